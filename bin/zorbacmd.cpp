@@ -500,6 +500,14 @@ static int compileAndExecute( Zorba *zorba,
             timers.stopTimer( Timers::plan_load, exec );
         }
 
+        if ( zc_props.sample_format_ != SAMPLE_FORMAT_NONE )
+          query->setSampling(
+            zc_props.sample_format_, zc_props.sample_interval_
+          );
+
+        if ( zc_props.memory_limit_ )
+          query->setMemoryAccounting( true, zc_props.memory_limit_ );
+
         if ( zc_props.timing_ )
           timers.startTimer( Timers::exec, exec );
 
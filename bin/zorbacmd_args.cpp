@@ -110,6 +110,9 @@ char const* get_help_msg() {
 
     ////////// d //////////////////////////////////////////////////////////////
 
+    HELP_OPT( "--data-guides <bool>" )
+      "Build a data guide for each loaded document, so that descendant name steps can skip subtrees without matches (default: true).\n\n"
+
 #ifdef ZORBA_WITH_DEBUGGER
     HELP_OPT( "--debug, -d" )
       "Launch the Zorba debugger server and connect to a DBGP-enabled debugger client.\n\n"
@@ -135,6 +138,9 @@ char const* get_help_msg() {
     HELP_OPT( "--disable-http-resolution" )
       "Do not use HTTP to resolve URIs.\n\n"
 
+    HELP_OPT( "--doc-projection <bool>" )
+      "Build only the parts of documents that the query can reach when loading them with fn:doc() or fn:parse-xml() (default: true).\n\n"
+
     HELP_OPT( "--dump-lib" )
       "Dump function library.\n\n"
 
@@ -153,6 +159,9 @@ char const* get_help_msg() {
 
     ////////// h //////////////////////////////////////////////////////////////
 
+    HELP_OPT( "--hash-joins" )
+      "Evaluate inferred value joins with a runtime hash join (default: true).\n\n"
+
     HELP_OPT( "--help" )
       "Print this help message.\n\n"
 
@@ -172,6 +181,9 @@ char const* get_help_msg() {
 
     ////////// j //////////////////////////////////////////////////////////////
 
+    HELP_OPT( "--json-scan <bool>" )
+      "Build only the fields of the objects returned by jn:parse-json() that the query looks up, and skip the objects that fail the equality tests of the where clauses (default: true).\n\n"
+
     HELP_OPT( "--jsoniq, -j" )
       "Force queries to be considered JSONiq.\n\n"
 
@@ -191,6 +203,9 @@ char const* get_help_msg() {
     HELP_OPT( "--max-udf-call-depth <depth>" )
       "Maximum stack depth of user-defined function calls.\n\n"
 
+    HELP_OPT( "--memory-limit <bytes>" )
+      "Abort the query if its runtime buffers (materialized sequences, sorted and grouped tuples) hold more than the given number of bytes.\n\n"
+
     HELP_OPT( "--module-path <path>" )
       "Path (list of directories) to add to both the URI and Library paths.\n\n"
 
@@ -235,6 +250,9 @@ char const* get_help_msg() {
 
     ////////// p //////////////////////////////////////////////////////////////
 
+    HELP_OPT( "--parallel-flwor-threads <n>" )
+      "Number of threads used by FLWOR expressions marked with the parallel pragma that do not specify one; 0 (the default) uses one thread per hardware thread.\n\n"
+
     HELP_OPT( "--parse-only" )
       "Stop after parsing the query.\n\n"
 
@@ -278,6 +296,12 @@ char const* get_help_msg() {
 
     ////////// s //////////////////////////////////////////////////////////////
 
+    HELP_OPT( "--sample {collapsed|table|trace}" )
+      "Sample the running iterators during the execution of the query and print the samples as collapsed stacks (for flame graphs), as a table of the self and total time of each iterator, or as a Chrome trace.\n\n"
+
+    HELP_OPT( "--sample-interval <ms>" )
+      "Set the sampling interval in milliseconds (default: 1).\n\n"
+
     HELP_OPT( "--serialization-parameter, -z <name>=<value>" )
       "Set serialization parameter (see http://www.w3.org/TR/xslt-xquery-serialization/#serparam, e.g.: -z method=xhtml -z doctype-system=DTD/xhtml1-strict.dtd -z indent=yes).\n\n"
 
@@ -317,12 +341,21 @@ char const* get_help_msg() {
     HELP_OPT( "--timeout <seconds>" )
       "Specify a timeout in seconds. After the specified time, the execution of the query will be aborted.\n\n"
 
+    HELP_OPT( "--trace-doc-projection" )
+      "Print, for each projected document, the projection and how many of its elements were built.\n\n"
+
     HELP_OPT( "--trace-parsing" )
       "Trace parsing.\n\n"
 
     HELP_OPT( "--trace-scanning" )
       "Trace scanning.\n\n"
 
+    HELP_OPT( "--trace-startup" )
+      "Print the time taken by each engine initialization phase.\n\n"
+
+    HELP_OPT( "--trace-string-dictionary" )
+      "Print how much memory the XML and JSON loaders saved by sharing repeated short values.\n\n"
+
 #ifndef NDEBUG
     HELP_OPT( "--trace-codegen" )
       "Trace code generatio.\n\n"
@@ -476,6 +509,10 @@ int parse_args( int argc, char const *argv[] ) {
 
     ////////// d //////////////////////////////////////////////////////////////
 
+    else if ( IS_LONG_OPT( "--data-guides" ) ) {
+      PARSE_ARG( "--data-guides" );
+      z_props.setDataGuides( bool_of( ARG_VAL ) );
+    }
 #ifdef ZORBA_WITH_DEBUGGER
     else if ( IS_OPT( "--debug", "-d" ) )
       zc_props.debug_ = true;
@@ -517,6 +554,10 @@ int parse_args( int argc, char const *argv[] ) {
       opt.value = "http-uri-resolution";
       zc_props.sctx_opts_.push_back( opt );
     }
+    else if ( IS_LONG_OPT( "--doc-projection" ) ) {
+      PARSE_ARG( "--doc-projection" );
+      z_props.setDocProjection( bool_of( ARG_VAL ) );
+    }
     else if ( IS_LONG_OPT( "--dump-lib" ) )
       z_props.setDumpLib( true );
 
@@ -554,6 +595,10 @@ int parse_args( int argc, char const *argv[] ) {
 
     ////////// h //////////////////////////////////////////////////////////////
 
+    else if ( IS_LONG_OPT( "--hash-joins" ) ) {
+      PARSE_ARG( "--hash-joins" );
+      z_props.setHashJoins( bool_of( ARG_VAL ) );
+    }
     else if ( IS_OPT( "--help", "-h" ) ) {
       cout << "Zorba NoSQL Query Processor, Version: "
            << Zorba::version() << '\n'
@@ -594,6 +639,10 @@ int parse_args( int argc, char const *argv[] ) {
 
     ////////// j //////////////////////////////////////////////////////////////
 
+    else if ( IS_LONG_OPT( "--json-scan" ) ) {
+      PARSE_ARG( "--json-scan" );
+      z_props.setJSONScan( bool_of( ARG_VAL ) );
+    }
     else if ( IS_OPT( "--jsoniq", "-j" ) )
       zc_props.jsoniq_ = true;
 
@@ -616,6 +665,10 @@ int parse_args( int argc, char const *argv[] ) {
       PARSE_ARG( "--max-udf-call-depth" );
       SET_ZPROP( MaxUDFCallDepth );
     }
+    else if ( IS_LONG_OPT( "--memory-limit" ) ) {
+      PARSE_ARG( "--memory-limit" );
+      SET_ZCPROP( memory_limit_ );
+    }
     else if ( IS_LONG_OPT( "--module-path" ) ) {
       PARSE_ARG( "--module-path" );
       zc_props.module_path_ = ARG_VAL;
@@ -680,6 +733,10 @@ int parse_args( int argc, char const *argv[] ) {
 
     ////////// p //////////////////////////////////////////////////////////////
 
+    else if ( IS_LONG_OPT( "--parallel-flwor-threads" ) ) {
+      PARSE_ARG( "--parallel-flwor-threads" );
+      SET_ZPROP( ParallelFlworThreads );
+    }
     else if ( IS_LONG_OPT( "--parse-only" ) )
       zc_props.parse_only_ = true;
     else if ( IS_OPT( "--print-ast", "-a" ) )
@@ -739,6 +796,27 @@ int parse_args( int argc, char const *argv[] ) {
 
     ////////// s //////////////////////////////////////////////////////////////
 
+    else if ( IS_LONG_OPT( "--sample" ) ) {
+      PARSE_ARG( "--sample" );
+      string val( ARG_VAL );
+      to_lower( val );
+      if ( val == "none" )
+        zc_props.sample_format_ = SAMPLE_FORMAT_NONE;
+      else if ( val == "collapsed" )
+        zc_props.sample_format_ = SAMPLE_FORMAT_COLLAPSED;
+      else if ( val == "table" )
+        zc_props.sample_format_ = SAMPLE_FORMAT_TABLE;
+      else if ( val == "trace" )
+        zc_props.sample_format_ = SAMPLE_FORMAT_TRACE;
+      else {
+        error = "--sample argument must be one of: none, collapsed, table, or trace.\n";
+        break;
+      }
+    }
+    else if ( IS_LONG_OPT( "--sample-interval" ) ) {
+      PARSE_ARG( "--sample-interval" );
+      SET_ZCPROP( sample_interval_ );
+    }
     else if ( IS_OPT( "--serialization-parameter", "-z" ) ) {
       PARSE_ARG( "--serialization-parameter" );
       string key, value;
@@ -801,10 +879,16 @@ int parse_args( int argc, char const *argv[] ) {
       PARSE_ARG( "--timeout" );
       SET_ZCPROP( timeout_ );
     }
+    else if ( IS_LONG_OPT( "--trace-doc-projection" ) )
+      z_props.setTraceDocProjection( true );
     else if ( IS_LONG_OPT( "--trace-parsing" ) )
       z_props.setTraceParsing( true );
     else if ( IS_LONG_OPT( "--trace-scanning" ) )
       z_props.setTraceScanning( true );
+    else if ( IS_LONG_OPT( "--trace-startup" ) )
+      z_props.setTraceStartup( true );
+    else if ( IS_LONG_OPT( "--trace-string-dictionary" ) )
+      z_props.setTraceStringDictionary( true );
 #ifndef NDEBUG
     else if ( IS_LONG_OPT( "--trace-codegen" ) )
       z_props.setTraceCodegen( true );
@@ -32,6 +32,7 @@ ZorbaCmdProperties::ZorbaCmdProperties() {
   jsoniq_ = false;
   lib_module_ = false;
   load_plan_ = false;
+  memory_limit_ = 0;
   multiple_ = 1;
   no_logo_ = false;
   no_serializer_ = false;
@@ -40,6 +41,8 @@ ZorbaCmdProperties::ZorbaCmdProperties() {
   parse_only_ = false;
   print_errors_as_xml_ = false;
   print_query_ = false;
+  sample_format_ = SAMPLE_FORMAT_NONE;
+  sample_interval_ = 1;
   save_plan_ = false;
   serialize_html_ = false;
   serialize_only_query_ = false;
@@ -24,6 +24,7 @@
 
 // Zorba
 #include <zorba/config.h>
+#include <zorba/options.h>
 #include <zorba/zorba_string.h>
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -84,6 +85,7 @@ struct ZorbaCmdProperties {
   bool          lib_module_;
   std::string   lib_path_;
   bool          load_plan_;
+  unsigned long long memory_limit_;
   std::string   module_path_;
   unsigned long multiple_;
   bool          no_logo_;
@@ -97,6 +99,8 @@ struct ZorbaCmdProperties {
   bool          parse_only_;
   bool          print_errors_as_xml_;
   bool          print_query_;
+  Zorba_sample_format_t sample_format_;
+  unsigned long sample_interval_;
   bool          save_plan_;
   sctx_opts     sctx_opts_;
   bool          serialize_html_;
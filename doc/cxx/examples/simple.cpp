@@ -373,6 +373,54 @@ example_15(Zorba* zorba)
 }
 
 
+bool
+example_16(Zorba* aZorba)
+{
+  XQuery_t lQuery = aZorba->compileQuery("declare variable $i external; 1 to $i");
+
+  try
+  {
+    // every execution has its own dynamic context, so the executions of one
+    // compiled query may run at the same time (e.g., in different threads)
+    XQueryExecution_t lExec1 = lQuery->createExecution();
+    XQueryExecution_t lExec2 = lQuery->createExecution();
+
+    lExec1->getDynamicContext()->setVariable(
+        "i", aZorba->getItemFactory()->createInteger(3));
+    lExec2->getDynamicContext()->setVariable(
+        "i", aZorba->getItemFactory()->createInteger(2));
+
+    Iterator_t lIterator1 = lExec1->iterator();
+    Iterator_t lIterator2 = lExec2->iterator();
+
+    lIterator1->open();
+    lIterator2->open();
+
+    Item lItem;
+    while ( lIterator1->next(lItem) )
+    {
+      std::cout << lItem.getStringValue();
+      if ( lIterator2->next(lItem) )
+        std::cout << lItem.getStringValue();
+    }
+    std::cout << std::endl;
+
+    lIterator1->close();
+    lIterator2->close();
+
+    lExec1->execute(std::cout);
+    std::cout << std::endl;
+  }
+  catch (ZorbaException& e)
+  {
+    std::cerr << e << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+
 int 
 simple(int argc, char* argv[])
 {
@@ -456,6 +504,11 @@ simple(int argc, char* argv[])
   if (!res) return 1;
   std::cout << std::endl;
 
+  std::cout << "executing example 16" << std::endl;
+  res = example_16(lZorba);
+  if (!res) return 1;
+  std::cout << std::endl;
+
   lZorba->shutdown();
   StoreManager::shutdownStore(lStore);
   return 0;
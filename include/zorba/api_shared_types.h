@@ -50,6 +50,7 @@ class TokenizerProvider;
 #endif /* ZORBA_NO_FULL_TEXT */
 class XmlDataManager;
 class XQuery;
+class XQueryExecution;
 class Zorba;
 
 // smart pointers
@@ -65,6 +66,7 @@ typedef SmartPtr<Serializer>      Serializer_t;
 typedef SmartPtr<StaticContext>   StaticContext_t;
 typedef SmartPtr<XmlDataManager>  XmlDataManager_t;
 typedef SmartPtr<XQuery>          XQuery_t;
+typedef SmartPtr<XQueryExecution> XQueryExecution_t;
 
 // data handlers
 class Item;
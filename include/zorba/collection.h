@@ -19,10 +19,34 @@
 #include <zorba/config.h>
 #include <zorba/api_shared_types.h>
 #include <zorba/item.h>
+#include <zorba/zorba_string.h>
 #include <vector>
 
 namespace zorba {
 
+/** \brief Statistics about a call to Collection::loadDocumentsLast().
+ */
+struct ZORBA_DLL_PUBLIC BulkLoadStats
+{
+  unsigned long long theNumDocuments;
+  unsigned long long theNumBytes;
+  double             theElapsedMillis;
+
+  BulkLoadStats() : theNumDocuments(0), theNumBytes(0), theElapsedMillis(0) {}
+
+  double
+  getDocumentsPerSecond() const
+  {
+    return theElapsedMillis > 0 ? theNumDocuments * 1000 / theElapsedMillis : 0;
+  }
+
+  double
+  getBytesPerSecond() const
+  {
+    return theElapsedMillis > 0 ? theNumBytes * 1000 / theElapsedMillis : 0;
+  }
+};
+
 /** \brief A Collection is a persistent sequence of node items.
  *
  * Instances of this class can be used to modify or retrieve the contents
@@ -68,6 +92,29 @@ class ZORBA_DLL_PUBLIC Collection : public SmartObject
    */
   virtual void
   insertNodesLast(const ItemSequence_t& aNodes) = 0;
+
+  /**
+   * This function parses the given files in parallel and inserts the
+   * resulting documents at the end of the collection, in the order of
+   * aFiles. Files whose name ends with ".json" are parsed as a sequence
+   * of JSON items; all other files are parsed as XML documents.
+   *
+   * The documents are inserted by a single update, after all the files
+   * have been parsed. If any file cannot be parsed, nothing is inserted
+   * and the error of the first such file (in the order of aFiles) is
+   * reported.
+   *
+   * @param aFiles The paths of the files to load.
+   * @param aNumThreads The number of parsing threads. If 0, the number
+   *        of hardware threads is used.
+   * @param aStats If not null, receives the number of documents and bytes
+   *        loaded and the time it took to parse and insert them.
+   */
+  virtual void
+  loadDocumentsLast(
+      const std::vector<String>& aFiles,
+      unsigned int aNumThreads = 0,
+      BulkLoadStats* aStats = 0) = 0;
   
   /**
    * This function inserts copies of the given
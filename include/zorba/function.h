@@ -224,6 +224,60 @@ class ZORBA_DLL_PUBLIC ContextualExternalFunction : public ExternalFunction
 };
 
 
+/**************************************************************************//**
+  The BatchExternalFunction class serves as the base of subclasses that
+  represent non contextual external functions which can evaluate many calls
+  at once, e.g., by sending one request to a remote service instead of one
+  request per call.
+
+  When a call to such a function is the return clause of a FLWOR expression
+  that iterates over a single for clause (optionally filtered by a where
+  clause), the runtime collects the arguments of up to getBatchSize()
+  iterations and passes them to evaluateBatch() in one go, instead of calling
+  evaluate() once per iteration. This is done only if every parameter of the
+  function is declared to accept at most one item, and if the function is
+  declared deterministic (but neither %an:cache nor %an:strictlydeterministic)
+  and neither sequential nor updating, so that the grouping of the calls cannot
+  be observed by the query.
+
+  Outside of such a FLWOR expression, the function is called through
+  evaluate(), which by default evaluates a batch of one call.
+*******************************************************************************/
+class ZORBA_DLL_PUBLIC BatchExternalFunction
+  : public NonContextualExternalFunction
+{
+ public:
+  /**
+   * The arguments of a batch of calls: one tuple per call, and one item per
+   * argument in each tuple. An item is null if the argument is the empty
+   * sequence.
+   */
+  typedef std::vector<std::vector<Item> > ArgumentTuples_t;
+
+  /**
+   * Evaluates a batch of calls.
+   *
+   * @param aTuples The arguments of the calls, in the order of the calls.
+   * @param aResults Must be filled with exactly one item per call, in the
+   *        order of the calls; a null item stands for the empty sequence.
+   */
+  virtual void
+  evaluateBatch(
+      const ArgumentTuples_t& aTuples,
+      std::vector<Item>& aResults) const = 0;
+
+  /**
+   * @return The maximum number of calls that the runtime passes to a single
+   *         invocation of evaluateBatch(). The default is 1024.
+   */
+  virtual size_t
+  getBatchSize() const;
+
+  ItemSequence_t
+  evaluate(const Arguments_t& aArgs) const;
+};
+
+
 } /* namespace zorba */
 #endif
 
@@ -186,6 +186,13 @@ typedef enum {
   PROFILE_FORMAT_JSON
 } Zorba_profile_format_t;
 
+typedef enum {
+  SAMPLE_FORMAT_NONE,
+  SAMPLE_FORMAT_COLLAPSED,
+  SAMPLE_FORMAT_TABLE,
+  SAMPLE_FORMAT_TRACE
+} Zorba_sample_format_t;
+
 
 /*****************************************************************************/
 
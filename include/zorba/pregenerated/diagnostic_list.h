@@ -505,6 +505,8 @@ extern ZORBA_DLL_PUBLIC ZorbaErrorCode ZXQP0065_INVALID_ANNOTATION;
 
 extern ZORBA_DLL_PUBLIC ZorbaErrorCode ZXQP0066_INVALID_ANNOTATION_LITERAL_VALUE;
 
+extern ZORBA_DLL_PUBLIC ZorbaErrorCode ZXQP0067_MEMORY_LIMIT_EXCEEDED;
+
 #if !defined(ZORBA_NO_FULL_TEXT)
 extern ZORBA_DLL_PUBLIC ZorbaErrorCode ZXQP8401_THESAURUS_VERSION_MISMATCH;
 
@@ -68,6 +68,26 @@ public:
   }
 #endif /* NDEBUG */
 
+  /**
+   * Gets whether the XML loader builds a data guide (a summary of the distinct
+   * element and attribute paths) for each document it loads, which descendant
+   * name steps and twig joins use to skip subtrees without matches.
+   *
+   * @return \c true only if data guides are built.
+   */
+  bool getDataGuides() const {
+    return data_guides_;
+  }
+
+  /**
+   * Sets whether the XML loader builds a data guide for each document.
+   *
+   * @param b If \c true, build data guides.
+   */
+  void setDataGuides( bool b ) {
+    data_guides_ = b;
+  }
+
   /**
    * Gets the stream used for additional developer debugging output.
    * (This has nothing to do with the Zorba debugger.)
@@ -109,6 +129,26 @@ public:
    */
   void setDebugStream( std::ostream &os, bool take_ownership = false );
 
+  /**
+   * Gets whether fn:doc() and fn:parse-xml() build only the parts of their
+   * documents that the query can reach, as derived by the optimizer.
+   *
+   * @return \c true only if document projection is enabled.
+   */
+  bool getDocProjection() const {
+    return doc_projection_;
+  }
+
+  /**
+   * Sets whether fn:doc() and fn:parse-xml() build only the parts of their
+   * documents that the query can reach.
+   *
+   * @param b If \c true, project documents.
+   */
+  void setDocProjection( bool b ) {
+    doc_projection_ = b;
+  }
+
   bool getDumpLib() const {
     return dump_lib_;
   }
@@ -125,6 +165,26 @@ public:
     force_gflwor_ = b;
   }
 
+  /**
+   * Gets whether value joins inferred by the optimizer are evaluated with a
+   * runtime hash join rather than a temporary value index.
+   *
+   * @return \c true only if runtime hash joins are enabled.
+   */
+  bool getHashJoins() const {
+    return hash_joins_;
+  }
+
+  /**
+   * Sets whether value joins inferred by the optimizer are evaluated with a
+   * runtime hash join rather than a temporary value index.
+   *
+   * @param b If \c true, use runtime hash joins.
+   */
+  void setHashJoins( bool b ) {
+    hash_joins_ = b;
+  }
+
   bool getInferJoins() const {
     return infer_joins_;
   }
@@ -141,6 +201,28 @@ public:
     inline_udf_ = b;
   }
 
+  /**
+   * Gets whether jn:parse-json() builds, of each object it returns to a for
+   * clause, only the fields that the query looks up, and skips the objects
+   * that fail the equality tests of the following where clauses, as derived
+   * by the optimizer.
+   *
+   * @return \c true only if JSON scans are enabled.
+   */
+  bool getJSONScan() const {
+    return json_scan_;
+  }
+
+  /**
+   * Sets whether jn:parse-json() builds only the parts of the objects it
+   * returns that the query needs.
+   *
+   * @param b If \c true, scan JSON input.
+   */
+  void setJSONScan( bool b ) {
+    json_scan_ = b;
+  }
+
   std::string const& getClassPath() const {
     return classpath_;
   }
@@ -186,6 +268,24 @@ public:
     setClassPath( jvmClasspath );
   }
 
+  /**
+   * Gets whether the functions of builtin modules are registered only when a
+   * query first refers to the module's namespace rather than at startup.
+   */
+  bool getLazyBuiltins() const {
+    return lazy_builtins_;
+  }
+
+  /**
+   * Sets whether the functions of builtin modules are registered lazily.
+   * This must be set before Zorba is initialized in order to have an effect.
+   *
+   * @param b If \c true, register builtin module functions on first use.
+   */
+  void setLazyBuiltins( bool b ) {
+    lazy_builtins_ = b;
+  }
+
   bool getLoopHoisting() const {
     return loop_hoisting_;
   }
@@ -240,6 +340,26 @@ public:
 
   void setOptimizationLevel( unsigned optimization_level );
 
+  /**
+   * Gets the number of threads used by a FLWOR expression that is marked with
+   * the parallel pragma but does not give a number of threads itself.
+   *
+   * @return Returns said number; 0 means one thread per hardware thread.
+   */
+  uint32_t getParallelFlworThreads() const {
+    return parallel_flwor_threads_;
+  }
+
+  /**
+   * Sets the number of threads used by a FLWOR expression that is marked with
+   * the parallel pragma but does not give a number of threads itself.
+   *
+   * @param n The number of threads; 0 means one thread per hardware thread.
+   */
+  void setParallelFlworThreads( uint32_t n ) {
+    parallel_flwor_threads_ = n;
+  }
+
   Zorba_plan_format_t getPlanFormat() const {
     return plan_format_;
   }
@@ -348,6 +468,23 @@ public:
   }
 #endif /* ZORBA_NO_FULL_TEXT */
 
+  /**
+   * Gets whether the XML loader prints to the debug stream, for each projected
+   * document, the projection and how many of the document's elements it built.
+   */
+  bool getTraceDocProjection() const {
+    return trace_doc_projection_;
+  }
+
+  /**
+   * Sets whether the XML loader prints a report for each projected document.
+   *
+   * @param b If \c true, print the report after each projected load.
+   */
+  void setTraceDocProjection( bool b ) {
+    trace_doc_projection_ = b;
+  }
+
   bool getTraceParsing() const {
     return trace_parsing_;
   }
@@ -364,6 +501,42 @@ public:
     trace_scanning_ = b;
   }
 
+  /**
+   * Gets whether the time taken by each engine initialization phase is printed
+   * to the debug stream.
+   */
+  bool getTraceStartup() const {
+    return trace_startup_;
+  }
+
+  /**
+   * Sets whether the time taken by each engine initialization phase is printed
+   * to the debug stream.
+   * This must be set before Zorba is initialized in order to have an effect.
+   *
+   * @param b If \c true, print the startup phase timings.
+   */
+  void setTraceStartup( bool b ) {
+    trace_startup_ = b;
+  }
+
+  /**
+   * Gets whether the XML and JSON loaders print to the debug stream how many
+   * repeated short values they shared and how much memory that saved.
+   */
+  bool getTraceStringDictionary() const {
+    return trace_string_dictionary_;
+  }
+
+  /**
+   * Sets whether the XML and JSON loaders print a string dictionary report.
+   *
+   * @param b If \c true, print the report after each load.
+   */
+  void setTraceStringDictionary( bool b ) {
+    trace_string_dictionary_ = b;
+  }
+
   bool getTraceTranslator() const {
     return trace_translator_;
   }
@@ -391,18 +564,24 @@ private:
 #endif /* NDEBUG */
   std::string            classpath_;
   bool                   collect_profile_;
+  bool                   data_guides_;
   stream_ptr             debug_stream_;
   bool                   owns_debug_stream_;
+  bool                   doc_projection_;
   bool                   dump_lib_;
   bool                   force_gflwor_;
+  bool                   hash_joins_;
   bool                   infer_joins_;
   bool                   inline_udf_;
+  bool                   json_scan_;
+  bool                   lazy_builtins_;
   bool                   loop_hoisting_;
   uint32_t               max_udf_call_depth_;
   bool                   no_copy_optim_;
   bool                   no_tree_ids_;
   bool                   no_uncalled_iterators_;
   unsigned               optimization_level_;
+  uint32_t               parallel_flwor_threads_;
   Zorba_plan_format_t    plan_format_;
   bool                   print_ast_;
   bool                   print_intermediate_opt_;
@@ -417,8 +596,11 @@ private:
 #ifndef ZORBA_NO_FULL_TEXT
   bool                   trace_fulltext_;
 #endif /* ZORBA_NO_FULL_TEXT */
+  bool                   trace_doc_projection_;
   bool                   trace_parsing_;
   bool                   trace_scanning_;
+  bool                   trace_startup_;
+  bool                   trace_string_dictionary_;
   bool                   trace_translator_;
   bool                   use_indexes_;
   double                 wall_time_threshold_;
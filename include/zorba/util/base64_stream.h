@@ -106,7 +106,7 @@ protected:
 private:
   std::streambuf *const orig_buf_;
 
-  char gbuf_[3];
+  char gbuf_[ 3 * 1024 ];                 // must be a multiple of 3
   char pbuf_[3];
   int plen_;
 
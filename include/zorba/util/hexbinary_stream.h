@@ -95,7 +95,7 @@ protected:
 
 private:
   std::streambuf *const orig_buf_;
-  char gbuf_[2];
+  char gbuf_[1024];
 
   void clear();
 
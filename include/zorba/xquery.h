@@ -96,6 +96,62 @@ class ZORBA_DLL_PUBLIC XQuery : public SmartObject
    */
   virtual void
   setTimeout(long aTimeout = -1) = 0;
+
+  /**
+   * \brief Enable or disable sampling of the executions of this query.
+   *
+   * While a sampled query runs, a background thread records the stack of
+   * active iterators every aInterval milliseconds. When the execution ends,
+   * the samples are printed to the debug stream of the Properties in the
+   * given format: collapsed stacks (as consumed by flame graph tools), a
+   * table of the self and total time of each iterator and its location in
+   * the query, or a Chrome trace (JSON). Unlike the profile collected when
+   * Properties::setCollectProfile() is set, sampling does not time each
+   * iterator call, so it hardly slows down the query.
+   *
+   * @param aFormat the format of the printed samples; SAMPLE_FORMAT_NONE
+   *        (the default) disables sampling.
+   * @param aInterval the sampling interval in milliseconds.
+   */
+  virtual void
+  setSampling(Zorba_sample_format_t aFormat, unsigned long aInterval = 1) = 0;
+
+  /**
+   * \brief Enable or disable memory accounting for the executions of this
+   *        query.
+   *
+   * While an accounted query runs, the memory held by its runtime buffers
+   * (materialized sequences, sorted and grouped tuples) is tracked, and so
+   * is the memory of the node trees it constructs or parses. The counters of
+   * the last execution are returned by getMemoryPeak() and
+   * getMemoryAllocated(), and are also recorded in the
+   * xquery/execution/memory-peak and xquery/execution/memory-allocated
+   * properties of the audit event of the query, if these are enabled (which
+   * also turns accounting on).
+   *
+   * @param aEnable whether memory accounting is enabled.
+   * @param aLimit if not 0, the execution is aborted with error
+   *        zerr:ZXQP0067 as soon as the runtime buffers of the query hold
+   *        more than aLimit bytes.
+   */
+  virtual void
+  setMemoryAccounting(bool aEnable, unsigned long long aLimit = 0) = 0;
+
+  /**
+   * \brief The highest amount of memory, in bytes, held by the runtime
+   *        buffers of the last execution of this query, or 0 if it was not
+   *        accounted (see setMemoryAccounting()).
+   */
+  virtual unsigned long long
+  getMemoryPeak() const = 0;
+
+  /**
+   * \brief The total amount of memory, in bytes, allocated for runtime
+   *        buffers and node trees during the last execution of this query, or
+   *        0 if it was not accounted (see setMemoryAccounting()).
+   */
+  virtual unsigned long long
+  getMemoryAllocated() const = 0;
   
   /**
    * \brief Execute the query and write the result to the given output stream.
@@ -413,6 +469,31 @@ class ZORBA_DLL_PUBLIC XQuery : public SmartObject
   virtual XQuery_t
   clone() const = 0;
 
+  /**
+   * \brief Create a new execution of this query.
+   *
+   * An execution has its own DynamicContext and its own runtime state, but
+   * shares the execution plan, the StaticContext, and the DiagnosticHandler
+   * with this query. Unlike clone(), creating an execution takes no lock and
+   * creates no static context, so any number of threads may create and run
+   * executions of the same XQuery object concurrently. A single execution
+   * object must not be used by more than one thread at a time.
+   *
+   * The DynamicContext of an execution is a child of the DynamicContext of
+   * this query: it starts out with the same implicit timezone, default
+   * collection, and external function parameters, but the values of the
+   * external variables and the context item must be set in the
+   * DynamicContext of the execution itself.
+   *
+   * This query must not be closed while any of its executions is still in
+   * use. For an example see example_16 in file \link simple.cpp \endlink.
+   *
+   * @return The new execution.
+   * @throw SystemException if the query has not been compiled or is closed.
+   */
+  virtual XQueryExecution_t
+  createExecution() const = 0;
+
 #ifdef ZORBA_WITH_DEBUGGER
   /**
    * \brief Enable/disable debug mode on the query
@@ -543,7 +624,88 @@ class ZORBA_DLL_PUBLIC XQuery : public SmartObject
    virtual void
    printPlan(std::ostream& aStream, Zorba_plan_format_t aFormat) const = 0;
 };
-  
+
+
+/**
+ * \brief One execution of a compiled XQuery program.
+ *
+ * An XQueryExecution is created by XQuery::createExecution(). It shares the
+ * compiled plan of its query, but has its own DynamicContext and its own
+ * runtime state, so that the executions of one query can run concurrently
+ * without any locking. An execution may be run any number of times; the
+ * values that have been set in its DynamicContext are kept between runs.
+ *
+ * Note: This class is reference counted, but the reference count is not
+ * synchronized. An XQueryExecution object must be used by one thread at a
+ * time.
+ */
+class ZORBA_DLL_PUBLIC XQueryExecution : public SmartObject
+{
+ public:
+  virtual ~XQueryExecution() { }
+
+  /**
+   * \brief Get the dynamic context of this execution.
+   *
+   * The values of the external variables and the context item of the query
+   * are set in this dynamic context before the execution is run.
+   *
+   * @return DynamicContext of this execution.
+   * @throw ZorbaException if the query has been closed.
+   */
+  virtual DynamicContext*
+  getDynamicContext() const = 0;
+
+  /**
+   * \brief Run the execution and write the result to the given output stream.
+   *
+   * @param aOutStream the output stream on which the result is written.
+   * @param aSerOptions an optional set of serialization options.
+   * @throw ZorbaException if an error occurs (e.g. the query is closed or is
+   *        updating, or the execution is already running)
+   */
+  virtual void
+  execute(std::ostream& aOutStream,
+          const Zorba_SerializerOptions_t* aSerOptions = NULL) = 0;
+
+  /**
+   * \brief Run the execution of an updating query.
+   *
+   * @throw ZorbaException if an error occurs (e.g. the query is closed or is
+   *        not updating, or the execution is already running)
+   */
+  virtual void
+  execute() = 0;
+
+  /**
+   * \brief Get an iterator for the result of this execution.
+   *
+   * There can be at most one iterator per execution at a time.
+   *
+   * @return Iterator iterator over the result sequence.
+   * @throw ZorbaException if an error occurs (e.g. the query is closed, or
+   *        the execution already has an iterator).
+   */
+  virtual Iterator_t
+  iterator() = 0;
+
+  /**
+   * \brief The highest amount of memory, in bytes, held by the runtime
+   *        buffers of the last run of this execution, or 0 if it was not
+   *        accounted (see XQuery::setMemoryAccounting()).
+   */
+  virtual unsigned long long
+  getMemoryPeak() const = 0;
+
+  /**
+   * \brief The total amount of memory, in bytes, allocated for runtime
+   *        buffers and node trees during the last run of this execution, or
+   *        0 if it was not accounted (see XQuery::setMemoryAccounting()).
+   */
+  virtual unsigned long long
+  getMemoryAllocated() const = 0;
+};
+
 
 // XML serialization of the query result (equiv to calling serialize(os) 
 ZORBA_DLL_PUBLIC
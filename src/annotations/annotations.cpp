@@ -127,6 +127,7 @@ void AnnotationInternal::createBuiltIn()
   ZANN(general-equality, general_equality);
   ZANN(value-range, value_range);
   ZANN(general-range, general_range);
+  ZANN(full-text, full_text);
 
   ZANN(automatic, automatic);
   ZANN(manual, manual);
@@ -156,7 +157,8 @@ void AnnotationInternal::createBuiltIn()
       ZANN(zann_value_equality) |
       ZANN(zann_general_equality) |
       ZANN(zann_value_range) |
-      ZANN(zann_general_range));
+      ZANN(zann_general_range) |
+      ZANN(zann_full_text));
 
   theConflictRuleSet.push_back(
       ZANN(zann_automatic) |
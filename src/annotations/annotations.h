@@ -77,6 +77,7 @@ public:
     zann_general_equality,
     zann_value_range,
     zann_general_range,
+    zann_full_text,
     zann_automatic,
     zann_manual,
     zann_mutable,
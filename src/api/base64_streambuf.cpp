@@ -37,6 +37,26 @@ int const Large_External_Buf_Size = 4096; // must be a multiple of 4
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/**
+ * Reads up to \a size (a multiple of 4) encoded bytes.  A short read doesn't
+ * necessarily mean EOF, so the last chunk is completed (if possible) since
+ * only the very last chunk may be partial.
+ *
+ * @return Returns the number of bytes read.
+ */
+static streamsize read_chunks( std::streambuf *buf, char *to,
+                               streamsize size ) {
+  streamsize got = buf->sgetn( to, size );
+  while ( got % 4 ) {
+    streambuf::int_type const c = buf->sbumpc();
+    if ( streambuf::traits_type::eq_int_type( c,
+                                              streambuf::traits_type::eof() ) )
+      break;
+    to[ got++ ] = streambuf::traits_type::to_char_type( c );
+  }
+  return got;
+}
+
 inline void streambuf::resetg() {
   setg( gbuf_, gbuf_ + sizeof gbuf_, gbuf_ + sizeof gbuf_ );
 }
@@ -91,8 +111,10 @@ streamsize streambuf::showmanyc() {
 }
 
 int streambuf::sync() {
-  if ( plen_ )
+  if ( plen_ ) {
     writep();
+    resetp();
+  }
   return orig_buf_->pubsync();
 }
 
@@ -113,9 +135,12 @@ streambuf::int_type streambuf::overflow( int_type c ) {
 streambuf::int_type streambuf::pbackfail( int_type c ) {
   if ( !traits_type::eq_int_type( c, traits_type::eof() ) &&
        gptr() > eback() ) {
-    c = orig_buf_->sputbackc( traits_type::to_char_type( c ) );
-    if ( !traits_type::eq_int_type( c, traits_type::eof() ) )
-      gbump( -1 );
+    //
+    // The get buffer holds decoded bytes that were read ahead, so the byte
+    // must be put back into it rather than into the original streambuf.
+    //
+    gbump( -1 );
+    *gptr() = traits_type::to_char_type( c );
     return c;
   }
   return traits_type::eof();
@@ -125,25 +150,19 @@ streambuf::int_type streambuf::underflow() {
 #ifdef ZORBA_DEBUG_BASE64_STREAMBUF
   printf( "underflow()\n" );
 #endif
-  char chunk[4];
-  int chunk_len = 0;
-
-  while ( gptr() >= egptr() ) {
-    int_type const c = orig_buf_->sbumpc();
-    bool is_eof = false;
-    if ( traits_type::eq_int_type( c, traits_type::eof() ) ) {
-      if ( !chunk_len )
-        return traits_type::eof();
-      is_eof = true;
-    } else {
-      chunk[ chunk_len++ ] = traits_type::to_char_type( c );
-    }
-    if ( chunk_len == sizeof chunk || (is_eof && chunk_len) ) {
-      streamsize const n = base64::decode( chunk, chunk_len, eback() );
-      setg( gbuf_, gbuf_, gbuf_ + n );
-    }
-  }
-  return traits_type::to_int_type( *gptr() );
+  //
+  // Decode as many whole chunks as fit into the get buffer at once rather than
+  // one chunk at a time so that base64::decode() can use its SIMD versions.
+  //
+  char ebuf[ sizeof gbuf_ / 3 * 4 ];
+  streamsize const ebuf_len = read_chunks( orig_buf_, ebuf, sizeof ebuf );
+  if ( !ebuf_len )
+    return traits_type::eof();
+
+  streamsize const n =
+    base64::decode( ebuf, static_cast<size_type>( ebuf_len ), gbuf_ );
+  setg( gbuf_, gbuf_, gbuf_ + n );
+  return n ? traits_type::to_int_type( *gptr() ) : traits_type::eof();
 }
 
 streamsize streambuf::xsgetn( char_type *to, streamsize size ) {
@@ -152,32 +171,39 @@ streamsize streambuf::xsgetn( char_type *to, streamsize size ) {
 #endif
   streamsize return_size = 0;
 
-  if ( streamsize const gsize = egptr() - gptr() ) {
-    //
-    // Get any chunk fragment pending in the get buffer first.
-    //
-    streamsize const n = min( gsize, size );
-    traits_type::copy( to, gptr(), static_cast<size_t>( n ) );
-    gbump( static_cast<int>( n ) );
-    to += n;
-    size -= n, return_size += n;
-  }
-
-  //
-  // Must get bytes in terms of encoded size.
-  //
-  size = base64::encoded_size( static_cast<size_type>( size ) );
-
   while ( size ) {
-    char ebuf[ Large_External_Buf_Size ];
-    streamsize const get = min( (streamsize)(sizeof ebuf), size );
-    if ( streamsize got = orig_buf_->sgetn( ebuf, get ) ) {
+    if ( streamsize const gsize = egptr() - gptr() ) {
+      //
+      // Get any bytes pending in the get buffer first.
+      //
+      streamsize const n = min( gsize, size );
+      traits_type::copy( to, gptr(), static_cast<size_t>( n ) );
+      gbump( static_cast<int>( n ) );
+      to += n;
+      size -= n, return_size += n;
+    } else if ( size >= 3 ) {
+      //
+      // Decode whole chunks directly; must get bytes in terms of encoded size
+      // so as not to decode more than was asked for.
+      //
+      char ebuf[ Large_External_Buf_Size ];
+      streamsize const get = min(
+        (streamsize)(sizeof ebuf), size / 3 * 4
+      );
+      streamsize const got = read_chunks( orig_buf_, ebuf, get );
+      if ( !got )
+        break;
       streamsize const decoded =
         base64::decode( ebuf, static_cast<size_type>( got ), to );
       to += decoded;
-      size -= got, return_size += decoded;
-    } else
-      break;
+      size -= decoded, return_size += decoded;
+    } else {
+      //
+      // Get the last chunk fragment via the get buffer.
+      //
+      if ( traits_type::eq_int_type( underflow(), traits_type::eof() ) )
+        break;
+    }
   }
 
   return return_size;
@@ -201,7 +227,7 @@ streamsize streambuf::xsputn( char_type const *from, streamsize size ) {
     char ebuf[ Large_External_Buf_Size ];
     static streamsize const esize =
       (streamsize)base64::decoded_size( sizeof ebuf );
-    streamsize const put = min( esize, size );
+    streamsize const put = min( esize, size / 3 * 3 );
     streamsize const encoded =
       base64::encode( from, static_cast<size_type>( put ), ebuf );
     orig_buf_->sputn( ebuf, encoded );
@@ -214,6 +240,7 @@ streamsize streambuf::xsputn( char_type const *from, streamsize size ) {
   if ( size ) {
     traits_type::copy( pbuf_, from, static_cast<size_t>( size ) );
     plen_ = static_cast<int>( size );
+    return_size += size;
   }
 
   return return_size;
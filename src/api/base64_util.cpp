@@ -24,8 +24,13 @@
 #include <zorba/util/base64_util.h>
 #include <zorba/util/mem_streambuf.h>
 #include "util/ascii_util.h"
+#include "util/cpu_util.h"
 #include "util/string_util.h"
 
+#ifdef ZORBA_CPU_X86_SIMD
+# include <immintrin.h>
+#endif
+
 using namespace std;
 
 namespace zorba {
@@ -120,6 +125,262 @@ inline void encode_chunk( char const *from, char *to ) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#ifdef ZORBA_CPU_X86_SIMD
+//
+// The SIMD versions of encode_chunk() and decode_chunk() are based on:
+// Wojciech Mula and Daniel Lemire, "Faster Base64 Encoding and Decoding Using
+// AVX2 Instructions," ACM Transactions on the Web 12(3), 2018.
+//
+// Each function processes as many whole blocks (of 12 or 24 bytes when
+// encoding; of 16 or 32 Base64 characters when decoding) as it can and
+// returns the number of bytes of "from" it consumed: the caller processes the
+// rest.  Decoding stops at the first block that contains anything other than
+// the 64 Base64 characters (e.g., whitespace or '=') so that the caller deals
+// with it (and, if necessary, reports the error) as before.  Neither function
+// ever writes past the bytes it encodes or decodes.
+//
+// The 256-bit versions use the same 16-byte tables in both 128-bit lanes.
+//
+
+/**
+ * Moves each group of 3 input bytes into a 32-bit word so that the 4 groups
+ * of 6 bits can be isolated by multiplications.
+ */
+static signed char const encode_shuffle[] = {
+  1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+};
+
+/**
+ * What to add to each 6-bit value to get its Base64 character, indexed by:
+ * 0-25 -> 13, 26-51 -> 0, 52-61 -> 1-10, 62 -> 11, 63 -> 12.
+ */
+static signed char const encode_offsets[] = {
+  'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+  '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0
+};
+
+/**
+ * Bit sets indexed by the low and high nibble, respectively, of a character:
+ * a character is a Base64 character only if the sets have no bit in common.
+ */
+static signed char const decode_lo_bits[] = {
+  0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+  0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+};
+static signed char const decode_hi_bits[] = {
+  0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+  0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+};
+
+/**
+ * What to add to a Base64 character to get its 6-bit value, indexed by its
+ * high nibble (minus 1 for '/').
+ */
+static signed char const decode_offsets[] = {
+  0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/**
+ * Gathers the 3 decoded bytes at the start of each 32-bit word.
+ */
+static signed char const decode_pack[] = {
+  2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+};
+
+#define ZORBA_LOAD_128(TABLE) \
+  _mm_loadu_si128( reinterpret_cast<__m128i const*>( TABLE ) )
+
+#define ZORBA_LOAD_256(TABLE) \
+  _mm256_broadcastsi128_si256( ZORBA_LOAD_128( TABLE ) )
+
+ZORBA_CPU_TARGET("ssse3")
+static size_type encode_ssse3( char const *from, size_type from_len,
+                               char *to ) {
+  __m128i const shuffle = ZORBA_LOAD_128( encode_shuffle );
+  __m128i const offsets = ZORBA_LOAD_128( encode_offsets );
+  char const *const from_orig = from;
+
+  //
+  // Only 12 of the 16 bytes loaded are encoded.
+  //
+  for ( ; from_len >= 16; from += 12, from_len -= 12, to += 16 ) {
+    __m128i in = _mm_loadu_si128( reinterpret_cast<__m128i const*>( from ) );
+    in = _mm_shuffle_epi8( in, shuffle );
+    __m128i const t0 = _mm_and_si128( in, _mm_set1_epi32( 0x0FC0FC00 ) );
+    __m128i const t1 = _mm_mulhi_epu16( t0, _mm_set1_epi32( 0x04000040 ) );
+    __m128i const t2 = _mm_and_si128( in, _mm_set1_epi32( 0x003F03F0 ) );
+    __m128i const t3 = _mm_mullo_epi16( t2, _mm_set1_epi32( 0x01000010 ) );
+    __m128i const values = _mm_or_si128( t1, t3 );
+    __m128i index = _mm_subs_epu8( values, _mm_set1_epi8( 51 ) );
+    __m128i const less = _mm_cmpgt_epi8( _mm_set1_epi8( 26 ), values );
+    index = _mm_or_si128( index, _mm_and_si128( less, _mm_set1_epi8( 13 ) ) );
+    __m128i const out =
+      _mm_add_epi8( _mm_shuffle_epi8( offsets, index ), values );
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( to ), out );
+  }
+  return from - from_orig;
+}
+
+ZORBA_CPU_TARGET("ssse3")
+static size_type decode_ssse3( char const *from, size_type from_len,
+                               char *to ) {
+  __m128i const lo_bits = ZORBA_LOAD_128( decode_lo_bits );
+  __m128i const hi_bits = ZORBA_LOAD_128( decode_hi_bits );
+  __m128i const offsets = ZORBA_LOAD_128( decode_offsets );
+  __m128i const pack = ZORBA_LOAD_128( decode_pack );
+  char const *const from_orig = from;
+
+  for ( ; from_len >= 16; from += 16, from_len -= 16 ) {
+    __m128i in = _mm_loadu_si128( reinterpret_cast<__m128i const*>( from ) );
+    __m128i const hi_nibbles =
+      _mm_and_si128( _mm_srli_epi32( in, 4 ), _mm_set1_epi8( 0x0F ) );
+    __m128i const lo_nibbles = _mm_and_si128( in, _mm_set1_epi8( 0x0F ) );
+    __m128i const invalid = _mm_and_si128(
+      _mm_shuffle_epi8( lo_bits, lo_nibbles ),
+      _mm_shuffle_epi8( hi_bits, hi_nibbles )
+    );
+    if ( _mm_movemask_epi8( _mm_cmpgt_epi8( invalid, _mm_setzero_si128() ) ) )
+      break;
+    if ( to ) {
+      __m128i const is_slash = _mm_cmpeq_epi8( in, _mm_set1_epi8( '/' ) );
+      in = _mm_add_epi8(
+        in, _mm_shuffle_epi8( offsets, _mm_add_epi8( is_slash, hi_nibbles ) )
+      );
+      in = _mm_maddubs_epi16( in, _mm_set1_epi32( 0x01400140 ) );
+      in = _mm_madd_epi16( in, _mm_set1_epi32( 0x00011000 ) );
+      in = _mm_shuffle_epi8( in, pack );
+      _mm_storel_epi64( reinterpret_cast<__m128i*>( to ), in );
+      int32_t const last = _mm_cvtsi128_si32( _mm_srli_si128( in, 8 ) );
+      ::memcpy( to + 8, &last, sizeof last );
+      to += 12;
+    }
+  }
+  return from - from_orig;
+}
+
+ZORBA_CPU_TARGET("avx2")
+static size_type encode_avx2( char const *from, size_type from_len,
+                              char *to ) {
+  __m256i const shuffle = ZORBA_LOAD_256( encode_shuffle );
+  __m256i const offsets = ZORBA_LOAD_256( encode_offsets );
+  char const *const from_orig = from;
+
+  //
+  // Each 128-bit lane gets 12 of the 24 bytes encoded; the second load reads
+  // 4 bytes beyond them, hence the 28.
+  //
+  for ( ; from_len >= 28; from += 24, from_len -= 24, to += 32 ) {
+    __m256i in = _mm256_inserti128_si256(
+      _mm256_castsi128_si256(
+        _mm_loadu_si128( reinterpret_cast<__m128i const*>( from ) )
+      ),
+      _mm_loadu_si128( reinterpret_cast<__m128i const*>( from + 12 ) ), 1
+    );
+    in = _mm256_shuffle_epi8( in, shuffle );
+    __m256i const t0 = _mm256_and_si256( in, _mm256_set1_epi32( 0x0FC0FC00 ) );
+    __m256i const t1 =
+      _mm256_mulhi_epu16( t0, _mm256_set1_epi32( 0x04000040 ) );
+    __m256i const t2 = _mm256_and_si256( in, _mm256_set1_epi32( 0x003F03F0 ) );
+    __m256i const t3 =
+      _mm256_mullo_epi16( t2, _mm256_set1_epi32( 0x01000010 ) );
+    __m256i const values = _mm256_or_si256( t1, t3 );
+    __m256i index = _mm256_subs_epu8( values, _mm256_set1_epi8( 51 ) );
+    __m256i const less = _mm256_cmpgt_epi8( _mm256_set1_epi8( 26 ), values );
+    index = _mm256_or_si256(
+      index, _mm256_and_si256( less, _mm256_set1_epi8( 13 ) )
+    );
+    __m256i const out =
+      _mm256_add_epi8( _mm256_shuffle_epi8( offsets, index ), values );
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( to ), out );
+  }
+  return from - from_orig;
+}
+
+ZORBA_CPU_TARGET("avx2")
+static size_type decode_avx2( char const *from, size_type from_len,
+                              char *to ) {
+  __m256i const lo_bits = ZORBA_LOAD_256( decode_lo_bits );
+  __m256i const hi_bits = ZORBA_LOAD_256( decode_hi_bits );
+  __m256i const offsets = ZORBA_LOAD_256( decode_offsets );
+  __m256i const pack = ZORBA_LOAD_256( decode_pack );
+  __m256i const join_lanes = _mm256_setr_epi32( 0, 1, 2, 4, 5, 6, 3, 7 );
+  char const *const from_orig = from;
+
+  for ( ; from_len >= 32; from += 32, from_len -= 32 ) {
+    __m256i in =
+      _mm256_loadu_si256( reinterpret_cast<__m256i const*>( from ) );
+    __m256i const hi_nibbles =
+      _mm256_and_si256( _mm256_srli_epi32( in, 4 ), _mm256_set1_epi8( 0x0F ) );
+    __m256i const lo_nibbles = _mm256_and_si256( in, _mm256_set1_epi8( 0x0F ) );
+    __m256i const invalid = _mm256_and_si256(
+      _mm256_shuffle_epi8( lo_bits, lo_nibbles ),
+      _mm256_shuffle_epi8( hi_bits, hi_nibbles )
+    );
+    if ( _mm256_movemask_epi8(
+           _mm256_cmpgt_epi8( invalid, _mm256_setzero_si256() ) ) )
+      break;
+    if ( to ) {
+      __m256i const is_slash = _mm256_cmpeq_epi8( in, _mm256_set1_epi8( '/' ) );
+      in = _mm256_add_epi8(
+        in,
+        _mm256_shuffle_epi8( offsets, _mm256_add_epi8( is_slash, hi_nibbles ) )
+      );
+      in = _mm256_maddubs_epi16( in, _mm256_set1_epi32( 0x01400140 ) );
+      in = _mm256_madd_epi16( in, _mm256_set1_epi32( 0x00011000 ) );
+      in = _mm256_shuffle_epi8( in, pack );
+      in = _mm256_permutevar8x32_epi32( in, join_lanes );
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i*>( to ), _mm256_castsi256_si128( in )
+      );
+      _mm_storel_epi64(
+        reinterpret_cast<__m128i*>( to + 16 ), _mm256_extracti128_si256( in, 1 )
+      );
+      to += 24;
+    }
+  }
+  return from - from_orig;
+}
+
+#undef ZORBA_LOAD_256
+#undef ZORBA_LOAD_128
+
+static size_type encode_simd( char const *from, size_type from_len,
+                              char *to ) {
+  size_type n = 0;
+  switch ( cpu::get_simd_level() ) {
+    case cpu::simd_avx2:
+      n = encode_avx2( from, from_len, to );
+      from += n, from_len -= n, to += n / 3 * 4;
+      // fall through
+    case cpu::simd_ssse3:
+      return n + encode_ssse3( from, from_len, to );
+    default:
+      return 0;
+  }
+}
+
+static size_type decode_simd( char const *from, size_type from_len,
+                              char *to ) {
+  size_type n = 0;
+  switch ( cpu::get_simd_level() ) {
+    case cpu::simd_avx2:
+      n = decode_avx2( from, from_len, to );
+      from += n, from_len -= n;
+      if ( from_len >= 32 )
+        return n;                       // stopped at a non-Base64 character
+      if ( to )
+        to += n / 4 * 3;
+      // fall through
+    case cpu::simd_ssse3:
+      return n + decode_ssse3( from, from_len, to );
+    default:
+      return 0;
+  }
+}
+#endif /* ZORBA_CPU_X86_SIMD */
+
+///////////////////////////////////////////////////////////////////////////////
+
 size_type decode( char const *from, size_type from_len, char *to,
                   int options ) {
   char chunk[4];
@@ -129,6 +390,18 @@ size_type decode( char const *from, size_type from_len, char *to,
   char const *const to_orig = to;
 
   for ( size_type pos = 0; pos < from_len; ++pos, ++from ) {
+#ifdef ZORBA_CPU_X86_SIMD
+    if ( !(chunk_len % 4) && !pads && from_len - pos >= 16 ) {
+      if ( size_type const n = decode_simd( from, from_len - pos, to ) ) {
+        pos += n, from += n;
+        if ( to )
+          to += n / 4 * 3;
+        chunk_len = 0;
+        if ( pos == from_len )
+          break;
+      }
+    }
+#endif /* ZORBA_CPU_X86_SIMD */
     char const c = *from;
     signed char value;
     if ( c == '=' ) {
@@ -285,6 +558,11 @@ size_type encode( char const *from, size_type from_len, char *to ) {
   char const *const to_orig = to;
   int chunk_len = 0;
 
+#ifdef ZORBA_CPU_X86_SIMD
+  size_type const n = encode_simd( from, from_len, to );
+  from += n, from_len -= n, to += n / 3 * 4;
+#endif /* ZORBA_CPU_X86_SIMD */
+
   while ( from_len-- ) {
     if ( ++chunk_len == 3 ) {
       encode_chunk( from, to );
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "stdafx.h"
+
+#include <fstream>
+#include <thread>
+
+#include "api/bulk_loader.h"
+
+#include "diagnostics/xquery_diagnostics.h"
+#include "diagnostics/zorba_exception.h"
+
+#include "runtime/json/json_loader.h"
+
+#include "store/api/store.h"
+
+#include "system/globalenv.h"
+
+#include "util/ascii_util.h"
+
+
+namespace zorba
+{
+
+/*******************************************************************************
+
+********************************************************************************/
+BulkLoader::BulkLoader(const std::vector<zstring>& files, csize numThreads)
+  :
+  theFiles(files),
+  theNumThreads(numThreads),
+  theResults(files.size()),
+  theErrors(files.size()),
+  theNextFile(0),
+  theStopAt(files.size()),
+  theNumBytes(0)
+{
+  if (theNumThreads == 0)
+    theNumThreads = std::thread::hardware_concurrency();
+
+#ifdef ZORBA_FOR_ONE_THREAD_ONLY
+  theNumThreads = 1;
+#endif
+
+  if (theNumThreads == 0)
+    theNumThreads = 1;
+
+  if (theNumThreads > files.size())
+    theNumThreads = (files.empty() ? 1 : files.size());
+
+  theLoadProperties.setStoreDocument(false);
+}
+
+
+/*******************************************************************************
+  Parse all the files and append the resulting items to the given vector, in
+  the order of the files.
+********************************************************************************/
+void BulkLoader::load(std::vector<store::Item_t>& items)
+{
+  if (theNumThreads == 1)
+  {
+    csize pos;
+    while (claimFile(pos))
+      loadFile(pos);
+  }
+  else
+  {
+    std::vector<std::unique_ptr<Worker> > workers(theNumThreads);
+
+    for (csize i = 0; i < theNumThreads; ++i)
+    {
+      workers[i].reset(new Worker(*this));
+      workers[i]->start();
+    }
+
+    for (csize i = 0; i < theNumThreads; ++i)
+      workers[i]->join();
+  }
+
+  if (theStopAt < theFiles.size())
+    std::rethrow_exception(theErrors[theStopAt]);
+
+  for (csize i = 0; i < theResults.size(); ++i)
+  {
+    items.insert(items.end(), theResults[i].begin(), theResults[i].end());
+    theResults[i].clear();
+  }
+}
+
+
+/*******************************************************************************
+  Set pos to the position of the next file to parse. Return false if there are
+  no more files or a file before it has failed.
+********************************************************************************/
+bool BulkLoader::claimFile(csize& pos)
+{
+  SYNC_CODE(AutoMutex lock(&theMutex);)
+
+  if (theNextFile >= theStopAt)
+    return false;
+
+  pos = theNextFile++;
+  return true;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void BulkLoader::loadFile(csize pos)
+{
+  const zstring& file = theFiles[pos];
+  std::vector<store::Item_t>& result = theResults[pos];
+  unsigned long long size = 0;
+
+  try
+  {
+    std::ifstream stream(file.c_str(), std::ios::in | std::ios::binary);
+
+    if (!stream)
+      throw ZORBA_EXCEPTION(zerr::ZOSE0001_FILE_NOT_FOUND, ERROR_PARAMS(file));
+
+    stream.seekg(0, std::ios::end);
+    size = stream.tellg();
+    stream.seekg(0, std::ios::beg);
+
+    if (ascii::ends_with(file, ".json"))
+    {
+      json::loader loader(stream, true);
+      loader.set_loc(file.c_str(), 1, 1);
+
+      store::Item_t item;
+      while (loader.next(&item))
+        result.push_back(item);
+    }
+    else
+    {
+      store::Item_t doc = GENV_STORE.loadDocument(file,
+                                                  file,
+                                                  stream,
+                                                  theLoadProperties);
+      if (doc != NULL)
+        result.push_back(doc);
+    }
+  }
+  catch (...)
+  {
+    SYNC_CODE(AutoMutex lock(&theMutex);)
+
+    theErrors[pos] = std::current_exception();
+
+    if (pos < theStopAt)
+      theStopAt = pos;
+
+    return;
+  }
+
+  SYNC_CODE(AutoMutex lock(&theMutex);)
+  theNumBytes += size;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void BulkLoader::Worker::run()
+{
+  csize pos;
+
+  while (theLoader.claimFile(pos))
+    theLoader.loadFile(pos);
+}
+
+
+} // namespace zorba
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef ZORBA_API_BULK_LOADER_H
+#define ZORBA_API_BULK_LOADER_H
+
+#include <exception>
+#include <memory>
+#include <vector>
+
+#include <zorba/zorba_exception.h>
+
+#include "common/common.h"
+
+#include "store/api/item.h"
+#include "store/api/load_properties.h"
+
+#include "zorbatypes/zstring.h"
+
+#include "zorbautils/mutex.h"
+#include "zorbautils/runnable.h"
+
+
+namespace zorba
+{
+
+/*******************************************************************************
+  Parses a list of XML and JSON files on a pool of worker threads.
+
+  Each worker repeatedly claims the next unparsed file and parses it with its
+  own loader: files whose name ends with ".json" are read with a json::loader
+  (and may contain several top-level items); all other files are loaded as XML
+  documents by the store, which creates a fresh FastXmlLoader (with its own
+  libxml parser context and string dictionary) for each of them. The parsed
+  trees are not stored in the store's document set.
+
+  The result of each file is kept in theResults at the position of the file,
+  so load() returns the items in the order of the given files, no matter
+  which worker parsed which file.
+
+  If some file cannot be parsed, the workers stop claiming files that come
+  after it, and load() rethrows the error of the first such file. Since files
+  are claimed in order, this is the same error that a sequential load would
+  raise. Any exception is caught on the worker thread (e.g. std::bad_alloc as
+  well as ZorbaException) and rethrown by load() on the calling thread.
+
+  theNextFile : Position of the next file to be claimed by a worker.
+  theStopAt   : Position of the first file that failed, or the number of files.
+  theNumBytes : Total size of the parsed files.
+********************************************************************************/
+class BulkLoader
+{
+protected:
+  class Worker : public Runnable
+  {
+  protected:
+    BulkLoader  & theLoader;
+
+  public:
+    Worker(BulkLoader& loader) : theLoader(loader) {}
+
+    ~Worker() {}
+
+  protected:
+    void run();
+
+    void finish() {}
+  };
+
+protected:
+  const std::vector<zstring>                   & theFiles;
+  csize                                          theNumThreads;
+
+  store::LoadProperties                          theLoadProperties;
+
+  std::vector<std::vector<store::Item_t> >       theResults;
+  std::vector<std::exception_ptr>                theErrors;
+
+  SYNC_CODE(Mutex                                theMutex;)
+  csize                                          theNextFile;
+  csize                                          theStopAt;
+  unsigned long long                             theNumBytes;
+
+public:
+  BulkLoader(const std::vector<zstring>& files, csize numThreads);
+
+  void load(std::vector<store::Item_t>& items);
+
+  unsigned long long numBytes() const { return theNumBytes; }
+
+protected:
+  bool claimFile(csize& pos);
+
+  void loadFile(csize pos);
+};
+
+
+} // namespace zorba
+
+#endif
+/* vim:set et sw=2 ts=2: */
@@ -26,9 +26,13 @@
 #include <zorba/iterator.h>
 #include <zorba/singleton_item_sequence.h>
 #include <zorba/typeident.h>
+#include <zorba/vector_item_sequence.h>
+#include <zorba/util/time.h>
 
+#include "api/bulk_loader.h"
 #include "api/zorbaimpl.h"
 #include "api/unmarshaller.h"
+#include "api/xqueryimpl.h"
 
 #include "diagnostics/assert.h"
 #include "diagnostics/xquery_diagnostics.h"
@@ -51,6 +55,8 @@
 
 #include "compiler/xqddf/collection_decl.h"
 
+#include "zorbamisc/ns_consts.h"
+
 namespace zorba {
 
 #define ZORBA_DM_TRY                                    \
@@ -172,6 +178,81 @@ CollectionImpl::insertNodesLast(const ItemSequence_t& aNodes)
 }
 
 
+/*******************************************************************************
+  Parse the files on a BulkLoader and insert the results with a single
+  insert-last. The parsed documents are not referenced by anything else, so
+  the update is done under the no-copy pragma.
+********************************************************************************/
+void
+CollectionImpl::loadDocumentsLast(
+    const std::vector<String>& aFiles,
+    unsigned int aNumThreads,
+    BulkLoadStats* aStats)
+{
+  ZORBA_DM_TRY
+  {
+    time::walltime lStart, lStop;
+    time::get_current_walltime(lStart);
+
+    std::vector<zstring> lFiles;
+    lFiles.reserve(aFiles.size());
+
+    for (std::vector<String>::const_iterator lIter = aFiles.begin();
+         lIter != aFiles.end();
+         ++lIter)
+    {
+      lFiles.push_back(Unmarshaller::getInternalString(*lIter));
+    }
+
+    BulkLoader lLoader(lFiles, aNumThreads);
+    std::vector<store::Item_t> lItems;
+    lLoader.load(lItems);
+
+    std::vector<Item> lDocs;
+    lDocs.reserve(lItems.size());
+
+    for (csize i = 0; i < lItems.size(); ++i)
+      lDocs.push_back(Item(lItems[i].getp()));
+
+    lItems.clear();
+
+    std::ostringstream lQueryStr;
+    lQueryStr
+      << "import module namespace d = '" << theNS << "';" << std::endl
+      << "declare namespace ext = '" << ZORBA_EXTENSIONS_NS << "';" << std::endl
+      << "declare variable $name as xs:QName external;" << std::endl
+      << "declare variable $docs external;" << std::endl
+      << "(# ext:no-copy #) { d:"
+      << (theNS.find("w3c") != std::string::npos ?
+          "insert-nodes-last" : "insert-last")
+      << "($name, $docs) }";
+
+    Zorba_CompilerHints_t lHints;
+    XQuery_t lQuery(new XQueryImpl());
+    lQuery->compile(lQueryStr.str(), theContext, lHints);
+
+    ItemSequence_t lDocSeq = new VectorItemSequence(lDocs);
+
+    DynamicContext* lDctx = lQuery->getDynamicContext();
+    lDctx->setVariable("name", theQName);
+    lDctx->setVariable("docs", lDocSeq->getIterator());
+
+    lQuery->execute();
+    lQuery->close();
+
+    time::get_current_walltime(lStop);
+
+    if (aStats)
+    {
+      aStats->theNumDocuments = lDocs.size();
+      aStats->theNumBytes = lLoader.numBytes();
+      aStats->theElapsedMillis = time::get_walltime_elapsed(lStart, lStop);
+    }
+  }
+  ZORBA_DM_CATCH
+}
+
+
 /*******************************************************************************
 
 ********************************************************************************/
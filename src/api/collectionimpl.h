@@ -98,6 +98,12 @@ protected:
   
   virtual void
   insertNodesLast(const ItemSequence_t& aNodes);
+
+  virtual void
+  loadDocumentsLast(
+      const std::vector<String>& aFiles,
+      unsigned int aNumThreads,
+      BulkLoadStats* aStats);
   
   virtual void
   insertNodesBefore(const Item& aTarget, const ItemSequence_t& aNodes);
@@ -33,6 +33,7 @@
 #include "api/unmarshaller.h"
 #include "api/zorbaimpl.h"
 #include "api/xqueryimpl.h"
+#include "api/xqueryexecutionimpl.h"
 #include "api/item_iter_query_result.h"
 #include "api/item_iter_store.h"
 #include "api/dynamiccontextimpl.h"
@@ -79,13 +80,28 @@ namespace zorba {
 ********************************************************************************/
 DynamicContextImpl::DynamicContextImpl(const XQueryImpl* aQuery)
   :
-  theQuery(aQuery)
+  theQuery(aQuery),
+  theExecution(NULL)
 {
   theCtx = theQuery->theDynamicContext;
   theStaticContext = theQuery->theStaticContext.getp();
 }
 
 
+/****************************************************************************//**
+
+********************************************************************************/
+DynamicContextImpl::DynamicContextImpl(const XQueryExecutionImpl* aExecution)
+  :
+  theQuery(aExecution->theQuery),
+  theExecution(aExecution),
+  theCtx(aExecution->theDynamicContext),
+  theSnapshotID(0)
+{
+  theStaticContext = theQuery->theStaticContext.getp();
+}
+
+
 /****************************************************************************//**
 
 ********************************************************************************/
@@ -924,8 +940,10 @@ bool DynamicContextImpl::setDefaultCollection(const Item& aCollectionUri)
 ********************************************************************************/
 void DynamicContextImpl::checkNoIterators() const
 {
-  if (theQuery->theResultIterator &&
-      theQuery->theResultIterator->isOpen())
+  const ResultIteratorImpl* iter = (theExecution ?
+                                    theExecution->theResultIterator :
+                                    theQuery->theResultIterator);
+  if (iter && iter->isOpen())
   {
     throw ZORBA_EXCEPTION( zerr::ZAPI0027_CANNOT_UPDATE_DCTX_WITH_ITERATORS );
   }
@@ -1054,7 +1072,7 @@ DynamicContextImpl::isBoundExternalVariable(const String& aNamespace, const Stri
 {
   ZORBA_DCTX_TRY
   {
-    if(theQuery->isBoundVariable(aNamespace, aLocalname))
+    if(theQuery->isBoundVariable(aNamespace, aLocalname, theCtx))
       return true;
   }
   ZORBA_DCTX_CATCH
@@ -1070,7 +1088,7 @@ DynamicContextImpl::isBoundContextItem() const
   ZORBA_DCTX_TRY
   {
     String varName = Unmarshaller::newString(static_context::DOT_VAR_NAME);
-    if(theQuery->isBoundVariable("", varName))
+    if(theQuery->isBoundVariable("", varName, theCtx))
       return true;
   }
   ZORBA_DCTX_CATCH
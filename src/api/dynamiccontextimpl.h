@@ -26,6 +26,7 @@ namespace zorba {
 
 class DiagnosticHandler;
 class XQueryImpl;
+class XQueryExecutionImpl;
 class VarInfo;
 
 
@@ -35,11 +36,17 @@ class VarInfo;
 
   An instance of DynamicContextImpl is created when the application asks for
   the dynamic context of a query (see XQueryImpl::getDynamicContext() method).
-  There can be at most one instance of DynamicContextImpl per XQuery.
+  There can be at most one instance of DynamicContextImpl per XQuery, plus one
+  per execution of the query (see XQueryExecutionImpl::getDynamicContext()).
   DynamicContextImpl does not own any of the other objs that it points to.
 
+  theExecution :
+  The execution whose dynamic context is wrapped by this obj, or NULL if this
+  obj wraps the dynamic context of the query itself.
+
   theCtx :
-  Pointer to the internal dynamic_context obj (which is owned by the XQuery obj).
+  Pointer to the internal dynamic_context obj (which is owned by the XQuery obj,
+  or by theExecution).
 
   theStaticContext :
   Pointer to the internal static_context obj (which is owned by the XQuery obj).
@@ -54,6 +61,7 @@ class DynamicContextImpl : public DynamicContext
 {
   friend class Unmarshaller; // needs to get the context out of this class
   friend class XQueryImpl;
+  friend class XQueryExecutionImpl;
   friend class ExtFunctionCallIterator;  // ExtFunctionCallIterator needs to
                                          // create a wrapper to a dynamic_context
                                          // to pass it to the external function
@@ -62,6 +70,8 @@ class DynamicContextImpl : public DynamicContext
 protected:
   const XQueryImpl          * theQuery;
 
+  const XQueryExecutionImpl * theExecution;
+
   dynamic_context           * theCtx;
 
   static_context            * theStaticContext;
@@ -74,6 +84,8 @@ protected:
 protected:
   DynamicContextImpl(const XQueryImpl* aQuery);
 
+  DynamicContextImpl(const XQueryExecutionImpl* aExecution);
+
   // Used by ExtFunctionCallIterator to create a temporary wrapper
   DynamicContextImpl(
       const XQueryImpl* aQuery,
@@ -81,6 +93,7 @@ protected:
       static_context* aSctx)
     :
     theQuery(aQuery),
+    theExecution(NULL),
     theCtx(aDctx),
     theStaticContext(aSctx),
     theSnapshotID(0)
@@ -15,6 +15,8 @@
  */
 
 #include <zorba/function.h>
+#include <zorba/empty_sequence.h>
+#include <zorba/singleton_item_sequence.h>
 
 namespace zorba {
 
@@ -26,5 +28,25 @@ ExternalFunction::~ExternalFunction() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+size_t BatchExternalFunction::getBatchSize() const {
+  return 1024;
+}
+
+ItemSequence_t
+BatchExternalFunction::evaluate( Arguments_t const &args ) const {
+  ArgumentTuples_t tuples( 1 );
+  for ( unsigned i = 0; i < args.size(); ++i )
+    tuples[0].push_back( getItem( args, i ) );
+
+  std::vector<Item> results;
+  evaluateBatch( tuples, results );
+
+  if ( results.empty() || results[0].isNull() )
+    return new EmptySequence();
+  return new SingletonItemSequence( results[0] );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 } // namespace zorba
 /* vim:set et sw=2 ts=2: */
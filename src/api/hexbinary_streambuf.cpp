@@ -87,9 +87,12 @@ streambuf::int_type streambuf::overflow( int_type c ) {
 streambuf::int_type streambuf::pbackfail( int_type c ) {
   if ( !traits_type::eq_int_type( c, traits_type::eof() ) &&
        gptr() > eback() ) {
-    c = orig_buf_->sputbackc( traits_type::to_char_type( c ) );
-    if ( !traits_type::eq_int_type( c, traits_type::eof() ) )
-      gbump( -1 );
+    //
+    // The get buffer holds decoded bytes that were read ahead, so the byte
+    // must be put back into it rather than into the original streambuf.
+    //
+    gbump( -1 );
+    *gptr() = traits_type::to_char_type( c );
     return c;
   }
   return traits_type::eof();
@@ -99,25 +102,29 @@ streambuf::int_type streambuf::underflow() {
 #ifdef ZORBA_DEBUG_HEXBINARY_STREAMBUF
   printf( "underflow()\n" );
 #endif
-  char chunk[2];
-  int chunk_len = 0;
+  //
+  // Decode as many bytes as fit into the get buffer at once rather than one at
+  // a time so that hexbinary::decode() can use its SIMD version.
+  //
+  char ebuf[ sizeof gbuf_ * 2 ];
+  streamsize ebuf_len = orig_buf_->sgetn( ebuf, sizeof ebuf );
 
-  while ( gptr() >= egptr() ) {
+  //
+  // A short read doesn't necessarily mean EOF: complete the last byte (if
+  // possible) since only the very last one may be partial.
+  //
+  if ( ebuf_len % 2 ) {
     int_type const c = orig_buf_->sbumpc();
-    bool is_eof = false;
-    if ( traits_type::eq_int_type( c, traits_type::eof() ) ) {
-      if ( !chunk_len )
-        return traits_type::eof();
-      is_eof = true;
-    } else {
-      chunk[ chunk_len++ ] = traits_type::to_char_type( c );
-    }
-    if ( chunk_len == sizeof chunk || (is_eof && chunk_len) ) {
-      streamsize const n = hexbinary::decode( chunk, chunk_len, eback() );
-      setg( gbuf_, gbuf_, gbuf_ + n );
-    }
+    if ( !traits_type::eq_int_type( c, traits_type::eof() ) )
+      ebuf[ ebuf_len++ ] = traits_type::to_char_type( c );
   }
-  return traits_type::to_int_type( *gptr() );
+  if ( !ebuf_len )
+    return traits_type::eof();
+
+  streamsize const n =
+    hexbinary::decode( ebuf, static_cast<size_type>( ebuf_len ), gbuf_ );
+  setg( gbuf_, gbuf_, gbuf_ + n );
+  return n ? traits_type::to_int_type( *gptr() ) : traits_type::eof();
 }
 
 streamsize streambuf::xsgetn( char_type *to, streamsize size ) {
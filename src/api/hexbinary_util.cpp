@@ -23,8 +23,13 @@
 // Zorba
 #include <zorba/util/hexbinary_util.h>
 #include <zorba/util/mem_streambuf.h>
+#include "util/cpu_util.h"
 #include "util/string_util.h"
 
+#ifdef ZORBA_CPU_X86_SIMD
+# include <emmintrin.h>
+#endif
+
 using namespace std;
 
 namespace zorba {
@@ -72,6 +77,104 @@ static signed char const decode_table[] = {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#ifdef ZORBA_CPU_X86_SIMD
+//
+// The SSE2 versions of encode() and decode() process as many whole blocks of
+// 16 bytes (32 hexadecimal digits) as they can and return the number of bytes
+// of "from" they consumed: the caller processes the rest.  Decoding stops at
+// the first block that contains a non-hexadecimal-digit so that the caller
+// reports the error as before.
+//
+
+/**
+ * Converts each nibble (0-15) to its uppercase hexadecimal digit.
+ */
+ZORBA_CPU_TARGET("sse2")
+static inline __m128i hex_digits( __m128i nibbles ) {
+  __m128i const letter = _mm_cmpgt_epi8( nibbles, _mm_set1_epi8( 9 ) );
+  return _mm_add_epi8(
+    _mm_add_epi8( nibbles, _mm_set1_epi8( '0' ) ),
+    _mm_and_si128( letter, _mm_set1_epi8( 'A' - '0' - 10 ) )
+  );
+}
+
+/**
+ * Converts each hexadecimal digit (of either case) to its value and sets
+ *  valid to whether they all were hexadecimal digits; then combines each
+ * pair of values into a byte in the low half of each 16-bit word.
+ */
+ZORBA_CPU_TARGET("sse2")
+static inline __m128i hex_values( __m128i digits, bool *valid ) {
+  __m128i const d = _mm_sub_epi8( digits, _mm_set1_epi8( '0' ) );
+  __m128i const is_d =
+    _mm_cmpeq_epi8( _mm_min_epu8( d, _mm_set1_epi8( 9 ) ), d );
+  __m128i const l = _mm_sub_epi8(
+    _mm_or_si128( digits, _mm_set1_epi8( 0x20 ) ), _mm_set1_epi8( 'a' )
+  );
+  __m128i const is_l =
+    _mm_cmpeq_epi8( _mm_min_epu8( l, _mm_set1_epi8( 5 ) ), l );
+  *valid = _mm_movemask_epi8( _mm_or_si128( is_d, is_l ) ) == 0xFFFF;
+  __m128i const v = _mm_or_si128(
+    _mm_and_si128( is_d, d ),
+    _mm_and_si128( is_l, _mm_add_epi8( l, _mm_set1_epi8( 10 ) ) )
+  );
+  return _mm_or_si128(
+    _mm_slli_epi16( _mm_and_si128( v, _mm_set1_epi16( 0x00FF ) ), 4 ),
+    _mm_srli_epi16( v, 8 )
+  );
+}
+
+ZORBA_CPU_TARGET("sse2")
+static size_type encode_sse2( char const *from, size_type from_len,
+                              char *to ) {
+  char const *const from_orig = from;
+
+  for ( ; from_len >= 16; from += 16, from_len -= 16, to += 32 ) {
+    __m128i const in =
+      _mm_loadu_si128( reinterpret_cast<__m128i const*>( from ) );
+    __m128i const nibble_mask = _mm_set1_epi8( 0x0F );
+    __m128i const hi =
+      hex_digits( _mm_and_si128( _mm_srli_epi16( in, 4 ), nibble_mask ) );
+    __m128i const lo = hex_digits( _mm_and_si128( in, nibble_mask ) );
+    _mm_storeu_si128(
+      reinterpret_cast<__m128i*>( to ), _mm_unpacklo_epi8( hi, lo )
+    );
+    _mm_storeu_si128(
+      reinterpret_cast<__m128i*>( to + 16 ), _mm_unpackhi_epi8( hi, lo )
+    );
+  }
+  return from - from_orig;
+}
+
+ZORBA_CPU_TARGET("sse2")
+static size_type decode_sse2( char const *from, size_type from_len,
+                              char *to ) {
+  char const *const from_orig = from;
+  bool valid_lo, valid_hi;
+
+  for ( ; from_len >= 32; from += 32, from_len -= 32 ) {
+    __m128i const lo = hex_values(
+      _mm_loadu_si128( reinterpret_cast<__m128i const*>( from ) ), &valid_lo
+    );
+    __m128i const hi = hex_values(
+      _mm_loadu_si128( reinterpret_cast<__m128i const*>( from + 16 ) ),
+      &valid_hi
+    );
+    if ( !(valid_lo && valid_hi) )
+      break;
+    if ( to ) {
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i*>( to ), _mm_packus_epi16( lo, hi )
+      );
+      to += 16;
+    }
+  }
+  return from - from_orig;
+}
+#endif /* ZORBA_CPU_X86_SIMD */
+
+///////////////////////////////////////////////////////////////////////////////
+
 size_type decode( char const *from, size_type from_len, char *to,
                   int options ) {
   bool const ignore_ws = !!(options & dopt_ignore_ws);
@@ -85,6 +188,15 @@ size_type decode( char const *from, size_type from_len, char *to,
   char const *const to_orig = to;
   char c;
 
+#ifdef ZORBA_CPU_X86_SIMD
+  if ( cpu::get_simd_level() >= cpu::simd_sse2 ) {
+    size_type const n = decode_sse2( from, from_len, to );
+    from += n;
+    if ( to )
+      to += n / 2;
+  }
+#endif /* ZORBA_CPU_X86_SIMD */
+
   while ( from < from_end ) {
     signed char const high = decode_table[ (unsigned char)(c = *from++) ];
     if ( high == -1 )
@@ -187,6 +299,14 @@ size_type encode( char const *from, size_type from_len, char *to ) {
   static char const encode_table[] = "0123456789ABCDEF";
 
   char const *const to_orig = to;
+
+#ifdef ZORBA_CPU_X86_SIMD
+  if ( cpu::get_simd_level() >= cpu::simd_sse2 ) {
+    size_type const n = encode_sse2( from, from_len, to );
+    from += n, from_len -= n, to += n * 2;
+  }
+#endif /* ZORBA_CPU_X86_SIMD */
+
   while ( from_len-- ) {
     unsigned char const c = *from++;
     *to++ = encode_table[ c >> 4   ];
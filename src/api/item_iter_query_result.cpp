@@ -24,6 +24,7 @@
 
 #include "api/item_iter_query_result.h"
 #include "api/unmarshaller.h"
+#include "api/xqueryexecutionimpl.h"
 #include "api/xqueryimpl.h"
 #include "api/zorbaimpl.h"
 
@@ -80,9 +81,11 @@ catch (...)                                                         \
 ********************************************************************************/
 ResultIteratorImpl::ResultIteratorImpl(
     XQueryImpl* aQuery,
-    const PlanWrapper_t& aPlanWrapper)
+    const PlanWrapper_t& aPlanWrapper,
+    XQueryExecutionImpl* aExecution)
   :
   theQuery(aQuery),
+  theExecution(aExecution),
   thePlan(aPlanWrapper),
   theIsOpen(false),
   theHaveLock(false)
@@ -99,7 +102,7 @@ ResultIteratorImpl::~ResultIteratorImpl()
   {
     if (theIsOpen && thePlan)
     {
-      theQuery->dispose(thePlan);
+      dispose();
     }
 
     SYNC_CODE(
@@ -111,7 +114,10 @@ ResultIteratorImpl::~ResultIteratorImpl()
 
     if (theQuery)
     {
-      theQuery->removeResultIterator(this);
+      if (theExecution)
+        theExecution->removeResultIterator(this);
+      else
+        theQuery->removeResultIterator(this);
       theQuery = NULL;
     }
   }
@@ -143,7 +149,10 @@ void ResultIteratorImpl::open()
 
     theIsOpen = true;
 
-    theQuery->theExecuting = true;
+    if (theExecution)
+      theExecution->theExecuting = true;
+    else
+      theQuery->theExecuting = true;
   } 
   RESULT_ITER_CATCH
 }
@@ -197,7 +206,7 @@ void ResultIteratorImpl::close()
 
     theIsOpen = false;
 
-    theQuery->dispose(thePlan);
+    dispose();
 
     SYNC_CODE(
     if (theHaveLock)
@@ -219,7 +228,7 @@ void ResultIteratorImpl::closeInternal()
   {
     if (thePlan)
     {
-      theQuery->dispose(thePlan);
+      dispose();
       thePlan = NULL;
     }
 
@@ -238,5 +247,18 @@ void ResultIteratorImpl::closeInternal()
 }
 
 
+/*******************************************************************************
+  Ends the run of the plan for the query or the execution that this iterator
+  belongs to.
+********************************************************************************/
+void ResultIteratorImpl::dispose()
+{
+  if (theExecution)
+    theExecution->dispose(thePlan);
+  else
+    theQuery->dispose(thePlan);
+}
+
+
 } /* namespace zorba */
 /* vim:set et sw=2 ts=2: */
@@ -25,25 +25,35 @@ namespace zorba {
 
 class DiagnosticHandler;
 class XQueryImpl;
+class XQueryExecutionImpl;
 
 /*******************************************************************************
   Iterator used for computing and retrieving the result of a query in a 
   one-item-at-a-time fashion. For each XQuery there can be at most 1 result
   iterator obj: it is created during the 1st invocation of the XQuery::iterator()
   method and destroyed when the query is closed.
+
+  If theExecution is not NULL, the iterator computes the result of that
+  execution of the query (see XQueryExecutionImpl::iterator()) instead of the
+  result of the query itself.
 ********************************************************************************/
 class ResultIteratorImpl  : public Iterator
 {
   friend class XQueryImpl;
+  friend class XQueryExecutionImpl;
   friend class Unmarshaller;
 
 protected:
-  XQueryImpl     * theQuery; 
-  PlanWrapper_t    thePlan;         
-  bool             theIsOpen;
-  bool             theHaveLock;
+  XQueryImpl          * theQuery; 
+  XQueryExecutionImpl * theExecution;
+  PlanWrapper_t         thePlan;         
+  bool                  theIsOpen;
+  bool                  theHaveLock;
 
-  ResultIteratorImpl(XQueryImpl*, const PlanWrapper_t&);
+  ResultIteratorImpl(
+      XQueryImpl*,
+      const PlanWrapper_t&,
+      XQueryExecutionImpl* = NULL);
 
 public:
   ~ResultIteratorImpl();
@@ -58,6 +68,8 @@ public:
 
 protected:
   void closeInternal();
+
+  void dispose();
 };
 
 
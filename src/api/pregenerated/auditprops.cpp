@@ -6,11 +6,18 @@ const PropertyImpl XQUERY_COMPILATION_TRANSLATION_DURATION(XQUERY_COMPILATION, "
 const PropertyImpl XQUERY_COMPILATION_OPTIMIZATION_DURATION(XQUERY_COMPILATION, "optimization-duration", 3, Property::INT);
 const PropertyImpl XQUERY_COMPILATION_CODEGENERATION_DURATION(XQUERY_COMPILATION, "codegeneration-duration", 4, Property::INT);
 
+const char* XQUERY_EXECUTION_[] = { "xquery", "execution" };
+const PropertyGroupImpl XQUERY_EXECUTION(2, XQUERY_EXECUTION_);
+const PropertyImpl XQUERY_EXECUTION_MEMORY_PEAK(XQUERY_EXECUTION, "memory-peak", 5, Property::INT);
+const PropertyImpl XQUERY_EXECUTION_MEMORY_ALLOCATED(XQUERY_EXECUTION, "memory-allocated", 6, Property::INT);
+
 
 const PropertyImpl* PROPERTIES[] = {
   &XQUERY_COMPILATION_FILENAME,
   &XQUERY_COMPILATION_PARSE_DURATION,
   &XQUERY_COMPILATION_TRANSLATION_DURATION,
   &XQUERY_COMPILATION_OPTIMIZATION_DURATION,
-  &XQUERY_COMPILATION_CODEGENERATION_DURATION
+  &XQUERY_COMPILATION_CODEGENERATION_DURATION,
+  &XQUERY_EXECUTION_MEMORY_PEAK,
+  &XQUERY_EXECUTION_MEMORY_ALLOCATED
 };
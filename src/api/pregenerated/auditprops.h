@@ -5,3 +5,7 @@ extern const PropertyImpl XQUERY_COMPILATION_TRANSLATION_DURATION;
 extern const PropertyImpl XQUERY_COMPILATION_OPTIMIZATION_DURATION;
 extern const PropertyImpl XQUERY_COMPILATION_CODEGENERATION_DURATION;
 
+extern const PropertyGroupImpl XQUERY_EXECUTION;
+extern const PropertyImpl XQUERY_EXECUTION_MEMORY_PEAK;
+extern const PropertyImpl XQUERY_EXECUTION_MEMORY_ALLOCATED;
+
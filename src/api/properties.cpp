@@ -38,17 +38,23 @@ Properties::Properties() {
 #endif /* NDEBUG */
   owns_debug_stream_ = false;
   collect_profile_ = false;
+  data_guides_ = true;
   debug_stream_.reset( &cout );
+  doc_projection_ = true;
   dump_lib_ = false;
   force_gflwor_ = false;
+  hash_joins_ = true;
   infer_joins_ = true;
   inline_udf_ = true;
+  json_scan_ = true;
+  lazy_builtins_ = true;
   loop_hoisting_ = true;
   max_udf_call_depth_ = 1024;
   no_copy_optim_ = true;
   no_tree_ids_ = false;
   no_uncalled_iterators_ = false;
   optimization_level_ = 1;
+  parallel_flwor_threads_ = 0;
   plan_format_ = PLAN_FORMAT_NONE;
   print_ast_ = false;
   print_intermediate_opt_ = false;
@@ -63,8 +69,11 @@ Properties::Properties() {
 #ifndef ZORBA_NO_FULL_TEXT
   trace_fulltext_ = false;
 #endif /* ZORBA_NO_FULL_TEXT */
+  trace_doc_projection_ = false;
   trace_parsing_ = false;
   trace_scanning_ = false;
+  trace_startup_ = false;
+  trace_string_dictionary_ = false;
   trace_translator_ = false;
   use_indexes_ = true;
   wall_time_threshold_ = 0;
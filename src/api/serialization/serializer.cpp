@@ -19,6 +19,7 @@
 #include <iomanip>
 
 #include <zorba/zorba_string.h>
+#include <zorba/util/base64_util.h>
 #include <zorba/util/transcode_stream.h>
 
 #include "diagnostics/xquery_diagnostics.h"
@@ -51,6 +52,7 @@
 #include "store/api/item.h"
 #include "store/api/item_factory.h"
 #include "store/api/copymode.h"
+#include "store/util/string_chunk_reader.h"
 
 namespace zorba {
 
@@ -372,24 +374,16 @@ void serializer::emitter::emit_streamable_item(store::Item* item)
   {
   case store::XS_STRING:
   {
-    char buffer[1024];
-    int rollover = 0;
-    std::streambuf *  pbuf;
-    std::streamsize   read_bytes;
-    std::istream& is = item->getStream();
+    // read chunks that never split a UTF-8 character and do string expansion
+    store::StringChunkReader reader;
+    const char* chunk;
+    csize chunkSize;
 
-    // read bytes and do string expansion
-    do
+    reader.init(item, true, store::StringChunkReader::DEFAULT_CHUNK_SIZE, true);
+    while (reader.next(chunk, chunkSize))
     {
-      // std::istream::read uses a try/catch internally so the Zorba_Exception
-      // is lost: that is why we are using std::streambuf::sgetn
-      pbuf = is.rdbuf();
-
-      read_bytes = pbuf->sgetn(buffer + rollover, 1024 - rollover);
-
-      rollover = emit_expanded_string(buffer, static_cast<zstring::size_type>(read_bytes + rollover));
-      memmove(buffer, buffer + 1024 - rollover, rollover);
-    } while (read_bytes > 0);
+      emit_expanded_string(chunk, static_cast<zstring::size_type>(chunkSize));
+    }
     break;
   }
   case store::XS_BASE64BINARY:
@@ -406,7 +400,7 @@ void serializer::emitter::emit_streamable_item(store::Item* item)
     }
     else
     {
-      tr << item->getStringValue();
+      base64::encode(item->getStream(), tr);
     }
     break;
   }
@@ -2200,9 +2194,7 @@ void serializer::binary_emitter::emit_item(store::Item* item)
     std::istream& stream = item->getStream();
     if (item->isEncoded())
     {
-      zstring decoded;
-      Base64::decode(stream, &decoded);
-      tr << decoded;
+      Base64::decode(stream, tr);
     }
     else
     {
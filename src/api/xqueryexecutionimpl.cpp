@@ -0,0 +1,320 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "stdafx.h"
+
+#include "api/xqueryexecutionimpl.h"
+
+#include <zorba/diagnostic_list.h>
+#include <zorba/properties.h>
+
+#include "diagnostics/xquery_diagnostics.h"
+#include "zorbautils/lock.h"
+
+#include "system/globalenv.h"
+
+#include "api/dynamiccontextimpl.h"
+#include "api/item_iter_query_result.h"
+#include "api/serialization/serializer.h"
+#include "api/serializerimpl.h"
+#include "api/xqueryimpl.h"
+#include "api/zorbaimpl.h"
+
+#include "context/dynamic_context.h"
+
+#include "compiler/api/compilercb.h"
+
+#include "runtime/base/plan_iterator.h"
+#include "runtime/api/plan_wrapper.h"
+#include "runtime/util/flowctl_exception.h"
+
+#include "store/api/store.h"
+#include "store/api/memory_account.h"
+
+namespace zorba
+{
+
+#define EXECUTION_CATCH                                                       \
+  catch (ZorbaException const& e)                                             \
+  {                                                                           \
+    ZorbaImpl::notifyError(theQuery->theDiagnosticHandler, e);                \
+  }                                                                           \
+  catch (FlowCtlException&)                                                   \
+  {                                                                           \
+    ZorbaImpl::notifyError(theQuery->theDiagnosticHandler, "User interrupt"); \
+  }                                                                           \
+  catch (std::exception const& e)                                             \
+  {                                                                           \
+    ZorbaImpl::notifyError(theQuery->theDiagnosticHandler, e.what());         \
+  }                                                                           \
+  catch (...)                                                                 \
+  {                                                                           \
+    ZorbaImpl::notifyError(theQuery->theDiagnosticHandler);                   \
+  }
+
+
+/*******************************************************************************
+
+********************************************************************************/
+XQueryExecutionImpl::XQueryExecutionImpl(XQueryImpl* aQuery)
+  :
+  theQuery(aQuery),
+  theDynamicContext(new dynamic_context(aQuery->theDynamicContext)),
+  theDynamicContextWrapper(NULL),
+  theResultIterator(NULL),
+  theExecuting(false),
+  theMemoryPeak(0),
+  theMemoryAllocated(0)
+{
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+XQueryExecutionImpl::~XQueryExecutionImpl()
+{
+  if (theResultIterator != NULL)
+  {
+    theResultIterator->closeInternal();
+    theResultIterator = NULL;
+  }
+
+  delete theDynamicContextWrapper;
+  delete theDynamicContext;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+DynamicContext* XQueryExecutionImpl::getDynamicContext() const
+{
+  try
+  {
+    theQuery->checkNotClosed();
+
+    if (!theDynamicContextWrapper)
+      theDynamicContextWrapper = new DynamicContextImpl(this);
+
+    return theDynamicContextWrapper;
+  }
+  EXECUTION_CATCH
+  return 0;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void XQueryExecutionImpl::execute(
+    std::ostream& os,
+    const Zorba_SerializerOptions_t* opt)
+{
+  try
+  {
+    checkRunnable();
+
+    SYNC_CODE(AutoLock lock(GENV_STORE.getGlobalLock(), Lock::READ);)
+
+    PlanWrapper_t lPlan = generateWrapper();
+
+    theExecuting = true;
+
+    try
+    {
+      lPlan->open();
+
+      serializer lSerializer(theQuery->theXQueryDiagnostics);
+
+      if (opt != NULL)
+      {
+        const Zorba_SerializerOptions_t lOptions = *opt;
+        SerializerImpl::setSerializationParameters(lSerializer, lOptions);
+      }
+
+      lSerializer.serialize(lPlan.getp(), os);
+    }
+    catch (...)
+    {
+      dispose(lPlan);
+      throw;
+    }
+
+    dispose(lPlan);
+  }
+  EXECUTION_CATCH
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void XQueryExecutionImpl::execute()
+{
+  try
+  {
+    checkRunnable();
+
+    if (!theQuery->theCompilerCB->isUpdating())
+      throw ZORBA_EXCEPTION(zerr::ZAPI0008_NOT_AN_UPDATE_XQUERY);
+
+    SYNC_CODE(AutoLock lock(GENV_STORE.getGlobalLock(), Lock::WRITE);)
+
+    PlanWrapper_t lPlan = generateWrapper();
+
+    theExecuting = true;
+
+    try
+    {
+      // call next once in order to apply updates
+      lPlan->open();
+
+      store::Item_t lItem;
+      bool more = lPlan->next(lItem);
+      assert(more == false);
+      (void)more; // to avoid compiler warning in release mode
+    }
+    catch (...)
+    {
+      dispose(lPlan);
+      throw;
+    }
+
+    dispose(lPlan);
+  }
+  EXECUTION_CATCH
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+Iterator_t XQueryExecutionImpl::iterator()
+{
+  try
+  {
+    checkRunnable();
+
+    if (theResultIterator)
+      throw ZORBA_EXCEPTION(zerr::ZAPI0039_XQUERY_HAS_ITERATOR_ALREADY);
+
+    PlanWrapper_t lPlan = generateWrapper();
+
+    theResultIterator = new ResultIteratorImpl(theQuery, lPlan, this);
+    return Iterator_t(theResultIterator);
+  }
+  EXECUTION_CATCH
+  return Iterator_t();
+}
+
+
+/*******************************************************************************
+  Called only from ~ResultIteratorImpl()
+********************************************************************************/
+void XQueryExecutionImpl::removeResultIterator(const ResultIteratorImpl* iter)
+{
+  assert(theResultIterator == iter);
+  (void)iter;
+
+  theResultIterator = NULL;
+  theExecuting = false;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+unsigned long long XQueryExecutionImpl::getMemoryPeak() const
+{
+  return theMemoryPeak;
+}
+
+
+unsigned long long XQueryExecutionImpl::getMemoryAllocated() const
+{
+  return theMemoryAllocated;
+}
+
+
+/*******************************************************************************
+  Like XQueryImpl::generateWrapper(), but the plan state of the new wrapper
+  belongs to this execution. The memory counters of the run are kept by this
+  execution only: they are not recorded in the audit event of the query,
+  which is shared by all its executions.
+********************************************************************************/
+PlanWrapper_t XQueryExecutionImpl::generateWrapper()
+{
+  CompilerCB* ccb = theQuery->theCompilerCB;
+
+  theDynamicContext->reset_current_date_time();
+
+  PlanWrapper_t lPlan = new PlanWrapper(
+      static_cast<PlanIterator*>(theQuery->thePlanProxy->theRootIter.getp()),
+      ccb,
+      theDynamicContext,
+      theQuery,
+      0, // stack depth
+      ccb->theHaveTimeout,
+      ccb->theTimeout);
+
+  if (theQuery->theSampleFormat != SAMPLE_FORMAT_NONE)
+    lPlan->enableSampling(theQuery->theSampleInterval);
+
+  if (theQuery->theMemoryAccounting)
+    lPlan->enableMemoryAccounting(theQuery->theMemoryLimit);
+
+  return lPlan;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void XQueryExecutionImpl::dispose(PlanWrapper_t const& plan)
+{
+  theExecuting = false;
+  if (plan->isOpen())
+  {
+    if (Properties::instance().getProfileFormat() != PROFILE_FORMAT_NONE)
+      plan->profile();
+    if (theQuery->theSampleFormat != SAMPLE_FORMAT_NONE)
+      plan->printSamples(theQuery->theSampleFormat);
+    plan->close();
+  }
+  if (const store::MemoryAccount* account = plan->getMemoryAccount())
+  {
+    theMemoryPeak = account->getPeak();
+    theMemoryAllocated = account->getAllocated();
+  }
+}
+
+
+/*******************************************************************************
+  Check that the query is still open and that this execution is not running
+  already. The query has been compiled, otherwise createExecution() would have
+  failed.
+********************************************************************************/
+void XQueryExecutionImpl::checkRunnable() const
+{
+  theQuery->checkNotClosed();
+
+  if (theExecuting)
+    throw ZORBA_EXCEPTION(zerr::ZAPI0005_XQUERY_ALREADY_EXECUTING);
+}
+
+
+} // namespace zorba
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef ZORBA_API_XQUERY_EXECUTION_IMPL_H
+#define ZORBA_API_XQUERY_EXECUTION_IMPL_H
+
+#include <zorba/xquery.h>
+
+#include "common/shared_types.h"
+
+namespace zorba
+{
+
+class DynamicContextImpl;
+class ResultIteratorImpl;
+class XQueryImpl;
+class dynamic_context;
+
+
+/*******************************************************************************
+  One execution of a compiled query (see XQuery::createExecution()).
+
+  An execution shares everything that the compiler produced (the plan, the
+  static contexts, and the CompilerCB) with its query, and owns only the
+  state of one run: its dynamic context and, while it runs, the PlanWrapper
+  (and thus the PlanState) of the shared plan. None of the query members it
+  uses is modified after compilation, so executions neither lock the query's
+  mutex nor touch the (unsynchronized) reference count of the query. The
+  query must therefore stay open for as long as its executions are used.
+
+  - theQuery :
+  The query this is an execution of. Not owned.
+
+  - theDynamicContext :
+  The dynamic context of this execution. It is a child of the dynamic context
+  of the query and is owned by this execution.
+
+  - theDynamicContextWrapper :
+  The DynamicContextImpl that wraps theDynamicContext. It is created lazily by
+  getDynamicContext().
+
+  - theResultIterator :
+  The iterator created by iterator(), if any. As for queries, there can be at
+  most one at a time (see XQueryImpl::theResultIterator).
+
+  - theExecuting :
+  Set to true while this execution runs.
+
+  - theMemoryPeak :
+  - theMemoryAllocated :
+  The memory counters of the last accounted run of this execution.
+********************************************************************************/
+class XQueryExecutionImpl : public XQueryExecution
+{
+  friend class DynamicContextImpl;
+  friend class ResultIteratorImpl;
+
+protected:
+  XQueryImpl                       * theQuery;
+
+  dynamic_context                  * theDynamicContext;
+
+  mutable DynamicContextImpl       * theDynamicContextWrapper;
+
+  ResultIteratorImpl               * theResultIterator;
+
+  bool                               theExecuting;
+
+  uint64_t                           theMemoryPeak;
+  uint64_t                           theMemoryAllocated;
+
+public:
+  XQueryExecutionImpl(XQueryImpl* aQuery);
+
+  ~XQueryExecutionImpl();
+
+  DynamicContext* getDynamicContext() const;
+
+  void execute(std::ostream&, const Zorba_SerializerOptions_t* = NULL);
+
+  void execute();
+
+  Iterator_t iterator();
+
+  unsigned long long getMemoryPeak() const;
+
+  unsigned long long getMemoryAllocated() const;
+
+protected:
+  PlanWrapper_t generateWrapper();
+
+  void dispose(PlanWrapper_t const&);
+
+  void removeResultIterator(const ResultIteratorImpl* iter);
+
+  void checkRunnable() const;
+};
+
+
+} // namespace zorba
+#endif /* ZORBA_API_XQUERY_EXECUTION_IMPL_H */
+/*
+ * Local variables:
+ * mode: c++
+ * End:
+ */
+/* vim:set et sw=2 ts=2: */
@@ -49,6 +49,7 @@
 #include "api/serializerimpl.h"
 #include "api/auditimpl.h"
 #include "api/staticcollectionmanagerimpl.h"
+#include "api/xqueryexecutionimpl.h"
 #include "api/item_iter_vector.h"
 
 #include "context/static_context.h"
@@ -69,6 +70,7 @@
 #include "store/api/item.h"
 #include "store/api/store.h"
 #include "store/api/item_factory.h"
+#include "store/api/memory_account.h"
 
 #include "zorbaserialization/bin_archiver.h"
 #include "zorbaserialization/class_serializer.h"
@@ -151,6 +153,12 @@ XQueryImpl::XQueryImpl()
   theSAX2Handler(0),
   theDocLoadingUserTime(0.0),
   theDocLoadingTime(0.0),
+  theSampleFormat(SAMPLE_FORMAT_NONE),
+  theSampleInterval(1),
+  theMemoryAccounting(false),
+  theMemoryLimit(0),
+  theMemoryPeak(0),
+  theMemoryAllocated(0),
 #ifdef ZORBA_WITH_DEBUGGER
   theIsDebugMode(false),
 #endif
@@ -252,6 +260,48 @@ void XQueryImpl::setTimeout(long aTimeout /* = -1 */)
 }
 
 
+/*******************************************************************************
+
+********************************************************************************/
+void XQueryImpl::setSampling(
+    Zorba_sample_format_t aFormat,
+    unsigned long aInterval)
+{
+  SYNC_CODE(AutoMutex lock(&theMutex);)
+
+  theSampleFormat = aFormat;
+  theSampleInterval = (aInterval == 0 ? 1 : aInterval);
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void XQueryImpl::setMemoryAccounting(bool aEnable, unsigned long long aLimit)
+{
+  SYNC_CODE(AutoMutex lock(&theMutex);)
+
+  theMemoryAccounting = aEnable;
+  theMemoryLimit = (aEnable ? aLimit : 0);
+}
+
+
+unsigned long long XQueryImpl::getMemoryPeak() const
+{
+  SYNC_CODE(AutoMutex lock(&theMutex);)
+
+  return theMemoryPeak;
+}
+
+
+unsigned long long XQueryImpl::getMemoryAllocated() const
+{
+  SYNC_CODE(AutoMutex lock(&theMutex);)
+
+  return theMemoryAllocated;
+}
+
+
 /*******************************************************************************
 
 ********************************************************************************/
@@ -715,6 +765,33 @@ XQuery_t XQueryImpl::clone() const
 }
 
 
+/*******************************************************************************
+  An execution shares the plan, the static contexts, and the CompilerCB of this
+  query, none of which changes after compilation. So, unlike clone(), this
+  method does not take theMutex, and it must not modify the query (which is
+  why it does not use QUERY_CATCH: notifyAllWarnings() clears the warnings).
+********************************************************************************/
+XQueryExecution_t XQueryImpl::createExecution() const
+{
+  try
+  {
+    checkNotClosed();
+    checkCompiled();
+
+    return new XQueryExecutionImpl(const_cast<XQueryImpl*>(this));
+  }
+  catch (ZorbaException const& e)
+  {
+    ZorbaImpl::notifyError(theDiagnosticHandler, e);
+  }
+  catch (std::exception const& e)
+  {
+    ZorbaImpl::notifyError(theDiagnosticHandler, e.what());
+  }
+  return XQueryExecution_t();
+}
+
+
 /*******************************************************************************
 
  ******************************************************************************/
@@ -725,8 +802,34 @@ void XQueryImpl::dispose( PlanWrapper_t const &plan ) {
   {
     if ( Properties::instance().getProfileFormat() != PROFILE_FORMAT_NONE )
       plan->profile();
+    if ( theSampleFormat != SAMPLE_FORMAT_NONE )
+      plan->printSamples( theSampleFormat );
     plan->close();
   }
+  if ( plan->getMemoryAccount() != NULL )
+    recordMemoryUsage( plan->getMemoryAccount() );
+}
+
+
+/*******************************************************************************
+  Keeps the memory counters of an execution that has just ended, and records
+  them in the audit event of the query.
+********************************************************************************/
+void XQueryImpl::recordMemoryUsage(const store::MemoryAccount* account)
+{
+  theMemoryPeak = account->getPeak();
+  theMemoryAllocated = account->getAllocated();
+
+  audit::Event* ae = theCompilerCB->theRootSctx->get_audit_event();
+  zorba::audit::ScopedRecord sar(ae);
+
+  if (ae->audit(audit::XQUERY_EXECUTION_MEMORY_PEAK))
+    sar.getRecord()->add(audit::XQUERY_EXECUTION_MEMORY_PEAK,
+                         static_cast<long long>(theMemoryPeak));
+
+  if (ae->audit(audit::XQUERY_EXECUTION_MEMORY_ALLOCATED))
+    sar.getRecord()->add(audit::XQUERY_EXECUTION_MEMORY_ALLOCATED,
+                         static_cast<long long>(theMemoryAllocated));
 }
 
 /*******************************************************************************
@@ -814,7 +917,8 @@ void XQueryImpl::getExternalVariables(Iterator_t& aVarsIter) const
 ********************************************************************************/
 bool XQueryImpl::isBoundVariable(
     const String& aNamespace,
-    const String& aLocalname) const
+    const String& aLocalname,
+    const dynamic_context* aDctx) const
 {
   try
   {
@@ -855,7 +959,7 @@ bool XQueryImpl::isBoundVariable(
     
     ulong varId = var->getId();
 
-    if (theDynamicContext->is_set_variable(varId))
+    if (aDctx->is_set_variable(varId))
       return true;
 
     return false;
@@ -1348,6 +1452,18 @@ PlanWrapper_t XQueryImpl::generateWrapper()
       theCompilerCB->theHaveTimeout,
       theCompilerCB->theTimeout);
 
+  if (theSampleFormat != SAMPLE_FORMAT_NONE)
+    lPlan->enableSampling(theSampleInterval);
+
+  audit::Event* ae = theCompilerCB->theRootSctx->get_audit_event();
+
+  if (theMemoryAccounting ||
+      ae->audit(audit::XQUERY_EXECUTION_MEMORY_PEAK) ||
+      ae->audit(audit::XQUERY_EXECUTION_MEMORY_ALLOCATED))
+  {
+    lPlan->enableMemoryAccounting(theMemoryLimit);
+  }
+
   return lPlan;
 }
 
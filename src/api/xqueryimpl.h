@@ -129,6 +129,24 @@ class ModuleInfo;
   - theSAX2Handler :
   sax content handler that provide event-based xml parser
 
+  - theSampleFormat :
+  The format in which the samples of each execution of this query are printed,
+  or SAMPLE_FORMAT_NONE if the executions are not sampled (see setSampling()).
+
+  - theSampleInterval :
+  The sampling interval, in milliseconds.
+
+  - theMemoryAccounting :
+  Whether the memory used by each execution of this query is accounted (see
+  setMemoryAccounting()).
+
+  - theMemoryLimit :
+  The memory limit of each execution, in bytes, or 0 if there is none.
+
+  - theMemoryPeak :
+  - theMemoryAllocated :
+  The memory counters of the last accounted execution of this query.
+
   - theIsDebugMode :
 
   - theStaticCollectionMgr : 
@@ -140,6 +158,7 @@ class ModuleInfo;
 class XQueryImpl : public XQuery , public ::zorba::serialization::SerializeBaseClass
 {
   friend class ResultIteratorImpl;
+  friend class XQueryExecutionImpl;
   friend class StaticContextImpl;  // StaticContextImpl::loadProlog() needs this
   friend class DynamicContextImpl;
   friend class CompilerCB;
@@ -202,6 +221,14 @@ class XQueryImpl : public XQuery , public ::zorba::serialization::SerializeBaseC
   double                             theDocLoadingUserTime;
   double                             theDocLoadingTime;
 
+  Zorba_sample_format_t              theSampleFormat;
+  unsigned long                      theSampleInterval;
+
+  bool                               theMemoryAccounting;
+  uint64_t                           theMemoryLimit;
+  uint64_t                           theMemoryPeak;
+  uint64_t                           theMemoryAllocated;
+
 private:
 #ifdef ZORBA_WITH_DEBUGGER
   bool                               theIsDebugMode;
@@ -225,6 +252,14 @@ public:
 
   void setTimeout(long aTimeout /* = -1 */);
 
+  void setSampling(Zorba_sample_format_t aFormat, unsigned long aInterval);
+
+  void setMemoryAccounting(bool aEnable, unsigned long long aLimit);
+
+  unsigned long long getMemoryPeak() const;
+
+  unsigned long long getMemoryAllocated() const;
+
   double getDocLoadingUserTime() const;
 
   double getDocLoadingTime() const;
@@ -335,6 +370,8 @@ public:
 
   XQuery_t clone() const;
 
+  XQueryExecution_t createExecution() const;
+
   StaticCollectionManager*
   getStaticCollectionManager() const;
 
@@ -372,6 +409,8 @@ protected:
 
   void dispose( PlanWrapper_t const& );
 
+  void recordMemoryUsage(const store::MemoryAccount* account);
+
   void removeResultIterator(const ResultIteratorImpl* iter);
 
   void checkNotClosed() const;
@@ -388,7 +427,10 @@ protected:
 
   void notifyAllWarnings() const;
 
-  bool isBoundVariable(const String& aNamespace, const String& aLocalname) const;
+  bool isBoundVariable(
+        const String& aNamespace,
+        const String& aLocalname,
+        const dynamic_context* aDctx) const;
 
   void parse(std::istream& aQuery, ModuleInfo_t& aResult);
 };
@@ -79,6 +79,12 @@ typedef rchandle<LetVarIterator> LetVarIter_t;
 class ValueIndexInsertSession;
 typedef rchandle<ValueIndexInsertSession> ValueIndexInsertSession_t;
 
+class HashJoinTable;
+typedef rchandle<HashJoinTable> HashJoinTable_t;
+
+class JSONScan;
+typedef rchandle<JSONScan> JSONScan_t;
+
 
 // Parsenodes
 class parsenode;
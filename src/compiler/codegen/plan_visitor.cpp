@@ -29,6 +29,7 @@
 #include "util/hashmap32.h"
 #include "util/indent.h"
 #include "util/stl_util.h"
+#include "util/string_util.h"
 #include "util/tracer.h"
 
 #include "system/globalenv.h"
@@ -37,6 +38,7 @@
 #include "compiler/api/compilercb.h"
 #include "compiler/codegen/plan_visitor.h"
 #include "compiler/expression/expr.h"
+#include "compiler/expression/expr_iter.h"
 #include "compiler/expression/expr_visitor.h"
 #include "compiler/expression/flwor_expr.h"
 #include "compiler/expression/fo_expr.h"
@@ -71,6 +73,8 @@
 #include "runtime/core/path_iterators.h"
 #include "runtime/core/nodeid_iterators.h"
 #include "runtime/core/flwor_iterator.h"
+#include "runtime/core/parallel_for_iterator.h"
+#include "runtime/core/batch_call_iterator.h"
 #include "runtime/core/trycatch.h"
 #include "runtime/errors_and_diagnostics/other_diagnostics.h"
 #include "runtime/core/gflwor/common.h"
@@ -350,6 +354,10 @@ protected:
 
   std::vector<FlworClauseVarMap_t>           theClauseStack;
 
+  std::vector<const flwor_expr*>             theParallelFlwors;
+
+  std::vector<std::pair<const flwor_expr*, PlanIter_t> > theBatchFlwors;
+
   CompilerCB                               * theCCB;
 
 #ifdef ZORBA_WITH_DEBUGGER
@@ -940,6 +948,16 @@ bool begin_visit(flwor_expr& v)
   bool isGeneral = v.compute_is_general();
 
   v.set_general(isGeneral);
+
+  // A FLWOR nested inside a parallel FLWOR is evaluated sequentially by each
+  // worker thread.
+  if (theParallelFlwors.empty() && !isGeneral && is_parallel_candidate(v))
+    theParallelFlwors.push_back(&v);
+
+  // The iterator of the batch call is recorded by end_visit(fo_expr&) and
+  // used by flwor_codegen() to build the BatchCallIterator.
+  if (!isGeneral && is_batch_candidate(v))
+    theBatchFlwors.push_back(std::make_pair(&v, PlanIter_t()));
     
   if (v.is_sequential())
   {
@@ -2038,6 +2056,60 @@ void flwor_codegen(const flwor_expr& flworExpr)
 
   std::reverse(forletClauses.begin(), forletClauses.end());
 
+  PlanIter_t batchCall;
+
+  if (!theBatchFlwors.empty() && theBatchFlwors.back().first == &flworExpr)
+  {
+    batchCall = theBatchFlwors.back().second;
+    theBatchFlwors.pop_back();
+  }
+
+  if (!theParallelFlwors.empty() && theParallelFlwors.back() == &flworExpr)
+  {
+    theParallelFlwors.pop_back();
+
+    std::vector<const flwor_expr*> scopes(1, &flworExpr);
+
+    if ((whereIter == NULL ||
+         is_parallel_safe(static_cast<const where_clause*>(flworExpr.get_clause(1))->
+                          get_expr(), scopes)) &&
+        is_parallel_safe(flworExpr.get_return_expr(), scopes))
+    {
+      pragma* pr = 0;
+      theCCB->lookup_pragma(&flworExpr, "parallel", pr);
+
+      csize numThreads = 0;
+      try
+      {
+        if (!pr->theContent.empty())
+          numThreads = ztd::aton<unsigned>(pr->theContent.c_str());
+      }
+      catch (std::exception const&)
+      {
+        // not a number of threads: use the default
+      }
+
+      push_itstack(new flwor::ParallelForIterator(flworExpr.get_sctx(),
+                                                  flworExpr.get_loc(),
+                                                  forletClauses[0],
+                                                  whereIter,
+                                                  returnIter,
+                                                  numThreads));
+      return;
+    }
+  }
+
+  if (batchCall != NULL)
+  {
+    push_itstack(new flwor::BatchCallIterator(flworExpr.get_sctx(),
+                                              flworExpr.get_loc(),
+                                              forletClauses[0],
+                                              whereIter,
+                                              returnIter,
+                                              batchCall));
+    return;
+  }
+
   flworIter = new flwor::FLWORIterator(flworExpr.get_sctx(),
                                        flworExpr.get_loc(),
                                        forletClauses,
@@ -2053,6 +2125,149 @@ void flwor_codegen(const flwor_expr& flworExpr)
 }
 
 
+/*******************************************************************************
+  Return true if the given FLWOR is marked with the parallel pragma and has the
+  form accepted by ParallelForIterator: a non-general, non-sequential and
+  non-updating FLWOR with a single FOR clause (without "allowing empty"),
+  an optional WHERE clause, and a RETURN clause.
+********************************************************************************/
+bool is_parallel_candidate(const flwor_expr& v)
+{
+  pragma* pr = 0;
+  if (!theCCB->lookup_pragma(&v, "parallel", pr))
+    return false;
+
+  if (v.is_sequential() || v.is_updating())
+    return false;
+
+  csize numClauses = v.num_clauses();
+
+  if (numClauses == 0 || numClauses > 2)
+    return false;
+
+  const flwor_clause* c = v.get_clause(0);
+
+  if (c->get_kind() != flwor_clause::for_clause ||
+      static_cast<const for_clause*>(c)->is_allowing_empty())
+    return false;
+
+  if (numClauses == 2 &&
+      v.get_clause(1)->get_kind() != flwor_clause::where_clause)
+    return false;
+
+  return true;
+}
+
+
+/*******************************************************************************
+  Return true if the given expr may be evaluated by a worker thread of a
+  ParallelForIterator. The worker threads only bind the FOR and positional
+  vars of the parallel FLWOR (the first entry of scopes), so the expr must not
+  reference any other var, except for prolog vars and vars defined by FLWORs
+  inside the expr itself. Furthermore, it must not bind anything in the
+  dynamic context, which is shared by the workers, nor call a udf whose
+  results are cached.
+********************************************************************************/
+bool is_parallel_safe(expr* e, std::vector<const flwor_expr*>& scopes)
+{
+  switch (e->get_expr_kind())
+  {
+  case var_expr_kind:
+  {
+    const var_expr* var = static_cast<const var_expr*>(e);
+
+    if (var->get_kind() == var_expr::prolog_var)
+      return true;
+
+    const flwor_clause* c = var->get_flwor_clause();
+
+    return (c != NULL &&
+            std::find(scopes.begin(), scopes.end(), c->get_flwor_expr()) !=
+            scopes.end());
+  }
+  case flwor_expr_kind:
+  {
+    scopes.push_back(static_cast<const flwor_expr*>(e));
+
+    bool safe = true;
+    ExprIterator iter(e);
+    while (safe && !iter.done())
+    {
+      safe = is_parallel_safe(**iter, scopes);
+      iter.next();
+    }
+
+    scopes.pop_back();
+    return safe;
+  }
+  case fo_expr_kind:
+  {
+    const function* f = static_cast<const fo_expr*>(e)->get_func();
+
+    if (f->getKind() == FunctionConsts::OP_CREATE_INTERNAL_INDEX_2 ||
+        f->getKind() == FunctionConsts::OP_HASH_JOIN_BUILD_2)
+      return false;
+
+    if (f->isUdf() && static_cast<const user_function*>(f)->hasCache())
+      return false;
+
+    break;
+  }
+  default:
+  {
+    break;
+  }
+  }
+
+  ExprIterator iter(e);
+  while (!iter.done())
+  {
+    if (!is_parallel_safe(**iter, scopes))
+      return false;
+
+    iter.next();
+  }
+
+  return true;
+}
+
+
+/*******************************************************************************
+  Return true if the rewriter has found the return clause of the given FLWOR
+  to be a call to a batch external function (see flwor_expr::get_batch_call())
+  and the FLWOR still has the form accepted by BatchCallIterator: a single FOR
+  clause, an optional WHERE clause, and the call, possibly wrapped in a treat
+  expr, as its RETURN clause. Later rewrites (e.g. loop hoisting) may have
+  changed the FLWOR since the call was found.
+********************************************************************************/
+bool is_batch_candidate(const flwor_expr& v)
+{
+  const expr* call = v.get_batch_call();
+
+  if (call == NULL)
+    return false;
+
+  const expr* ret = v.get_return_expr();
+
+  if (ret->get_expr_kind() == treat_expr_kind)
+    ret = static_cast<const treat_expr*>(ret)->get_input();
+
+  if (ret != call)
+    return false;
+
+  csize numClauses = v.num_clauses();
+
+  if (numClauses == 0 || numClauses > 2)
+    return false;
+
+  if (v.get_clause(0)->get_kind() != flwor_clause::for_clause)
+    return false;
+
+  return (numClauses == 1 ||
+          v.get_clause(1)->get_kind() == flwor_clause::where_clause);
+}
+
+
 void generate_groupby(
     const FlworClauseVarMap* clauseVarMap,
     std::vector<flwor::GroupingSpec>& gspecs,
@@ -2504,6 +2719,10 @@ void end_visit(fo_expr& v)
     ZORBA_ASSERT(iter != NULL);
     push_itstack(iter);
 
+    if (!theBatchFlwors.empty() &&
+        theBatchFlwors.back().first->get_batch_call() == &v)
+      theBatchFlwors.back().second = iter;
+
     if (is_enclosed_expr(&v))
     {
       expr* e = plan_visitor_ns::pop_stack(theConstructorsStack);
@@ -2816,13 +3035,38 @@ void end_visit(match_expr& v)
 #else
 
 /*******************************************************************************
-
+  If the rewriter has marked the path as a twig pattern, and its steps still
+  form one, only the first step is translated as usual, and the remaining
+  (child or descendant element name) steps are evaluated together by a
+  TwigPathIterator over its result. Otherwise, each axis step creates its own
+  axis iterator.
 ********************************************************************************/
 bool begin_visit(relpath_expr& v)
 {
   CODEGEN_TRACE_IN("");
-  // Done in axis itself
-  return true;
+
+  if (!v.use_twig_join() || !v.is_twig_pattern())
+    return true;
+
+  v[0]->accept(*this);
+
+  PlanIter_t input = pop_itstack();
+
+  csize numSteps = v.numSteps();
+  std::vector<store::Item_t> names(numSteps - 1);
+  std::vector<bool> descendantSteps(numSteps - 1);
+
+  for (csize i = 1; i < numSteps; ++i)
+  {
+    axis_step_expr* axisStep = static_cast<axis_step_expr*>(v[i]);
+
+    names[i - 1] = axisStep->getTest()->getQName();
+    descendantSteps[i - 1] = (axisStep->getAxis() == axis_kind_descendant);
+  }
+
+  push_itstack(new TwigPathIterator(sctx, qloc, input, names, descendantSteps));
+
+  return false;
 }
 
 
@@ -2866,7 +3110,7 @@ bool begin_visit(axis_step_expr& v)
   }
   case axis_kind_descendant:
   {
-    axisIte = new DescendantAxisIterator(sctx, qloc, input);
+    axisIte = new DescendantAxisIterator(sctx, qloc, input, v.use_data_guide());
     break;
   }
   case axis_kind_descendant_or_self:
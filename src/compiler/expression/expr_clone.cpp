@@ -222,6 +222,8 @@ expr* expr::clone(user_function* udf, substitution_t& subst) const
       cloneExpr->add_back((*e)[i]->clone(udf, subst));
     }
 
+    cloneExpr->theUseTwigJoin = e->theUseTwigJoin;
+
     newExpr = cloneExpr;
     break;
   }
@@ -235,6 +237,7 @@ expr* expr::clone(user_function* udf, substitution_t& subst) const
     cloneExpr->setAxis(e->getAxis());
     cloneExpr->setTest(static_cast<match_expr*>(CLONE(e->getTest(), udf, subst)));
     cloneExpr->theReverseOrder = e->theReverseOrder;
+    cloneExpr->theUseDataGuide = e->theUseDataGuide;
 
     newExpr = cloneExpr;
     break;
@@ -337,6 +340,8 @@ expr* expr::clone(user_function* udf, substitution_t& subst) const
       cloneExpr->theArgs.push_back(e->theArgs[i]->clone(udf, subst));
 
     cloneExpr->theScriptingKind  = e->theScriptingKind;
+    cloneExpr->theProjection = e->theProjection;
+    cloneExpr->theJSONScan = e->theJSONScan;
 
     newExpr = cloneExpr;
     break;
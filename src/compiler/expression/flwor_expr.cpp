@@ -781,7 +781,8 @@ flwor_expr::flwor_expr(
   :
   expr(ccb, sctx, udf, loc, flwor_expr_kind),
   theReturnExpr(NULL),
-  theFlworFlags(0)
+  theFlworFlags(0),
+  theBatchCall(NULL)
 {
   theScriptingKind = SIMPLE_EXPR;
 }
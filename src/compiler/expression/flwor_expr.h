@@ -674,6 +674,7 @@ protected:
   clause_list_t   theClauses;
   expr          * theReturnExpr;
   ulong           theFlworFlags;
+  expr          * theBatchCall;
 
 protected:
   flwor_expr(
@@ -695,6 +696,15 @@ public:
 
   bool compute_is_general();
 
+  /*
+    The call to a batch external function that makes up the return clause of
+    this FLWOR, if the FLWOR can be evaluated by a BatchCallIterator (see
+    the MarkBatchCalls rule); NULL otherwise.
+  */
+  expr* get_batch_call() const { return theBatchCall; }
+
+  void set_batch_call(expr* e) { theBatchCall = e; }
+
   expr* get_return_expr() const { return theReturnExpr; }
 
   expr** get_return_expr_ref() { return &theReturnExpr; }
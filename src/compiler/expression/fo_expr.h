@@ -21,6 +21,10 @@
 
 #include "compiler/expression/expr_base.h"
 
+#include "store/api/doc_projection.h"
+
+#include "runtime/json/json_scan.h"
+
 
 namespace zorba
 {
@@ -31,6 +35,18 @@ class signature;
 
 /*******************************************************************************
   first-order expressions
+
+  theProjection:
+  --------------
+  Set by the MarkDocProjections rule on fn:doc and fn:parse-xml calls, if the
+  query reaches only some paths within the documents they return, so that
+  codegen can pass those paths on to the loader.
+
+  theJSONScan:
+  ------------
+  Set by the MarkJSONScans rule on jn:parse-json calls that are the domain of
+  a for clause, if the query needs only some fields of the objects they return
+  or skips those objects whose fields do not have some constant values.
 ********************************************************************************/
 class fo_expr : public expr
 {
@@ -41,6 +57,8 @@ class fo_expr : public expr
 protected:
   checked_vector<expr*>    theArgs;
   function               * theFunction;
+  store::DocProjection_t   theProjection;
+  JSONScan_t               theJSONScan;
 
 public:
 
@@ -107,6 +125,14 @@ public:
 
   void remove_arg(csize i);
 
+  store::DocProjection* get_projection() const { return theProjection.getp(); }
+
+  void set_projection(store::DocProjection* p) { theProjection = p; }
+
+  JSONScan* get_json_scan() const { return theJSONScan.getp(); }
+
+  void set_json_scan(JSONScan* s) { theJSONScan = s; }
+
   void compute_scripting_kind();
 
   void accept(expr_visitor&);
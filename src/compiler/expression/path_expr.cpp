@@ -27,6 +27,8 @@
 
 #include "compiler/api/compilercb.h"
 
+#include "store/api/iterator.h"
+
 
 namespace zorba
 {
@@ -48,7 +50,8 @@ relpath_expr::relpath_expr(
     user_function* udf,
     const QueryLoc& loc)
   :
-  expr(ccb, sctx, udf, loc, relpath_expr_kind)
+  expr(ccb, sctx, udf, loc, relpath_expr_kind),
+  theUseTwigJoin(false)
 {
   theScriptingKind = SIMPLE_EXPR;
 }
@@ -104,6 +107,44 @@ void relpath_expr::compute_scripting_kind()
 }
 
 
+/*******************************************************************************
+  Check whether all the steps of this path, after the first one, are element
+  name tests without wildcards on the child or descendant axis, with at least
+  one descendant step. Such a path is a pattern that can be evaluated by a
+  single twig join under each node produced by the first step, instead of one
+  step at a time.
+********************************************************************************/
+bool relpath_expr::is_twig_pattern() const
+{
+  csize numSteps = size();
+
+  if (numSteps < 3 || numSteps - 1 > store::TwigJoinIterator::MAX_STEPS)
+    return false;
+
+  bool haveDescendantStep = false;
+
+  for (csize i = 1; i < numSteps; ++i)
+  {
+    if (theSteps[i]->get_expr_kind() != axis_step_expr_kind)
+      return false;
+
+    axis_step_expr* axisStep = static_cast<axis_step_expr*>(theSteps[i]);
+    match_expr* test = axisStep->getTest();
+
+    if (test->getTestKind() != match_name_test ||
+        test->getWildKind() != match_no_wild)
+      return false;
+
+    if (axisStep->getAxis() == axis_kind_descendant)
+      haveDescendantStep = true;
+    else if (axisStep->getAxis() != axis_kind_child)
+      return false;
+  }
+
+  return haveDescendantStep;
+}
+
+
 /*******************************************************************************
 
   AxisStep ::= Axis NodeTest Predicate*
@@ -116,7 +157,8 @@ axis_step_expr::axis_step_expr(
     const QueryLoc& loc)
   :
   expr(ccb, sctx, udf, loc, axis_step_expr_kind),
-  theReverseOrder(false)
+  theReverseOrder(false),
+  theUseDataGuide(false)
 {
   compute_scripting_kind();
 }
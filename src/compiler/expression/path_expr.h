@@ -49,6 +49,13 @@ class match_expr;
 
  RelativPathExpr ::= "/" | ("/" | "//")?  StepExpr (("/" | "//") StepExpr)*
 
+  theUseTwigJoin:
+  ---------------
+  Set by the EliminateExtraneousPathSteps rule if all the steps after the first
+  one are element name tests on the child or descendant axis (see
+  is_twig_pattern()), so that codegen can evaluate them all at once with a
+  TwigPathIterator. Codegen checks the pattern again, because the steps may
+  have been rewritten since.
 ********************************************************************************/
 class relpath_expr : public expr
 {
@@ -58,6 +65,7 @@ class relpath_expr : public expr
 
 protected:
   std::vector<expr*> theSteps;
+  bool               theUseTwigJoin;
 
 protected:
   relpath_expr(
@@ -81,6 +89,12 @@ public:
 
   std::vector<expr*>::const_iterator end() const { return theSteps.end(); }
 
+  void set_twig_join(bool v) { theUseTwigJoin = v; }
+
+  bool use_twig_join() const { return theUseTwigJoin; }
+
+  bool is_twig_pattern() const;
+
   void compute_scripting_kind();
 
   void accept(expr_visitor&);
@@ -100,6 +114,13 @@ public:
 
   AxisStep ::= Axis NodeTest Predicate*
 
+  theUseDataGuide:
+  ----------------
+  Set by the EliminateExtraneousPathSteps rule on a descendant step with an
+  element name test that is applied directly to the nodes produced by the
+  first step of a path. The step then consults the data guide of the tree of
+  each such node, and skips the node if its guide shows that it has no
+  descendant with the step's name.
 ********************************************************************************/
 class axis_step_expr : public expr
 {
@@ -110,6 +131,7 @@ class axis_step_expr : public expr
 protected:
   axis_kind_t             theAxis;
   bool                    theReverseOrder;
+  bool                    theUseDataGuide;
   expr                  * theNodeTest;
 
 public:
@@ -131,6 +153,10 @@ public:
 
   bool use_reverse_order() const { return theReverseOrder; }
 
+  void set_data_guide(bool v) { theUseDataGuide = v; }
+
+  bool use_data_guide() const { return theUseDataGuide; }
+
   bool is_reverse_axis() const { return is_reverse_axis(getAxis()); }
 
   match_expr* getTest() const
@@ -267,6 +267,27 @@ bool DefaultOptimizer::rewrite(RewriterContext& rCtx)
     }
   }
 
+  // Mark the parts of the documents loaded by the query that must be built
+  if (Properties::instance().getDocProjection())
+  {
+    if (rCtx.theUDF == NULL)
+    {
+      RuleOnceDriver<MarkDocProjections> driverMarkDocProjections;
+      driverMarkDocProjections.rewrite(rCtx);
+    }
+  }
+
+  // Mark the parts of the JSON records scanned by the query that must be built
+  if (Properties::instance().getJSONScan())
+  {
+    RuleOnceDriver<MarkJSONScans> driverMarkJSONScans;
+    driverMarkJSONScans.rewrite(rCtx);
+  }
+
+  // Mark the flwor exprs whose external function calls can be batched
+  RuleOnceDriver<MarkBatchCalls> driverMarkBatchCalls;
+  driverMarkBatchCalls.rewrite(rCtx);
+
   return modified;
 }
 
@@ -18,6 +18,9 @@
 #include "functions/function.h"
 #include "functions/udf.h"
 #include "functions/library.h"
+#include "functions/external_function.h"
+
+#include "annotations/annotations.h"
 
 #include "compiler/rewriter/rules/ruleset.h"
 #include "compiler/rewriter/framework/rule_driver.h"
@@ -596,6 +599,7 @@ bool EliminateUnusedLetVars::safe_to_fold_var(csize varPos, int& numRefs)
   if (safe && numRefs == 0)
   {
     if (varDomExpr->get_function_kind() == FunctionConsts::OP_CREATE_INTERNAL_INDEX_2 ||
+        varDomExpr->get_function_kind() == FunctionConsts::OP_HASH_JOIN_BUILD_2 ||
         !isSafeVar)
     {
       return false;
@@ -1792,5 +1796,112 @@ expr* MergeFLWOR::apply(RewriterContext& rCtx, expr* node, bool& modified)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  MarkBatchCalls                                                            //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+
+/*******************************************************************************
+  If the given FLWOR has the form
+
+    for $x at $pos in domain_expr
+    where where_expr
+    return f(arg_1, ..., arg_n)
+
+  (with optional positional var and where clause), where f is a deterministic,
+  simple external function implemented by a BatchExternalFunction, f is not
+  annotated with %an:cache or %an:strictlydeterministic, and each arg yields
+  at most one item, return the call to f, so that the codegen can
+  evaluate the FLWOR by a BatchCallIterator. The call may be wrapped in the
+  treat expr that checks the declared return type of f. Return NULL otherwise.
+********************************************************************************/
+static expr* get_batch_call(flwor_expr* flwor)
+{
+  if (flwor->is_sequential() || flwor->is_updating())
+    return NULL;
+
+  csize numClauses = flwor->num_clauses();
+
+  if (numClauses == 0 || numClauses > 2)
+    return NULL;
+
+  const flwor_clause* c = flwor->get_clause(0);
+
+  if (c->get_kind() != flwor_clause::for_clause ||
+      static_cast<const for_clause*>(c)->is_allowing_empty() ||
+      static_cast<const for_clause*>(c)->get_score_var() != NULL)
+    return NULL;
+
+  if (numClauses == 2 &&
+      flwor->get_clause(1)->get_kind() != flwor_clause::where_clause)
+    return NULL;
+
+  expr* call = flwor->get_return_expr();
+
+  if (call->get_expr_kind() == treat_expr_kind)
+    call = static_cast<treat_expr*>(call)->get_input();
+
+  if (call->get_expr_kind() != fo_expr_kind)
+    return NULL;
+
+  fo_expr* fo = static_cast<fo_expr*>(call);
+  function* f = fo->get_func();
+
+  if (!f->isExternal() ||
+      !f->isDeterministic() ||
+      f->getScriptingKind() != SIMPLE_EXPR ||
+      dynamic_cast<BatchExternalFunction*>(
+        static_cast<external_function*>(f)->getImpl()) == NULL)
+    return NULL;
+
+  // The results of such functions must come from their cache.
+  const AnnotationList* annotations = f->getAnnotationList();
+
+  if (annotations &&
+      (annotations->contains(AnnotationInternal::zann_cache) ||
+       annotations->contains(AnnotationInternal::zann_strictlydeterministic)))
+    return NULL;
+
+  csize numArgs = fo->num_args();
+
+  for (csize i = 0; i < numArgs; ++i)
+  {
+    SequenceType::Quantifier q = fo->get_arg(i)->get_return_type()->get_quantifier();
+
+    if (q != SequenceType::QUANT_ONE && q != SequenceType::QUANT_QUESTION)
+      return NULL;
+  }
+
+  return fo;
+}
+
+
+/*******************************************************************************
+  Mark every flwor expr within the given expr with its batch call, if any.
+********************************************************************************/
+expr* MarkBatchCalls::apply(RewriterContext& rCtx, expr* node, bool& modified)
+{
+  if (node->get_expr_kind() == flwor_expr_kind)
+  {
+    flwor_expr* flwor = static_cast<flwor_expr*>(node);
+
+    flwor->set_batch_call(get_batch_call(flwor));
+  }
+
+  ExprIterator iter(node);
+
+  while (!iter.done())
+  {
+    apply(rCtx, **iter, modified);
+
+    iter.next();
+  }
+
+  return node;
+}
+
+
 }
 /* vim:set et sw=2 ts=2: */
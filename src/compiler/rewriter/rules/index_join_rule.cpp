@@ -970,6 +970,14 @@ void IndexJoinRule::rewriteJoin(PredicateInfo& predInfo)
 
   for_clause* innerClause = predInfo.theInnerVar->get_forlet_clause();
 
+  //
+  // Value joins are evaluated by a runtime hash join, which does not go
+  // through the store's index machinery. The temp index is still declared,
+  // because it provides the build expr, but it is not bound in the sctx.
+  //
+  bool hashJoin = (!predInfo.theIsGeneral &&
+                   Properties::instance().getHashJoins());
+
   //
   // The index domain expr is the expr that defines the inner var, expanded so
   // that it does not reference any LET variables defined after the outer var
@@ -981,7 +989,8 @@ void IndexJoinRule::rewriteJoin(PredicateInfo& predInfo)
   // Create the index declaration
   //
   std::ostringstream os;
-  os << "tempIndex" << GENV_ROOT_STATIC_CONTEXT.create_temporary_index_id();
+  os << (hashJoin ? "tempHashJoin" : "tempIndex")
+     << GENV_ROOT_STATIC_CONTEXT.create_temporary_index_id();
 
   store::Item_t qname;
   GENV_ITEMFACTORY->createQName(qname, "", "", os.str().c_str());
@@ -1022,13 +1031,15 @@ void IndexJoinRule::rewriteJoin(PredicateInfo& predInfo)
   idx->setOrderModifiers(modifiers);
 
   //
-  // Create the "create-index()" expr
+  // Create the "create-index()" or "hash-join-build()" expr
   //
   expr* qnameExpr = em->create_const_expr(sctx, udf, loc, qname);
 
   expr* buildExpr = idx->getBuildExpr(loc);
 
-  function* f = BUILTIN_FUNC(OP_CREATE_INTERNAL_INDEX_2);
+  function* f = (hashJoin ?
+                 BUILTIN_FUNC(OP_HASH_JOIN_BUILD_2) :
+                 BUILTIN_FUNC(OP_CREATE_INTERNAL_INDEX_2));
   fo_expr* createExpr = em->create_fo_expr(sctx, udf, loc, f, qnameExpr, buildExpr);
 
   DynamicBitset indexVars;
@@ -1085,7 +1096,7 @@ void IndexJoinRule::rewriteJoin(PredicateInfo& predInfo)
   }
 
   //
-  // Replace the expr defining the inner var with an index probe.
+  // Replace the expr defining the inner var with an index or hash join probe.
   //
   fo_expr* probeExpr = NULL;
 
@@ -1106,6 +1117,16 @@ void IndexJoinRule::rewriteJoin(PredicateInfo& predInfo)
                    BUILTIN_FUNC(OP_SORT_DISTINCT_NODES_ASC_1),
                    probeExpr);
   }
+  else if (hashJoin)
+  {
+    probeExpr = em->
+    create_fo_expr(sctx,
+                   udf,
+                   loc,
+                   BUILTIN_FUNC(OP_HASH_JOIN_PROBE_2),
+                   qnameExpr,
+                   const_cast<expr*>(predInfo.theOuterOp));
+  }
   else
   {
     probeExpr = em->
@@ -1122,19 +1143,13 @@ void IndexJoinRule::rewriteJoin(PredicateInfo& predInfo)
 
   innerClause->set_expr(probeExpr);
 
-  sctx->bind_index(idx, loc);
+  if (!hashJoin)
+    sctx->bind_index(idx, loc);
 
   if (Properties::instance().getPrintIntermediateOpt())
   {
     std::cout << std::endl << idx->toString() << std::endl;
   }
-
-#if 0
-  if (predInfo.theIsGeneral)
-    std::cout << "!!!!! Applied General Hash Join !!!!!" << std::endl << std::endl;
-  else
-    std::cout << "!!!!! Applied Value Hash Join !!!!!" << std::endl << std::endl;
-#endif
 }
 
 
@@ -20,6 +20,10 @@
 
 #include "compiler/expression/expr.h"
 #include "compiler/expression/expr_iter.h"
+#ifndef ZORBA_NO_FULL_TEXT
+#include "compiler/expression/ft_expr.h"
+#include "compiler/expression/ftnode.h"
+#endif
 
 #include "compiler/xqddf/value_index.h"
 #include "compiler/xqddf/collection_decl.h"
@@ -39,8 +43,17 @@
 
 #include "diagnostics/assert.h"
 
+#ifndef ZORBA_NO_FULL_TEXT
+#include "runtime/full_text/ft_util.h"
+#include "store/api/ft_token_iterator.h"
+#include "store/api/store.h"
+#include "system/globalenv.h"
+#endif
+
 #include <zorba/properties.h>
 
+#include <set>
+
 
 namespace zorba
 {
@@ -96,7 +109,7 @@ expr* IndexMatchingRule::apply(RewriterContext& rCtx, expr* node, bool& modified
   modified = false;
 
   // TODO remove this
-  if (theIndexDecl->isGeneral())
+  if (theIndexDecl->isGeneral() && !theIndexDecl->isFullText())
     return node;
 
   if (node->get_expr_kind() == flwor_expr_kind)
@@ -106,7 +119,9 @@ expr* IndexMatchingRule::apply(RewriterContext& rCtx, expr* node, bool& modified
 
     theQueryExpr = static_cast<flwor_expr*>(node);
 
-    bool matched = matchIndex();
+    bool matched = (theIndexDecl->isFullText() ?
+                    matchFullTextIndex() :
+                    matchIndex());
 
     if (matched)
     {
@@ -690,6 +705,386 @@ bool IndexMatchingRule::matchIndex()
 }
 
 
+#ifndef ZORBA_NO_FULL_TEXT
+
+/*******************************************************************************
+  The ft match options that may make a query token match a document token
+  whose normalized (lower-case, diacritics-stripped) value is different than
+  the normalized value of the query token. If any of them is in effect for an
+  FTWords, the tokens of the FTWords can not be looked-up in a full-text index.
+********************************************************************************/
+struct FTIndexOptions
+{
+  bool theStemming;
+  bool theThesaurus;
+  bool theStopWords;
+  bool theWildcards;
+  bool theOther;
+
+  FTIndexOptions()
+    :
+    theStemming(false),
+    theThesaurus(false),
+    theStopWords(false),
+    theWildcards(false),
+    theOther(false)
+  {
+  }
+
+  void apply(const ftmatch_options* mo)
+  {
+    if (mo == NULL)
+      return;
+
+    if (const ftstem_option* o = mo->get_stem_option())
+      theStemming = (o->get_mode() == ft_stem_mode::stemming);
+
+    if (const ftthesaurus_option* o = mo->get_thesaurus_option())
+      theThesaurus = !o->no_thesaurus();
+
+    if (const ftstop_word_option* o = mo->get_stop_word_option())
+      theStopWords = (o->get_mode() != ft_stop_words_mode::without);
+
+    if (const ftwild_card_option* o = mo->get_wild_card_option())
+      theWildcards = (o->get_mode() == ft_wild_card_mode::with);
+
+    // The language affects both the tokenization and the case mapping.
+    if (mo->get_language_option() || mo->get_extension_options())
+      theOther = true;
+  }
+
+  bool isPlain() const
+  {
+    return !(theStemming || theThesaurus || theStopWords || theWildcards ||
+             theOther);
+  }
+};
+
+
+/*******************************************************************************
+  Put in "items" the items of the given FTWordsValue expr, if it is a constant.
+********************************************************************************/
+static bool getFTWordsItems(expr* e, std::vector<store::Item*>& items)
+{
+  while (e->get_expr_kind() == promote_expr_kind ||
+         e->get_expr_kind() == treat_expr_kind)
+  {
+    e = static_cast<cast_base_expr*>(e)->get_input();
+  }
+
+  if (e->get_expr_kind() == const_expr_kind)
+  {
+    items.push_back(static_cast<const_expr*>(e)->get_val());
+    return true;
+  }
+
+  if (e->get_function_kind() == FunctionConsts::OP_CONCATENATE_N)
+  {
+    fo_expr* fo = static_cast<fo_expr*>(e);
+
+    for (csize i = 0; i < fo->num_args(); ++i)
+    {
+      if (!getFTWordsItems(fo->get_arg(i), items))
+        return false;
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+
+/*******************************************************************************
+  Add to "terms" the normalized tokens that every item of the search context
+  of an ftcontains expr must contain in order for the given FTSelection node
+  to match that item. The tokens are computed the same way as the keys of a
+  full-text index (see FullTextIndexKeysIterator). If nothing can be said
+  about the tokens of the matching items (e.g. for FTOr, FTUnaryNot, or
+  FTWords with stemming), no tokens are added.
+
+  Notice that positional filters (ordered, window, distance, etc.) can only
+  make an FTSelection more selective, so the tokens computed here are required
+  by the phrase, distance, or window conditions as well. These conditions
+  themselves are checked by the ftcontains expr, which is kept by the rewrite.
+********************************************************************************/
+static void getRequiredFTTerms(
+    const ftnode* node,
+    FTIndexOptions options,
+    std::set<zstring>& terms)
+{
+  if (const ftselection* sel = dynamic_cast<const ftselection*>(node))
+  {
+    getRequiredFTTerms(sel->get_ftor(), options, terms);
+  }
+  else if (const ftor* ora = dynamic_cast<const ftor*>(node))
+  {
+    if (ora->get_node_list().size() == 1)
+      getRequiredFTTerms(ora->get_node_list().front(), options, terms);
+  }
+  else if (const ftand* anda = dynamic_cast<const ftand*>(node))
+  {
+    ftnode_list::ftnode_list_t::const_iterator ite = anda->get_node_list().begin();
+    ftnode_list::ftnode_list_t::const_iterator end = anda->get_node_list().end();
+    for (; ite != end; ++ite)
+      getRequiredFTTerms(*ite, options, terms);
+  }
+  else if (const ftmild_not* mn = dynamic_cast<const ftmild_not*>(node))
+  {
+    if (!mn->get_node_list().empty())
+      getRequiredFTTerms(mn->get_node_list().front(), options, terms);
+  }
+  else if (const ftprimary_with_options* pwo =
+           dynamic_cast<const ftprimary_with_options*>(node))
+  {
+    options.apply(pwo->get_match_options());
+    getRequiredFTTerms(pwo->get_primary(), options, terms);
+  }
+  else if (const ftwords_times* wt = dynamic_cast<const ftwords_times*>(node))
+  {
+    // "occurs at most N times" is satisfied by items that do not contain the
+    // words at all.
+    if (wt->get_times() == NULL)
+      getRequiredFTTerms(wt->get_words(), options, terms);
+  }
+  else if (const ftwords* w = dynamic_cast<const ftwords*>(node))
+  {
+    if (!options.isPlain())
+      return;
+
+    std::vector<store::Item*> items;
+    if (!getFTWordsItems(*const_cast<ftwords*>(w)->get_value_expr(), items))
+      return;
+
+    TokenizerProvider const* provider = GENV_STORE.getTokenizerProvider();
+
+    std::vector<std::vector<zstring> > itemTokens(items.size());
+    csize numTokens = 0;
+
+    for (csize i = 0; i < items.size(); ++i)
+    {
+      Tokenizer::State tstate;
+      FTTokenIterator_t tokens =
+      items[i]->getTokens(*provider, tstate, locale::iso639_1::unknown);
+
+      while (tokens->hasNext())
+      {
+        FTToken const* t = tokens->next();
+        itemTokens[i].push_back(t->value(FTToken::lower | FTToken::ascii));
+        ++numTokens;
+      }
+    }
+
+    switch (w->get_mode())
+    {
+    case ft_anyall_mode::any:
+    {
+      // Each string is a phrase, and any one of them may match.
+      if (items.size() != 1)
+        return;
+      break;
+    }
+    case ft_anyall_mode::any_word:
+    {
+      if (numTokens != 1)
+        return;
+      break;
+    }
+    case ft_anyall_mode::all:
+    case ft_anyall_mode::all_words:
+    case ft_anyall_mode::phrase:
+    {
+      break;
+    }
+    }
+
+    for (csize i = 0; i < itemTokens.size(); ++i)
+      terms.insert(itemTokens[i].begin(), itemTokens[i].end());
+  }
+}
+
+
+/*******************************************************************************
+  Match a flwor expr with a full-text index. The flwor must contain a FOR
+  clause whose domain expr is the same as the domain expr of the index, and a
+  WHERE clause after it with an ftcontains predicate whose search context is
+  the key expr of the index (applied on the FOR var). For example, given the
+  index
+
+  declare %an:automatic %an:full-text index news:text-idx
+  on nodes db:collection(xs:QName("news:articles"))
+  by ./body;
+
+  the query
+
+  for $a in db:collection(xs:QName("news:articles"))
+  where $a/body contains text "stock market" distance at most 3 words
+  return $a/title
+
+  is rewritten to
+
+  for $a in probe-index-point-general(xs:QName("news:text-idx"), "stock")
+            intersect
+            probe-index-point-general(xs:QName("news:text-idx"), "market")
+  where $a/body contains text "stock market" distance at most 3 words
+  return $a/title
+
+  The index lookups only skip the domain nodes that can not satisfy the
+  predicate, so the ftcontains predicate stays in the WHERE clause.
+********************************************************************************/
+bool IndexMatchingRule::matchFullTextIndex()
+{
+  CompilerCB* ccb = theQueryExpr->get_ccb();
+  static_context* sctx = theQueryExpr->get_sctx();
+  user_function* udf = theQueryExpr->get_udf();
+
+  // The keys of the index are tokenized with the language of the index's
+  // sctx, whereas the query tokens are tokenized with no language.
+  if (get_lang_from(theIndexDecl->getSctx()->get_match_options()) !=
+      locale::iso639_1::unknown)
+    return false;
+
+  for_clause* vfc = static_cast<for_clause*>(theViewExpr->get_clause(0));
+  expr* vdomExpr = vfc->get_expr();
+  expr* vkeyExpr = (*theKeyClauses)[0]->get_expr();
+
+  // The domain expr of a general index is wrapped by check-distinct-nodes.
+  if (vdomExpr->get_function_kind() == FunctionConsts::OP_CHECK_DISTINCT_NODES_1)
+    vdomExpr = static_cast<fo_expr*>(vdomExpr)->get_arg(0);
+
+  csize numQClauses = theQueryExpr->num_clauses();
+
+  for (csize qi = 0; qi < numQClauses; ++qi)
+  {
+    flwor_clause* qc = theQueryExpr->get_clause(qi);
+
+    if (qc->get_kind() != flwor_clause::for_clause)
+      continue;
+
+    for_clause* qfc = static_cast<for_clause*>(qc);
+
+    if (qfc->is_allowing_empty() || qfc->get_pos_var() != NULL)
+      continue;
+
+    expr::substitution_t subst;
+
+    if (!expr_tools::match_exact(qfc->get_expr(), vdomExpr, subst))
+      continue;
+
+    subst[vfc->get_var()] = qfc->get_var();
+
+    std::set<zstring> terms;
+
+    for (csize i = qi + 1; i < numQClauses && terms.empty(); ++i)
+    {
+      flwor_clause* c = theQueryExpr->get_clause(i);
+
+      if (c->get_kind() == flwor_clause::for_clause ||
+          c->get_kind() == flwor_clause::let_clause)
+      {
+        if (static_cast<forlet_clause*>(c)->get_expr()->is_sequential())
+          break;
+
+        continue;
+      }
+      else if (c->get_kind() == flwor_clause::orderby_clause)
+      {
+        continue;
+      }
+      else if (c->get_kind() != flwor_clause::where_clause)
+      {
+        break;
+      }
+
+      std::vector<PredInfo> preds;
+      getWherePreds(i, static_cast<where_clause*>(c), preds);
+
+      for (csize j = 0; j < preds.size() && terms.empty(); ++j)
+      {
+        if (preds[j].theExpr->get_expr_kind() != ft_expr_kind)
+          continue;
+
+        ftcontains_expr* ftc = static_cast<ftcontains_expr*>(preds[j].theExpr);
+
+        if (ftc->get_ignore() != NULL ||
+            !expr_tools::match_exact(ftc->get_range(), vkeyExpr, subst))
+          continue;
+
+        FTIndexOptions options;
+        options.apply(ftc->get_sctx()->get_match_options());
+
+        getRequiredFTTerms(ftc->get_ftselection().getp(), options, terms);
+      }
+    }
+
+    if (terms.empty())
+      continue;
+
+    // Create the lookups and intersect their results
+    const QueryLoc& loc = qfc->get_loc();
+    expr* probeExpr = NULL;
+
+    std::set<zstring>::const_iterator ite = terms.begin();
+    std::set<zstring>::const_iterator end = terms.end();
+    for (; ite != end; ++ite)
+    {
+      zstring term = *ite;
+
+      expr* qnameExpr = ccb->theEM->
+      create_const_expr(sctx, udf, loc, theIndexDecl->getName());
+
+      expr* termExpr = ccb->theEM->create_const_expr(sctx, udf, loc, term);
+
+      expr* termProbe = ccb->theEM->
+      create_fo_expr(sctx,
+                     udf,
+                     loc,
+                     BUILTIN_FUNC(FN_ZORBA_XQDDF_PROBE_INDEX_POINT_GENERAL_N),
+                     qnameExpr,
+                     termExpr);
+
+      if (probeExpr == NULL)
+      {
+        probeExpr = termProbe;
+      }
+      else
+      {
+        probeExpr = ccb->theEM->
+        create_fo_expr(sctx,
+                       udf,
+                       loc,
+                       BUILTIN_FUNC(OP_INTERSECT_2),
+                       probeExpr,
+                       termProbe);
+      }
+    }
+
+    if (! (theQueryExpr->ignoresSortedNodes() ||
+           (theIndexDecl->numSources() == 1 &&
+            !sctx->lookup_collection(theIndexDecl->getSourceName(0))->isOrdered())))
+    {
+      probeExpr = ccb->theEM->
+      create_fo_expr(sctx, udf, loc, BUILTIN_FUNC(OP_SORT_NODES_ASC_1), probeExpr);
+    }
+
+    qfc->set_expr(probeExpr);
+
+    return true;
+  }
+
+  return false;
+}
+
+#else
+
+bool IndexMatchingRule::matchFullTextIndex()
+{
+  return false;
+}
+
+#endif /* ZORBA_NO_FULL_TEXT */
+
+
 /*******************************************************************************
 
 ********************************************************************************/
@@ -70,6 +70,8 @@ public:
 protected:
   bool matchIndex();
 
+  bool matchFullTextIndex();
+
   void getWherePreds(
       csize clausePos,
       where_clause* wc,
@@ -61,8 +61,38 @@ RULE_REWRITE_PRE(EliminateExtraneousPathSteps)
 }
 
 
+/*******************************************************************************
+  Check whether the 2nd step of the given path expr is a descendant step with
+  an element name test without wildcards. Such a step can skip the nodes
+  produced by the first step whose data guide shows that no element with the
+  step's name exists below them.
+********************************************************************************/
+static bool is_data_guide_step(const relpath_expr* re)
+{
+  if (re->size() < 2 || (*re)[1]->get_expr_kind() != axis_step_expr_kind)
+    return false;
+
+  axis_step_expr* axisStep = static_cast<axis_step_expr*>((*re)[1]);
+  match_expr* test = axisStep->getTest();
+
+  return (axisStep->getAxis() == axis_kind_descendant &&
+          test->getTestKind() == match_name_test &&
+          test->getWildKind() == match_no_wild);
+}
+
+
 RULE_REWRITE_POST(EliminateExtraneousPathSteps)
 {
+  if (node->get_expr_kind() == relpath_expr_kind)
+  {
+    relpath_expr* re = static_cast<relpath_expr *>(node);
+
+    re->set_twig_join(re->is_twig_pattern());
+
+    if (!re->use_twig_join() && is_data_guide_step(re))
+      static_cast<axis_step_expr*>((*re)[1])->set_data_guide(true);
+  }
+
   return NULL;
 }
 
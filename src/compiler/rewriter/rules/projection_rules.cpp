@@ -0,0 +1,785 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "stdafx.h"
+
+#include "compiler/rewriter/rules/ruleset.h"
+
+#include "compiler/expression/flwor_expr.h"
+#include "compiler/expression/path_expr.h"
+#include "compiler/expression/expr.h"
+#include "compiler/expression/fo_expr.h"
+#include "compiler/expression/var_expr.h"
+#include "compiler/expression/script_exprs.h"
+#include "compiler/expression/expr_iter.h"
+
+#include "context/static_context.h"
+
+#include "functions/function.h"
+
+#include "runtime/json/json_scan.h"
+
+#include "zorbamisc/ns_consts.h"
+
+#include "types/root_typemanager.h"
+#include "types/typeops.h"
+
+
+namespace zorba
+{
+
+
+/*******************************************************************************
+  Check whether a treat expr lets a document node through without looking at
+  its content, i.e., whether it can be seen through when looking for the doc
+  source of a path.
+********************************************************************************/
+static bool is_content_independent(const treat_expr* e)
+{
+  TypeManager* tm = e->get_type_manager();
+  RootTypeManager& rtm = GENV_TYPESYSTEM;
+
+  return TypeOps::is_subtype(tm,
+                             *rtm.DOCUMENT_UNTYPED_TYPE_ONE,
+                             *TypeOps::prime_type(tm, *e->get_target_type()));
+}
+
+
+/*******************************************************************************
+  Check whether a call to the given function can only look at the nodes that
+  it receives as arguments, and at their subtrees. This is not the case for
+  functions that navigate to the root or the siblings of their arguments, for
+  functions that may call other functions, and for functions whose bodies we
+  do not see.
+********************************************************************************/
+static bool is_safe_call(const fo_expr* fo)
+{
+  const function* f = fo->get_func();
+
+  if (f->isUdf() || f->isExternal())
+    return false;
+
+  switch (f->getKind())
+  {
+  case FunctionConsts::FN_ROOT_0:
+  case FunctionConsts::FN_ROOT_1:
+  case FunctionConsts::FN_PATH_0:
+  case FunctionConsts::FN_PATH_1:
+  case FunctionConsts::FN_ID_1:
+  case FunctionConsts::FN_ID_2:
+  case FunctionConsts::FN_IDREF_1:
+  case FunctionConsts::FN_IDREF_2:
+  case FunctionConsts::FN_ELEMENT_WITH_ID_1:
+  case FunctionConsts::FN_ELEMENT_WITH_ID_2:
+  case FunctionConsts::FN_FUNCTION_LOOKUP_2:
+    return false;
+  default:
+    break;
+  }
+
+  TypeManager* tm = fo->get_type_manager();
+  RootTypeManager& rtm = GENV_TYPESYSTEM;
+  const signature& sig = f->getSignature();
+  csize numArgs = fo->num_args();
+
+  for (csize i = 0; i < numArgs; ++i)
+  {
+    if (TypeOps::is_subtype(tm, *sig[i], *rtm.ANY_FUNCTION_TYPE_STAR))
+      return false;
+  }
+
+  zstring ns = f->getName()->getNamespace();
+
+  if (ns == static_context::W3C_FN_NS ||
+      ns == static_context::XQUERY_MATH_FN_NS ||
+      ns == static_context::XQUERY_OP_NS ||
+      ns == static_context::ZORBA_OP_NS)
+    return true;
+
+  // fn:doc does not add projected documents to the store, so the query must
+  // not look for them there.
+  if (ns == static_context::ZORBA_STORE_DOCUMENTS_FN_NS)
+    return false;
+
+  // Functions of other modules may do anything with nodes, so they are safe
+  // only if they do not receive any.
+  for (csize i = 0; i < numArgs; ++i)
+  {
+    if (!TypeOps::is_subtype(tm,
+                             *fo->get_arg(i)->get_return_type(),
+                             *rtm.ANY_ATOMIC_TYPE_STAR))
+      return false;
+  }
+
+  return true;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+expr* MarkDocProjections::apply(
+    RewriterContext& rCtx,
+    expr* node,
+    bool& modified)
+{
+  modified = false;
+
+  if (node->is_updating() || node->is_sequential())
+    return node;
+
+  theDocVars.clear();
+  theDocCalls.clear();
+  theProjection = new store::DocProjection;
+
+  // A variable may be bound to another doc variable, so repeat until no more
+  // doc variables are found.
+  bool found;
+  do
+  {
+    found = false;
+    findDocVars(node, found);
+  }
+  while (found);
+
+  if (!findPaths(node, false) ||
+      theDocCalls.empty() ||
+      theProjection->numPaths() == 0)
+    return node;
+
+  std::vector<fo_expr*>::const_iterator ite = theDocCalls.begin();
+  std::vector<fo_expr*>::const_iterator end = theDocCalls.end();
+  for (; ite != end; ++ite)
+  {
+    (*ite)->set_projection(theProjection.getp());
+  }
+
+  return node;
+}
+
+
+/*******************************************************************************
+  Add to theDocVars the for, let, and prolog variables that are bound to the
+  result of a doc source.
+********************************************************************************/
+void MarkDocProjections::findDocVars(expr* node, bool& found)
+{
+  if (node->get_expr_kind() == flwor_expr_kind)
+  {
+    flwor_expr* flwor = static_cast<flwor_expr*>(node);
+
+    for (csize i = 0; i < flwor->num_clauses(); ++i)
+    {
+      flwor_clause* c = flwor->get_clause(i);
+
+      if (c->get_kind() != flwor_clause::for_clause &&
+          c->get_kind() != flwor_clause::let_clause)
+        continue;
+
+      forlet_clause* fc = static_cast<forlet_clause*>(c);
+
+      if (isDocSource(fc->get_expr()) && theDocVars.insert(fc->get_var()).second)
+        found = true;
+    }
+  }
+  else if (node->get_expr_kind() == var_decl_expr_kind)
+  {
+    var_decl_expr* decl = static_cast<var_decl_expr*>(node);
+
+    if (decl->get_init_expr() != NULL &&
+        isDocSource(decl->get_init_expr()) &&
+        theDocVars.insert(decl->get_var_expr()).second)
+      found = true;
+  }
+
+  ExprIterator iter(node);
+  while (!iter.done())
+  {
+    findDocVars(**iter, found);
+    iter.next();
+  }
+}
+
+
+/*******************************************************************************
+  Check whether the given expr returns the result of an fn:doc or fn:parse-xml
+  call, or the value of a doc variable, as it is.
+********************************************************************************/
+bool MarkDocProjections::isDocSource(expr* node) const
+{
+  while (true)
+  {
+    switch (node->get_expr_kind())
+    {
+    case treat_expr_kind:
+    {
+      treat_expr* te = static_cast<treat_expr*>(node);
+
+      if (!is_content_independent(te))
+        return false;
+
+      node = te->get_input();
+      break;
+    }
+    case wrapper_expr_kind:
+    {
+      node = static_cast<wrapper_expr*>(node)->get_input();
+      break;
+    }
+    case fo_expr_kind:
+    {
+      fo_expr* fo = static_cast<fo_expr*>(node);
+
+      switch (fo->get_func()->getKind())
+      {
+      case FunctionConsts::FN_DOC_1:
+      case FunctionConsts::FN_PARSE_XML_1:
+        return true;
+      case FunctionConsts::OP_HOIST_1:
+      case FunctionConsts::OP_UNHOIST_1:
+        node = fo->get_arg(0);
+        break;
+      default:
+        return false;
+      }
+      break;
+    }
+    case var_expr_kind:
+    {
+      return theDocVars.find(static_cast<var_expr*>(node)) != theDocVars.end();
+    }
+    default:
+    {
+      return false;
+    }
+    }
+  }
+}
+
+
+/*******************************************************************************
+  Add to theProjection the paths of the path exprs that start at a doc source,
+  and to theDocCalls the fn:doc and fn:parse-xml calls. Return false if the
+  query may reach a part of a document that is not on these paths, i.e., if a
+  doc source is used other than as the input of a path expr or as the domain
+  of a variable, or if some expr may navigate outside the subtrees reached by
+  the paths.
+
+  isSourcePos is true if the given expr is in a position where it may be a
+  doc source.
+********************************************************************************/
+bool MarkDocProjections::findPaths(expr* node, bool isSourcePos)
+{
+  switch (node->get_expr_kind())
+  {
+  case var_expr_kind:
+  {
+    return isSourcePos ||
+           theDocVars.find(static_cast<var_expr*>(node)) == theDocVars.end();
+  }
+
+  case fo_expr_kind:
+  {
+    fo_expr* fo = static_cast<fo_expr*>(node);
+
+    switch (fo->get_func()->getKind())
+    {
+    case FunctionConsts::FN_DOC_1:
+    case FunctionConsts::FN_PARSE_XML_1:
+    {
+      if (!isSourcePos)
+        return false;
+
+      theDocCalls.push_back(fo);
+      return findPaths(fo->get_arg(0), false);
+    }
+    case FunctionConsts::OP_HOIST_1:
+    case FunctionConsts::OP_UNHOIST_1:
+    {
+      return findPaths(fo->get_arg(0), isSourcePos);
+    }
+    default:
+    {
+      if (!is_safe_call(fo))
+        return false;
+      break;
+    }
+    }
+    break;
+  }
+
+  case treat_expr_kind:
+  {
+    treat_expr* te = static_cast<treat_expr*>(node);
+
+    return findPaths(te->get_input(),
+                     isSourcePos && is_content_independent(te));
+  }
+
+  case wrapper_expr_kind:
+  {
+    return findPaths(static_cast<wrapper_expr*>(node)->get_input(),
+                     isSourcePos);
+  }
+
+  case relpath_expr_kind:
+  {
+    relpath_expr* pathExpr = static_cast<relpath_expr*>(node);
+
+    if (isDocSource((*pathExpr)[0]) && !addPath(pathExpr))
+      return false;
+
+    if (!findPaths((*pathExpr)[0], true))
+      return false;
+
+    for (csize i = 1; i < pathExpr->size(); ++i)
+    {
+      if (!findPaths((*pathExpr)[i], false))
+        return false;
+    }
+
+    return true;
+  }
+
+  case axis_step_expr_kind:
+  {
+    switch (static_cast<axis_step_expr*>(node)->getAxis())
+    {
+    case axis_kind_self:
+    case axis_kind_child:
+    case axis_kind_descendant:
+    case axis_kind_descendant_or_self:
+    case axis_kind_attribute:
+      break;
+    default:
+      return false;
+    }
+    break;
+  }
+
+  case flwor_expr_kind:
+  {
+    flwor_expr* flwor = static_cast<flwor_expr*>(node);
+    std::set<expr*> domains;
+
+    for (csize i = 0; i < flwor->num_clauses(); ++i)
+    {
+      flwor_clause* c = flwor->get_clause(i);
+
+      if (c->get_kind() == flwor_clause::for_clause ||
+          c->get_kind() == flwor_clause::let_clause)
+        domains.insert(static_cast<forlet_clause*>(c)->get_expr());
+    }
+
+    ExprIterator iter(node);
+    while (!iter.done())
+    {
+      if (!findPaths(**iter, domains.find(**iter) != domains.end()))
+        return false;
+
+      iter.next();
+    }
+
+    return true;
+  }
+
+  case var_decl_expr_kind:
+  {
+    var_decl_expr* decl = static_cast<var_decl_expr*>(node);
+
+    return (decl->get_init_expr() == NULL ||
+            findPaths(decl->get_init_expr(), true));
+  }
+
+  case dynamic_function_invocation_expr_kind:
+  case function_item_expr_kind:
+  case eval_expr_kind:
+  {
+    return false;
+  }
+
+  default:
+  {
+    break;
+  }
+  }
+
+  ExprIterator iter(node);
+  while (!iter.done())
+  {
+    if (!findPaths(**iter, false))
+      return false;
+
+    iter.next();
+  }
+
+  return true;
+}
+
+
+/*******************************************************************************
+  Add to theProjection the longest prefix of the steps of the given path expr
+  that consists of name tests on the child, descendant, and attribute axes.
+  The query may reach the full subtree of any node selected by such a prefix,
+  but, since all other steps are forward steps, nothing above it. Return false
+  if the prefix is empty, i.e., if the whole document may be reached.
+********************************************************************************/
+bool MarkDocProjections::addPath(const relpath_expr* pathExpr)
+{
+  store::DocProjection::Path path;
+
+  for (csize i = 1; i < pathExpr->size(); ++i)
+  {
+    if ((*pathExpr)[i]->get_expr_kind() != axis_step_expr_kind)
+      break;
+
+    axis_step_expr* axisStep = static_cast<axis_step_expr*>((*pathExpr)[i]);
+    match_expr* test = axisStep->getTest();
+
+    if (test->getTestKind() != match_name_test ||
+        (test->getWildKind() != match_no_wild &&
+         test->getWildKind() != match_all_wild))
+      break;
+
+    store::Item_t name;
+    if (test->getWildKind() == match_no_wild)
+      name = test->getQName();
+
+    if (axisStep->getAxis() == axis_kind_child)
+    {
+      path.push_back(store::DocProjection::Step(store::DocProjection::CHILD, name));
+    }
+    else if (axisStep->getAxis() == axis_kind_descendant)
+    {
+      path.push_back(store::DocProjection::Step(store::DocProjection::DESCENDANT, name));
+    }
+    else if (axisStep->getAxis() == axis_kind_attribute)
+    {
+      path.push_back(store::DocProjection::Step(store::DocProjection::ATTRIBUTE, name));
+      break;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  if (path.empty())
+    return false;
+
+  theProjection->addPath(path);
+  return true;
+}
+
+
+
+/*******************************************************************************
+  Skip the exprs that return their input as it is.
+********************************************************************************/
+static expr* skip_wrappers(expr* e)
+{
+  while (e->get_expr_kind() == wrapper_expr_kind)
+    e = static_cast<wrapper_expr*>(e)->get_input();
+
+  return e;
+}
+
+
+/*******************************************************************************
+  Skip the atomization and the promotion to xs:anyAtomicType that the
+  translator wraps around the operands of a comparison. Neither of them can
+  raise an error for the result of a single object lookup that the JSON scan
+  does not assume to be true anyway (see JSONScan).
+********************************************************************************/
+static expr* skip_atomization(expr* e)
+{
+  RootTypeManager& rtm = GENV_TYPESYSTEM;
+
+  while (true)
+  {
+    e = skip_wrappers(e);
+
+    if (e->get_expr_kind() == promote_expr_kind)
+    {
+      promote_expr* pe = static_cast<promote_expr*>(e);
+      TypeManager* tm = pe->get_type_manager();
+
+      if (!TypeOps::is_equal(tm,
+                             *TypeOps::prime_type(tm, *pe->get_target_type()),
+                             *rtm.ANY_ATOMIC_TYPE_ONE))
+        return e;
+
+      e = pe->get_input();
+    }
+    else if (e->get_function_kind() == FunctionConsts::FN_DATA_1)
+    {
+      e = static_cast<fo_expr*>(e)->get_arg(0);
+    }
+    else
+    {
+      return e;
+    }
+  }
+}
+
+
+/*******************************************************************************
+  Check whether the given expr is a chain of object lookups with constant keys
+  that starts at the given variable, e.g., $o.a.b, and if so, put its keys in
+  the given path. The variable itself is a chain with no keys.
+********************************************************************************/
+static bool get_lookup_path(
+    expr* e,
+    const var_expr* var,
+    JSONScan::Path& path)
+{
+  e = skip_wrappers(e);
+
+  if (e == var)
+    return true;
+
+  FunctionConsts::FunctionKind fkind = e->get_function_kind();
+
+  if (fkind != FunctionConsts::OP_ZORBA_MULTI_OBJECT_LOOKUP_2 &&
+      fkind != FunctionConsts::OP_ZORBA_SINGLE_OBJECT_LOOKUP_2)
+    return false;
+
+  fo_expr* fo = static_cast<fo_expr*>(e);
+  const expr* keyExpr = fo->get_arg(1);
+
+  if (keyExpr->get_expr_kind() != const_expr_kind)
+    return false;
+
+  if (!get_lookup_path(fo->get_arg(0), var, path))
+    return false;
+
+  path.push_back(static_cast<const const_expr*>(keyExpr)->get_val()->getStringValue());
+  return true;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+expr* MarkJSONScans::apply(
+    RewriterContext& rCtx,
+    expr* node,
+    bool& modified)
+{
+  modified = false;
+
+  if (node->is_updating() || node->is_sequential())
+    return node;
+
+  markScans(node);
+
+  return node;
+}
+
+
+/*******************************************************************************
+  Mark the jn:parse-json calls that are the domain of a for clause of some
+  flwor expr within the given expr.
+********************************************************************************/
+void MarkJSONScans::markScans(expr* node)
+{
+  if (node->get_expr_kind() == flwor_expr_kind)
+  {
+    flwor_expr* flwor = static_cast<flwor_expr*>(node);
+
+    for (csize i = 0; i < flwor->num_clauses(); ++i)
+    {
+      if (flwor->get_clause(i)->get_kind() == flwor_clause::for_clause)
+        markScan(flwor, i);
+    }
+  }
+
+  ExprIterator iter(node);
+  while (!iter.done())
+  {
+    markScans(**iter);
+    iter.next();
+  }
+}
+
+
+/*******************************************************************************
+  If the domain of the for clause at the given position is a jn:parse-json
+  call, attach to the call the JSONScan that consists of:
+
+  - the lookup paths through which the query uses the for variable, if it
+    uses the variable only as the start of lookup chains with constant keys,
+  - the equality predicates between a lookup chain and a string or integer
+    literal found among the conjuncts of the where clauses that follow the for
+    clause with only for, let, and where clauses in between. A record that
+    does not satisfy such a predicate makes the where clause false, so the
+    flwor returns nothing for it. The predicates are not used if the for
+    clause has a positional variable or allows empty, because skipping records
+    would then change the result.
+********************************************************************************/
+void MarkJSONScans::markScan(flwor_expr* flwor, csize pos)
+{
+  for_clause* fc = static_cast<for_clause*>(flwor->get_clause(pos));
+  expr* domainExpr = skip_wrappers(fc->get_expr());
+
+  if (domainExpr->get_function_kind() != FunctionConsts::FN_JSONIQ_PARSE_JSON_1 &&
+      domainExpr->get_function_kind() != FunctionConsts::FN_JSONIQ_PARSE_JSON_2)
+    return;
+
+  const var_expr* var = fc->get_var();
+  JSONScan_t scan = new JSONScan;
+
+  bool project = findPaths(flwor, var, scan.getp());
+
+  if (!project)
+    scan = new JSONScan;
+
+  if (fc->get_pos_var() == NULL && !fc->is_allowing_empty())
+  {
+    for (csize i = pos + 1; i < flwor->num_clauses(); ++i)
+    {
+      flwor_clause* c = flwor->get_clause(i);
+
+      if (c->get_kind() == flwor_clause::where_clause)
+      {
+        expr* whereExpr = static_cast<where_clause*>(c)->get_expr();
+
+        if (whereExpr->get_function_kind() == FunctionConsts::OP_AND_N)
+        {
+          fo_expr* andExpr = static_cast<fo_expr*>(whereExpr);
+
+          for (csize j = 0; j < andExpr->num_args(); ++j)
+            addPredicate(andExpr->get_arg(j), var, scan.getp());
+        }
+        else
+        {
+          addPredicate(whereExpr, var, scan.getp());
+        }
+      }
+      else if (c->get_kind() != flwor_clause::for_clause &&
+               c->get_kind() != flwor_clause::let_clause)
+      {
+        break;
+      }
+    }
+  }
+
+  // The paths of the predicates are lookup chains in the where clauses, so
+  // they are among the paths found above, if any.
+  if (!project || scan->getNode(0).theChildren.empty())
+    scan->getNodes()[0].theKeep = true;
+
+  if (!scan->isTrivial())
+    static_cast<fo_expr*>(domainExpr)->set_json_scan(scan.getp());
+}
+
+
+/*******************************************************************************
+  Add to the given scan the lookup paths through which the given expr uses
+  the given variable. Return false if the expr uses the variable in any other
+  way, in which case the whole value of the variable must be built.
+********************************************************************************/
+bool MarkJSONScans::findPaths(
+    expr* node,
+    const var_expr* var,
+    JSONScan* scan)
+{
+  FunctionConsts::FunctionKind fkind = node->get_function_kind();
+
+  if (fkind == FunctionConsts::OP_ZORBA_MULTI_OBJECT_LOOKUP_2 ||
+      fkind == FunctionConsts::OP_ZORBA_SINGLE_OBJECT_LOOKUP_2)
+  {
+    JSONScan::Path path;
+
+    if (get_lookup_path(node, var, path))
+    {
+      scan->addPath(path);
+      return true;
+    }
+  }
+  else if (node == var)
+  {
+    return false;
+  }
+
+  ExprIterator iter(node);
+  while (!iter.done())
+  {
+    if (!findPaths(**iter, var, scan))
+      return false;
+
+    iter.next();
+  }
+
+  return true;
+}
+
+
+/*******************************************************************************
+  If the given where conjunct compares a lookup chain on the given variable
+  with a string or integer literal by eq or =, under the codepoint collation,
+  add the comparison to the given scan as a predicate.
+********************************************************************************/
+void MarkJSONScans::addPredicate(
+    expr* node,
+    const var_expr* var,
+    JSONScan* scan)
+{
+  node = skip_wrappers(node);
+
+  if (node->get_function_kind() == FunctionConsts::FN_BOOLEAN_1)
+    node = skip_wrappers(static_cast<fo_expr*>(node)->get_arg(0));
+
+  if (node->get_expr_kind() != fo_expr_kind)
+    return;
+
+  fo_expr* compExpr = static_cast<fo_expr*>(node);
+  CompareConsts::CompareType compKind = compExpr->get_func()->comparisonKind();
+
+  if (compKind != CompareConsts::VALUE_EQUAL &&
+      compKind != CompareConsts::GENERAL_EQUAL)
+    return;
+
+  if (compExpr->get_sctx()->get_default_collation(compExpr->get_loc()) !=
+      W3C_CODEPT_COLLATION_NS)
+    return;
+
+  for (csize i = 0; i < 2; ++i)
+  {
+    expr* valueExpr = skip_atomization(compExpr->get_arg(1 - i));
+
+    if (valueExpr->get_expr_kind() != const_expr_kind)
+      continue;
+
+    store::Item* value = static_cast<const_expr*>(valueExpr)->get_val();
+
+    if (value->getTypeCode() != store::XS_STRING &&
+        value->getTypeCode() != store::XS_INTEGER)
+      continue;
+
+    JSONScan::Path path;
+
+    if (get_lookup_path(skip_atomization(compExpr->get_arg(i)), var, path) &&
+        !path.empty())
+    {
+      scan->addPredicate(path, value);
+      return;
+    }
+  }
+}
+
+
+}
+/* vim:set et sw=2 ts=2: */
@@ -39,6 +39,9 @@ public:
     MarkProducerNodeProps,
     EliminateNodeOps,
     MarkNodeCopyProps,
+    MarkDocProjections,
+    MarkJSONScans,
+    MarkBatchCalls,
     ReplaceExprWithConstantOneWhenPossible,
     SpecializeOperations,
     EliminateTypeEnforcingOperations,
@@ -17,18 +17,25 @@
 #ifndef ZORBA_COMPILER_REWRITER_RULESET_H
 #define ZORBA_COMPILER_REWRITER_RULESET_H
 
+#include <set>
 #include <string>
+#include <vector>
 
 #include "compiler/expression/expr_base.h"
 #include "compiler/rewriter/framework/rewriter_context.h"
 #include "compiler/rewriter/rules/rule_base.h"
 
+#include "store/api/doc_projection.h"
+
 
 namespace zorba
 {
 
 
 class SourceFinder;
+class flwor_expr;
+class relpath_expr;
+class JSONScan;
 
 
 PREPOST_RULE(EchoNodes);
@@ -237,6 +244,90 @@ protected:
 };
 
 
+/*******************************************************************************
+  Finds the paths that the query navigates within the documents returned by
+  fn:doc and fn:parse-xml and, if the query cannot reach any other part of
+  those documents, attaches the union of these paths, as a DocProjection, to
+  each fn:doc and fn:parse-xml call.
+
+  theDocVars  : The variables that are bound to the result of a doc source,
+                i.e., an fn:doc or fn:parse-xml call.
+  theDocCalls : The fn:doc and fn:parse-xml calls of the query.
+********************************************************************************/
+class MarkDocProjections : public RewriteRule
+{
+protected:
+  std::set<const var_expr*>   theDocVars;
+  std::vector<fo_expr*>       theDocCalls;
+  store::DocProjection_t      theProjection;
+
+public:
+  MarkDocProjections()
+    :
+    RewriteRule(RewriteRule::MarkDocProjections, "MarkDocProjections")
+  {
+  }
+
+  expr* apply(RewriterContext& rCtx, expr* node, bool& modified);
+
+protected:
+  void findDocVars(expr* node, bool& modified);
+
+  bool isDocSource(expr* node) const;
+
+  bool findPaths(expr* node, bool isSourcePos);
+
+  bool addPath(const relpath_expr* pathExpr);
+};
+
+
+/*******************************************************************************
+  Finds the for clauses that iterate over the result of a jn:parse-json call,
+  and attaches to the call a JSONScan with the fields of each returned object
+  that the query looks up, and the equality predicates of the following where
+  clauses, so that the JSON loader can skip the rest of the input.
+********************************************************************************/
+class MarkJSONScans : public RewriteRule
+{
+public:
+  MarkJSONScans()
+    :
+    RewriteRule(RewriteRule::MarkJSONScans, "MarkJSONScans")
+  {
+  }
+
+  expr* apply(RewriterContext& rCtx, expr* node, bool& modified);
+
+protected:
+  void markScans(expr* node);
+
+  void markScan(flwor_expr* flwor, csize pos);
+
+  bool findPaths(expr* node, const var_expr* var, JSONScan* scan);
+
+  void addPredicate(expr* node, const var_expr* var, JSONScan* scan);
+};
+
+
+/*******************************************************************************
+  Marks each flwor expr that returns, for every tuple of a single for clause,
+  a call to a batch external function with that call, so that the codegen
+  evaluates the flwor by a BatchCallIterator (see get_batch_call() in
+  flwor_rules.cpp).
+********************************************************************************/
+class MarkBatchCalls : public RewriteRule
+{
+public:
+  MarkBatchCalls()
+    :
+    RewriteRule(RewriteRule::MarkBatchCalls, "MarkBatchCalls")
+  {
+  }
+
+  expr* apply(RewriterContext& rCtx, expr* node, bool& modified);
+};
+
+
 }
 
 #endif /* ZORBA_REWRITE_RULE_H */
@@ -5277,6 +5277,16 @@ void* begin_visit(const AST_IndexDecl& v)
     {
       index->setMethod(IndexDecl::TREE);
     }
+    if (ZANN_CONTAINS(zann_full_text))
+    {
+#ifdef ZORBA_NO_FULL_TEXT
+      RAISE_ERROR(zerr::ZXQP0050_FEATURE_NOT_AVAILABLE, loc,
+      ERROR_PARAMS("full-text"));
+#else
+      index->setGeneral(true);
+      index->setFullText(true);
+#endif
+    }
     if (ZANN_CONTAINS(zann_unique))
     {
       index->setUnique(true);
@@ -5454,10 +5464,21 @@ void end_visit(const IndexKeyList& v, void* /*visit_state*/)
                      ZED(ZDST0027_NO_KEY_TYPE_DECL)));
       }
 
-      keyExpr = wrap_in_atomization(keyExpr);
+      // The key items of a full-text index are tokenized rather than atomized
+      // (see IndexDecl::getBuildExpr()), and the key expr is kept as is, so
+      // that it can be matched with the search context of ftcontains exprs.
+      if (!index->isFullText())
+        keyExpr = wrap_in_atomization(keyExpr);
     }
     else
     {
+      if (index->isFullText())
+      {
+        RAISE_ERROR(zerr::ZDST0027_INDEX_BAD_KEY_TYPE, kloc,
+        ERROR_PARAMS(index->getName()->getStringValue(),
+                     ZED(ZDST0027_FULL_TEXT_KEY_TYPE_DECL)));
+      }
+
       type = pop_tstack();
       ptype = TypeOps::prime_type(tm, *type);
       SequenceType::Quantifier quant = type->get_quantifier();
@@ -5529,7 +5550,7 @@ void end_visit(const IndexKeyList& v, void* /*visit_state*/)
       keyTypes[i] = ptype->getBaseBuiltinType();
     }
 
-    if (index->isGeneral())
+    if (index->isGeneral() && !index->isFullText())
     {
       // Eliminate duplicate key values, as they don't play any role in a
       // general comparison predicate.
@@ -7061,6 +7082,7 @@ void end_visit(const FLWORExpr& v, void* /*visit_state*/)
   theFlworClausesStack.resize(curClausePos);
 
   recognizePragma(flwor, "no-materialization");
+  recognizePragma(flwor, "parallel");
 
   push_nodestack(flwor);
 }
@@ -64,6 +64,7 @@ IndexDecl::IndexDecl(
   theSctx(sctx),
   theName(name),
   theIsGeneral(false),
+  theIsFullText(false),
   theIsUnique(false),
   theIsTemp(false),
   theMaintenanceMode(MANUAL),
@@ -74,7 +75,8 @@ IndexDecl::IndexDecl(
   theDomainPosVar(NULL),
   theViewExpr(NULL),
   theBuildExpr(NULL),
-  theDocIndexerExpr(NULL)
+  theDocIndexerExpr(NULL),
+  theHasFieldDependencies(false)
 {
 }
 
@@ -91,7 +93,8 @@ IndexDecl::IndexDecl(::zorba::serialization::Archiver& ar)
   theDomainPosVar(NULL),
   theViewExpr(NULL),
   theBuildExpr(NULL),
-  theDocIndexerExpr(NULL)
+  theDocIndexerExpr(NULL),
+  theHasFieldDependencies(false)
 {
 }
 
@@ -104,6 +107,7 @@ void IndexDecl::serialize(::zorba::serialization::Archiver& ar)
   ar & theSctx;
   ar & theName;
   ar & theIsGeneral;
+  ar & theIsFullText;
   ar & theIsUnique;
   ar & theIsTemp;
   SERIALIZE_ENUM(MaintenanceMode, theMaintenanceMode);
@@ -119,6 +123,9 @@ void IndexDecl::serialize(::zorba::serialization::Archiver& ar)
 
   ar & theBuildPlan;
   ar & theDocIndexerPlan;
+
+  ar & theHasFieldDependencies;
+  ar & theFieldDependencies;
 }
 
 
@@ -358,6 +365,8 @@ void IndexDecl::analyze()
   }
   else if (theMaintenanceMode == DOC_MAP)
   {
+    analyzeFieldDependencies();
+
     // Have to do this here (rather than during runtime) so that we don't have to
     // serialize the index exprs.
     (void)getDocIndexer(theLocation);
@@ -479,6 +488,120 @@ void IndexDecl::analyzeExprInternal(
 }
 
 
+/*******************************************************************************
+  Find the fields of the domain items that the key exprs depend on (see
+  theHasFieldDependencies). This is possible only if the domain expr is the
+  (possibly type-checked) xqddf:collection() invocation itself, so that each
+  domain item is a collection root.
+********************************************************************************/
+void IndexDecl::analyzeFieldDependencies()
+{
+  theHasFieldDependencies = false;
+  theFieldDependencies.clear();
+
+  if (theDomainSourceExprs.size() != 1)
+    return;
+
+  expr* domainExpr = getDomainExpr();
+
+  while (true)
+  {
+    if (domainExpr->get_expr_kind() == treat_expr_kind)
+    {
+      domainExpr = static_cast<treat_expr*>(domainExpr)->get_input();
+    }
+    else if (domainExpr->get_expr_kind() == fo_expr_kind &&
+             static_cast<fo_expr*>(domainExpr)->get_func()->getKind() ==
+             FunctionConsts::OP_CHECK_DISTINCT_NODES_1)
+    {
+      domainExpr = static_cast<fo_expr*>(domainExpr)->get_arg(0);
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  if (domainExpr != theDomainSourceExprs[0])
+    return;
+
+  std::vector<zstring> fields;
+
+  for (csize i = 0; i < theKeyExprs.size(); ++i)
+  {
+    if (!collectFieldDependencies(theKeyExprs[i], fields))
+      return;
+  }
+
+  std::sort(fields.begin(), fields.end());
+  fields.erase(std::unique(fields.begin(), fields.end()), fields.end());
+
+  theFieldDependencies.swap(fields);
+  theHasFieldDependencies = true;
+}
+
+
+/*******************************************************************************
+  Add to the given vector the names of the fields that the given expr looks up
+  in the domain item. Return false if the expr accesses the domain item in any
+  other way, e.g., by navigating it with a path expr or passing it to a
+  function other than an object lookup.
+********************************************************************************/
+bool IndexDecl::collectFieldDependencies(
+    expr* e,
+    std::vector<zstring>& fields) const
+{
+  if (e->get_expr_kind() == fo_expr_kind)
+  {
+    fo_expr* foExpr = static_cast<fo_expr*>(e);
+    FunctionConsts::FunctionKind fkind = foExpr->get_func()->getKind();
+
+    if (fkind == FunctionConsts::OP_ZORBA_MULTI_OBJECT_LOOKUP_2 ||
+        fkind == FunctionConsts::OP_ZORBA_SINGLE_OBJECT_LOOKUP_2)
+    {
+      expr* objExpr = foExpr->get_arg(0);
+
+      while (objExpr->get_expr_kind() == wrapper_expr_kind ||
+             objExpr->get_expr_kind() == treat_expr_kind)
+      {
+        if (objExpr->get_expr_kind() == wrapper_expr_kind)
+          objExpr = static_cast<wrapper_expr*>(objExpr)->get_input();
+        else
+          objExpr = static_cast<treat_expr*>(objExpr)->get_input();
+      }
+
+      if (objExpr == getDomainVariable())
+      {
+        const expr* nameExpr = foExpr->get_arg(1);
+
+        if (nameExpr->get_expr_kind() != const_expr_kind)
+          return false;
+
+        fields.push_back(
+          static_cast<const const_expr*>(nameExpr)->get_val()->getStringValue());
+
+        return true;
+      }
+    }
+  }
+  else if (e == getDomainVariable())
+  {
+    return false;
+  }
+
+  ExprIterator iter(e);
+  while (!iter.done())
+  {
+    if (!collectFieldDependencies(**iter, fields))
+      return false;
+
+    iter.next();
+  }
+
+  return true;
+}
+
+
 /******************************************************************************
   Create the expression that represents the index as a view.
  
@@ -679,6 +802,16 @@ expr* IndexDecl::getBuildExpr(const QueryLoc& loc)
     subst[pos] = newpos;
 
     clonedExprs[i+1] = theKeyExprs[i]->clone(udf, subst);
+
+    if (theIsFullText)
+    {
+      clonedExprs[i+1] = theCCB->theEM->
+      create_fo_expr(sctx,
+                     udf,
+                     clonedExprs[i+1]->get_loc(),
+                     BUILTIN_FUNC(OP_FULL_TEXT_INDEX_KEYS_1),
+                     clonedExprs[i+1]);
+    }
   }
 
   //
@@ -829,6 +962,16 @@ DocIndexer* IndexDecl::getDocIndexer(const QueryLoc& loc)
     subst[pos] = newpos;
 
     clonedExprs[i+1] = theKeyExprs[i]->clone(udf, subst);
+
+    if (theIsFullText)
+    {
+      clonedExprs[i+1] = theCCB->theEM->
+      create_fo_expr(sctx,
+                     udf,
+                     clonedExprs[i+1]->get_loc(),
+                     BUILTIN_FUNC(OP_FULL_TEXT_INDEX_KEYS_1),
+                     clonedExprs[i+1]);
+    }
   }
 
   //
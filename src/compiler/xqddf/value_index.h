@@ -61,6 +61,7 @@ typedef rchandle<DocIndexer> DocIndexer_t;
   IndexPropertyList := ("unique" | "non" "unique" |
                         "value" "range" | "value" "equality" |
                         "general" "range" | "general" "equality" |
+                        "full" "text" |
                         "automatically" "maintained" | "manually" "maintained")*
 
   IndexDomainExpr := PathExpr
@@ -111,6 +112,20 @@ typedef rchandle<DocIndexer> DocIndexer_t;
   theIsGeneral:
   -------------
 
+  theIsFullText:
+  --------------
+  Whether it is a full-text index or not (declared with the %an:full-text
+  annotation). A full-text index is an inverted index: it is a general hash
+  index whose keys are the normalized (lower-case, diacritics-stripped) tokens
+  of the items returned by its single key expr, i.e., it maps each token to
+  the list of domain nodes whose key items contain that token. The key expr
+  may not have a type declaration; instead of being atomized, the key items
+  are tokenized by the full-text-index-keys function in the same way as the
+  search context of an ftcontains expr (see FullTextIndexKeysIterator). The
+  index is used by the IndexMatchingRule to restrict the domain of a FOR
+  clause to the nodes that contain all the tokens required by an ftcontains
+  predicate; the predicate itself is kept to check phrases, distances, etc.
+
   theIsUnique:
   ------------
   Whether it is a unique index or not.
@@ -147,8 +162,9 @@ typedef rchandle<DocIndexer> DocIndexer_t;
   The key expressions of the index. If kexpr is a key expr specified in the
   index declaration, the actual domain expr is:
 
-  for value indexes   : keyExpr := fn:data(kexpr) treat as typeDecl
-  for general indexes : distinct-values(fn:data(kexpr) treat as typeDecl)
+  for value indexes     : keyExpr := fn:data(kexpr) treat as typeDecl
+  for general indexes   : distinct-values(fn:data(kexpr) treat as typeDecl)
+  for full-text indexes : kexpr
 
   theKeyTypes:
   ------------
@@ -206,6 +222,9 @@ typedef rchandle<DocIndexer> DocIndexer_t;
   for $$dot at $$pos in domainExpr
   return general-index-entry-builder($$dot, fieldExpr);
 
+  For full-text indexes, fieldExpr is wrapped in a call to the
+  full-text-index-keys function.
+
   theBuildPlan:
   -------------
   The runtime plan corresponding to theBuildExpr. During runtime (see
@@ -233,6 +252,22 @@ typedef rchandle<DocIndexer> DocIndexer_t;
   store during an apply-updates, so that the store can obtain the index entries
   corresponding to a document that is being updated within collection C, and
   using these entries, maintain the index appropriately.
+
+  theHasFieldDependencies:
+  ------------------------
+  Whether the fields in theFieldDependencies are the only part of a domain item
+  that the key exprs depend on. This is the case if the domain expr returns
+  the docs of a collection (so that each domain item is a collection root) and
+  the key exprs access the domain var only through object lookups with a
+  constant field name. If so, an update that only inserts, deletes, renames,
+  or replaces the values of other fields of a root object cannot change the
+  index entries of that object, and the store skips the maintenance of the
+  index for that object (see CollectionPul::computeIndexDeltas()).
+
+  theFieldDependencies:
+  ---------------------
+  The names of the fields of the domain items that the key exprs read, sorted
+  and without duplicates. Meaningful only if theHasFieldDependencies is true.
 ********************************************************************************/
 class IndexDecl : public SimpleRCObject
 {
@@ -263,6 +298,7 @@ private:
   store::Item_t                   theName;
 
   bool                            theIsGeneral;
+  bool                            theIsFullText;
   bool                            theIsUnique;
   bool                            theIsTemp;
   MaintenanceMode                 theMaintenanceMode;
@@ -292,6 +328,9 @@ private:
   PlanIter_t                      theDocIndexerPlan;
   DocIndexer_t                    theDocIndexer;
 
+  bool                            theHasFieldDependencies;
+  std::vector<zstring>            theFieldDependencies;
+
 public:
   SERIALIZABLE_CLASS(IndexDecl)
   IndexDecl(::zorba::serialization::Archiver& ar);
@@ -314,6 +353,10 @@ public:
 
   void setGeneral(bool gen) { theIsGeneral = gen; }
 
+  bool isFullText() const { return theIsFullText; }
+
+  void setFullText(bool ft) { theIsFullText = ft; }
+
   bool getUnique() const { return theIsUnique; }
 
   void setUnique(bool unique) { theIsUnique = unique; }
@@ -368,6 +411,13 @@ public:
 
   void analyze();
 
+  bool hasFieldDependencies() const { return theHasFieldDependencies; }
+
+  const std::vector<zstring>& getFieldDependencies() const
+  {
+    return theFieldDependencies;
+  }
+
   flwor_expr* getViewExpr(std::vector<let_clause*>*& keyClauses);
 
   expr* getBuildExpr(const QueryLoc& loc);
@@ -385,6 +435,10 @@ private:
       std::vector<expr*>& sourceExprs,
       std::vector<var_expr*>& varExprs,
       expr* dotVar);
+
+  void analyzeFieldDependencies();
+
+  bool collectFieldDependencies(expr* e, std::vector<zstring>& fields) const;
 };
 
 
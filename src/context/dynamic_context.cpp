@@ -40,6 +40,7 @@
 
 #include "runtime/api/plan_wrapper.h"
 #include "runtime/base/plan_iterator.h"
+#include "runtime/indexing/hash_join.h"
 
 #include "zorbautils/hashmap_itemp.h"
 #include "util/string_util.h"
@@ -127,7 +128,9 @@ dynamic_context::dynamic_context(dynamic_context* parent)
   keymap(NULL),
   theAvailableIndices(NULL),
   theAvailableMaps(NULL),
+  theHashJoinTables(NULL),
   theEnvironmentVariables(NULL),
+  theProjectedDocuments(NULL),
   theSnapshotID(0),
   theDocLoadingUserTime(0.0),
   theDocLoadingTime(0)
@@ -182,6 +185,12 @@ dynamic_context::~dynamic_context()
 
   if (theAvailableMaps)
     delete theAvailableMaps;
+
+  if (theHashJoinTables)
+    delete theHashJoinTables;
+
+  if (theProjectedDocuments)
+    delete theProjectedDocuments;
 }
 
 
@@ -744,6 +753,86 @@ void dynamic_context::unbindIndex(store::Item* qname)
 }
 
 
+/*******************************************************************************
+
+********************************************************************************/
+HashJoinTable* dynamic_context::getHashJoinTable(store::Item* qname) const
+{
+  if (theHashJoinTables == NULL)
+    return NULL;
+
+  HashJoinTable_t table;
+
+  if (theHashJoinTables->get(qname, table))
+  {
+    return table.getp();
+  }
+  else
+  {
+    return NULL;
+  }
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void dynamic_context::bindHashJoinTable(
+    store::Item* qname,
+    HashJoinTable_t& table)
+{
+  if (theHashJoinTables == NULL)
+    theHashJoinTables = new HashJoinTableMap(HashMapItemPointerCmp(0, NULL), 8, false);
+
+  if (!theHashJoinTables->insert(qname, table))
+  {
+    ZORBA_ASSERT(false);
+  }
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void dynamic_context::unbindHashJoinTable(store::Item* qname)
+{
+  if (theHashJoinTables != NULL)
+    theHashJoinTables->erase(qname);
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+store::Item* dynamic_context::getProjectedDocument(
+    const zstring& uri,
+    const store::DocProjection* projection) const
+{
+  if (theProjectedDocuments == NULL)
+    return NULL;
+
+  ProjectedDocMap::const_iterator ite =
+  theProjectedDocuments->find(std::make_pair(uri, projection));
+
+  return (ite != theProjectedDocuments->end() ? ite->second.getp() : NULL);
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void dynamic_context::bindProjectedDocument(
+    const zstring& uri,
+    const store::DocProjection* projection,
+    const store::Item_t& doc)
+{
+  if (theProjectedDocuments == NULL)
+    theProjectedDocuments = new ProjectedDocMap;
+
+  (*theProjectedDocuments)[std::make_pair(uri, projection)] = doc;
+}
+
+
 /*******************************************************************************
 
 ********************************************************************************/
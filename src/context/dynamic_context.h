@@ -50,6 +50,8 @@ template <class V> class ItemPointerHashMap;
     current value, which is either a single item or a temp sequence.
   - A map mapping the uri of each index to the store object representing the
     index (store::Index_t)
+  - A map mapping the name of each hash join table created by the hash join
+    rewrite (see rewriter/rules/index_join_rule.cpp) to the table itself
 ********************************************************************************/
 class dynamic_context
 {
@@ -119,8 +121,13 @@ protected:
 
   ITEM_PTR_HASH_MAP(store::Index_t, IndexMap);
 
+  ITEM_PTR_HASH_MAP(HashJoinTable_t, HashJoinTableMap);
+
   typedef std::map<const zstring, const zstring> EnvVarMap;
 
+  typedef std::map<std::pair<zstring, const store::DocProjection*>,
+                   store::Item_t> ProjectedDocMap;
+
 protected:
   dynamic_context            * theParent;
 
@@ -138,9 +145,13 @@ protected:
 
   IndexMap                   * theAvailableMaps;
 
+  HashJoinTableMap           * theHashJoinTables;
+
   //MODIFY
   EnvVarMap                  * theEnvironmentVariables;
 
+  ProjectedDocMap            * theProjectedDocuments;
+
   locale::iso639_1::type       theLang;
   locale::iso3166_1::type      theCountry;
   time::calendar::type         theCalendar;
@@ -248,6 +259,26 @@ public:
 
   void unbindIndex(store::Item* qname);
 
+  HashJoinTable* getHashJoinTable(store::Item* qname) const;
+
+  void bindHashJoinTable(store::Item* qname, HashJoinTable_t& table);
+
+  void unbindHashJoinTable(store::Item* qname);
+
+  /**
+   * Projected documents are not added to the store, so fn:doc() remembers
+   * them here to return the same document node every time it is called with
+   * the same uri (and projection) during an execution.
+   */
+  store::Item* getProjectedDocument(
+      const zstring& uri,
+      const store::DocProjection* projection) const;
+
+  void bindProjectedDocument(
+      const zstring& uri,
+      const store::DocProjection* projection,
+      const store::Item_t& doc);
+
   store::Index* getMap(store::Item* qname, bool lookupParent = true) const;
 
   void bindMap(store::Item* qname, store::Index_t& index);
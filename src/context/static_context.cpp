@@ -2520,8 +2520,12 @@ void static_context::bind_fn(
 
   if (theFunctionMap == NULL)
   {
-    csize size = (is_global_root_sctx() ? 500 : 32);
-    theFunctionMap = new FunctionMap(HashMapItemPointerCmp(0, NULL), size, false);
+    // The root sctx may get new functions bound to it while queries are being
+    // compiled (see BuiltinFunctionLibrary::populateNamespace), so its maps
+    // must be synchronized.
+    bool isRoot = is_global_root_sctx();
+    csize size = (isRoot ? 500 : 32);
+    theFunctionMap = new FunctionMap(HashMapItemPointerCmp(0, NULL), size, isRoot);
   }
 
   FunctionInfo fi(f.getp());
@@ -2547,7 +2551,8 @@ void static_context::bind_fn(
     if (theFunctionArityMap == NULL)
     {
       theFunctionArityMap =
-      new FunctionArityMap(HashMapItemPointerCmp(0, NULL), 16, false);
+      new FunctionArityMap(HashMapItemPointerCmp(0, NULL), 16,
+                           is_global_root_sctx());
     }
 
     std::vector<FunctionInfo>* fv = 0;
@@ -2721,6 +2726,9 @@ function* static_context::lookup_fn(
 
   while (sctx != NULL)
   {
+    if (sctx->is_global_root_sctx() && GENV_FUNC_LIB->hasLazyGroups())
+      GENV_FUNC_LIB->populateNamespace(qname2->getNamespace());
+
     if (sctx->theFunctionMap != NULL && sctx->theFunctionMap->get(qname2, fi))
     {
       function* f = fi.theFunction;
@@ -2814,6 +2822,9 @@ void static_context::get_functions(std::vector<function *>& functions) const
   std::vector<function*> disabled;
   std::vector<zstring> importedBuiltinModules;
 
+  if (GENV_FUNC_LIB->hasLazyGroups())
+    GENV_FUNC_LIB->populateAll();
+
   const static_context* sctx = this;
 
   while (sctx != NULL)
@@ -2957,6 +2968,9 @@ void static_context::find_functions(
   FunctionInfo fi;
   store::Item* qname2 = const_cast<store::Item*>(qname);
 
+  if (is_global_root_sctx() && GENV_FUNC_LIB->hasLazyGroups())
+    GENV_FUNC_LIB->populateNamespace(qname2->getNamespace());
+
   if (theFunctionMap != NULL && theFunctionMap->get(qname2, fi))
   {
     if (!fi.theIsDisabled)
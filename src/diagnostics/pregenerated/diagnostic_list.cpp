@@ -739,6 +739,9 @@ ZorbaErrorCode ZXQP0065_INVALID_ANNOTATION( "zerr:ZXQP0065" );
 ZorbaErrorCode ZXQP0066_INVALID_ANNOTATION_LITERAL_VALUE( "zerr:ZXQP0066" );
 
 
+ZorbaErrorCode ZXQP0067_MEMORY_LIMIT_EXCEEDED( "zerr:ZXQP0067" );
+
+
 #if !defined(ZORBA_NO_FULL_TEXT)
 ZorbaErrorCode ZXQP8401_THESAURUS_VERSION_MISMATCH( "zerr:ZXQP8401" );
 
@@ -523,6 +523,7 @@ extern entry const dict_en[] = {
   { "zerr:ZXQP0064", "\"$1\": is not a valid argument index for function \"$2\", valid indexes are in the range [1-$3]" },
   { "zerr:ZXQP0065", "\"$1\": is not a valid annotation for function \"$2\", $3" },
   { "zerr:ZXQP0066", "\"$1\": is not a valid annotation literal for annotation \"$2\", $3" },
+  { "zerr:ZXQP0067", "query memory limit of $1 bytes exceeded ($2 bytes used)" },
 #if !defined(ZORBA_NO_FULL_TEXT)
   { "zerr:ZXQP8401", "\"$1\": wrong WordNet file version; should be \"$2\"" },
 #endif
@@ -1040,6 +1041,7 @@ extern entry const dict_en[] = {
   { "~XUST0002_Transform", "transform expression witn non-updating or vacuous modify clause" },
   { "~XUST0002_UDF_2", "\"$2\": function declared updating but body is not updating or vacuous" },
   { "~ZAPI0014_BadType_3", "invalid type: must be $3" },
+  { "~ZDST0027_FULL_TEXT_KEY_TYPE_DECL", "full-text index can not have a key type declaration" },
   { "~ZDST0027_MULTI_VALUED_KEY_TYPE_DECL", "value index can not have a key type declaration with * or + quantifier" },
   { "~ZDST0027_NON_ATOMIC_KEY_TYPE", "index has non-atomic key type declaration" },
   { "~ZDST0027_NON_ORDERED_KEY_TYPE", "range index can not have type $3 in key type declaration" },
@@ -169,6 +169,7 @@
 #define ZED_ZXQD0004_NOT_WITHIN_RANGE "~ZXQD0004_NOT_WITHIN_RANGE"
 #define ZED_ZAPI0014_BadType_3 "~ZAPI0014_BadType_3"
 #define ZED_ZDST0027_NO_KEY_TYPE_DECL "~ZDST0027_NO_KEY_TYPE_DECL"
+#define ZED_ZDST0027_FULL_TEXT_KEY_TYPE_DECL "~ZDST0027_FULL_TEXT_KEY_TYPE_DECL"
 #define ZED_ZDST0027_NON_SPECIFIC_KEY_TYPE_DECL "~ZDST0027_NON_SPECIFIC_KEY_TYPE_DECL"
 #define ZED_ZDST0027_MULTI_VALUED_KEY_TYPE_DECL "~ZDST0027_MULTI_VALUED_KEY_TYPE_DECL"
 #define ZED_ZDST0027_NON_ATOMIC_KEY_TYPE "~ZDST0027_NON_ATOMIC_KEY_TYPE"
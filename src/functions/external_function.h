@@ -63,6 +63,8 @@ public:
 
   unsigned short getScriptingKind() const { return theScriptingKind; }
 
+  ExternalFunction* getImpl() const { return theImpl; }
+
   bool accessesDynCtx() const;
 
   bool propagatesInputNodes(expr* fo, csize input) const;
@@ -16,6 +16,7 @@
  #include "stdafx.h"
 
 #include "runtime/indexing/index_ddl.h"
+#include "runtime/indexing/hash_join.h"
 
 #include "compiler/expression/fo_expr.h"
 #include "compiler/expression/expr.h"
@@ -46,6 +47,42 @@ PlanIter_t op_create_internal_index::codegen(
 }
 
 
+PlanIter_t op_hash_join_build::codegen(
+    CompilerCB* cb,
+    static_context* sctx,
+    const QueryLoc& loc,
+    std::vector<PlanIter_t>& argv,
+    expr& ann) const
+{
+  fo_expr* fo = static_cast<fo_expr*>(&ann);
+
+  const const_expr* qnameExpr = static_cast<const const_expr*>(fo->get_arg(0));
+
+  return new HashJoinBuildIterator(sctx,
+                                   loc,
+                                   argv[1],
+                                   const_cast<store::Item*>(qnameExpr->get_val()));
+}
+
+
+PlanIter_t op_hash_join_probe::codegen(
+    CompilerCB* cb,
+    static_context* sctx,
+    const QueryLoc& loc,
+    std::vector<PlanIter_t>& argv,
+    expr& ann) const
+{
+  fo_expr* fo = static_cast<fo_expr*>(&ann);
+
+  const const_expr* qnameExpr = static_cast<const const_expr*>(fo->get_arg(0));
+
+  return new HashJoinProbeIterator(sctx,
+                                   loc,
+                                   argv[1],
+                                   const_cast<store::Item*>(qnameExpr->get_val()));
+}
+
+
 PlanIter_t fn_zorba_ddl_create_index::codegen(
   CompilerCB*,
   static_context* sctx,
@@ -102,6 +139,17 @@ PlanIter_t op_general_index_entry_builder::codegen(
 }
 
 
+PlanIter_t op_full_text_index_keys::codegen(
+  CompilerCB*,
+  static_context* sctx,
+  const QueryLoc& loc,
+  std::vector<PlanIter_t>& argv,
+  expr& ann) const
+{
+  return new FullTextIndexKeysIterator(sctx, loc, argv[0]);
+}
+
+
 PlanIter_t fn_zorba_ddl_probe_index_point_value::codegen(
   CompilerCB*,
   static_context* sctx,
@@ -184,12 +232,29 @@ void populate_context_index_ddl(static_context* sctx)
         GENV_TYPESYSTEM.ANY_ATOMIC_TYPE_STAR,
         GENV_TYPESYSTEM.ITEM_TYPE_STAR));
 
+  DECL(sctx, op_full_text_index_keys,
+       (createQName(zorba_op_ns, "", "full-text-index-keys"),
+        GENV_TYPESYSTEM.ITEM_TYPE_STAR,
+        GENV_TYPESYSTEM.STRING_TYPE_STAR));
+
   DECL(sctx, op_create_internal_index,
        (createQName(zorba_op_ns, "", "create-internal-index"),
         GENV_TYPESYSTEM.QNAME_TYPE_ONE,
         GENV_TYPESYSTEM.ITEM_TYPE_STAR,
         GENV_TYPESYSTEM.EMPTY_TYPE));
 
+  DECL(sctx, op_hash_join_build,
+       (createQName(zorba_op_ns, "", "hash-join-build"),
+        GENV_TYPESYSTEM.QNAME_TYPE_ONE,
+        GENV_TYPESYSTEM.ITEM_TYPE_STAR,
+        GENV_TYPESYSTEM.EMPTY_TYPE));
+
+  DECL(sctx, op_hash_join_probe,
+       (createQName(zorba_op_ns, "", "hash-join-probe"),
+        GENV_TYPESYSTEM.QNAME_TYPE_ONE,
+        GENV_TYPESYSTEM.ANY_ATOMIC_TYPE_QUESTION,
+        GENV_TYPESYSTEM.ANY_NODE_TYPE_STAR));
+
   DECL(sctx, fn_zorba_ddl_create_index,
        (createQName("http://zorba.io/modules/store/static/indexes/ddl",
                     "",
@@ -65,6 +65,55 @@ public:
 };
 
 
+/*******************************************************************************
+  op:hash-join-build($name as xs:QName, $items as item*)
+
+  The hash join counterpart of create-internal-index: the second param is bound
+  to the same kind of build expr, but the entries are stored in an in-memory
+  hash table instead of a temp store index (see runtime/indexing/hash_join.h).
+********************************************************************************/
+class op_hash_join_build : public function
+{
+public:
+  op_hash_join_build(const signature& sig)
+    :
+    function(sig, FunctionConsts::OP_HASH_JOIN_BUILD_2)
+  {
+  }
+
+  bool accessesDynCtx() const { return true; }
+
+  unsigned short getScriptingKind() const { return SIMPLE_EXPR; }
+
+  bool mustCopyInputNodes(expr* fo, csize input) const { return false; }
+
+  BoolAnnotationValue ignoresSortedNodes(expr* fo, csize input) const
+  {
+    return ANNOTATION_TRUE;
+  }
+
+  CODEGEN_DECL();
+};
+
+
+/*******************************************************************************
+  op:hash-join-probe($name as xs:QName, $key as xs:anyAtomicType?) as node()*
+********************************************************************************/
+class op_hash_join_probe : public function
+{
+public:
+  op_hash_join_probe(const signature& sig)
+    :
+    function(sig, FunctionConsts::OP_HASH_JOIN_PROBE_2)
+  {
+  }
+
+  bool accessesDynCtx() const { return true; }
+
+  CODEGEN_DECL();
+};
+
+
 /*******************************************************************************
   fn-zorba-ddl:create($indexName as xs:QName)
 ********************************************************************************/
@@ -168,6 +217,32 @@ public:
 };
 
 
+/*******************************************************************************
+  op:full-text-index-keys($items as item()*) as xs:string*
+
+  Returns the distinct normalized tokens of the given items. It is used to
+  compute the keys of full-text indexes (see compiler/xqddf/value_index.h).
+********************************************************************************/
+class op_full_text_index_keys : public function
+{
+public:
+  op_full_text_index_keys(const signature& sig)
+    :
+    function(sig, FunctionConsts::OP_FULL_TEXT_INDEX_KEYS_1)
+  {
+  }
+
+  bool mustCopyInputNodes(expr* fo, csize input) const { return false; }
+
+  BoolAnnotationValue ignoresSortedNodes(expr* fo, csize input) const
+  {
+    return ANNOTATION_TRUE;
+  }
+
+  CODEGEN_DECL();
+};
+
+
 /*******************************************************************************
   fn-zorba-ddl:probe-index-point-value(
       $indexName as xs:QName, 
@@ -41,16 +41,18 @@ PlanIter_t fn_jsoniq_parse_json::codegen(
     std::vector<PlanIter_t>& argv,
     expr& ann) const
 {
+  JSONScan* lScan = static_cast<fo_expr&>(ann).get_json_scan();
+
   SingletonIterator* lArg = dynamic_cast<SingletonIterator*>(argv[0].getp());
   if (lArg && lArg->getValue()->isAtomic())
   {
     const QueryLoc& lArgLoc = lArg->getLocation();
-    return new JSONParseIterator(sctx, loc, argv, lArgLoc);
+    return new JSONParseIterator(sctx, loc, argv, lArgLoc, lScan);
   }
   else
   {
     QueryLoc lArgLoc = QueryLoc::null;
-    return new JSONParseIterator(sctx, loc, argv, lArgLoc);
+    return new JSONParseIterator(sctx, loc, argv, lArgLoc, lScan);
   }
 }
 
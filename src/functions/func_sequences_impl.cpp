@@ -1007,6 +1007,23 @@ PlanIter_t fn_head::codegen(
 }
 
 
+/*******************************************************************************
+
+********************************************************************************/
+PlanIter_t fn_doc::codegen(
+    CompilerCB* /*cb*/,
+    static_context* sctx,
+    const QueryLoc& loc,
+    std::vector<PlanIter_t>& argv,
+    expr& ann) const
+{
+  return new FnDocIterator(sctx,
+                           loc,
+                           argv,
+                           static_cast<fo_expr&>(ann).get_projection());
+}
+
+
 /*******************************************************************************
 
 ********************************************************************************/
@@ -17,10 +17,31 @@
 #include "functions/function.h"
 #include "functions/func_parsing_and_serializing.h"
 
+#include "runtime/parsing_and_serializing/parsing_and_serializing.h"
+
+#include "compiler/expression/fo_expr.h"
+
 namespace zorba
 {
 
 
+/*******************************************************************************
+
+********************************************************************************/
+PlanIter_t fn_parse_xml_3_0::codegen(
+    CompilerCB*,
+    static_context* sctx,
+    const QueryLoc& loc,
+    std::vector<PlanIter_t>& argv,
+    expr& ann) const
+{
+  return new FnParseXmlIterator(sctx,
+                                loc,
+                                argv,
+                                static_cast<fo_expr&>(ann).get_projection());
+}
+
+
 /*******************************************************************************
   
 ********************************************************************************/
@@ -65,6 +65,9 @@ typedef enum
   FN_ZORBA_XQDDF_REFRESH_INDEX_1,
   OP_VALUE_INDEX_ENTRY_BUILDER_N,
   OP_GENERAL_INDEX_ENTRY_BUILDER_N,
+  OP_FULL_TEXT_INDEX_KEYS_1,
+  OP_HASH_JOIN_BUILD_2,
+  OP_HASH_JOIN_PROBE_2,
 
   FN_EXACTLY_ONE_1,
   FN_MAX_1,
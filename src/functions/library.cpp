@@ -17,8 +17,13 @@
 
 #include <iostream>
 
+#include <zorba/properties.h>
+#include <zorba/util/time.h>
+
 #include "zorbamisc/ns_consts.h"
 
+#include "context/static_context.h"
+
 #include "functions/library.h"
 #include "functions/function.h"
 #include "functions/signature.h"
@@ -105,26 +110,28 @@ void library_init()
 
 
 BuiltinFunctionLibrary::BuiltinFunctionLibrary()
+  :
+  theRootSctx(NULL),
+  theHasLazyGroups(false)
 {
-  theFunctions = new function*[FunctionConsts::FN_MAX_FUNC];
+  theFunctions = new std::atomic<function*>[FunctionConsts::FN_MAX_FUNC];
 
-  memset(&theFunctions[0], 0, FunctionConsts::FN_MAX_FUNC * sizeof(function*));
+  for (csize i = 0; i < FunctionConsts::FN_MAX_FUNC; ++i)
+    theFunctions[i].store(NULL, std::memory_order_relaxed);
 }
 
 
 void BuiltinFunctionLibrary::populate(static_context* sctx)
 {
+  theRootSctx = sctx;
+
   populate_context_accessors(sctx);
   populate_context_any_uri(sctx);
   populate_context_accessors_impl(sctx);
-  populate_context_base64(sctx);
   populate_context_booleans(sctx);
   populate_context_booleans_impl(sctx);
   populate_context_collections(sctx);
   populate_context_context(sctx);
-  populate_context_csv(sctx);
-  populate_context_datetime(sctx);
-  populate_context_dctx(sctx);
   populate_context_durations_dates_times(sctx);
   populate_context_durations_dates_times_impl(sctx);
   populate_context_errors_and_diagnostics(sctx);
@@ -132,13 +139,8 @@ void BuiltinFunctionLibrary::populate(static_context* sctx)
   populate_context_index_ddl(sctx);
   populate_context_index_func(sctx);
   populate_context_ic_ddl(sctx);
-  populate_context_json(sctx);
-  populate_context_jsound(sctx);
   populate_context_maths(sctx);
   populate_context_nodes(sctx);
-  populate_context_item(sctx);
-  populate_context_reference(sctx);
-  populate_context_node_position(sctx);
   populate_context_numerics(sctx);
   populate_context_other_diagnostics(sctx);
   populate_context_parsing_and_serializing(sctx);
@@ -146,19 +148,12 @@ void BuiltinFunctionLibrary::populate(static_context* sctx)
   populate_context_parse_fragment_impl(sctx);
   populate_context_qnames(sctx);
   populate_context_random(sctx);
-  populate_context_schema(sctx);
-  populate_context_sctx(sctx);
-  populate_context_seq(sctx);
   populate_context_strings(sctx);
   populate_context_strings_impl(sctx);
-  populate_context_uris(sctx);
   populate_context_sequences(sctx);
   populate_context_sequences_impl(sctx);
-  populate_context_xqdoc(sctx);
   populate_context_fn_hof_functions(sctx);
   populate_context_hof_impl(sctx);
-  populate_context_documents(sctx);
-  populate_context_maps(sctx);
 
   populateContext_Arithmetics(sctx);
   populateContext_Numerics(sctx);
@@ -171,13 +166,52 @@ void BuiltinFunctionLibrary::populate(static_context* sctx)
   populate_context_reflection(sctx);
   populate_context_apply(sctx);
 
-  populate_context_fetch(sctx);
+  populate_context_jsoniq_functions(sctx);
+  populate_context_jsoniq_functions_impl(sctx);
+
+  // The following groups contain only functions of builtin modules that must
+  // be explicitly imported by a query, so their registration is deferred.
+  addLazyGroup(static_context::ZORBA_BASE64_FN_NS,
+               populate_context_base64);
+  addLazyGroup(static_context::ZORBA_JSON_CSV_FN_NS,
+               populate_context_csv);
+  addLazyGroup(static_context::ZORBA_DATETIME_FN_NS,
+               populate_context_datetime);
+  addLazyGroup(static_context::ZORBA_DCTX_FN_NS,
+               populate_context_dctx);
+  addLazyGroup(static_context::ZORBA_STORE_DOCUMENTS_FN_NS,
+               populate_context_documents);
+  addLazyGroup(static_context::ZORBA_FETCH_FN_NS,
+               populate_context_fetch);
 #ifndef ZORBA_NO_FULL_TEXT
-  populate_context_ft_module(sctx);
+  addLazyGroup(static_context::ZORBA_FULL_TEXT_FN_NS,
+               populate_context_ft_module);
 #endif /* ZORBA_NO_FULL_TEXT */
+  addLazyGroup(static_context::ZORBA_ITEM_FN_NS,
+               populate_context_item);
+  addLazyGroup(static_context::ZORBA_JSON_XML_FN_NS,
+               populate_context_json);
+  addLazyGroup(static_context::ZORBA_JSOUND_FN_NS,
+               populate_context_jsound);
+  addLazyGroup(static_context::ZORBA_STORE_UNORDERED_MAPS_FN_NS,
+               populate_context_maps);
+  addLazyGroup(static_context::ZORBA_NODEPOS_FN_NS,
+               populate_context_node_position);
+  addLazyGroup(static_context::ZORBA_REFERENCE_FN_NS,
+               populate_context_reference);
+  addLazyGroup(static_context::ZORBA_SCHEMA_FN_NS,
+               populate_context_schema);
+  addLazyGroup(static_context::ZORBA_SCTX_FN_NS,
+               populate_context_sctx);
+  addLazyGroup(static_context::ZORBA_SEQ_FN_NS,
+               populate_context_seq);
+  addLazyGroup(static_context::ZORBA_URI_FN_NS,
+               populate_context_uris);
+  addLazyGroup(static_context::ZORBA_XQDOC_FN_NS,
+               populate_context_xqdoc);
 
-  populate_context_jsoniq_functions(sctx);
-  populate_context_jsoniq_functions_impl(sctx);
+  if (!Properties::instance().getLazyBuiltins())
+    populateAll();
 
 #ifdef PRE_SERIALIZE_BUILTIN_FUNCTIONS
   ar.set_loading_hardcoded_objects(false);
@@ -185,11 +219,111 @@ void BuiltinFunctionLibrary::populate(static_context* sctx)
 }
 
 
+/*******************************************************************************
+
+********************************************************************************/
+void BuiltinFunctionLibrary::addLazyGroup(const char* ns, PopulateFunc f)
+{
+  theLazyGroups.emplace_back(ns, f);
+  theHasLazyGroups.store(true, std::memory_order_release);
+}
+
+
+/*******************************************************************************
+  Must be called with theLazyGroupsMutex held. The group is marked as populated
+  only after all its functions have been bound in the root sctx, because
+  populateNamespace() checks the flag without locking.
+********************************************************************************/
+void BuiltinFunctionLibrary::populateGroup(LazyGroup& group)
+{
+  if (group.theIsPopulated.load(std::memory_order_relaxed))
+    return;
+
+  if (Properties::instance().getTraceStartup())
+  {
+    time::walltime start, stop;
+    time::get_current_walltime(start);
+
+    (*group.thePopulateFunc)(theRootSctx);
+
+    time::get_current_walltime(stop);
+
+    Properties::instance().getDebugStream()
+      << "Lazy builtin functions  : " << group.theNamespace << " "
+      << time::get_walltime_elapsed(start, stop) << " milliseconds"
+      << std::endl;
+  }
+  else
+  {
+    (*group.thePopulateFunc)(theRootSctx);
+  }
+
+  group.theIsPopulated.store(true, std::memory_order_release);
+}
+
+
+/*******************************************************************************
+  Register the builtin functions whose names are in the given namespace, if
+  they have not been registered already. theLazyGroups does not change after
+  populate() returns, so the search is done without locking.
+********************************************************************************/
+void BuiltinFunctionLibrary::populateNamespace(const zstring& ns)
+{
+  std::deque<LazyGroup>::iterator ite = theLazyGroups.begin();
+  std::deque<LazyGroup>::iterator end = theLazyGroups.end();
+
+  for (; ite != end; ++ite)
+  {
+    if (ns == ite->theNamespace)
+      break;
+  }
+
+  if (ite == end || ite->theIsPopulated.load(std::memory_order_acquire))
+    return;
+
+  SYNC_CODE(AutoMutex lock(&theLazyGroupsMutex);)
+
+  populateGroup(*ite);
+
+  bool hasLazyGroups = false;
+
+  for (ite = theLazyGroups.begin(); ite != end; ++ite)
+  {
+    if (!ite->theIsPopulated.load(std::memory_order_relaxed))
+    {
+      hasLazyGroups = true;
+      break;
+    }
+  }
+
+  theHasLazyGroups.store(hasLazyGroups, std::memory_order_release);
+}
+
+
+/*******************************************************************************
+  Register all the builtin functions that have not been registered yet.
+********************************************************************************/
+void BuiltinFunctionLibrary::populateAll()
+{
+  SYNC_CODE(AutoMutex lock(&theLazyGroupsMutex);)
+
+  std::deque<LazyGroup>::iterator ite = theLazyGroups.begin();
+  std::deque<LazyGroup>::iterator end = theLazyGroups.end();
+
+  for (; ite != end; ++ite)
+  {
+    populateGroup(*ite);
+  }
+
+  theHasLazyGroups.store(false, std::memory_order_release);
+}
+
+
 BuiltinFunctionLibrary::~BuiltinFunctionLibrary()
 {
   for (csize i = 0; i < FunctionConsts::FN_MAX_FUNC; ++i)
   {
-    delete theFunctions[i];
+    delete theFunctions[i].load(std::memory_order_relaxed);
   }
 
   delete [] theFunctions;
@@ -17,8 +17,17 @@
 #ifndef ZORBA_FUNCTION_LIBRARY_H
 #define ZORBA_FUNCTION_LIBRARY_H
 
+#include <atomic>
+#include <deque>
+
+#include "common/common.h"
+
 #include "functions/function_consts.h"
 
+#include "zorbatypes/zstring.h"
+
+#include "zorbautils/mutex.h"
+
 
 namespace zorba 
 {
@@ -27,12 +36,64 @@ class static_context;
 class function;
 
 
+/*******************************************************************************
+  theFunctions:
+  -------------
+  Maps each function kind to the function object for that kind. The entries
+  are atomic because lazy groups may register functions while other threads
+  look up functions of other groups.
+
+  theLazyGroups:
+  --------------
+  The builtin functions whose names are in the namespace of a builtin module
+  (e.g. fetch, full-text, sctx) are not needed unless a query actually uses
+  that module. So, instead of registering them in the root sctx at startup,
+  their populate_context_* function is recorded here, and it is run the first
+  time a function in that namespace is looked up in the root sctx (see
+  static_context::lookup_fn()), or the first time getFunction() is called for
+  a function kind that has not been registered yet.
+
+  theHasLazyGroups:
+  -----------------
+  True if at least one of the lazy groups has not been populated yet.
+
+  theHasLazyGroups and the theIsPopulated flags of the groups are read without
+  locking; they are set (with release semantics) only after the functions of
+  the groups have been registered, under theLazyGroupsMutex.
+********************************************************************************/
 class BuiltinFunctionLibrary 
 {
   friend class GlobalEnvironment;
 
 public:
-  function  ** theFunctions;
+  typedef void (*PopulateFunc)(static_context*);
+
+  struct LazyGroup
+  {
+    const char          * theNamespace;
+    PopulateFunc          thePopulateFunc;
+    std::atomic<bool>     theIsPopulated;
+
+    LazyGroup(const char* ns, PopulateFunc f)
+      :
+      theNamespace(ns),
+      thePopulateFunc(f),
+      theIsPopulated(false)
+    {
+    }
+  };
+
+public:
+  std::atomic<function*>  * theFunctions;
+
+protected:
+  static_context          * theRootSctx;
+
+  std::deque<LazyGroup>     theLazyGroups;
+
+  std::atomic<bool>         theHasLazyGroups;
+
+  SYNC_CODE(Mutex           theLazyGroupsMutex;)
 
 public:
   BuiltinFunctionLibrary();
@@ -41,15 +102,37 @@ public:
 
   void populate(static_context* sctx);
 
+  bool hasLazyGroups() const
+  {
+    return theHasLazyGroups.load(std::memory_order_acquire);
+  }
+
+  void populateNamespace(const zstring& ns);
+
+  void populateAll();
+
   function* getFunction(FunctionConsts::FunctionKind kind)
   {
-    return theFunctions[kind];
+    function* f = theFunctions[kind].load(std::memory_order_acquire);
+
+    if (f == NULL && hasLazyGroups())
+    {
+      populateAll();
+      f = theFunctions[kind].load(std::memory_order_acquire);
+    }
+
+    return f;
   }
 
   void addFunction(FunctionConsts::FunctionKind kind, function* f)
   {
-    theFunctions[kind] = f;
+    theFunctions[kind].store(f, std::memory_order_release);
   }
+
+protected:
+  void addLazyGroup(const char* ns, PopulateFunc f);
+
+  void populateGroup(LazyGroup& group);
 };
 
 
@@ -42,6 +42,16 @@ PlanIter_t fn_zorba_csv_parse::codegen(
   return new CsvParseIterator(sctx, loc, argv);
 }
 
+PlanIter_t fn_zorba_csv_parse_file::codegen(
+  CompilerCB*,
+  static_context* sctx,
+  const QueryLoc& loc,
+  std::vector<PlanIter_t>& argv,
+  expr& ann) const
+{
+  return new CsvParseFileIterator(sctx, loc, argv);
+}
+
 PlanIter_t fn_zorba_csv_serialize::codegen(
   CompilerCB*,
   static_context* sctx,
@@ -69,6 +79,19 @@ void populate_context_csv(static_context* sctx)
 
 
 
+      {
+    DECL_WITH_KIND(sctx, fn_zorba_csv_parse_file,
+        (createQName("http://zorba.io/modules/json-csv","","parse-file"), 
+        GENV_TYPESYSTEM.STRING_TYPE_ONE, 
+        GENV_TYPESYSTEM.JSON_OBJECT_TYPE_ONE, 
+        GENV_TYPESYSTEM.JSON_OBJECT_TYPE_STAR),
+        FunctionConsts::FN_ZORBA_CSV_PARSE_FILE_2);
+
+  }
+
+
+
+
       {
     DECL_WITH_KIND(sctx, fn_zorba_csv_serialize,
         (createQName("http://zorba.io/modules/json-csv","","serialize"), 
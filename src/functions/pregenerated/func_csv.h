@@ -54,6 +54,21 @@ public:
 };
 
 
+//fn-zorba-csv:parse-file
+class fn_zorba_csv_parse_file : public function
+{
+public:
+  fn_zorba_csv_parse_file(const signature& sig, FunctionConsts::FunctionKind kind)
+    : 
+    function(sig, kind)
+  {
+
+  }
+
+  CODEGEN_DECL();
+};
+
+
 //fn-zorba-csv:serialize
 class fn_zorba_csv_serialize : public function
 {
@@ -32,16 +32,6 @@ namespace zorba{
 
 
 
-PlanIter_t fn_parse_xml_3_0::codegen(
-  CompilerCB*,
-  static_context* sctx,
-  const QueryLoc& loc,
-  std::vector<PlanIter_t>& argv,
-  expr& ann) const
-{
-  return new FnParseXmlIterator(sctx, loc, argv);
-}
-
 PlanIter_t fn_serialize_3_0::codegen(
   CompilerCB*,
   static_context* sctx,
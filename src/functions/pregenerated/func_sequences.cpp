@@ -231,16 +231,6 @@ PlanIter_t fn_idref::codegen(
   return new FnIdRefIterator(sctx, loc, argv);
 }
 
-PlanIter_t fn_doc::codegen(
-  CompilerCB*,
-  static_context* sctx,
-  const QueryLoc& loc,
-  std::vector<PlanIter_t>& argv,
-  expr& ann) const
-{
-  return new FnDocIterator(sctx, loc, argv);
-}
-
 PlanIter_t fn_doc_available::codegen(
   CompilerCB*,
   static_context* sctx,
@@ -117,6 +117,7 @@
   FN_LAST_0,
   FN_STATIC_BASE_URI_0,
   FN_ZORBA_CSV_PARSE_2,
+  FN_ZORBA_CSV_PARSE_FILE_2,
   FN_ZORBA_CSV_SERIALIZE_2,
   FN_ZORBA_DATETIME_CURRENT_DATE_0,
   FN_ZORBA_DATETIME_CURRENT_DATETIME_0,
@@ -24,10 +24,13 @@
 
 #include "runtime/api/plan_wrapper.h"
 #include "runtime/base/plan_iterator.h"
+#include "runtime/util/sampler.h"
 #include "runtime/util/timeout.h"
 #include "runtime/visitors/iterprinter.h"
 #include "runtime/visitors/printer_visitor_api.h"
 
+#include "store/api/memory_account.h"
+
 using namespace std;
 
 namespace zorba {
@@ -48,6 +51,7 @@ PlanWrapper::PlanWrapper(
   theDynamicContext(NULL),
   theIsOpen(false),
   theTimeout(NULL),
+  theSampler(NULL),
   theExitValue(0)
 {
   assert (aCompilerCB);
@@ -100,6 +104,16 @@ PlanWrapper::~PlanWrapper()
 
   delete theTimeout;
 
+  if (theSampler)
+    theSampler->terminate();
+
+  delete theSampler;
+
+  // Temp sequences bound to global variables may outlive the plan state, and
+  // with it the quit flag that the account points to.
+  if (theMemoryAccount != NULL)
+    theMemoryAccount->setQuitFlag(NULL);
+
   delete thePlanState; 
   thePlanState = NULL;
 
@@ -119,6 +133,11 @@ void PlanWrapper::open()
 {
   ZORBA_ASSERT(!theIsOpen);
 
+  // Start sampling before opening the plan, because some iterators do much of
+  // their work in their open method.
+  if (theSampler)
+    theSampler->start();
+
   uint32_t offset = 0;
   theIterator->open(*thePlanState, offset);
 
@@ -236,6 +255,50 @@ void PlanWrapper::profile() const {
   }
 }
 
+/*******************************************************************************
+  Makes the plan be sampled every "interval" ms while it is open. Must be called
+  before the plan is opened.
+********************************************************************************/
+void PlanWrapper::enableSampling(unsigned long interval)
+{
+  ZORBA_ASSERT(!theIsOpen && !theSampler);
+
+  theSampler = new Sampler(interval);
+  thePlanState->theSampleStack = theSampler->getSampleStack();
+}
+
+
+/*******************************************************************************
+  Stops the sampling of the plan and prints the samples taken so far to the
+  debug stream. Must be called before the plan is closed, because the samples
+  refer to its iterators.
+********************************************************************************/
+void PlanWrapper::printSamples(Zorba_sample_format_t format)
+{
+  if (theSampler)
+  {
+    theSampler->terminate();
+    theSampler->print(Properties::instance().getDebugStream(), format);
+  }
+}
+
+
+/*******************************************************************************
+  Makes the runtime buffers of the plan charge their memory to a new account.
+  If "limit" is not 0, the plan is interrupted with a ZXQP0067 error as soon as
+  the buffers hold more than "limit" bytes. Must be called before the plan is
+  opened.
+********************************************************************************/
+void PlanWrapper::enableMemoryAccounting(uint64_t limit)
+{
+  ZORBA_ASSERT(!theIsOpen && theMemoryAccount == NULL);
+
+  theMemoryAccount = new store::MemoryAccount(limit);
+  theMemoryAccount->setQuitFlag(&thePlanState->theHasToQuit);
+  thePlanState->theMemoryAccount = theMemoryAccount.getp();
+}
+
+
 /*******************************************************************************
 
 ********************************************************************************/
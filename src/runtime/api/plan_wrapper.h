@@ -23,6 +23,7 @@
 #include "zorbautils/mutex.h"
 
 #include <zorba/item.h>
+#include <zorba/options.h>
 #include <api/serialization/serializable.h>
 
 
@@ -32,6 +33,7 @@ namespace zorba
 class PlanState;
 class DebuggerRuntime;
 class Timeout;
+class Sampler;
 class XQueryImpl;
 class dynamic_context;
 
@@ -59,6 +61,10 @@ class dynamic_context;
   constructor of "this", in which case the constructor will allocate a dctx and
   store a pointer to it in theDynamicContext, so that it will be deallocated by
   the destructor of "this".
+
+  - theMemoryAccount :
+  The account that the runtime buffers of the plan charge their memory to, or
+  NULL if memory accounting has not been enabled for the plan.
 ********************************************************************************/
 class PlanWrapper : public store::Iterator
 {
@@ -79,6 +85,10 @@ protected:
   Timeout            * theTimeout;
   Mutex                theTimeoutMutex;
 
+  Sampler            * theSampler;
+
+  store::MemoryAccount_t theMemoryAccount;
+
   store::Iterator_t    theExitValue;
 
 public:
@@ -110,6 +120,14 @@ public:
 
   void profile() const;
 
+  void enableSampling(unsigned long interval);
+
+  void printSamples(Zorba_sample_format_t format);
+
+  void enableMemoryAccounting(uint64_t limit);
+
+  store::MemoryAccount* getMemoryAccount() const { return theMemoryAccount.getp(); }
+
   bool isOpen() { return theIsOpen; }
 
 #ifndef NDEBUG
@@ -27,6 +27,7 @@
 #include "runtime/util/flowctl_exception.h"
 
 #include "store/api/item_factory.h"
+#include "store/api/memory_account.h"
 #include "store/api/store.h"
 
 #include "system/globalenv.h"
@@ -73,6 +74,8 @@ PlanState::PlanState(
   theLocalDynCtx(localDctx),
   theHasToQuit(false),
   theProfile( Properties::instance().getCollectProfile() ),
+  theSampleStack(NULL),
+  theMemoryAccount(NULL),
   theBlockOwned(true)
 {
   assert(globalDctx != NULL && localDctx != NULL);
@@ -92,6 +95,8 @@ PlanState::PlanState(PlanState& aPlanState):
       theDebuggerCommons(aPlanState.theDebuggerCommons),
       theHasToQuit(aPlanState.theHasToQuit),
       theProfile(aPlanState.theProfile),
+      theSampleStack(aPlanState.theSampleStack),
+      theMemoryAccount(aPlanState.theMemoryAccount),
       theBlockOwned(false)
 {
 }
@@ -103,6 +108,20 @@ void PlanState::checkDepth(const QueryLoc& loc)
 }
 
 
+/*******************************************************************************
+  Called when theHasToQuit is found set. Raises an error if the reason is that
+  the memory limit of the query has been exceeded.
+********************************************************************************/
+void PlanState::checkMemoryLimit(const QueryLoc& loc)
+{
+  if (theMemoryAccount != NULL && theMemoryAccount->isLimitExceeded())
+  {
+    RAISE_ERROR(zerr::ZXQP0067_MEMORY_LIMIT_EXCEEDED, loc,
+    ERROR_PARAMS(theMemoryAccount->getLimit(), theMemoryAccount->getPeak()));
+  }
+}
+
+
 PlanState::~PlanState()
 {
   if (theBlockOwned)
@@ -239,6 +258,8 @@ bool PlanIterator::consumeNext(
   {
     // std::cout << "Plan interupted" << std::endl;
 
+    planState.checkMemoryLimit(iter->getLocation());
+
     throw FlowCtlException(FlowCtlException::INTERRUPT);
   }
   bool status = iter->produceNext(result, planState);
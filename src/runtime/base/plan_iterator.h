@@ -17,6 +17,7 @@
 #ifndef ZORBA_RUNTIME_PLAN_ITERATOR
 #define ZORBA_RUNTIME_PLAN_ITERATOR
 
+#include <atomic>
 #include <stack>
 
 #include "common/shared_types.h"
@@ -99,6 +100,7 @@ class PlanIterVisitor;
 class dynamic_context;
 class DebuggerCommons;
 class XQueryImpl;
+class SampleStack;
 
 
 /*******************************************************************************
@@ -113,6 +115,19 @@ class XQueryImpl;
                     i.e. between every two iterator next calls. This value is
                     set by the StateWrapper class (see runtime/util/timeout.h)
                     after a user-defined timeout value is exceeded.
+
+  theSampleStack  : The shadow stack of active iterators that is read by the
+                    sampling profiler (see runtime/util/sampler.h), or NULL if
+                    the query is not being sampled. Nested plan states (e.g.
+                    the ones of UDF bodies) share the stack of their parent.
+
+  theMemoryAccount: The account that the runtime buffers of the query charge
+                    their memory to (see store/api/memory_account.h), or NULL.
+                    If the account has a limit, exceeding it sets theHasToQuit
+                    of the top-level plan state, and checkMemoryLimit() turns
+                    the resulting interrupt into a ZXQP0067 error. Nested plan
+                    states share the account of their parent, but see the
+                    flag only when control returns to the parent plan.
 ********************************************************************************/
 class PlanState
 {
@@ -141,6 +156,10 @@ public:
 
   bool const                theProfile;   // cache Properties::getProfile()
 
+  SampleStack             * theSampleStack;
+
+  store::MemoryAccount    * theMemoryAccount;
+
   bool                      theBlockOwned;
 
 public:
@@ -156,6 +175,8 @@ public:
   ~PlanState();
 
   void checkDepth(const QueryLoc& loc);
+
+  void checkMemoryLimit(const QueryLoc& loc);
 };
 
 
@@ -218,6 +239,77 @@ struct profile_data
   }
 };
 
+/*******************************************************************************
+  The stack of the iterators whose open/next/reset/count/skip/close method is
+  currently running, maintained only when a query is being sampled. It is
+  written by the thread that executes the query and read, without locking, by
+  the thread of the sampling profiler. A frame is stored before the depth that
+  covers it is published (with release semantics), so the sampler, which loads
+  the depth with acquire semantics, never sees a frame that has not been set.
+  It may still see a frame that is being popped or replaced; this is harmless,
+  because all the frames are iterators of the plan being sampled and they are
+  only used as keys until the samples are resolved, which happens after the
+  query execution has ended. The frames are NULL until first pushed.
+
+  Iterators nested more than MAX_DEPTH levels deep are counted but not
+  recorded, so their time is attributed to the deepest recorded iterator.
+********************************************************************************/
+class SampleStack
+{
+public:
+  static const uint32_t MAX_DEPTH = 256;
+
+  std::atomic<const PlanIterator*>  theFrames[MAX_DEPTH];
+  std::atomic<uint32_t>             theDepth;
+
+public:
+  SampleStack() : theDepth(0)
+  {
+    for (uint32_t i = 0; i < MAX_DEPTH; ++i)
+      theFrames[i].store(NULL, std::memory_order_relaxed);
+  }
+
+  void push(const PlanIterator* iter)
+  {
+    uint32_t depth = theDepth.load(std::memory_order_relaxed);
+    if (depth < MAX_DEPTH)
+      theFrames[depth].store(iter, std::memory_order_relaxed);
+    theDepth.store(depth + 1, std::memory_order_release);
+  }
+
+  void pop()
+  {
+    uint32_t depth = theDepth.load(std::memory_order_relaxed);
+    theDepth.store(depth - 1, std::memory_order_release);
+  }
+};
+
+
+/*******************************************************************************
+  Pushes an iterator on the sample stack of a plan state, if any, for the
+  lifetime of the frame object.
+********************************************************************************/
+class SampleFrame
+{
+  SampleStack  * theStack;
+
+public:
+  SampleFrame(PlanState& planState, const PlanIterator* iter)
+    :
+    theStack(planState.theSampleStack)
+  {
+    if (theStack)
+      theStack->push(iter);
+  }
+
+  ~SampleFrame()
+  {
+    if (theStack)
+      theStack->pop();
+  }
+};
+
+
 /*******************************************************************************
   Base class for all iterator state objects.
 ********************************************************************************/
@@ -468,6 +560,7 @@ public:
    */
   void open(PlanState& planState, uint32_t& offset)
   {
+    SampleFrame f(planState, this);
     TimerWrapper t(NULL, planState.theProfile, &mbr_fn::addCall);
 
     openImpl(planState, offset);
@@ -501,6 +594,7 @@ public:
     ZORBA_ASSERT(state->theIsOpened);
 #endif
 
+    SampleFrame f(planState, this);
     TimerWrapper t(state, planState.theProfile, &mbr_fn::addCall);
 
     resetImpl(planState);
@@ -520,6 +614,7 @@ public:
     PlanIteratorState* state =
         StateTraitsImpl<PlanIteratorState>::getState(planState, theStateOffset);
 
+    SampleFrame f(planState, this);
     TimerWrapper t(state, planState.theProfile, NULL);
 
     closeImpl(planState);
@@ -544,6 +639,7 @@ public:
     PlanIteratorState* state =
         StateTraitsImpl<PlanIteratorState>::getState(planState, theStateOffset);
 
+    SampleFrame f(planState, this);
     TimerWrapper t(state, planState.theProfile, NULL);
 
     return countImpl(result, planState);
@@ -567,6 +663,7 @@ public:
     PlanIteratorState* state =
         StateTraitsImpl<PlanIteratorState>::getState(planState, theStateOffset);
 
+    SampleFrame f(planState, this);
     TimerWrapper t(state, planState.theProfile, NULL);
 
     return skipImpl(count, planState);
@@ -589,6 +686,7 @@ public:
 #ifndef NDEBUG
     ZORBA_ASSERT(state->theIsOpened);
 #endif
+    SampleFrame f(planState, this);
     TimerWrapper t(state, planState.theProfile, &mbr_fn::addNext);
 
     return nextImpl(result, planState);
@@ -613,6 +711,8 @@ public:
   {
     if (planState.theHasToQuit)
     {
+      planState.checkMemoryLimit(iter->getLocation());
+
       // Quit the execution
       throw FlowCtlException(FlowCtlException::INTERRUPT);
     }
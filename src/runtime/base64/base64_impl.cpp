@@ -16,11 +16,14 @@
 #include "stdafx.h"
 
 #include <sstream>
+#include <vector>
 #include <zorba/util/transcode_stream.h>
 
 #include "system/globalenv.h"
 
+#include "diagnostics/dict.h"
 #include "diagnostics/xquery_diagnostics.h"
+#include "util/ascii_util.h"
 #include "zorbatypes/binary.h"
 
 #include "runtime/base64/base64.h"
@@ -30,6 +33,122 @@
 
 namespace zorba {
 
+/*******************************************************************************
+  An istream that decodes the content of an encoded, streamable xs:base64Binary
+  item on-the-fly. The item is kept alive for as long as the stream is used.
+  The stream can be rewound (i.e., it is seekable) only if the item is.
+********************************************************************************/
+class Base64DecodeStream : public std::istream
+{
+  class streambuf : public std::streambuf
+  {
+    store::Item_t      theItem;
+    std::streambuf   * theOrigBuf;
+    std::vector<char>  theEncoded;
+    std::vector<char>  theDecoded;
+    bool               theIsPadded;
+    bool               theIsEof;
+
+  public:
+    streambuf(store::Item_t& item)
+      :
+      theItem(item),
+      theOrigBuf(item->getStream().rdbuf()),
+      theIsPadded(false),
+      theIsEof(false)
+    {
+    }
+
+  protected:
+    int_type underflow();
+
+    pos_type seekoff(off_type, std::ios_base::seekdir, std::ios_base::openmode);
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which)
+    {
+      return seekoff(pos, std::ios_base::beg, which);
+    }
+  };
+
+  streambuf theBuf;
+
+public:
+  Base64DecodeStream(store::Item_t& item)
+    :
+    std::istream(NULL),
+    theBuf(item)
+  {
+    rdbuf(&theBuf);
+  }
+
+  static void release(std::istream* stream) { delete stream; }
+};
+
+
+Base64DecodeStream::streambuf::int_type
+Base64DecodeStream::streambuf::underflow()
+{
+  char buf[4096];
+
+  while (gptr() == egptr())
+  {
+    if (theIsEof)
+      return traits_type::eof();
+
+    std::streamsize const n = theOrigBuf->sgetn(buf, sizeof buf);
+    theIsEof = n <= 0;
+
+    for (std::streamsize i = 0; i < n; ++i)
+    {
+      if (ascii::is_space(buf[i]))
+        continue;
+      // Only the last group of 4 characters may end in padding.
+      if (theIsPadded)
+        throw XQUERY_EXCEPTION(
+          err::FORG0001,
+          ERROR_PARAMS(ZED(FORG0001_Base64BadChar_2), buf[i])
+        );
+      theEncoded.push_back(buf[i]);
+    }
+
+    // Decode whole groups of 4 characters only, unless this is the end.
+    std::vector<char>::size_type const len =
+      theIsEof ? theEncoded.size() : theEncoded.size() & ~3;
+
+    theDecoded.clear();
+    if (len > 0)
+    {
+      Base64::decode(&theEncoded[0], len, &theDecoded);
+      theIsPadded = theEncoded[len - 1] == '=';
+      theEncoded.erase(theEncoded.begin(), theEncoded.begin() + len);
+    }
+
+    if (!theDecoded.empty())
+      setg(&theDecoded[0], &theDecoded[0], &theDecoded[0] + theDecoded.size());
+  }
+  return traits_type::to_int_type(*gptr());
+}
+
+
+Base64DecodeStream::streambuf::pos_type
+Base64DecodeStream::streambuf::seekoff(
+    off_type off,
+    std::ios_base::seekdir dir,
+    std::ios_base::openmode)
+{
+  if (off != 0 || dir != std::ios_base::beg || !theItem->isSeekable())
+    return pos_type(off_type(-1));
+
+  theOrigBuf = theItem->getStream().rdbuf();
+  theEncoded.clear();
+  theDecoded.clear();
+  theIsPadded = false;
+  theIsEof = false;
+  setg(NULL, NULL, NULL);
+  return pos_type(0);
+}
+
+
 bool Base64DecodeIterator::nextImpl(
     store::Item_t& result,
     PlanState& planState) const
@@ -66,7 +185,19 @@ bool Base64DecodeIterator::nextImpl(
   {
     if (lItem->isEncoded())
     {
-      Base64::decode(lItem->getStream(), &lResultString);
+      // Decode as the result is being read rather than materializing either
+      // the encoded or the decoded value.
+      std::unique_ptr<std::istream> lStream(new Base64DecodeStream(lItem));
+      if (transcode::is_necessary(lEncoding.c_str()))
+      {
+        transcode::attach(*lStream, lEncoding.c_str());
+      }
+      GENV_ITEMFACTORY->createStreamableString(
+          result,
+          *lStream,
+          Base64DecodeStream::release,
+          lItem->isSeekable());
+      lStream.release();
     }
     else
     {
@@ -149,12 +280,21 @@ bool Base64EncodeIterator::nextImpl(
 
   if (consumeNext(lItem, theChildren[0].getp(), planState)) 
   {
-    lItem->getStringValue2(lTmpString);
-    // create a base64Binary item
-    // the content is the non-encoded string
-    GENV_ITEMFACTORY->createBase64Binary(
-      result, lTmpString.c_str(), lTmpString.size(), false
-    );
+    if (lItem->isStreamable())
+    {
+      // the content of the base64Binary item is the non-encoded stream of
+      // the string; it is encoded only if and when the item is serialized
+      GENV_ITEMFACTORY->createSharedStreamableBase64Binary(result, lItem);
+    }
+    else
+    {
+      lItem->getStringValue2(lTmpString);
+      // create a base64Binary item
+      // the content is the non-encoded string
+      GENV_ITEMFACTORY->createBase64Binary(
+        result, lTmpString.c_str(), lTmpString.size(), false
+      );
+    }
     STACK_PUSH (true, state);
   }
   STACK_END (state);
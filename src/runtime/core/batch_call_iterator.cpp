@@ -0,0 +1,434 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "stdafx.h"
+
+#include "diagnostics/assert.h"
+#include "diagnostics/xquery_exception.h"
+
+#include "runtime/core/batch_call_iterator.h"
+#include "runtime/core/fncall_iterator.h"
+#include "runtime/core/var_iterators.h"
+#include "runtime/visitors/planiter_visitor.h"
+
+#include "store/api/item_factory.h"
+
+#include "system/globalenv.h"
+
+#include "util/string_util.h"
+
+
+namespace zorba
+{
+
+namespace flwor
+{
+
+SERIALIZABLE_CLASS_VERSIONS(BatchCallIterator)
+
+
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//  BatchCallState                                                             //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+BatchCallState::BatchCallState()
+  :
+  thePosition(0),
+  theDomainDone(false),
+  theCurResult(0)
+{
+}
+
+
+BatchCallState::~BatchCallState()
+{
+}
+
+
+void BatchCallState::init(PlanState& planState)
+{
+  PlanIteratorState::init(planState);
+  thePosition = 0;
+  theDomainDone = false;
+  clearBatch();
+}
+
+
+void BatchCallState::reset(PlanState& planState)
+{
+  PlanIteratorState::reset(planState);
+  thePosition = 0;
+  theDomainDone = false;
+  clearBatch();
+}
+
+
+void BatchCallState::clearBatch()
+{
+  theTuples.clear();
+  theResults.clear();
+  theCurResult = 0;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//  BatchCallIterator                                                          //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************************
+
+********************************************************************************/
+BatchCallIterator::BatchCallIterator(
+    static_context* sctx,
+    const QueryLoc& loc,
+    ForLetClause& forClause,
+    PlanIter_t& whereClause,
+    PlanIter_t& returnClause,
+    PlanIter_t& call)
+  :
+  PlanIterator(sctx, loc),
+  theForClause(forClause),
+  theWhereClause(whereClause),
+  theReturnClause(returnClause),
+  theCall(call)
+{
+  assert(theForClause.theType == ForLetClause::FOR);
+  assert(dynamic_cast<ExtFunctionCallIterator*>(theCall.getp()) != NULL);
+}
+
+
+BatchCallIterator::~BatchCallIterator()
+{
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void BatchCallIterator::serialize(::zorba::serialization::Archiver& ar)
+{
+  serialize_baseclass(ar, (PlanIterator*)this);
+  ar & theForClause;
+  ar & theWhereClause; // can be null
+  ar & theReturnClause;
+  ar & theCall;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+const ExtFunctionCallIterator* BatchCallIterator::getCall() const
+{
+  return static_cast<const ExtFunctionCallIterator*>(theCall.getp());
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void BatchCallIterator::openImpl(PlanState& planState, uint32_t& offset)
+{
+  StateTraitsImpl<BatchCallState>::createState(planState, theStateOffset, offset);
+
+  BatchCallState* state =
+  StateTraitsImpl<BatchCallState>::getState(planState, theStateOffset);
+
+  state->init(planState);
+
+  theForClause.theInput->open(planState, offset);
+
+  theReturnClause->open(planState, offset);
+
+  if (theWhereClause != NULL)
+    theWhereClause->open(planState, offset);
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+bool BatchCallIterator::nextImpl(
+    store::Item_t& result,
+    PlanState& planState) const
+{
+  BatchCallState* state;
+  DEFAULT_STACK_INIT(BatchCallState, state, planState);
+
+  while (fillBatch(state, planState))
+  {
+    evalBatch(state);
+
+    for (state->theCurResult = 0;
+         state->theCurResult < state->theResults.size();
+         ++state->theCurResult)
+    {
+      getCall()->setBatchResult(planState,
+                                state->theResults[state->theCurResult]);
+
+      while (consumeNext(result, theReturnClause, planState))
+      {
+        STACK_PUSH(true, state);
+      }
+
+      theReturnClause->reset(planState);
+    }
+  }
+
+  STACK_END(state);
+}
+
+
+/*******************************************************************************
+  Consume domain items until the next batch of calls is complete. For each
+  item that passes the where clause, evaluate the args of the call and add
+  them to the batch. Return false if there are no more calls to make.
+********************************************************************************/
+bool BatchCallIterator::fillBatch(
+    BatchCallState* state,
+    PlanState& planState) const
+{
+  state->clearBatch();
+
+  if (state->theDomainDone)
+    return false;
+
+  const ExtFunctionCallIterator* call = getCall();
+  const BatchExternalFunction* f =
+  static_cast<const BatchExternalFunction*>(call->theFunction);
+
+  csize batchSize = f->getBatchSize();
+  if (batchSize == 0)
+    batchSize = 1;
+
+  csize numArgs = call->theChildren.size();
+  store::Item_t item;
+  store::Item_t argItem;
+
+  while (state->theTuples.size() < batchSize)
+  {
+    if (!consumeNext(item, theForClause.theInput, planState))
+    {
+      state->theDomainDone = true;
+      break;
+    }
+
+    ++state->thePosition;
+
+    bindVariables(item, state->thePosition, planState);
+
+    if (theWhereClause != NULL && !evalToBool(planState))
+      continue;
+
+    state->theTuples.push_back(std::vector<Item>());
+    std::vector<Item>& tuple = state->theTuples.back();
+    tuple.reserve(numArgs);
+
+    for (csize i = 0; i < numArgs; ++i)
+    {
+      const PlanIter_t& arg = call->theChildren[i];
+
+      if (consumeNext(argItem, arg, planState))
+        tuple.push_back(Item(argItem.getp()));
+      else
+        tuple.push_back(Item());
+
+      arg->reset(planState);
+    }
+  }
+
+  return !state->theTuples.empty();
+}
+
+
+/*******************************************************************************
+  Call the function on the current batch.
+********************************************************************************/
+void BatchCallIterator::evalBatch(BatchCallState* state) const
+{
+  const BatchExternalFunction* f =
+  static_cast<const BatchExternalFunction*>(getCall()->theFunction);
+
+  try
+  {
+    f->evaluateBatch(state->theTuples, state->theResults);
+  }
+  catch (ZorbaException& e)
+  {
+    set_source(e, loc);
+    throw;
+  }
+  catch (std::exception const& e)
+  {
+    throw XQUERY_EXCEPTION(
+      zerr::ZXQP0001_DYNAMIC_RUNTIME_ERROR,
+      ERROR_PARAMS(e.what()),
+      ERROR_LOC(loc));
+  }
+
+  if (state->theResults.size() != state->theTuples.size())
+  {
+    throw XQUERY_EXCEPTION(
+      zerr::ZXQP0001_DYNAMIC_RUNTIME_ERROR,
+      ERROR_PARAMS(BUILD_STRING(getCall()->getNameAsString(),
+                                ": evaluateBatch() returned ",
+                                state->theResults.size(),
+                                " results for ",
+                                state->theTuples.size(),
+                                " calls")),
+      ERROR_LOC(loc));
+  }
+}
+
+
+/*******************************************************************************
+  Bind the given domain item and its position to all the references of the FOR
+  and positional vars.
+********************************************************************************/
+void BatchCallIterator::bindVariables(
+    store::Item_t& item,
+    csize pos,
+    PlanState& planState) const
+{
+  std::vector<PlanIter_t>::const_iterator ite = theForClause.theVarRefs.begin();
+  std::vector<PlanIter_t>::const_iterator end = theForClause.theVarRefs.end();
+  for (; ite != end; ++ite)
+  {
+    static_cast<ForVarIterator*>((*ite).getp())->bind(item.getp(), planState);
+  }
+
+  if (!theForClause.thePosVarRefs.empty())
+  {
+    store::Item_t posItem;
+    GENV_ITEMFACTORY->createInteger(posItem, xs_integer(pos));
+
+    ite = theForClause.thePosVarRefs.begin();
+    end = theForClause.thePosVarRefs.end();
+    for (; ite != end; ++ite)
+    {
+      static_cast<ForVarIterator*>((*ite).getp())->bind(posItem.getp(), planState);
+    }
+  }
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+bool BatchCallIterator::evalToBool(PlanState& planState) const
+{
+  store::Item_t boolValue;
+  if (!consumeNext(boolValue, theWhereClause.getp(), planState))
+  {
+    theWhereClause->reset(planState);
+    return false;
+  }
+
+  bool value = boolValue->getBooleanValue();
+  theWhereClause->reset(planState);
+  return value;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void BatchCallIterator::resetImpl(PlanState& planState) const
+{
+  theReturnClause->reset(planState);
+
+  if (theWhereClause != NULL)
+    theWhereClause->reset(planState);
+
+  theForClause.theInput->reset(planState);
+
+  StateTraitsImpl<BatchCallState>::reset(planState, theStateOffset);
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void BatchCallIterator::closeImpl(PlanState& planState)
+{
+  theReturnClause->close(planState);
+
+  if (theWhereClause != NULL)
+    theWhereClause->close(planState);
+
+  theForClause.theInput->close(planState);
+
+  StateTraitsImpl<BatchCallState>::destroyState(planState, theStateOffset);
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+zstring BatchCallIterator::getNameAsString() const
+{
+  return "BatchCallIterator";
+}
+
+
+uint32_t BatchCallIterator::getStateSize() const
+{
+  return sizeof(BatchCallState);
+}
+
+
+uint32_t BatchCallIterator::getStateSizeOfSubtree() const
+{
+  uint32_t size = getStateSize();
+
+  size += theForClause.theInput->getStateSizeOfSubtree();
+
+  size += theReturnClause->getStateSizeOfSubtree();
+
+  if (theWhereClause != NULL)
+    size += theWhereClause->getStateSizeOfSubtree();
+
+  return size;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void BatchCallIterator::accept(PlanIterVisitor& v) const
+{
+  if (!v.hasToVisit(this))
+    return;
+
+  v.beginVisit(*this);
+
+  theForClause.accept(v);
+
+  if (theWhereClause != NULL)
+    v.visitFlworWhereClause(*theWhereClause);
+
+  v.visitFlworReturn(*theReturnClause);
+
+  v.endVisit(*this);
+}
+
+
+} // namespace flwor
+} // namespace zorba
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef ZORBA_RUNTIME_BATCH_CALL_ITERATOR
+#define ZORBA_RUNTIME_BATCH_CALL_ITERATOR
+
+#include <vector>
+
+#include <zorba/function.h>
+
+#include "common/common.h"
+#include "common/shared_types.h"
+
+#include "runtime/base/plan_iterator.h"
+#include "runtime/core/flwor_iterator.h"
+
+
+namespace zorba
+{
+
+class ExtFunctionCallIterator;
+
+namespace flwor
+{
+
+/***************************************************************************//**
+  State of a BatchCallIterator.
+
+  thePosition    : Number of domain items consumed so far.
+  theDomainDone  : Whether the domain has been exhausted.
+  theTuples      : The arguments of the calls of the current batch.
+  theResults     : theResults[i] is the result of the i-th call of the current
+                   batch.
+  theCurResult   : Position in theResults of the call whose result is being
+                   returned.
+********************************************************************************/
+class BatchCallState : public PlanIteratorState
+{
+public:
+  csize                                     thePosition;
+  bool                                      theDomainDone;
+
+  BatchExternalFunction::ArgumentTuples_t   theTuples;
+  std::vector<Item>                         theResults;
+
+  csize                                     theCurResult;
+
+public:
+  BatchCallState();
+
+  ~BatchCallState();
+
+  void init(PlanState& planState);
+
+  void reset(PlanState& planState);
+
+  void clearBatch();
+};
+
+
+/***************************************************************************//**
+  Evaluates a FLWOR expr of the form
+
+    for $x at $pos in domain_expr
+    where where_expr
+    return f(arg_1, ..., arg_n)
+
+  (with optional positional var and where clause), where f is an external
+  function implemented by a BatchExternalFunction, by calling f once per batch
+  of iterations instead of once per iteration.
+
+  For each iteration, the iterator binds the FOR and positional vars, evaluates
+  the where clause and then the args of the call (which the rewriter has
+  checked to yield at most one item each), and adds the args to the current
+  batch. Once the batch holds BatchExternalFunction::getBatchSize() tuples, or
+  the domain is exhausted, it passes them to
+  BatchExternalFunction::evaluateBatch(). The result of each call is then
+  handed to theCall (see ExtFunctionCallIterator::setBatchResult()) and
+  returned through the return clause, so that the declared return type of f
+  is still checked.
+
+  The rewriter chooses this iterator only for deterministic, simple external
+  functions (see the MarkBatchCalls rule), so the fact that the
+  calls are grouped and that the result cache of the function is bypassed
+  cannot be observed by the query.
+
+  theReturnClause : The call to f, possibly wrapped in a treat iterator.
+  theCall         : The ExtFunctionCallIterator of the call to f, inside
+                    theReturnClause. Its args are evaluated directly by this
+                    iterator.
+********************************************************************************/
+class BatchCallIterator : public PlanIterator
+{
+private:
+  ForLetClause              theForClause;
+  PlanIter_t                theWhereClause;
+  PlanIter_t                theReturnClause;
+  PlanIter_t                theCall;
+
+public:
+  SERIALIZABLE_CLASS(BatchCallIterator);
+  SERIALIZABLE_CLASS_CONSTRUCTOR2(BatchCallIterator, PlanIterator);
+  void serialize(::zorba::serialization::Archiver& ar);
+
+public:
+  BatchCallIterator(
+      static_context*  sctx,
+      const QueryLoc&  loc,
+      ForLetClause&    forClause,
+      PlanIter_t&      whereClause,
+      PlanIter_t&      returnClause,
+      PlanIter_t&      call);
+
+  ~BatchCallIterator();
+
+  void openImpl(PlanState& planState, uint32_t& offset);
+  bool nextImpl(store::Item_t& result, PlanState& planState) const;
+  void resetImpl(PlanState& planState) const;
+  void closeImpl(PlanState& planState);
+
+  zstring getNameAsString() const;
+
+  uint32_t getStateSize() const;
+
+  uint32_t getStateSizeOfSubtree() const;
+
+  void accept(PlanIterVisitor&) const;
+
+private:
+  const ExtFunctionCallIterator* getCall() const;
+
+  void bindVariables(
+      store::Item_t& item,
+      csize pos,
+      PlanState& planState) const;
+
+  bool evalToBool(PlanState& planState) const;
+
+  bool fillBatch(BatchCallState* state, PlanState& planState) const;
+
+  void evalBatch(BatchCallState* state) const;
+};
+
+
+}
+} /* namespace zorba */
+#endif
+
+/*
+ * Local variables:
+ * mode: c++
+ * End:
+ */
+/* vim:set et sw=2 ts=2: */
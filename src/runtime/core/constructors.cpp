@@ -39,6 +39,7 @@
 #include "store/api/temp_seq.h"
 #include "store/api/item_factory.h"
 #include "store/api/copymode.h"
+#include "store/api/memory_account.h"
 
 #include "util/ascii_util.h"
 #include "util/string_util.h"
@@ -176,6 +177,9 @@ bool DocumentIterator::nextImpl(store::Item_t& result, PlanState& planState) con
 
   path.pop();
 
+  if (planState.theMemoryAccount)
+    planState.theMemoryAccount->recordTree(result.getp());
+
   STACK_PUSH(true, state);
   STACK_END (state);
 }
@@ -534,6 +538,9 @@ bool ElementIterator::nextImpl(store::Item_t& result, PlanState& planState) cons
 
   path.pop();
 
+  if (theIsRoot && planState.theMemoryAccount)
+    planState.theMemoryAccount->recordTree(result.getp());
+
   STACK_PUSH(true, state);
   STACK_END(state);
 }
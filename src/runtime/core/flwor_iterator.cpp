@@ -754,12 +754,15 @@ void FlworState::init(
     {
       (*domiter) = new PlanIteratorWrapper(flc.theInput, planState);
       (*seqiter) = GENV_STORE.createTempSeq(flc.lazyEval());
+      (*seqiter)->setMemoryAccount(planState.theMemoryAccount);
     }
   }
 
   theNumTuples = 0;
   theCurTuplePos = 0;
   theFirstResult = true;
+
+  theMemory.attach(planState.theMemoryAccount);
 }
 
 
@@ -819,6 +822,8 @@ void FlworState::reset(PlanState& planState)
 
   if (theGroupMap != NULL)
     clearGroupMap();
+
+  theMemory.releaseAll();
 }
 
 
@@ -1338,6 +1343,8 @@ void FLWORIterator::materializeStreamTuple(
   csize numTuples = tuplesTable.size();
   tuplesTable.resize(numTuples + 1);
 
+  iterState->theMemory.charge(sizeof(StreamTuple));
+
   csize numForVars = theMaterializeClause->theInputForVars.size();
   csize numLetVars = theMaterializeClause->theInputLetVars.size();
 
@@ -1352,6 +1359,7 @@ void FLWORIterator::materializeStreamTuple(
                 theMaterializeClause->theInputForVars[i],
                 planState);
 
+    iterState->theMemory.charge(forItem.getp());
     streamTuple.theItems[i].transfer(forItem);
 
     theMaterializeClause->theInputForVars[i]->reset(planState);
@@ -1380,6 +1388,8 @@ void FLWORIterator::materializeStreamTuple(
   FlworState::SortTable& sortTable = iterState->theSortTable;
   sortTable.resize(numTuples + 1);
 
+  iterState->theMemory.charge(sizeof(SortTuple));
+
   std::vector<store::Item*>& sortTuple = sortTable[numTuples].theKeyValues;
   sortTuple.resize(numSpecs);
 
@@ -1388,6 +1398,7 @@ void FLWORIterator::materializeStreamTuple(
     store::Item_t sortKeyItem;
     if (consumeNext(sortKeyItem, orderSpecs[i].theDomainIter, planState))
     {
+      iterState->theMemory.charge(sortKeyItem.getp());
       sortTuple[i] = sortKeyItem.release();
 
       store::Item_t temp;
@@ -1405,6 +1416,8 @@ void FLWORIterator::materializeStreamTuple(
     orderSpecs[i].theDomainIter->reset(planState);
   }
 
+  sortTable[numTuples].computeCollationKeys(orderSpecs);
+
   sortTable[numTuples].theDataPos = numTuples;
 }
 
@@ -1429,6 +1442,8 @@ void FLWORIterator::materializeSortTupleAndResult(
   sortTable.resize(numTuples + 1);
   resultTable.resize(numTuples + 1);
 
+  iterState->theMemory.charge(sizeof(SortTuple) + sizeof(store::Iterator_t));
+
   // Create the sort tuple
 
   std::vector<OrderSpec>& orderSpecs = theOrderByClause->theOrderSpecs;
@@ -1442,6 +1457,7 @@ void FLWORIterator::materializeSortTupleAndResult(
     store::Item_t sortKeyItem;
     if (consumeNext(sortKeyItem, orderSpecs[i].theDomainIter, planState))
     {
+      iterState->theMemory.charge(sortKeyItem.getp());
       sortKey[i] = sortKeyItem.release();
 
       store::Item_t temp;
@@ -1459,10 +1475,14 @@ void FLWORIterator::materializeSortTupleAndResult(
     orderSpecs[i].theDomainIter->reset(planState);
   }
 
+  sortTable[numTuples].computeCollationKeys(orderSpecs);
+
   sortTable[numTuples].theDataPos = numTuples;
 
   store::Iterator_t iterWrapper = new PlanIteratorWrapper(theReturnClause, planState);
-  store::TempSeq_t resultSeq = GENV_STORE.createTempSeq(iterWrapper, false);
+  store::TempSeq_t resultSeq = GENV_STORE.createTempSeq(false);
+  resultSeq->setMemoryAccount(planState.theMemoryAccount);
+  resultSeq->init(iterWrapper);
   store::Iterator_t resultIter = resultSeq->getIterator();
 
   resultTable[numTuples].transfer(resultIter);
@@ -1486,9 +1506,9 @@ void FLWORIterator::materializeGroupTuple(
   std::unique_ptr<GroupTuple> groupTuple(new GroupTuple());
   std::vector<store::Item_t>& groupTupleItems = groupTuple->theItems;
 
-  std::vector<GroupingSpec> groupSpecs = theGroupByClause->theGroupingSpecs;
-  std::vector<GroupingSpec>::iterator specIter = groupSpecs.begin();
-  std::vector<GroupingSpec>::iterator specEnd = groupSpecs.end();
+  const std::vector<GroupingSpec>& groupSpecs = theGroupByClause->theGroupingSpecs;
+  std::vector<GroupingSpec>::const_iterator specIter = groupSpecs.begin();
+  std::vector<GroupingSpec>::const_iterator specEnd = groupSpecs.end();
 
   while ( specIter != specEnd )
   {
@@ -1501,9 +1521,11 @@ void FLWORIterator::materializeGroupTuple(
     ++specIter;
   }
 
+  groupTuple->computeCollationKeys(groupSpecs);
+
   GroupHashMap* groupMap = iterState->theGroupMap;
 
-  std::vector<NonGroupingSpec> nongroupingSpecs = theGroupByClause->theNonGroupingSpecs;
+  const std::vector<NonGroupingSpec>& nongroupingSpecs = theGroupByClause->theNonGroupingSpecs;
   std::vector<store::TempSeq_t>* nongroupVarSequences = 0;
   csize numNonGroupingSpecs = nongroupingSpecs.size();
 
@@ -1528,13 +1550,20 @@ void FLWORIterator::materializeGroupTuple(
       store::Iterator_t iterWrapper = 
       new PlanIteratorWrapper(nongroupingSpecs[i].theInput, planState);
 
-      store::TempSeq_t result = GENV_STORE.createTempSeq(iterWrapper, false);
+      store::TempSeq_t result = GENV_STORE.createTempSeq(false);
+      result->setMemoryAccount(planState.theMemoryAccount);
+      result->init(iterWrapper);
 
       nongroupVarSequences->push_back(result);
 
       nongroupingSpecs[i].reset(planState);
     }
 
+    iterState->theMemory.charge(sizeof(GroupTuple));
+
+    for (csize i = 0; i < groupTupleItems.size(); ++i)
+      iterState->theMemory.charge(groupTupleItems[i].getp());
+
     groupMap->insert(groupTuple.get(), nongroupVarSequences);
     groupTuple.release();
   }
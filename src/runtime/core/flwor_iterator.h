@@ -76,8 +76,10 @@ namespace flwor
 ********************************************************************************/
 class ForLetClause : public ::zorba::serialization::SerializeBaseClass
 {
+  friend class BatchCallIterator;
   friend class FLWORIterator;
   friend class FlworState;
+  friend class ParallelForIterator;
   friend class PrinterVisitor;
 
 protected:
@@ -359,6 +361,12 @@ public:
   - theFirstResult :
   ------------------
 
+  - theMemory :
+  -------------
+  The memory of the tuples in theTuplesTable, theSortTable, and theGroupMap,
+  as charged to the memory account of the query (if any). The temp seqs in
+  these tables charge their own memory.
+
 ********************************************************************************/
 class FlworState : public PlanIteratorState
 {
@@ -398,6 +406,8 @@ protected:
 
   bool                           theFirstResult;
 
+  store::MemoryCharge            theMemory;
+
 public:
   FlworState();
 
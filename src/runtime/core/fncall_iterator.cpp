@@ -21,6 +21,7 @@
 #include "zorba/iterator.h"
 #include "zorba/function.h"
 #include "zorba/vector_item_sequence.h"
+#include "zorba/singleton_item_sequence.h"
 
 #include "diagnostics/xquery_diagnostics.h"
 #include "diagnostics/user_exception.h"
@@ -177,6 +178,8 @@ void UDFunctionCallIteratorState::open(
   thePlanState->theDebuggerCommons = planState.theDebuggerCommons;
 #endif
   thePlanState->theQuery = planState.theQuery;
+  thePlanState->theSampleStack = planState.theSampleStack;
+  thePlanState->theMemoryAccount = planState.theMemoryAccount;
 }
 
 
@@ -831,7 +834,8 @@ public:
 ********************************************************************************/
 ExtFunctionCallIteratorState::ExtFunctionCallIteratorState():
     theIsEvaluated(false),
-    theProfileDataMap(NULL)
+    theProfileDataMap(NULL),
+    theHasBatchResult(false)
 {
 }
 
@@ -856,6 +860,8 @@ void ExtFunctionCallIteratorState::reset(PlanState& planState)
   theResultIter = NULL;
   theResult = NULL;
   theIsEvaluated = false;
+  theHasBatchResult = false;
+  theBatchResult = Item();
 }
 
 
@@ -1064,7 +1070,11 @@ bool ExtFunctionCallIterator::nextImpl(
 {
   try
   {
-    if (isCached())
+    ExtFunctionCallIteratorState* lState =
+    StateTraitsImpl<ExtFunctionCallIteratorState>::getState(aPlanState,
+                                                            theStateOffset);
+
+    if (isCached() && !lState->theHasBatchResult)
       return nextImplCache(aResult, aPlanState);
     else
       return nextImplNoCache(aResult, aPlanState);
@@ -1286,6 +1296,19 @@ bool ExtFunctionCallIterator::nextImplNoCache(
 ********************************************************************************/
 void ExtFunctionCallIterator::evaluate(PlanState& aPlanState, ExtFunctionCallIteratorState* aState, std::vector<zorba::ItemSequence*>& aArguments) const
 {
+  if (aState->theHasBatchResult)
+  {
+    if (!aState->theBatchResult.isNull())
+    {
+      aState->theResult = new SingletonItemSequence(aState->theBatchResult);
+      aState->theResultIter = aState->theResult->getIterator();
+      aState->theResultIter->open();
+    }
+
+    aState->theIsEvaluated = true;
+    return;
+  }
+
   if (theFunction->isContextual())
   {
     ContextualExternalFunction const *const lFunction =
@@ -1336,6 +1359,24 @@ void ExtFunctionCallIterator::evaluate(PlanState& aPlanState, ExtFunctionCallIte
 }
 
 
+/*******************************************************************************
+  Make the next evaluation of this call return the given item (or the empty
+  sequence, if the item is null), which a BatchCallIterator has computed by
+  evaluating a batch of calls. The iterator must have been reset since it last
+  returned a result.
+********************************************************************************/
+void ExtFunctionCallIterator::setBatchResult(
+    PlanState& aPlanState,
+    const Item& aResult) const
+{
+  ExtFunctionCallIteratorState* lState =
+  StateTraitsImpl<ExtFunctionCallIteratorState>::getState(aPlanState,
+                                                          theStateOffset);
+  lState->theHasBatchResult = true;
+  lState->theBatchResult = aResult;
+}
+
+
 /*******************************************************************************
 ********************************************************************************/
 bool ExtFunctionCallIterator::isCached() const
@@ -41,6 +41,11 @@ class FunctionCache;
 
 class PrinterVisitor;
 
+namespace flwor
+{
+class BatchCallIterator;
+}
+
 /*******************************************************************************
 theCache:
 ---------
@@ -237,7 +242,10 @@ protected:
 
 
 /*******************************************************************************
-
+  theHasBatchResult : Whether the result of the call has already been computed
+                      by a BatchCallIterator, together with the results of
+                      other calls of the same batch. In this case, theBatchResult
+                      is returned (if not null) instead of calling the function.
 ********************************************************************************/
 class ExtFunctionCallIteratorState : public FunctionCallIteratorState
 {
@@ -247,6 +255,8 @@ class ExtFunctionCallIteratorState : public FunctionCallIteratorState
   Iterator_t                 theResultIter;
   bool                       theIsEvaluated;
   ProfileDataMap           * theProfileDataMap;
+  bool                       theHasBatchResult;
+  Item                       theBatchResult;
 
   ExtFunctionCallIteratorState();
 
@@ -262,6 +272,7 @@ class ExtFunctionCallIterator : public NaryBaseIterator<ExtFunctionCallIterator,
                                                         ExtFunctionCallIteratorState>
 {
   friend class PrinterVisitor;
+  friend class flwor::BatchCallIterator;
 
 protected:
   rchandle<external_function> theFunctionDef;
@@ -316,6 +327,8 @@ public:
 
   void evaluate(PlanState& aPlanState, ExtFunctionCallIteratorState* aState, std::vector<zorba::ItemSequence*>& aArguments) const;
 
+  void setBatchResult(PlanState& aPlanState, const Item& aResult) const;
+
   bool isCached() const;
 
   bool isCacheAcrossSnapshots() const;
@@ -17,10 +17,15 @@
 
 #include "context/dynamic_context.h"
 
+#include "types/typeops.h"
+
 #include "runtime/visitors/planiter_visitor.h"
 #include "runtime/booleans/BooleanImpl.h"
 #include "runtime/core/gflwor/common.h"
 
+#include "util/utf8_util.h"
+#include "zorbatypes/collation_manager.h"
+
 namespace zorba
 {
 
@@ -32,6 +37,41 @@ SERIALIZABLE_CLASS_VERSIONS(GroupingSpec)
 SERIALIZABLE_CLASS_VERSIONS(NonGroupingSpec)
 
 
+/*******************************************************************************
+
+********************************************************************************/
+bool getCollationKey(
+    const store::Item* item,
+    const XQPCollator* collator,
+    bool withUntyped,
+    zstring& key,
+    uint32_t* hash)
+{
+  key.clear();
+
+#ifndef ZORBA_NO_ICU
+  if (item == NULL || collator == NULL || collator->doMemCmp() ||
+      !item->isAtomic())
+    return false;
+
+  store::SchemaTypeCode typeCode = item->getTypeCode();
+
+  if (!TypeOps::is_subtype(typeCode, store::XS_STRING) &&
+      !(withUntyped && typeCode == store::XS_UNTYPED_ATOMIC))
+    return false;
+
+  uint32_t h = utf8::sort_key(item->getString(), collator, &key);
+
+  if (hash)
+    *hash = h;
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////
 //                                                                             //
 //  GroupingSpec                                                               //
@@ -160,6 +200,42 @@ void NonGroupingSpec::close(PlanState& planState)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//  GroupTuple                                                                 //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+void GroupTuple::computeCollationKeys(const std::vector<GroupingSpec>& specs)
+{
+  csize numSpecs = specs.size();
+  csize i;
+
+  for (i = 0; i < numSpecs; ++i)
+  {
+    if (specs[i].theCollator && !specs[i].theCollator->doMemCmp())
+      break;
+  }
+
+  if (i == numSpecs)
+    return;
+
+  theCollationKeys.resize(numSpecs);
+  theCollationKeyHashes.resize(numSpecs);
+
+  for (i = 0; i < numSpecs; ++i)
+  {
+    // untypedAtomic items are hashed without their collation, so they must
+    // keep being compared through it.
+    getCollationKey(theItems[i].getp(),
+                    specs[i].theCollator,
+                    false,
+                    theCollationKeys[i],
+                    &theCollationKeyHashes[i]);
+  }
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////
 //                                                                             //
 //  GroupTupleCmp                                                              //
@@ -189,9 +265,15 @@ uint32_t GroupTupleCmp::hash(GroupTuple* t) const
   std::vector<store::Item_t>::const_iterator end = t->theItems.end();
   std::vector<GroupingSpec>::const_iterator ite2 = theGroupingSpecs->begin();
 
-  for (; ite != end; ++ite, ++ite2)
+  bool haveKeys = !t->theCollationKeys.empty();
+
+  for (csize i = 0; ite != end; ++ite, ++ite2, ++i)
   {
-    if (*ite)
+    if (haveKeys && !t->theCollationKeys[i].empty())
+    {
+      hash += t->theCollationKeyHashes[i];
+    }
+    else if (*ite)
     {
       hash += (*ite)->hash(theTimezone, (*ite2).theCollator);
     }
@@ -210,12 +292,25 @@ bool GroupTupleCmp::equal(const GroupTuple* t1, const GroupTuple* t2) const
   std::vector<store::Item_t>::const_iterator iter2 = t2->theItems.begin();
   std::vector<GroupingSpec>::const_iterator iter3 = theGroupingSpecs->begin();
 
+  bool haveKeys = (!t1->theCollationKeys.empty() &&
+                   !t2->theCollationKeys.empty());
+  csize i = 0;
+
   while (iter1 != end1)
   {
     const store::Item* item1 = (*iter1).getp();
     const store::Item* item2 = (*iter2).getp();
 
-    if (item1 == NULL)
+    if (haveKeys &&
+        !t1->theCollationKeys[i].empty() &&
+        !t2->theCollationKeys[i].empty())
+    {
+      if (t1->theCollationKeys[i] != t2->theCollationKeys[i])
+      {
+        return false;
+      }
+    }
+    else if (item1 == NULL)
     {      
       if (item2 != NULL)
       {
@@ -271,6 +366,7 @@ bool GroupTupleCmp::equal(const GroupTuple* t1, const GroupTuple* t2) const
     ++iter3;
     ++iter1;
     ++iter2;
+    ++i;
   }
 
   return true;
@@ -28,6 +28,7 @@
 
 #include "store/api/store.h"
 #include "store/api/temp_seq.h"
+#include "store/api/memory_account.h"
 
 namespace zorba 
 {
@@ -202,11 +203,23 @@ public:
 
   theItems       : The values of the grouping variables in itg and otg.
   theTypedValues : The typed values of theItems.
+  theCollationKeys : The collation keys of theItems, computed once per input
+                     tuple so that hashing and comparing group tuples does not
+                     have to call the collator every time. It is empty unless
+                     some grouping spec has a non-codepoint collator. Else,
+                     theCollationKeys[i] is non-empty iff theItems[i] is a
+                     string whose grouping spec has such a collator.
+  theCollationKeyHashes : The hashes of the non-empty theCollationKeys.
 ********************************************************************************/
 class GroupTuple
 {
 public:
   std::vector<store::Item_t> theItems;
+  std::vector<zstring>       theCollationKeys;
+  std::vector<uint32_t>      theCollationKeyHashes;
+
+public:
+  void computeCollationKeys(const std::vector<GroupingSpec>& specs);
 };
 
 
@@ -258,6 +271,21 @@ inline bool empty_item(const store::Item* s)
 }
 
 
+/***************************************************************************//**
+  If the given item is a string (or, if withUntyped is true, an untypedAtomic)
+  and the collator is not a codepoint collator, put the ICU collation key of
+  the item's string value in key and return true. Otherwise, leave key empty
+  and return false. If hash is not NULL, it receives the same value as
+  item->hash(timezone, collator) does for strings.
+********************************************************************************/
+bool getCollationKey(
+    const store::Item* item,
+    const XQPCollator* collator,
+    bool withUntyped,
+    zstring& key,
+    uint32_t* hash = NULL);
+
+
 /////////////////////////////////////////////////////////////////////////////////
 //                                                                             //
 //  Standard Iterator Tasks                                                    //
@@ -429,7 +457,9 @@ inline void createTempSeq(
     const bool aLazyEval)
 {
   store::Iterator_t iterWrapper = new PlanIteratorWrapper(aInput, planState);
-  aTempSeqResult = GENV_STORE.createTempSeq(iterWrapper, aLazyEval);
+  aTempSeqResult = GENV_STORE.createTempSeq(aLazyEval);
+  aTempSeqResult->setMemoryAccount(planState.theMemoryAccount);
+  aTempSeqResult->init(iterWrapper);
 }
   
 
@@ -34,14 +34,31 @@ bool SortTupleCmp::operator()(const SortTuple& t1, const SortTuple& t2) const
 
   std::vector<OrderSpec>::const_iterator orderSpecIter = theOrderSpecs->begin();
 
+  bool haveKeys = (!t1.theCollationKeys.empty() &&
+                   !t2.theCollationKeys.empty());
+  csize i = 0;
+
   while (t1iter != t1end)
   {
-    long cmp = compare(*t1iter,
-                        *t2iter,
-                        orderSpecIter->theDescending,
-                        orderSpecIter->theEmptyLeast,
-                        orderSpecIter->theNativeCompare,
-                        orderSpecIter->theCollator);
+    long cmp;
+
+    if (haveKeys &&
+        !t1.theCollationKeys[i].empty() &&
+        !t2.theCollationKeys[i].empty())
+    {
+      cmp = descAsc(t1.theCollationKeys[i].compare(t2.theCollationKeys[i]),
+                    orderSpecIter->theDescending);
+    }
+    else
+    {
+      cmp = compare(*t1iter,
+                    *t2iter,
+                    orderSpecIter->theDescending,
+                    orderSpecIter->theEmptyLeast,
+                    orderSpecIter->theNativeCompare,
+                    orderSpecIter->theCollator);
+    }
+
     if (cmp > 0)
     {
       return false;
@@ -54,6 +71,7 @@ bool SortTupleCmp::operator()(const SortTuple& t1, const SortTuple& t2) const
     ++t1iter;
     ++t2iter;
     ++orderSpecIter;
+    ++i;
   }
   return false;
 }
@@ -91,6 +91,8 @@ void GroupByState::init(
 
   GroupTupleCmp cmp(loc, aState.theLocalDynCtx, tm, gspecs);
   theGroupMap = new GroupHashMap(cmp, 1024, false);
+
+  theMemory.attach(aState.theMemoryAccount);
 }
 
 
@@ -110,6 +112,8 @@ void GroupByState::reset(PlanState& aPlanState)
   }
 
   theGroupMap->clear();
+
+  theMemory.releaseAll();
 }
   
 
@@ -387,6 +391,8 @@ void GroupByIterator::matVarsAndGroupBy(
     theGroupingSpecs[i].theInput->reset(aPlanState);
   }
 
+  groupTuple->computeCollationKeys(theGroupingSpecs);
+
   GroupHashMap* groupMap = aGroupByState->theGroupMap;
 
   numVars = theNonGroupingSpecs.size();
@@ -417,13 +423,20 @@ void GroupByIterator::matVarsAndGroupBy(
       new PlanIteratorWrapper(theNonGroupingSpecs[i].theInput, aPlanState);
 
       // FIXME are those settings (no-copy and no-lazy) right? 
-      store::TempSeq_t tempSeq = GENV_STORE.createTempSeq(iterWrapper, false); 
+      store::TempSeq_t tempSeq = GENV_STORE.createTempSeq(false); 
+      tempSeq->setMemoryAccount(aPlanState.theMemoryAccount);
+      tempSeq->init(iterWrapper);
 
       nonGroupTuple->push_back(tempSeq);
 
       theNonGroupingSpecs[i].theInput->reset(aPlanState);
     }
 
+    aGroupByState->theMemory.charge(sizeof(GroupTuple));
+
+    for (csize i = 0; i < groupTupleItems.size(); ++i)
+      aGroupByState->theMemory.charge(groupTupleItems[i].getp());
+
     groupMap->insert(groupTuple.get(), nonGroupTuple);
     groupTuple.release();
   }
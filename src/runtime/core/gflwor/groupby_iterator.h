@@ -33,7 +33,9 @@ class GroupByIterator;
   
 
 /***************************************************************************//**
-
+  theMemory : The memory of the group tuples in theGroupMap, as charged to the
+              memory account of the query (if any). The temp seqs of the
+              non-grouping vars charge their own memory.
 ********************************************************************************/
 class GroupByState : public PlanIteratorState 
 {
@@ -42,6 +44,7 @@ class GroupByState : public PlanIteratorState
 protected:
   GroupHashMap           * theGroupMap;
   GroupHashMap::iterator   theGroupMapIter;
+  store::MemoryCharge      theMemory;
        
 public:
   GroupByState();
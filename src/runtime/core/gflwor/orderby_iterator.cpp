@@ -34,6 +34,8 @@
 #include "runtime/core/gflwor/common.h"
 #include "runtime/core/gflwor/comp_function.h"
 
+#include "zorbatypes/collation_manager.h"
+
 #include <vector>
 #include <algorithm>
 
@@ -116,6 +118,38 @@ void OrderSpec::close(PlanState& aPlanState) const
 
 
 
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//  SortTuple                                                                  //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+void SortTuple::computeCollationKeys(const std::vector<OrderSpec>& specs)
+{
+  csize numSpecs = specs.size();
+  csize i;
+
+  for (i = 0; i < numSpecs; ++i)
+  {
+    if (specs[i].theCollator && !specs[i].theCollator->doMemCmp())
+      break;
+  }
+
+  if (i == numSpecs)
+    return;
+
+  theCollationKeys.resize(numSpecs);
+
+  for (i = 0; i < numSpecs; ++i)
+  {
+    getCollationKey(theKeyValues[i],
+                    specs[i].theCollator,
+                    true,
+                    theCollationKeys[i]);
+  }
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////
 //                                                                             //
 //  OrderByState                                                               //
@@ -143,6 +177,8 @@ void OrderByState::init(PlanState& planState, std::vector<OrderSpec>* orderSpecs
 
   theNumTuples = 0;
   theCurTuplePos = 0;
+
+  theMemory.attach(planState.theMemoryAccount);
 }
 
 
@@ -154,6 +190,8 @@ void OrderByState::reset(PlanState& planState)
   theDataTable.clear();
   theNumTuples = 0;
   theCurTuplePos = 0;
+
+  theMemory.releaseAll();
 }
 
 
@@ -388,6 +426,8 @@ void OrderByIterator::materializeResultForSort(
   sortTable.resize(numTuples + 1);
   dataTable.resize(numTuples + 1);
 
+  iterState->theMemory.charge(sizeof(SortTuple) + sizeof(StreamTuple));
+
   // Create the sort tuple
 
   csize numSpecs = theOrderSpecs.size();
@@ -400,6 +440,7 @@ void OrderByIterator::materializeResultForSort(
     store::Item_t sortKeyItem;
     if (consumeNext(sortKeyItem, theOrderSpecs[i].theDomainIter, planState)) 
     {
+      iterState->theMemory.charge(sortKeyItem.getp());
       sortKey[i] = sortKeyItem.release();
 
       store::Item_t temp;
@@ -416,6 +457,8 @@ void OrderByIterator::materializeResultForSort(
 
     theOrderSpecs[i].theDomainIter->reset(planState);
   }
+
+  sortTable[numTuples].computeCollationKeys(theOrderSpecs);
   
   sortTable[numTuples].theDataPos = numTuples;
 
@@ -433,6 +476,7 @@ void OrderByIterator::materializeResultForSort(
     store::Item_t forItem;
     consumeNext(forItem, theInputForVars[i], planState);
 
+    iterState->theMemory.charge(forItem.getp());
     streamTuple.theItems[i].transfer(forItem);
 
     theInputForVars[i]->reset(planState);
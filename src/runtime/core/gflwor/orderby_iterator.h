@@ -111,20 +111,31 @@ public:
   For a simple flwor, the T data is an iterator I over a temp sequence that
   stores the result of the return clause computed for the current input-
   stream tuple.
+
+  theCollationKeys stores the ICU collation keys of the string key values whose
+  orderby column has a non-codepoint collator, so that sorting compares raw
+  bytes instead of calling the collator O(n log n) times. It is empty if no
+  column has such a collator.
+
+  Note: SortTuple has no user-declared destructor so that std::sort can move,
+  rather than copy, the tuples.
 ********************************************************************************/
 class SortTuple
 {
 public:
   std::vector<store::Item*>   theKeyValues;
+  std::vector<zstring>        theCollationKeys;
   ulong                       theDataPos;
 
 public:
   SortTuple() { }
 
-  ~SortTuple() { }
+  void computeCollationKeys(const std::vector<OrderSpec>& specs);
 
   void clear()
   {
+    theCollationKeys.clear();
+
     csize numColumns = theKeyValues.size();
     for (csize i = 0; i < numColumns; ++i)
     {
@@ -147,6 +158,8 @@ public:
   theCurTuplePos : A position inside theOrderMap. Used to return individual flwor
                    results after the full result set has been materialized and
                    sorted. 
+  theMemory      : The memory of the materialized tuples, as charged to the
+                   memory account of the query (if any).
 ********************************************************************************/
 class OrderByState : public PlanIteratorState 
 {
@@ -162,6 +175,8 @@ protected:
   ulong        theNumTuples;
   ulong        theCurTuplePos;
 
+  store::MemoryCharge theMemory;
+
 public:
   OrderByState();
 
@@ -845,7 +845,9 @@ bool WindowIterator::nextImpl(store::Item_t& aResult, PlanState& planState) cons
     // Create the temp sequence where to materialize the result of the domain
     // expr (lazily if theLazyEval flag is true).
     iterator = new PlanIteratorWrapper(theInputIter, planState);
-    state->theDomainSeq = GENV_STORE.createTempSeq(iterator, theLazyEval);
+    state->theDomainSeq = GENV_STORE.createTempSeq(theLazyEval);
+    state->theDomainSeq->setMemoryAccount(planState.theMemoryAccount);
+    state->theDomainSeq->init(iterator);
 
     // Its clever to switch quite early to avoid a lot of if-else statements
     if (theWindowType == WindowIterator::SLIDING)
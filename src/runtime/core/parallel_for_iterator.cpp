@@ -0,0 +1,578 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "stdafx.h"
+
+#include <thread>
+
+#include <zorba/properties.h>
+
+#include "diagnostics/assert.h"
+#include "diagnostics/zorba_exception.h"
+
+#include "runtime/core/parallel_for_iterator.h"
+#include "runtime/core/var_iterators.h"
+#include "runtime/visitors/planiter_visitor.h"
+
+#include "store/api/item_factory.h"
+
+#include "system/globalenv.h"
+
+
+namespace zorba
+{
+
+namespace flwor
+{
+
+SERIALIZABLE_CLASS_VERSIONS(ParallelForIterator)
+
+
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//  ParallelForState                                                           //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+ParallelForState::ParallelForState()
+  :
+  theNumThreads(1),
+  thePosition(0),
+  theDomainDone(false),
+  theNextItem(0),
+  theStopAt(0),
+  theCurItem(0),
+  theCurResult(0)
+{
+}
+
+
+ParallelForState::~ParallelForState()
+{
+  assert(theWorkerStates.empty());
+}
+
+
+void ParallelForState::init(PlanState& planState)
+{
+  PlanIteratorState::init(planState);
+  thePosition = 0;
+  theDomainDone = false;
+  clearBatch();
+}
+
+
+void ParallelForState::reset(PlanState& planState)
+{
+  PlanIteratorState::reset(planState);
+  thePosition = 0;
+  theDomainDone = false;
+  clearBatch();
+}
+
+
+void ParallelForState::clearBatch()
+{
+  theBatch.clear();
+  theResults.clear();
+  theErrors.clear();
+  theNextItem = 0;
+  theStopAt = 0;
+  theCurItem = 0;
+  theCurResult = 0;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//  ParallelForIterator                                                        //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************************
+
+********************************************************************************/
+ParallelForIterator::ParallelForIterator(
+    static_context* sctx,
+    const QueryLoc& loc,
+    ForLetClause& forClause,
+    PlanIter_t& whereClause,
+    PlanIter_t& returnClause,
+    csize numThreads)
+  :
+  PlanIterator(sctx, loc),
+  theForClause(forClause),
+  theWhereClause(whereClause),
+  theReturnClause(returnClause),
+  theNumThreads(numThreads),
+  theReturnOffset(0),
+  theWhereOffset(0)
+{
+  assert(theForClause.theType == ForLetClause::FOR);
+}
+
+
+ParallelForIterator::~ParallelForIterator()
+{
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void ParallelForIterator::serialize(::zorba::serialization::Archiver& ar)
+{
+  serialize_baseclass(ar, (PlanIterator*)this);
+  ar & theForClause;
+  ar & theWhereClause; // can be null
+  ar & theReturnClause;
+  ar & theNumThreads;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void ParallelForIterator::openImpl(PlanState& planState, uint32_t& offset)
+{
+  StateTraitsImpl<ParallelForState>::createState(planState, theStateOffset, offset);
+
+  ParallelForState* state =
+  StateTraitsImpl<ParallelForState>::getState(planState, theStateOffset);
+
+  state->init(planState);
+
+  theForClause.theInput->open(planState, offset);
+
+  theReturnOffset = offset;
+  theReturnClause->open(planState, offset);
+
+  if (theWhereClause != NULL)
+  {
+    theWhereOffset = offset;
+    theWhereClause->open(planState, offset);
+  }
+
+  csize numThreads = theNumThreads;
+
+  if (numThreads == 0)
+    numThreads = Properties::instance().getParallelFlworThreads();
+
+  if (numThreads == 0)
+    numThreads = std::thread::hardware_concurrency();
+
+#ifdef ZORBA_FOR_ONE_THREAD_ONLY
+  numThreads = 1;
+#endif
+
+  state->theNumThreads = (numThreads == 0 ? 1 : numThreads);
+
+  if (state->theNumThreads == 1)
+    return;
+
+  // Open the where and return clauses once more in each worker's PlanState.
+  // Their states are placed at the same offsets as in the main PlanState, so
+  // the iterators of these clauses find them there.
+  for (csize i = 0; i < state->theNumThreads; ++i)
+  {
+    PlanState* workerState = new PlanState(planState.theGlobalDynCtx,
+                                           planState.theLocalDynCtx,
+                                           planState.theBlockSize,
+                                           planState.theStackDepth,
+                                           planState.theMaxStackDepth);
+
+    workerState->theCompilerCB = planState.theCompilerCB;
+#ifdef ZORBA_WITH_DEBUGGER
+    workerState->theDebuggerCommons = planState.theDebuggerCommons;
+#endif
+    workerState->theQuery = planState.theQuery;
+    // The memory account is not shared: it is not thread-safe (see the doc of
+    // ParallelForIterator), so theMemoryAccount stays NULL.
+
+    state->theWorkerStates.push_back(workerState);
+
+    uint32_t workerOffset = theReturnOffset;
+    theReturnClause->open(*workerState, workerOffset);
+
+    if (theWhereClause != NULL)
+    {
+      workerOffset = theWhereOffset;
+      theWhereClause->open(*workerState, workerOffset);
+    }
+  }
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+bool ParallelForIterator::nextImpl(
+    store::Item_t& result,
+    PlanState& planState) const
+{
+  store::Item_t item;
+
+  ParallelForState* state;
+  DEFAULT_STACK_INIT(ParallelForState, state, planState);
+
+  if (state->theNumThreads == 1)
+  {
+    while (consumeNext(item, theForClause.theInput, planState))
+    {
+      ++state->thePosition;
+
+      bindVariables(item, state->thePosition, planState);
+
+      if (theWhereClause != NULL && !evalToBool(planState))
+        continue;
+
+      while (consumeNext(result, theReturnClause, planState))
+      {
+        STACK_PUSH(true, state);
+      }
+
+      theReturnClause->reset(planState);
+    }
+  }
+  else
+  {
+    while (fillBatch(state, planState))
+    {
+      evalBatch(state);
+
+      for (state->theCurItem = 0;
+           state->theCurItem < state->theBatch.size();
+           ++state->theCurItem)
+      {
+        for (state->theCurResult = 0;
+             state->theCurResult < state->theResults[state->theCurItem].size();
+             ++state->theCurResult)
+        {
+          result.transfer(
+          state->theResults[state->theCurItem][state->theCurResult]);
+
+          STACK_PUSH(true, state);
+        }
+      }
+    }
+  }
+
+  STACK_END(state);
+}
+
+
+/*******************************************************************************
+  Consume the next batch of domain items. Return false if the domain is
+  exhausted.
+********************************************************************************/
+bool ParallelForIterator::fillBatch(
+    ParallelForState* state,
+    PlanState& planState) const
+{
+  state->clearBatch();
+
+  if (state->theDomainDone)
+    return false;
+
+  csize batchSize = BATCH_ITEMS_PER_THREAD * state->theNumThreads;
+  store::Item_t item;
+
+  while (state->theBatch.size() < batchSize)
+  {
+    if (!consumeNext(item, theForClause.theInput, planState))
+    {
+      state->theDomainDone = true;
+      break;
+    }
+
+    state->theBatch.push_back(item);
+  }
+
+  csize numItems = state->theBatch.size();
+
+  state->theResults.resize(numItems);
+  state->theErrors.resize(numItems);
+  state->theStopAt = numItems;
+
+  return numItems > 0;
+}
+
+
+/*******************************************************************************
+  Evaluate the where and return clauses for all the items of the current
+  batch, and rethrow the error of the first item that failed, if any.
+********************************************************************************/
+void ParallelForIterator::evalBatch(ParallelForState* state) const
+{
+  csize numThreads = state->theNumThreads;
+
+  if (numThreads > state->theBatch.size())
+    numThreads = state->theBatch.size();
+
+  std::vector<std::unique_ptr<Worker> > workers(numThreads);
+
+  for (csize i = 0; i < numThreads; ++i)
+  {
+    workers[i].reset(new Worker(*this, state, *state->theWorkerStates[i]));
+    workers[i]->start();
+  }
+
+  for (csize i = 0; i < numThreads; ++i)
+    workers[i]->join();
+
+  if (state->theStopAt < state->theBatch.size())
+    std::rethrow_exception(state->theErrors[state->theStopAt]);
+
+  state->thePosition += state->theBatch.size();
+}
+
+
+/*******************************************************************************
+  Set pos to the position of the next item of the batch to be evaluated.
+  Return false if there are no more items or an item before it has failed.
+********************************************************************************/
+bool ParallelForIterator::claimItem(ParallelForState* state, csize& pos) const
+{
+  SYNC_CODE(AutoMutex lock(&state->theMutex);)
+
+  if (state->theNextItem >= state->theStopAt)
+    return false;
+
+  pos = state->theNextItem++;
+  return true;
+}
+
+
+/*******************************************************************************
+  Called by a worker to evaluate the where and return clauses for the item at
+  the given position of the current batch, in the worker's PlanState.
+********************************************************************************/
+void ParallelForIterator::evalItem(
+    ParallelForState* state,
+    csize pos,
+    PlanState& planState) const
+{
+  std::vector<store::Item_t>& results = state->theResults[pos];
+
+  try
+  {
+    bindVariables(state->theBatch[pos],
+                  state->thePosition + pos + 1,
+                  planState);
+
+    if (theWhereClause != NULL && !evalToBool(planState))
+      return;
+
+    store::Item_t item;
+    while (consumeNext(item, theReturnClause, planState))
+      results.push_back(item);
+
+    theReturnClause->reset(planState);
+  }
+  catch (...)
+  {
+    // Nothing may escape the worker thread (that would terminate the process),
+    // so the exception, whatever it is, is rethrown by evalBatch().
+    SYNC_CODE(AutoMutex lock(&state->theMutex);)
+
+    state->theErrors[pos] = std::current_exception();
+
+    if (pos < state->theStopAt)
+      state->theStopAt = pos;
+  }
+
+  // Leave the clauses ready for the next item, in case the error is caught
+  // and the FLWOR is evaluated again.
+  if (state->theErrors[pos])
+  {
+    try
+    {
+      theReturnClause->reset(planState);
+
+      if (theWhereClause != NULL)
+        theWhereClause->reset(planState);
+    }
+    catch (...)
+    {
+    }
+  }
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void ParallelForIterator::Worker::run()
+{
+  csize pos;
+
+  while (theIterator.claimItem(theState, pos))
+    theIterator.evalItem(theState, pos, thePlanState);
+}
+
+
+/*******************************************************************************
+  Bind the given domain item and its position to all the references of the FOR
+  and positional vars.
+********************************************************************************/
+void ParallelForIterator::bindVariables(
+    store::Item_t& item,
+    csize pos,
+    PlanState& planState) const
+{
+  std::vector<PlanIter_t>::const_iterator ite = theForClause.theVarRefs.begin();
+  std::vector<PlanIter_t>::const_iterator end = theForClause.theVarRefs.end();
+  for (; ite != end; ++ite)
+  {
+    static_cast<ForVarIterator*>((*ite).getp())->bind(item.getp(), planState);
+  }
+
+  if (!theForClause.thePosVarRefs.empty())
+  {
+    store::Item_t posItem;
+    GENV_ITEMFACTORY->createInteger(posItem, xs_integer(pos));
+
+    ite = theForClause.thePosVarRefs.begin();
+    end = theForClause.thePosVarRefs.end();
+    for (; ite != end; ++ite)
+    {
+      static_cast<ForVarIterator*>((*ite).getp())->bind(posItem.getp(), planState);
+    }
+  }
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+bool ParallelForIterator::evalToBool(PlanState& planState) const
+{
+  store::Item_t boolValue;
+  if (!consumeNext(boolValue, theWhereClause.getp(), planState))
+  {
+    theWhereClause->reset(planState);
+    return false;
+  }
+
+  bool value = boolValue->getBooleanValue();
+  theWhereClause->reset(planState);
+  return value;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void ParallelForIterator::resetImpl(PlanState& planState) const
+{
+  theReturnClause->reset(planState);
+
+  if (theWhereClause != NULL)
+    theWhereClause->reset(planState);
+
+  theForClause.theInput->reset(planState);
+
+  StateTraitsImpl<ParallelForState>::reset(planState, theStateOffset);
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void ParallelForIterator::closeImpl(PlanState& planState)
+{
+  ParallelForState* state =
+  StateTraitsImpl<ParallelForState>::getState(planState, theStateOffset);
+
+  std::vector<PlanState*>::const_iterator ite = state->theWorkerStates.begin();
+  std::vector<PlanState*>::const_iterator end = state->theWorkerStates.end();
+  for (; ite != end; ++ite)
+  {
+    theReturnClause->close(**ite);
+
+    if (theWhereClause != NULL)
+      theWhereClause->close(**ite);
+
+    delete *ite;
+  }
+
+  state->theWorkerStates.clear();
+  state->clearBatch();
+
+  theReturnClause->close(planState);
+
+  if (theWhereClause != NULL)
+    theWhereClause->close(planState);
+
+  theForClause.theInput->close(planState);
+
+  StateTraitsImpl<ParallelForState>::destroyState(planState, theStateOffset);
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+zstring ParallelForIterator::getNameAsString() const
+{
+  return "ParallelForIterator";
+}
+
+
+uint32_t ParallelForIterator::getStateSize() const
+{
+  return sizeof(ParallelForState);
+}
+
+
+uint32_t ParallelForIterator::getStateSizeOfSubtree() const
+{
+  uint32_t size = getStateSize();
+
+  size += theForClause.theInput->getStateSizeOfSubtree();
+
+  size += theReturnClause->getStateSizeOfSubtree();
+
+  if (theWhereClause != NULL)
+    size += theWhereClause->getStateSizeOfSubtree();
+
+  return size;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void ParallelForIterator::accept(PlanIterVisitor& v) const
+{
+  if (!v.hasToVisit(this))
+    return;
+
+  v.beginVisit(*this);
+
+  theForClause.accept(v);
+
+  if (theWhereClause != NULL)
+    v.visitFlworWhereClause(*theWhereClause);
+
+  v.visitFlworReturn(*theReturnClause);
+
+  v.endVisit(*this);
+}
+
+
+} // namespace flwor
+} // namespace zorba
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,242 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef ZORBA_RUNTIME_PARALLEL_FOR_ITERATOR
+#define ZORBA_RUNTIME_PARALLEL_FOR_ITERATOR
+
+#include <exception>
+#include <memory>
+#include <vector>
+
+#include <zorba/zorba_exception.h>
+
+#include "common/common.h"
+#include "common/shared_types.h"
+
+#include "runtime/base/plan_iterator.h"
+#include "runtime/core/flwor_iterator.h"
+
+#include "zorbautils/mutex.h"
+#include "zorbautils/runnable.h"
+
+
+namespace zorba
+{
+
+namespace flwor
+{
+
+/***************************************************************************//**
+  State of a ParallelForIterator.
+
+  theNumThreads  : The number of threads actually used (at least 1). With one
+                   thread, the iterator streams like an ordinary FLWOR.
+  theWorkerStates: One PlanState per worker thread. The where and return
+                   clauses are opened in each of them at the same offsets as
+                   in the main PlanState, so each worker has its own copy of
+                   the states of these clauses (including the ForVarIterators
+                   that reference the FOR and positional vars).
+  thePosition    : Number of domain items consumed so far.
+  theBatch       : The domain items of the current batch.
+  theResults     : theResults[i] is the result of the return clause for the
+                   i-th item of the current batch.
+  theErrors      : theErrors[i] is the exception thrown while evaluating the
+                   i-th item of the current batch, if any. Any exception is
+                   caught on the worker thread and rethrown on the calling
+                   thread, be it a ZorbaException or e.g. std::bad_alloc.
+  theNextItem    : Position in theBatch of the next item to be claimed by a
+                   worker.
+  theStopAt      : Position in theBatch of the first item that failed, or the
+                   size of theBatch.
+  theCurItem     : Position in theBatch of the item whose results are being
+                   returned.
+  theCurResult   : Position in theResults[theCurItem] of the next result to be
+                   returned.
+********************************************************************************/
+class ParallelForState : public PlanIteratorState
+{
+public:
+  csize                                          theNumThreads;
+  std::vector<PlanState*>                        theWorkerStates;
+
+  csize                                          thePosition;
+  bool                                           theDomainDone;
+
+  std::vector<store::Item_t>                     theBatch;
+  std::vector<std::vector<store::Item_t> >       theResults;
+  std::vector<std::exception_ptr>                theErrors;
+
+  SYNC_CODE(Mutex                                theMutex;)
+  csize                                          theNextItem;
+  csize                                          theStopAt;
+
+  csize                                          theCurItem;
+  csize                                          theCurResult;
+
+public:
+  ParallelForState();
+
+  ~ParallelForState();
+
+  void init(PlanState& planState);
+
+  void reset(PlanState& planState);
+
+  void clearBatch();
+};
+
+
+/***************************************************************************//**
+  Evaluates a FLWOR expr of the form
+
+    for $x at $pos in domain_expr
+    where where_expr
+    return return_expr
+
+  (with optional positional var and where clause) by evaluating the where and
+  return clauses of several FOR iterations concurrently.
+
+  The domain is consumed on the calling thread, in batches of
+  BATCH_ITEMS_PER_THREAD items per thread. The items of a batch are then
+  claimed, in order, by a pool of worker threads. Each worker binds the FOR
+  and positional vars in its own PlanState and materializes the result of the
+  return clause for that item. Once the whole batch is evaluated, the results
+  are returned in the order of the domain, so the result is the same as the
+  one of the sequential FLWOR. If the evaluation of some items raises an
+  error, the error of the first such item is rethrown.
+
+  The PlanStates of the workers have no memory account (see PlanState), since
+  store::MemoryAccount is not thread-safe. So the runtime buffers built by the
+  where and return clauses of a parallel FLWOR are neither counted in the
+  memory audit of the query nor checked against its memory limit. Buffers
+  built on the calling thread, e.g. by the consumers of the results, are.
+
+  The codegen creates this iterator only for FLWORs marked with the
+  (# ext:parallel [n] #) pragma whose where and return clauses reference no
+  variables other than the FOR and positional vars and prolog vars (see
+  plan_visitor.cpp). The pragma asserts that the iterations are independent,
+  i.e., they do not rely on node identity across iterations, side effects, or
+  the order in which they are evaluated.
+
+  theNumThreads  : The number of threads given in the pragma, or 0 to use the
+                   ParallelFlworThreads property (if that is 0 too, one thread
+                   per hardware thread is used).
+  theReturnOffset: The offset of the states of the return clause in the
+                   PlanState (set in openImpl).
+  theWhereOffset : The offset of the states of the where clause in the
+                   PlanState (set in openImpl).
+********************************************************************************/
+class ParallelForIterator : public PlanIterator
+{
+public:
+  static const csize BATCH_ITEMS_PER_THREAD = 256;
+
+protected:
+  class Worker : public Runnable
+  {
+  protected:
+    const ParallelForIterator  & theIterator;
+    ParallelForState           * theState;
+    PlanState                  & thePlanState;
+
+  public:
+    Worker(
+        const ParallelForIterator& iter,
+        ParallelForState* state,
+        PlanState& planState)
+      :
+      theIterator(iter),
+      theState(state),
+      thePlanState(planState)
+    {
+    }
+
+    ~Worker() {}
+
+  protected:
+    void run();
+
+    void finish() {}
+  };
+
+private:
+  ForLetClause              theForClause;
+  PlanIter_t                theWhereClause;
+  PlanIter_t                theReturnClause;
+  csize                     theNumThreads;
+
+  uint32_t                  theReturnOffset;
+  uint32_t                  theWhereOffset;
+
+public:
+  SERIALIZABLE_CLASS(ParallelForIterator);
+  SERIALIZABLE_CLASS_CONSTRUCTOR2(ParallelForIterator, PlanIterator);
+  void serialize(::zorba::serialization::Archiver& ar);
+
+public:
+  ParallelForIterator(
+      static_context*  sctx,
+      const QueryLoc&  loc,
+      ForLetClause&    forClause,
+      PlanIter_t&      whereClause,
+      PlanIter_t&      returnClause,
+      csize            numThreads);
+
+  ~ParallelForIterator();
+
+  csize getNumThreads() const { return theNumThreads; }
+
+  void openImpl(PlanState& planState, uint32_t& offset);
+  bool nextImpl(store::Item_t& result, PlanState& planState) const;
+  void resetImpl(PlanState& planState) const;
+  void closeImpl(PlanState& planState);
+
+  zstring getNameAsString() const;
+
+  uint32_t getStateSize() const;
+
+  uint32_t getStateSizeOfSubtree() const;
+
+  void accept(PlanIterVisitor&) const;
+
+private:
+  void bindVariables(
+      store::Item_t& item,
+      csize pos,
+      PlanState& planState) const;
+
+  bool evalToBool(PlanState& planState) const;
+
+  bool fillBatch(ParallelForState* state, PlanState& planState) const;
+
+  void evalBatch(ParallelForState* state) const;
+
+  bool claimItem(ParallelForState* state, csize& pos) const;
+
+  void evalItem(ParallelForState* state, csize pos, PlanState& planState) const;
+};
+
+
+}
+} /* namespace zorba */
+#endif
+
+/*
+ * Local variables:
+ * mode: c++
+ * End:
+ */
+/* vim:set et sw=2 ts=2: */
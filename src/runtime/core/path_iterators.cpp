@@ -31,6 +31,7 @@
 #include "store/api/item.h"
 #include "store/api/iterator.h"
 #include "store/api/iterator_factory.h"
+#include "store/api/store.h"
 
 
 #define MYTRACE(msg) \
@@ -141,6 +142,8 @@ SERIALIZABLE_CLASS_VERSIONS(PrecedingReverseAxisIterator)
 
 SERIALIZABLE_CLASS_VERSIONS(FollowingAxisIterator)
 
+SERIALIZABLE_CLASS_VERSIONS(TwigPathIterator)
+
 
 UNARY_ACCEPT(SelfAxisIterator);
 DEF_GET_NAME_AS_STRING(SelfAxisIterator)
@@ -190,6 +193,9 @@ DEF_GET_NAME_AS_STRING(PrecedingReverseAxisIterator)
 UNARY_ACCEPT(FollowingAxisIterator);
 DEF_GET_NAME_AS_STRING(FollowingAxisIterator)
 
+UNARY_ACCEPT(TwigPathIterator);
+DEF_GET_NAME_AS_STRING(TwigPathIterator)
+
 
 
 static inline bool isElementOrDocumentNode(const store::Item* node)
@@ -1253,6 +1259,8 @@ void DescendantAxisIterator::serialize(::zorba::serialization::Archiver& ar)
   (UnaryBaseIterator<DescendantAxisIterator, DescendantAxisState>*)this);
 
   AxisIteratorHelper::serialize(ar);
+
+  ar & theUseDataGuide;
 }
 
 
@@ -1280,6 +1288,10 @@ bool DescendantAxisIterator::nextImpl(store::Item_t& result, PlanState& planStat
     }
     while (!isElementOrDocumentNode(state->theContextNode.getp()));
 
+    if (theUseDataGuide &&
+        !GENV_STORE.mayHaveDescendant(state->theContextNode.getp(), theQName.getp()))
+      continue;
+
     state->theCurrentPos = 0;
 
     state->push(state->theContextNode);
@@ -2004,5 +2016,101 @@ bool FollowingAxisIterator::nextImpl(
 }
 
 
+
+/*******************************************************************************
+
+********************************************************************************/
+void TwigPathState::init(PlanState& planState)
+{
+  PlanIteratorState::init(planState);
+
+  theTwigJoin = GENV_ITERATOR_FACTORY->createTwigJoinIterator();
+}
+
+
+void TwigPathState::reset(PlanState& planState)
+{
+  PlanIteratorState::reset(planState);
+
+  if (theTwigJoin != NULL)
+    theTwigJoin->close();
+}
+
+
+void TwigPathIterator::serialize(::zorba::serialization::Archiver& ar)
+{
+  serialize_baseclass(ar,
+  (UnaryBaseIterator<TwigPathIterator, TwigPathState>*)this);
+
+  ar & theNames;
+
+  // std::vector<bool> does not hand out bool references.
+  csize numSteps = theNames.size();
+
+  if (!ar.is_serializing_out())
+    theDescendantSteps.resize(numSteps);
+
+  for (csize i = 0; i < numSteps; ++i)
+  {
+    bool isDescendant = theDescendantSteps[i];
+    ar & isDescendant;
+    theDescendantSteps[i] = isDescendant;
+  }
+}
+
+
+zstring TwigPathIterator::getPattern() const
+{
+  zstring pattern;
+
+  csize numSteps = theNames.size();
+
+  for (csize i = 0; i < numSteps; ++i)
+  {
+    pattern += (theDescendantSteps[i] ? "//" : "/");
+    theNames[i]->appendStringValue(pattern);
+  }
+
+  return pattern;
+}
+
+
+bool TwigPathIterator::nextImpl(store::Item_t& result, PlanState& planState) const
+{
+  TwigPathState* state;
+  DEFAULT_STACK_INIT(TwigPathState, state, planState);
+
+  while (true)
+  {
+    do
+    {
+      if (!consumeNext(state->theContextNode, theChild.getp(), planState))
+        goto done;
+
+      if (!state->theContextNode->isNode())
+      {
+        throw XQUERY_EXCEPTION(err::XPTY0020, ERROR_LOC(loc));
+      }
+    }
+    while (!isElementOrDocumentNode(state->theContextNode.getp()));
+
+    state->theTwigJoin->init(state->theContextNode.getp(),
+                             theNames,
+                             theDescendantSteps);
+    state->theTwigJoin->open();
+
+    while (state->theTwigJoin->next(result))
+    {
+      STACK_PUSH(true, state);
+    }
+
+    state->theTwigJoin->close();
+  }
+
+ done:
+  STACK_END(state);
+}
+
+
 };
 /* vim:set et sw=2 ts=2: */
@@ -43,6 +43,7 @@ namespace store
   class ChildrenIterator;
   class ChildrenReverseIterator;
   class AttributesIterator;
+  class TwigJoinIterator;
 }
 
 
@@ -672,10 +673,18 @@ public:
 };
 
 
+/*******************************************************************************
+  theUseDataGuide : If true, the context nodes whose data guide shows that they
+                    have no descendant element with theQName are skipped without
+                    traversing their subtrees (see axis_step_expr).
+********************************************************************************/
 class DescendantAxisIterator : public UnaryBaseIterator<DescendantAxisIterator,
                                                         DescendantAxisState>,
                                public AxisIteratorHelper
 {
+protected:
+  bool theUseDataGuide;
+
 public:
   SERIALIZABLE_CLASS(DescendantAxisIterator);
   SERIALIZABLE_CLASS_CONSTRUCTOR2T(
@@ -687,9 +696,11 @@ public:
   DescendantAxisIterator(
         static_context* sctx,
         const QueryLoc& loc,
-        PlanIter_t input)
+        PlanIter_t input,
+        bool useDataGuide = false)
     :
-    UnaryBaseIterator<DescendantAxisIterator, DescendantAxisState>(sctx, loc, input)
+    UnaryBaseIterator<DescendantAxisIterator, DescendantAxisState>(sctx, loc, input),
+    theUseDataGuide(useDataGuide)
   {
   }
 
@@ -939,6 +950,74 @@ public:
 };
 
 
+/*******************************************************************************
+  Evaluates a path expression like $input//a/b//c, whose steps are all element
+  name tests (without wildcards) on the child or descendant axis, with at least
+  one descendant step. Instead of evaluating each step over the result of the
+  previous one, the whole pattern is evaluated at once under each context node
+  by a store::TwigJoinIterator, which returns the matching nodes in document
+  order and without duplicates.
+
+  theNames           : The element names of the steps.
+  theDescendantSteps : Whether each step uses the descendant (rather than the
+                       child) axis.
+********************************************************************************/
+class TwigPathState : public PlanIteratorState
+{
+public:
+  store::Item_t                     theContextNode;
+  rchandle<store::TwigJoinIterator> theTwigJoin;
+
+public:
+  TwigPathState() {}
+
+  ~TwigPathState() {}
+
+  void init(PlanState&);
+
+  void reset(PlanState&);
+};
+
+
+class TwigPathIterator : public UnaryBaseIterator<TwigPathIterator, TwigPathState>
+{
+protected:
+  std::vector<store::Item_t> theNames;
+  std::vector<bool>          theDescendantSteps;
+
+public:
+  SERIALIZABLE_CLASS(TwigPathIterator);
+  SERIALIZABLE_CLASS_CONSTRUCTOR2T(
+  TwigPathIterator,
+  UnaryBaseIterator<TwigPathIterator, TwigPathState>);
+  void serialize(::zorba::serialization::Archiver& ar);
+
+public:
+  TwigPathIterator(
+      static_context* sctx,
+      const QueryLoc& loc,
+      PlanIter_t input,
+      const std::vector<store::Item_t>& names,
+      const std::vector<bool>& descendantSteps)
+    :
+    UnaryBaseIterator<TwigPathIterator, TwigPathState>(sctx, loc, input),
+    theNames(names),
+    theDescendantSteps(descendantSteps)
+  {
+  }
+
+  ~TwigPathIterator() {}
+
+  zstring getPattern() const;
+
+  void accept(PlanIterVisitor& v) const;
+
+  zstring getNameAsString() const;
+
+  bool nextImpl(store::Item_t& result, PlanState& planState) const;
+};
+
+
 } /* namespace zorba */
 
 #endif  /* ZORBA_PATH_ITERATORS_H */
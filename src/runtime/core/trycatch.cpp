@@ -693,7 +693,9 @@ TryCatchIterator::nextImpl(store::Item_t& result, PlanState& planState) const
   try
   {
     lIterator = new PlanIteratorWrapper(theChild, planState);
-    state->theTargetSequence = GENV_STORE.createTempSeq(lIterator, false);
+    state->theTargetSequence = GENV_STORE.createTempSeq(false);
+    state->theTargetSequence->setMemoryAccount(planState.theMemoryAccount);
+    state->theTargetSequence->init(lIterator);
     state->theTempIterator = state->theTargetSequence->getIterator();
     state->theTempIterator->open();
   }
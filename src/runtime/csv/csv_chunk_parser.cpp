@@ -0,0 +1,418 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stdafx.h"
+
+// standard
+#include <algorithm>
+#include <thread>
+
+// Zorba
+#include <zorba/diagnostic_list.h>
+#include "diagnostics/dict.h"
+#include "diagnostics/xquery_diagnostics.h"
+#include "store/api/item_factory.h"
+#include "system/globalenv.h"
+#include "util/ascii_util.h"
+#include "util/fs_util.h"
+#include "util/stl_util.h"
+
+// local
+#include "csv_chunk_parser.h"
+
+using namespace std;
+
+namespace zorba {
+
+///////////////////////////////////////////////////////////////////////////////
+
+csv_chunk_parser::csv_chunk_parser( csv_parser const &csv,
+                                    bool cast_unquoted,
+                                    zstring const &extra_name,
+                                    items_type const &keys,
+                                    missing::type missing,
+                                    QueryLoc const &loc ) :
+  csv_( csv ),
+  cast_unquoted_( cast_unquoted ),
+  extra_name_( extra_name ),
+  keys_( keys ),
+  missing_( missing ),
+  loc_( loc ),
+  num_threads_( thread::hardware_concurrency() ),
+  pos_( nullptr ),
+  end_( nullptr ),
+  line_no_( 1 ),
+  scanning_( false ),
+  next_chunk_( 0 ),
+  stop_at_( 0 )
+{
+#ifdef ZORBA_FOR_ONE_THREAD_ONLY
+  num_threads_ = 1;
+#endif
+  if ( !num_threads_ )
+    num_threads_ = 1;
+}
+
+csv_chunk_parser::~csv_chunk_parser() {
+  // out-of-line since it's not trivial
+}
+
+#ifdef ZORBA_WITH_FILE_ACCESS
+void csv_chunk_parser::open( char const *path ) {
+  fs::info info;
+  switch ( fs::get_type( path, &info ) ) {
+    case fs::file:
+      break;
+    case fs::non_existent:
+      throw XQUERY_EXCEPTION(
+        zerr::ZOSE0001_FILE_NOT_FOUND, ERROR_PARAMS( path ), ERROR_LOC( loc_ )
+      );
+    default:
+      throw XQUERY_EXCEPTION(
+        zerr::ZOSE0002_NOT_PLAIN_FILE, ERROR_PARAMS( path ), ERROR_LOC( loc_ )
+      );
+  }
+  if ( info.size ) {                    // an empty file can't be mapped
+    file_.open( path );
+    pos_ = file_.begin();
+    end_ = file_.end();
+  }
+  if ( keys_.empty() )
+    parse_header();
+}
+#endif /* ZORBA_WITH_FILE_ACCESS */
+
+bool csv_chunk_parser::next_batch( items_type *items ) {
+  if ( error_ ) {
+    exception_ptr const error( error_ );
+    error_ = nullptr;
+    rethrow_exception( error );
+  }
+  if ( pos_ == end_ )
+    return false;
+
+  csize num_chunks = num_threads_ * CHUNKS_PER_THREAD;
+  csize chunk_size = CHUNK_SIZE;
+  if ( csv_.get_quote_esc() != csv_.get_quote() ) {
+    //
+    // With a quote-escape character other than the quote character, the
+    // parity of the number of quotes doesn't tell whether a newline is inside
+    // of a quoted value, so the rest of the file is parsed as a single chunk.
+    //
+    num_chunks = 1;
+    chunk_size = end_ - pos_;
+  }
+
+  char const *window_end;
+  for ( ;; ) {
+    csize const size = end_ - pos_;
+    if ( size <= num_chunks * chunk_size ) {
+      window_end = end_;
+      num_chunks = (size + chunk_size - 1) / chunk_size;
+    } else
+      window_end = pos_ + num_chunks * chunk_size;
+
+    chunks_.clear();
+    chunks_.resize( num_chunks );
+    char const *begin = pos_;
+    MUTATE_EACH( vector<chunk>, c, chunks_ ) {
+      c->begin_ = begin;
+      c->end_ = begin = min( begin + chunk_size, window_end );
+      c->line_no_ = line_no_;
+    }
+
+    if ( num_chunks == 1 && window_end == end_ )
+      break;
+
+    scanning_ = true;
+    run_workers();
+
+    //
+    // Now that the quote parity at the start of every chunk is known, make
+    // each chunk start right after the last record terminator of the chunks
+    // before it and end right after its own last record terminator.
+    //
+    unsigned in_quote = 0;
+    unsigned line_no = line_no_;
+    begin = pos_;
+    MUTATE_EACH( vector<chunk>, c, chunks_ ) {
+      char const *const last_eol = c->info_.last_eol[ in_quote ];
+      c->begin_ = begin;
+      c->line_no_ = line_no;
+      line_no += c->info_.records[ in_quote ];
+      in_quote ^= c->info_.quotes & 1;
+      if ( last_eol )
+        begin = last_eol;
+      c->end_ = begin;
+    }
+
+    if ( window_end == end_ ) {
+      chunks_.back().end_ = end_;
+      break;
+    }
+    if ( begin != pos_ ) {
+      line_no_ = line_no;
+      break;
+    }
+    //
+    // The window doesn't contain even a single whole record: try again with a
+    // bigger one.
+    //
+    chunk_size *= 2;
+  } // for
+
+  pos_ = chunks_.back().end_;
+
+  scanning_ = false;
+  run_workers();
+
+  //
+  // The chunk that failed, if any, has the objects of the records before the
+  // bad one: they're returned too, before the error is raised.
+  //
+  csize const last = min( stop_at_ + 1, chunks_.size() );
+  for ( csize i = 0; i < last; ++i ) {
+    items_type &chunk_items = chunks_[i].items_;
+    items->insert( items->end(), chunk_items.begin(), chunk_items.end() );
+  }
+  if ( stop_at_ < chunks_.size() ) {
+    error_ = std::move( chunks_[ stop_at_ ].error_ );
+    pos_ = end_;
+  }
+  chunks_.clear();
+  return true;
+}
+
+void csv_chunk_parser::parse_header() {
+  csv_.set_buffer( pos_, end_ );
+  zstring value;
+  bool eol;
+  store::Item_t item;
+
+  while ( csv_.next_value( &value, &eol ) ) {
+    if ( value.empty() ) {
+      //
+      // Header field names can never be empty.
+      //
+      throw XQUERY_EXCEPTION(
+        csv::MISSING_VALUE,
+        ERROR_PARAMS( ZED( MISSING_VALUE_EmptyHeader ) ),
+        ERROR_LOC( loc_ )
+      );
+    }
+    GENV_ITEMFACTORY->createString( item, value );
+    keys_.push_back( item );
+    if ( eol )
+      break;
+  }
+  pos_ = csv_.get_buffer_pos();
+  ++line_no_;
+}
+
+void csv_chunk_parser::run_workers() {
+  next_chunk_ = 0;
+  stop_at_ = chunks_.size();
+
+  csize const num_workers = min( num_threads_, chunks_.size() );
+  if ( num_workers <= 1 ) {
+    work();
+    return;
+  }
+
+  vector<unique_ptr<worker> > workers( num_workers );
+  for ( csize i = 0; i < num_workers; ++i ) {
+    workers[i].reset( new worker( *this ) );
+    workers[i]->start();
+  }
+  for ( csize i = 0; i < num_workers; ++i )
+    workers[i]->join();
+}
+
+void csv_chunk_parser::work() {
+  csv_parse_json_state json_state;
+  csize i;
+
+  while ( claim_chunk( &i ) ) {
+    chunk &c = chunks_[i];
+    try {
+      if ( scanning_ )
+        csv_scan( c.begin_, c.end_, end_, csv_.get_quote(), &c.info_ );
+      else
+        parse_chunk( c, json_state );
+    }
+    catch ( ... ) {
+      //
+      // Nothing may escape a worker thread (that would terminate the
+      // process), so any exception is rethrown by next_batch().
+      //
+      SYNC_CODE( AutoMutex lock( &mutex_ ); )
+      c.error_ = current_exception();
+      if ( i < stop_at_ )
+        stop_at_ = i;
+    }
+  }
+}
+
+bool csv_chunk_parser::claim_chunk( csize *i ) {
+  SYNC_CODE( AutoMutex lock( &mutex_ ); )
+  if ( next_chunk_ >= stop_at_ )
+    return false;
+  *i = next_chunk_++;
+  return true;
+}
+
+void csv_chunk_parser::parse_chunk( chunk &c,
+                                    csv_parse_json_state &json_state ) {
+  csv_parser csv( csv_ );
+  csv.set_buffer( c.begin_, c.end_ );
+
+  items_type values;
+  vector<unsigned> omit;
+  store::Item_t item;
+  zstring value;
+  bool eol, quoted;
+  unsigned field_no = 0;
+  unsigned line_no = c.line_no_;
+
+  while ( csv.next_value( &value, &eol, &quoted ) ) {
+    if ( !keys_.empty() && values.size() == keys_.size() &&
+         extra_name_.empty() ) {
+      throw XQUERY_EXCEPTION(
+        csv::EXTRA_VALUE,
+        ERROR_PARAMS( value, line_no ),
+        ERROR_LOC( loc_ )
+      );
+    }
+
+    item = nullptr;
+    if ( value.empty() ) {
+      if ( quoted )
+        GENV_ITEMFACTORY->createString( item, value );
+      else
+        switch ( missing_ ) {
+          case missing::error:
+            throw_missing( field_no, line_no );
+          case missing::null:
+            GENV_ITEMFACTORY->createJSONNull( item );
+            break;
+          case missing::omit:
+            omit.push_back( field_no );
+            break;
+        }
+    } else if ( cast_unquoted_ && !quoted )
+      cast_csv_value( value, json_state, &item );
+    else
+      GENV_ITEMFACTORY->createString( item, value );
+
+    if ( !item.isNull() )
+      values.push_back( item );
+
+    if ( eol ) {
+      make_object( values, omit, line_no, &item );
+      c.items_.push_back( item );
+      values.clear();
+      omit.clear();
+      ++line_no, field_no = 0;
+    } else
+      ++field_no;
+  } // while
+}
+
+void csv_chunk_parser::make_object( items_type &values,
+                                    vector<unsigned> const &omit,
+                                    unsigned line_no,
+                                    store::Item_t *result ) const {
+  if ( values.size() < keys_.size() ) {
+    //
+    // At least one value is missing.
+    //
+    items_type keys;
+    switch ( missing_ ) {
+      case missing::error:
+        throw_missing( values.size(), line_no );
+      case missing::null: {
+        store::Item_t null_item;
+        GENV_ITEMFACTORY->createJSONNull( null_item );
+        values.resize( keys_.size(), null_item );
+        GENV_ITEMFACTORY->createJSONObject( *result, keys_, values );
+        return;
+      }
+      case missing::omit:
+        if ( omit.empty() ) {
+          //
+          // The last field is the one that's missing and there's no trailing
+          // separator (which is why omit is empty).
+          //
+          keys.assign( keys_.begin(), keys_.end() - 1 );
+        } else {
+          for ( unsigned i = 0; i < keys_.size(); ++i )
+            if ( find( omit.begin(), omit.end(), i ) == omit.end() )
+              keys.push_back( keys_[i] );
+        }
+        GENV_ITEMFACTORY->createJSONObject( *result, keys, values );
+        return;
+    }
+  }
+
+  if ( values.size() > keys_.size() ) {
+    //
+    // There's at least one extra value: add in extra fields for keys.
+    //
+    items_type keys( keys_ );
+    zstring::size_type const num_pos = extra_name_.find( '#' );
+    for ( unsigned f = keys_.size() + 1; f <= values.size(); ++f ) {
+      ascii::itoa_buf_type buf;
+      ascii::itoa( f, buf );
+      zstring extra_name( extra_name_ );
+      if ( num_pos != zstring::npos )
+        extra_name.replace( num_pos, 1, buf );
+      else
+        extra_name += buf;
+      store::Item_t key;
+      GENV_ITEMFACTORY->createString( key, extra_name );
+      keys.push_back( key );
+    }
+    GENV_ITEMFACTORY->createJSONObject( *result, keys, values );
+    return;
+  }
+
+  GENV_ITEMFACTORY->createJSONObject( *result, keys_, values );
+}
+
+void csv_chunk_parser::throw_missing( unsigned field_no,
+                                      unsigned line_no ) const {
+  throw XQUERY_EXCEPTION(
+    csv::MISSING_VALUE,
+    ERROR_PARAMS(
+      ZED( MISSING_VALUE_Default ),
+      field_no < keys_.size() ?
+        keys_[ field_no ]->getStringValue() : extra_name_,
+      line_no
+    ),
+    ERROR_LOC( loc_ )
+  );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void csv_chunk_parser::worker::run() {
+  parser_.work();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace zorba
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ZORBA_CSV_CHUNK_PARSER_H
+#define ZORBA_CSV_CHUNK_PARSER_H
+
+// standard
+#include <exception>
+#include <memory>
+#include <vector>
+
+// Zorba
+#include <zorba/config.h>
+#include <zorba/zorba_exception.h>
+#include "common/common.h"
+#include "compiler/parser/query_loc.h"
+#include "store/api/item.h"
+#include "util/csv_parser.h"
+#include "util/mmap_file.h"
+#include "zorbatypes/zstring.h"
+#include "zorbautils/mutex.h"
+#include "zorbautils/runnable.h"
+
+// local
+#include "csv_util.h"
+
+namespace zorba {
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A %csv_chunk_parser parses a memory-mapped CSV file into JSON objects on a
+ * pool of worker threads, returning the objects in the order of the records.
+ *
+ * The file is processed in windows of up to \c CHUNK_SIZE bytes per chunk.
+ * Each window is parsed in two parallel passes:
+ *  <ol>
+ *    <li>
+ *      The window is split into equal-sized chunks and each chunk is scanned
+ *      by csv_scan() for quote characters and record terminators.  The
+ *      parities of the quote counts then give, for each chunk, whether it
+ *      starts inside of a quoted value, hence which of its terminators really
+ *      end records.  Each chunk is then adjusted to end right after its last
+ *      record terminator.
+ *    </li>
+ *    <li>
+ *      Each chunk is parsed with its own csv_parser into JSON objects that all
+ *      share the same field-name items.  Since the number of records in each
+ *      chunk is known from the first pass, so is the line number of each
+ *      record.
+ *    </li>
+ *  </ol>
+ * Whatever follows the last record terminator of a window is carried over
+ * to the next window.
+ *
+ * If a record of some chunk raises an error, the objects of the records that
+ * precede it are returned first and then the error is rethrown, i.e., the
+ * result is the same as that of csv:parse() on the contents of the file.
+ */
+class csv_chunk_parser {
+public:
+  typedef std::vector<store::Item_t> items_type;
+
+  /**
+   * The number of bytes of a chunk.
+   */
+  static csize const CHUNK_SIZE = 1 << 20;
+
+  /**
+   * The number of chunks per thread in a window.
+   */
+  static csize const CHUNKS_PER_THREAD = 4;
+
+  /**
+   * Constructs a %csv_chunk_parser.
+   *
+   * @param csv The csv_parser whose separator and quote characters to use.
+   * @param cast_unquoted Whether to cast unquoted values.
+   * @param extra_name The field name for extra values, if any.
+   * @param keys The field names or empty to take them from the header line.
+   * @param missing What to do for missing values.
+   * @param loc The location to use for errors.
+   */
+  csv_chunk_parser( csv_parser const &csv, bool cast_unquoted,
+                    zstring const &extra_name, items_type const &keys,
+                    missing::type missing, QueryLoc const &loc );
+
+  ~csv_chunk_parser();
+
+#ifdef ZORBA_WITH_FILE_ACCESS
+  /**
+   * Maps the given file and parses its header line, if any.
+   *
+   * @param path The full path of the file.
+   */
+  void open( char const *path );
+#endif /* ZORBA_WITH_FILE_ACCESS */
+
+  /**
+   * Parses the next window of the file.
+   *
+   * @param items The vector to append the objects to.
+   * @return Returns \c false only if there are no more records.
+   */
+  bool next_batch( items_type *items );
+
+private:
+  class worker : public Runnable {
+  public:
+    worker( csv_chunk_parser &parser ) : parser_( parser ) { }
+    ~worker() { }
+
+  protected:
+    void run();
+    void finish() { }
+
+  private:
+    csv_chunk_parser &parser_;
+  };
+
+  struct chunk {
+    char const *begin_;
+    char const *end_;
+    unsigned line_no_;
+    csv_scan_info info_;
+    items_type items_;
+    std::exception_ptr error_;
+  };
+
+  csv_parser csv_;
+  bool const cast_unquoted_;
+  zstring const extra_name_;
+  items_type keys_;
+  missing::type const missing_;
+  QueryLoc const loc_;
+  csize num_threads_;
+
+#ifdef ZORBA_WITH_FILE_ACCESS
+  mmap_file file_;
+#endif /* ZORBA_WITH_FILE_ACCESS */
+  char const *pos_;
+  char const *end_;
+  unsigned line_no_;
+  std::exception_ptr error_;
+
+  std::vector<chunk> chunks_;
+  bool scanning_;
+  SYNC_CODE(Mutex mutex_;)
+  csize next_chunk_;
+  csize stop_at_;
+
+  void parse_header();
+  void run_workers();
+  void work();
+  bool claim_chunk( csize *i );
+  void parse_chunk( chunk&, csv_parse_json_state& );
+  void make_object( items_type &values, std::vector<unsigned> const &omit,
+                    unsigned line_no, store::Item_t *result ) const;
+  [[noreturn]] void throw_missing( unsigned field_no, unsigned line_no ) const;
+
+  // forbid these
+  csv_chunk_parser( csv_chunk_parser const& );
+  csv_chunk_parser& operator=( csv_chunk_parser const& );
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace zorba
+#endif /* ZORBA_CSV_CHUNK_PARSER_H */
+/* vim:set et sw=2 ts=2: */
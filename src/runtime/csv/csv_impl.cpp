@@ -188,6 +188,42 @@ static json::type parse_json( zstring const &s, csv_parse_json_state &state,
   return json::map_type( tt );
 }
 
+void cast_csv_value( zstring &value, csv_parse_json_state &state,
+                     store::Item_t *result ) {
+  if ( value == "T" || value == "Y" )
+    GENV_ITEMFACTORY->createBoolean( *result, true );
+  else if ( value == "F" || value == "N" )
+    GENV_ITEMFACTORY->createBoolean( *result, false );
+  else {
+    json::token t;
+    switch ( parse_json( value, state, &t ) ) {
+      case json::boolean:
+        GENV_ITEMFACTORY->createBoolean( *result, value[0] == 't' );
+        break;
+      case json::null:
+        GENV_ITEMFACTORY->createJSONNull( *result );
+        break;
+      case json::number:
+        switch ( t.get_numeric_type() ) {
+          case json::token::integer:
+            GENV_ITEMFACTORY->createInteger( *result, xs_integer( value ) );
+            break;
+          case json::token::decimal:
+            GENV_ITEMFACTORY->createDecimal( *result, xs_decimal( value ) );
+            break;
+          case json::token::floating_point:
+            GENV_ITEMFACTORY->createDouble( *result, xs_double( value ) );
+            break;
+          default:
+            ZORBA_ASSERT( false );
+        }
+        break;
+      default:
+        GENV_ITEMFACTORY->createString( *result, value );
+    } // switch
+  } // else
+}
+
 static void set_keys( store::Item_t const &item, vector<store::Item_t> *keys,
                       QueryLoc const &loc ) {
   store::Item_t opt_item;
@@ -228,23 +264,9 @@ static void emit_csv_value(const store::Item_t& item,
     line += state.quote_;
 }
 
-///////////////////////////////////////////////////////////////////////////////
-
-void CsvParseIterator::set_input( store::Item_t const &item,
-                                  CsvParseIteratorState *state ) const {
-  if ( item->isStreamable() )
-    state->csv_.set_stream( item->getStream() );
-  else {
-    item->getStringValue2( state->string_ );
-    state->input_buf_.set( state->string_.data(), state->string_.size() );
-    state->input_iss_.ios::rdbuf( &state->input_buf_ );
-    state->csv_.set_stream( state->input_iss_ );
-  }
-}
-
-void CsvParseIterator::set_options( store::Item_t const &item,
-                                    CsvParseIteratorState *state ) const {
-  store::Item_t opt_item;
+template<class StateType>
+static void set_parse_options( store::Item_t const &item, StateType *state,
+                               QueryLoc const &loc ) {
   char opt_char;
   zstring value;
 
@@ -271,6 +293,25 @@ void CsvParseIterator::set_options( store::Item_t const &item,
     state->csv_.set_separator( opt_char );
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+void CsvParseIterator::set_input( store::Item_t const &item,
+                                  CsvParseIteratorState *state ) const {
+  if ( item->isStreamable() )
+    state->csv_.set_stream( item->getStream() );
+  else {
+    item->getStringValue2( state->string_ );
+    state->input_buf_.set( state->string_.data(), state->string_.size() );
+    state->input_iss_.ios::rdbuf( &state->input_buf_ );
+    state->csv_.set_stream( state->input_iss_ );
+  }
+}
+
+void CsvParseIterator::set_options( store::Item_t const &item,
+                                    CsvParseIteratorState *state ) const {
+  set_parse_options( item, state, loc );
+}
+
 bool CsvParseIterator::countImpl( store::Item_t &result,
                               PlanState &plan_state ) const {
   unsigned long count = 0;
@@ -437,38 +478,7 @@ bool CsvParseIterator::nextImpl( store::Item_t &result,
             break;
         }
     } else if ( state->cast_unquoted_ && !quoted && !state->keys_.empty() ) {
-      if ( *value == "T" || *value == "Y" )
-        GENV_ITEMFACTORY->createBoolean( item, true );
-      else if ( *value == "F" || *value == "N" )
-        GENV_ITEMFACTORY->createBoolean( item, false );
-      else {
-        json::token t;
-        switch ( parse_json( *value, state->parse_json_state_, &t ) ) {
-          case json::boolean:
-            GENV_ITEMFACTORY->createBoolean( item, (*value)[0] == 't' );
-            break;
-          case json::null:
-            GENV_ITEMFACTORY->createJSONNull( item );
-            break;
-          case json::number:
-            switch ( t.get_numeric_type() ) {
-              case json::token::integer:
-                GENV_ITEMFACTORY->createInteger( item, xs_integer( *value ) );
-                break;
-              case json::token::decimal:
-                GENV_ITEMFACTORY->createDecimal( item, xs_decimal( *value ) );
-                break;
-              case json::token::floating_point:
-                GENV_ITEMFACTORY->createDouble( item, xs_double( *value ) );
-                break;
-              default:
-                ZORBA_ASSERT( false );
-            }
-            break;
-          default:
-            GENV_ITEMFACTORY->createString( item, *value );
-        } // switch
-      } // else
+      cast_csv_value( *value, state->parse_json_state_, &item );
     } else {
       GENV_ITEMFACTORY->createString( item, *value );
     }
@@ -573,6 +583,83 @@ missing_error:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void CsvParseFileIteratorState::init( PlanState &state ) {
+  PlanIteratorState::init( state );
+  batch_pos_ = 0;
+  cast_unquoted_ = true;
+  csv_ = csv_parser();
+  extra_name_.clear();
+  keys_.clear();
+  missing_ = missing::null;
+}
+
+void CsvParseFileIteratorState::reset( PlanState &state ) {
+  PlanIteratorState::reset( state );
+  batch_.clear();
+  batch_pos_ = 0;
+  cast_unquoted_ = true;
+  csv_ = csv_parser();
+  extra_name_.clear();
+  keys_.clear();
+  missing_ = missing::null;
+  parser_.reset();
+}
+
+void CsvParseFileIterator::set_options( store::Item_t const &item,
+                                        CsvParseFileIteratorState *state )
+                                        const {
+  set_parse_options( item, state, loc );
+}
+
+bool CsvParseFileIterator::nextImpl( store::Item_t &result,
+                                     PlanState &plan_state ) const {
+  store::Item_t item;
+  zstring path;
+
+  CsvParseFileIteratorState *state;
+  DEFAULT_STACK_INIT( CsvParseFileIteratorState, state, plan_state );
+
+  // $path as string
+  consumeNext( item, theChildren[0], plan_state );
+  item->getStringValue2( path );
+
+  // $options as object()
+  consumeNext( item, theChildren[1], plan_state );
+  set_options( item, state );
+
+#ifdef ZORBA_WITH_FILE_ACCESS
+  state->parser_.reset(
+    new csv_chunk_parser(
+      state->csv_, state->cast_unquoted_, state->extra_name_, state->keys_,
+      state->missing_, loc
+    )
+  );
+  state->parser_->open( path.c_str() );
+
+  while ( true ) {
+    state->batch_.clear();
+    state->batch_pos_ = 0;
+    if ( !state->parser_->next_batch( &state->batch_ ) )
+      break;
+    while ( state->batch_pos_ < state->batch_.size() ) {
+      result.transfer( state->batch_[ state->batch_pos_++ ] );
+      STACK_PUSH( true, state );
+    }
+  }
+  state->parser_.reset();
+#else
+  throw XQUERY_EXCEPTION(
+    zerr::ZXQP0050_FEATURE_NOT_AVAILABLE,
+    ERROR_PARAMS( "file access" ),
+    ERROR_LOC( loc )
+  );
+#endif /* ZORBA_WITH_FILE_ACCESS */
+
+  STACK_END( state );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void CsvSerializeIteratorState::reset( PlanState &state ) {
   PlanIteratorState::reset( state );
   boolean_string_[0] = "false";
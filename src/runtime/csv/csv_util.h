@@ -22,6 +22,8 @@
 
 // Zorba
 #include <zorba/util/mem_streambuf.h>
+#include "store/api/item.h"
+#include "zorbatypes/zstring.h"
 
 namespace zorba {
 
@@ -51,6 +53,17 @@ namespace missing {
   };
 }
 
+/**
+ * Casts an unquoted CSV value to boolean, null, integer, decimal, or double.
+ * If the value is none of those, it is taken to be a string.
+ *
+ * @param value The value to cast.  It may be swapped into the result.
+ * @param state The JSON lexer state to use.
+ * @param result A pointer to the item to receive the result.
+ */
+void cast_csv_value( zstring &value, csv_parse_json_state &state,
+                     store::Item_t *result );
+
 ///////////////////////////////////////////////////////////////////////////////
 
 } // namespace zorba
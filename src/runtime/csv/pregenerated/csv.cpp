@@ -89,6 +89,45 @@ zstring CsvParseIterator::getNameAsString() const {
 // </CsvParseIterator>
 
 
+// <CsvParseFileIterator>
+SERIALIZABLE_CLASS_VERSIONS(CsvParseFileIterator)
+
+void CsvParseFileIterator::serialize(::zorba::serialization::Archiver& ar)
+{
+  serialize_baseclass(ar,
+  (NaryBaseIterator<CsvParseFileIterator, CsvParseFileIteratorState>*)this);
+}
+
+
+void CsvParseFileIterator::accept(PlanIterVisitor& v) const
+{
+  if (!v.hasToVisit(this))
+    return;
+
+  v.beginVisit(*this);
+
+  std::vector<PlanIter_t>::const_iterator lIter = theChildren.begin();
+  std::vector<PlanIter_t>::const_iterator lEnd = theChildren.end();
+  for ( ; lIter != lEnd; ++lIter ){
+    (*lIter)->accept(v);
+  }
+
+  v.endVisit(*this);
+}
+
+CsvParseFileIterator::~CsvParseFileIterator() {}
+
+CsvParseFileIteratorState::CsvParseFileIteratorState() {}
+
+CsvParseFileIteratorState::~CsvParseFileIteratorState() {}
+
+
+zstring CsvParseFileIterator::getNameAsString() const {
+  return "fn-zorba-csv:parse-file";
+}
+// </CsvParseFileIterator>
+
+
 // <CsvSerializeIterator>
 SERIALIZABLE_CLASS_VERSIONS(CsvSerializeIterator)
 
@@ -33,6 +33,8 @@
 #include <sstream>
 #include <vector>
 #include <zorba/util/mem_streambuf.h>
+#include <zorba/internal/unique_ptr.h>
+#include "runtime/csv/csv_chunk_parser.h"
 #include "runtime/csv/csv_util.h"
 #include "util/csv_parser.h"
 #include "zorbatypes/zstring.h"
@@ -101,6 +103,60 @@ public:
 };
 
 
+/**
+ * 
+ * Author: 
+ */
+class CsvParseFileIteratorState : public PlanIteratorState
+{
+public:
+  std::vector<store::Item_t> batch_; //
+  std::vector<store::Item_t>::size_type batch_pos_; //
+  bool cast_unquoted_; //
+  csv_parser csv_; //
+  zstring extra_name_; //
+  std::vector<store::Item_t> keys_; //
+  missing::type missing_; //
+  std::unique_ptr<csv_chunk_parser> parser_; //
+
+  CsvParseFileIteratorState();
+
+  ~CsvParseFileIteratorState();
+
+  void init(PlanState&);
+  void reset(PlanState&);
+};
+
+class CsvParseFileIterator : public NaryBaseIterator<CsvParseFileIterator, CsvParseFileIteratorState>
+{ 
+public:
+  SERIALIZABLE_CLASS(CsvParseFileIterator);
+
+  SERIALIZABLE_CLASS_CONSTRUCTOR2T(CsvParseFileIterator,
+    NaryBaseIterator<CsvParseFileIterator, CsvParseFileIteratorState>);
+
+  void serialize( ::zorba::serialization::Archiver& ar);
+
+  CsvParseFileIterator(
+    static_context* sctx,
+    const QueryLoc& loc,
+    std::vector<PlanIter_t>& children)
+    : 
+    NaryBaseIterator<CsvParseFileIterator, CsvParseFileIteratorState>(sctx, loc, children)
+  {}
+
+  virtual ~CsvParseFileIterator();
+
+  zstring getNameAsString() const;
+
+public:
+  void set_options(store::Item_t const& item, CsvParseFileIteratorState* state) const;
+  void accept(PlanIterVisitor& v) const;
+
+  bool nextImpl(store::Item_t& result, PlanState& aPlanState) const;
+};
+
+
 /**
  * 
  * Author: 
@@ -0,0 +1,257 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "stdafx.h"
+
+#include "runtime/visitors/planiter_visitor.h"
+#include "runtime/indexing/hash_join.h"
+
+#include "context/static_context.h"
+#include "context/dynamic_context.h"
+
+#include "diagnostics/assert.h"
+
+
+namespace zorba {
+
+
+SERIALIZABLE_CLASS_VERSIONS(HashJoinBuildIterator)
+DEF_GET_NAME_AS_STRING(HashJoinBuildIterator)
+
+SERIALIZABLE_CLASS_VERSIONS(HashJoinProbeIterator)
+DEF_GET_NAME_AS_STRING(HashJoinProbeIterator)
+
+
+/*******************************************************************************
+  HashJoinTable
+********************************************************************************/
+
+HashJoinTable::HashJoinTable(long timezone, const XQPCollator* collator)
+  :
+  theNumChains(0),
+  theTimezone(timezone),
+  theCollator(collator)
+{
+}
+
+
+void HashJoinTable::insert(store::Item_t& key, store::Item_t& value)
+{
+  if (key == NULL)
+    return;
+
+  uint32_t hval = key->hash(theTimezone, theCollator);
+
+  if (2 * (theNumChains + 1) > theSlots.size())
+    grow();
+
+  csize slot = findSlot(key.getp(), hval);
+  csize pos = theEntries.size();
+
+  theEntries.resize(pos + 1);
+
+  Entry& entry = theEntries[pos];
+  entry.theKey.transfer(key);
+  entry.theValue.transfer(value);
+  entry.theHash = hval;
+  entry.theNext = 0;
+  entry.theLast = pos;
+
+  if (theSlots[slot] == 0)
+  {
+    theSlots[slot] = pos + 1;
+    ++theNumChains;
+  }
+  else
+  {
+    Entry& head = theEntries[theSlots[slot] - 1];
+    theEntries[head.theLast].theNext = pos + 1;
+    head.theLast = pos;
+  }
+}
+
+
+csize HashJoinTable::find(const store::Item* key) const
+{
+  if (key == NULL || theNumChains == 0)
+    return 0;
+
+  return theSlots[findSlot(key, key->hash(theTimezone, theCollator))];
+}
+
+
+/*******************************************************************************
+  Return the slot that holds the chain for the given key, or the free slot
+  where such a chain would be placed.
+********************************************************************************/
+csize HashJoinTable::findSlot(const store::Item* key, uint32_t hval) const
+{
+  csize mask = theSlots.size() - 1;
+  csize slot = hval & mask;
+
+  while (theSlots[slot] != 0)
+  {
+    const Entry& head = theEntries[theSlots[slot] - 1];
+
+    if (head.theHash == hval &&
+        head.theKey->equals(key, theTimezone, theCollator))
+      return slot;
+
+    slot = (slot + 1) & mask;
+  }
+
+  return slot;
+}
+
+
+void HashJoinTable::grow()
+{
+  csize newSize = (theSlots.empty() ? 16 : 2 * theSlots.size());
+  csize mask = newSize - 1;
+
+  std::vector<csize> newSlots(newSize, 0);
+
+  std::vector<csize>::const_iterator ite = theSlots.begin();
+  std::vector<csize>::const_iterator end = theSlots.end();
+  for (; ite != end; ++ite)
+  {
+    if (*ite == 0)
+      continue;
+
+    csize slot = theEntries[*ite - 1].theHash & mask;
+
+    while (newSlots[slot] != 0)
+      slot = (slot + 1) & mask;
+
+    newSlots[slot] = *ite;
+  }
+
+  theSlots.swap(newSlots);
+}
+
+
+/*******************************************************************************
+  HashJoinBuildIterator
+********************************************************************************/
+
+HashJoinBuildIterator::~HashJoinBuildIterator()
+{
+}
+
+
+bool HashJoinBuildIterator::nextImpl(
+    store::Item_t& result,
+    PlanState& planState) const
+{
+  store::Item_t value;
+  store::Item_t key;
+  HashJoinTable_t table;
+  dynamic_context* dctx = planState.theLocalDynCtx;
+
+  PlanIteratorState* state;
+  DEFAULT_STACK_INIT(PlanIteratorState, state, planState);
+
+  table = new HashJoinTable(dctx->get_implicit_timezone(),
+                            theSctx->get_default_collator(loc));
+
+  while (consumeNext(value, theChild, planState))
+  {
+    // The build expr returns the domain item followed by its key (or NULL if
+    // the key is the empty sequence).
+    if (!consumeNext(key, theChild, planState))
+      ZORBA_ASSERT(false);
+
+    table->insert(key, value);
+  }
+
+  if (dctx->getHashJoinTable(theQName.getp()))
+    dctx->unbindHashJoinTable(theQName.getp());
+
+  dctx->bindHashJoinTable(theQName.getp(), table);
+
+  STACK_END(state);
+}
+
+
+UNARY_ACCEPT(HashJoinBuildIterator)
+
+
+/*******************************************************************************
+  HashJoinProbeIterator
+********************************************************************************/
+
+HashJoinProbeIteratorState::HashJoinProbeIteratorState()
+{
+}
+
+
+HashJoinProbeIteratorState::~HashJoinProbeIteratorState()
+{
+}
+
+
+void HashJoinProbeIteratorState::init(PlanState& planState)
+{
+  PlanIteratorState::init(planState);
+  theTable = NULL;
+  thePos = 0;
+}
+
+
+void HashJoinProbeIteratorState::reset(PlanState& planState)
+{
+  PlanIteratorState::reset(planState);
+  theTable = NULL;
+  thePos = 0;
+}
+
+
+HashJoinProbeIterator::~HashJoinProbeIterator()
+{
+}
+
+
+bool HashJoinProbeIterator::nextImpl(
+    store::Item_t& result,
+    PlanState& planState) const
+{
+  store::Item_t key;
+
+  HashJoinProbeIteratorState* state;
+  DEFAULT_STACK_INIT(HashJoinProbeIteratorState, state, planState);
+
+  if (consumeNext(key, theChild, planState))
+  {
+    state->theTable = planState.theLocalDynCtx->getHashJoinTable(theQName.getp());
+    ZORBA_ASSERT(state->theTable != NULL);
+
+    state->thePos = state->theTable->find(key.getp());
+
+    while (state->thePos != 0)
+    {
+      result = state->theTable->next(state->thePos);
+      STACK_PUSH(true, state);
+    }
+  }
+
+  STACK_END(state);
+}
+
+
+UNARY_ACCEPT(HashJoinProbeIterator)
+
+
+}
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef ZORBA_RUNTIME_INDEXING_HASH_JOIN_H
+#define ZORBA_RUNTIME_INDEXING_HASH_JOIN_H
+
+#include <vector>
+
+#include "common/shared_types.h"
+
+#include "runtime/base/unarybase.h"
+
+#include "store/api/item.h"
+
+
+namespace zorba
+{
+
+class XQPCollator;
+
+
+/*******************************************************************************
+  The in-memory table built by op:hash-join-build and probed by
+  op:hash-join-probe. It maps the (atomized) join key of each item in the
+  inner side of a value join to the item itself.
+
+  Entries are kept in a vector, in the order in which they were inserted. All
+  the entries having the same key form a chain (via theNext), so a probe
+  returns the matching items in the order of the inner domain, exactly as the
+  nested-loop plan would.
+
+  theSlots is an open-addressing table (linear probing, power-of-two size,
+  load factor at most 1/2). Each slot stores 1 + the position in theEntries
+  of the head of a chain, or 0 if the slot is free. The hash code of each
+  chain head is cached in its entry, so that growing the table does not need
+  to rehash any item.
+
+  Hashing and equality follow the store's value indexes: Item::hash() and
+  Item::equals(), using the implicit timezone and the default collation.
+  Entries with an empty key never match and are not inserted at all.
+********************************************************************************/
+class HashJoinTable : public SimpleRCObject
+{
+protected:
+  struct Entry
+  {
+    store::Item_t  theKey;
+    store::Item_t  theValue;
+    uint32_t       theHash;
+    csize          theNext;   // 1 + pos of the next entry in chain, or 0
+    csize          theLast;   // for chain heads: pos of the last entry in chain
+  };
+
+protected:
+  std::vector<Entry>   theEntries;
+  std::vector<csize>   theSlots;
+  csize                theNumChains;
+
+  long                 theTimezone;
+  const XQPCollator  * theCollator;
+
+public:
+  HashJoinTable(long timezone, const XQPCollator* collator);
+
+  void insert(store::Item_t& key, store::Item_t& value);
+
+  csize find(const store::Item* key) const;
+
+  csize size() const { return theEntries.size(); }
+
+  /**
+   * Returns the value of the entry at the given position, and sets pos to
+   * the position of the next entry with the same key (or to 0 if there is
+   * none). Positions returned by find() and next() are 1-based.
+   */
+  const store::Item_t& next(csize& pos) const
+  {
+    const Entry& e = theEntries[pos - 1];
+    pos = e.theNext;
+    return e.theValue;
+  }
+
+protected:
+  csize findSlot(const store::Item* key, uint32_t hval) const;
+
+  void grow();
+};
+
+
+/*******************************************************************************
+  op:hash-join-build($name as xs:QName, $items as item*) as ()
+
+  Consumes the output of a build expr of the form
+
+    for $dot at $pos in domain_expr
+    return value-index-entry-builder($$dot, key_expr)
+
+  and stores each (key, $dot) pair into a HashJoinTable, which is then bound
+  into the local dynamic context under the given name. Like
+  create-internal-index, the name is a const qname and the function is
+  "simple".
+********************************************************************************/
+class HashJoinBuildIterator : public UnaryBaseIterator<HashJoinBuildIterator,
+                                                       PlanIteratorState>
+{
+protected:
+  store::Item_t theQName;
+
+public:
+  SERIALIZABLE_CLASS(HashJoinBuildIterator);
+
+  SERIALIZABLE_CLASS_CONSTRUCTOR2T(HashJoinBuildIterator,
+  UnaryBaseIterator<HashJoinBuildIterator, PlanIteratorState>);
+
+  void serialize( ::zorba::serialization::Archiver& ar)
+  {
+    serialize_baseclass(ar,
+    (UnaryBaseIterator<HashJoinBuildIterator, PlanIteratorState>*)this);
+
+    ar & theQName;
+  }
+
+  HashJoinBuildIterator(
+        static_context* sctx,
+        const QueryLoc& loc,
+        PlanIter_t& child,
+        const store::Item_t& name)
+    :
+    UnaryBaseIterator<HashJoinBuildIterator, PlanIteratorState>(sctx, loc, child),
+    theQName(name)
+  {
+  }
+
+  ~HashJoinBuildIterator();
+
+  store::Item_t getName() const { return theQName; }
+
+  void accept(PlanIterVisitor& v) const;
+
+  zstring getNameAsString() const;
+
+  bool nextImpl(store::Item_t& result, PlanState& aPlanState) const;
+};
+
+
+/*******************************************************************************
+  op:hash-join-probe($name as xs:QName, $key as xs:anyAtomicType?) as node()*
+
+  Returns the items of the hash join table with the given name whose key is
+  equal to $key, in the order they were inserted into the table. The name is
+  a const qname, so it is taken from the const expr during codegen and the
+  only child of the iterator computes the probing key.
+********************************************************************************/
+class HashJoinProbeIteratorState : public PlanIteratorState
+{
+public:
+  HashJoinTable_t  theTable;
+  csize            thePos;
+
+public:
+  HashJoinProbeIteratorState();
+
+  ~HashJoinProbeIteratorState();
+
+  void init(PlanState&);
+  void reset(PlanState&);
+};
+
+
+class HashJoinProbeIterator : public UnaryBaseIterator<HashJoinProbeIterator,
+                                                       HashJoinProbeIteratorState>
+{
+protected:
+  store::Item_t theQName;
+
+public:
+  SERIALIZABLE_CLASS(HashJoinProbeIterator);
+
+  SERIALIZABLE_CLASS_CONSTRUCTOR2T(HashJoinProbeIterator,
+  UnaryBaseIterator<HashJoinProbeIterator, HashJoinProbeIteratorState>);
+
+  void serialize( ::zorba::serialization::Archiver& ar)
+  {
+    serialize_baseclass(ar,
+    (UnaryBaseIterator<HashJoinProbeIterator, HashJoinProbeIteratorState>*)this);
+
+    ar & theQName;
+  }
+
+  HashJoinProbeIterator(
+        static_context* sctx,
+        const QueryLoc& loc,
+        PlanIter_t& child,
+        const store::Item_t& name)
+    :
+    UnaryBaseIterator<HashJoinProbeIterator, HashJoinProbeIteratorState>(sctx, loc, child),
+    theQName(name)
+  {
+  }
+
+  ~HashJoinProbeIterator();
+
+  store::Item_t getName() const { return theQName; }
+
+  void accept(PlanIterVisitor& v) const;
+
+  zstring getNameAsString() const;
+
+  bool nextImpl(store::Item_t& result, PlanState& aPlanState) const;
+};
+
+
+}
+#endif
+/* vim:set et sw=2 ts=2: */
@@ -15,6 +15,8 @@
  */
 #include "stdafx.h"
 
+#include <set>
+
 #include "runtime/visitors/planiter_visitor.h"
 #include "runtime/indexing/index_ddl.h"
 #include "runtime/api/plan_wrapper.h"
@@ -42,6 +44,11 @@
 
 #include "zorbautils/hashset_structured_itemh.h"
 
+#ifndef ZORBA_NO_FULL_TEXT
+#include "runtime/full_text/ft_util.h"
+#include "store/api/ft_token_iterator.h"
+#endif /* ZORBA_NO_FULL_TEXT */
+
 #include "diagnostics/xquery_exception.h"
 #include "diagnostics/util_macros.h"
 
@@ -66,6 +73,9 @@ DEF_GET_NAME_AS_STRING(ValueIndexEntryBuilderIterator)
 SERIALIZABLE_CLASS_VERSIONS(GeneralIndexEntryBuilderIterator)
 DEF_GET_NAME_AS_STRING(GeneralIndexEntryBuilderIterator)
 
+SERIALIZABLE_CLASS_VERSIONS(FullTextIndexKeysIterator)
+DEF_GET_NAME_AS_STRING(FullTextIndexKeysIterator)
+
 SERIALIZABLE_CLASS_VERSIONS(ProbeIndexPointValueIterator)
 DEF_GET_NAME_AS_STRING(ProbeIndexPointValueIterator)
 
@@ -202,6 +212,9 @@ static void createIndexSpec(
   {
     spec.theSources[i] = const_cast<store::Item*>(indexDecl->getSourceName(i));
   }
+
+  spec.theHasFieldDependencies = indexDecl->hasFieldDependencies();
+  spec.theFieldDependencies = indexDecl->getFieldDependencies();
 }
 
 
@@ -575,6 +588,84 @@ bool GeneralIndexEntryBuilderIterator::nextImpl(
 BINARY_ACCEPT(GeneralIndexEntryBuilderIterator)
 
 
+/*******************************************************************************
+  FullTextIndexKeysIterator
+********************************************************************************/
+
+FullTextIndexKeysIterator::FullTextIndexKeysIterator(
+    static_context* sctx,
+    const QueryLoc& loc,
+    PlanIter_t& child)
+  :
+  UnaryBaseIterator<FullTextIndexKeysIterator,
+                    FullTextIndexKeysIteratorState>(sctx, loc, child)
+{
+}
+
+
+FullTextIndexKeysIterator::~FullTextIndexKeysIterator()
+{
+}
+
+
+void FullTextIndexKeysIterator::serialize(::zorba::serialization::Archiver& ar)
+{
+  serialize_baseclass(ar,
+  (UnaryBaseIterator<FullTextIndexKeysIterator,
+                     FullTextIndexKeysIteratorState>*)this);
+}
+
+
+bool FullTextIndexKeysIterator::nextImpl(
+    store::Item_t& result,
+    PlanState& planState) const
+{
+  store::Item_t item;
+  zstring token;
+
+  FullTextIndexKeysIteratorState* state;
+  DEFAULT_STACK_INIT(FullTextIndexKeysIteratorState, state, planState);
+
+#ifndef ZORBA_NO_FULL_TEXT
+  {
+    std::set<zstring> tokens;
+
+    locale::iso639_1::type lang =
+    get_lang_from(theSctx->get_match_options());
+
+    TokenizerProvider const* provider = GENV_STORE.getTokenizerProvider();
+    ZORBA_ASSERT(provider);
+
+    while (consumeNext(item, theChild.getp(), planState))
+    {
+      Tokenizer::State tstate;
+      FTTokenIterator_t itemTokens = item->getTokens(*provider, tstate, lang);
+
+      while (itemTokens->hasNext())
+      {
+        FTToken const* t = itemTokens->next();
+        tokens.insert(t->value(FTToken::lower | FTToken::ascii));
+      }
+    }
+
+    state->theTokens.assign(tokens.begin(), tokens.end());
+  }
+#endif /* ZORBA_NO_FULL_TEXT */
+
+  for (; state->thePos < state->theTokens.size(); ++state->thePos)
+  {
+    token = state->theTokens[state->thePos];
+    GENV_ITEMFACTORY->createString(result, token);
+    STACK_PUSH(true, state);
+  }
+
+  STACK_END(state);
+}
+
+
+UNARY_ACCEPT(FullTextIndexKeysIterator)
+
+
 /*******************************************************************************
   probe-index-point-value($indexName as xs:QName,
                           $key1      as anyAtomic?,
@@ -18,12 +18,16 @@
 #define ZORBA_RUNTIME_INDEXING_INDEX_DDL_H
 
 
+#include <vector>
+
 #include "common/shared_types.h"
 
 #include "runtime/base/unarybase.h"
 #include "runtime/base/binarybase.h"
 #include "runtime/base/narybase.h"
 
+#include "zorbatypes/zstring.h"
+
 
 namespace zorba 
 {
@@ -323,6 +327,70 @@ public:
 };
 
 
+/******************************************************************************
+  zorba-op:full-text-index-keys(item()*) as xs:string*
+
+  Computes the keys of a full-text index for a domain node. Each input item is
+  tokenized the same way as the items of the search context of an ftcontains
+  expr, i.e., with the default tokenizer and the language of the ft match
+  options of the index's static context. The iterator returns the distinct
+  tokens of all the items, lower-cased and with their diacritics stripped, so
+  that a query token matches a token of an item only if the normalized values
+  of the two tokens are equal (no matter which case or diacritics option the
+  query uses).
+
+  theTokens : The distinct normalized tokens of the input items.
+  thePos    : The position in theTokens of the next token to return.
+*******************************************************************************/
+class FullTextIndexKeysIteratorState : public PlanIteratorState
+{
+public:
+  std::vector<zstring> theTokens;
+  csize                thePos;
+
+  void init(PlanState& planState)
+  {
+    PlanIteratorState::init(planState);
+    theTokens.clear();
+    thePos = 0;
+  }
+
+  void reset(PlanState& planState)
+  {
+    PlanIteratorState::reset(planState);
+    theTokens.clear();
+    thePos = 0;
+  }
+};
+
+
+class FullTextIndexKeysIterator :
+public UnaryBaseIterator<FullTextIndexKeysIterator,
+                         FullTextIndexKeysIteratorState>
+{
+public:
+  SERIALIZABLE_CLASS(FullTextIndexKeysIterator);
+  SERIALIZABLE_CLASS_CONSTRUCTOR2T(FullTextIndexKeysIterator,
+  UnaryBaseIterator<FullTextIndexKeysIterator,
+                    FullTextIndexKeysIteratorState>);
+  void serialize(::zorba::serialization::Archiver& ar);
+
+public:
+  FullTextIndexKeysIterator(
+      static_context* sctx,
+      const QueryLoc& loc,
+      PlanIter_t& child);
+
+  virtual ~FullTextIndexKeysIterator();
+
+  void accept(PlanIterVisitor& v) const;
+
+  zstring getNameAsString() const;
+
+  bool nextImpl(store::Item_t& result, PlanState& aPlanState) const;
+};
+
+
 /******************************************************************************
    probe-index-point-value($indexName as xs:QName,
                            $key1      as anyAtomic?,
@@ -16,6 +16,7 @@
 
 #include "stdafx.h"
 #include <zorba/config.h>
+#include <zorba/properties.h>
 
 // Zorba
 #include <store/api/item.h>
@@ -80,15 +81,22 @@ void loader::stack_element::destroy() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-loader::loader( istream &is, bool allow_multiple, bool strip_top_level_array ) :
+loader::loader( istream &is, bool allow_multiple, bool strip_top_level_array,
+                JSONScan const *scan ) :
   parser_( is, allow_multiple ),
+  dict_( GENV_ITEMFACTORY, false ),
   strip_top_level_array_( strip_top_level_array ),
-  stripped_top_level_array_( false )
+  stripped_top_level_array_( false ),
+  scan_( scan ),
+  failed_( false )
 {
 }
 
 loader::~loader() {
   clear_stack();
+  if ( Properties::instance().getTraceStringDictionary() &&
+       dict_.numLookups() )
+    dict_.report( Properties::instance().getDebugStream(), "JSON" );
 }
 
 void loader::add_value( store::Item_t const &value ) {
@@ -137,90 +145,244 @@ void loader::clear_stack() {
   }
 }
 
-bool loader::next( store::Item_t *result ) {
+bool loader::build( json::token &t, store::Item_t *result ) {
   store::Item_t item;
   zstring s;
+
+  do {
+    switch( t.get_type() ) {
+      case '[':
+        push( stack_element::array_type );
+        continue;
+      case '{':
+        push( stack_element::object_type );
+        continue;
+      case ']':
+      case '}': {
+        stack_element top( stack_.top() );
+        stack_.pop();
+        switch ( top.type_ ) {
+          case stack_element::array_type:
+            GENV_ITEMFACTORY->createJSONArray( item, *top.array_ );
+            break;
+          case stack_element::object_type:
+            GENV_ITEMFACTORY->createJSONObject(
+              item, top.object_->keys_, top.object_->values_
+            );
+            break;
+          default:
+            assert( false );
+        } // switch
+        top.destroy();
+        break;
+      }
+      case ':':
+      case ',':
+        continue;
+      case token::number:
+        switch ( t.get_numeric_type() ) {
+          case token::integer:
+            GENV_ITEMFACTORY->createInteger(
+              item, xs_integer( t.get_value() )
+            );
+            break;
+          case token::decimal:
+            GENV_ITEMFACTORY->createDecimal(
+              item, xs_decimal( t.get_value() )
+            );
+            break;
+          case token::floating_point:
+            GENV_ITEMFACTORY->createDouble(
+              item, xs_double( t.get_value() )
+            );
+            break;
+          default:
+            assert( false );
+        }
+        break;
+      case token::string:
+        s = t.get_value();
+        dict_.createItem( item, s );
+        break;
+      case 'F':
+      case 'T':
+        GENV_ITEMFACTORY->createBoolean( item, t.get_type() == 'T' );
+        break;
+      case token::json_null:
+        GENV_ITEMFACTORY->createJSONNull( item );
+        break;
+      default:
+        assert( false );
+    } // switch
+
+    if ( stack_.empty() ) {
+      *result = item;
+      return true;
+    }
+    add_value( item );
+  } while ( parser_.next( &t ) );
+  return false;
+}
+
+/**
+ * Skips the value that starts with the given token, without creating any
+ * item.
+ */
+void loader::skip_value( json::token &t ) {
+  int depth = 0;
+  do {
+    switch ( t.get_type() ) {
+      case '[':
+      case '{':
+        ++depth;
+        break;
+      case ']':
+      case '}':
+        --depth;
+        break;
+      default:
+        break;
+    }
+  } while ( depth > 0 && parser_.next( &t ) );
+}
+
+/**
+ * Scans a top-level object whose '{' has just been read.
+ *
+ * @param result A pointer to the Item to receive the (projected) object.
+ * @return Returns \c true only if the object passed all the predicates of
+ * the scan.
+ */
+bool loader::scan_record( store::Item_t *result ) {
+  JSONScan::Node const &root = scan_->getNode( 0 );
+  passed_.assign( scan_->numPredicates(), false );
+  failed_ = false;
+
+  scan_object( root, root.theKeep, result );
+
+  for ( vector<bool>::size_type i = 0; !failed_ && i < passed_.size(); ++i )
+    failed_ = !passed_[i];
+  return !failed_;
+}
+
+/**
+ * Scans the members of an object whose '{' has just been read.  The values of
+ * the keys the node has children for are scanned with those; the others are
+ * built only if the object is kept.  Once a predicate failed, the rest of the
+ * object is skipped and no object is created.
+ */
+void loader::scan_object( JSONScan::Node const &node, bool keep,
+                          store::Item_t *result ) {
+  vector<store::Item_t> keys, values;
+  store::Item_t key, value;
+  zstring s;
+  json::token t;
+
+  while ( parser_.next( &t ) && t.get_type() != '}' ) {
+    if ( t.get_type() == ',' )
+      continue;
+    s = t.get_value();
+    parser_.next( &t );                 // ':'
+    parser_.next( &t );                 // first token of the value
+    if ( failed_ ) {
+      skip_value( t );
+      continue;
+    }
+    if ( csize const child = scan_->getChild( node, s ) ) {
+      JSONScan::Node const &child_node = scan_->getNode( child );
+      scan_value( child_node, keep || child_node.theKeep, t, &value );
+    } else if ( keep )
+      build( t, &value );
+    else
+      skip_value( t );
+    if ( value ) {
+      dict_.createItem( key, s );
+      keys.push_back( key );
+      values.push_back( value );
+      value = NULL;
+    }
+  }
+  if ( !failed_ )
+    GENV_ITEMFACTORY->createJSONObject( *result, keys, values );
+}
+
+/**
+ * Scans a value for the given node, starting with the given token.  The
+ * value is returned in \a result only if it is built.
+ */
+void loader::scan_value( JSONScan::Node const &node, bool keep,
+                         json::token &t, store::Item_t *result ) {
+  test( node, t );
+  if ( failed_ )
+    skip_value( t );
+  else if ( t.get_type() == '{' && !node.theChildren.empty() )
+    scan_object( node, keep, result );
+  else if ( keep )
+    build( t, result );
+  else
+    skip_value( t );
+}
+
+/**
+ * Tests the predicates of the given node against the value that starts with
+ * the given token.  Only a string (resp. integer) that differs from the
+ * string (resp. integer) of a predicate makes it fail: the comparison of any
+ * other value is left to the query.
+ */
+void loader::test( JSONScan::Node const &node, json::token const &t ) {
+  for ( vector<csize>::const_iterator
+          i = node.thePredicates.begin(); i != node.thePredicates.end(); ++i ) {
+    store::Item const *const value = scan_->getPredicate( *i );
+    switch ( t.get_type() ) {
+      case token::string:
+        failed_ = value->getTypeCode() == store::XS_STRING &&
+                  value->getString() != t.get_value();
+        break;
+      case token::number:
+        failed_ = t.get_numeric_type() == token::integer &&
+                  value->getTypeCode() == store::XS_INTEGER &&
+                  value->getIntegerValue() != xs_integer( t.get_value() );
+        break;
+      default:
+        break;
+    }
+    if ( failed_ )
+      return;
+    passed_[ *i ] = true;
+  }
+}
+
+bool loader::next( store::Item_t *result ) {
   json::token t;
 
   try {
     while ( parser_.next( &t ) ) {
       switch( t.get_type() ) {
         case '[':
-          if ( strip_top_level_array_ && !stripped_top_level_array_ )
+          if ( strip_top_level_array_ && !stripped_top_level_array_ ) {
             stripped_top_level_array_ = true;
-          else
-            push( stack_element::array_type );
-          continue;
-        case '{':
-          push( stack_element::object_type );
-          continue;
-        case ']':
-          if ( stack_.empty() && strip_top_level_array_ ) {
-            stripped_top_level_array_ = false;
             continue;
           }
-        case '}': {
-          stack_element top( stack_.top() );
-          stack_.pop();
-          switch ( top.type_ ) {
-            case stack_element::array_type:
-              GENV_ITEMFACTORY->createJSONArray( item, *top.array_ );
-              break;
-            case stack_element::object_type:
-              GENV_ITEMFACTORY->createJSONObject(
-                item, top.object_->keys_, top.object_->values_
-              );
-              break;
-            default:
-              assert( false );
-          } // switch
-          top.destroy();
           break;
-        }
-        case ':':
+        case ']':
+          // the end of the stripped top-level array
+          stripped_top_level_array_ = false;
+          continue;
         case ',':
           continue;
-        case token::number:
-          switch ( t.get_numeric_type() ) {
-            case token::integer:
-              GENV_ITEMFACTORY->createInteger(
-                item, xs_integer( t.get_value() )
-              );
-              break;
-            case token::decimal:
-              GENV_ITEMFACTORY->createDecimal(
-                item, xs_decimal( t.get_value() )
-              );
-              break;
-            case token::floating_point:
-              GENV_ITEMFACTORY->createDouble(
-                item, xs_double( t.get_value() )
-              );
-              break;
-            default:
-              assert( false );
+        case '{':
+          if ( scan_ ) {
+            if ( scan_record( result ) )
+              return true;
+            continue;
           }
           break;
-        case token::string:
-          s = t.get_value();
-          GENV_ITEMFACTORY->createString( item, s );
-          break;
-        case 'F':
-        case 'T':
-          GENV_ITEMFACTORY->createBoolean( item, t.get_type() == 'T' );
-          break;
-        case token::json_null:
-          GENV_ITEMFACTORY->createJSONNull( item );
-          break;
         default:
-          assert( false );
+          break;
       } // switch
 
-      if ( stack_.empty() ) {
-        *result = item;
+      if ( build( t, result ) )
         return true;
-      }
-      add_value( item );
     } // while
     return false;
   } // try
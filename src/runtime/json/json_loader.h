@@ -24,15 +24,22 @@
 #include <vector>
 
 // Zorba
+#include "runtime/json/json_scan.h"
 #include "store/api/item.h"
 #include "util/json_parser.h"
 #include "zorbatypes/zstring.h"
+#include "zorbautils/string_dictionary.h"
 
 namespace zorba {
 namespace json {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/**
+ * Loads JSON items from an istream.  Short keys and strings that repeat within
+ * the stream always share a single item (see StringDictionary): unlike the XML
+ * loader, this %loader does not honor store::LoadProperties::setInternStrings().
+ */
 class loader {
 public:
   typedef parser::line_type line_type;
@@ -46,9 +53,11 @@ public:
    * be returned.
    * @param strip_top_level_array If \c true, strips the top-level array, if
    * any.
+   * @param scan If not null, the parts of each top-level object to build and
+   * the predicates it must satisfy to be returned at all.
    */
   loader( std::istream &is, bool allow_multiple = false,
-          bool strip_top_level_array = false );
+          bool strip_top_level_array = false, JSONScan const *scan = nullptr );
 
   /**
    * Destroys this %loader.
@@ -109,7 +118,15 @@ private:
   stack_type stack_;
 
   void add_value( store::Item_t const& );
+  bool build( json::token&, store::Item_t* );
   void clear_stack();
+  void skip_value( json::token& );
+
+  bool scan_record( store::Item_t* );
+  void scan_object( JSONScan::Node const&, bool, store::Item_t* );
+  void scan_value( JSONScan::Node const&, bool, json::token&,
+                   store::Item_t* );
+  void test( JSONScan::Node const&, json::token const& );
 
   stack_element& push( stack_element::type t ) {
     //
@@ -121,8 +138,13 @@ private:
   }
 
   parser parser_;
+  StringDictionary dict_;               // shares repeated keys and strings
   bool const strip_top_level_array_;
   bool stripped_top_level_array_;
+
+  JSONScan const *const scan_;
+  std::vector<bool> passed_;            // the predicates the record passed
+  bool failed_;                         // whether the record failed one
 };
 
 ///////////////////////////////////////////////////////////////////////////////
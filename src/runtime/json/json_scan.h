@@ -0,0 +1,159 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ZORBA_RUNTIME_JSON_SCAN_H
+#define ZORBA_RUNTIME_JSON_SCAN_H
+
+#include <utility>
+#include <vector>
+
+#include "zorbatypes/rchandle.h"
+#include "zorbatypes/zstring.h"
+
+#include "store/api/item.h"
+
+
+namespace zorba
+{
+
+/*******************************************************************************
+  Describes what the query needs of each top-level item (record) returned by a
+  jn:parse-json call, so that the JSON loader can skip the rest while lexing.
+
+  A scan is a tree of nodes, each of which stands for the values reached by a
+  path of object keys from the record; theNodes[0] is the record itself. A
+  node has:
+
+  - theChildren :
+    The keys under which the node has a child node.
+  - theKeep :
+    Whether the whole value must be built. The value of a node that is not
+    kept is built only if it is an object, and then only with the fields that
+    have a child node; the query reaches such a value only by looking up these
+    fields, and a lookup into an atomic value or an array is empty anyway. A
+    field without a node is skipped, unless its object is kept.
+  - thePredicates :
+    The predicates on the value of the node. A predicate is an atomic value
+    (an xs:string or an xs:integer) that the value must be equal to.
+
+  The loader skips a record, without building anything of it, if one of its
+  predicates is false, i.e., if the path of the predicate does not reach any
+  value in the record, or if it reaches a string (resp. integer) that differs
+  from the predicate's string (resp. integer). A predicate on any other value
+  is assumed to be true, and so left to the query to evaluate.
+********************************************************************************/
+class JSONScan : public SimpleRCObject
+{
+public:
+  typedef std::vector<zstring> Path;
+
+  struct Node
+  {
+    std::vector<std::pair<zstring, csize> >  theChildren;
+    bool                                     theKeep;
+    std::vector<csize>                       thePredicates;
+
+    Node() : theKeep(false) {}
+  };
+
+protected:
+  std::vector<Node>           theNodes;
+  std::vector<store::Item_t>  thePredicates;
+
+public:
+  JSONScan() : theNodes(1) {}
+
+  /**
+   * Makes the loader build the whole value reached by the given path.
+   */
+  void addPath(const Path& path) { theNodes[addNode(path)].theKeep = true; }
+
+  /**
+   * Makes the loader skip the records in which the value reached by the given
+   * path is not equal to the given atomic value.
+   */
+  void addPredicate(const Path& path, const store::Item_t& value)
+  {
+    csize node = addNode(path);
+    theNodes[node].thePredicates.push_back(thePredicates.size());
+    thePredicates.push_back(value);
+  }
+
+  const Node& getNode(csize i) const { return theNodes[i]; }
+
+  /**
+   * Returns the position of the child of the given node under the given key,
+   * or 0 if there is none.
+   */
+  csize getChild(const Node& node, const zstring& key) const
+  {
+    for (csize i = 0; i < node.theChildren.size(); ++i)
+    {
+      if (node.theChildren[i].first == key)
+        return node.theChildren[i].second;
+    }
+    return 0;
+  }
+
+  csize numPredicates() const { return thePredicates.size(); }
+
+  const store::Item* getPredicate(csize i) const
+  {
+    return thePredicates[i].getp();
+  }
+
+  std::vector<Node>& getNodes() { return theNodes; }
+
+  std::vector<store::Item_t>& getPredicates() { return thePredicates; }
+
+  /**
+   * Returns true if the loader has nothing to skip, i.e., if the whole record
+   * is kept and there are no predicates.
+   */
+  bool isTrivial() const
+  {
+    return theNodes[0].theKeep && thePredicates.empty();
+  }
+
+protected:
+  csize addNode(const Path& path)
+  {
+    csize node = 0;
+
+    for (csize i = 0; i < path.size(); ++i)
+    {
+      csize child = getChild(theNodes[node], path[i]);
+      if (child == 0)
+      {
+        child = theNodes.size();
+        theNodes[node].theChildren.push_back(std::make_pair(path[i], child));
+        theNodes.push_back(Node());
+      }
+      node = child;
+    }
+    return node;
+  }
+};
+
+
+} // namespace zorba
+
+#endif /* ZORBA_RUNTIME_JSON_SCAN_H */
+/*
+ * Local variables:
+ * mode: c++
+ * End:
+ */
+/* vim:set et sw=2 ts=2: */
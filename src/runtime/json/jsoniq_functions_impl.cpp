@@ -864,8 +864,11 @@ bool JSONParseIterator::nextImpl(
       stream_uri = nullptr;
     }
 
+    // Skipped items are not counted, so the scan is used only when there may
+    // be several of them.
     state->loader_ = new json::loader(
-      *state->theInputStream, true, lStripTopLevelArray
+      *state->theInputStream, true, lStripTopLevelArray,
+      state->theAllowMultiple ? theScan.getp() : nullptr
     );
 
     if ( state->theInput == NULL && theRelativeLocation )
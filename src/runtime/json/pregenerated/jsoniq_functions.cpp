@@ -136,6 +136,7 @@ void JSONParseIterator::serialize(::zorba::serialization::Archiver& ar)
   (NaryBaseIterator<JSONParseIterator, JSONParseIteratorState>*)this);
 
     ar & theRelativeLocation;
+    ar & theScan;
 }
 
 
@@ -32,6 +32,7 @@
 #include "runtime/base/narybase.h"
 #include <context/uri_resolver.h>
 #include "runtime/json/json_loader.h"
+#include "runtime/json/json_scan.h"
 #include "zorbautils/hashset.h"
 #include "zorbautils/hashmap_zstring.h"
 
@@ -168,6 +169,7 @@ class JSONParseIterator : public NaryBaseIterator<JSONParseIterator, JSONParseIt
 { 
 protected:
   QueryLoc theRelativeLocation; //
+  JSONScan_t theScan; //the parts of each top-level object to build, or NULL for all of them
 public:
   SERIALIZABLE_CLASS(JSONParseIterator);
 
@@ -180,10 +182,12 @@ public:
     static_context* sctx,
     const QueryLoc& loc,
     std::vector<PlanIter_t>& children,
-    QueryLoc aRelativeLocation)
+    QueryLoc aRelativeLocation,
+    JSONScan_t aScan)
     : 
     NaryBaseIterator<JSONParseIterator, JSONParseIteratorState>(sctx, loc, children),
-    theRelativeLocation(aRelativeLocation)
+    theRelativeLocation(aRelativeLocation),
+    theScan(aScan)
   {}
 
   virtual ~JSONParseIterator();
@@ -48,6 +48,7 @@ void MaterializeIteratorState::init(PlanState& planState)
   PlanIteratorState::init(planState);
 
   theTempSeq = GENV_STORE.createTempSeq(false);
+  theTempSeq->setMemoryAccount(planState.theMemoryAccount);
 }
 
 
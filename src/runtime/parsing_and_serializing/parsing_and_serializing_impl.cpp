@@ -32,6 +32,7 @@
 #include "store/api/store.h"
 #include "store/api/item.h"
 #include "store/api/item_factory.h"
+#include "store/api/memory_account.h"
 
 #include "system/globalenv.h"
 
@@ -87,6 +88,7 @@ bool FnParseXmlIterator::nextImpl(store::Item_t& result, PlanState& planState) c
       store::LoadProperties loadProps;
       loadProps.setStoreDocument(false);
       loadProps.setUseCachedDocument(false);
+      loadProps.setProjection(theProjection.getp());
       result = lStore.loadDocument(baseUri, docUri, *is, loadProps);
     }
     catch (const ZorbaException& e)
@@ -98,6 +100,9 @@ bool FnParseXmlIterator::nextImpl(store::Item_t& result, PlanState& planState) c
       throw xe;
     }
 
+    if (planState.theMemoryAccount)
+      planState.theMemoryAccount->recordTree(result.getp());
+
     STACK_PUSH(true, state);
   }
 
@@ -40,6 +40,8 @@ void FnParseXmlIterator::serialize(::zorba::serialization::Archiver& ar)
 {
   serialize_baseclass(ar,
   (NaryBaseIterator<FnParseXmlIterator, PlanIteratorState>*)this);
+
+    ar & theProjection;
 }
 
 
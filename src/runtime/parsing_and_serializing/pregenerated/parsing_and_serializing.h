@@ -30,6 +30,7 @@
 
 
 #include "runtime/base/narybase.h"
+#include "store/api/doc_projection.h"
 
 
 namespace zorba {
@@ -40,6 +41,8 @@ namespace zorba {
  */
 class FnParseXmlIterator : public NaryBaseIterator<FnParseXmlIterator, PlanIteratorState>
 { 
+protected:
+  store::DocProjection_t theProjection; //the parts of the document to build, or NULL for all of it
 public:
   SERIALIZABLE_CLASS(FnParseXmlIterator);
 
@@ -51,9 +54,11 @@ public:
   FnParseXmlIterator(
     static_context* sctx,
     const QueryLoc& loc,
-    std::vector<PlanIter_t>& children)
+    std::vector<PlanIter_t>& children,
+    store::DocProjection_t aProjection)
     : 
-    NaryBaseIterator<FnParseXmlIterator, PlanIteratorState>(sctx, loc, children)
+    NaryBaseIterator<FnParseXmlIterator, PlanIteratorState>(sctx, loc, children),
+    theProjection(aProjection)
   {}
 
   virtual ~FnParseXmlIterator();
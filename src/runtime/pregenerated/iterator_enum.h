@@ -74,6 +74,7 @@
   TYPE_ImplicitTimezoneIterator,
   TYPE_DefaultCollationIterator,
   TYPE_CsvParseIterator,
+  TYPE_CsvParseFileIterator,
   TYPE_CsvSerializeIterator,
   TYPE_CurrentDate,
   TYPE_CurrentDateTime,
@@ -1177,6 +1177,8 @@ void FnDocIterator::serialize(::zorba::serialization::Archiver& ar)
 {
   serialize_baseclass(ar,
   (NaryBaseIterator<FnDocIterator, PlanIteratorState>*)this);
+
+    ar & theProjection;
 }
 
 
@@ -1414,6 +1416,12 @@ FnUnparsedTextLinesIterator::~FnUnparsedTextLinesIterator() {}
 
 FnUnparsedTextLinesIteratorState::FnUnparsedTextLinesIteratorState() {}
 
+FnUnparsedTextLinesIteratorState::~FnUnparsedTextLinesIteratorState() {}
+
+
+void FnUnparsedTextLinesIteratorState::init(PlanState& planState) {
+  PlanIteratorState::init(planState);
+}
 
 zstring FnUnparsedTextLinesIterator::getNameAsString() const {
   return "fn:unparsed-text-lines";
@@ -34,6 +34,8 @@
 #include "runtime/base/narybase.h"
 #include "runtime/core/path_iterators.h"
 #include "zorbatypes/integer.h"
+#include "store/util/string_chunk_reader.h"
+#include "store/api/doc_projection.h"
 
 
 namespace zorba {
@@ -1274,6 +1276,8 @@ public:
  */
 class FnDocIterator : public NaryBaseIterator<FnDocIterator, PlanIteratorState>
 { 
+protected:
+  store::DocProjection_t theProjection; //the parts of the document to build, or NULL for all of it
 public:
   SERIALIZABLE_CLASS(FnDocIterator);
 
@@ -1285,9 +1289,11 @@ public:
   FnDocIterator(
     static_context* sctx,
     const QueryLoc& loc,
-    std::vector<PlanIter_t>& children)
+    std::vector<PlanIter_t>& children,
+    store::DocProjection_t aProjection)
     : 
-    NaryBaseIterator<FnDocIterator, PlanIteratorState>(sctx, loc, children)
+    NaryBaseIterator<FnDocIterator, PlanIteratorState>(sctx, loc, children),
+    theProjection(aProjection)
   {}
 
   virtual ~FnDocIterator();
@@ -1502,8 +1508,7 @@ public:
 class FnUnparsedTextLinesIteratorState : public PlanIteratorState
 {
 public:
-  std::unique_ptr<std::istream, StreamReleaser>* theStream; //the current stream
-   internal::StreamResource* theStreamResource; //the current iterator
+  store::StringChunkReader theReader; //reads the lines of the document
 
   FnUnparsedTextLinesIteratorState();
 
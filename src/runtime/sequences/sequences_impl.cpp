@@ -58,6 +58,7 @@
 #include <store/api/pul.h>
 
 #include <context/static_context.h>
+#include <context/dynamic_context.h>
 
 #include "zorbautils/hashset_structured_itemh.h"
 #include "zorbautils/hashset_atomic_itemh.h"
@@ -1521,13 +1522,27 @@ static void loadDocument(
     static_context* aSctx,
     PlanState& aPlanState,
     QueryLoc const& loc,
+    const store::DocProjection* aProjection,
     store::Item_t& oResult)
 {
   // Normalize input to handle filesystem paths, etc.
   zstring lNormUri;
   normalizeInputUri(aUri, aSctx, loc, &lNormUri);
 
-  // See if this (normalized) URI is already loaded in the store.
+  // A projected document is not added to the store, but it is remembered by
+  // the dynamic context, so that every call returns the same document node.
+  dynamic_context* lDctx = aPlanState.theGlobalDynCtx;
+
+  if (aProjection != NULL)
+  {
+    oResult = lDctx->getProjectedDocument(lNormUri, aProjection);
+
+    if (oResult != NULL)
+      return;
+  }
+
+  // See if this (normalized) URI is already loaded in the store. If so, it
+  // is used even if only a projection of it was needed.
   try 
   {
     oResult = GENV_STORE.getDocument(lNormUri);
@@ -1543,9 +1558,10 @@ static void loadDocument(
 
   // Prepare a LoadProperties for loading the stream into the store
   store::LoadProperties lLoadProperties;
-  lLoadProperties.setStoreDocument(true);
+  lLoadProperties.setStoreDocument(aProjection == NULL);
   lLoadProperties.setDTDValidate( aSctx->is_feature_set( feature::dtd ) );
   lLoadProperties.setBaseUri(lNormUri);
+  lLoadProperties.setProjection(aProjection);
 
   // Resolve URI to a stream
   zstring lErrorMessage;
@@ -1592,6 +1608,9 @@ static void loadDocument(
   {
     throw XQUERY_EXCEPTION(err::FODC0002, ERROR_PARAMS( aUri ), ERROR_LOC(loc));
   }
+
+  if (aProjection != NULL)
+    lDctx->bindProjectedDocument(lNormUri, aProjection, oResult);
 }
 
 
@@ -1605,7 +1624,7 @@ bool FnDocIterator::nextImpl(store::Item_t& result, PlanState& planState) const
   if (consumeNext(uriItem, theChildren[0].getp(), planState))
   {
     uriItem->getStringValue2(uriString);
-    loadDocument(uriString, theSctx, planState, loc, result);
+    loadDocument(uriString, theSctx, planState, loc, theProjection.getp(), result);
     STACK_PUSH(true, state);
   } // return empty sequence if input is the empty sequence
 
@@ -1628,7 +1647,7 @@ bool FnDocAvailableIterator::nextImpl(store::Item_t& result, PlanState& planStat
     {
       zstring uriString;
       uriItem->getStringValue2(uriString);
-      loadDocument(uriString, theSctx, planState, loc, doc);
+      loadDocument(uriString, theSctx, planState, loc, NULL, doc);
     }
     catch (ZorbaException& e)
     {
@@ -1841,26 +1860,14 @@ bool FnUnparsedTextAvailableIterator::nextImpl(store::Item_t& result, PlanState&
 /*******************************************************************************
   14.8.6 fn:unparsed-text-lines
 ********************************************************************************/
-FnUnparsedTextLinesIteratorState::~FnUnparsedTextLinesIteratorState()
-{
-  delete theStream;
-  theStream = 0;
-  theStreamResource = 0;
-}
-
 bool FnUnparsedTextLinesIterator::nextImpl(store::Item_t& result, PlanState& planState) const
 {
   store::Item_t uriItem;
   store::Item_t encodingItem;
-  store::Item_t streamItem;
-  zstring streamLine;
+  store::Item_t textItem;
+  zstring line;
   zstring uriString;
   zstring encodingString("UTF-8");
-  zstring lNormUri;
-  zstring lErrorMessage;
-  std::unique_ptr<internal::Resource> lResource;
-  StreamReleaser lStreamReleaser;
-  std::unique_ptr<zorba::URI> lUri;
 
   FnUnparsedTextLinesIteratorState* state;
   DEFAULT_STACK_INIT(FnUnparsedTextLinesIteratorState, state, planState);
@@ -1876,64 +1883,33 @@ bool FnUnparsedTextLinesIterator::nextImpl(store::Item_t& result, PlanState& pla
     encodingItem->getStringValue2(encodingString);
   }
 
-  //Normalize input to handle filesystem paths, etc.
   uriItem->getStringValue2(uriString);
-  normalizeInputUri(uriString, theSctx, loc, &lNormUri);
+  readDocument(uriString, encodingString, theSctx, planState, loc, textItem);
 
-  //Check for a fragment identifier
-  //Create a zorba::URI for validating if it contains a fragment  
-  lUri.reset(new zorba::URI(lNormUri));
-  if (lUri->get_encoded_fragment() != "")
-  {
-    throw XQUERY_EXCEPTION(err::FOUT1170, ERROR_PARAMS(uriString), ERROR_LOC(loc));    
-  }
+  //
+  // Read the document a chunk at a time so that only the current line is ever
+  // in memory. The text item is not used anywhere else, so even a non-seekable
+  // stream can be consumed.
+  //
+  state->theReader.init(textItem.getp(),
+                        true,
+                        store::StringChunkReader::DEFAULT_CHUNK_SIZE,
+                        true);
 
-  //Resolve URI to stream
-  lResource = theSctx->resolve_uri
-    (lNormUri, internal::EntityData::SOME_CONTENT, lErrorMessage);
-
-  state->theStreamResource =
-    dynamic_cast<internal::StreamResource*>(lResource.get());
-
-  if (state->theStreamResource == NULL)
-    throw XQUERY_EXCEPTION(err::FOUT1170, ERROR_PARAMS(uriString), ERROR_LOC(loc));
-
-  lStreamReleaser = state->theStreamResource->getStreamReleaser();
-  state->theStream = new std::unique_ptr<std::istream, StreamReleaser> (state->theStreamResource->getStream(), lStreamReleaser);
-  state->theStreamResource->setStreamReleaser(nullptr);
-
-  //check if encoding is needed
-  if (transcode::is_necessary(encodingString.c_str()))
+  while (state->theReader.nextLine(line))
   {
-    if (!transcode::is_supported(encodingString.c_str()))
-    {
-      throw XQUERY_EXCEPTION(err::FOUT1190, ERROR_PARAMS(uriString), ERROR_LOC(loc));
-    }
-    transcode::attach(*state->theStream->get(), encodingString.c_str());
+    STACK_PUSH(GENV_ITEMFACTORY->createString(result, line), state);
   }
 
-  while (state->theStream->get()->good())
-  {
-    getline(*state->theStream->get(), streamLine);
-    STACK_PUSH(GENV_ITEMFACTORY->createString(result, streamLine), state);
-  }
+  state->theReader.clear();
 
   STACK_END(state);
 }
 
-void FnUnparsedTextLinesIteratorState::init(PlanState& planState)
-{
-  PlanIteratorState::init(planState);
-  theStreamResource = 0;
-  theStream = 0;
-}
-
 void FnUnparsedTextLinesIteratorState::reset(PlanState& planState)
 {
   PlanIteratorState::reset(planState);
-  delete theStream;
-  theStream = 0;
-  theStreamResource = 0;
+  theReader.clear();
 }
 
 } // namespace zorba
@@ -578,6 +578,7 @@ MapInsertIterator::nextImpl(
   std::vector<store::Item_t> lKeyAttrs;
   store::Index*              lMap;
   bool                       lPersistent;
+  store::Item_t              lValue;
 
   PlanIteratorState* state;
   DEFAULT_STACK_INIT(PlanIteratorState, state, aPlanState);
@@ -591,50 +592,36 @@ MapInsertIterator::nextImpl(
 
   prepareKeyAttributes(loc, theSctx, lKey, lMap, lKeyAttrs);
 
-  if (lPersistent)
-  {
-    store::Iterator_t lValue
-      = new PlanIteratorWrapper(theChildren[2], aPlanState);
-
-    std::unique_ptr<store::PUL> lPul(GENV_ITEMFACTORY->createPendingUpdateList());
-    lPul->addInsertIntoHashMap(&loc, lName, lKeyAttrs, lValue);
-
-    apply_updates(
-        aPlanState.theCompilerCB,
-        aPlanState.theGlobalDynCtx,
-        theSctx,
-        lPul.get(),
-        loc);
-  }
-  else
+  // map:insert is sequential, so the insertion takes effect immediately, also
+  // for persistent maps. Applying a PUL with a single insert-into-hashmap
+  // primitive would do the same thing as inserting into the map directly,
+  // only much more slowly.
+  while (consumeNext(lValue, theChildren[2], aPlanState))
   {
-    store::Item_t lValue;
-    while (consumeNext(lValue, theChildren[2], aPlanState))
+    if (!lPersistent &&
+        (lValue->isNode() || lValue->isArray() || lValue->isObject()) &&
+        lValue->getCollection() == 0)
     {
-      if ((lValue->isNode() || lValue->isArray() || lValue->isObject())
-          && lValue->getCollection() == 0)
-      {
-        zstring lType = "node";
-        if (lValue->isArray()) lType = "array";
-        else if (lValue->isObject()) lType = "object";
+      zstring lType = "node";
+      if (lValue->isArray()) lType = "array";
+      else if (lValue->isObject()) lType = "object";
 
-        RAISE_ERROR(zerr::ZDDY0042_ITEM_NOT_IN_COLLECTION, loc,
-        ERROR_PARAMS(lName->getLocalName(), lType));
-      }
+      RAISE_ERROR(zerr::ZDDY0042_ITEM_NOT_IN_COLLECTION, loc,
+      ERROR_PARAMS(lName->getLocalName(), lType));
+    }
 
-      std::unique_ptr<store::IndexKey> k(new store::IndexKey());
-      for (size_t i = 0; i < lKeyAttrs.size(); ++i)
-      {
-        k->push_back(lKeyAttrs[i]);
-      }
+    std::unique_ptr<store::IndexKey> k(new store::IndexKey());
+    for (size_t i = 0; i < lKeyAttrs.size(); ++i)
+    {
+      k->push_back(lKeyAttrs[i]);
+    }
 
-      store::IndexKey* lKeyPtr = k.get();
-      if (!lMap->insert(lKeyPtr, lValue))
-      {
-        // the index took the ownership over the key if the index
-        // did _not_ already contain an entry with the same key
-        k.release();
-      }
+    store::IndexKey* lKeyPtr = k.get();
+    if (!lMap->insert(lKeyPtr, lValue))
+    {
+      // the index took the ownership over the key if the index
+      // did _not_ already contain an entry with the same key
+      k.release();
     }
   }
 
@@ -32,6 +32,7 @@
 #include "runtime/base/narybase.h"
 #include "zorbautils/checked_vector.h"
 #include "zorbatypes/schema_types.h"
+#include "store/util/string_chunk_reader.h"
 
 
 namespace zorba {
@@ -882,6 +883,8 @@ public:
   zstring theFlags; //the tokenizing flags
   xs_int start_pos; //the start position
   xs_boolean hasmatched; //flag indicating whether a match was found
+  zstring theSeparator; //the pattern, if it is a literal string
+  store::StringChunkReader theReader; //the streamable input, if split on theSeparator
 
   FnTokenizeIteratorState();
 
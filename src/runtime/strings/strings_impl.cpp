@@ -39,6 +39,7 @@
 
 #include "store/api/item.h"
 #include "store/api/item_factory.h"
+#include "store/util/string_chunk_reader.h"
 
 #include "zorbautils/string_util.h"
 
@@ -450,8 +451,8 @@ bool SubstringIterator::nextImpl(
   store::Item_t stringItem;
   store::Item_t startItem;
   store::Item_t lenItem;
-  zstring strval;
   zstring resStr;
+  csize numChars;
   xs_double start;
   xs_double len;
   xs_int istart;
@@ -462,9 +463,11 @@ bool SubstringIterator::nextImpl(
 
   if (consumeNext(stringItem, theChildren[0].getp(), planState ))
   {
-    stringItem->getStringValue2(strval);
+    // The number of characters (as well as whether the string is all-ASCII)
+    // is cached by the item, so this is O(1) after the first time.
+    numChars = stringItem->getStringLength();
 
-    if (!strval.empty())
+    if (numChars > 0)
     {
       bool startExists = consumeNext(startItem, theChildren[1], planState);
 
@@ -495,33 +498,19 @@ bool SubstringIterator::nextImpl(
         }
         else
         {
-          istart = (xs_int)utf8_string<zstring>(strval).length();
+          istart = (xs_int)numChars;
         }
 
         if( theChildren.size() == 2)
         {
           if (istart <= 0)
           {
-            resStr = strval;
+            stringItem->getStringValue2(resStr);
           }
           else
           {
-            try
-            {
-              resStr = utf8_string<zstring>(strval).substr(istart-1);
-            }
-            catch (...)
-            {
-              zstring::size_type numChars = utf8_string<zstring>(strval).length();
-              if (static_cast<zstring::size_type>(istart) > numChars)
-              {
-                // result is the empty string
-              }
-              else
-              {
-                throw;
-              }
-            }
+            // the result is empty if istart is past the end of the string
+            stringItem->getSubstring(istart - 1, numChars, resStr);
           }
         }
         else
@@ -552,7 +541,7 @@ bool SubstringIterator::nextImpl(
             }
             else
             {
-              ilen = (xs_int)(utf8_string<zstring>(strval).length() - istart + 1);
+              ilen = (xs_int)(numChars - istart + 1);
             }
 
             if( !(start + len).isNaN())
@@ -562,26 +551,11 @@ bool SubstringIterator::nextImpl(
                 if (istart <= 0)
                 {
                   if ((ilen + istart - 1) >= 0)
-                    resStr = utf8_string<zstring>(strval).substr(0,  istart - 1 + ilen);
+                    stringItem->getSubstring(0, istart - 1 + ilen, resStr);
                 }
                 else
                 {
-                  try
-                  {
-                    resStr = utf8_string<zstring>(strval).substr(istart-1, ilen);
-                  }
-                  catch (...)
-                  {
-                    zstring::size_type numChars = utf8_string<zstring>(strval).length();
-                    if (static_cast<zstring::size_type>(istart) > numChars)
-                    {
-                      // result is the empty string
-                    }
-                    else
-                    {
-                      throw;
-                    }
-                  }
+                  stringItem->getSubstring(istart - 1, ilen, resStr);
                 }
               }
             }
@@ -615,7 +589,6 @@ bool SubstringIntOptIterator::nextImpl(
   store::Item_t stringItem;
   store::Item_t startItem;
   store::Item_t lenItem;
-  zstring strval;
   zstring resStr;
   xs_int start;
   xs_int len;
@@ -625,9 +598,7 @@ bool SubstringIntOptIterator::nextImpl(
 
   if (consumeNext(stringItem, theChildren[0].getp(), planState ))
   {
-    stringItem->getStringValue2(strval);
-
-    if (!strval.empty())
+    if (stringItem->getStringLength() > 0)
     {
       bool startExists = consumeNext(startItem, theChildren[1], planState);
 
@@ -654,26 +625,12 @@ bool SubstringIntOptIterator::nextImpl(
       {
         if (start <= 0)
         {
-          resStr = strval;
+          stringItem->getStringValue2(resStr);
         }
         else
         {
-          try
-          {
-            resStr = utf8_string<zstring>(strval).substr(start-1);
-          }
-          catch (...)
-          {
-            zstring::size_type numChars = utf8_string<zstring>(strval).length();
-            if (static_cast<zstring::size_type>(start) > numChars)
-            {
-              // result is the empty string
-            }
-            else
-            {
-              throw;
-            }
-          }
+          // the result is empty if start is past the end of the string
+          stringItem->getSubstring(start - 1, stringItem->getStringLength(), resStr);
         }
       }
       else
@@ -701,26 +658,11 @@ bool SubstringIntOptIterator::nextImpl(
           if (start <= 0)
           {
             if ((len + start - 1) >= 0)
-              resStr = utf8_string<zstring>(strval).substr(0,  start - 1 + len);
+              stringItem->getSubstring(0, start - 1 + len, resStr);
           }
           else
           {
-            try
-            {
-              resStr = utf8_string<zstring>(strval).substr(start-1, len);
-            }
-            catch (...)
-            {
-              zstring::size_type numChars = utf8_string<zstring>(strval).length();
-              if (static_cast<zstring::size_type>(start) > numChars)
-              {
-                // result is the empty string
-              }
-              else
-              {
-                throw;
-              }
-            }
+            stringItem->getSubstring(start - 1, len, resStr);
           }
         }
       }
@@ -741,20 +683,42 @@ STACK_END (state);
   *fn:string-length()                   as xs:integer
   *fn:string-length($arg as xs:string?) as xs:integer
   *_______________________________________________________________________*/
+static csize streamStringLength(store::Item* item)
+{
+  store::StringChunkReader reader;
+  const char* chunk;
+  csize size;
+  csize length = 0;
+
+  reader.init(item);
+
+  while (reader.next(chunk, size))
+    length += utf8::length(chunk, chunk + size);
+
+  return length;
+}
+
+
 bool StringLengthIterator::nextImpl(
     store::Item_t& result,
     PlanState& planState) const
 {
   store::Item_t item;
-  zstring strval;
 
   PlanIteratorState* state;
   DEFAULT_STACK_INIT(PlanIteratorState, state, planState);
 
   if (consumeNext(item, theChildren [0].getp(), planState))
   {
-    item->getStringValue2(strval);
-    STACK_PUSH(GENV_ITEMFACTORY->createInteger(result, xs_integer(utf8::length(strval))), state);
+    STACK_PUSH(
+      GENV_ITEMFACTORY->createInteger(
+        result,
+        xs_integer(item->isStreamable() && item->isSeekable() ?
+                   streamStringLength(item.getp()) :
+                   item->getStringLength())
+      ),
+      state
+    );
   }
   else
   {
@@ -1145,6 +1109,34 @@ bool EscapeHtmlUriIterator::nextImpl(
   *             $arg2       as xs:string?,
   *             $collation  as xs:string) as xs:boolean
   *_______________________________________________________________________*/
+static bool streamContains(store::Item* item, const zstring& pattern)
+{
+  store::StringChunkReader reader;
+  const char* chunk;
+  csize size;
+  zstring window;
+
+  // A match may straddle two chunks, so the last pattern.size() - 1 bytes of
+  // each chunk are searched again together with the next one.
+  const csize keep = pattern.size() - 1;
+
+  reader.init(item);
+
+  while (reader.next(chunk, size))
+  {
+    window.append(chunk, size);
+
+    if (window.find(pattern) != zstring::npos)
+      return true;
+
+    if (window.size() > keep)
+      window.erase(0, window.size() - keep);
+  }
+
+  return false;
+}
+
+
 bool ContainsIterator::nextImpl(
     store::Item_t& result,
     PlanState& planState) const
@@ -1155,13 +1147,21 @@ bool ContainsIterator::nextImpl(
   bool resBool = false;
   zstring arg1;
   zstring arg2;
+  XQPCollator* coll;
+  bool streaming = false;
 
   PlanIteratorState* state;
   DEFAULT_STACK_INIT(PlanIteratorState, state, planState);
 
   if (consumeNext(item0, theChildren[0].getp(), planState ))
   {
-    item0->getStringValue2(arg1);
+    // A seekable streamable string is searched chunk by chunk instead. A
+    // non-seekable one is materialized, since it can be read only once but
+    // may be used again after this call.
+    streaming = (item0->isStreamable() && item0->isSeekable());
+
+    if (!streaming)
+      item0->getStringValue2(arg1);
   }
 
   if (consumeNext(item1, theChildren[1].getp(), planState ))
@@ -1173,7 +1173,7 @@ bool ContainsIterator::nextImpl(
   {
     STACK_PUSH( GENV_ITEMFACTORY->createBoolean(result, true), state );
   }
-  else if (arg1.empty())
+  else if (arg1.empty() && !streaming)
   {
     STACK_PUSH( GENV_ITEMFACTORY->createBoolean(result, false), state );
   }
@@ -1181,14 +1181,28 @@ bool ContainsIterator::nextImpl(
   {
     if (theChildren.size() == 2)
     {
-      resBool = (arg1.find(arg2) != zstring::npos);
+      if (streaming)
+        resBool = streamContains(item0.getp(), arg2);
+      else
+        resBool = (arg1.find(arg2) != zstring::npos);
     }
     else
     {
       if (consumeNext(itemColl, theChildren[2].getp(), planState ))
       {
-        XQPCollator* coll = theSctx->get_collator(itemColl->getStringValue().str(), loc);
-        resBool = (utf8::find(arg1, arg2, coll) != zstring::npos);
+        coll = theSctx->get_collator(itemColl->getStringValue().str(), loc);
+
+        if (streaming && coll->doMemCmp())
+        {
+          resBool = streamContains(item0.getp(), arg2);
+        }
+        else
+        {
+          if (streaming)
+            item0->getStringValue2(arg1);
+
+          resBool = (utf8::find(arg1, arg2, coll) != zstring::npos);
+        }
       }
     }
     STACK_PUSH( GENV_ITEMFACTORY->createBoolean(result, resBool), state );
@@ -1706,6 +1720,70 @@ void FnTokenizeIteratorState::reset(PlanState& planState)
   hasmatched = false;
   thePattern.clear();
   theFlags.clear();
+  theSeparator.clear();
+  theReader.clear();
+}
+
+
+/**
+ * Checks whether the given XQuery regular expression, with the given flags,
+ * matches only the literal string it denotes (possibly using single-character
+ * escapes like "\|" or "\n"). If so, returns that string in literal.
+ */
+static bool getLiteralPattern(
+    const zstring& pattern,
+    const zstring& flags,
+    zstring& literal)
+{
+  bool isQuoted = false;
+
+  for (zstring::const_iterator i = flags.begin(); i != flags.end(); ++i)
+  {
+    switch (*i)
+    {
+    case 'q': isQuoted = true; break;
+    case 'm':
+    case 's': break;                    // affect only '^', '$', and '.'
+    default : return false;             // 'i' and 'x' do change the match
+    }
+  }
+
+  if (isQuoted)
+  {
+    literal = pattern;
+    return true;
+  }
+
+  literal.clear();
+  for (zstring::const_iterator i = pattern.begin(); i != pattern.end(); ++i)
+  {
+    switch (*i)
+    {
+    case '.': case '^': case '$': case '|': case '?': case '*': case '+':
+    case '(': case ')': case '[': case ']': case '{': case '}':
+      return false;
+    case '\\':
+      if (++i == pattern.end())
+        return false;
+      switch (*i)
+      {
+      case 'n': literal += '\n'; break;
+      case 'r': literal += '\r'; break;
+      case 't': literal += '\t'; break;
+      case '\\': case '|': case '.': case '-': case '^': case '?': case '*':
+      case '+': case '{': case '}': case '(': case ')': case '[': case ']':
+      case '$':
+        literal += *i;
+        break;
+      default:                          // character class escape, e.g. "\d"
+        return false;
+      }
+      break;
+    default:
+      literal += *i;
+    }
+  }
+  return true;
 }
 
 
@@ -1714,17 +1792,14 @@ bool FnTokenizeIterator::nextImpl(
     PlanState& planState) const
 {
   zstring pattern, token;
-  store::Item_t item;
+  store::Item_t input, item;
   bool tmp;
   unicode::string u_string;
 
   FnTokenizeIteratorState* state;
   DEFAULT_STACK_INIT(FnTokenizeIteratorState, state, planState);
 
-  if (consumeNext(item, theChildren[0].getp(), planState))
-  {
-    item->getStringValue2(state->theString);
-  }
+  consumeNext(input, theChildren[0].getp(), planState);
 
   if (!consumeNext(item, theChildren[1].getp(), planState))
     ZORBA_ASSERT(false);
@@ -1755,38 +1830,60 @@ bool FnTokenizeIterator::nextImpl(
       err::FORX0003, ERROR_PARAMS( pattern ), ERROR_LOC( loc )
     );
 
-
-  while ((xs_unsignedInt)state->start_pos < state->theString.length ())
+  //
+  // Split a streamable input on a literal separator as it is being read
+  // rather than materializing it. A non-seekable input is materialized, since
+  // it can be read only once but may be used again after this call.
+  //
+  if (input && input->isStreamable() && input->isSeekable() &&
+      getLiteralPattern(pattern, state->theFlags, state->theSeparator))
   {
-    try
-    {
-      unicode::regex re;
-      //
-      // The RE needs to be compiled every time due to the weird stack macros.
-      //
-      re.compile( state->thePattern, state->theFlags );
-      unicode::string u_token;
-      bool const got_next = re.next_token(
-        state->theString, &state->start_pos, &u_token, &state->hasmatched
-      );
-      utf8::to_string( u_token, &token );
-      if ( !got_next )
-        break;
-    }
-    catch(XQueryException& ex)
+    state->theReader.init(input.getp());
+
+    while (state->theReader.nextToken(state->theSeparator, token))
     {
-      set_source( ex, loc );
-      throw;
+      STACK_PUSH(GENV_ITEMFACTORY->createString(result, token), state);
     }
 
-    STACK_PUSH(GENV_ITEMFACTORY->createString(result, token), state);
+    state->theReader.clear();
   }
-
-  if(state->hasmatched)
+  else
   {
-    //the last token is empty (is after the last match)
-    token.clear();
-    STACK_PUSH(GENV_ITEMFACTORY->createString(result, token), state);
+    if (input)
+      input->getStringValue2(state->theString);
+
+    while ((xs_unsignedInt)state->start_pos < state->theString.length ())
+    {
+      try
+      {
+        unicode::regex re;
+        //
+        // The RE needs to be compiled every time due to the weird stack macros.
+        //
+        re.compile( state->thePattern, state->theFlags );
+        unicode::string u_token;
+        bool const got_next = re.next_token(
+          state->theString, &state->start_pos, &u_token, &state->hasmatched
+        );
+        utf8::to_string( u_token, &token );
+        if ( !got_next )
+          break;
+      }
+      catch(XQueryException& ex)
+      {
+        set_source( ex, loc );
+        throw;
+      }
+
+      STACK_PUSH(GENV_ITEMFACTORY->createString(result, token), state);
+    }
+
+    if(state->hasmatched)
+    {
+      //the last token is empty (is after the last match)
+      token.clear();
+      STACK_PUSH(GENV_ITEMFACTORY->createString(result, token), state);
+    }
   }
   STACK_END(state);
 }
@@ -0,0 +1,340 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "stdafx.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "sampler.h"
+
+#include "util/json_util.h"
+
+using namespace std;
+
+namespace zorba
+{
+
+/*******************************************************************************
+
+********************************************************************************/
+Sampler::Sampler(unsigned long aInterval)
+  :
+  theInterval(aInterval)
+{
+  theTimer.start();
+}
+
+
+/*******************************************************************************
+  The main function of the sampler thread. It runs until the sampler is
+  terminated, which can happen only while the thread is suspended, so a sample
+  is never left half-recorded.
+********************************************************************************/
+void Sampler::run()
+{
+  while (true)
+  {
+    suspend(theInterval);
+
+    takeSample();
+  }
+}
+
+
+void Sampler::finish()
+{
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void Sampler::takeSample()
+{
+  uint32_t depth = theSampleStack.theDepth.load(std::memory_order_acquire);
+
+  if (depth > SampleStack::MAX_DEPTH)
+    depth = SampleStack::MAX_DEPTH;
+
+  Stack stack;
+  stack.reserve(depth);
+
+  for (uint32_t i = 0; i < depth; ++i)
+  {
+    const PlanIterator* frame =
+    theSampleStack.theFrames[i].load(std::memory_order_relaxed);
+
+    if (frame != NULL)
+      stack.push_back(frame);
+  }
+
+  std::pair<std::map<Stack, csize>::iterator, bool> ite =
+  theStackIds.insert(std::pair<Stack, csize>(stack, theStacks.size()));
+
+  if (ite.second)
+    theStacks.push_back(&ite.first->first);
+
+  theSamples.push_back(Sample(theTimer.elapsed(), ite.first->second));
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+std::string Sampler::getFrameName(const PlanIterator* iter)
+{
+  return iter->getNameAsString().str();
+}
+
+
+std::string Sampler::getFrameLocation(const PlanIterator* iter)
+{
+  const QueryLoc& loc = iter->getLocation();
+
+  std::ostringstream os;
+  if (!loc.getFilename().empty())
+    os << loc.getFilename() << ':';
+  os << loc.getLineBegin() << ':' << loc.getColumnBegin();
+  return os.str();
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void Sampler::print(std::ostream& os, Zorba_sample_format_t format) const
+{
+  switch (format)
+  {
+  case SAMPLE_FORMAT_COLLAPSED:
+    printCollapsed(os);
+    break;
+  case SAMPLE_FORMAT_TABLE:
+    printTable(os);
+    break;
+  case SAMPLE_FORMAT_TRACE:
+    printTrace(os);
+    break;
+  default:
+    break;
+  }
+}
+
+
+/*******************************************************************************
+  Prints one line per distinct stack, with the frames separated by ';' and
+  followed by the number of samples of the stack. This is the input format of
+  flamegraph.pl and of most other flame graph tools. Samples taken while no
+  iterator was running (e.g. while the serializer was writing out an item) are
+  attributed to a "(no iterator)" frame.
+********************************************************************************/
+void Sampler::printCollapsed(std::ostream& os) const
+{
+  std::vector<csize> counts(theStacks.size(), 0);
+
+  for (csize i = 0; i < theSamples.size(); ++i)
+    ++counts[theSamples[i].theStack];
+
+  for (csize i = 0; i < theStacks.size(); ++i)
+  {
+    const Stack& stack = *theStacks[i];
+
+    if (stack.empty())
+      os << "(no iterator)";
+
+    for (csize j = 0; j < stack.size(); ++j)
+    {
+      if (j > 0)
+        os << ';';
+      os << getFrameName(stack[j]) << " (" << getFrameLocation(stack[j]) << ')';
+    }
+
+    os << ' ' << counts[i] << std::endl;
+  }
+}
+
+
+/*******************************************************************************
+  The number of samples in which an iterator was the innermost running one
+  (self) or was running at all (total).
+********************************************************************************/
+namespace
+{
+
+struct IterTimes
+{
+  const PlanIterator  * theIter;
+  csize                 theSelf;
+  csize                 theTotal;
+
+  IterTimes(const PlanIterator* iter) : theIter(iter), theSelf(0), theTotal(0) {}
+
+  bool operator<(const IterTimes& other) const
+  {
+    return (theTotal > other.theTotal ||
+            (theTotal == other.theTotal && theSelf > other.theSelf));
+  }
+};
+
+}
+
+
+/*******************************************************************************
+  Prints, for each iterator that was sampled, its self and total time, hottest
+  first. The times are estimated as the number of samples times the sampling
+  interval.
+********************************************************************************/
+void Sampler::printTable(std::ostream& os) const
+{
+  std::vector<csize> counts(theStacks.size(), 0);
+
+  for (csize i = 0; i < theSamples.size(); ++i)
+    ++counts[theSamples[i].theStack];
+
+  std::vector<IterTimes> times;
+  std::map<const PlanIterator*, csize> positions;
+
+  for (csize i = 0; i < theStacks.size(); ++i)
+  {
+    const Stack& stack = *theStacks[i];
+
+    // An iterator may be on a stack more than once (e.g. in a recursive UDF),
+    // but it counts only once towards its total.
+    std::vector<const PlanIterator*> seen;
+
+    for (csize j = 0; j < stack.size(); ++j)
+    {
+      std::pair<std::map<const PlanIterator*, csize>::iterator, bool> ite =
+      positions.insert(std::pair<const PlanIterator*, csize>(stack[j],
+                                                             times.size()));
+      if (ite.second)
+        times.push_back(IterTimes(stack[j]));
+
+      IterTimes& iterTimes = times[ite.first->second];
+
+      if (std::find(seen.begin(), seen.end(), stack[j]) == seen.end())
+      {
+        iterTimes.theTotal += counts[i];
+        seen.push_back(stack[j]);
+      }
+
+      if (j == stack.size() - 1)
+        iterTimes.theSelf += counts[i];
+    }
+  }
+
+  std::stable_sort(times.begin(), times.end());
+
+  double const numSamples = static_cast<double>(theSamples.size());
+
+  os << theSamples.size() << " samples taken every " << theInterval << " ms"
+     << std::endl
+     << std::setw(10) << "self ms" << std::setw(8) << "self %"
+     << std::setw(10) << "total ms" << std::setw(8) << "total %"
+     << "  iterator (location)" << std::endl;
+
+  std::ios::fmtflags const flags = os.flags();
+  std::streamsize const precision = os.precision();
+
+  os << std::fixed << std::setprecision(1);
+
+  for (csize i = 0; i < times.size(); ++i)
+  {
+    const IterTimes& iterTimes = times[i];
+
+    os << std::setw(10) << double(iterTimes.theSelf * theInterval)
+       << std::setw(8) << 100.0 * iterTimes.theSelf / numSamples
+       << std::setw(10) << double(iterTimes.theTotal * theInterval)
+       << std::setw(8) << 100.0 * iterTimes.theTotal / numSamples
+       << "  " << getFrameName(iterTimes.theIter)
+       << " (" << getFrameLocation(iterTimes.theIter) << ')' << std::endl;
+  }
+
+  os.flags(flags);
+  os.precision(precision);
+}
+
+
+/*******************************************************************************
+  Prints the samples as a Chrome trace (as loaded by chrome://tracing and
+  similar viewers). An iterator that is on the stack in consecutive samples
+  (at the same depth) becomes a single "complete" event that starts at the
+  first of these samples and ends at the first sample that does not have it.
+********************************************************************************/
+void Sampler::printTrace(std::ostream& os) const
+{
+  std::vector<std::pair<const PlanIterator*, double> > open;
+  bool first = true;
+
+  os << "{\"traceEvents\":[";
+
+  for (csize i = 0; i <= theSamples.size(); ++i)
+  {
+    const Stack* stack = NULL;
+    double time;
+
+    if (i < theSamples.size())
+    {
+      stack = theStacks[theSamples[i].theStack];
+      time = theSamples[i].theTime;
+    }
+    else
+    {
+      time = (theSamples.empty() ? 0 : theSamples.back().theTime + theInterval);
+    }
+
+    csize common = 0;
+    if (stack)
+    {
+      while (common < open.size() && common < stack->size() &&
+             open[common].first == (*stack)[common])
+        ++common;
+    }
+
+    while (open.size() > common)
+    {
+      const PlanIterator* iter = open.back().first;
+      double start = open.back().second;
+      open.pop_back();
+
+      if (!first)
+        os << ',';
+      first = false;
+
+      os << std::endl
+         << "{\"name\":\"" << json::serialize(getFrameName(iter))
+         << "\",\"cat\":\"iterator\",\"ph\":\"X\""
+         << ",\"ts\":" << static_cast<uint64_t>(start * 1000)
+         << ",\"dur\":" << static_cast<uint64_t>((time - start) * 1000)
+         << ",\"pid\":1,\"tid\":1"
+         << ",\"args\":{\"location\":\""
+         << json::serialize(getFrameLocation(iter)) << "\"}}";
+    }
+
+    if (stack)
+    {
+      for (csize j = common; j < stack->size(); ++j)
+        open.push_back(std::make_pair((*stack)[j], time));
+    }
+  }
+
+  os << std::endl << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+}
+
+
+} //namespace zorba
+/* vim:set et sw=2 ts=2: */
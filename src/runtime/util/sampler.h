@@ -0,0 +1,103 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ZORBA_RUNTIME_UTIL_SAMPLER_H
+#define ZORBA_RUNTIME_UTIL_SAMPLER_H
+
+#include <map>
+#include <ostream>
+#include <vector>
+
+#include <zorba/options.h>
+#include <zorba/util/timer.h>
+
+#include "runtime/base/plan_iterator.h"
+
+#include "zorbautils/runnable.h"
+
+namespace zorba
+{
+
+/*******************************************************************************
+  A sampling profiler for the execution of a plan.
+
+  While the plan runs, the sampler thread wakes up every theInterval ms and
+  records a copy of theSampleStack, which the plan iterators maintain through
+  the theSampleStack of their PlanState (see runtime/base/plan_iterator.h).
+  This costs the query thread one push and one pop per iterator call, instead
+  of the two timers that the iterator profile needs.
+
+  The samples are resolved to iterator names and query locations only when
+  they are printed, which must happen after the sampler has been terminated
+  and before the plan is destroyed.
+
+  theStackIds : Maps each distinct stack that was sampled to its position in
+                theStacks.
+  theStacks   : The distinct sampled stacks, outermost iterator first.
+  theSamples  : The time (in ms after the sampler started) and the stack of
+                each sample, in the order they were taken.
+********************************************************************************/
+class Sampler : public Runnable
+{
+protected:
+  typedef std::vector<const PlanIterator*> Stack;
+
+  struct Sample
+  {
+    double  theTime;
+    csize   theStack;
+
+    Sample(double time, csize stack) : theTime(time), theStack(stack) {}
+  };
+
+protected:
+  unsigned long              theInterval;
+  SampleStack                theSampleStack;
+  time::wall::timer          theTimer;
+
+  std::map<Stack, csize>     theStackIds;
+  std::vector<const Stack*>  theStacks;
+  std::vector<Sample>        theSamples;
+
+public:
+  Sampler(unsigned long aInterval);
+
+  SampleStack* getSampleStack() { return &theSampleStack; }
+
+  virtual void run();
+  // Note: this method is not allowed to throw an exception!
+  virtual void finish();
+
+  void print(std::ostream& os, Zorba_sample_format_t format) const;
+
+protected:
+  void takeSample();
+
+  void printCollapsed(std::ostream& os) const;
+
+  void printTable(std::ostream& os) const;
+
+  void printTrace(std::ostream& os) const;
+
+  static std::string getFrameName(const PlanIterator* iter);
+
+  static std::string getFrameLocation(const PlanIterator* iter);
+};
+
+
+} //namespace zorba
+
+#endif /* ZORBA_RUNTIME_UTIL_SAMPLER_H */
+/* vim:set et sw=2 ts=2: */
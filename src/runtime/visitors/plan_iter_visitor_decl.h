@@ -58,6 +58,7 @@ PIV_VISIT_DECL( ExitCatcherIterator );
 PIV_VISIT_DECL( ExitIterator );
 PIV_VISIT_DECL( ExtFunctionCallIterator );
 PIV_VISIT_DECL( FlowCtlIterator );
+PIV_VISIT_DECL( flwor::BatchCallIterator );
 PIV_VISIT_DECL( flwor::CountIterator );
 PIV_VISIT_DECL( flwor::FLWORIterator );
 PIV_VISIT_DECL( flwor::ForIterator );
@@ -65,6 +66,7 @@ PIV_VISIT_DECL( flwor::GroupByIterator );
 PIV_VISIT_DECL( flwor::LetIterator );
 PIV_VISIT_DECL( flwor::OrderByIterator );
 PIV_VISIT_DECL( flwor::OuterForIterator );
+PIV_VISIT_DECL( flwor::ParallelForIterator );
 PIV_VISIT_DECL( flwor::TupleSourceIterator );
 PIV_VISIT_DECL( flwor::TupleStreamIterator );
 PIV_VISIT_DECL( flwor::WhereIterator );
@@ -78,6 +80,7 @@ PIV_VISIT_DECL( FnMinMaxIterator );
 PIV_VISIT_DECL( FollowingAxisIterator );
 PIV_VISIT_DECL( ForVarIterator );
 PIV_VISIT_DECL( FTContainsIterator );
+PIV_VISIT_DECL( FullTextIndexKeysIterator );
 PIV_VISIT_DECL( FunctionItemIterator );
 PIV_VISIT_DECL( GeneralIndexEntryBuilderIterator );
 PIV_VISIT_DECL( GenericArithIterator<AddOperation> );
@@ -86,6 +89,8 @@ PIV_VISIT_DECL( GenericArithIterator<IntegerDivideOperation> );
 PIV_VISIT_DECL( GenericArithIterator<ModOperation> );
 PIV_VISIT_DECL( GenericArithIterator<MultiplyOperation> );
 PIV_VISIT_DECL( GenericArithIterator<SubtractOperation> );
+PIV_VISIT_DECL( HashJoinBuildIterator );
+PIV_VISIT_DECL( HashJoinProbeIterator );
 PIV_VISIT_DECL( HoistIterator );
 PIV_VISIT_DECL( IfThenElseIterator );
 PIV_VISIT_DECL( InsertIterator );
@@ -154,6 +159,7 @@ PIV_VISIT_DECL( TextIterator );
 PIV_VISIT_DECL( TransformIterator );
 PIV_VISIT_DECL( TreatIterator );
 PIV_VISIT_DECL( TryCatchIterator );
+PIV_VISIT_DECL( TwigPathIterator );
 PIV_VISIT_DECL( TypedValueCompareIterator<store::XS_DECIMAL> );
 PIV_VISIT_DECL( TypedValueCompareIterator<store::XS_DOUBLE> );
 PIV_VISIT_DECL( TypedValueCompareIterator<store::XS_FLOAT> );
@@ -70,8 +70,11 @@ class FnMinMaxIterator;
 class FollowingAxisIterator;
 class ForVarIterator;
 class FTContainsIterator;
+class FullTextIndexKeysIterator;
 class FunctionItemIterator;
 class GeneralIndexEntryBuilderIterator;
+class HashJoinBuildIterator;
+class HashJoinProbeIterator;
 class HoistIterator;
 class IfThenElseIterator;
 class InsertIterator;
@@ -121,6 +124,7 @@ class TextIterator;
 class TransformIterator;
 class TreatIterator;
 class TryCatchIterator;
+class TwigPathIterator;
 class UDFunctionCallIterator;
 class UnhoistIterator;
 #ifndef ZORBA_NO_XMLSCHEMA
@@ -135,6 +139,7 @@ class ZorbaSchemaTypeIterator;
 
 namespace flwor
 {
+  class BatchCallIterator;
   class CountIterator;
   class FLWORIterator;
   class ForIterator;
@@ -142,6 +147,7 @@ namespace flwor
   class LetIterator;
   class OrderByIterator;
   class OuterForIterator;
+  class ParallelForIterator;
   class TupleSourceIterator;
   class TupleStreamIterator;
   class WhereIterator;
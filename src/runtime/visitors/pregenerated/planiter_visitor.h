@@ -137,6 +137,8 @@ namespace zorba{
 
     class CsvParseIterator;
 
+    class CsvParseFileIterator;
+
     class CsvSerializeIterator;
 
     class CurrentDate;
@@ -939,6 +941,9 @@ public:
     virtual void beginVisit ( const CsvParseIterator& ) = 0;
     virtual void endVisit   ( const CsvParseIterator& ) = 0;
 
+    virtual void beginVisit ( const CsvParseFileIterator& ) = 0;
+    virtual void endVisit   ( const CsvParseFileIterator& ) = 0;
+
     virtual void beginVisit ( const CsvSerializeIterator& ) = 0;
     virtual void endVisit   ( const CsvSerializeIterator& ) = 0;
 
@@ -683,6 +683,20 @@ void PrinterVisitor::endVisit( const CsvParseIterator& ) {
 // </CsvParseIterator>
 
 
+// <CsvParseFileIterator>
+void PrinterVisitor::beginVisit( const CsvParseFileIterator& a) {
+  thePrinter.startBeginVisit("CsvParseFileIterator", ++theId);
+  printCommons( &a, theId );
+  thePrinter.endBeginVisit( theId );
+}
+
+void PrinterVisitor::endVisit( const CsvParseFileIterator& ) {
+  thePrinter.startEndVisit();
+  thePrinter.endEndVisit();
+}
+// </CsvParseFileIterator>
+
+
 // <CsvSerializeIterator>
 void PrinterVisitor::beginVisit( const CsvSerializeIterator& a) {
   thePrinter.startBeginVisit("CsvSerializeIterator", ++theId);
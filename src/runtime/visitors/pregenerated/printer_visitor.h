@@ -220,6 +220,9 @@ namespace zorba {
     void beginVisit( const CsvParseIterator& );
     void endVisit  ( const CsvParseIterator& );
 
+    void beginVisit( const CsvParseFileIterator& );
+    void endVisit  ( const CsvParseFileIterator& );
+
     void beginVisit( const CsvSerializeIterator& );
     void endVisit  ( const CsvSerializeIterator& );
 
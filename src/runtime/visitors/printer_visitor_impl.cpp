@@ -30,6 +30,7 @@
 #include "runtime/collections/collections.h"
 #include "runtime/core/apply_updates.h"
 #include "runtime/core/arithmetic_impl.h"
+#include "runtime/core/batch_call_iterator.h"
 #include "runtime/core/constructors.h"
 #include "runtime/core/flwor_iterator.h"
 #include "runtime/core/fncall_iterator.h"
@@ -45,6 +46,7 @@
 #include "runtime/core/internal_operators.h"
 #include "runtime/core/item_iterator.h"
 #include "runtime/core/nodeid_iterators.h"
+#include "runtime/core/parallel_for_iterator.h"
 #include "runtime/core/path_iterators.h"
 #include "runtime/core/sequencetypes.h"
 #include "runtime/core/trycatch.h"
@@ -57,6 +59,7 @@
 #include "runtime/eval/eval.h"
 #include "runtime/hof/dynamic_fncall_iterator.h"
 #include "runtime/hof/function_item_iter.h"
+#include "runtime/indexing/hash_join.h"
 #include "runtime/indexing/index_ddl.h"
 #include "runtime/json/json_constructors.h"
 #include "runtime/misc/materialize.h"
@@ -211,6 +214,7 @@ DEF_VISIT( FnAdjustToTimeZoneIterator_2 )
 DEF_VISIT( FnBooleanIterator )
 DEF_VISIT( FnDateTimeConstructorIterator )
 DEF_VISIT( FnFormatDateTimeIterator )
+DEF_VISIT( FullTextIndexKeysIterator )
 DEF_VISIT( GeneralIndexEntryBuilderIterator )
 DEF_VISIT( HoistIterator )
 DEF_VISIT( IfThenElseIterator )
@@ -570,6 +574,22 @@ void PrinterVisitor::beginVisit( flwor::OuterForIterator const &i ) {
 }
 DEF_END_VISIT( flwor::OuterForIterator )
 
+void PrinterVisitor::beginVisit( flwor::ParallelForIterator const &i ) {
+  thePrinter.startBeginVisit( "ParallelForIterator", ++theId );
+  if ( i.getNumThreads() > 0 )
+    thePrinter.addIntAttribute( "threads", i.getNumThreads() );
+  printCommons( &i, theId );
+  thePrinter.endBeginVisit( theId );
+}
+DEF_END_VISIT( flwor::ParallelForIterator )
+
+void PrinterVisitor::beginVisit( flwor::BatchCallIterator const &i ) {
+  thePrinter.startBeginVisit( "BatchCallIterator", ++theId );
+  printCommons( &i, theId );
+  thePrinter.endBeginVisit( theId );
+}
+DEF_END_VISIT( flwor::BatchCallIterator )
+
 void PrinterVisitor::beginVisit( FnMinMaxIterator const &i ) {
   thePrinter.startBeginVisit( "FnMinMaxIterator", ++theId );
   thePrinter.addAttribute( "type",
@@ -610,6 +630,22 @@ void PrinterVisitor::beginVisit( FunctionItemIterator const &i ) {
 }
 DEF_END_VISIT( FunctionItemIterator )
 
+void PrinterVisitor::beginVisit( HashJoinBuildIterator const &i ) {
+  thePrinter.startBeginVisit( "HashJoinBuildIterator", ++theId );
+  thePrinter.addAttribute( "name", i.getName()->show().str() );
+  printCommons( &i, theId );
+  thePrinter.endBeginVisit( theId );
+}
+DEF_END_VISIT( HashJoinBuildIterator )
+
+void PrinterVisitor::beginVisit( HashJoinProbeIterator const &i ) {
+  thePrinter.startBeginVisit( "HashJoinProbeIterator", ++theId );
+  thePrinter.addAttribute( "name", i.getName()->show().str() );
+  printCommons( &i, theId );
+  thePrinter.endBeginVisit( theId );
+}
+DEF_END_VISIT( HashJoinProbeIterator )
+
 void PrinterVisitor::beginVisit( LetVarIterator const &i ) {
   thePrinter.startBeginVisit( "LetVarIterator", ++theId );
 #ifndef NDEBUG
@@ -672,6 +708,14 @@ void PrinterVisitor::beginVisit( TreatIterator const &i ) {
 }
 DEF_END_VISIT( TreatIterator )
 
+void PrinterVisitor::beginVisit( TwigPathIterator const &i ) {
+  thePrinter.startBeginVisit( "TwigPathIterator", ++theId );
+  printCommons( &i, theId );
+  thePrinter.addAttribute( "pattern", i.getPattern().str() );
+  thePrinter.endBeginVisit( theId );
+}
+DEF_END_VISIT( TwigPathIterator )
+
 void PrinterVisitor::beginVisit( UDFunctionCallIterator const &i ) {
   thePrinter.startBeginVisit( "UDFunctionCallIterator", ++theId );
   if ( i.theUDF->getSignature().getName() )
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ZORBA_STORE_API_DOC_PROJECTION
+#define ZORBA_STORE_API_DOC_PROJECTION
+
+#include <vector>
+
+#include "zorbatypes/rchandle.h"
+#include "zorbatypes/zstring.h"
+
+#include "store/api/shared_types.h"
+#include "store/api/item.h"
+
+
+namespace zorba
+{
+
+namespace store
+{
+
+/*******************************************************************************
+  Describes the part of a document that a query can reach, so that the loader
+  needs to build only that part.
+
+  A projection is a set of paths. Each path is a sequence of steps, evaluated
+  starting from the document node. A child or descendant step selects the
+  element children or descendants (of the nodes selected by the previous step)
+  that have the step's name, or any name if theName is NULL. An attribute step
+  may only be the last step of a path; it says that only the attributes of the
+  elements selected by the previous step are reached.
+
+  A projected document contains:
+  - the full subtree of each element selected by the last step of a path,
+  - each element whose attributes are reached by an attribute step, with its
+    attributes but without its children,
+  - the elements on the way from the document node to the above elements, with
+    their attributes, but without any other children.
+  Elements that are kept only because they are on the way to other elements
+  are not reached by the query, so their missing content is never observed.
+
+  A projection must have at least one path, and every path at least one step.
+********************************************************************************/
+class DocProjection : public SimpleRCObject
+{
+public:
+  enum Axis
+  {
+    CHILD,
+    DESCENDANT,
+    ATTRIBUTE
+  };
+
+  struct Step
+  {
+    Axis    theAxis;
+    Item_t  theName;
+
+    Step() : theAxis(CHILD) {}
+
+    Step(Axis axis, const Item_t& name) : theAxis(axis), theName(name) {}
+  };
+
+  typedef std::vector<Step> Path;
+
+protected:
+  std::vector<Path>  thePaths;
+
+public:
+  void addPath(const Path& path) { thePaths.push_back(path); }
+
+  csize numPaths() const { return thePaths.size(); }
+
+  const Path& getPath(csize i) const { return thePaths[i]; }
+
+  std::vector<Path>& getPaths() { return thePaths; }
+
+  zstring toString() const
+  {
+    zstring s;
+    for (csize i = 0; i < thePaths.size(); ++i)
+    {
+      if (i > 0)
+        s += " | ";
+
+      for (csize j = 0; j < thePaths[i].size(); ++j)
+      {
+        const Step& step = thePaths[i][j];
+        s += (step.theAxis == DESCENDANT ? "//" : "/");
+        if (step.theAxis == ATTRIBUTE)
+          s += "@";
+        s += (step.theName == NULL ? zstring("*") : step.theName->getStringValue());
+      }
+    }
+    return s;
+  }
+};
+
+
+} // namespace store
+} // namespace zorba
+
+#endif /* ZORBA_STORE_API_DOC_PROJECTION */
+/*
+ * Local variables:
+ * mode: c++
+ * End:
+ */
+/* vim:set et sw=2 ts=2: */
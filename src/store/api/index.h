@@ -19,6 +19,8 @@
 #include "store/api/shared_types.h"
 #include "store/util/item_vector.h"
 
+#include "zorbatypes/zstring.h"
+
 namespace zorba
 {
 
@@ -86,6 +88,18 @@ typedef rchandle<IndexEntryCreator> IndexEntryCreator_t;
   theSources:
   -----------
   The qnames of the collections accessed by the defining exprs of this index.
+
+  theHasFieldDependencies:
+  ------------------------
+  Whether the keys of each domain item depend only on the fields listed in
+  theFieldDependencies. This is known only for indexes whose domain items are
+  the docs of a collection; the store then does not maintain the index for a
+  JSON object whose updates touch none of these fields.
+
+  theFieldDependencies:
+  ---------------------
+  The names of the fields of the domain items that the keys depend on, sorted
+  and without duplicates.
 ********************************************************************************/
 class IndexSpecification
 {
@@ -104,6 +118,9 @@ public:
 
   std::vector<store::Item_t>     theSources;
 
+  bool                           theHasFieldDependencies;
+  std::vector<zstring>           theFieldDependencies;
+
 public:
   IndexSpecification()
     :
@@ -114,7 +131,8 @@ public:
     theIsSorted(false),
     theIsTemp(false),
     theIsThreadSafe(false),
-    theIsAutomatic(false)
+    theIsAutomatic(false),
+    theHasFieldDependencies(false)
   {
   }
 
@@ -125,6 +143,8 @@ public:
     theCollations.clear();
     theTimezone = 0;
     theIsAutomatic = theIsGeneral = theIsUnique = theIsSorted = theIsTemp = theIsThreadSafe = false;
+    theHasFieldDependencies = false;
+    theFieldDependencies.clear();
   }
 
   void resize(csize numColumns)
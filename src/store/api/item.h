@@ -367,6 +367,27 @@ public:
    */
   virtual const zstring& getString() const;
 
+  /**
+   * Accessor for xs:string and its subtypes.
+   *
+   * @return The number of Unicode characters of the string value.
+   */
+  virtual csize getStringLength() const;
+
+  /**
+   * Accessor for xs:string and its subtypes: gets the substring of the
+   * string value that starts at the given character position.
+   *
+   * @param pos The 0-based position of the first character of the substring.
+   *        If it is not less than the number of characters, the substring is
+   *        empty.
+   * @param len The maximum number of characters of the substring. If fewer
+   *        characters follow \a pos, the substring ends at the end of the
+   *        string.
+   * @param result The string to receive the substring.
+   */
+  virtual void getSubstring(csize pos, csize len, zstring& result) const;
+
   /** Accessor for xs:base64Binary
    */
   virtual const char* getBase64BinaryValue(size_t& size) const;
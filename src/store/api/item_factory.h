@@ -276,6 +276,17 @@ public:
       bool seekable = false,
       bool encoded = false) = 0;
 
+  /**
+   * Create a StreamableBase64BinaryItem which re-uses the stream from another
+   * Streamable*Item, in the same way as createSharedStreamableString().
+   * The encoded flag specifies whether the content of the stream is already
+   * base64 encoded or not.
+   */
+  virtual bool createSharedStreamableBase64Binary(
+      Item_t& result,
+      Item_t& streamable_dependent,
+      bool encoded = false) = 0;
+
   /**
    * Specification: [http://www.w3.org/TR/xmlschema-2/#bool]
    * @param value
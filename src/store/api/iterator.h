@@ -16,6 +16,8 @@
 #ifndef ZORBA_STORE_ITERATOR_H
 #define ZORBA_STORE_ITERATOR_H
 
+#include <vector>
+
 #include "zorbamisc/config/platform.h"
 
 #include "store/api/shared_types.h"
@@ -156,6 +158,43 @@ public:
 };
 
 
+/**
+ * This iterator is used to evaluate a path pattern like //a//b/c, i.e., a
+ * sequence of element name tests, each reached from the previous one (or, for
+ * the first, from the context node) via either the child or the descendant
+ * axis. It returns the element nodes in the subtree of the context node that
+ * match the last name test, in document order and without duplicates. It
+ * implements the interface of a generic iterator, but also offers the
+ * following additional method:
+ *
+ * - An init method that takes as input the context node (a document or element
+ *   node), the names of the steps, and, for each step, whether it uses the
+ *   descendant (rather than the child) axis. There may be at most MAX_STEPS
+ *   steps.
+ */
+class TwigJoinIterator : public Iterator
+{
+public:
+  static const csize MAX_STEPS = 31;
+
+public:
+  virtual ~TwigJoinIterator() { }
+
+  virtual void init(
+      const Item* contextNode,
+      const std::vector<Item_t>& names,
+      const std::vector<bool>& descendantSteps) = 0;
+
+  virtual void open() = 0;
+
+  virtual bool next(Item_t& result) = 0;
+
+  virtual void reset() = 0;
+
+  virtual void close() = 0;
+};
+
+
 /**
  * This iterator is used to iterate over the result of an index probe. The
  * target index is specified when the iterator is created (see iterator_factory.h)
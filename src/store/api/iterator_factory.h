@@ -51,6 +51,13 @@ public:
   virtual AttributesIterator*
   createAttributesIterator() = 0;
 
+  /**
+   * Create an iterator to evaluate a path pattern of element name tests over
+   * the subtree of a document or element node (see TwigJoinIterator).
+   */
+  virtual TwigJoinIterator*
+  createTwigJoinIterator() = 0;
+
 
   /**
    * Create an iterator to iterate over the result of an index probe
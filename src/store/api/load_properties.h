@@ -30,6 +30,8 @@ SYNC_CODE(class Lock;)
 namespace store
 {
 
+class DocProjection;
+
 /**
  * How should the document load be done
  */
@@ -64,7 +66,16 @@ private:
                                 // nodes will not have their parent link set to the 
                                 // the document node. This is used by the parse-fragment
                                 // functions.
-                               
+
+  bool theInternStrings;        // Default true. If set, short text and attribute
+                                // values that repeat within the loaded tree share
+                                // a single item (see zorbautils/string_dictionary.h).
+                                // XML only: the JSON loader, which takes no load
+                                // properties, always interns its keys and strings.
+
+  const DocProjection * theProjection; // Default NULL. If set, only the part of the
+                                // document described by the projection is built
+                                // (see store/api/doc_projection.h). Not owned.
 
 public:
   LoadProperties()
@@ -89,7 +100,9 @@ public:
     theNoCDATA(false),
     theNoXIncludeNodes(false),
     theNoNetworkAccess (false),
-    theCreateDocParentLink(true)
+    theCreateDocParentLink(true),
+    theInternStrings(true),
+    theProjection(NULL)
   {
   }
 
@@ -118,6 +131,8 @@ public:
     theNoCDATA = false;
     theNoXIncludeNodes = false;
     theNoNetworkAccess  = false;
+    theInternStrings = true;
+    theProjection = NULL;
   }
 
   /**
@@ -350,6 +365,26 @@ public:
     return theNoNetworkAccess ;
   }
 
+  // theInternStrings
+  void setInternStrings(bool aInternStrings)
+  {
+    theInternStrings = aInternStrings;
+  }
+  bool getInternStrings() const
+  {
+    return theInternStrings;
+  }
+
+  // theProjection
+  void setProjection(const DocProjection* aProjection)
+  {
+    theProjection = aProjection;
+  }
+  const DocProjection* getProjection() const
+  {
+    return theProjection;
+  }
+
   /**
    * @brief Return a libxml2 options bit-field based, suitable for using
    * while using libxml2 to parse XML. The following members of this
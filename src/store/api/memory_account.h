@@ -0,0 +1,205 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ZORBA_STORE_API_MEMORY_ACCOUNT
+#define ZORBA_STORE_API_MEMORY_ACCOUNT
+
+#include "zorbatypes/rchandle.h"
+
+#include "store/api/shared_types.h"
+#include "store/api/item.h"
+
+#include "util/mem_sizeof.h"
+
+
+namespace zorba
+{
+
+namespace store
+{
+
+/*******************************************************************************
+  Keeps track of the memory used by one execution of a query.
+
+  The runtime buffers of the query (temp sequences, sort tables, group maps)
+  charge the memory of the items they hold when they add them, and release it
+  when they drop them; see MemoryCharge below. theCurrent is the memory they
+  hold right now, and thePeak the most they have held at any time.
+
+  theAllocated is the memory charged so far, plus the memory of the node trees
+  built by the query (by node constructors and fn:parse-xml()). These trees are
+  not charged to theCurrent, because the account does not learn when they are
+  freed.
+
+  If theLimit is not 0 and theCurrent exceeds it, theLimitExceeded is set and
+  so is *theQuitFlag, if given, which makes the query abort at its next
+  iterator call (see PlanIterator::consumeNext()).
+
+  A MemoryAccount is ref-counted, because a temp sequence that is bound to a
+  global variable may outlive the execution that built it.
+********************************************************************************/
+class MemoryAccount : public SimpleRCObject
+{
+protected:
+  uint64_t   theCurrent;
+  uint64_t   thePeak;
+  uint64_t   theAllocated;
+  uint64_t   theLimit;
+  bool       theLimitExceeded;
+  bool     * theQuitFlag;
+
+public:
+  MemoryAccount(uint64_t limit = 0)
+    :
+    theCurrent(0),
+    thePeak(0),
+    theAllocated(0),
+    theLimit(limit),
+    theLimitExceeded(false),
+    theQuitFlag(NULL)
+  {
+  }
+
+  void setQuitFlag(bool* flag) { theQuitFlag = flag; }
+
+  uint64_t getCurrent() const { return theCurrent; }
+
+  uint64_t getPeak() const { return thePeak; }
+
+  uint64_t getAllocated() const { return theAllocated; }
+
+  uint64_t getLimit() const { return theLimit; }
+
+  void setLimit(uint64_t limit) { theLimit = limit; }
+
+  bool isLimitExceeded() const { return theLimitExceeded; }
+
+  void charge(uint64_t bytes)
+  {
+    theCurrent += bytes;
+    theAllocated += bytes;
+
+    if (theCurrent > thePeak)
+    {
+      thePeak = theCurrent;
+
+      if (theLimit != 0 && thePeak > theLimit && !theLimitExceeded)
+      {
+        theLimitExceeded = true;
+
+        if (theQuitFlag)
+          *theQuitFlag = true;
+      }
+    }
+  }
+
+  void release(uint64_t bytes)
+  {
+    theCurrent -= (bytes < theCurrent ? bytes : theCurrent);
+  }
+
+  void recordTree(const Item* root)
+  {
+    theAllocated += ztd::mem_sizeof(*root);
+  }
+
+  /**
+   * Returns the memory charged for holding the given item in a buffer: the
+   * slot of the buffer plus the item itself. A node, object or array counts
+   * without its content, because the content is not owned by the buffer
+   * (and walking it would cost as much as the content each time the same
+   * item is buffered again).
+   */
+  static uint64_t getItemSize(const Item* item)
+  {
+    if (item == NULL)
+      return sizeof(Item*);
+
+    return sizeof(Item*) +
+           (item->isStructuredItem() ?
+            item->dynamic_size() :
+            ztd::mem_sizeof(*item));
+  }
+};
+
+
+/*******************************************************************************
+  The memory that one buffer has charged to a MemoryAccount. Releases all of
+  it when the buffer is cleared or destroyed. Does nothing if no account has
+  been attached to it.
+********************************************************************************/
+class MemoryCharge
+{
+protected:
+  MemoryAccount_t   theAccount;
+  uint64_t          theSize;
+
+public:
+  MemoryCharge() : theSize(0) {}
+
+  ~MemoryCharge() { releaseAll(); }
+
+  void attach(MemoryAccount* account)
+  {
+    releaseAll();
+    theAccount = account;
+  }
+
+  MemoryAccount* getAccount() const { return theAccount.getp(); }
+
+  void charge(uint64_t bytes)
+  {
+    if (theAccount != NULL)
+    {
+      theSize += bytes;
+      theAccount->charge(bytes);
+    }
+  }
+
+  void charge(const Item* item)
+  {
+    if (theAccount != NULL)
+      charge(MemoryAccount::getItemSize(item));
+  }
+
+  void release(uint64_t bytes)
+  {
+    if (theAccount != NULL)
+    {
+      if (bytes > theSize)
+        bytes = theSize;
+      theSize -= bytes;
+      theAccount->release(bytes);
+    }
+  }
+
+  void releaseAll() { release(theSize); }
+
+private:
+  MemoryCharge(const MemoryCharge&);
+  MemoryCharge& operator=(const MemoryCharge&);
+};
+
+
+} // namespace store
+} // namespace zorba
+
+#endif /* ZORBA_STORE_API_MEMORY_ACCOUNT */
+/*
+ * Local variables:
+ * mode: c++
+ * End:
+ */
+/* vim:set et sw=2 ts=2: */
@@ -100,6 +100,12 @@ class ICChecker;
 class Annotation;
 typedef rchandle<Annotation> Annotation_t;
 
+class DocProjection;
+typedef rchandle<DocProjection> DocProjection_t;
+
+class MemoryAccount;
+typedef rchandle<MemoryAccount> MemoryAccount_t;
+
 
 } // namespace store
 } // namespace zorba
@@ -187,18 +187,43 @@ public:
    */
   virtual Iterator_t checkDistinctNodes(Iterator* input) = 0;
 
-#ifdef DATAGUIDE
   /**
+   * Looks up a path in the data guide of a document, i.e., in the summary of
+   * the distinct element and attribute paths of the document that the store
+   * keeps for loaded documents.
    *
+   * @param docUri The uri of the document.
+   * @param contextPath A path of element names, starting below the document
+   *        node.
+   * @param relativePath A path of names that continues the context path. It
+   *        may be empty.
+   * @param isAttrPath Whether the last name of the whole path is an attribute
+   *        name.
+   * @param found Set to true if some node of the document is on the path.
+   * @param unique Set to true if each step of the path selects at most one
+   *        node per node of the previous step.
+   * @param count Set to the number of nodes of the document on the path.
+   * @return false if there is no such document or it has no data guide.
    */
-  bool getPathInfo(
-        const store::Item*               docUri,
-        std::vector<const store::Item*>& contextPath,
-        std::vector<const store::Item*>& relativePath,
-        bool                             isAttrPath,
-        bool&                            found,
-        bool&                            unique);
-#endif
+  virtual bool getPathInfo(
+        const Item* docUri,
+        std::vector<const Item*>& contextPath,
+        std::vector<const Item*>& relativePath,
+        bool isAttrPath,
+        bool& found,
+        bool& unique,
+        csize& count) = 0;
+
+  /**
+   * Uses the data guide of the tree that contains the given node to tell
+   * whether some descendant of the node may be an element with the given name.
+   * If the tree has no data guide, the answer is always true.
+   *
+   * @param node An element or document node.
+   * @param name The element name.
+   * @return false if no descendant of the node has the given name.
+   */
+  virtual bool mayHaveDescendant(const Item* node, const Item* name) = 0;
 
   /* ------------------------ Document Management ---------------------------*/
 
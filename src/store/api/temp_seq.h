@@ -105,6 +105,12 @@ public:
    * 
    */
   virtual Iterator_t getIterator() const = 0;
+
+  /**
+   * Makes the temp sequence charge the memory of the items it holds, now
+   * and from now on, to the given account (see store/api/memory_account.h).
+   */
+  virtual void setMemoryAccount(MemoryAccount* account) = 0;
 	
 #ifndef NDEBUG  
   /** Debugging aid: method to print the contents of the sequence
@@ -21,6 +21,7 @@
 
 #include <zorba/internal/unique_ptr.h>
 #include <zorba/util/base64_util.h>
+#include <zorba/util/mem_streambuf.h>
 
 #include "diagnostics/assert.h"
 #include "diagnostics/xquery_diagnostics.h"
@@ -615,10 +616,16 @@ bool UntypedAtomicItem::equals(
     long timezone,
     const XQPCollator* collation) const
 {
+  const zstring& otherValue = other->getString();
+
+  // Values shared through a StringDictionary have the same string rep.
+  if (theValue.data() == otherValue.data())
+    return true;
+
   if (collation == NULL || collation->doMemCmp())
-    return theValue == other->getString();
+    return theValue == otherValue;
 
-  return (utf8::compare(theValue, other->getString(), collation) == 0);
+  return (utf8::compare(theValue, otherValue, collation) == 0);
 }
 
 
@@ -1910,9 +1917,16 @@ size_t StructuralAnyUriItem::dynamic_size() const
   class StringItem
 ********************************************************************************/
 
+StringItem::~StringItem()
+{
+  delete theCharIndex;
+}
+
+
 size_t StringItem::alloc_size() const
 {
-  return AtomicItem::alloc_size() + ztd::alloc_sizeof( theValue );
+  return AtomicItem::alloc_size() + ztd::alloc_sizeof( theValue ) +
+         ztd::alloc_sizeof( theCharIndex );
 }
 
 size_t StringItem::dynamic_size() const
@@ -1937,10 +1951,16 @@ bool StringItem::equals(
     long timezone,
     const XQPCollator* aCollation) const
 {
+  const zstring& otherValue = other->getString();
+
+  // Values shared through a StringDictionary have the same string rep.
+  if (theValue.data() == otherValue.data())
+    return true;
+
   if (aCollation == NULL || aCollation->doMemCmp())
-    return theValue == other->getString();
+    return theValue == otherValue;
 
-  return (utf8::compare(theValue, other->getString(), aCollation) == 0);
+  return (utf8::compare(theValue, otherValue, aCollation) == 0);
 }
 
 
@@ -1961,6 +1981,120 @@ bool StringItem::getEBV() const
 }
 
 
+void StringItem::getCharInfo(
+    csize& numChars,
+    const std::vector<csize>*& charIndex) const
+{
+  SYNC_CODE(theRCLock.acquire();)
+  numChars = theNumChars;
+  charIndex = theCharIndex;
+  SYNC_CODE(theRCLock.release();)
+
+  if (numChars != UNKNOWN_NUM_CHARS)
+    return;
+
+  const zstring& value = getString();
+  const char* const s = value.data();
+  const csize size = value.size();
+
+  csize const n = utf8::length(s, s + size);
+
+  unique_ptr<std::vector<csize> > index;
+
+  if (n != size && size >= CHAR_INDEX_MIN_SIZE)
+  {
+    index.reset(new std::vector<csize>);
+    index->reserve(n / CHAR_INDEX_STEP + 1);
+
+    for (csize i = 0, b = 0; i < n; ++i)
+    {
+      if (i % CHAR_INDEX_STEP == 0)
+        index->push_back(b);
+
+      b += utf8::char_length(s[b]);
+    }
+  }
+
+  SYNC_CODE(theRCLock.acquire();)
+  if (theNumChars == UNKNOWN_NUM_CHARS)
+  {
+    theNumChars = n;
+    theCharIndex = index.release();
+  }
+  numChars = theNumChars;
+  charIndex = theCharIndex;
+  SYNC_CODE(theRCLock.release();)
+}
+
+
+/*******************************************************************************
+  Returns the byte position in s of the pos-th character of s, given that the
+  charPos-th character of s (with charPos <= pos) starts at bytePos.
+********************************************************************************/
+static csize seekChar(
+    const char* s,
+    const std::vector<csize>* charIndex,
+    csize charPos,
+    csize bytePos,
+    csize pos)
+{
+  if (charIndex && pos - charPos >= StringItem::CHAR_INDEX_STEP)
+  {
+    charPos = pos - pos % StringItem::CHAR_INDEX_STEP;
+    bytePos = (*charIndex)[pos / StringItem::CHAR_INDEX_STEP];
+  }
+
+  for (; charPos < pos; ++charPos)
+    bytePos += utf8::char_length(s[bytePos]);
+
+  return bytePos;
+}
+
+
+csize StringItem::getStringLength() const
+{
+  csize numChars;
+  const std::vector<csize>* charIndex;
+  getCharInfo(numChars, charIndex);
+  return numChars;
+}
+
+
+void StringItem::getSubstring(csize pos, csize len, zstring& result) const
+{
+  csize numChars;
+  const std::vector<csize>* charIndex;
+  getCharInfo(numChars, charIndex);
+
+  if (pos >= numChars || len == 0)
+  {
+    result.clear();
+    return;
+  }
+
+  const zstring& value = getString();
+  const csize end = (len < numChars - pos ? pos + len : numChars);
+
+  if (pos == 0 && end == numChars)
+  {
+    result = value;
+  }
+  else if (numChars == value.size())
+  {
+    result.assign(value.data() + pos, end - pos);
+  }
+  else
+  {
+    const char* const s = value.data();
+    const csize b = seekChar(s, charIndex, 0, 0, pos);
+    const csize e = (end == numChars ?
+                     value.size() :
+                     seekChar(s, charIndex, pos, b, end));
+    result.assign(s + b, e - b);
+  }
+}
+
+
 zstring StringItem::show() const
 {
   zstring res("xs:string(");
@@ -2179,8 +2313,42 @@ void StreamableStringItem::ensureSeekable()
   }
 }
 
+/*******************************************************************************
+  An istream over the materialized value of a StreamableStringItem or a
+  StreamableBase64BinaryItem.
+********************************************************************************/
+class MaterializedStream : public std::istream
+{
+  mem_streambuf theBuf;
+
+public:
+  MaterializedStream(const char* data, size_t size)
+    :
+    std::istream(NULL),
+    theBuf(const_cast<char*>(data), size)
+  {
+    rdbuf(&theBuf);
+  }
+};
+
+
 std::istream& StreamableStringItem::getStream()
 {
+  if (theIsMaterialized && !theIsSeekable)
+  {
+    // The stream has been read into theValue already (and theValue does not
+    // change anymore), so it can still be streamed from there.
+    std::istream* lStream =
+      new MaterializedStream(theValue.data(), theValue.size());
+    if (theStreamReleaser)
+      theStreamReleaser(theIstream);
+    if (!theStreamableDependent.isNull())
+      theStreamableDependent = nullptr;
+    theIstream = lStream;
+    theStreamReleaser = StreamableStringItem::streamReleaser;
+    theIsSeekable = true;
+  }
+
   // a non-seekable stream can only be consumed once
   // we raise an error if getStream is called twice
   // if a query requires a stream to be consumed more than once,
@@ -3574,6 +3742,26 @@ zstring Base64BinaryItem::show() const
 /*******************************************************************************
   class StreamableBase64BinaryItem
 ********************************************************************************/
+StreamableBase64BinaryItem::StreamableBase64BinaryItem(
+    store::SchemaTypeCode t,
+    store::Item_t& aStreamableDependent,
+    bool is_encoded)
+  :
+  Base64BinaryItem(t, is_encoded),
+  theIstream(&aStreamableDependent->getStream()),
+  theIsMaterialized(false),
+  theIsConsumed(false),
+  theIsSeekable(aStreamableDependent->isSeekable()),
+  theStreamReleaser(nullptr),
+  theStreamableDependent(aStreamableDependent)
+{
+  ZORBA_ASSERT(theStreamableDependent->isStreamable());
+
+  // As for StreamableStringItem, the dependent item keeps ownership of the
+  // stream.
+}
+
+
 zstring StreamableBase64BinaryItem::getStringValue() const
 {
   if (!theIsMaterialized)
@@ -3710,6 +3898,20 @@ void StreamableBase64BinaryItem::setStreamReleaser(StreamReleaser aReleaser)
 
 std::istream& StreamableBase64BinaryItem::getStream()
 {
+  if (theIsMaterialized && !theIsSeekable)
+  {
+    // See StreamableStringItem::getStream().
+    std::istream* lStream =
+      new MaterializedStream(theValue.data(), theValue.size());
+    if (theStreamReleaser)
+      theStreamReleaser(theIstream);
+    if (!theStreamableDependent.isNull())
+      theStreamableDependent = nullptr;
+    theIstream = lStream;
+    theStreamReleaser = StreamableBase64BinaryItem::streamReleaser;
+    theIsSeekable = true;
+  }
+
   // a non-seekable stream can only be consumed once
   // we raise an error if getStream is called twice
   // if a query requires a stream to be consumed more than once,
@@ -877,6 +877,24 @@ protected:
 
 /*******************************************************************************
   class StringItem
+
+  theValue    : The UTF-8 encoded string.
+  theNumChars : The number of Unicode characters of theValue, or
+                UNKNOWN_NUM_CHARS if it has not been computed yet. It is
+                computed lazily, the first time that getStringLength() or
+                getSubstring() is invoked. theValue consists of ASCII
+                characters only iff theNumChars is equal to its size in
+                bytes; in that case, character positions are byte positions.
+  theCharIndex: For strings that are not all-ASCII and whose size is at least
+                CHAR_INDEX_MIN_SIZE bytes, theCharIndex[i] is the byte
+                position of the (i * CHAR_INDEX_STEP)-th character of
+                theValue, so the byte position of any character can be found
+                by decoding at most CHAR_INDEX_STEP - 1 characters. NULL
+                otherwise.
+
+  theNumChars and theCharIndex are computed without holding any lock and are
+  then published under theRCLock (unless another thread published them first),
+  since the same item may be accessed by several threads concurrently.
 ********************************************************************************/
 class StringItem : public AtomicItem
 {
@@ -885,20 +903,44 @@ class StringItem : public AtomicItem
   friend class AtomicItemTokenizerCallback;
 #endif /* ZORBA_NO_FULL_TEXT */
 
+public:
+  static const csize UNKNOWN_NUM_CHARS = static_cast<csize>(-1);
+
+  static const csize CHAR_INDEX_MIN_SIZE = 256;
+
+  static const csize CHAR_INDEX_STEP = 64;
+
 protected:
-  zstring theValue;
+  zstring                       theValue;
+
+  mutable csize                 theNumChars;
+  mutable std::vector<csize>  * theCharIndex;
 
 protected:
   StringItem(store::SchemaTypeCode t, zstring& value)
     :
-    AtomicItem(t)
+    AtomicItem(t),
+    theNumChars(UNKNOWN_NUM_CHARS),
+    theCharIndex(NULL)
   {
     theValue.take(value);
   }
 
-  StringItem(store::SchemaTypeCode t) : AtomicItem(t) {}
+  StringItem(store::SchemaTypeCode t)
+    :
+    AtomicItem(t),
+    theNumChars(UNKNOWN_NUM_CHARS),
+    theCharIndex(NULL)
+  {
+  }
+
+  void getCharInfo(
+        csize& numChars,
+        const std::vector<csize>*& charIndex) const;
 
 public:
+  virtual ~StringItem();
+
   size_t alloc_size() const;
   size_t dynamic_size() const;
 
@@ -926,6 +968,10 @@ public:
 
   const zstring& getString() const { return theValue; }
 
+  csize getStringLength() const;
+
+  void getSubstring(csize pos, csize len, zstring& result) const;
+
   virtual zstring show() const;
 
 #ifndef ZORBA_NO_FULL_TEXT
@@ -2387,6 +2433,8 @@ protected:
 
   StreamReleaser theStreamReleaser;
 
+  store::Item_t  theStreamableDependent;
+
 protected:
   StreamableBase64BinaryItem(
       store::SchemaTypeCode t,
@@ -2404,6 +2452,11 @@ protected:
   {
   }
 
+  StreamableBase64BinaryItem(
+      store::SchemaTypeCode t,
+      store::Item_t& streamableDependent,
+      bool is_encoded = false);
+
   void materialize() const;
 
 public:
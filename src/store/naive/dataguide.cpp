@@ -15,8 +15,13 @@
  */
 #include "stdafx.h"
 
+#include <algorithm>
+#include <sstream>
+
 #include "zorbautils/fatal.h"
 #include "dataguide.h"
+#include "atomic_items.h"
+#include "node_items.h"
 
 
 namespace zorba 
@@ -26,6 +31,34 @@ namespace simplestore
 {
 
 
+/*******************************************************************************
+  Count one more node of the tree on this path. "parent" is the parent of that
+  node.
+********************************************************************************/
+void GuideNode::addNode(const XmlNode* parent)
+{
+  if (parent != NULL && parent == theLastParent)
+    theIsUnique = false;
+
+  theLastParent = parent;
+
+  if (theCount++ == 0 && theParent != NULL)
+    theParent->dropDescendantNames();
+}
+
+
+/*******************************************************************************
+  Count one node less on this path.
+********************************************************************************/
+void GuideNode::removeNode()
+{
+  assert(theCount > 0);
+
+  if (--theCount == 0 && theParent != NULL)
+    theParent->dropDescendantNames();
+}
+
+
 /*******************************************************************************
 
 ********************************************************************************/
@@ -33,14 +66,14 @@ void GuideNode::deleteTree()
 {
   assert(theParent == NULL);
 
-  ulong numChildren = this->numChildren();
-  ulong numAttrs = this->numAttributes();
+  csize numChildren = this->numChildren();
+  csize numAttrs = this->numAttributes();
 
   if (numChildren > 0 || numAttrs > 0)
   {
     ElementGuideNode* node = reinterpret_cast<ElementGuideNode*>(this);
 
-    for (ulong i = 0; i < numChildren; i++)
+    for (csize i = 0; i < numChildren; i++)
     {
       GuideNode* child = node->theChildren[i];
       assert(child->theParent == this);
@@ -48,7 +81,7 @@ void GuideNode::deleteTree()
       child->deleteTree();
     }
 
-    for (ulong i = 0; i < numAttrs; i++)
+    for (csize i = 0; i < numAttrs; i++)
     {
       GuideNode* attr = node->theAttributes[i];
       assert(attr->theParent == this);
@@ -60,6 +93,18 @@ void GuideNode::deleteTree()
 }
 
 
+/*******************************************************************************
+
+********************************************************************************/
+AttributeGuideNode::AttributeGuideNode(ElementGuideNode* parent, store::Item_t& name)
+  :
+  GuideNode(parent, name)
+{
+  if (parent)
+    parent->theAttributes.push_back(this);
+}
+
+
 /*******************************************************************************
 
 ********************************************************************************/
@@ -68,7 +113,8 @@ void AttributeGuideNode::getPathInfo(
     std::vector<const store::Item*>& relPath,
     bool                             attrPath,
     bool&                            found,
-    bool&                            unique)
+    bool&                            unique,
+    csize&                           count)
 {
   ZORBA_FATAL(0, "");
 }
@@ -76,42 +122,69 @@ void AttributeGuideNode::getPathInfo(
 
 /*******************************************************************************
 
+********************************************************************************/
+std::string AttributeGuideNode::show(ulong depth) const
+{
+  std::stringstream str;
+
+  if (depth > 0)
+  {
+    std::string indent(depth, ' ');
+    str << indent;
+  }
+
+  str << "@" << theName->getStringValue() << " count=" << theCount
+      << std::endl;
+
+  return str.str();
+}
+
+
+/*******************************************************************************
+  Find the guide node of the path that consists of ctxPath followed by relPath
+  (relPath may be empty). If attrPath is true, the last step of the path is an
+  attribute name. On return, found says whether some node of the tree is on
+  the path, unique whether each of the steps of the path selects at most one
+  node per node of the previous step, and count is the number of nodes on the
+  path.
 ********************************************************************************/
 void ElementGuideNode::getPathInfo(
     std::vector<const store::Item*>& ctxPath,
     std::vector<const store::Item*>& relPath,
     bool                             attrPath,
     bool&                            found,
-    bool&                            unique)
+    bool&                            unique,
+    csize&                           count)
 {
-  found = true;
+  GuideNode* pathNode;
+
+  found = false;
+  count = 0;
 
   if (relPath.empty())
   {
-    GuideNode* ctxNode = findPath(ctxPath, attrPath, unique);
-
-    if (ctxNode == NULL)
-      found = false;
+    pathNode = findPath(ctxPath, attrPath, unique);
   }
   else
   {
     assert(!ctxPath.empty());
 
-    GuideNode* ctxNode = findPath(ctxPath, false, unique);
+    bool ctxUnique;
+    GuideNode* ctxNode = findPath(ctxPath, false, ctxUnique);
 
     if (ctxNode == NULL)
-    {
-      found = false;
       return;
-    }
 
     assert(ctxNode->getNodeKind() == store::StoreConsts::elementNode);
 
-    GuideNode* pathNode = reinterpret_cast<ElementGuideNode*>(ctxNode)->
-                          findPath(relPath, attrPath, unique);
+    pathNode = reinterpret_cast<ElementGuideNode*>(ctxNode)->
+               findPath(relPath, attrPath, unique);
+  }
 
-    if (pathNode == NULL)
-      found = false;
+  if (pathNode != NULL)
+  {
+    count = pathNode->theCount;
+    found = (count > 0);
   }
 }
 
@@ -129,9 +202,9 @@ GuideNode* ElementGuideNode::findPath(
 
   unique = true;
 
-  ulong pathLen = (ulong)path.size();
+  csize pathLen = path.size();
 
-  for (ulong i = 0; i < pathLen; i++)
+  for (csize i = 0; i < pathLen; i++)
   {
     if (attrPath && i == pathLen - 1)
     {
@@ -158,10 +231,10 @@ GuideNode* ElementGuideNode::findPath(
 /*******************************************************************************
 
 ********************************************************************************/
-ElementGuideNode* ElementGuideNode::findChild(const store::Item* name)
+ElementGuideNode* ElementGuideNode::findChild(const store::Item* name) const
 {
-  ulong numChildren = (ulong)theChildren.size();
-  for (ulong i = 0; i < numChildren; i++)
+  csize numChildren = theChildren.size();
+  for (csize i = 0; i < numChildren; i++)
   {
     if (theChildren[i]->theName->equals(name))
       return theChildren[i];
@@ -174,10 +247,10 @@ ElementGuideNode* ElementGuideNode::findChild(const store::Item* name)
 /*******************************************************************************
 
 ********************************************************************************/
-AttributeGuideNode* ElementGuideNode::findAttr(const store::Item* name)
+AttributeGuideNode* ElementGuideNode::findAttr(const store::Item* name) const
 {
-  ulong numAttrs = (ulong)theAttributes.size();
-  for (ulong i = 0; i < numAttrs; i++)
+  csize numAttrs = theAttributes.size();
+  for (csize i = 0; i < numAttrs; i++)
   {
     if (theAttributes[i]->theName->equals(name))
       return theAttributes[i];
@@ -187,6 +260,310 @@ AttributeGuideNode* ElementGuideNode::findAttr(const store::Item* name)
 }
 
 
+/*******************************************************************************
+  Return the guide node of the child path with the given name, creating it if
+  it does not exist already.
+********************************************************************************/
+ElementGuideNode* ElementGuideNode::addChild(const store::Item* name)
+{
+  ElementGuideNode* child = findChild(name);
+
+  if (child == NULL)
+  {
+    store::Item_t childName(const_cast<store::Item*>(name));
+    child = new ElementGuideNode(this, childName);
+  }
+
+  return child;
+}
+
+
+/*******************************************************************************
+  Return the guide node of the attribute path with the given name, creating it
+  if it does not exist already.
+********************************************************************************/
+AttributeGuideNode* ElementGuideNode::addAttr(const store::Item* name)
+{
+  AttributeGuideNode* attr = findAttr(name);
+
+  if (attr == NULL)
+  {
+    store::Item_t attrName(const_cast<store::Item*>(name));
+    attr = new AttributeGuideNode(this, attrName);
+  }
+
+  return attr;
+}
+
+
+/*******************************************************************************
+  Return the guide node of the path of the given element or attribute node, or
+  NULL if there is none, if "this" is not the data guide of the node's tree, or
+  if the node is not connected to the root of its tree (e.g. because it is
+  being deleted by a PUL).
+********************************************************************************/
+GuideNode* ElementGuideNode::findNode(const XmlNode* node)
+{
+  assert(theParent == NULL);
+
+  std::vector<const XmlNode*> path;
+
+  while (node->getParent() != NULL)
+  {
+    path.push_back(node);
+    node = static_cast<const XmlNode*>(node->getParent());
+  }
+
+  if (node != node->getTree()->getRoot() || node->getTree()->getDataGuide() != this)
+    return NULL;
+
+  GuideNode* gnode = this;
+
+  for (csize i = path.size(); i > 0; --i)
+  {
+    const XmlNode* step = path[i-1];
+    ElementGuideNode* parent = static_cast<ElementGuideNode*>(gnode);
+
+    switch (step->getNodeKind())
+    {
+    case store::StoreConsts::elementNode:
+      gnode = parent->findChild(step->getNodeName());
+      break;
+    case store::StoreConsts::attributeNode:
+      gnode = (i == 1 ? parent->findAttr(step->getNodeName()) : NULL);
+      break;
+    default:
+      return NULL;
+    }
+
+    if (gnode == NULL)
+      return NULL;
+  }
+
+  return gnode;
+}
+
+
+/*******************************************************************************
+  "this" must be the guide node of the path of the parent of the given node.
+  Add the element and attribute nodes of the subtree rooted at the given node
+  to the guide.
+********************************************************************************/
+void ElementGuideNode::addSubtree(const XmlNode* parent, const XmlNode* node)
+{
+  if (node->isConnectorNode())
+    node = static_cast<const ConnectorNode*>(node)->getNode();
+
+  switch (node->getNodeKind())
+  {
+  case store::StoreConsts::attributeNode:
+  {
+    if (!static_cast<const AttributeNode*>(node)->isHidden())
+      addAttr(node->getNodeName())->addNode(parent);
+
+    break;
+  }
+  case store::StoreConsts::elementNode:
+  {
+    const ElementNode* elem = static_cast<const ElementNode*>(node);
+
+    ElementGuideNode* gnode = addChild(elem->getNodeName());
+    gnode->addNode(parent);
+
+    csize numAttrs = elem->numAttrs();
+    for (csize i = 0; i < numAttrs; ++i)
+      gnode->addSubtree(elem, elem->getAttr(i));
+
+    csize numChildren = elem->numChildren();
+    for (csize i = 0; i < numChildren; ++i)
+      gnode->addSubtree(elem, elem->getChild(i));
+
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+
+/*******************************************************************************
+  "this" must be the guide node of the path of the parent of the given node.
+  Append to guideNodes the guide node of each element and attribute node of the
+  subtree rooted at the given node, once per such node.
+********************************************************************************/
+void ElementGuideNode::collectSubtree(
+    const XmlNode* node,
+    std::vector<GuideNode*>& guideNodes)
+{
+  if (node->isConnectorNode())
+    node = static_cast<const ConnectorNode*>(node)->getNode();
+
+  switch (node->getNodeKind())
+  {
+  case store::StoreConsts::attributeNode:
+  {
+    if (static_cast<const AttributeNode*>(node)->isHidden())
+      break;
+
+    AttributeGuideNode* gnode = findAttr(node->getNodeName());
+
+    if (gnode != NULL)
+      guideNodes.push_back(gnode);
+
+    break;
+  }
+  case store::StoreConsts::elementNode:
+  {
+    const ElementNode* elem = static_cast<const ElementNode*>(node);
+
+    ElementGuideNode* gnode = findChild(elem->getNodeName());
+
+    if (gnode == NULL)
+      return;
+
+    guideNodes.push_back(gnode);
+
+    csize numAttrs = elem->numAttrs();
+    for (csize i = 0; i < numAttrs; ++i)
+      gnode->collectSubtree(elem->getAttr(i), guideNodes);
+
+    csize numChildren = elem->numChildren();
+    for (csize i = 0; i < numChildren; ++i)
+      gnode->collectSubtree(elem->getChild(i), guideNodes);
+
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+
+/*******************************************************************************
+  Check whether some node on a descendant path of this guide node is an element
+  with the given name.
+********************************************************************************/
+bool ElementGuideNode::hasDescendant(const store::Item* name) const
+{
+  const QNameItem* qname = static_cast<const QNameItem*>(name);
+
+  return getDescendantNames().count(qname->getNormalized()) != 0;
+}
+
+
+/*******************************************************************************
+  Return the normalized names of the element paths below this guide node that
+  are present in the tree, computing them (and those of the descendant guide
+  nodes) if they are not current.
+********************************************************************************/
+const std::set<const store::Item*>& ElementGuideNode::getDescendantNames() const
+{
+  if (!theHasDescendantNames)
+  {
+    theDescendantNames.clear();
+
+    csize numChildren = theChildren.size();
+    for (csize i = 0; i < numChildren; i++)
+    {
+      const ElementGuideNode* child = theChildren[i];
+
+      if (child->theCount == 0)
+        continue;
+
+      const QNameItem* qname = static_cast<const QNameItem*>(child->getName());
+      theDescendantNames.insert(qname->getNormalized());
+
+      const std::set<const store::Item*>& names = child->getDescendantNames();
+      theDescendantNames.insert(names.begin(), names.end());
+    }
+
+    theHasDescendantNames = true;
+  }
+
+  return theDescendantNames;
+}
+
+
+/*******************************************************************************
+  The set of paths present below this guide node has changed, so the
+  descendant names of this node and of its ancestors are not current anymore.
+********************************************************************************/
+void ElementGuideNode::dropDescendantNames()
+{
+  for (ElementGuideNode* gnode = this; gnode != NULL; gnode = gnode->theParent)
+  {
+    gnode->theHasDescendantNames = false;
+    gnode->theDescendantNames.clear();
+  }
+}
+
+
+/*******************************************************************************
+  Check whether some node on a path below this guide node matches the given
+  pattern of child (descendantSteps[i] == false) and descendant element name
+  steps. The pattern is matched one step at a time, against the set of guide
+  nodes that matched the previous steps.
+********************************************************************************/
+bool ElementGuideNode::hasPathMatch(
+    const std::vector<const store::Item*>& names,
+    const std::vector<bool>& descendantSteps) const
+{
+  std::vector<const ElementGuideNode*> curr(1, this);
+  std::vector<const ElementGuideNode*> next;
+
+  csize numSteps = names.size();
+
+  for (csize step = 0; step < numSteps; ++step)
+  {
+    next.clear();
+
+    csize numCurr = curr.size();
+    for (csize i = 0; i < numCurr; ++i)
+      curr[i]->collectMatches(names[step], descendantSteps[step], next);
+
+    if (next.empty())
+      return false;
+
+    // A descendant step may reach the same guide node from more than one of
+    // the current ones.
+    if (descendantSteps[step])
+    {
+      std::sort(next.begin(), next.end());
+      next.erase(std::unique(next.begin(), next.end()), next.end());
+    }
+
+    curr.swap(next);
+  }
+
+  return true;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void ElementGuideNode::collectMatches(
+    const store::Item* name,
+    bool descendant,
+    std::vector<const ElementGuideNode*>& result) const
+{
+  csize numChildren = theChildren.size();
+  for (csize i = 0; i < numChildren; i++)
+  {
+    const ElementGuideNode* child = theChildren[i];
+
+    if (child->theCount == 0)
+      continue;
+
+    if (child->theName->equals(name))
+      result.push_back(child);
+
+    if (descendant)
+      child->collectMatches(name, true, result);
+  }
+}
+
+
 /*******************************************************************************
 
 ********************************************************************************/
@@ -202,23 +579,26 @@ std::string ElementGuideNode::show(ulong depth) const
 
   depth += 2;
 
-  ulong numChildren = (ulong)theChildren.size();
+  csize numChildren = theChildren.size();
+  csize numAttrs = theAttributes.size();
+  bool empty = (numChildren == 0 && numAttrs == 0);
 
   if (theName != NULL)
   {
-    if (numChildren > 0)
-      str <<  "<" << theName->getStringValue() << " unique=" << theIsUnique
-          << ">" << std::endl;
-    else
-      str <<  "<" << theName->getStringValue() << " unique=" << theIsUnique
-          << "/>" << std::endl;
+    str <<  "<" << theName->getStringValue() << " count=" << theCount
+        << " unique=" << theIsUnique << (empty ? "/>" : ">") << std::endl;
   }
   else
   {
     str <<  "<DOC>" << std::endl;
   }
 
-  for (ulong i = 0; i < numChildren; i++)
+  for (csize i = 0; i < numAttrs; i++)
+  {
+    str << theAttributes[i]->show(depth);
+  }
+
+  for (csize i = 0; i < numChildren; i++)
   {
     str << theChildren[i]->show(depth);
   }
@@ -227,7 +607,7 @@ std::string ElementGuideNode::show(ulong depth) const
 
   if (theName != NULL)
   {
-    if (numChildren > 0)
+    if (!empty)
     {
       if (depth > 0)
       {
@@ -242,7 +622,7 @@ std::string ElementGuideNode::show(ulong depth) const
     str <<  "</DOC>" << std::endl;
   }
 
-  return str.str().c_str();
+  return str.str();
 }
 
 
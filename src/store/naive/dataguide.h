@@ -13,13 +13,13 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-
 #ifndef ZORBA_SIMPLE_STORE_DATAGUIDE
 #define ZORBA_SIMPLE_STORE_DATAGUIDE
 
-#include "store/api/item.h"
+#include <set>
+#include <vector>
 
-//#define DATAGUIDE
+#include "store/api/item.h"
 
 
 namespace zorba 
@@ -28,8 +28,34 @@ namespace simplestore
 {
 
 class ElementGuideNode;
+class XmlNode;
 
 
+/*******************************************************************************
+  A data guide is a summary of the distinct paths of an xml tree: every path of
+  element and attribute names that leads from the root of the tree to some node
+  of the tree is represented by exactly one guide node. The guide node of the
+  root of the tree is an ElementGuideNode with a NULL name (if the root is a
+  document node).
+
+  Data guides are built by the loader and kept current by the application of
+  PULs to the tree (see CollectionPul::computeDataGuideDeltas()).
+
+  theParent     : The guide node of the path without its last step.
+  theName       : The node name of the last step of the path.
+  theCount      : The number of nodes of the tree that are on this path. Guide
+                  nodes are not removed when their count drops to 0, so a path
+                  is present in the tree only if its count is non-zero. A guide
+                  node with zero count has descendants with zero count only.
+  theIsUnique   : If true, no node of the tree has more than one child on this
+                  path. Once cleared, the flag is not set again by updates that
+                  remove such children.
+  theLastParent : The parent of the node that was most recently added to this
+                  path. Since nodes are added in document order, all the
+                  children of a node are added before the children of the next
+                  node on the parent path, so a node whose parent is the last
+                  parent has a sibling on the same path.
+********************************************************************************/
 class GuideNode
 {
   friend class AttributeGuideNode;
@@ -38,13 +64,17 @@ class GuideNode
 protected:
   ElementGuideNode  * theParent;
   store::Item_t       theName;
+  csize               theCount;
   bool                theIsUnique;
+  const XmlNode     * theLastParent;
 
 public:
   GuideNode(ElementGuideNode* parent, store::Item_t& name)
     :
     theParent(parent),
-    theIsUnique(true)
+    theCount(0),
+    theIsUnique(true),
+    theLastParent(NULL)
   {
     theName.transfer(name);
   }
@@ -60,8 +90,14 @@ public:
   bool getUnique() const       { return theIsUnique; }
   void setUnique(bool v)       { theIsUnique = v; }
 
-  virtual ulong numChildren() const { return 0; }
-  virtual ulong numAttributes() const { return 0; }
+  csize getCount() const { return theCount; }
+
+  void addNode(const XmlNode* parent);
+
+  void removeNode();
+
+  virtual csize numChildren() const { return 0; }
+  virtual csize numAttributes() const { return 0; }
 
   void deleteTree();
 
@@ -70,7 +106,8 @@ public:
         std::vector<const store::Item*>& relPath,
         bool                             attrPath,
         bool&                            found,
-        bool&                            unique) = 0;
+        bool&                            unique,
+        csize&                           count) = 0;
 
   virtual std::string show(ulong depth) const = 0;
 };
@@ -85,11 +122,7 @@ class AttributeGuideNode : public GuideNode
   friend class ElementGuideNode;
 
 public:
-  AttributeGuideNode(ElementGuideNode* parent, store::Item_t& name)
-    :
-    GuideNode(parent, name)
-  {
-  }
+  AttributeGuideNode(ElementGuideNode* parent, store::Item_t& name);
 
   store::StoreConsts::NodeKind getNodeKind() const
   {
@@ -101,27 +134,38 @@ public:
         std::vector<const store::Item*>& relPath,
         bool                             attrPath,
         bool&                            found,
-        bool&                            unique);
+        bool&                            unique,
+        csize&                           count);
 
-  std::string show(ulong depth) const { return "attr"; }
+  std::string show(ulong depth) const;
 };
 
 
 /*******************************************************************************
 
+  theDescendantNames    : The normalized names of the element paths below this
+                          one that are present in the tree (see hasDescendant()).
+  theHasDescendantNames : Whether theDescendantNames is current. It is computed
+                          on demand, and cleared for all the ancestors of a path
+                          whose count becomes or stops being 0.
 ********************************************************************************/
 class ElementGuideNode : public GuideNode
 {
   friend class GuideNode;
+  friend class AttributeGuideNode;
 
 protected:
-  std::vector<ElementGuideNode*>   theChildren;
-  std::vector<AttributeGuideNode*> theAttributes;
+  std::vector<ElementGuideNode*>          theChildren;
+  std::vector<AttributeGuideNode*>        theAttributes;
+
+  mutable std::set<const store::Item*>    theDescendantNames;
+  mutable bool                            theHasDescendantNames;
 
 public:
   ElementGuideNode(ElementGuideNode* parent, store::Item_t& name)
     :
-    GuideNode(parent, name)
+    GuideNode(parent, name),
+    theHasDescendantNames(false)
   {
     if (parent)
       parent->theChildren.push_back(this);
@@ -132,25 +176,51 @@ public:
     return store::StoreConsts::elementNode; 
   }
 
-  ulong numChildren() const { return (ulong)theChildren.size(); }
-  ulong numAttributes() const { return (ulong)theAttributes.size(); }
+  csize numChildren() const { return theChildren.size(); }
+  csize numAttributes() const { return theAttributes.size(); }
 
   void getPathInfo(
         std::vector<const store::Item*>& ctxPath,
         std::vector<const store::Item*>& relPath,
         bool                             attrPath,
         bool&                            found,
-        bool&                            unique);
+        bool&                            unique,
+        csize&                           count);
 
   GuideNode* findPath(
         std::vector<const store::Item*>& path,
         bool                             attrPath,
         bool&                            unique);
 
-  ElementGuideNode* findChild(const store::Item* name);
-  AttributeGuideNode* findAttr(const store::Item* name);
+  ElementGuideNode* findChild(const store::Item* name) const;
+  AttributeGuideNode* findAttr(const store::Item* name) const;
+
+  ElementGuideNode* addChild(const store::Item* name);
+  AttributeGuideNode* addAttr(const store::Item* name);
+
+  GuideNode* findNode(const XmlNode* node);
+
+  void addSubtree(const XmlNode* parent, const XmlNode* node);
+
+  void collectSubtree(const XmlNode* node, std::vector<GuideNode*>& guideNodes);
+
+  bool hasDescendant(const store::Item* name) const;
+
+  bool hasPathMatch(
+        const std::vector<const store::Item*>& names,
+        const std::vector<bool>& descendantSteps) const;
 
   std::string show(ulong depth) const;
+
+protected:
+  const std::set<const store::Item*>& getDescendantNames() const;
+
+  void dropDescendantNames();
+
+  void collectMatches(
+        const store::Item* name,
+        bool descendant,
+        std::vector<const ElementGuideNode*>& result) const;
 };
 
 
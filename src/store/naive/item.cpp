@@ -22,6 +22,7 @@
 #include "diagnostics/assert.h"
 
 #include "zorbatypes/datetime.h"
+#include "util/utf8_util.h"
 
 #include "store/api/item.h"
 #include "store/api/iterator.h"
@@ -493,6 +494,36 @@ const zstring& Item::getString() const
 }
 
 
+/**
+ * Accessor for xs:string and its subtypes
+ */
+csize Item::getStringLength() const
+{
+  zstring value;
+  getStringValue2(value);
+  return utf8::length(value.data(), value.data() + value.size());
+}
+
+
+void Item::getSubstring(csize pos, csize len, zstring& result) const
+{
+  zstring value;
+  getStringValue2(value);
+
+  const char* const s = value.data();
+  const utf8::size_type b = utf8::byte_pos(s, value.size(), pos);
+
+  if (b == utf8::npos)
+  {
+    result.clear();
+    return;
+  }
+
+  const utf8::size_type e = utf8::byte_pos(s + b, value.size() - b, len);
+  result.assign(s + b, e == utf8::npos ? value.size() - b : e);
+}
+
+
 /**
  * Accessor for xs:base64Binary
  */
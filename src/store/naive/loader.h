@@ -24,8 +24,10 @@
 #include "store/api/load_properties.h"
 
 #include "ordpath.h"
+#include "projection_automaton.h"
 
 #include "zorbautils/stack.h"
+#include "zorbautils/string_dictionary.h"
 #include "runtime/parsing_and_serializing/fragment_istream.h"
 
 
@@ -124,6 +126,24 @@ public:
                  and the endElement and endDocument methods will remove these
                  children from the stack and link them with N.
 
+  theStringDictionary : Shares the items of repeated short text and attribute
+                 values within the tree being loaded. It is used only if the
+                 internStrings load property is set.
+
+  theProjection : If the load properties have a document projection, the
+                 automaton that decides which elements are built (see
+                 ProjectionAutomaton); otherwise NULL.
+  theProjectionStack : The automaton state and action of each element being
+                 built whose subtree is not kept in full, starting with the
+                 document node.
+  theSkipDepth : The number of elements being skipped, i.e., the depth within
+                 the outermost element that is not built.
+  theKeepAllDepth : The depth within the outermost element whose subtree is
+                 kept in full.
+  theNumElements : The number of elements in the input (counted only when
+                 projecting, for the traceDocProjection property).
+  theNumKeptElements : The number of those elements that were built.
+
 ********************************************************************************/
 class FastXmlLoader : public XmlLoader
 {
@@ -151,9 +171,16 @@ protected:
   zorba::Stack<PathStepInfo>       thePathStack;
   std::stack<NsBindingsContext*>   theBindingsStack;
 
-#ifdef DATAGUIDE
   zorba::Stack<ElementGuideNode*>  theGuideStack;
-#endif
+
+  StringDictionary                 theStringDictionary;
+
+  ProjectionAutomaton            * theProjection;
+  std::vector<ProjectionAutomaton::Transition> theProjectionStack;
+  csize                            theSkipDepth;
+  csize                            theKeepAllDepth;
+  csize                            theNumElements;
+  csize                            theNumKeptElements;
 
 public:
   FastXmlLoader(
@@ -178,6 +205,19 @@ protected:
 
   void* getElementNode();
 
+  bool isSkippingContent() const
+  {
+    return theSkipDepth > 0 || (theProjection != NULL && theKeepAllDepth == 0);
+  }
+
+  // Projected documents are private to the query that loads them, and the
+  // elements they drop are not known until their end tags, so no data guide
+  // is built for them.
+  bool buildDataGuide() const
+  {
+    return theBuildDataGuide && theProjection == NULL;
+  }
+
 public:
   static void	startDocument(void * ctx);
 
@@ -349,9 +389,7 @@ protected:
   zorba::Stack<PathStepInfo>       thePathStack;
   std::stack<NsBindingsContext*>   theBindingsStack;
 
-#ifdef DATAGUIDE
   zorba::Stack<ElementGuideNode*>  theGuideStack;
-#endif
 
 public:
   DtdXmlLoader(
@@ -652,8 +652,7 @@ void DtdXmlLoader::abortload()
 
   thePathStack.clear();
 
-#ifdef DATAGUIDE
-  if(!theGuideStack.empty())
+  if (!theGuideStack.empty())
   {
     GuideNode* node = theGuideStack[0];
     if (node != NULL)
@@ -661,7 +660,6 @@ void DtdXmlLoader::abortload()
   }
 
   theGuideStack.clear();
-#endif
 
   while(!theBindingsStack.empty())
   {
@@ -696,9 +694,7 @@ void DtdXmlLoader::reset()
     theNodeStack.pop();
 
   ZORBA_ASSERT(theNodeStack.empty());
-#ifdef DATAGUIDE
   ZORBA_ASSERT(theGuideStack.empty());
-#endif
   ZORBA_ASSERT(theBindingsStack.empty());
 }
 
@@ -1050,15 +1046,14 @@ void DtdXmlLoader::startDocument(void * ctx)
     loader.theNodeStack.push(docNode);
     loader.theNodeStack.push(NULL);
 
-#ifdef DATAGUIDE
     if (loader.theBuildDataGuide)
     {
       assert(loader.theGuideStack.empty());
       store::Item_t nodeName;
       ElementGuideNode* gnode = new ElementGuideNode(NULL, nodeName);
+      gnode->addNode(NULL);
       loader.theGuideStack.push(gnode);
     }
-#endif
 
     docNode->setBaseUri(loader.theBaseUri);
     docNode->setDocUri(loader.theDocUri);
@@ -1131,7 +1126,6 @@ void DtdXmlLoader::endDocument(void * ctx)
 
     nodeStack.pop(numChildren+1);
 
-#ifdef DATAGUIDE
     if (loader.theBuildDataGuide)
     {
       // Remove from the dataguide stack
@@ -1141,11 +1135,8 @@ void DtdXmlLoader::endDocument(void * ctx)
 
       loader.theTree->setDataGuide(rootGNode);
 
-#ifndef NDEBUG
-      std::cout << rootGNode->show(0) << std::endl;
-#endif
+      LOADER_TRACE2("Data Guide = " << std::endl << rootGNode->show(0));
     }
-#endif
 
     LOADER_TRACE2("End Doc Node = " << docNode);
   }
@@ -1225,54 +1216,32 @@ void DtdXmlLoader::startElement(
     if (nodeStack.empty())
       loader.setRoot(elemNode);
 
-#ifdef DATAGUIDE
-    nodeName = elemNode->getNodeName();
-
-    // Push new node to dataguide, if not there already
-    if (loader.theBuildDataGuide && loader.theNodeStack.empty())
-    {
-      assert(loader.theGuideStack.empty());
-      ElementGuideNode* gnode = new ElementGuideNode(NULL, nodeName);
-      loader.theGuideStack.push(gnode);
-    }
-    else if (loader.theBuildDataGuide)
+    // Add the element to the data guide. Its parent is at the top of the
+    // path stack, unless it is the document node.
+    if (loader.theBuildDataGuide)
     {
-      bool duplicate = false;
-
-      assert(!loader.theGuideStack.empty());
+      nodeName = elemNode->getNodeName();
 
-      // See if we have seen an element with the same tag name among the left
-      // siblings of this element node.
-      for (long i = loader.theNodeStack.size() - 1;
-           loader.theNodeStack[i] != NULL;
-           --i)
+      if (nodeStack.empty())
       {
-        XmlNode* sib = loader.theNodeStack[i];
-        if (sib->getNodeKind() == store::StoreConsts::elementNode &&
-            sib->getNodeName()->equals(nodeName))
-        {
-          duplicate = true;
-          break;
-        }
-      }
-
-      ElementGuideNode* parentGNode = loader.theGuideStack.top();
-      ElementGuideNode* childGNode = parentGNode->findChild(nodeName);
-
-      if (duplicate)
-      {
-        assert(childGNode != NULL);
-        childGNode->setUnique(false);
+        assert(loader.theGuideStack.empty());
+        ElementGuideNode* gnode = new ElementGuideNode(NULL, nodeName);
+        gnode->addNode(NULL);
+        loader.theGuideStack.push(gnode);
       }
       else
       {
-        if (childGNode == NULL)
-          childGNode = new ElementGuideNode(parentGNode, nodeName);
-      }
+        assert(!loader.theGuideStack.empty());
+
+        const XmlNode* parent = pathStack.top().theNode;
+        if (parent == NULL)
+          parent = loader.theRootNode;
 
-      loader.theGuideStack.push(childGNode);
+        ElementGuideNode* gnode = loader.theGuideStack.top()->addChild(nodeName);
+        gnode->addNode(parent);
+        loader.theGuideStack.push(gnode);
+      }
     }
-#endif
 
     // Check for recursiveness, i.e., whether this node is a descendant of
     // another noide with the same name
@@ -1410,6 +1379,10 @@ void DtdXmlLoader::startElement(
 
       attrNodes[i] = attrNode;
 
+      if (loader.theBuildDataGuide)
+        loader.theGuideStack.top()->addAttr(attrNode->getNodeName())->
+        addNode(elemNode);
+
       if (attrNode->isBaseUri())
       {
         baseUri = pathStack.top().theBaseUri;
@@ -1570,14 +1543,17 @@ void  DtdXmlLoader::endElement(
     // Adjust the dewey id
     loader.theOrdPath.popChild();
 
-#ifdef DATAGUIDE
     if (loader.theBuildDataGuide)
     {
       // Remove from the dataguide stack
-      assert(loader.theGuideStack.top()->getName()->equals(elemNode->getNodeName()));
+      ElementGuideNode* gnode = loader.theGuideStack.top();
+      assert(gnode->getName()->equals(elemNode->getNodeName()));
       loader.theGuideStack.pop();
+
+      // If the element is the root of the tree, so is its guide node.
+      if (loader.theGuideStack.empty())
+        loader.theTree->setDataGuide(gnode);
     }
-#endif
   }
   catch (ZorbaException const& e)
   {
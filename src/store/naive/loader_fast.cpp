@@ -22,6 +22,7 @@
 
 #include <libxml/xmlmemory.h>
 
+#include <zorba/properties.h>
 #include <zorba/store_consts.h>
 
 #include "store_defs.h"
@@ -199,7 +200,13 @@ FastXmlLoader::FastXmlLoader(
   XmlLoader(factory, xqueryDiagnostics, loadProperties, dataguide),
   theTree(NULL),
   theRootNode(NULL),
-  theNodeStack(2048)
+  theNodeStack(2048),
+  theStringDictionary(factory, true),
+  theProjection(NULL),
+  theSkipDepth(0),
+  theKeepAllDepth(0),
+  theNumElements(0),
+  theNumKeptElements(0)
 {
   theBuffer = new char[INPUT_CHUNK_SIZE];
   theOrdPath.init();
@@ -229,6 +236,7 @@ FastXmlLoader::FastXmlLoader(
 FastXmlLoader::~FastXmlLoader()
 {
   delete[] theBuffer;
+  delete theProjection;
 }
 
 
@@ -269,8 +277,15 @@ void FastXmlLoader::abortload()
 
   thePathStack.clear();
 
-#ifdef DATAGUIDE
-  if(!theGuideStack.empty())
+  theStringDictionary.clear();
+
+  delete theProjection;
+  theProjection = NULL;
+  theProjectionStack.clear();
+  theSkipDepth = 0;
+  theKeepAllDepth = 0;
+
+  if (!theGuideStack.empty())
   {
     GuideNode* node = theGuideStack[0];
     if (node != NULL)
@@ -278,7 +293,6 @@ void FastXmlLoader::abortload()
   }
 
   theGuideStack.clear();
-#endif
 
   while(!theBindingsStack.empty())
   {
@@ -311,10 +325,15 @@ void FastXmlLoader::reset()
   if (!theNodeStack.empty())
     theNodeStack.pop();
 
+  theStringDictionary.clear();
+
+  delete theProjection;
+  theProjection = NULL;
+  theProjectionStack.clear();
+
   ZORBA_ASSERT(theNodeStack.empty());
-#ifdef DATAGUIDE
+  ZORBA_ASSERT(theSkipDepth == 0 && theKeepAllDepth == 0);
   ZORBA_ASSERT(theGuideStack.empty());
-#endif
   ZORBA_ASSERT(theBindingsStack.empty());
 }
 
@@ -368,6 +387,7 @@ store::Item_t FastXmlLoader::loadXml(
 {
   //  xmlParserCtxtPtr ctxt = NULL;
   theTree = GET_STORE().getNodeFactory().createXmlTree();
+  theTree->enableTagIndex();
 
   xmlSubstituteEntitiesDefault(1);
 
@@ -393,6 +413,16 @@ store::Item_t FastXmlLoader::loadXml(
 
   thePathStack.push(PathStepInfo(NULL, baseUri));
 
+  if (theLoadProperties.getProjection() != NULL)
+  {
+    theProjection = new ProjectionAutomaton(*theLoadProperties.getProjection());
+    theProjectionStack.push_back(
+      ProjectionAutomaton::Transition(ProjectionAutomaton::getStartState(),
+                                      ProjectionAutomaton::KEEP));
+    theNumElements = 0;
+    theNumKeptElements = 0;
+  }
+
   try
   {
     std::streamsize numChars = readPacket(stream, theBuffer, INPUT_CHUNK_SIZE);
@@ -493,6 +523,22 @@ store::Item_t FastXmlLoader::loadXml(
   thePathStack.pop();
   assert(thePathStack.empty());
 
+  if (Properties::instance().getTraceStringDictionary() &&
+      theLoadProperties.getInternStrings())
+  {
+    theStringDictionary.report(Properties::instance().getDebugStream(),
+                               theDocUri);
+  }
+
+  if (theProjection != NULL && Properties::instance().getTraceDocProjection())
+  {
+    Properties::instance().getDebugStream()
+      << "document projection of " << theDocUri << " ("
+      << theLoadProperties.getProjection()->toString() << "): built "
+      << theNumKeptElements << " of " << theNumElements << " elements"
+      << std::endl;
+  }
+
   XmlNode* resultNode;
   resultNode = theRootNode;
   reset();
@@ -518,15 +564,14 @@ void FastXmlLoader::startDocument(void * ctx)
     loader.theNodeStack.push(docNode);
     loader.theNodeStack.push(NULL);
 
-#ifdef DATAGUIDE
-    if (loader.theBuildDataGuide)
+    if (loader.buildDataGuide())
     {
       assert(loader.theGuideStack.empty());
       store::Item_t nodeName;
       ElementGuideNode* gnode = new ElementGuideNode(NULL, nodeName);
+      gnode->addNode(NULL);
       loader.theGuideStack.push(gnode);
     }
-#endif
 
     docNode->setBaseUri(loader.theBaseUri);
     docNode->setDocUri(loader.theDocUri);
@@ -602,8 +647,7 @@ void FastXmlLoader::endDocument(void * ctx)
 
     nodeStack.pop(numChildren+1);
 
-#ifdef DATAGUIDE
-    if (loader.theBuildDataGuide)
+    if (loader.buildDataGuide())
     {
       // Remove from the dataguide stack
       ElementGuideNode* rootGNode = loader.theGuideStack.top();
@@ -612,11 +656,8 @@ void FastXmlLoader::endDocument(void * ctx)
 
       loader.theTree->setDataGuide(rootGNode);
 
-#ifndef NDEBUG
-      std::cout << rootGNode->show(0) << std::endl;
-#endif
+      LOADER_TRACE2("Data Guide = " << std::endl << rootGNode->show(0));
     }
-#endif
 
     LOADER_TRACE2("End Doc Node = " << docNode);
   }
@@ -670,6 +711,13 @@ void FastXmlLoader::startElement(
   zorba::Stack<PathStepInfo>& pathStack = loader.thePathStack;
   zstring baseUri;
 
+  if (loader.theSkipDepth > 0)
+  {
+    ++loader.theSkipDepth;
+    ++loader.theNumElements;
+    return;
+  }
+
   try
   {
     csize numAttributes = static_cast<csize>(numAttrs);
@@ -681,6 +729,39 @@ void FastXmlLoader::startElement(
                   reinterpret_cast<const char*>(uri),
                   reinterpret_cast<const char*>(prefix),
                   reinterpret_cast<const char*>(lname));
+
+    // If the document is projected, decide whether to build the element and,
+    // if so, whether to build all of its subtree.
+    if (loader.theProjection != NULL)
+    {
+      ++loader.theNumElements;
+
+      if (loader.theKeepAllDepth > 0)
+      {
+        ++loader.theKeepAllDepth;
+      }
+      else
+      {
+        ProjectionAutomaton::Transition next = loader.theProjection->
+        transition(loader.theProjectionStack.back().theTarget, nodeName.getp());
+
+        if (next.theAction == ProjectionAutomaton::SKIP)
+        {
+          loader.theSkipDepth = 1;
+          return;
+        }
+        else if (next.theAction == ProjectionAutomaton::KEEP_ALL)
+        {
+          loader.theKeepAllDepth = 1;
+        }
+        else
+        {
+          loader.theProjectionStack.push_back(next);
+        }
+      }
+
+      ++loader.theNumKeptElements;
+    }
     
     // Create the element node and push it to the node stack
     ElementNode* elemNode = nfactory.createElementNode(nodeName,
@@ -689,54 +770,32 @@ void FastXmlLoader::startElement(
     if (nodeStack.empty())
       loader.setRoot(elemNode);
     
-#ifdef DATAGUIDE
-    nodeName = elemNode->getNodeName();
-
-    // Push new node to dataguide, if not there already
-    if (loader.theBuildDataGuide && loader.theNodeStack.empty())
-    {
-      assert(loader.theGuideStack.empty());
-      ElementGuideNode* gnode = new ElementGuideNode(NULL, nodeName);
-      loader.theGuideStack.push(gnode);
-    }
-    else if (loader.theBuildDataGuide)
+    // Add the element to the data guide. Its parent is at the top of the
+    // path stack, unless it is the document node.
+    if (loader.buildDataGuide())
     {
-      bool duplicate = false;
-
-      assert(!loader.theGuideStack.empty());
-
-      // See if we have seen an element with the same tag name among the left
-      // siblings of this element node.
-      for (long i = loader.theNodeStack.size() - 1;
-           loader.theNodeStack[i] != NULL;
-           --i)
-      {
-        XmlNode* sib = loader.theNodeStack[i];
-        if (sib->getNodeKind() == store::StoreConsts::elementNode &&
-            sib->getNodeName()->equals(nodeName))
-        {
-          duplicate = true;
-          break;
-        }
-      }
-
-      ElementGuideNode* parentGNode = loader.theGuideStack.top();
-      ElementGuideNode* childGNode = parentGNode->findChild(nodeName);
+      nodeName = elemNode->getNodeName();
 
-      if (duplicate)
+      if (nodeStack.empty())
       {
-        assert(childGNode != NULL);
-        childGNode->setUnique(false);
+        assert(loader.theGuideStack.empty());
+        ElementGuideNode* gnode = new ElementGuideNode(NULL, nodeName);
+        gnode->addNode(NULL);
+        loader.theGuideStack.push(gnode);
       }
       else
       {
-        if (childGNode == NULL)
-          childGNode = new ElementGuideNode(parentGNode, nodeName);
-      }
+        assert(!loader.theGuideStack.empty());
+
+        const XmlNode* parent = pathStack.top().theNode;
+        if (parent == NULL)
+          parent = loader.theRootNode;
 
-      loader.theGuideStack.push(childGNode);
+        ElementGuideNode* gnode = loader.theGuideStack.top()->addChild(nodeName);
+        gnode->addNode(parent);
+        loader.theGuideStack.push(gnode);
+      }
     }
-#endif
 
     // Check for recursiveness, i.e., whether this node is a descendant of
     // another noide with the same name
@@ -810,7 +869,11 @@ void FastXmlLoader::startElement(
 
         zstring value(valueBegin, valueEnd);
         store::Item_t typedValue;
-        GET_STORE().getItemFactory()->createUntypedAtomic(typedValue, value);
+
+        if (loader.theLoadProperties.getInternStrings())
+          loader.theStringDictionary.createItem(typedValue, value);
+        else
+          GET_STORE().getItemFactory()->createUntypedAtomic(typedValue, value);
 
         AttributeNode* attrNode = nfactory.createAttributeNode(qname);
         attrNode->theParent = elemNode;
@@ -819,6 +882,10 @@ void FastXmlLoader::startElement(
 
         attrNodes[i] = attrNode;
 
+        if (loader.buildDataGuide())
+          loader.theGuideStack.top()->addAttr(attrNode->getNodeName())->
+          addNode(elemNode);
+
         if (attrNode->isBaseUri())
         {
           baseUri = pathStack.top().theBaseUri;
@@ -905,6 +972,12 @@ void  FastXmlLoader::endElement(
   XmlNode* prevChild = NULL;
   XmlNode* currChild;
 
+  if (loader.theSkipDepth > 0)
+  {
+    --loader.theSkipDepth;
+    return;
+  }
+
   try
   {
     // Find the position of the 1st child of this element node in the node stack
@@ -983,14 +1056,41 @@ void  FastXmlLoader::endElement(
     // Adjust the dewey id
     loader.theOrdPath.popChild();
 
-#ifdef DATAGUIDE
-    if (loader.theBuildDataGuide)
+    if (loader.theProjection != NULL)
+    {
+      if (loader.theKeepAllDepth > 0)
+      {
+        --loader.theKeepAllDepth;
+      }
+      else
+      {
+        ProjectionAutomaton::Action action =
+        loader.theProjectionStack.back().theAction;
+
+        loader.theProjectionStack.pop_back();
+
+        // The element was built only because a path might have selected some
+        // of its descendants; if none was, the element is not needed either.
+        if (action == ProjectionAutomaton::CONNECT && numChildren == 0)
+        {
+          nodeStack.pop();
+          elemNode->destroy(true);
+          --loader.theNumKeptElements;
+        }
+      }
+    }
+
+    if (loader.buildDataGuide())
     {
       // Remove from the dataguide stack
-      assert(loader.theGuideStack.top()->getName()->equals(elemNode->getNodeName()));
+      ElementGuideNode* gnode = loader.theGuideStack.top();
+      assert(gnode->getName()->equals(elemNode->getNodeName()));
       loader.theGuideStack.pop();
+
+      // If the element is the root of the tree, so is its guide node.
+      if (loader.theGuideStack.empty())
+        loader.theTree->setDataGuide(gnode);
     }
-#endif
   }
   catch (ZorbaException const& e)
   {
@@ -1017,11 +1117,23 @@ void FastXmlLoader::characters(void * ctx, const xmlChar * ch, int len)
   FastXmlLoader& loader = *(static_cast<FastXmlLoader *>( ctx ));
   ZORBA_LOADER_CHECK_ERROR(loader);
 
+  if (loader.isSkippingContent())
+    return;
+
   try
   {
     const char* charp = reinterpret_cast<const char*>(ch);
     zstring content(charp, len);
 
+    if (loader.theLoadProperties.getInternStrings() &&
+        content.size() <= StringDictionary::MAX_STRING_SIZE)
+    {
+      // Make the text node share the string of the pooled item.
+      store::Item_t pooled;
+      loader.theStringDictionary.createItem(pooled, content);
+      content = pooled->getString();
+    }
+
     TextNode* textNode = GET_STORE().getNodeFactory().createTextNode(content);
 
     if (loader.theNodeStack.empty())
@@ -1068,6 +1180,9 @@ void FastXmlLoader::cdataBlock(void * ctx, const xmlChar * ch, int len)
   FastXmlLoader& loader = *(static_cast<FastXmlLoader *>( ctx ));
   ZORBA_LOADER_CHECK_ERROR(loader);
 
+  if (loader.isSkippingContent())
+    return;
+
   try
   {
     // If a doc contains an element like <cdata><![CDATA[ <> ]]></cdata>,
@@ -1123,6 +1238,9 @@ void FastXmlLoader::processingInstruction(
   FastXmlLoader& loader = *(static_cast<FastXmlLoader *>( ctx ));
   ZORBA_LOADER_CHECK_ERROR(loader);
 
+  if (loader.isSkippingContent())
+    return;
+
   try
   {
     // bugfix: handling PIs with no data (i.e. data being NULL)
@@ -1170,6 +1288,9 @@ void FastXmlLoader::comment(void * ctx, const xmlChar * ch)
   FastXmlLoader& loader = *(static_cast<FastXmlLoader *>( ctx ));
   ZORBA_LOADER_CHECK_ERROR(loader);
 
+  if (loader.isSkippingContent())
+    return;
+
   try
   {
     const char* charp = reinterpret_cast<const char*>(ch);
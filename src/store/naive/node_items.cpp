@@ -47,6 +47,7 @@
 #include "item_iterator.h"
 #include "dataguide.h"
 #include "node_factory.h"
+#include "tag_index.h"
 
 #ifndef ZORBA_NO_FULL_TEXT
 using namespace zorba::locale;
@@ -69,15 +70,16 @@ XmlTree::XmlTree()
   theRefCount(0),
   theCollectionInfo(NULL),
   theRootNode(NULL),
-#ifdef DATAGUIDE
   theDataGuideRootNode(NULL),
-#endif
   theIsValidated(false),
   theIsRecursive(false)
 #ifndef EMBEDED_TYPE
   ,
   theTypesMap(NULL)
 #endif
+  ,
+  theUseTagIndex(false),
+  theTagIndex(NULL)
 {
 }
 
@@ -91,19 +93,33 @@ XmlTree::XmlTree(XmlNode* root, const TreeId& id)
   theCollectionInfo(NULL),
   theTreeId(id),
   theRootNode(root),
-#ifdef DATAGUIDE
   theDataGuideRootNode(NULL),
-#endif
   theIsValidated(false),
   theIsRecursive(false)
 #ifndef EMBEDED_TYPE
   ,
   theTypesMap(NULL)
 #endif
+  ,
+  theUseTagIndex(false),
+  theTagIndex(NULL)
 {
 }
 
 
+/*******************************************************************************
+
+********************************************************************************/
+XmlTree::~XmlTree()
+{
+  theRootNode = 0;
+  delete theTagIndex;
+
+  if (theDataGuideRootNode != NULL)
+    theDataGuideRootNode->deleteTree();
+}
+
+
 /*******************************************************************************
 
 ********************************************************************************/
@@ -123,14 +139,6 @@ void XmlTree::destroy() throw()
     theRootNode = NULL;
   }
 
-#ifdef DATAGUIDE
-  if (theDataGuideRootNode != NULL)
-  {
-    theDataGuideRootNode->deleteTree();
-    theDataGuideRootNode = NULL;
-  }
-#endif
-
 #ifndef EMBEDED_TYPE
   if (theTypesMap)
     delete theTypesMap;
@@ -149,6 +157,54 @@ void XmlTree::free()
 }
 
 
+/*******************************************************************************
+  Returns the tag index of the tree, building it first if the tree uses one but
+  it has not been built yet, or NULL if the tree does not use a tag index.
+********************************************************************************/
+const TagIndex* XmlTree::getTagIndex()
+{
+  SYNC_CODE(AutoMutex lock(&theTagIndexMutex);)
+
+  if (theTagIndex == NULL && theUseTagIndex && theRootNode != NULL)
+  {
+    theTagIndex = new TagIndex;
+    theTagIndex->build(theRootNode);
+  }
+
+  return theTagIndex;
+}
+
+
+/*******************************************************************************
+  Drops the tag index of the tree, if any, and makes sure that no new one gets
+  built, because the tree is being modified.
+********************************************************************************/
+void XmlTree::dropTagIndex()
+{
+  SYNC_CODE(AutoMutex lock(&theTagIndexMutex);)
+
+  theUseTagIndex = false;
+
+  delete theTagIndex;
+  theTagIndex = NULL;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void XmlTree::setDataGuide(ElementGuideNode* root)
+{
+  if (root != theDataGuideRootNode)
+  {
+    if (theDataGuideRootNode != NULL)
+      theDataGuideRootNode->deleteTree();
+
+    theDataGuideRootNode = root;
+  }
+}
+
+
 #ifndef EMBEDED_TYPE
 
 /*******************************************************************************
@@ -799,6 +855,13 @@ void XmlNode::swap(Item* anotherItem)
   assert(theParent == NULL);
   assert(lOtherItem->theParent == NULL);
 
+  // The tag indexes and data guides would be swapped along with the trees,
+  // but not the root nodes, so they are dropped rather than fixed.
+  getTree()->dropTagIndex();
+  lOtherItem->getTree()->dropTagIndex();
+  getTree()->dropDataGuide();
+  lOtherItem->getTree()->dropDataGuide();
+
   // But some things must be "unswapped"
   std::swap(getTree()->theCollectionInfo, lOtherItem->getTree()->theCollectionInfo);
   std::swap(getTree()->theTreeId, lOtherItem->getTree()->theTreeId);
@@ -33,6 +33,7 @@
 #include "zorbatypes/zstring.h"
 #include "zorbautils/fatal.h"
 #include "zorbautils/hashfun.h"
+#include "zorbautils/mutex.h"
 
 #ifndef ZORBA_NO_FULL_TEXT
 #include "ft_token_store.h"
@@ -79,10 +80,11 @@ class AttributeNode;
 class CommentNode;
 class DocumentNode;
 class ElementNode;
-class GuideNode;
+class ElementGuideNode;
 class InternalNode;
 class NsBindingsContext;
 class PiNode;
+class TagIndex;
 class TextNode;
 
 class UpdatePrimitive;
@@ -173,6 +175,36 @@ class XmlNodeTokenizerCallback;
 
   theTokens:
   ----------
+
+  theUseTagIndex:
+  ---------------
+  Whether a tag index may be built for the tree. It is set for trees created by
+  the FastXmlLoader and is cleared as soon as the tree gets updated.
+
+  theTagIndex:
+  ------------
+  The element nodes of the tree grouped by name, in document order (see
+  TagIndex). Only twig joins use it, so it is built by the first twig join over
+  the tree (see getTagIndex()). It is NULL until then, and for the trees that
+  do not use a tag index.
+
+  theTagIndexMutex:
+  -----------------
+  Protects the lazy building of theTagIndex, since queries running in
+  different threads may search the same tree.
+
+  theDataGuideRootNode:
+  ---------------------
+  The root of the data guide of the tree, i.e., of the summary of its distinct
+  element and attribute paths (see dataguide.h). It is built by the loaders
+  for document trees (unless the dataGuides property is off) and is kept
+  current by the application of PULs. It is NULL for all other trees.
+
+  theDataGuideMutex:
+  ------------------
+  Protects the descendant names that the data guide computes on demand (see
+  Store::mayHaveDescendant()), since queries running in different threads may
+  search the same tree.
 ********************************************************************************/
 class XmlTree
 {
@@ -198,9 +230,8 @@ protected:
 
   XmlNode                 * theRootNode;
 
-#ifdef DATAGUIDE
-  GuideNode               * theDataGuideRootNode;
-#endif
+  ElementGuideNode        * theDataGuideRootNode;
+  SYNC_CODE(Mutex           theDataGuideMutex;)
 
   bool                      theIsValidated;
 
@@ -214,13 +245,17 @@ protected:
   FTTokenStore              theTokens;
 #endif
 
+  bool                      theUseTagIndex;
+  TagIndex                * theTagIndex;
+  SYNC_CODE(Mutex           theTagIndexMutex;)
+
 protected:
   XmlTree(XmlNode* root, const TreeId& id);
 
 public:
   XmlTree();
 
-  ~XmlTree() { theRootNode = 0; }
+  ~XmlTree();
 
   void free();
 
@@ -279,11 +314,19 @@ public:
 
   bool isRecursive() const { return theIsRecursive; }
 
-#ifdef DATAGUIDE
-  GuideNode* getDataGuide() const { return theDataGuideRootNode; }
+  void enableTagIndex() { theUseTagIndex = true; }
 
-  void setDataGuide(GuideNode* root) { theDataGuideRootNode = root; }
-#endif
+  const TagIndex* getTagIndex();
+
+  void dropTagIndex();
+
+  ElementGuideNode* getDataGuide() const { return theDataGuideRootNode; }
+
+  void setDataGuide(ElementGuideNode* root);
+
+  void dropDataGuide() { setDataGuide(NULL); }
+
+  SYNC_CODE(Mutex* getDataGuideMutex() { return &theDataGuideMutex; })
 
 #ifndef EMBEDED_TYPE
   store::Item* getType(const XmlNode* n) const;
@@ -538,12 +581,12 @@ public:
 
   void setParent(InternalNode* p) { theParent = p; }
 
-#ifdef DATAGUIDE
-  GuideNode* getDataGuide() const { return getTree()->getDataGuide(); }
-#endif
+  ElementGuideNode* getDataGuide() const { return getTree()->getDataGuide(); }
 
   inline long compare2(const XmlNode* other) const;
 
+  inline long compareInTree(const XmlNode* other) const;
+
   virtual XmlNode* copyInternal(
       InternalNode* rootParent,
       InternalNode* parent,
@@ -1762,6 +1805,28 @@ inline long XmlNode::compare2(const XmlNode* other) const
 #endif // TEXT_ORDPATH
 
 
+/*******************************************************************************
+  Like compare2(), but "this" and the "other" node must belong to the same tree,
+  so their collection ids, tree ids, and positions need not be compared.
+********************************************************************************/
+inline long XmlNode::compareInTree(const XmlNode* other) const
+{
+  assert(getTree() == other->getTree());
+
+  if (this == other)
+    return 0;
+
+#ifdef TEXT_ORDPATH
+  const OrdPathNode* ordThis = static_cast<const OrdPathNode*>(this);
+  const OrdPathNode* ordOther = static_cast<const OrdPathNode*>(other);
+
+  return (ordThis->getOrdPath() < ordOther->getOrdPath() ? -1 : 1);
+#else
+  return compareInSameTree(this, other);
+#endif
+}
+
+
 #ifndef ZORBA_NO_FULL_TEXT
 /**
  * An %XmlNodeTokenizerCallback is-a Tokenizer::Callback for tokenizing XML
@@ -16,12 +16,15 @@
 #include "stdafx.h"
 
 #include <algorithm>
+#include <map>
 
 #include "diagnostics/assert.h"
 #include "diagnostics/xquery_diagnostics.h"
 
 #include "node_items.h"
 #include "node_iterators.h"
+#include "dataguide.h"
+#include "atomic_items.h"
 #include "store_defs.h"
 
 namespace zorba
@@ -139,6 +142,345 @@ bool AttributesIteratorImpl::next(store::Item_t& result)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//  class TwigJoinIterator                                                     //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+struct OrdPathComparison
+{
+  bool operator()(const OrdPath& ordPath, const ElementNode* node) const
+  {
+    return ordPath < node->getOrdPath();
+  }
+};
+
+
+inline const store::Item* getNormalizedName(const XmlNode* node)
+{
+  return static_cast<const QNameItem*>(node->getNodeName())->getNormalized();
+}
+
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void TwigJoinIteratorImpl::init(
+    const store::Item* contextNode,
+    const std::vector<store::Item_t>& names,
+    const std::vector<bool>& descendantSteps)
+{
+  csize numSteps = names.size();
+
+  ZORBA_ASSERT(numSteps > 0 && numSteps <= MAX_STEPS);
+  ZORBA_ASSERT(descendantSteps.size() == numSteps);
+
+  theContextNode = contextNode;
+
+  theNames.resize(numSteps);
+  theChildSteps = 0;
+  theDescendantSteps = 0;
+
+  for (csize i = 0; i < numSteps; ++i)
+  {
+    theNames[i] = static_cast<const QNameItem*>(names[i].getp())->getNormalized();
+
+    if (descendantSteps[i])
+      theDescendantSteps |= (1u << i);
+    else
+      theChildSteps |= (1u << i);
+  }
+
+  theCandidates = NULL;
+  theStartPos = 0;
+
+  // If the data guide of the tree shows that no path below the context node
+  // matches the steps, there is nothing to search.
+  ElementGuideNode* guide = theContextNode->getTree()->getDataGuide();
+
+  if (guide != NULL)
+  {
+    GuideNode* gnode = guide->findNode(theContextNode.getp());
+
+    if (gnode != NULL &&
+        gnode->getNodeKind() == store::StoreConsts::elementNode &&
+        !static_cast<ElementGuideNode*>(gnode)->hasPathMatch(theNames,
+                                                             descendantSteps))
+    {
+      theUseIndex = true;
+      return;
+    }
+  }
+
+  const TagIndex* index = theContextNode->getTree()->getTagIndex();
+
+  theUseIndex = (index != NULL);
+
+  if (theUseIndex)
+  {
+    theCandidates = index->getNodes(theNames[numSteps - 1]);
+
+    // Unless the context node is the root of the tree, skip the candidates
+    // that precede it in document order.
+    if (theCandidates != NULL && theContextNode->getParent() != NULL)
+    {
+      theStartPos = std::upper_bound(theCandidates->begin(),
+                                     theCandidates->end(),
+                                     theContextNode->getOrdPath(),
+                                     OrdPathComparison()) -
+                    theCandidates->begin();
+    }
+  }
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void TwigJoinIteratorImpl::open()
+{
+  thePos = theStartPos;
+
+  theStack.clear();
+
+  if (!theUseIndex)
+  {
+    Frame frame;
+    frame.theNode = theContextNode.getp();
+    frame.theNextChild = 0;
+    frame.theMatched = 1;
+    frame.theInherited = 1;
+    theStack.push_back(frame);
+  }
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void TwigJoinIteratorImpl::reset()
+{
+  open();
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void TwigJoinIteratorImpl::close()
+{
+  theContextNode = NULL;
+  theCandidates = NULL;
+  theStack.clear();
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+bool TwigJoinIteratorImpl::next(store::Item_t& result)
+{
+  if (theUseIndex ? nextCandidate(result) : nextInSubtree(result))
+    return true;
+
+  result = NULL;
+  return false;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+bool TwigJoinIteratorImpl::nextCandidate(store::Item_t& result)
+{
+  if (theCandidates == NULL)
+    return false;
+
+  csize numCandidates = theCandidates->size();
+
+  while (thePos < numCandidates)
+  {
+    ElementNode* candidate = (*theCandidates)[thePos++];
+
+    int match = checkCandidate(candidate);
+
+    if (match > 0)
+    {
+      result = candidate;
+      return true;
+    }
+    else if (match < 0)
+    {
+      // The candidate follows the subtree of the context node, and so do
+      // all of the remaining ones.
+      thePos = numCandidates;
+    }
+  }
+
+  return false;
+}
+
+
+/*******************************************************************************
+  Returns 1 if the given candidate matches the pattern, 0 if it does not, and -1
+  if it is not a descendant of the context node.
+
+  With p(0) being the context node and p(1), ..., p(m) being the nodes on the
+  path from the context node down to the candidate p(m), the row of step j in
+  theReached says which p(i) can match step j given that steps 1 to j-1 have
+  been matched by nodes above p(i). A child step can be matched by p(i) only if
+  the previous step was matched by p(i-1); a descendant step only if the
+  previous step was matched by any p(k) with k < i.
+********************************************************************************/
+int TwigJoinIteratorImpl::checkCandidate(const XmlNode* candidate)
+{
+  const XmlNode* ctxNode = theContextNode.getp();
+  const XmlNode* node = candidate;
+
+  thePathNames.clear();
+
+  while (node != ctxNode)
+  {
+    if (node == NULL)
+      return -1;
+
+    thePathNames.push_back(getNormalizedName(node));
+    node = static_cast<const XmlNode*>(node->getParent());
+  }
+
+  csize numSteps = theNames.size();
+  csize pathLen = thePathNames.size();
+
+  if (pathLen < numSteps)
+    return 0;
+
+  // thePathNames holds the names of p(m), ..., p(1), in that order. theReached
+  // holds the rows of the previous step and of the current step.
+  theReached.assign(2 * (pathLen + 1), 0);
+  char* prev = &theReached[0];
+  char* curr = prev + pathLen + 1;
+  prev[0] = 1;
+
+  for (csize j = 0; j < numSteps; ++j)
+  {
+    const store::Item* name = theNames[j];
+    bool isDescendant = ((theDescendantSteps & (1u << j)) != 0);
+    bool reachedAbove = false;
+    bool reachedAny = false;
+
+    curr[0] = 0;
+
+    for (csize i = 1; i <= pathLen; ++i)
+    {
+      reachedAbove = reachedAbove || prev[i - 1];
+
+      curr[i] = ((isDescendant ? reachedAbove : prev[i - 1] != 0) &&
+                 thePathNames[pathLen - i] == name);
+
+      reachedAny = reachedAny || curr[i];
+    }
+
+    if (!reachedAny)
+      return 0;
+
+    std::swap(prev, curr);
+  }
+
+  return (prev[pathLen] ? 1 : 0);
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+bool TwigJoinIteratorImpl::nextInSubtree(store::Item_t& result)
+{
+  uint32_t finalStep = (1u << theNames.size());
+
+  while (!theStack.empty())
+  {
+    Frame& top = theStack.back();
+
+    if (top.theNextChild == top.theNode->numChildren())
+    {
+      theStack.pop_back();
+      continue;
+    }
+
+    XmlNode* child = top.theNode->getChild(top.theNextChild++);
+
+    if (child->getNodeKind() != store::StoreConsts::elementNode)
+      continue;
+
+    uint32_t matched = matchSteps(child, top.theMatched, top.theInherited);
+    uint32_t inherited = top.theInherited | matched;
+
+    // Descend only if a step can still be matched below the child.
+    if ((matched & theChildSteps) || (inherited & theDescendantSteps))
+    {
+      const InternalNode* elem = static_cast<const InternalNode*>(child);
+
+      if (elem->numChildren() > 0)
+      {
+        Frame frame;
+        frame.theNode = elem;
+        frame.theNextChild = 0;
+        frame.theMatched = matched;
+        frame.theInherited = inherited;
+        theStack.push_back(frame);
+      }
+    }
+
+    if (matched & finalStep)
+    {
+      result = child;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+/*******************************************************************************
+  Returns the set of steps matched by the given element node, given the steps
+  matched by its parent and by its parent or any of the parent's ancestors.
+********************************************************************************/
+uint32_t TwigJoinIteratorImpl::matchSteps(
+    const XmlNode* node,
+    uint32_t parentMatched,
+    uint32_t parentInherited) const
+{
+  const store::Item* name = getNormalizedName(node);
+  uint32_t matched = 0;
+
+  csize numSteps = theNames.size();
+
+  for (csize j = 0; j < numSteps; ++j)
+  {
+    if (theNames[j] != name)
+      continue;
+
+    // Step j+1 can be matched if step j was matched by the parent (child
+    // axis) or by the parent or an ancestor of it (descendant axis).
+    uint32_t previous = ((theDescendantSteps & (1u << j)) ?
+                         parentInherited :
+                         parentMatched);
+
+    if (previous & (1u << j))
+      matched |= (1u << (j + 1));
+  }
+
+  return matched;
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////
 //                                                                             //
 //  class NodeDistinctIterator                                                 //
@@ -296,9 +638,7 @@ bool StoreNodeSortIterator::next(store::Item_t& result)
     
     // We are out of items. We can now begin to output the nodes. In the next
     // iteration, this part of the code will be skipped.
-    ComparisonFunction cmp(theAscending);
-
-    std::sort(theNodes.begin(), theNodes.end(), cmp);
+    sortNodes(theNodes, theAscending);
   }
 
   if (theCurrentNode < theNodes.size())
@@ -384,6 +724,244 @@ void StoreNodeSortIterator::close()
 }
 
 
+/*******************************************************************************
+  Sort the given nodes in document order (or reverse document order, if
+  "ascending" is false), leaving duplicate nodes adjacent to each other.
+********************************************************************************/
+void StoreNodeSortIterator::sortNodes(std::vector<XmlNode*>& nodes, bool ascending)
+{
+  csize numNodes = nodes.size();
+
+  if (numNodes < 2)
+    return;
+
+  // Sort in reverse document order by sorting the reversed input in document
+  // order: this turns descending runs into ascending ones.
+  if (!ascending)
+    std::reverse(nodes.begin(), nodes.end());
+
+  csize numRuns = 1;
+  for (csize i = 1; i < numNodes; ++i)
+  {
+    if (nodes[i]->compare2(nodes[i - 1]) < 0)
+      ++numRuns;
+  }
+
+  if (numRuns > 1)
+  {
+    if (numRuns * MIN_MERGE_RUN_LENGTH <= numNodes)
+      mergeRuns(nodes, numRuns);
+    else
+      sortByTree(nodes);
+  }
+
+  if (!ascending)
+    std::reverse(nodes.begin(), nodes.end());
+}
+
+
+namespace
+{
+
+/*******************************************************************************
+  An ordered run of nodes within a vector of nodes: [theBegin, theEnd).
+********************************************************************************/
+struct NodeRun
+{
+  csize theBegin;
+  csize theEnd;
+};
+
+
+/*******************************************************************************
+  Orders NodeRuns by their first nodes so that a heap of runs has the run with
+  the smallest first node on top.
+********************************************************************************/
+class NodeRunComparison
+{
+protected:
+  const std::vector<XmlNode*>& theNodes;
+
+public:
+  NodeRunComparison(const std::vector<XmlNode*>& nodes) : theNodes(nodes) { }
+
+  bool operator()(const NodeRun& r1, const NodeRun& r2) const
+  {
+    return (theNodes[r2.theBegin]->compare2(theNodes[r1.theBegin]) < 0);
+  }
+};
+
+
+/*******************************************************************************
+  Orders nodes of the same tree in document order.
+********************************************************************************/
+class InTreeComparison
+{
+public:
+  bool operator()(const XmlNode* n1, const XmlNode* n2) const
+  {
+    return (n1->compareInTree(n2) < 0);
+  }
+};
+
+
+/*******************************************************************************
+  Orders trees by the document order of their root nodes, i.e., by collection
+  id, and then by tree id or position within the collection.
+********************************************************************************/
+class TreeComparison
+{
+protected:
+  const std::vector<XmlTree*>& theTrees;
+
+public:
+  TreeComparison(const std::vector<XmlTree*>& trees) : theTrees(trees) { }
+
+  bool operator()(csize t1, csize t2) const
+  {
+    return (theTrees[t1]->getRoot()->compare2(theTrees[t2]->getRoot()) < 0);
+  }
+};
+
+}
+
+
+/*******************************************************************************
+  Merge the given number of ordered runs that the nodes consist of by a k-way
+  merge using a heap of runs.
+********************************************************************************/
+void StoreNodeSortIterator::mergeRuns(std::vector<XmlNode*>& nodes, csize numRuns)
+{
+  csize numNodes = nodes.size();
+
+  std::vector<NodeRun> runs;
+  runs.reserve(numRuns);
+
+  NodeRun run;
+  run.theBegin = 0;
+  for (csize i = 1; i < numNodes; ++i)
+  {
+    if (nodes[i]->compare2(nodes[i - 1]) < 0)
+    {
+      run.theEnd = i;
+      runs.push_back(run);
+      run.theBegin = i;
+    }
+  }
+  run.theEnd = numNodes;
+  runs.push_back(run);
+
+  NodeRunComparison cmp(nodes);
+  std::make_heap(runs.begin(), runs.end(), cmp);
+
+  std::vector<XmlNode*> merged;
+  merged.reserve(numNodes);
+
+  while (!runs.empty())
+  {
+    std::pop_heap(runs.begin(), runs.end(), cmp);
+
+    NodeRun& next = runs.back();
+    merged.push_back(nodes[next.theBegin++]);
+
+    if (next.theBegin < next.theEnd)
+      std::push_heap(runs.begin(), runs.end(), cmp);
+    else
+      runs.pop_back();
+  }
+
+  nodes.swap(merged);
+}
+
+
+/*******************************************************************************
+  Sort the nodes by a counting sort on the rank of their trees followed by a
+  sort of the nodes of each tree, unless they're already sorted.
+********************************************************************************/
+void StoreNodeSortIterator::sortByTree(std::vector<XmlNode*>& nodes)
+{
+  csize numNodes = nodes.size();
+
+  // Assign to each node the index of its tree in "trees". Nodes of the same
+  // tree tend to be adjacent, so the map is looked up only when the tree
+  // changes.
+  std::vector<XmlTree*> trees;
+  std::map<XmlTree*, csize> treeIndexes;
+  std::vector<csize> nodeTrees(numNodes);
+
+  XmlTree* prevTree = NULL;
+  csize prevIndex = 0;
+
+  for (csize i = 0; i < numNodes; ++i)
+  {
+    XmlTree* tree = nodes[i]->getTree();
+
+    if (tree != prevTree)
+    {
+      std::pair<std::map<XmlTree*, csize>::iterator, bool> ins =
+      treeIndexes.insert(std::make_pair(tree, trees.size()));
+
+      if (ins.second)
+        trees.push_back(tree);
+
+      prevTree = tree;
+      prevIndex = ins.first->second;
+    }
+
+    nodeTrees[i] = prevIndex;
+  }
+
+  csize numTrees = trees.size();
+
+  // Rank the trees and compute the start of the bucket of each tree.
+  std::vector<csize> rankedTrees(numTrees);
+  for (csize t = 0; t < numTrees; ++t)
+    rankedTrees[t] = t;
+
+  std::sort(rankedTrees.begin(), rankedTrees.end(), TreeComparison(trees));
+
+  std::vector<csize> bucketCounts(numTrees, 0);
+  for (csize i = 0; i < numNodes; ++i)
+    ++bucketCounts[nodeTrees[i]];
+
+  std::vector<csize> bucketStarts(numTrees);
+  csize start = 0;
+  for (csize r = 0; r < numTrees; ++r)
+  {
+    csize t = rankedTrees[r];
+    bucketStarts[t] = start;
+    start += bucketCounts[t];
+  }
+
+  // Distribute the nodes into their buckets, preserving their relative order.
+  std::vector<XmlNode*> sorted(numNodes);
+  for (csize i = 0; i < numNodes; ++i)
+    sorted[bucketStarts[nodeTrees[i]]++] = nodes[i];
+
+  // Sort each bucket: bucketStarts[t] is now the end of the bucket of tree t.
+  InTreeComparison cmp;
+  start = 0;
+  for (csize r = 0; r < numTrees; ++r)
+  {
+    std::vector<XmlNode*>::iterator begin = sorted.begin() + start;
+    std::vector<XmlNode*>::iterator end = sorted.begin() + bucketStarts[rankedTrees[r]];
+
+    for (std::vector<XmlNode*>::iterator ite = begin + 1; ite < end; ++ite)
+    {
+      if (cmp(*ite, *(ite - 1)))
+      {
+        std::sort(begin, end, cmp);
+        break;
+      }
+    }
+
+    start = bucketStarts[rankedTrees[r]];
+  }
+
+  nodes.swap(sorted);
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////
 //                                                                             //
 //  class StoreNodeSortOrAtomicIterator                                        //
@@ -427,9 +1005,7 @@ bool StoreNodeSortOrAtomicIterator::next(store::Item_t& result)
       result.release();
     }
 
-    ComparisonFunction cmp;
-
-    std::sort(theNodes.begin(), theNodes.end(), cmp);
+    sortNodes(theNodes, true);
   }
 
   if (theCurrentNode < theNodes.size())
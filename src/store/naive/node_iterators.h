@@ -24,6 +24,7 @@
 #include "shared_types.h"
 #include "node_items.h"
 #include "json_items.h"
+#include "tag_index.h"
 
 #include "zorbautils/hashfun.h"
 #include "zorbautils/hashset_structured_itemh.h"
@@ -358,6 +359,110 @@ public:
 };
 
 
+/*******************************************************************************
+  Implements the store::TwigJoinIterator interface.
+
+  If the tree of the context node uses a tag index (which the first twig join
+  over the tree builds), the element nodes named by the last step are the
+  candidate results. The candidates that are descendants
+  of the context node form a contiguous range of their (document-ordered) tag
+  index list, which is located via a binary search on the OrdPaths. Each
+  candidate is then checked against the whole pattern by collecting the names
+  on its path from the context node, so only the nodes with the last step's
+  name are ever visited, and the result is in document order without having to
+  be sorted or deduplicated.
+
+  Otherwise (e.g. the tree was constructed or updated), the subtree of the
+  context node is traversed once in document order. Each node carries the set
+  of steps that it matches and the set of steps that it or any of its ancestors
+  matches, so all the steps are evaluated during the same traversal, and the
+  subtrees below nodes where no step can match any more are skipped. In these
+  sets, bit 0 stands for the context node and bit i for the i-th step.
+
+  In either case, if the data guide of the tree shows that no path below the
+  context node matches the steps, nothing is searched at all.
+
+  theContextNode : The node whose subtree is searched.
+  theNames       : The normalized qnames of the steps.
+  theChildSteps  : Bit i-1 is set if the i-th step uses the child axis.
+  theDescendantSteps : Bit i-1 is set if the i-th step uses the descendant axis.
+  theCandidates  : The tag index list for the name of the last step, or NULL if
+                   there is no element with that name in the tree.
+  theUseIndex    : Whether the tag index is used or the subtree is traversed.
+  theStartPos    : The position in theCandidates of the first node after the
+                   context node in document order.
+  thePos         : The position in theCandidates of the next candidate.
+  thePathNames   : Scratch space holding the names on the path from a
+                   candidate up to the context node.
+  theReached     : Scratch space for checking a candidate.
+  theStack       : The traversal stack.
+********************************************************************************/
+class TwigJoinIteratorImpl : public store::TwigJoinIterator
+{
+protected:
+  struct Frame
+  {
+    const InternalNode * theNode;
+    csize                theNextChild;
+    uint32_t             theMatched;
+    uint32_t             theInherited;
+  };
+
+protected:
+  store::ItemHandle<InternalNode>  theContextNode;
+  std::vector<const store::Item*>  theNames;
+  uint32_t                         theChildSteps;
+  uint32_t                         theDescendantSteps;
+
+  const TagIndex::NodeList       * theCandidates;
+  bool                             theUseIndex;
+  csize                            theStartPos;
+  csize                            thePos;
+
+  std::vector<const store::Item*>  thePathNames;
+  std::vector<char>                theReached;
+
+  std::vector<Frame>               theStack;
+
+public:
+  TwigJoinIteratorImpl()
+    :
+    theChildSteps(0),
+    theDescendantSteps(0),
+    theCandidates(NULL),
+    theUseIndex(false),
+    theStartPos(0),
+    thePos(0)
+  {
+  }
+
+  void init(
+      const store::Item* contextNode,
+      const std::vector<store::Item_t>& names,
+      const std::vector<bool>& descendantSteps);
+
+  void open();
+
+  bool next(store::Item_t& result);
+
+  void reset();
+
+  void close();
+
+protected:
+  bool nextCandidate(store::Item_t& result);
+
+  bool nextInSubtree(store::Item_t& result);
+
+  int checkCandidate(const XmlNode* candidate);
+
+  uint32_t matchSteps(
+      const XmlNode* node,
+      uint32_t parentMatched,
+      uint32_t parentInherited) const;
+};
+
+
 /*******************************************************************************
   This iterator is used to eliminated duplicate nodes in the multiset of nodes
   produced by another iterator.
@@ -430,32 +535,29 @@ public:
   This iterator is used to sort by document order the nodes produced by another
   iterator.
 
+  The nodes are sorted by sortNodes(), which avoids a full comparison sort in
+  the common cases:
+
+  - If the input is already in order (e.g., a path step that the compiler
+    could not prove to be ordered, but is), nothing is done.
+  - If the input is a concatenation of ordered runs (e.g., the results of a
+    step for each of its context nodes), the runs are merged by a k-way merge,
+    as long as they are, on average, at least MIN_MERGE_RUN_LENGTH long.
+  - Otherwise, the nodes are first distributed into buckets, one per tree, by
+    a counting sort on the rank of their tree (so that the collection ids,
+    tree ids, and positions of the trees are compared only once per tree
+    rather than once per pair of nodes), and then each bucket is sorted, if
+    it's not sorted already, by comparing nodes within the tree only.
+
+  Duplicate nodes end up adjacent to each other in all cases.
+
   theInput  : input iterator
   theNodes  : A vector that stores rchandles to the nodes.
 ********************************************************************************/
 class StoreNodeSortIterator : public store::Iterator
 {
-protected:
-  class ComparisonFunction
-  {
-  protected:
-    bool theAscending;
-
-  public:
-    ComparisonFunction(bool asc = true) : theAscending(asc) { }
-
-    bool operator()(const XmlNode* n1, const XmlNode* n2) const
-    {
-      if (theAscending)
-      {
-        return (n1->compare2(n2) < 0);
-      }
-      else
-      {
-        return (n2->compare2(n1) < 0);
-      }
-    }
-  };
+public:
+  static const csize MIN_MERGE_RUN_LENGTH = 8;
 
 protected:
   store::Iterator_t       theInput;
@@ -486,6 +588,13 @@ public:
   bool next(store::Item_t& result);
   void reset();
   void close();
+
+  static void sortNodes(std::vector<XmlNode*>& nodes, bool ascending);
+
+protected:
+  static void mergeRuns(std::vector<XmlNode*>& nodes, csize numRuns);
+
+  static void sortByTree(std::vector<XmlNode*>& nodes);
 };
 
 
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "stdafx.h"
+
+#include <algorithm>
+
+#include "projection_automaton.h"
+
+
+namespace zorba
+{
+namespace simplestore
+{
+
+
+/*******************************************************************************
+
+********************************************************************************/
+ProjectionAutomaton::ProjectionAutomaton(const store::DocProjection& projection)
+{
+  StateSet startStates;
+
+  csize numPaths = projection.numPaths();
+
+  for (csize p = 0; p < numPaths; ++p)
+  {
+    const store::DocProjection::Path& path = projection.getPath(p);
+
+    startStates.push_back(theSteps.size());
+
+    for (csize i = 0; i < path.size(); ++i)
+      theSteps.push_back(&path[i]);
+
+    theSteps.push_back(NULL);
+  }
+
+  addStateSet(startStates);
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+csize ProjectionAutomaton::addStateSet(const StateSet& states)
+{
+  std::map<StateSet, csize>::const_iterator ite = theStateIds.find(states);
+
+  if (ite != theStateIds.end())
+    return ite->second;
+
+  csize id = theStateSets.size();
+
+  theStateSets.push_back(states);
+  theTransitions.push_back(TransitionMap());
+  theStateIds[states] = id;
+
+  return id;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+bool ProjectionAutomaton::matches(
+    const store::DocProjection::Step* step,
+    const store::Item* name)
+{
+  return step->theName == NULL || step->theName->equals(name);
+}
+
+
+/*******************************************************************************
+  An element selected by the last step of a path is kept with its subtree. An
+  element whose attributes are selected by the last step of a path is kept
+  even if it has no children. Any other element that some path can still go
+  through is kept only if, in the end, some of its children are kept too.
+********************************************************************************/
+ProjectionAutomaton::Transition ProjectionAutomaton::transition(
+    csize state,
+    const store::Item* name)
+{
+  TransitionMap::const_iterator ite = theTransitions[state].find(name);
+
+  if (ite != theTransitions[state].end())
+    return ite->second;
+
+  StateSet targets;
+  Action action = SKIP;
+
+  const StateSet& sources = theStateSets[state];
+  csize numSources = sources.size();
+
+  for (csize i = 0; i < numSources; ++i)
+  {
+    csize source = sources[i];
+    const store::DocProjection::Step* step = theSteps[source];
+
+    if (step->theAxis == store::DocProjection::ATTRIBUTE)
+      continue;
+
+    if (step->theAxis == store::DocProjection::DESCENDANT)
+      targets.push_back(source);
+
+    if (matches(step, name))
+    {
+      const store::DocProjection::Step* next = theSteps[source + 1];
+
+      if (next == NULL)
+        action = KEEP_ALL;
+      else if (next->theAxis == store::DocProjection::ATTRIBUTE && action != KEEP_ALL)
+        action = KEEP;
+
+      targets.push_back(source + 1);
+    }
+  }
+
+  Transition result;
+
+  if (action == KEEP_ALL)
+  {
+    result.theAction = KEEP_ALL;
+  }
+  else if (!targets.empty())
+  {
+    std::sort(targets.begin(), targets.end());
+    targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+
+    result.theTarget = addStateSet(targets);
+    result.theAction = (action == KEEP ? KEEP : CONNECT);
+  }
+
+  return theTransitions[state].insert(std::make_pair(name, result)).first->second;
+}
+
+
+} // namespace simplestore
+} // namespace zorba
+/* vim:set et sw=2 ts=2: */
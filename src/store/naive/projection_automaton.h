@@ -0,0 +1,120 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ZORBA_SIMPLE_STORE_PROJECTION_AUTOMATON
+#define ZORBA_SIMPLE_STORE_PROJECTION_AUTOMATON
+
+#include <map>
+#include <vector>
+
+#include "store/api/doc_projection.h"
+
+
+namespace zorba
+{
+namespace simplestore
+{
+
+
+/*******************************************************************************
+  Tells the FastXmlLoader, for each element it encounters, what part of it a
+  DocProjection keeps.
+
+  The paths of the projection are compiled into a nondeterministic automaton
+  whose state (p, i) means that the first i steps of path p have selected the
+  current element (or, for i = 0, that the current element is the document
+  node or on a path of descendants below an element that was selected by the
+  previous step). The states of path p are numbered consecutively, after
+  those of the paths before it.
+
+  The deterministic automaton that the loader actually runs is built lazily,
+  as element names are encountered: each of its states is a (sorted) set of
+  nondeterministic states, and its state 0 is the state of the document node.
+
+  theSteps       : The step taken from each nondeterministic state, i.e., step
+                   i of path p for state (p, i), or NULL for the final state
+                   of a path.
+  theStateSets   : The set of nondeterministic states of each state.
+  theStateIds    : Maps each set in theStateSets to its position there.
+  theTransitions : For each state, the transitions computed so far, keyed by
+                   element name. Names are pooled qnames, so a pointer stands
+                   for a name (with a given prefix).
+********************************************************************************/
+class ProjectionAutomaton
+{
+public:
+  enum Action
+  {
+    SKIP,      // Neither the element nor any of its descendants is kept.
+    KEEP_ALL,  // The whole subtree of the element is kept.
+    KEEP,      // The element is kept with its attributes, and its children
+               // are decided by the transitions out of the new state.
+    CONNECT    // As KEEP, but the element is dropped again if none of its
+               // children is kept.
+  };
+
+  struct Transition
+  {
+    csize   theTarget;
+    Action  theAction;
+
+    Transition() : theTarget(0), theAction(SKIP) {}
+
+    Transition(csize target, Action action)
+      :
+      theTarget(target),
+      theAction(action)
+    {
+    }
+  };
+
+protected:
+  typedef std::vector<csize> StateSet;
+
+  typedef std::map<const store::Item*, Transition> TransitionMap;
+
+  std::vector<const store::DocProjection::Step*>  theSteps;
+  std::vector<StateSet>                           theStateSets;
+  std::map<StateSet, csize>                       theStateIds;
+  std::vector<TransitionMap>                      theTransitions;
+
+public:
+  ProjectionAutomaton(const store::DocProjection& projection);
+
+  static csize getStartState() { return 0; }
+
+  /**
+   * Returns the state and the action for an element with the given (pooled)
+   * name whose parent is in the given state.
+   */
+  Transition transition(csize state, const store::Item* name);
+
+protected:
+  csize addStateSet(const StateSet& states);
+
+  static bool matches(const store::DocProjection::Step* step, const store::Item* name);
+};
+
+
+} // namespace simplestore
+} // namespace zorba
+
+#endif
+/*
+ * Local variables:
+ * mode: c++
+ * End:
+ */
+/* vim:set et sw=2 ts=2: */
@@ -1955,8 +1955,7 @@ void UpdRemoveFromHashMap::apply()
     ERROR_PARAMS(theQName->getStringValue()));
   }
 
-  simplestore::ValueHashIndex* lImpl =
-    static_cast<simplestore::ValueHashIndex*>(lMap.getp());
+  ValueIndex* lImpl = static_cast<ValueIndex*>(lMap.getp());
 
   store::IndexKey lKey;
   for (std::vector<store::Item_t>::const_iterator lIter = theKey.begin();
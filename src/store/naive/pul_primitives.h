@@ -256,6 +256,7 @@ public:
 class UpdInsertAttributes : public UpdatePrimitive
 {
   friend class PULImpl;
+  friend class CollectionPul;
   friend class ElementNode;
   friend class PULPrimitiveFactory;
 
@@ -96,6 +96,7 @@ class IndexConditionImpl : public store::IndexCondition
 {
   friend class ProbeValueTreeIndexIterator;
   friend class ProbeValueHashIndexIterator;
+  friend class ProbeSingleKeyHashIndexIterator;
   friend class ProbeGeneralIndexIterator;
   friend class ProbeGeneralHashIndexIterator;
   friend class ProbeGeneralTreeIndexIterator;
@@ -237,6 +238,7 @@ class IndexPointCondition : public IndexConditionImpl
 {
   friend class ProbeValueTreeIndexIterator;
   friend class ProbeValueHashIndexIterator;
+  friend class ProbeSingleKeyHashIndexIterator;
   friend class ProbeGeneralHashIndexIterator;
   friend class ProbeGeneralTreeIndexIterator;
 
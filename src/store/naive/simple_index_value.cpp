@@ -572,6 +572,335 @@ void ProbeValueHashIndexIterator::count(store::Item_t& result)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//  Single Key Hash Index                                                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+
+/******************************************************************************
+
+********************************************************************************/
+uint32_t SingleKeyCompareFunction::hash(const store::Item* key) const
+{
+  return (key == NULL ? 0 : key->hash(theTimezone, theCollator));
+}
+
+
+/******************************************************************************
+
+********************************************************************************/
+bool SingleKeyCompareFunction::equal(
+    const store::Item* key1,
+    const store::Item* key2) const
+{
+  if (key1 == NULL || key2 == NULL)
+    return key1 == key2;
+
+  return key1->equals(key2, theTimezone, theCollator);
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+SingleKeyHashIndex::KeyIterator::KeyIterator(const IndexMap& aMap)
+  :
+  theMap(aMap)
+{
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+SingleKeyHashIndex::KeyIterator::~KeyIterator()
+{
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void SingleKeyHashIndex::KeyIterator::open()
+{
+  theIterator = theMap.begin();
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+bool SingleKeyHashIndex::KeyIterator::next(store::IndexKey& aKey)
+{
+  if (theIterator != theMap.end())
+  {
+    aKey.resize(1);
+    aKey[0] = (*theIterator).first;
+
+    ++theIterator;
+    return true;
+  }
+  return false;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void SingleKeyHashIndex::KeyIterator::close()
+{
+  theIterator = theMap.end();
+}
+
+
+/******************************************************************************
+
+********************************************************************************/
+SingleKeyHashIndex::SingleKeyHashIndex(
+    const store::Item_t& qname,
+    const store::IndexSpecification& spec)
+  :
+  ValueIndex(qname, spec),
+  theMap(SingleKeyCompareFunction(spec.theTimezone, theCompFunction.getCollator(0)),
+         1024,
+         spec.theIsThreadSafe)
+{
+  assert(getNumColumns() == 1);
+}
+
+
+/******************************************************************************
+
+********************************************************************************/
+SingleKeyHashIndex::~SingleKeyHashIndex()
+{
+  clear();
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void SingleKeyHashIndex::clear()
+{
+  IndexMap::iterator ite = theMap.begin();
+  IndexMap::iterator end = theMap.end();
+
+  for (; ite != end; ++ite)
+  {
+    if ((*ite).first != NULL)
+      (*ite).first->removeReference();
+
+    delete (*ite).second;
+  }
+
+  theMap.clear();
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+csize SingleKeyHashIndex::size() const
+{
+  return theMap.size();
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+store::Index::KeyIterator_t SingleKeyHashIndex::keys() const
+{
+  return new KeyIterator(theMap);
+}
+
+
+/*******************************************************************************
+  Insert the given item in the value set of the given key. If the key is not
+  in the index already, then the key item is inserted as well. Return true if
+  the key was already in the index, false otherwise. In the latter case, the
+  given key is deleted.
+********************************************************************************/
+bool SingleKeyHashIndex::insert(store::IndexKey*& key, store::Item_t& value)
+{
+  if (key->size() != 1)
+  {
+    RAISE_ERROR_NO_LOC(zerr::ZSTR0003_INDEX_PARTIAL_KEY_INSERT,
+    ERROR_PARAMS(key->toString(), theQname->getStringValue()));
+  }
+
+  store::Item* keyItem = (*key)[0].getp();
+
+  IndexMap::iterator pos = theMap.find(keyItem);
+
+  if (pos != theMap.end())
+  {
+    if (isUnique())
+    {
+      RAISE_ERROR_NO_LOC(zerr::ZDDY0024_INDEX_UNIQUE_VIOLATION,
+      ERROR_PARAMS(theQname->getStringValue()));
+    }
+
+    (*pos).second->transfer_back(value);
+    return true;
+  }
+
+  ValueIndexValue* valueSet = new ValueIndexValue(1);
+  (*valueSet)[0].transfer(value);
+
+  if (keyItem != NULL)
+    keyItem->addReference();
+
+  theMap.insert(keyItem, valueSet);
+
+  delete key;
+  key = NULL;
+
+  return false;
+}
+
+
+/******************************************************************************
+  Same as ValueHashIndex::remove().
+********************************************************************************/
+bool SingleKeyHashIndex::remove(
+    const store::IndexKey* key,
+    const store::Item_t& value,
+    bool all)
+{
+  if (key->size() != 1)
+  {
+    RAISE_ERROR_NO_LOC(zerr::ZSTR0004_INDEX_PARTIAL_KEY_REMOVE,
+    ERROR_PARAMS(key->toString(), theQname->getStringValue()));
+  }
+
+  IndexMap::iterator pos = theMap.find((*key)[0].getp());
+
+  if (pos == theMap.end())
+    return false;
+
+  store::Item* keyItem = (*pos).first;
+  ValueIndexValue* valueSet = (*pos).second;
+
+  if (!all)
+  {
+    ValueIndexValue::iterator valIte =
+    std::find(valueSet->begin(), valueSet->end(), value);
+
+    if (valIte == valueSet->end())
+      return false;
+
+    valueSet->theItems.erase(valIte);
+
+    if (!valueSet->empty())
+      return true;
+  }
+
+  theMap.erase(pos);
+
+  if (keyItem != NULL)
+    keyItem->removeReference();
+
+  delete valueSet;
+
+  return true;
+}
+
+
+/******************************************************************************
+
+********************************************************************************/
+void ProbeSingleKeyHashIndexIterator::init(
+    const store::IndexCondition_t& cond,
+    const xs_integer& aSkip)
+{
+  theSkip = aSkip;
+
+  theCondition = reinterpret_cast<IndexPointCondition*>(cond.getp());
+
+  assert(theCondition->theKey.size() == 1);
+
+  theResultSet = NULL;
+
+  theIndex->theMap.get(theCondition->theKey[0].getp(), theResultSet);
+
+  if (theResultSet)
+  {
+    theIte = theResultSet->begin();
+    theEnd = theResultSet->end();
+  }
+}
+
+
+/******************************************************************************
+
+********************************************************************************/
+void ProbeSingleKeyHashIndexIterator::open()
+{
+  reset();
+}
+
+
+/******************************************************************************
+
+********************************************************************************/
+void ProbeSingleKeyHashIndexIterator::reset()
+{
+  if (theResultSet)
+  {
+    theIte = theResultSet->begin();
+
+    if (theSkip >= theResultSet->size())
+      theIte = theEnd;
+    else
+      theIte += static_cast<csize>(to_xs_long(theSkip));
+  }
+}
+
+
+/******************************************************************************
+
+********************************************************************************/
+void ProbeSingleKeyHashIndexIterator::close()
+{
+  theCondition = NULL;
+  theResultSet = NULL;
+}
+
+
+/******************************************************************************
+
+********************************************************************************/
+bool ProbeSingleKeyHashIndexIterator::next(store::Item_t& result)
+{
+  if (theResultSet && theIte != theEnd)
+  {
+    result = (*theIte);
+    ++theIte;
+    return true;
+  }
+
+  return false;
+}
+
+
+/******************************************************************************
+
+********************************************************************************/
+void ProbeSingleKeyHashIndexIterator::count(store::Item_t& result)
+{
+  xs_integer res = xs_integer(0);
+
+  if (theResultSet && theSkip < theResultSet->size())
+    res = xs_integer(theResultSet->size()) - theSkip;
+
+  GET_FACTORY().createInteger(result, res);
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////
 //                                                                             //
 //  Value Tree Index                                                           //
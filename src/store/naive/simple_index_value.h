@@ -91,6 +91,8 @@ public:
 
   virtual bool isTreeIndex() = 0;
 
+  virtual bool isSingleKeyIndex() { return false; }
+
   virtual bool insert(store::IndexKey*& key, store::Item_t& item) = 0;
 
   virtual bool remove(
@@ -194,6 +196,131 @@ public:
 };
 
 
+/******************************************************************************
+  Hash and equality function for the keys of a SingleKeyHashIndex. It does not
+  own the collator, which belongs to the compare function of the index.
+********************************************************************************/
+class SingleKeyCompareFunction
+{
+private:
+  long                 theTimezone;
+  const XQPCollator  * theCollator;
+
+public:
+  SingleKeyCompareFunction(long timezone, const XQPCollator* collator)
+    :
+    theTimezone(timezone),
+    theCollator(collator)
+  {
+  }
+
+  uint32_t hash(const store::Item* key) const;
+
+  bool equal(const store::Item* key1, const store::Item* key2) const;
+};
+
+
+/******************************************************************************
+  A hash-based value index with a single key column. It is used for the maps
+  whose keys consist of a single atomic item, and it maps the key item itself,
+  rather than a one-item IndexKey, to the value set of the key. The index holds
+  a reference to each key item in theMap.
+
+  The insert() and remove() methods accept the same IndexKeys as those of the
+  ValueHashIndex, but insert() does not keep the given key; if it takes the
+  ownership of the key (i.e., returns false), it deletes it.
+********************************************************************************/
+class SingleKeyHashIndex : public ValueIndex
+{
+  friend class Store;
+  friend class ProbeSingleKeyHashIndexIterator;
+
+  typedef HashMap<store::Item*,
+                  ValueIndexValue*,
+                  SingleKeyCompareFunction> IndexMap;
+
+protected:
+
+  class KeyIterator : public Index::KeyIterator
+  {
+  protected:
+    IndexMap::iterator   theIterator;
+    const IndexMap     & theMap;
+
+  public:
+    KeyIterator(const IndexMap& aMap);
+
+    ~KeyIterator();
+
+    void open();
+    bool next(store::IndexKey&);
+    void close();
+  };
+
+  typedef rchandle<KeyIterator> KeyIterator_t;
+
+private:
+  IndexMap  theMap;
+
+protected:
+  SingleKeyHashIndex(
+      const store::Item_t& qname,
+      const store::IndexSpecification& spec);
+
+  ~SingleKeyHashIndex();
+
+public:
+  bool isTreeIndex() { return false; }
+
+  bool isSingleKeyIndex() { return true; }
+
+  void clear();
+
+  csize size() const;
+
+  Index::KeyIterator_t keys() const;
+
+  bool insert(store::IndexKey*& key, store::Item_t& item);
+
+  bool remove(const store::IndexKey* key, const store::Item_t& item, bool all);
+};
+
+
+/******************************************************************************
+  Iterator to probe a SingleKeyHashIndex
+********************************************************************************/
+class ProbeSingleKeyHashIndexIterator : public store::IndexProbeIterator
+{
+protected:
+  rchandle<SingleKeyHashIndex>           theIndex;
+
+  rchandle<IndexPointCondition>          theCondition;
+
+  ValueIndexValue                      * theResultSet;
+  ValueIndexValue::const_iterator        theIte;
+  ValueIndexValue::const_iterator        theEnd;
+  xs_integer                             theSkip;
+
+public:
+  ProbeSingleKeyHashIndexIterator(const store::Index_t& index) : theResultSet(NULL)
+  {
+    theIndex = static_cast<SingleKeyHashIndex*>(index.getp());
+  }
+
+  void init(const store::IndexCondition_t& cond, const xs_integer& aSkip);
+
+  void open();
+
+  bool next(store::Item_t& result);
+
+  void reset();
+
+  void close();
+
+  void count(store::Item_t& result);
+};
+
+
 /******************************************************************************
 
 ********************************************************************************/
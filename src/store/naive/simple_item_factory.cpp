@@ -1182,6 +1182,18 @@ bool BasicItemFactory::createStreamableBase64Binary(
 }
 
 
+bool BasicItemFactory::createSharedStreamableBase64Binary(
+    store::Item_t& result,
+    store::Item_t& streamable_dependent,
+    bool encoded)
+{
+  result = new StreamableBase64BinaryItem(store::XS_BASE64BINARY,
+                                          streamable_dependent,
+                                          encoded);
+  return true;
+}
+
+
 bool BasicItemFactory::createHexBinary(store::Item_t& result,
                                        xs_hexBinary const &value)
 {
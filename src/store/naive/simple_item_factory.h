@@ -141,6 +141,11 @@ public:
       bool seekable = false,
       bool encoded = false);
 
+  bool createSharedStreamableBase64Binary(
+      store::Item_t& result,
+      store::Item_t& streamable_dependent,
+      bool encoded = false);
+
   bool createBoolean(store::Item_t& result, xs_boolean value);
 
 
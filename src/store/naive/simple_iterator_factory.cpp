@@ -55,6 +55,15 @@ store::AttributesIterator* SimpleIteratorFactory::createAttributesIterator()
 }
 
 
+/*******************************************************************************
+
+********************************************************************************/
+store::TwigJoinIterator* SimpleIteratorFactory::createTwigJoinIterator()
+{
+  return new TwigJoinIteratorImpl();
+}
+
+
 /*******************************************************************************
 
 ********************************************************************************/
@@ -75,6 +84,10 @@ store::IndexProbeIterator* SimpleIteratorFactory::createIndexProbeIterator(
   else if (idx->isSorted())
     return new ProbeValueTreeIndexIterator(index);
 
+  // value, hash, single key
+  else if (static_cast<ValueIndex*>(idx)->isSingleKeyIndex())
+    return new ProbeSingleKeyHashIndexIterator(index);
+
   // value, hash
   else
     return new ProbeValueHashIndexIterator(index);
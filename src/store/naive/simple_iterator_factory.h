@@ -37,6 +37,8 @@ public:
 
   store::AttributesIterator* createAttributesIterator();
 
+  store::TwigJoinIterator* createTwigJoinIterator();
+
   store::IndexProbeIterator* createIndexProbeIterator(const store::Index_t& index);
 
   store::TempSeqIterator* createTempSeqIterator(bool lazy);
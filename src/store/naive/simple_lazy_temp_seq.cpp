@@ -63,6 +63,8 @@ void SimpleLazyTempSeq::clear()
   }
 
   theItems.clear();
+
+  theMemory.releaseAll();
 }
 
 
@@ -80,6 +82,7 @@ void SimpleLazyTempSeq::matNextItem()
   }
   else
   {
+    theMemory.charge(item.getp());
     theItems.push_back(item.get());
     item.release();
   }
@@ -186,6 +189,9 @@ void SimpleLazyTempSeq::purgeUpTo(xs_integer position)
   std::vector<store::Item*>::iterator end = theItems.begin() + static_cast<std::vector<store::Item*>::size_type>(pos - thePurgedUpTo);
   for (; ite != end; ++ite)
   {
+    if (theMemory.getAccount())
+      theMemory.release(store::MemoryAccount::getItemSize(*ite));
+
     (*ite)->removeReference();
   }
 
@@ -292,6 +298,22 @@ store::Iterator_t SimpleLazyTempSeq::getIterator() const
 }
 
 
+/*******************************************************************************
+  Charges the items that are already buffered to the new account.
+********************************************************************************/
+void SimpleLazyTempSeq::setMemoryAccount(store::MemoryAccount* account)
+{
+  theMemory.attach(account);
+
+  std::vector<store::Item*>::const_iterator ite = theItems.begin();
+  std::vector<store::Item*>::const_iterator end = theItems.end();
+  for (; ite != end; ++ite)
+  {
+    theMemory.charge(*ite);
+  }
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////
 //                                                                             //
 //  SimpleLazyTempSeqIter                                                      //
@@ -22,6 +22,7 @@
 #include "zorba/diagnostic_list.h"
 #include "diagnostics/diagnostic.h"
 #include "store/api/iterator.h"
+#include "store/api/memory_account.h"
 #include "store/api/temp_seq.h"
 #include "store/api/copymode.h"
 
@@ -51,6 +52,11 @@ typedef rchandle<class SimpleLazyTempSeq> SimpleLazyTempSeq_t;
   theItems :
   ----------
   Vector storing the cached items.
+
+  theMemory :
+  -----------
+  The memory of theItems, as charged to the account given by setMemoryAccount(),
+  if any.
 ********************************************************************************/
 class SimpleLazyTempSeq : public store::TempSeq 
 {
@@ -63,6 +69,8 @@ class SimpleLazyTempSeq : public store::TempSeq
   
   std::vector<store::Item*>  theItems; // ref-counting is done manually
 
+  store::MemoryCharge        theMemory;
+
  private:
   void clear();
 
@@ -96,6 +104,8 @@ class SimpleLazyTempSeq : public store::TempSeq
   bool containsItem(xs_integer pos);
 
   store::Iterator_t getIterator() const;
+
+  void setMemoryAccount(store::MemoryAccount* account);
   
 #ifndef NDEBUG
   // toString() debugging method.
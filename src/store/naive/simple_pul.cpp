@@ -28,6 +28,7 @@
 #include "simple_pul.h"
 #include "pul_primitives.h"
 #include "node_items.h"
+#include "dataguide.h"
 #include "json_items.h"
 #include "atomic_items.h"
 #include "pul_primitive_factory.h"
@@ -2302,7 +2303,10 @@ void PULImpl::checkTransformUpdates(const std::vector<store::Item*>& rootNodes)
   the docs that belong to that collection already).
 
   As a side-effect, the method will also collect in theModifiedDocs all the
-  exisiting collection docs that are modified by this pul.
+  exisiting collection docs that are modified by this pul. For each modified
+  doc that is a JSON object and whose updates all insert, delete, rename, or
+  replace the value of its own fields, the names of these fields are collected
+  in theModifiedDocFields.
 
   This method is invoked by the ApplyIterator before any of the pul primitives
   is applied.
@@ -2343,6 +2347,10 @@ void PULImpl::getIndicesToRefresh(
       continue;
     }
 
+    // The modified docs whose updates are not all field updates on the doc
+    // itself.
+    std::set<store::Item*> opaqueDocs;
+
     NodeToUpdatesMap::iterator ite = pul->theNodeToUpdatesMap.begin();
     NodeToUpdatesMap::iterator end = pul->theNodeToUpdatesMap.end();
     for (; ite != end; ++ite)
@@ -2351,8 +2359,16 @@ void PULImpl::getIndicesToRefresh(
       ZORBA_ASSERT(item->isStructuredItem());
 
       StructuredItem* structuredItem = static_cast<StructuredItem*>(item);
-      pul->theModifiedDocs.insert(structuredItem->getCollectionRoot());
-      continue;
+      store::Item* root = structuredItem->getCollectionRoot();
+      pul->theModifiedDocs.insert(root);
+
+      if (item != root ||
+          !item->isObject() ||
+          !CollectionPul::getUpdatedFields(*(*ite).second,
+                                           pul->theModifiedDocFields[root]))
+      {
+        opaqueDocs.insert(root);
+      }
     }
 
     csize numCollUpdates = pul->theEditInCollectionList.size();
@@ -2363,8 +2379,15 @@ void PULImpl::getIndicesToRefresh(
       static_cast<UpdEditInCollection*>(pul->theEditInCollectionList[i]);
 
       pul->theModifiedDocs.insert(upd->getTarget());
+      opaqueDocs.insert(upd->getTarget());
     }
 
+    std::set<store::Item*>::const_iterator opaqueIte = opaqueDocs.begin();
+    std::set<store::Item*>::const_iterator opaqueEnd = opaqueDocs.end();
+
+    for (; opaqueIte != opaqueEnd; ++opaqueIte)
+      pul->theModifiedDocFields.erase(*opaqueIte);
+
     numCollUpdates = pul->theInsertIntoCollectionList.size();
 
     for (csize i = 0; i < numCollUpdates; ++i)
@@ -2722,6 +2745,303 @@ void CollectionPul::switchPulInPrimitivesList(std::vector<UpdatePrimitive*>& lis
 }
 
 
+/*******************************************************************************
+  Drop the tag index (if any) of the tree of each node that is the target of a
+  primitive in the given list.
+********************************************************************************/
+void CollectionPul::dropTagIndexes(std::vector<UpdatePrimitive*>& list)
+{
+  std::vector<UpdatePrimitive*>::iterator ite = list.begin();
+  std::vector<UpdatePrimitive*>::iterator end = list.end();
+  for (; ite != end; ++ite)
+  {
+    store::Item* target = (*ite)->theTarget.getp();
+
+    if (target != NULL && target->isNode())
+      static_cast<XmlNode*>(target)->getTree()->dropTagIndex();
+  }
+}
+
+
+/*******************************************************************************
+  Return the data guide delta of the given tree, or NULL if the tree has no data
+  guide.
+********************************************************************************/
+CollectionPul::DataGuideDelta* CollectionPul::getDataGuideDelta(XmlTree* tree)
+{
+  ElementGuideNode* guide = tree->getDataGuide();
+
+  if (guide == NULL)
+    return NULL;
+
+  DataGuideDelta& delta = theDataGuideDeltas[tree];
+  delta.theGuide = guide;
+  return &delta;
+}
+
+
+/*******************************************************************************
+  For each primitive in the given list whose target belongs to a tree with a
+  data guide, append to removedRoots the roots of the subtrees that the
+  primitive removes from the tree, add to renamedRoots the node that the
+  primitive renames, and register with the tree's delta the roots of the
+  subtrees that the primitive adds to the tree or renames.
+********************************************************************************/
+void CollectionPul::collectDataGuideRoots(
+    std::vector<UpdatePrimitive*>& list,
+    std::vector<XmlNode*>& removedRoots,
+    std::set<const XmlNode*>& renamedRoots)
+{
+  std::vector<UpdatePrimitive*>::iterator ite = list.begin();
+  std::vector<UpdatePrimitive*>::iterator end = list.end();
+  for (; ite != end; ++ite)
+  {
+    UpdatePrimitive* upd = *ite;
+    store::Item* target = upd->theTarget.getp();
+
+    if (target == NULL || !target->isNode())
+      continue;
+
+    XmlNode* targetNode = static_cast<XmlNode*>(target);
+    DataGuideDelta* delta = getDataGuideDelta(targetNode->getTree());
+
+    if (delta == NULL)
+      continue;
+
+    const std::vector<store::Item_t>* newNodes = NULL;
+
+    switch (upd->getKind())
+    {
+    case store::UpdateConsts::UP_DELETE:
+    {
+      removedRoots.push_back(targetNode);
+      break;
+    }
+    case store::UpdateConsts::UP_INSERT_INTO:
+    case store::UpdateConsts::UP_INSERT_INTO_FIRST:
+    case store::UpdateConsts::UP_INSERT_INTO_LAST:
+    case store::UpdateConsts::UP_INSERT_BEFORE:
+    case store::UpdateConsts::UP_INSERT_AFTER:
+    {
+      newNodes = &static_cast<UpdInsertChildren*>(upd)->theNewChildren;
+      break;
+    }
+    case store::UpdateConsts::UP_INSERT_ATTRIBUTES:
+    {
+      newNodes = &static_cast<UpdInsertAttributes*>(upd)->theNewAttrs;
+      break;
+    }
+    case store::UpdateConsts::UP_REPLACE_CHILD:
+    {
+      UpdReplaceChild* upd2 = static_cast<UpdReplaceChild*>(upd);
+      removedRoots.push_back(BASE_NODE(upd2->theChild));
+      newNodes = &upd2->theNewChildren;
+      break;
+    }
+    case store::UpdateConsts::UP_REPLACE_ATTRIBUTE:
+    {
+      UpdReplaceAttribute* upd2 = static_cast<UpdReplaceAttribute*>(upd);
+      removedRoots.push_back(BASE_NODE(upd2->theAttr));
+      newNodes = &upd2->theNewAttrs;
+      break;
+    }
+    case store::UpdateConsts::UP_REPLACE_CONTENT:
+    {
+      InternalNode* elem = static_cast<InternalNode*>(targetNode);
+      csize numChildren = elem->numChildren();
+      for (csize i = 0; i < numChildren; ++i)
+        removedRoots.push_back(elem->getChild(i));
+      break;
+    }
+    case store::UpdateConsts::UP_RENAME_ELEM:
+    case store::UpdateConsts::UP_RENAME_ATTR:
+    {
+      renamedRoots.insert(targetNode);
+      delta->theAddedRoots.push_back(targetNode);
+      break;
+    }
+    default:
+      break;
+    }
+
+    if (newNodes != NULL)
+    {
+      csize numNodes = newNodes->size();
+      for (csize i = 0; i < numNodes; ++i)
+        delta->theAddedRoots.push_back(BASE_NODE((*newNodes)[i]));
+    }
+  }
+}
+
+
+/*******************************************************************************
+  Compute, before any modifications are actually applied, the changes that the
+  XQUF primitives of this PUL make to the data guides of the updated trees. The
+  guide nodes of the subtrees that are removed or renamed are collected here,
+  while the nodes still have their old names and positions; the guide nodes of
+  the subtrees that are added or renamed are computed after the modifications
+  (see applyDataGuideDeltas()). If a removed subtree cannot be located in the
+  guide (e.g. because it is the whole tree), the guide is dropped instead.
+********************************************************************************/
+void CollectionPul::computeDataGuideDeltas()
+{
+  std::vector<XmlNode*> removedRoots;
+  std::set<const XmlNode*> renamedRoots;
+
+  collectDataGuideRoots(theDoFirstList, removedRoots, renamedRoots);
+  collectDataGuideRoots(theInsertList, removedRoots, renamedRoots);
+  collectDataGuideRoots(theReplaceNodeList, removedRoots, renamedRoots);
+  collectDataGuideRoots(theReplaceContentList, removedRoots, renamedRoots);
+  collectDataGuideRoots(theDeleteList, removedRoots, renamedRoots);
+
+  theDataGuideRemovedRoots.insert(removedRoots.begin(), removedRoots.end());
+
+  std::set<const XmlNode*> collectedSet(theDataGuideRemovedRoots);
+  collectedSet.insert(renamedRoots.begin(), renamedRoots.end());
+
+  std::set<const XmlNode*>::const_iterator ite = collectedSet.begin();
+  std::set<const XmlNode*>::const_iterator end = collectedSet.end();
+  for (; ite != end; ++ite)
+  {
+    const XmlNode* root = *ite;
+    DataGuideDelta* delta = getDataGuideDelta(root->getTree());
+
+    if (delta == NULL || delta->theDropGuide)
+      continue;
+
+    // The guide nodes of a subtree must be collected only once, even if the
+    // subtree is part of a bigger subtree that is also removed or renamed.
+    const XmlNode* parent = static_cast<const XmlNode*>(root->getParent());
+    const XmlNode* ancestor = parent;
+
+    while (ancestor != NULL && collectedSet.find(ancestor) == collectedSet.end())
+      ancestor = static_cast<const XmlNode*>(ancestor->getParent());
+
+    if (ancestor != NULL)
+      continue;
+
+    GuideNode* parentGNode = NULL;
+
+    if (parent != NULL)
+      parentGNode = delta->theGuide->findNode(parent);
+
+    if (parentGNode == NULL)
+    {
+      delta->theDropGuide = true;
+      continue;
+    }
+
+    static_cast<ElementGuideNode*>(parentGNode)->
+    collectSubtree(root, delta->theRemovedNodes);
+  }
+}
+
+
+/*******************************************************************************
+  Apply the data guide deltas computed by computeDataGuideDeltas() to the
+  guides of the updated trees. The method is called from finalizeUpdates(),
+  before the removed nodes are detached from their trees.
+
+  The guide nodes of the removed and renamed subtrees are decremented, and the
+  added and renamed subtrees are added to the guides, skipping those that are
+  part of a bigger added subtree, or that were themselves removed by the PUL.
+  Guide nodes whose count drops to 0 are kept; they are ignored when the guide
+  is searched.
+********************************************************************************/
+void CollectionPul::applyDataGuideDeltas()
+{
+  DataGuideDeltas::iterator ite = theDataGuideDeltas.begin();
+  DataGuideDeltas::iterator end = theDataGuideDeltas.end();
+
+  for (; ite != end; ++ite)
+  {
+    XmlTree* tree = ite->first;
+    DataGuideDelta& delta = ite->second;
+
+    if (tree->getDataGuide() != delta.theGuide)
+      continue;
+
+    if (delta.theDropGuide)
+    {
+      tree->dropDataGuide();
+      continue;
+    }
+
+    csize numRemoved = delta.theRemovedNodes.size();
+    for (csize i = 0; i < numRemoved; ++i)
+      delta.theRemovedNodes[i]->removeNode();
+
+    std::set<const XmlNode*> addedSet(delta.theAddedRoots.begin(),
+                                      delta.theAddedRoots.end());
+
+    std::set<std::pair<const XmlNode*, GuideNode*> > checkedSiblings;
+
+    csize numAdded = delta.theAddedRoots.size();
+    for (csize i = 0; i < numAdded; ++i)
+    {
+      XmlNode* root = delta.theAddedRoots[i];
+
+      if (theDataGuideRemovedRoots.find(root) != theDataGuideRemovedRoots.end())
+        continue;
+
+      const XmlNode* ancestor = static_cast<const XmlNode*>(root->getParent());
+
+      while (ancestor != NULL &&
+             addedSet.find(ancestor) == addedSet.end() &&
+             theDataGuideRemovedRoots.find(ancestor) == theDataGuideRemovedRoots.end())
+        ancestor = static_cast<const XmlNode*>(ancestor->getParent());
+
+      if (ancestor != NULL)
+        continue;
+
+      const InternalNode* parent =
+      static_cast<const InternalNode*>(root->getParent());
+      ElementGuideNode* parentGNode = NULL;
+
+      if (parent != NULL)
+        parentGNode = static_cast<ElementGuideNode*>(delta.theGuide->findNode(parent));
+
+      if (parentGNode == NULL)
+      {
+        tree->dropDataGuide();
+        break;
+      }
+
+      parentGNode->addSubtree(parent, root);
+
+      if (root->getNodeKind() != store::StoreConsts::elementNode)
+        continue;
+
+      // addSubtree() can tell that a guide node is not unique only if the
+      // nodes of its path with the same parent are added one after the other.
+      // Here, the new element may have old siblings with the same name.
+      GuideNode* gnode = parentGNode->findChild(root->getNodeName());
+
+      if (!gnode->getUnique() ||
+          !checkedSiblings.insert(std::make_pair(parent, gnode)).second)
+        continue;
+
+      csize numSiblings = 0;
+      csize numChildren = parent->numChildren();
+      for (csize j = 0; j < numChildren && numSiblings < 2; ++j)
+      {
+        const XmlNode* child = parent->getChild(j);
+
+        if (child->getNodeKind() == store::StoreConsts::elementNode &&
+            child->getNodeName()->equals(root->getNodeName()))
+          ++numSiblings;
+      }
+
+      if (numSiblings > 1)
+        gnode->setUnique(false);
+    }
+  }
+
+  theDataGuideDeltas.clear();
+  theDataGuideRemovedRoots.clear();
+}
+
+
 /*******************************************************************************
   For each incrementally-maintained index associated with this collection,
   compute the index contents on the modified and deleted docs, before any 
@@ -2793,10 +3113,96 @@ void CollectionPul::computeIndexAfterDeltas()
 }
 
 
+/*******************************************************************************
+  If all the given updates (which have the same target JSON object) insert,
+  delete, rename, or replace the value of fields of their target, add the names
+  of these fields to the given vector and return true. Otherwise, return false.
+********************************************************************************/
+bool CollectionPul::getUpdatedFields(
+    const NodeUpdates& updates,
+    std::vector<zstring>& fields)
+{
+  NodeUpdates::const_iterator ite = updates.begin();
+  NodeUpdates::const_iterator end = updates.end();
+
+  for (; ite != end; ++ite)
+  {
+    switch ((*ite)->getKind())
+    {
+    case store::UpdateConsts::UP_JSON_OBJECT_INSERT:
+    {
+      UpdJSONObjectInsert* upd = static_cast<UpdJSONObjectInsert*>(*ite);
+
+      for (csize i = 0; i < upd->theNames.size(); ++i)
+        fields.push_back(upd->theNames[i]->getStringValue());
+
+      break;
+    }
+    case store::UpdateConsts::UP_JSON_OBJECT_DELETE:
+    {
+      UpdJSONObjectDelete* upd = static_cast<UpdJSONObjectDelete*>(*ite);
+      fields.push_back(upd->theName->getStringValue());
+      break;
+    }
+    case store::UpdateConsts::UP_JSON_OBJECT_REPLACE_VALUE:
+    {
+      UpdJSONObjectReplaceValue* upd =
+      static_cast<UpdJSONObjectReplaceValue*>(*ite);
+      fields.push_back(upd->theName->getStringValue());
+      break;
+    }
+    case store::UpdateConsts::UP_JSON_OBJECT_RENAME:
+    {
+      UpdJSONObjectRename* upd = static_cast<UpdJSONObjectRename*>(*ite);
+      fields.push_back(upd->theName->getStringValue());
+      fields.push_back(upd->theNewName->getStringValue());
+      break;
+    }
+    default:
+    {
+      return false;
+    }
+    }
+  }
+
+  return true;
+}
+
+
+/*******************************************************************************
+  Return true if the index entries of a doc may depend on any of the given
+  fields of the doc.
+********************************************************************************/
+bool CollectionPul::dependsOnFields(
+    const IndexImpl* index,
+    const std::vector<zstring>& fields)
+{
+  const store::IndexSpecification& spec = index->getSpecification();
+
+  if (!spec.theHasFieldDependencies)
+    return true;
+
+  std::vector<zstring>::const_iterator ite = fields.begin();
+  std::vector<zstring>::const_iterator end = fields.end();
+
+  for (; ite != end; ++ite)
+  {
+    if (std::binary_search(spec.theFieldDependencies.begin(),
+                           spec.theFieldDependencies.end(),
+                           *ite))
+      return true;
+  }
+
+  return false;
+}
+
+
 /*******************************************************************************
   For each incrementally maintained index I and each collection doc D that is
   modified by this pul, compute the index entries for I and D, and insert them
-  into the given deltas vector
+  into the given deltas vector. The entries are not computed if the updates of
+  D touch only fields that the keys of I do not depend on; since the before
+  and after deltas are computed from the same updates, both skip the same docs.
 ********************************************************************************/
 void CollectionPul::computeIndexDeltas(std::vector<IndexDeltaImpl>& deltas)
 {
@@ -2807,8 +3213,15 @@ void CollectionPul::computeIndexDeltas(std::vector<IndexDeltaImpl>& deltas)
 
   for (; docIte != docEnd; ++docIte)
   {
+    std::map<store::Item*, std::vector<zstring> >::const_iterator fieldsIte =
+    theModifiedDocFields.find(*docIte);
+
     for (csize i = 0; i < numIncrementalIndices; ++i)
     {
+      if (fieldsIte != theModifiedDocFields.end() &&
+          !dependsOnFields(theIncrementalIndices[i], fieldsIte->second))
+        continue;
+
       store::IndexEntryCreator* docIndexer = theIndexEntryCreators[i].getp();
       store::IndexDelta& indexDelta = deltas[i];
 
@@ -3447,6 +3860,16 @@ void CollectionPul::applyUpdates()
 
     theIsApplied = true;
 
+    // The tag indexes of the updated trees become stale.
+    dropTagIndexes(theDoFirstList);
+    dropTagIndexes(theInsertList);
+    dropTagIndexes(theReplaceNodeList);
+    dropTagIndexes(theReplaceContentList);
+    dropTagIndexes(theDeleteList);
+
+    // Compute the changes to the data guides of the updated trees.
+    computeDataGuideDeltas();
+
     // Apply all the XQUF update primitives
     applyList(theDoFirstList);
     applyList(theInsertList);
@@ -3659,6 +4082,9 @@ void CollectionPul::undoUpdates()
     undoList(theInsertList);
     undoList(theDoFirstList);
 
+    theDataGuideDeltas.clear();
+    theDataGuideRemovedRoots.clear();
+
     undoRefreshIndexes();
   }
   catch (...)
@@ -3681,6 +4107,8 @@ void CollectionPul::finalizeUpdates()
   {
     truncateIndexes();
 
+    applyDataGuideDeltas();
+
     // If necessary, adjust the position of trees inside this collection.
     if (theAdjustTreePositions)
     {
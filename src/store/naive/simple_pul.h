@@ -16,6 +16,8 @@
 #ifndef ZORBA_SIMPLE_STORE_PUL
 #define ZORBA_SIMPLE_STORE_PUL
 
+#include <map>
+#include <set>
 #include <vector>
 
 #include "shared_types.h"
@@ -46,6 +48,9 @@ class QNameItem;
 class Collection;
 class InternalNode;
 class TextNode;
+class XmlTree;
+class GuideNode;
+class ElementGuideNode;
 
 
 typedef std::vector<UpdatePrimitive*> NodeUpdates;
@@ -132,6 +137,16 @@ public:
   -------------------
   Nodes whose children might need to be merged 
 
+  theDataGuideDeltas:
+  -------------------
+  For each tree updated by the XQUF primitives of this PUL that has a data
+  guide, the changes to be made to the guide once the PUL has been applied
+  successfully (see computeDataGuideDeltas()).
+
+  theDataGuideRemovedRoots:
+  -------------------------
+  The roots of the subtrees that the XQUF primitives remove from their trees
+  (renamed nodes are not included).
 ********************************************************************************/
 class CollectionPul
 {
@@ -154,6 +169,18 @@ class CollectionPul
     }
   };
 
+  struct DataGuideDelta
+  {
+    ElementGuideNode       * theGuide;
+    bool                     theDropGuide;
+    std::vector<GuideNode*>  theRemovedNodes;
+    std::vector<XmlNode*>    theAddedRoots;
+
+    DataGuideDelta() : theGuide(NULL), theDropGuide(false) {}
+  };
+
+  typedef std::map<XmlTree*, DataGuideDelta> DataGuideDeltas;
+
 protected:
   // Bookeeping
   Collection                       * theCollection;
@@ -167,6 +194,9 @@ protected:
 
   std::vector<UpdatePrimitive*>      thePrimitivesToRecheck;
 
+  DataGuideDeltas                    theDataGuideDeltas;
+  std::set<const XmlNode*>           theDataGuideRemovedRoots;
+
   std::set<store::Item*>             theValidationNodes;
 
   store::PUL_t                       theValidationPul;
@@ -195,6 +225,7 @@ protected:
 
   // Index Maintenance
   std::set<store::Item*>             theModifiedDocs;
+  std::map<store::Item*, std::vector<zstring> > theModifiedDocFields;
   std::vector<store::Item*>          theInsertedDocs;
   std::vector<store::Item*>          theDeletedDocs;
 
@@ -250,6 +281,27 @@ public:
 protected:
   void switchPulInPrimitivesList(std::vector<UpdatePrimitive*>& list);
 
+  void dropTagIndexes(std::vector<UpdatePrimitive*>& list);
+
+  DataGuideDelta* getDataGuideDelta(XmlTree* tree);
+
+  void collectDataGuideRoots(
+      std::vector<UpdatePrimitive*>& list,
+      std::vector<XmlNode*>& removedRoots,
+      std::set<const XmlNode*>& renamedRoots);
+
+  void computeDataGuideDeltas();
+
+  void applyDataGuideDeltas();
+
+  static bool getUpdatedFields(
+      const NodeUpdates& updates,
+      std::vector<zstring>& fields);
+
+  static bool dependsOnFields(
+      const IndexImpl* index,
+      const std::vector<zstring>& fields);
+
   void computeIndexDeltas(std::vector<IndexDeltaImpl>& deltas);
 
   void cleanIndexDeltas();
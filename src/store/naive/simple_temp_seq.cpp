@@ -95,6 +95,8 @@ void SimpleTempSeq::clear()
   }
 
   theItems.clear();
+
+  theMemory.releaseAll();
 }
 
 
@@ -110,6 +112,7 @@ void SimpleTempSeq::init(const store::Iterator_t& iter)
   while (iter->next(curItem)) 
   {
     // TODO ???? Check that the size is less than max(csize, xs_integer)
+    theMemory.charge(curItem.getp());
     theItems.push_back(NULL);
     theItems.back() = curItem.release();
   }
@@ -126,6 +129,7 @@ void SimpleTempSeq::append(const store::Iterator_t& iter)
   while (iter->next(curItem))
   {
     // TODO ???? Check that the size is less than max(csize, xs_integer)
+    theMemory.charge(curItem.getp());
     theItems.push_back(NULL);
     theItems.back() = curItem.release();
   }
@@ -261,6 +265,22 @@ store::Iterator_t SimpleTempSeq::getIterator() const
 }
 
 
+/*******************************************************************************
+  Charges the items that are already in the sequence to the new account.
+********************************************************************************/
+void SimpleTempSeq::setMemoryAccount(store::MemoryAccount* account)
+{
+  theMemory.attach(account);
+
+  std::vector<store::Item*>::const_iterator ite = theItems.begin();
+  std::vector<store::Item*>::const_iterator end = theItems.end();
+  for (; ite != end; ++ite)
+  {
+    theMemory.charge(*ite);
+  }
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////
 //                                                                             //
 //  SimpleTempSeqIter                                                          //
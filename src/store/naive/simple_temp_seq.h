@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "store/api/iterator.h"
+#include "store/api/memory_account.h"
 #include "store/api/temp_seq.h"
 
 namespace zorba { namespace simplestore {
@@ -30,6 +31,9 @@ typedef rchandle<class SimpleTempSeq> SimpleTempSeq_t;
 /*******************************************************************************
   Very simple implementation of Temp Sequence. It eagerly saves the items
   returned by an iterator into a vector.
+
+  theMemory : The memory of theItems, as charged to the account given by
+              setMemoryAccount(), if any.
 ********************************************************************************/
 class SimpleTempSeq : public store::TempSeq
 {
@@ -38,6 +42,8 @@ class SimpleTempSeq : public store::TempSeq
 private:
   std::vector<store::Item*> theItems; // ref-counting is done manually
 
+  store::MemoryCharge       theMemory;
+
 private:
   void clear();
 
@@ -73,6 +79,8 @@ public:
   bool containsItem(xs_integer position);
 
   store::Iterator_t getIterator() const;
+
+  void setMemoryAccount(store::MemoryAccount* account);
   
 #ifndef NDEBUG
   // toString() and show() debugging methods.
@@ -22,6 +22,7 @@
 
 #include <zorba/internal/cxx_util.h>
 #include <zorba/internal/unique_ptr.h>
+#include <zorba/properties.h>
 
 #include "zorbautils/hashfun.h"
 #include "zorbautils/fatal.h"
@@ -384,12 +385,12 @@ XmlLoader* Store::getXmlLoader(
     return new DtdXmlLoader(theItemFactory,
                             aXQueryDiagnostics,
                             loadProperties,
-                            false);
+                            Properties::instance().getDataGuides());
   else
     return new FastXmlLoader(theItemFactory,
                              aXQueryDiagnostics,
                              loadProperties,
-                             false);
+                             Properties::instance().getDataGuides());
 }
 
 
@@ -892,7 +893,10 @@ Store::createMap(
     );
   }
 
-  lIndex = new ValueHashIndex(aQName, aSpec);
+  if (aSpec.getNumColumns() == 1)
+    lIndex = new SingleKeyHashIndex(aQName, aSpec);
+  else
+    lIndex = new ValueHashIndex(aQName, aSpec);
 
   if (!aSpec.theIsTemp) addMap(lIndex);
 
@@ -1238,7 +1242,8 @@ bool Store::getPathInfo(
     std::vector<const store::Item*>& relativePath,
     bool                             isAttrPath,
     bool&                            found,
-    bool&                            unique)
+    bool&                            unique,
+    csize&                           count)
 {
   zstring docUri;
   docUriItem->getStringValue2(docUri);
@@ -1248,18 +1253,45 @@ bool Store::getPathInfo(
   if (docRoot == NULL)
     return false;
 
-#ifdef DATAGUIDE
-  GuideNode* guideRoot = docRoot->getDataGuide();
+  ElementGuideNode* guideRoot = docRoot->getDataGuide();
 
   if (!guideRoot)
     return false;
 
-  guideRoot->getPathInfo(contextPath, relativePath, isAttrPath, found, unique);
-#endif
+  guideRoot->getPathInfo(contextPath, relativePath, isAttrPath,
+                         found, unique, count);
   return true;
 }
 
 
+/*******************************************************************************
+
+********************************************************************************/
+bool Store::mayHaveDescendant(const store::Item* node, const store::Item* name)
+{
+  const XmlNode* xmlNode = static_cast<const XmlNode*>(node);
+
+  if (xmlNode->isConnectorNode())
+    return true;
+
+  ElementGuideNode* guideRoot = xmlNode->getDataGuide();
+
+  if (guideRoot == NULL)
+    return true;
+
+  // The guide computes the descendant names of its nodes on demand.
+  SYNC_CODE(AutoMutex lock(xmlNode->getTree()->getDataGuideMutex());)
+
+  GuideNode* guideNode = guideRoot->findNode(xmlNode);
+
+  if (guideNode == NULL ||
+      guideNode->getNodeKind() != store::StoreConsts::elementNode)
+    return true;
+
+  return static_cast<ElementGuideNode*>(guideNode)->hasDescendant(name);
+}
+
+
 /*******************************************************************************
   Creates a new TempSeq. The instance can be used, e.g. for variable bindings
 
@@ -405,7 +405,12 @@ public:
       std::vector<const store::Item*>& relativePath,
       bool isAttrPath,
       bool& found,
-      bool& unique);
+      bool& unique,
+      csize& count);
+
+  virtual bool mayHaveDescendant(
+      const store::Item* node,
+      const store::Item* name);
 
 /*---------------------- Node Reference Management ---------------------------*/
 public:
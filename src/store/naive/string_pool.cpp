@@ -28,15 +28,12 @@ namespace zorba { namespace simplestore {
 StringPool::~StringPool() 
 {
   csize count = 0;
-  csize n = capacity();
 
-  for (csize i = 0; i < n; ++i)
+  for (iterator ite = begin(); ite != end(); ++ite)
   {
-    if (!theHashTab[i].isFree() && theHashTab[i].key().is_shared())
+    if (ite.getKey().is_shared())
     {
-      std::cerr << "ID: " << i << " Referenced URI: "
-                << theHashTab[i].key() << std::endl;
-      //delete theHashTab[i].theString.getp();
+      std::cerr << "Referenced URI: " << ite.getKey() << std::endl;
       count++;
     }
   }
@@ -48,6 +45,25 @@ StringPool::~StringPool()
 }
 
 
+/*******************************************************************************
+  Predicate to look up a pooled string by a C string of known length.
+********************************************************************************/
+class CStringEquals
+{
+public:
+  CStringEquals(const char* str, zstring::size_type len) : theStr(str), theLen(len) {}
+
+  bool operator()(const zstring& s) const
+  {
+    return ztd::equals(s, theStr, theLen);
+  }
+
+private:
+  const char       * theStr;
+  zstring::size_type theLen;
+};
+
+
 /*******************************************************************************
   Check if the given string is already in the pool and if not, make a copy of it
   and place the copy in the pool. Return true if the string was already in the
@@ -55,33 +71,18 @@ StringPool::~StringPool()
 ********************************************************************************/
 bool StringPool::insertc(const char* str, zstring& outStr)
 {
-  bool found = false;
-
   zstring::size_type len = strlen(str);
 
-  ulong hval = hashfun::h32(str, len, FNV_32_INIT) % bucket_count();
+  uint32_t hval = hashfun::h32w(str, len);
 
   {
     SYNC_CODE(AutoMutex lock(&theMutex);)
 
-    HashEntry<zstring, DummyHashValue>* entry = &theHashTab[hval];
-
-    if (!entry->isFree())
-    {
-      while (entry != NULL)
-      {
-        if (ztd::equals(entry->key(), str, len))
-        {
-          found = true;
-          break;
-        }
-        entry = entry->getNext();
-      }
-    }
+    const zstring* found = findNoSync(hval, CStringEquals(str, len));
 
     if (found)
     {
-      outStr = entry->key();
+      outStr = *found;
       return false;
     }
   }
@@ -94,84 +95,21 @@ bool StringPool::insertc(const char* str, zstring& outStr)
 
 
 /*******************************************************************************
-  Look for strings that are not used by anybody outside the pool. Delete each
-  such string and place its entry in the free list.
+  Predicate that is true for strings that are not used by anybody outside the
+  pool.
 ********************************************************************************/
-void StringPool::garbageCollect()
+static bool is_unused(const zstring& s)
 {
-  HashEntry<zstring, DummyHashValue>* currEntry;
-
-  HashEntry<zstring, DummyHashValue>* freeList = NULL;
-
-  csize size = bucket_count();
-
-  for (csize i = 0; i < size; ++i)
-  {
-    currEntry = &theHashTab[i];
-
-    // If the current hash bucket is empty, move to the next one
-    if (currEntry->isFree())
-    {
-      ZORBA_FATAL(currEntry->theNext == 0, "");
-      continue;
-    }
-
-    // Handle the 1st hash entry of the current hash bucket
-    while (!currEntry->key().is_shared())
-    {
-      if (currEntry->theNext == 0)
-      {
-        currEntry->setFree();
-        --theNumEntries;
-        break;
-      }
-      else
-      {
-        HashEntry<zstring, DummyHashValue>* nextEntry = currEntry->getNext();
-        assert(!nextEntry->isFree());
-        *currEntry = *nextEntry;
-        currEntry->setNext(nextEntry->getNext());
-        nextEntry->setFree();
-        nextEntry->setNext(freeList);
-        freeList = nextEntry;
-        --theNumEntries;
-      }
-    }
-
-    // Handle the overflow entries of the current hash bucket.
-    HashEntry<zstring, DummyHashValue>* prevEntry = currEntry;
-    currEntry = currEntry->getNext();
-
-    while (currEntry != NULL)
-    {
-      if (!currEntry->key().is_shared())
-      {
-        prevEntry->setNext(currEntry->getNext());
-        currEntry->setFree();
-        currEntry->setNext(freeList);
-        freeList = currEntry;
-        --theNumEntries;
-
-        currEntry = prevEntry->getNext();
-      }
-      else
-      {
-        prevEntry = currEntry;
-        currEntry = currEntry->getNext();
-      }
-    }
-  }
-
-  if (freeList != NULL)
-  {
-    currEntry = freeList;
-    while (currEntry->theNext != 0)
-      currEntry = currEntry->getNext();
+  return !s.is_shared();
+}
 
-    currEntry->setNext(theHashTab[bucket_count()].getNext());
 
-    theHashTab[bucket_count()].setNext(freeList);
-  }
+/*******************************************************************************
+  Delete the strings that are not used by anybody outside the pool.
+********************************************************************************/
+void StringPool::garbageCollect()
+{
+  eraseIfNoSync(is_unused);
 }
 
 } // namespace simplestore
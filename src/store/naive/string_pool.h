@@ -19,7 +19,7 @@
 #include "common/common.h"
 #include "zorbatypes/zstring.h"
 
-#include "zorbautils/hashset.h"
+#include "zorbautils/flat_hashset.h"
 #include "zorbautils/hashfun.h"
 
 
@@ -36,7 +36,7 @@ public:
 
   static uint32_t hash(const zstring& s)
   {
-    return hashfun::h32(s.data(), s.size(), FNV_32_INIT);
+    return hashfun::h32w(s.data(), s.size());
   }
 };
 
@@ -46,12 +46,12 @@ public:
 
   It is used to implement a pool of URI strings.
 ********************************************************************************/
-class StringPool : public HashSet<zstring, StringPoolCompareFunction>
+class StringPool : public FlatHashSet<zstring, StringPoolCompareFunction>
 {
 public:
  StringPool(ulong size) 
     :
-    HashSet<zstring, StringPoolCompareFunction>(size, true) {}
+    FlatHashSet<zstring, StringPoolCompareFunction>(size, true) {}
 
   ~StringPool();
 
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "stdafx.h"
+
+#include "tag_index.h"
+#include "atomic_items.h"
+#include "node_items.h"
+
+#include "diagnostics/assert.h"
+
+
+namespace zorba
+{
+namespace simplestore
+{
+
+
+/*******************************************************************************
+  Adds the element nodes of the tree rooted at the given node, in document
+  order.
+********************************************************************************/
+void TagIndex::build(const XmlNode* root)
+{
+  ZORBA_ASSERT(theLists.empty());
+
+  if (root->getNodeKind() != store::StoreConsts::documentNode &&
+      root->getNodeKind() != store::StoreConsts::elementNode)
+    return;
+
+  std::vector<std::pair<const InternalNode*, csize> > stack;
+  stack.push_back(std::make_pair(static_cast<const InternalNode*>(root), 0));
+
+  if (root->getNodeKind() == store::StoreConsts::elementNode)
+    addNode(static_cast<ElementNode*>(const_cast<XmlNode*>(root)));
+
+  while (!stack.empty())
+  {
+    const InternalNode* parent = stack.back().first;
+    csize pos = stack.back().second;
+
+    if (pos == parent->numChildren())
+    {
+      stack.pop_back();
+      continue;
+    }
+
+    ++stack.back().second;
+
+    XmlNode* child = parent->getChild(pos);
+
+    if (child->getNodeKind() == store::StoreConsts::elementNode)
+    {
+      addNode(static_cast<ElementNode*>(child));
+      stack.push_back(std::make_pair(static_cast<const InternalNode*>(child), 0));
+    }
+  }
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void TagIndex::addNode(ElementNode* node)
+{
+  const QNameItem* qname = static_cast<const QNameItem*>(node->getNodeName());
+
+  theLists[qname->getNormalized()].push_back(node);
+}
+
+
+/*******************************************************************************
+  Returns the element nodes with the given name, in document order, or NULL if
+  there are none.
+********************************************************************************/
+const TagIndex::NodeList* TagIndex::getNodes(const store::Item* qname) const
+{
+  const QNameItem* name = static_cast<const QNameItem*>(qname);
+
+  ListMap::const_iterator ite = theLists.find(name->getNormalized());
+
+  return (ite == theLists.end() ? NULL : &ite->second);
+}
+
+
+} // namespace simplestore
+} // namespace zorba
+/* vim:set et sw=2 ts=2: */
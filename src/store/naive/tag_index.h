@@ -0,0 +1,81 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ZORBA_SIMPLE_STORE_TAG_INDEX
+#define ZORBA_SIMPLE_STORE_TAG_INDEX
+
+#include <map>
+#include <vector>
+
+#include "store/api/item.h"
+
+
+namespace zorba
+{
+namespace simplestore
+{
+
+class ElementNode;
+class XmlNode;
+
+
+/*******************************************************************************
+  A tag index maps each element name that appears in an xml tree to the list of
+  the element nodes in that tree that have this name. The lists are in document
+  order: the index is built by a traversal of the tree in document order, when
+  the first twig join searches the tree (see XmlTree::getTagIndex()). Only the
+  trees created by the FastXmlLoader get an index.
+
+  The index is valid only as long as the tree is not modified. Instead of being
+  maintained incrementally, it is dropped by the first update that targets a
+  node of the tree (see XmlTree::dropTagIndex()), after which paths over that
+  tree are evaluated by navigation.
+
+  theLists :
+  ----------
+  Maps the normalized qname of an element name (which is unique for the name,
+  so the pointer is used as the key) to the element nodes with that name.
+********************************************************************************/
+class TagIndex
+{
+public:
+  typedef std::vector<ElementNode*> NodeList;
+
+protected:
+  typedef std::map<const store::Item*, NodeList> ListMap;
+
+  ListMap  theLists;
+
+public:
+  void build(const XmlNode* root);
+
+  const NodeList* getNodes(const store::Item* qname) const;
+
+protected:
+  void addNode(ElementNode* node);
+};
+
+
+} // namespace simplestore
+} // namespace zorba
+
+#endif
+
+/*
+ * Local variables:
+ * mode: c++
+ * End:
+ */
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,310 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "stdafx.h"
+
+#include <cassert>
+#include <cstring>
+#include <istream>
+
+#include "store/util/string_chunk_reader.h"
+
+namespace zorba
+{
+
+namespace store
+{
+
+/******************************************************************************
+  Returns the number of bytes at the end of s[0,n) that are the beginning of a
+  UTF-8 character that does not end in s[0,n).
+********************************************************************************/
+static csize partialCharLength(const char* s, csize n)
+{
+  for (csize i = 1; i <= 4 && i <= n; ++i)
+  {
+    unsigned char const c = static_cast<unsigned char>(s[n - i]);
+
+    if ((c & 0xC0) != 0x80)
+    {
+      csize const len = (c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1);
+      return (len > i ? i : 0);
+    }
+  }
+  return 0;
+}
+
+
+/******************************************************************************
+
+********************************************************************************/
+StringChunkReader::StringChunkReader()
+  :
+  theStreambuf(NULL),
+  theData(NULL),
+  theDataSize(0),
+  theChunkEnd(0),
+  theCarry(0),
+  theIsUtf8(true),
+  theIsEof(false),
+  thePendingPos(0),
+  theSawSeparator(false)
+{
+}
+
+
+/******************************************************************************
+
+********************************************************************************/
+void StringChunkReader::init(
+    Item* item,
+    bool isUtf8,
+    csize chunkSize,
+    bool consume)
+{
+  clear();
+
+  theItem = item;
+  theIsUtf8 = isUtf8;
+
+  // A non-seekable item that may be used again is materialized below, by
+  // getString() or getBase64BinaryValue(), so that it can still be read later.
+  if (item->isStreamable() && (consume || item->isSeekable()))
+  {
+    theStreambuf = item->getStream().rdbuf();
+    // A chunk must have room for at least one UTF-8 character.
+    theChunk.resize(chunkSize < 4 ? 4 : chunkSize);
+    return;
+  }
+
+  if (item->isAtomic())
+  {
+    SchemaTypeCode typeCode = item->getTypeCode();
+
+    if (typeCode == XS_BASE64BINARY)
+    {
+      size_t size;
+      theData = item->getBase64BinaryValue(size);
+      theDataSize = size;
+      return;
+    }
+
+    if (XS_STRING <= typeCode && typeCode <= XS_UNTYPED_ATOMIC)
+    {
+      const zstring& value = item->getString();
+      theData = value.data();
+      theDataSize = value.size();
+      return;
+    }
+  }
+
+  item->getStringValue2(theValue);
+  theData = theValue.data();
+  theDataSize = theValue.size();
+}
+
+
+/******************************************************************************
+
+********************************************************************************/
+void StringChunkReader::clear()
+{
+  theItem = NULL;
+  theStreambuf = NULL;
+  theValue.clear();
+  theData = NULL;
+  theDataSize = 0;
+  theChunkEnd = 0;
+  theCarry = 0;
+  theIsEof = false;
+  thePending.clear();
+  thePendingPos = 0;
+  theSawSeparator = false;
+}
+
+
+/******************************************************************************
+
+********************************************************************************/
+bool StringChunkReader::next(const char*& data, csize& size)
+{
+  if (theStreambuf == NULL)
+  {
+    if (theData == NULL || theDataSize == 0)
+      return false;
+
+    data = theData;
+    size = theDataSize;
+    theData = NULL;
+    return true;
+  }
+
+  for (;;)
+  {
+    if (theIsEof && theCarry == 0)
+      return false;
+
+    if (theCarry)
+      ::memmove(&theChunk[0], &theChunk[theChunkEnd - theCarry], theCarry);
+
+    std::streamsize n = 0;
+
+    if (!theIsEof)
+    {
+      // std::istream::read() would swallow the exceptions thrown by the
+      // streambuf; sgetn() lets them through.
+      n = theStreambuf->sgetn(&theChunk[theCarry], theChunk.size() - theCarry);
+
+      if (n <= 0)
+      {
+        n = 0;
+        theIsEof = true;
+      }
+    }
+
+    theChunkEnd = theCarry + static_cast<csize>(n);
+
+    theCarry = ((theIsUtf8 && !theIsEof) ?
+                partialCharLength(&theChunk[0], theChunkEnd) : 0);
+
+    if (theChunkEnd > theCarry)
+    {
+      data = &theChunk[0];
+      size = theChunkEnd - theCarry;
+      return true;
+    }
+  }
+}
+
+
+/******************************************************************************
+  Appends the next chunk to thePending, first discarding the part of it that
+  has been returned already.
+********************************************************************************/
+bool StringChunkReader::fillPending()
+{
+  const char* data;
+  csize size;
+
+  if (!next(data, size))
+    return false;
+
+  if (thePendingPos)
+  {
+    thePending.erase(0, thePendingPos);
+    thePendingPos = 0;
+  }
+
+  thePending.append(data, size);
+  return true;
+}
+
+
+/******************************************************************************
+
+********************************************************************************/
+bool StringChunkReader::nextToken(const zstring& separator, zstring& token)
+{
+  assert(!separator.empty());
+
+  // Offset, relative to thePendingPos, from which to look for the separator:
+  // the bytes before it have been looked at already.
+  csize scanned = 0;
+
+  for (;;)
+  {
+    csize pos = thePending.find(separator, thePendingPos + scanned);
+
+    if (pos != zstring::npos)
+    {
+      token.assign(thePending, thePendingPos, pos - thePendingPos);
+      thePendingPos = pos + separator.size();
+      theSawSeparator = true;
+      return true;
+    }
+
+    csize avail = thePending.size() - thePendingPos;
+    if (avail >= separator.size())
+      scanned = avail - separator.size() + 1;
+
+    if (!fillPending())
+      break;
+  }
+
+  if (thePendingPos == thePending.size() && !theSawSeparator)
+    return false;
+
+  token.assign(thePending, thePendingPos, zstring::npos);
+  thePending.clear();
+  thePendingPos = 0;
+  theSawSeparator = false;
+  return true;
+}
+
+
+/******************************************************************************
+
+********************************************************************************/
+bool StringChunkReader::nextLine(zstring& line)
+{
+  // Offset, relative to thePendingPos, from which to look for a line end.
+  csize scanned = 0;
+
+  for (;;)
+  {
+    const char* const begin = thePending.data() + thePendingPos;
+    const char* const end = thePending.data() + thePending.size();
+    const char* p = begin + scanned;
+
+    while (p < end && *p != '\n' && *p != '\r')
+      ++p;
+
+    scanned = p - begin;
+
+    if (p < end && (*p == '\n' || p + 1 < end))
+    {
+      line.assign(begin, scanned);
+      thePendingPos += scanned + 1;
+
+      if (*p == '\r' && p[1] == '\n')
+        ++thePendingPos;
+
+      return true;
+    }
+
+    // Either no line end was found, or it is a \r that may be followed by a
+    // \n in the next chunk.
+    if (!fillPending())
+      break;
+  }
+
+  if (thePendingPos == thePending.size())
+    return false;
+
+  // The last line, or a line ended by a \r at the very end.
+  csize len = thePending.size() - thePendingPos;
+  if (thePending[thePending.size() - 1] == '\r')
+    --len;
+
+  line.assign(thePending, thePendingPos, len);
+  thePending.clear();
+  thePendingPos = 0;
+  return true;
+}
+
+
+}
+}
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ZORBA_STORE_UTIL_STRING_CHUNK_READER
+#define ZORBA_STORE_UTIL_STRING_CHUNK_READER
+
+#include <streambuf>
+#include <vector>
+
+#include "store/api/shared_types.h"
+#include "store/api/item.h"
+#include "zorbatypes/zstring.h"
+
+
+namespace zorba { namespace store {
+
+
+/***************************************************************************//**
+  Reads the content of an item (the string value of a string-like item, or the
+  bytes of an xs:base64Binary item, as returned by getBase64BinaryValue()) in
+  chunks, without materializing it if the item is streamable and seekable.
+
+  For a non-streamable item, the whole content is returned as a single chunk
+  that points into the item itself. For a streamable item, the content is read
+  from the item's stream, chunkSize bytes at a time, into theChunk. If
+  theIsUtf8 is true, a chunk never ends in the middle of a UTF-8 character:
+  the bytes of a partial character are carried over to the next chunk.
+
+  On top of next(), nextToken() and nextLine() split the content into tokens
+  and lines while keeping only the current token or line in memory.
+
+  Note: a non-seekable stream can be read only once, and the same item may be
+  used again after it has been read (e.g. in "let $s := ... return
+  (string-length($s), $s)"). So a non-seekable item is materialized and read
+  as a non-streamable one, unless the reader is told that it is the last user
+  of the item (e.g. the serializer).
+
+  theItem       : The item whose content is read; it is kept alive for as long
+                  as it is being read.
+  theStreambuf  : The streambuf of the item's stream, or NULL if the item is
+                  not streamable.
+  theValue      : The string value of a non-streamable item that has no
+                  getString() (e.g. a node).
+  theData       : The content of a non-streamable item, or NULL once it has
+                  been returned by next().
+  theCarry      : The number of bytes at the end of theChunk (i.e., at offset
+                  theChunkEnd - theCarry) that belong to the next chunk.
+  thePending    : The content read by nextToken()/nextLine() that has not been
+                  returned yet starts at offset thePendingPos of thePending.
+  theSawSeparator : Whether the last token returned by nextToken() was followed
+                  by a separator (and so another, possibly empty, token
+                  follows).
+********************************************************************************/
+class StringChunkReader
+{
+public:
+  static const csize DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+protected:
+  Item_t             theItem;
+  std::streambuf   * theStreambuf;
+  zstring            theValue;
+  const char       * theData;
+  csize              theDataSize;
+
+  std::vector<char>  theChunk;
+  csize              theChunkEnd;
+  csize              theCarry;
+  bool               theIsUtf8;
+  bool               theIsEof;
+
+  zstring            thePending;
+  csize              thePendingPos;
+  bool               theSawSeparator;
+
+public:
+  StringChunkReader();
+
+  /**
+   * Starts reading the content of the given item. If the item is streamable
+   * and either seekable or consumed, its stream is obtained right away
+   * (Item::getStream() rewinds a seekable stream).
+   *
+   * @param consume If \c true, the item is not used anymore after it has been
+   * read, so it is streamed even if its stream is not seekable.
+   */
+  void init(
+      Item* item,
+      bool isUtf8 = true,
+      csize chunkSize = DEFAULT_CHUNK_SIZE,
+      bool consume = false);
+
+  /**
+   * Stops reading and releases the item.
+   */
+  void clear();
+
+  bool isInitialized() const { return !theItem.isNull(); }
+
+  bool isStreaming() const { return theStreambuf != NULL; }
+
+  /**
+   * Gets the next chunk of the content. The chunk remains valid until the
+   * next call to any of next(), nextToken(), nextLine(), init(), or clear().
+   *
+   * @param data Set to point to the first byte of the chunk.
+   * @param size Set to the size of the chunk in bytes; never 0.
+   * @return Returns \c false only if there are no more chunks.
+   */
+  bool next(const char*& data, csize& size);
+
+  /**
+   * Gets the next token of the content, where tokens are separated by the
+   * given non-empty separator. As for fn:tokenize(), an empty content has no
+   * tokens, and if the content ends with the separator, the last token is
+   * empty.
+   *
+   * @return Returns \c false only if there are no more tokens.
+   */
+  bool nextToken(const zstring& separator, zstring& token);
+
+  /**
+   * Gets the next line of the content, where lines are terminated by a
+   * newline, a carriage return, or both, as for fn:unparsed-text-lines().
+   *
+   * @return Returns \c false only if there are no more lines.
+   */
+  bool nextLine(zstring& line);
+
+protected:
+  bool fillPending();
+};
+
+
+}
+}
+#endif
+/* vim:set et sw=2 ts=2: */
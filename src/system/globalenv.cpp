@@ -15,6 +15,11 @@
  */
 #include "stdafx.h"
 
+#include <iomanip>
+
+#include <zorba/properties.h>
+#include <zorba/util/time.h>
+
 #include "common/common.h"
 
 #ifndef ZORBA_NO_ICU
@@ -71,11 +76,50 @@ using namespace zorba;
 
 GlobalEnvironment * GlobalEnvironment::m_globalEnv = 0;
 
+namespace
+{
+
+/*******************************************************************************
+  Measures the wall-clock time of consecutive initialization phases. Each call
+  to stop() records the time elapsed since the previous call (or since the
+  construction of the timer) under the given phase name.
+********************************************************************************/
+class StartupTimer
+{
+  std::vector<GlobalEnvironment::StartupPhase> & thePhases;
+  time::walltime                                 theStart;
+
+public:
+  StartupTimer(std::vector<GlobalEnvironment::StartupPhase>& phases)
+    :
+    thePhases(phases)
+  {
+    time::get_current_walltime(theStart);
+  }
+
+  void stop(const char* phase)
+  {
+    time::walltime now;
+    time::get_current_walltime(now);
+
+    thePhases.push_back(GlobalEnvironment::StartupPhase(
+        phase, time::get_walltime_elapsed(theStart, now)));
+
+    theStart = now;
+  }
+};
+
+}
+
+
 /*******************************************************************************
 
 ********************************************************************************/
 void GlobalEnvironment::init(store::Store* store)
 {
+  std::vector<StartupPhase> phases;
+  StartupTimer timer(phases);
+
   // initialize Xerces-C lib
 #ifndef ZORBA_NO_XMLSCHEMA
   try
@@ -88,12 +132,16 @@ void GlobalEnvironment::init(store::Store* store)
               << StrX(toCatch.getMessage()) << std::endl;
     abort();
   }
+
+  timer.stop("Xerces-C");
 #endif
 
   m_globalEnv = new GlobalEnvironment();
 
   m_globalEnv->init_icu();
 
+  timer.stop("ICU");
+
   ZORBA_FATAL(store != NULL, "Must provide store during zorba initialization");
 
   m_globalEnv->theStore = store;
@@ -101,15 +149,23 @@ void GlobalEnvironment::init(store::Store* store)
   m_globalEnv->theRootTypeManager = new RootTypeManager;
   RCHelper::addReference(m_globalEnv->theRootTypeManager);
 
+  timer.stop("root type manager");
+
   m_globalEnv->theRootStaticContext = new root_static_context();
   m_globalEnv->theRootStaticContext->init();
 
+  timer.stop("root static context");
+
   m_globalEnv->theFunctionLib = new BuiltinFunctionLibrary();
 
   m_globalEnv->theFunctionLib->populate(m_globalEnv->theRootStaticContext);
 
+  timer.stop("builtin functions");
+
   AnnotationInternal::createBuiltIn();
 
+  timer.stop("builtin annotations");
+
 #ifdef ZORBA_XQUERYX
   //libxml2 and libxslt are needed
   xmlInitMemory();
@@ -120,6 +176,8 @@ void GlobalEnvironment::init(store::Store* store)
   // TODO function not available on mac
   //xsltInit();
   m_globalEnv->xqueryx_convertor = new XQueryXConvertor;
+
+  timer.stop("XQueryX");
 #endif
 
   std::unique_ptr<XQueryCompilerSubsystem> lSubSystem = 
@@ -131,9 +189,48 @@ void GlobalEnvironment::init(store::Store* store)
 
   m_globalEnv->theDynamicLoader = 0;
 
+  timer.stop("compiler subsystem");
+
   m_globalEnv->theHostCountry = locale::get_host_country();
 
   m_globalEnv->theHostLang = locale::get_host_lang();
+
+  timer.stop("host locale");
+
+  m_globalEnv->theStartupPhases.swap(phases);
+
+  if (Properties::instance().getTraceStartup())
+    m_globalEnv->printStartupPhases(Properties::instance().getDebugStream());
+}
+
+
+/*******************************************************************************
+  Print the wall-clock time taken by each of the initialization phases.
+********************************************************************************/
+void GlobalEnvironment::printStartupPhases(std::ostream& os) const
+{
+  std::ios::fmtflags flags = os.flags();
+  std::streamsize precision = os.precision(3);
+  os.setf(std::ios::fixed);
+
+  double total = 0;
+
+  std::vector<StartupPhase>::const_iterator ite = theStartupPhases.begin();
+  std::vector<StartupPhase>::const_iterator end = theStartupPhases.end();
+
+  for (; ite != end; ++ite)
+  {
+    os << "Startup phase " << std::setw(21) << std::left
+       << ite->first << ": " << ite->second << " milliseconds" << std::endl;
+
+    total += ite->second;
+  }
+
+  os << "Startup phases total               : " << total << " milliseconds"
+     << std::endl;
+
+  os.precision(precision);
+  os.flags(flags);
 }
 
 
@@ -18,6 +18,9 @@
 #define ZORBA_GLOBALENV_H
 
 #include <cassert>
+#include <iosfwd>
+#include <utility>
+#include <vector>
 
 #include <zorba/config.h>
 #include <zorba/internal/unique_ptr.h>
@@ -58,6 +61,9 @@ class Store;
 ********************************************************************************/
 class GlobalEnvironment 
 {
+public:
+  typedef std::pair<const char*, double> StartupPhase;
+
 private:
 
   static GlobalEnvironment        * m_globalEnv;
@@ -90,6 +96,8 @@ private:
 
   locale::iso639_1::type            theHostLang;
 
+  std::vector<StartupPhase>         theStartupPhases;
+
 public:
 
   static void init(store::Store* store);
@@ -144,6 +152,13 @@ public:
 
   locale::iso639_1::type get_host_lang() const { return theHostLang; }
 
+  const std::vector<StartupPhase>& getStartupPhases() const
+  {
+    return theStartupPhases;
+  }
+
+  void printStartupPhases(std::ostream& os) const;
+
 #ifdef ZORBA_XQUERYX
   XQueryXConvertor* getXQueryXConvertor();
 #endif
@@ -15,6 +15,7 @@
  */
 
 #include "stdafx.h"
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -121,6 +122,41 @@ static bool test_put( test const *t ) {
   return b64_str == expected_b64_str;
 }
 
+/**
+ * Writes and then reads back random bytes through base64 streambufs using
+ * write()/read() sizes that aren't multiples of 3 mixed with put()/get().
+ */
+static bool test_round_trip( int size ) {
+  string raw_str;
+  for ( int i = 0; i < size; ++i )
+    raw_str += static_cast<char>( ::rand() );
+
+  ostringstream oss;
+  { // local scope
+  base64::auto_attach<ostringstream> const raii( oss );
+  string::size_type const n = raw_str.size() / 3 + 1;
+  oss.write( raw_str.data(), min( n, raw_str.size() ) );
+  for ( string::size_type i = n; i < raw_str.size(); ++i )
+    oss.put( raw_str[i] );
+  } // local scope
+
+  istringstream iss( oss.str() );
+  base64::auto_attach<istringstream> const raii( iss );
+  string result;
+  for ( int i = 0; iss; ++i ) {
+    if ( i % 2 ) {
+      char buf[ 1000 ];
+      iss.read( buf, ::rand() % sizeof buf );
+      result.append( buf, static_cast<string::size_type>( iss.gcount() ) );
+    } else {
+      int const c = iss.get();
+      if ( c != EOF )
+        result += static_cast<char>( c );
+    }
+  }
+  return result == raw_str;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static test const tests[] = {
@@ -144,6 +180,11 @@ int test_base64_streambuf( int, char*[] ) {
     ASSERT_TRUE_AND_NO_EXCEPTION( test_no, test_insertion( t ) );
     ASSERT_TRUE_AND_NO_EXCEPTION( test_no, test_put( t ) );
   }
+
+  ::srand( 1 );
+  for ( int size = 0; size < 20000; size += 997, ++test_no )
+    ASSERT_TRUE_AND_NO_EXCEPTION( test_no, test_round_trip( size ) );
+
   cout << failures << " test(s) failed\n";
   return failures ? 1 : 0;
 }
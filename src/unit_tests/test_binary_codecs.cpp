@@ -0,0 +1,248 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stdafx.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <zorba/util/base64_util.h>
+#include <zorba/util/hexbinary_util.h>
+
+#include "util/cpu_util.h"
+#include "util/time_util.h"
+
+using namespace std;
+using namespace zorba;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static int failures;
+
+static bool assert_true( int no, char const *expr, int line, bool result ) {
+  if ( !result ) {
+    cout << '#' << no << " FAILED, line " << line << ": " << expr << endl;
+    ++failures;
+  }
+  return result;
+}
+
+#define ASSERT_TRUE( NO, EXPR ) assert_true( NO, #EXPR, __LINE__, !!(EXPR) )
+
+///////////////////////////////////////////////////////////////////////////////
+
+static cpu::simd_level const levels[] = {
+  cpu::simd_sse2, cpu::simd_ssse3, cpu::simd_avx2
+};
+static int const num_levels = sizeof( levels ) / sizeof( levels[0] );
+
+static char const *const level_names[] = { "scalar", "SSE2", "SSSE3", "AVX2" };
+
+static string random_bytes( int size ) {
+  string s;
+  for ( int i = 0; i < size; ++i )
+    s += static_cast<char>( ::rand() );
+  return s;
+}
+
+/**
+ * Randomly inserts whitespace, replaces characters, or deletes characters of
+ * the given encoded string so that decoding it exercises the error and
+ * whitespace-skipping paths.
+ */
+static void mutate( string *s, char const *replacements ) {
+  string::size_type const num_replacements = ::strlen( replacements );
+  for ( int n = ::rand() % 4; n > 0 && !s->empty(); --n ) {
+    string::size_type const pos = ::rand() % s->size();
+    switch ( ::rand() % 4 ) {
+      case 0: s->insert( pos, "\r\n" ); break;
+      case 1: s->insert( pos, " " ); break;
+      case 2: (*s)[ pos ] = replacements[ ::rand() % num_replacements ]; break;
+      case 3: s->erase( pos, 1 ); break;
+    }
+  }
+}
+
+/**
+ * Decodes the given string and returns either the decoded bytes or, if it
+ * could not be decoded, a description of the error so that results can be
+ * compared across SIMD levels.
+ */
+template<class ExceptionType,typename SizeType>
+static string decode( string const &s, int options,
+                      SizeType (*decode_fn)( char const*, SizeType, char*,
+                                             int ) ) {
+  string result( s.size() + 1, '\0' );
+  try {
+    result.resize( (*decode_fn)( s.data(), s.size(), &result[0], options ) );
+    return result;
+  }
+  catch ( ExceptionType const &e ) {
+    return string( "!" ) + e.invalid_char() + e.what();
+  }
+  catch ( invalid_argument const &e ) {
+    return string( "!" ) + e.what();
+  }
+}
+
+static base64::size_type base64_decode( char const *from,
+                                        base64::size_type from_len, char *to,
+                                        int options ) {
+  return base64::decode( from, from_len, to, options );
+}
+
+static hexbinary::size_type hexbinary_decode( char const *from,
+                                              hexbinary::size_type from_len,
+                                              char *to, int options ) {
+  return hexbinary::decode( from, from_len, to, options );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Encodes and decodes the given bytes with the scalar codecs and with each
+ * SIMD level and checks that the results are identical.
+ */
+static void test_codecs( int no, string const &raw ) {
+  cpu::set_simd_level( cpu::simd_none );
+
+  string b64( base64::encoded_size( raw.size() ), '\0' );
+  b64.resize( base64::encode( raw.data(), raw.size(), &b64[0] ) );
+  string hex( hexbinary::encoded_size( raw.size() ), '\0' );
+  hex.resize( hexbinary::encode( raw.data(), raw.size(), &hex[0] ) );
+
+  string b64_mutated( b64 );
+  mutate( &b64_mutated, "=*-A/" );
+  string hex_mutated( hex );
+  if ( ::rand() % 2 )
+    for ( string::size_type i = 0; i < hex_mutated.size(); ++i )
+      hex_mutated[i] = static_cast<char>( ::tolower( hex_mutated[i] ) );
+  mutate( &hex_mutated, "gG/:@`0f" );
+  int const b64_options = ::rand() % 4;
+  int const hex_options = ::rand() % 2 ? hexbinary::dopt_ignore_ws : 0;
+
+  string const b64_decoded( decode<base64::exception>(
+    b64_mutated, b64_options, &base64_decode
+  ) );
+  string const hex_decoded( decode<hexbinary::exception>(
+    hex_mutated, hex_options, &hexbinary_decode
+  ) );
+  if ( b64_mutated == b64 && !b64_options )
+    ASSERT_TRUE( no, b64_decoded == raw );
+
+  for ( int i = 0; i < num_levels; ++i ) {
+    cpu::set_simd_level( levels[i] );
+
+    string s( b64.size(), '\0' );
+    s.resize( base64::encode( raw.data(), raw.size(), &s[0] ) );
+    ASSERT_TRUE( no, s == b64 );
+    s.assign( hex.size(), '\0' );
+    s.resize( hexbinary::encode( raw.data(), raw.size(), &s[0] ) );
+    ASSERT_TRUE( no, s == hex );
+
+    ASSERT_TRUE( no,
+      decode<base64::exception>( b64_mutated, b64_options, &base64_decode )
+      == b64_decoded
+    );
+    ASSERT_TRUE( no,
+      decode<hexbinary::exception>( hex_mutated, hex_options,
+                                    &hexbinary_decode )
+      == hex_decoded
+    );
+  }
+  cpu::set_simd_level( cpu::simd_avx2 );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static double elapsed_ms( time::sec_type sec0, time::usec_type usec0 ) {
+  time::sec_type sec;
+  time::usec_type usec;
+  time::get_epoch( &sec, &usec );
+  return (sec - sec0) * 1000.0 + (usec - usec0) / 1000.0;
+}
+
+static double mb_per_sec( string::size_type size, double ms ) {
+  return ms > 0 ? size / (1024.0 * 1024.0) / (ms / 1000.0) : 0;
+}
+
+/**
+ * Prints the encoding and decoding throughput of the scalar codecs and of
+ * each SIMD level supported by the CPU.
+ */
+static void benchmark() {
+  time::sec_type sec;
+  time::usec_type usec;
+  string const raw( random_bytes( 8 * 1024 * 1024 ) );
+  string b64( base64::encoded_size( raw.size() ), '\0' );
+  string hex( hexbinary::encoded_size( raw.size() ), '\0' );
+  string decoded( raw.size(), '\0' );
+
+  cpu::simd_level const detected = cpu::get_simd_level();
+  for ( int level = cpu::simd_none; level <= detected; ++level ) {
+    cpu::set_simd_level( static_cast<cpu::simd_level>( level ) );
+
+    time::get_epoch( &sec, &usec );
+    base64::encode( raw.data(), raw.size(), &b64[0] );
+    double const b64_encode_ms = elapsed_ms( sec, usec );
+
+    time::get_epoch( &sec, &usec );
+    base64::decode( b64.data(), b64.size(), &decoded[0] );
+    double const b64_decode_ms = elapsed_ms( sec, usec );
+
+    time::get_epoch( &sec, &usec );
+    hexbinary::encode( raw.data(), raw.size(), &hex[0] );
+    double const hex_encode_ms = elapsed_ms( sec, usec );
+
+    time::get_epoch( &sec, &usec );
+    hexbinary::decode( hex.data(), hex.size(), &decoded[0] );
+    double const hex_decode_ms = elapsed_ms( sec, usec );
+
+    cout << level_names[ level ] << ": base64 encode "
+         << mb_per_sec( raw.size(), b64_encode_ms ) << " MB/s, decode "
+         << mb_per_sec( raw.size(), b64_decode_ms ) << " MB/s; "
+         << "hexBinary encode "
+         << mb_per_sec( raw.size(), hex_encode_ms ) << " MB/s, decode "
+         << mb_per_sec( raw.size(), hex_decode_ms ) << " MB/s\n";
+  }
+  cpu::set_simd_level( cpu::simd_avx2 );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace zorba {
+namespace UnitTests {
+
+int test_binary_codecs( int, char*[] ) {
+  int test_no = 0;
+
+  ::srand( 1 );
+  for ( int i = 0; i < 20000; ++i, ++test_no )
+    test_codecs( test_no, random_bytes( ::rand() % 200 ) );
+
+  benchmark();
+
+  cout << failures << " test(s) failed\n";
+  return failures ? 1 : 0;
+}
+
+} // namespace UnitTests
+} // namespace zorba
+
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,278 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stdafx.h"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "store/api/item.h"
+#include "store/api/item_factory.h"
+#include "system/globalenv.h"
+#include "util/time_util.h"
+#include "zorbautils/flat_hashset.h"
+#include "zorbautils/hashfun.h"
+#include "zorbautils/hashmap_itemh.h"
+#include "zorbautils/hashset.h"
+#include "zorbautils/hashset_structured_itemh.h"
+
+using namespace std;
+using namespace zorba;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static int failures;
+
+static bool assert_true( int no, char const *expr, int line, bool result ) {
+  if ( !result ) {
+    cout << '#' << no << " FAILED, line " << line << ": " << expr << endl;
+    ++failures;
+  }
+  return result;
+}
+
+#define ASSERT_TRUE( NO, EXPR ) assert_true( NO, #EXPR, __LINE__, !!(EXPR) )
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Hashes only the low 4 bits so that keys collide a lot and runs of occupied
+ * slots wrap around the end of the table.
+ */
+class BadIntCompare {
+public:
+  static bool equal( int i, int j ) {
+    return i == j;
+  }
+
+  static uint32_t hash( int i ) {
+    return i & 0xF;
+  }
+};
+
+class StringCompare {
+public:
+  static bool equal( zstring const &s1, zstring const &s2 ) {
+    return s1 == s2;
+  }
+
+  static uint32_t hash( zstring const &s ) {
+    return hashfun::h32w( s.data(), s.size() );
+  }
+};
+
+struct StringEquals {
+  StringEquals( zstring const &s ) : s_( s ) { }
+  bool operator()( zstring const &s ) const { return s == s_; }
+  zstring const &s_;
+};
+
+static bool is_odd( int i ) {
+  return i & 1;
+}
+
+typedef FlatHashMap<int,int,BadIntCompare> int_map_type;
+typedef map<int,int> ref_map_type;
+
+static bool same( int_map_type const &m, ref_map_type const &ref ) {
+  if ( m.size() != ref.size() )
+    return false;
+  csize n = 0;
+  for ( int_map_type::iterator i = m.begin(); i != m.end(); ++i, ++n ) {
+    ref_map_type::const_iterator const j = ref.find( i.getKey() );
+    if ( j == ref.end() || j->second != i.getValue() )
+      return false;
+  }
+  if ( n != ref.size() )
+    return false;
+  for ( ref_map_type::const_iterator j = ref.begin(); j != ref.end(); ++j ) {
+    int value;
+    if ( !m.get( j->first, value ) || value != j->second )
+      return false;
+  }
+  return true;
+}
+
+static void test_int_map( int &test_no ) {
+  int_map_type m( 8, false );
+  ref_map_type ref;
+
+  ::srand( 1 );
+  for ( int i = 0; i < 20000; ++i ) {
+    int const key = ::rand() % 500;
+    int value = ::rand();
+    if ( ::rand() % 3 ) {
+      bool const inserted = ref.insert( make_pair( key, value ) ).second;
+      ASSERT_TRUE( test_no, m.insert( key, value ) == inserted );
+      if ( !inserted )
+        ASSERT_TRUE( test_no, value == ref[ key ] );
+    } else {
+      ASSERT_TRUE( test_no, m.erase( key ) == (ref.erase( key ) == 1) );
+    }
+    if ( i % 1000 == 0 && !ASSERT_TRUE( test_no, same( m, ref ) ) )
+      break;
+  }
+  ASSERT_TRUE( test_no, same( m, ref ) );
+  ++test_no;
+
+  ASSERT_TRUE( test_no, m.update( ref.begin()->first, -1 ) );
+  ref.begin()->second = -1;
+  ASSERT_TRUE( test_no, !m.update( 1000, -1 ) );
+  ASSERT_TRUE( test_no, m.find( 1000 ) == m.end() );
+  ASSERT_TRUE( test_no, m.find( ref.begin()->first ).getValue() == -1 );
+  ASSERT_TRUE( test_no, same( m, ref ) );
+  ++test_no;
+
+  m.eraseIfNoSync( is_odd );
+  for ( ref_map_type::iterator j = ref.begin(); j != ref.end(); )
+    if ( is_odd( j->first ) )
+      ref.erase( j++ );
+    else
+      ++j;
+  ASSERT_TRUE( test_no, same( m, ref ) );
+  ++test_no;
+
+  m.clear();
+  ASSERT_TRUE( test_no, m.empty() && m.begin() == m.end() );
+  ++test_no;
+}
+
+static void test_string_set( int &test_no ) {
+  FlatHashSet<zstring,StringCompare> s( 4, false );
+  char buf[ 16 ];
+
+  for ( int i = 0; i < 1000; ++i ) {
+    ::sprintf( buf, "s%d", i );
+    ASSERT_TRUE( test_no, s.insert( zstring( buf ) ) );
+  }
+  ASSERT_TRUE( test_no, s.size() == 1000 );
+  ++test_no;
+
+  zstring const s7( "s7" );
+  zstring pooled;
+  ASSERT_TRUE( test_no, !s.insert( s7, pooled ) );
+  ASSERT_TRUE( test_no, pooled == s7 );
+  zstring const *const found =
+    s.findNoSync( StringCompare::hash( s7 ), StringEquals( s7 ) );
+  ASSERT_TRUE( test_no, found && *found == s7 );
+  ASSERT_TRUE( test_no, s.erase( s7 ) && !s.exists( s7 ) );
+  ASSERT_TRUE( test_no, s.exists( zstring( "s999" ) ) );
+  ++test_no;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static double elapsed_ms( time::sec_type sec0, time::usec_type usec0 ) {
+  time::sec_type sec;
+  time::usec_type usec;
+  time::get_epoch( &sec, &usec );
+  return (sec - sec0) * 1000.0 + (usec - usec0) / 1000.0;
+}
+
+/**
+ * Inserts every item (each one twice) into a set, then looks every item up,
+ * then erases every item.
+ */
+template<class SetType>
+static double time_set( SetType &set, vector<store::Item*> const &items ) {
+  time::sec_type sec;
+  time::usec_type usec;
+  csize found = 0;
+
+  time::get_epoch( &sec, &usec );
+  for ( int pass = 0; pass < 2; ++pass )
+    for ( csize i = 0; i < items.size(); ++i ) {
+      store::Item *item = items[i];
+      set.insert( item );
+    }
+  for ( csize i = 0; i < items.size(); ++i )
+    found += set.exists( items[i] );
+  for ( csize i = 0; i < items.size(); ++i )
+    set.erase( items[i] );
+  double const ms = elapsed_ms( sec, usec );
+
+  return found == items.size() && set.empty() ? ms : -1;
+}
+
+/**
+ * Compares HashSet and FlatHashSet on item-handle keys, both by identity (as
+ * for node sets) and by value (as for fn:distinct-values()).
+ */
+static void benchmark( int &test_no ) {
+  csize const num_items = 200000;
+  vector<store::Item_t> items;
+  vector<store::Item*> ptrs;
+  char buf[ 32 ];
+
+  for ( csize i = 0; i < num_items; ++i ) {
+    store::Item_t item;
+    zstring s( "item-" );
+    ::sprintf( buf, "%lu", static_cast<unsigned long>( i * 7919 ) );
+    s += buf;
+    GENV_ITEMFACTORY->createString( item, s );
+    items.push_back( item );
+    ptrs.push_back( item.getp() );
+  }
+
+  typedef StructuredItemHandleHashSet::CompareFunction identity_cmp;
+  HashSet<store::Item*,identity_cmp> chained_id( 1024, false );
+  FlatHashSet<store::Item*,identity_cmp> flat_id( 1024, false );
+
+  ItemHandleHashMapCmp const value_cmp( 0, NULL );
+  HashSet<store::Item*,ItemHandleHashMapCmp> chained_value(
+    value_cmp, 1024, false
+  );
+  FlatHashSet<store::Item*,ItemHandleHashMapCmp> flat_value(
+    value_cmp, 1024, false
+  );
+
+  double const chained_id_ms = time_set( chained_id, ptrs );
+  double const flat_id_ms = time_set( flat_id, ptrs );
+  double const chained_value_ms = time_set( chained_value, ptrs );
+  double const flat_value_ms = time_set( flat_value, ptrs );
+
+  ASSERT_TRUE( test_no, chained_id_ms >= 0 && flat_id_ms >= 0 );
+  ASSERT_TRUE( test_no, chained_value_ms >= 0 && flat_value_ms >= 0 );
+  ++test_no;
+
+  cout << num_items << " item handles by identity: HashSet "
+       << chained_id_ms << " ms, FlatHashSet " << flat_id_ms << " ms\n"
+       << num_items << " item handles by value: HashSet "
+       << chained_value_ms << " ms, FlatHashSet " << flat_value_ms << " ms\n";
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace zorba {
+namespace UnitTests {
+
+int test_flat_hashmap( int, char*[] ) {
+  int test_no = 0;
+
+  test_int_map( test_no );
+  test_string_set( test_no );
+  benchmark( test_no );
+
+  cout << failures << " test(s) failed\n";
+  return failures ? 1 : 0;
+}
+
+} // namespace UnitTests
+} // namespace zorba
+
+/* vim:set et sw=2 ts=2: */
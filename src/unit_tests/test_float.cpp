@@ -0,0 +1,197 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stdafx.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "util/time_util.h"
+#include "zorbatypes/float.h"
+
+using namespace std;
+using namespace zorba;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static int failures;
+
+static bool assert_true( int no, char const *expr, int line, bool result ) {
+  if ( !result ) {
+    cout << '#' << no << " FAILED, line " << line << ": " << expr << endl;
+    ++failures;
+  }
+  return result;
+}
+
+#define ASSERT_TRUE( NO, EXPR ) assert_true( NO, #EXPR, __LINE__, !!(EXPR) )
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct test {
+  char const *input;
+  char const *expected;
+};
+
+static test const double_tests[] = {
+  { "0.1", "0.1" },
+  { "1.0000001", "1.0000001" },
+  { "2.9999", "2.9999" },
+  { "100", "100" },
+  { "-0.5", "-0.5" },
+  { "0.000001", "0.000001" },
+  { "9.99999e-7", "9.99999E-7" },
+  { "0.000025", "0.000025" },
+  { "999999.5", "999999.5" },
+  { "1e6", "1.0E6" },
+  { "99999999", "9.9999999E7" },
+  { "123456789", "1.23456789E8" },
+  { "1e23", "1.0E23" },
+  // Grisu2 alone generates more digits than needed for these.
+  { "8e23", "8.0E23" },
+  { "3.1e22", "3.1E22" },
+  { "6.6573e20", "6.6573E20" },
+  { "1.7976931348623157e308", "1.7976931348623157E308" },
+  { "4.9e-324", "5.0E-324" },
+  { "-1e-10", "-1.0E-10" },
+  { "-0", "-0" },
+  { "INF", "INF" },
+  { "NaN", "NaN" },
+  { 0, 0 }
+};
+
+static test const float_tests[] = {
+  { "0.1", "0.1" },
+  { "3.14159", "3.14159" },
+  { "123456789", "1.2345679E8" },
+  { "3.4028235e38", "3.4028235E38" },
+  { "1e-45", "1.0E-45" },
+  // Grisu2 alone generates more digits than needed for these.
+  { "4.9e9", "4.9E9" },
+  { "7.781e8", "7.781E8" },
+  { 0, 0 }
+};
+
+static double random_double() {
+  uint64_t bits = 0;
+  for ( int i = 0; i < 4; ++i )
+    bits = (bits << 16) ^ (::rand() & 0xFFFF);
+  double d;
+  ::memcpy( &d, &bits, sizeof( d ) );
+  return d;
+}
+
+static double elapsed_ms( time::sec_type sec0, time::usec_type usec0 ) {
+  time::sec_type sec;
+  time::usec_type usec;
+  time::get_epoch( &sec, &usec );
+  return (sec - sec0) * 1000.0 + (usec - usec0) / 1000.0;
+}
+
+/**
+ * Times toString() and parsing against snprintf(3) and strtod(3) with the 17
+ * digits needed to always round-trip.
+ */
+static void benchmark( vector<double> const &values ) {
+  time::sec_type sec;
+  time::usec_type usec;
+  vector<zstring> strings;
+  strings.reserve( values.size() );
+  double sum = 0;
+
+  time::get_epoch( &sec, &usec );
+  for ( vector<double>::const_iterator i = values.begin(); i != values.end();
+        ++i )
+    strings.push_back( xs_double( *i ).toString() );
+  double const format_ms = elapsed_ms( sec, usec );
+
+  time::get_epoch( &sec, &usec );
+  for ( vector<zstring>::const_iterator i = strings.begin();
+        i != strings.end(); ++i )
+    sum += xs_double( i->c_str() ).getNumber();
+  double const parse_ms = elapsed_ms( sec, usec );
+
+  char buf[ 32 ];
+  time::get_epoch( &sec, &usec );
+  for ( vector<double>::const_iterator i = values.begin(); i != values.end();
+        ++i ) {
+    ::snprintf( buf, sizeof buf, "%.17G", *i );
+    sum += ::strtod( buf, nullptr );
+  }
+  double const printf_ms = elapsed_ms( sec, usec );
+
+  cout << values.size() << " doubles: toString " << format_ms << " ms, "
+       << "parse " << parse_ms << " ms; "
+       << "snprintf+strtod " << printf_ms << " ms"
+       << (sum == 0 ? " " : "") << endl;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace zorba {
+namespace UnitTests {
+
+int test_float( int, char*[] ) {
+  int test_no = 0;
+
+  for ( test const *t = double_tests; t->input; ++t, ++test_no ) {
+    xs_double const d( t->input );
+    ASSERT_TRUE( test_no, d.toString() == t->expected );
+  }
+  for ( test const *t = float_tests; t->input; ++t, ++test_no ) {
+    xs_float const f( t->input );
+    ASSERT_TRUE( test_no, f.toString() == t->expected );
+  }
+
+  //
+  // The canonical representation must convert back to the same value.
+  //
+  vector<double> values;
+  ::srand( 42 );
+  while ( values.size() < 100000 ) {
+    double const d = random_double();
+    if ( d == d && d - d == 0 )         // skip NaN and INF
+      values.push_back( d );
+  }
+  for ( vector<double>::const_iterator i = values.begin(); i != values.end();
+        ++i ) {
+    xs_double const d( *i );
+    zstring const s( d.toString() );
+    if ( !ASSERT_TRUE( test_no, xs_double( s.c_str() ).getNumber() == *i ) )
+      break;
+    xs_float const f( static_cast<float>( *i ) );
+    zstring const fs( f.toString() );
+    if ( !ASSERT_TRUE( test_no, xs_float( fs.c_str() ) == f ) )
+      break;
+  }
+  ++test_no;
+
+  vector<double> numbers;
+  for ( int i = 0; i < 100000; ++i )
+    numbers.push_back( i * 0.37 + 1.0 / (i + 1) );
+  benchmark( numbers );
+  benchmark( values );
+
+  cout << failures << " test(s) failed\n";
+  return failures ? 1 : 0;
+}
+
+} // namespace UnitTests
+} // namespace zorba
+
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stdafx.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <zorba/properties.h>
+
+#include "context/static_context.h"
+#include "functions/function.h"
+#include "functions/library.h"
+#include "store/api/item.h"
+#include "store/api/item_factory.h"
+#include "system/globalenv.h"
+
+using namespace std;
+using namespace zorba;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static int failures;
+
+static bool assert_true( int no, char const *expr, int line, bool result ) {
+  if ( !result ) {
+    cout << '#' << no << " FAILED, line " << line << ": " << expr << endl;
+    ++failures;
+  }
+  return result;
+}
+
+#define ASSERT_TRUE( NO, EXPR ) assert_true( NO, #EXPR, __LINE__, !!(EXPR) )
+
+///////////////////////////////////////////////////////////////////////////////
+
+static zorba::function* lookup_builtin( char const *ns, char const *local,
+                                        csize arity ) {
+  store::Item_t qname;
+  GENV_ITEMFACTORY->createQName( qname, ns, "", local );
+  return GENV_ROOT_STATIC_CONTEXT.lookup_fn( qname.getp(), arity );
+}
+
+/**
+ * Resolves a function of a namespace whose functions are registered lazily.
+ */
+static void test_lookup( int &test_no ) {
+  BuiltinFunctionLibrary *const lib = GENV_FUNC_LIB;
+  bool const lazy = Properties::instance().getLazyBuiltins();
+
+  ASSERT_TRUE( test_no, !lazy || lib->hasLazyGroups() );
+  ++test_no;
+
+  zorba::function const *const f =
+    lookup_builtin( static_context::ZORBA_BASE64_FN_NS, "encode", 1 );
+  if ( ASSERT_TRUE( test_no, f ) ) {
+    ASSERT_TRUE(
+      test_no, f->getKind() == FunctionConsts::FN_ZORBA_BASE64_ENCODE_1
+    );
+    ASSERT_TRUE( test_no, lib->getFunction( f->getKind() ) == f );
+  }
+  ++test_no;
+
+  // Another lazy namespace is still unregistered.
+  ASSERT_TRUE( test_no, !lazy || lib->hasLazyGroups() );
+  ++test_no;
+}
+
+#ifndef ZORBA_FOR_ONE_THREAD_ONLY
+/**
+ * Resolves functions of lazily registered namespaces from several threads at
+ * once: every thread must get the same function object.  (Without threading
+ * support, the locks of the library and of the sctx maps are compiled out.)
+ */
+static void test_concurrent_lookup( int &test_no ) {
+  static csize const NUM_THREADS = 8;
+  static csize const NUM_LOOKUPS = 1000;
+
+  vector<zorba::function*> csv_parse( NUM_THREADS );
+  vector<zorba::function*> uri_parse( NUM_THREADS );
+  vector<thread> threads;
+
+  for ( csize i = 0; i < NUM_THREADS; ++i ) {
+    threads.push_back( thread( [&,i]() {
+      for ( csize j = 0; j < NUM_LOOKUPS; ++j ) {
+        csv_parse[i] =
+          lookup_builtin( static_context::ZORBA_JSON_CSV_FN_NS, "parse", 2 );
+        uri_parse[i] =
+          lookup_builtin( static_context::ZORBA_URI_FN_NS, "parse", 1 );
+      }
+    } ) );
+  }
+  for ( csize i = 0; i < NUM_THREADS; ++i )
+    threads[i].join();
+
+  for ( csize i = 0; i < NUM_THREADS; ++i ) {
+    ASSERT_TRUE( test_no, csv_parse[i] && csv_parse[i] == csv_parse[0] );
+    ASSERT_TRUE( test_no, uri_parse[i] && uri_parse[i] == uri_parse[0] );
+  }
+  ++test_no;
+}
+#endif /* ZORBA_FOR_ONE_THREAD_ONLY */
+
+/**
+ * Gets, by kind, a function whose group has not been registered yet.
+ */
+static void test_get_function( int &test_no ) {
+  BuiltinFunctionLibrary *const lib = GENV_FUNC_LIB;
+
+  FunctionConsts::FunctionKind const kind =
+    FunctionConsts::FN_ZORBA_XQDOC_XQDOC_CONTENT_IMPL_2;
+
+  zorba::function const *const f = lib->getFunction( kind );
+  if ( ASSERT_TRUE( test_no, f ) )
+    ASSERT_TRUE( test_no, f->getKind() == kind );
+  ++test_no;
+
+  ASSERT_TRUE( test_no, !lib->hasLazyGroups() );
+  ++test_no;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace zorba {
+namespace UnitTests {
+
+int test_function_library( int, char*[] ) {
+  int test_no = 0;
+
+  test_lookup( test_no );
+#ifndef ZORBA_FOR_ONE_THREAD_ONLY
+  test_concurrent_lookup( test_no );
+#endif /* ZORBA_FOR_ONE_THREAD_ONLY */
+  test_get_function( test_no );
+
+  cout << failures << " test(s) failed\n";
+  return failures ? 1 : 0;
+}
+
+} // namespace UnitTests
+} // namespace zorba
+
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,221 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stdafx.h"
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "store/api/item.h"
+#include "store/api/item_factory.h"
+#include "store/util/string_chunk_reader.h"
+#include "system/globalenv.h"
+
+using namespace std;
+using namespace zorba;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static int failures;
+
+static bool assert_true( int no, char const *expr, int line, bool result ) {
+  if ( !result ) {
+    cout << '#' << no << " FAILED, line " << line << ": " << expr << endl;
+    ++failures;
+  }
+  return result;
+}
+
+#define ASSERT_TRUE( NO, EXPR ) assert_true( NO, #EXPR, __LINE__, !!(EXPR) )
+
+///////////////////////////////////////////////////////////////////////////////
+
+typedef vector<zstring> strings;
+
+static void release_stream( std::istream *is ) {
+  delete is;
+}
+
+static store::Item_t make_streamable( zstring const &s, bool seekable ) {
+  store::Item_t item;
+  istringstream *const is = new istringstream( string( s.data(), s.size() ) );
+  GENV_ITEMFACTORY->createStreamableString(
+    item, *is, release_stream, seekable
+  );
+  return item;
+}
+
+static store::Item_t make_string( zstring const &s ) {
+  store::Item_t item;
+  zstring copy( s );
+  GENV_ITEMFACTORY->createString( item, copy );
+  return item;
+}
+
+/**
+ * Splits the way fn:tokenize() does for a literal separator.
+ */
+static strings split( zstring const &s, zstring const &sep ) {
+  strings result;
+  if ( s.empty() )
+    return result;
+  zstring::size_type pos = 0;
+  for ( ;; ) {
+    zstring::size_type const found = s.find( sep, pos );
+    if ( found == zstring::npos ) {
+      result.push_back( s.substr( pos ) );
+      return result;
+    }
+    result.push_back( s.substr( pos, found - pos ) );
+    pos = found + sep.size();
+  }
+}
+
+/**
+ * Splits the way fn:unparsed-text-lines() does.
+ */
+static strings lines( zstring const &s ) {
+  strings result;
+  zstring line;
+  bool pending = false;
+  for ( zstring::size_type i = 0; i < s.size(); ++i ) {
+    char const c = s[i];
+    if ( c == '\n' || c == '\r' ) {
+      result.push_back( line );
+      line.clear();
+      pending = false;
+      if ( c == '\r' && i + 1 < s.size() && s[ i + 1 ] == '\n' )
+        ++i;
+    } else {
+      line += c;
+      pending = true;
+    }
+  }
+  if ( pending )
+    result.push_back( line );
+  return result;
+}
+
+static bool is_utf8_aligned( char const *data, csize size ) {
+  unsigned char const first = static_cast<unsigned char>( data[0] );
+  unsigned char const last = static_cast<unsigned char>( data[ size - 1 ] );
+  return (first & 0xC0) != 0x80 && last < 0xC0;
+}
+
+/**
+ * Reads the given string through a StringChunkReader as a non-streamable, a
+ * seekable streamable, and a non-seekable streamable item, with the given
+ * chunk size, and compares chunks, tokens, and lines against reading it as a
+ * whole.  Every item is read several times: a non-seekable one is then read
+ * from its materialized value rather than from its stream, which can be read
+ * only once.
+ */
+static void test_string( int test_no, zstring const &s, csize chunk_size ) {
+  store::StringChunkReader reader;
+  char const *data;
+  csize size;
+  zstring token;
+  zstring const seps[] = { ",", "ab" };
+
+  for ( int kind = 0; kind < 3; ++kind ) {
+    store::Item_t item(
+      kind ? make_streamable( s, kind == 1 ) : make_string( s )
+    );
+
+    zstring all;
+    reader.init( item.getp(), true, chunk_size );
+    ASSERT_TRUE( test_no, reader.isStreaming() == (kind == 1) );
+    while ( reader.next( data, size ) ) {
+      all.append( data, size );
+      if ( !ASSERT_TRUE( test_no, size && is_utf8_aligned( data, size ) ) )
+        break;
+    }
+    ASSERT_TRUE( test_no, all == s );
+
+    for ( int i = 0; i < 2; ++i ) {
+      strings tokens;
+      reader.init( item.getp(), true, chunk_size );
+      while ( reader.nextToken( seps[i], token ) )
+        tokens.push_back( token );
+      ASSERT_TRUE( test_no, tokens == split( s, seps[i] ) );
+    }
+
+    strings ls;
+    reader.init( item.getp(), true, chunk_size );
+    while ( reader.nextLine( token ) )
+      ls.push_back( token );
+    ASSERT_TRUE( test_no, ls == lines( s ) );
+
+    reader.clear();
+    ASSERT_TRUE( test_no, !reader.isInitialized() );
+
+    // The item can still be used after it has been read.
+    ASSERT_TRUE( test_no, item->getStringValue() == s );
+  }
+
+  // A non-seekable item that is read for the last time is streamed.
+  store::Item_t item( make_streamable( s, false ) );
+  zstring all;
+  reader.init( item.getp(), true, chunk_size, true );
+  ASSERT_TRUE( test_no, reader.isStreaming() );
+  while ( reader.next( data, size ) )
+    all.append( data, size );
+  ASSERT_TRUE( test_no, all == s );
+  reader.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace zorba {
+namespace UnitTests {
+
+int test_string_chunk_reader( int, char*[] ) {
+  int test_no = 0;
+
+  test_string( test_no++, "", 4 );
+  test_string( test_no++, "a,b,,c,", 4 );
+  test_string( test_no++, "line1\r\nline2\rline3\n\nline5", 4 );
+  test_string( test_no++, "\r", 4 );
+  test_string( test_no++, "\xE2\x82\xAC\xE2\x82\xAC,\xC3\xA9", 5 );
+
+  //
+  // Random strings of separators, line ends, and multi-byte characters with
+  // small chunks so that all of them get split across chunk boundaries.
+  //
+  char const *const pieces[] = {
+    "a", "b", "ab", ",", "\n", "\r", "\xC3\xA9", "\xE2\x82\xAC",
+    "\xF0\x9D\x84\x9E"
+  };
+  int const num_pieces = sizeof( pieces ) / sizeof( pieces[0] );
+
+  ::srand( 1 );
+  for ( int i = 0; i < 2000 && !failures; ++i, ++test_no ) {
+    zstring s;
+    for ( int n = ::rand() % 40; n > 0; --n )
+      s += pieces[ ::rand() % num_pieces ];
+    test_string( test_no, s, 1 + ::rand() % 8 );
+  }
+
+  cout << failures << " test(s) failed\n";
+  return failures ? 1 : 0;
+}
+
+} // namespace UnitTests
+} // namespace zorba
+
+/* vim:set et sw=2 ts=2: */
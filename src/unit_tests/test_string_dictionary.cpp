@@ -0,0 +1,198 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stdafx.h"
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "store/api/item.h"
+#include "store/api/item_factory.h"
+#include "system/globalenv.h"
+#include "zorbautils/string_dictionary.h"
+
+using namespace std;
+using namespace zorba;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static int failures;
+
+static bool assert_true( int no, char const *expr, int line, bool result ) {
+  if ( !result ) {
+    cout << '#' << no << " FAILED, line " << line << ": " << expr << endl;
+    ++failures;
+  }
+  return result;
+}
+
+#define ASSERT_TRUE( NO, EXPR ) assert_true( NO, #EXPR, __LINE__, !!(EXPR) )
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Interns a copy of the given value, since createItem() may swap it with an
+ * empty string.
+ */
+static store::Item_t intern( StringDictionary &dict, zstring const &value ) {
+  zstring copy( value );
+  store::Item_t item;
+  dict.createItem( item, copy );
+  return item;
+}
+
+static zstring make_value( char const *prefix, csize i ) {
+  ostringstream oss;
+  oss << prefix << i;
+  return oss.str();
+}
+
+static void test_intern( int &test_no ) {
+  StringDictionary dict( GENV_ITEMFACTORY, false );
+
+  store::Item_t const a1( intern( dict, "a" ) );
+  store::Item_t const b1( intern( dict, "b" ) );
+  store::Item_t const a2( intern( dict, "a" ) );
+
+  ASSERT_TRUE( test_no, a1->getTypeCode() == store::XS_STRING );
+  ASSERT_TRUE( test_no, a1->getStringValue() == "a" );
+  ASSERT_TRUE( test_no, b1->getStringValue() == "b" );
+  ++test_no;
+
+  // The same value gives the same item; a different one doesn't.
+  ASSERT_TRUE( test_no, a1.getp() == a2.getp() );
+  ASSERT_TRUE( test_no, a1.getp() != b1.getp() );
+  ASSERT_TRUE( test_no, dict.numStrings() == 2 );
+  ASSERT_TRUE( test_no, dict.numLookups() == 3 );
+  ASSERT_TRUE( test_no, dict.numHits() == 1 );
+  ++test_no;
+
+  StringDictionary untyped( GENV_ITEMFACTORY, true );
+  store::Item_t const u( intern( untyped, "a" ) );
+  ASSERT_TRUE( test_no, u->getTypeCode() == store::XS_UNTYPED_ATOMIC );
+  ASSERT_TRUE( test_no, u->getStringValue() == "a" );
+  ASSERT_TRUE( test_no, u.getp() != a1.getp() );
+  ++test_no;
+
+  // Long values aren't pooled.
+  zstring const long_value( StringDictionary::MAX_STRING_SIZE + 1, 'x' );
+  store::Item_t const l1( intern( dict, long_value ) );
+  store::Item_t const l2( intern( dict, long_value ) );
+  ASSERT_TRUE( test_no, l1->getStringValue() == long_value );
+  ASSERT_TRUE( test_no, l1.getp() != l2.getp() );
+  ASSERT_TRUE( test_no, dict.numStrings() == 2 );
+  ++test_no;
+
+  dict.clear();
+  store::Item_t const a3( intern( dict, "a" ) );
+  ASSERT_TRUE( test_no, a3.getp() != a1.getp() );
+  ASSERT_TRUE( test_no, dict.numStrings() == 1 );
+  ASSERT_TRUE( test_no, dict.numHits() == 0 );
+  ++test_no;
+}
+
+/**
+ * Once the dictionary is full, new values are no longer added, but the ones
+ * already in it are still shared.
+ */
+static void test_lookup_when_full( int &test_no ) {
+  StringDictionary dict( GENV_ITEMFACTORY, false );
+
+  store::Item_t const first( intern( dict, make_value( "v", 0 ) ) );
+  for ( csize i = 1; i < StringDictionary::MAX_STRINGS; ++i )
+    intern( dict, make_value( "v", i ) );
+  ASSERT_TRUE( test_no, dict.numStrings() == StringDictionary::MAX_STRINGS );
+  ++test_no;
+
+  zstring const extra( make_value( "w", 0 ) );
+  store::Item_t const e1( intern( dict, extra ) );
+  store::Item_t const e2( intern( dict, extra ) );
+  ASSERT_TRUE( test_no, e1->getStringValue() == extra );
+  ASSERT_TRUE( test_no, e1.getp() != e2.getp() );
+  ASSERT_TRUE( test_no, dict.numStrings() == StringDictionary::MAX_STRINGS );
+  ++test_no;
+
+  ASSERT_TRUE( test_no, intern( dict, make_value( "v", 0 ) ) == first );
+  ++test_no;
+}
+
+#ifndef ZORBA_FOR_ONE_THREAD_ONLY
+/**
+ * A dictionary belongs to a single loader, but several loaders (each with its
+ * own dictionary) run at once when files are loaded in parallel; they share
+ * only the item factory.
+ */
+static void test_concurrent( int &test_no ) {
+  static csize const NUM_THREADS = 8;
+  static csize const NUM_VALUES = 1000;
+  static csize const NUM_ROUNDS = 10;
+
+  vector<csize> errors( NUM_THREADS );
+  vector<thread> threads;
+
+  for ( csize t = 0; t < NUM_THREADS; ++t ) {
+    threads.push_back( thread( [&,t]() {
+      StringDictionary dict( GENV_ITEMFACTORY, t % 2 == 0 );
+      vector<store::Item_t> items( NUM_VALUES );
+      for ( csize r = 0; r < NUM_ROUNDS; ++r ) {
+        for ( csize i = 0; i < NUM_VALUES; ++i ) {
+          zstring const value( make_value( "k", i ) );
+          store::Item_t const item( intern( dict, value ) );
+          if ( item->getStringValue() != value )
+            ++errors[t];
+          if ( r == 0 )
+            items[i] = item;
+          else if ( item.getp() != items[i].getp() )
+            ++errors[t];
+        }
+      }
+      if ( dict.numStrings() != NUM_VALUES ||
+           dict.numHits() != NUM_VALUES * (NUM_ROUNDS - 1) )
+        ++errors[t];
+    } ) );
+  }
+  for ( csize t = 0; t < NUM_THREADS; ++t )
+    threads[t].join();
+
+  for ( csize t = 0; t < NUM_THREADS; ++t )
+    ASSERT_TRUE( test_no, errors[t] == 0 );
+  ++test_no;
+}
+#endif /* ZORBA_FOR_ONE_THREAD_ONLY */
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace zorba {
+namespace UnitTests {
+
+int test_string_dictionary( int, char*[] ) {
+  int test_no = 0;
+
+  test_intern( test_no );
+  test_lookup_when_full( test_no );
+#ifndef ZORBA_FOR_ONE_THREAD_ONLY
+  test_concurrent( test_no );
+#endif /* ZORBA_FOR_ONE_THREAD_ONLY */
+
+  cout << failures << " test(s) failed\n";
+  return failures ? 1 : 0;
+}
+
+} // namespace UnitTests
+} // namespace zorba
+
+/* vim:set et sw=2 ts=2: */
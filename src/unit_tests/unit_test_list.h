@@ -31,7 +31,11 @@ namespace UnitTests {
   int test_ato_( int, char*[] );
   int test_base64( int, char*[] );
   int test_base64_streambuf( int, char*[] );
+  int test_binary_codecs( int, char*[] );
+  int test_flat_hashmap( int, char*[] );
+  int test_float( int, char*[] );
   int test_fs_util( int, char*[] );
+  int test_function_library( int, char*[] );
   int test_hashmaps( int argc, char* argv[] );
   int test_hexbinary( int argc, char* argv[] );
   int test_hexbinary_streambuf( int argc, char* argv[] );
@@ -44,6 +48,8 @@ namespace UnitTests {
   int test_mem_sizeof( int, char*[] );
   int test_parameters( int, char*[] );
   int test_string( int, char*[] );
+  int test_string_chunk_reader( int, char*[] );
+  int test_string_dictionary( int, char*[] );
   int test_time( int, char*[] );
   int test_time_parse( int, char*[] );
 
@@ -42,7 +42,11 @@ void initializeTestList()
   libunittests["ato"] = test_ato_;
   libunittests["base64"] = test_base64;
   libunittests["base64_streambuf"] = test_base64_streambuf;
+  libunittests["binary_codecs"] = test_binary_codecs;
+  libunittests["flat_hashmap"] = test_flat_hashmap;
+  libunittests["float"] = test_float;
   libunittests["fs_util"] = test_fs_util;
+  libunittests["function_library"] = test_function_library;
   libunittests["hashmaps"] = test_hashmaps;
   libunittests["hexbinary"] = test_hexbinary;
   libunittests["hexbinary_streambuf"] = test_hexbinary_streambuf;
@@ -56,6 +60,8 @@ void initializeTestList()
   libunittests["json_parser"] = test_json_parser;
   libunittests["parameters"] = test_parameters;
   libunittests["string"] = test_string;
+  libunittests["string_chunk_reader"] = test_string_chunk_reader;
+  libunittests["string_dictionary"] = test_string_dictionary;
   libunittests["time"] = test_time;
   libunittests["time_parse"] = test_time_parse;
 
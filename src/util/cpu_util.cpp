@@ -0,0 +1,79 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stdafx.h"
+
+#ifdef _MSC_VER
+# include <intrin.h>
+#endif
+
+// local
+#include "cpu_util.h"
+
+namespace zorba {
+namespace cpu {
+
+///////////////////////////////////////////////////////////////////////////////
+
+static simd_level max_simd_level = simd_avx2;
+
+static simd_level detect_simd_level() {
+#if defined(ZORBA_CPU_X86_SIMD) && defined(__GNUC__)
+  __builtin_cpu_init();
+  //
+  // For AVX2, this also checks that the OS saves the YMM registers.
+  //
+  if ( __builtin_cpu_supports( "avx2" ) )
+    return simd_avx2;
+  if ( __builtin_cpu_supports( "ssse3" ) )
+    return simd_ssse3;
+  if ( __builtin_cpu_supports( "sse2" ) )
+    return simd_sse2;
+#elif defined(ZORBA_CPU_X86_SIMD) && defined(_MSC_VER)
+  int info[4];
+  __cpuid( info, 1 );
+  bool const ssse3 = !!(info[2] & (1 << 9));
+  bool const sse2 = !!(info[3] & (1 << 26));
+  bool const os_avx =
+    (info[2] & (1 << 27)) && (info[2] & (1 << 28)) &&
+    (_xgetbv( 0 ) & 6) == 6;
+  __cpuidex( info, 7, 0 );
+  if ( os_avx && (info[1] & (1 << 5)) )
+    return simd_avx2;
+  if ( ssse3 )
+    return simd_ssse3;
+  if ( sse2 )
+    return simd_sse2;
+#endif /* ZORBA_CPU_X86_SIMD */
+  return simd_none;
+}
+
+simd_level get_simd_level() {
+  static simd_level const detected = detect_simd_level();
+  return detected < max_simd_level ? detected : max_simd_level;
+}
+
+simd_level set_simd_level( simd_level level ) {
+  simd_level const prev = max_simd_level;
+  max_simd_level = level;
+  return prev;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace cpu
+} // namespace zorba
+/* vim:set et sw=2 ts=2: */
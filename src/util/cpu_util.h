@@ -0,0 +1,81 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef ZORBA_CPU_UTIL_H
+#define ZORBA_CPU_UTIL_H
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Defined only if x86 SIMD instructions can be used (subject to
+ * cpu::get_simd_level()).  Functions using instructions beyond SSE2 must be
+ * declared with ZORBA_CPU_TARGET so that they can be compiled without having
+ * to compile everything else for those instructions too.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define ZORBA_CPU_X86_SIMD 1
+# define ZORBA_CPU_TARGET(ISA) __attribute__(( target( ISA ) ))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# define ZORBA_CPU_X86_SIMD 1
+# define ZORBA_CPU_TARGET(ISA) /* nothing */
+#endif
+
+namespace zorba {
+namespace cpu {
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The SIMD instruction sets, in increasing order, that code may have
+ * specialized versions for.
+ */
+enum simd_level {
+  simd_none,
+  simd_sse2,
+  simd_ssse3,
+  simd_avx2
+};
+
+/**
+ * Gets the highest SIMD instruction set supported by the CPU the process is
+ * running on (as detected the first time this function is called) or, if
+ * lower, the level set by set_simd_level().
+ *
+ * @return Returns said level.
+ */
+simd_level get_simd_level();
+
+/**
+ * Limits the SIMD instruction set that get_simd_level() returns.  This is
+ * meant only for testing and benchmarking the non-SIMD versions of code and
+ * must not be called while other threads may be calling get_simd_level().
+ *
+ * @param level The highest level to return.
+ * @return Returns the previous limit.
+ */
+simd_level set_simd_level( simd_level level );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace cpu
+} // namespace zorba
+#endif /* ZORBA_CPU_UTIL_H */
+/*
+ * Local variables:
+ * mode: c++
+ * End:
+ */
+/* vim:set et sw=2 ts=2: */
@@ -14,8 +14,13 @@
  * limitations under the License.
  */
 
+// standard
+#include <algorithm>
+#include <cstring>
+
 // Zorba
 #include "util/string_util.h"
+#include "zorbamisc/config/stdint.h"
 
 // local
 #include "csv_parser.h"
@@ -37,6 +42,9 @@ inline bool peek( istream &is, char &c ) {
 ///////////////////////////////////////////////////////////////////////////////
 
 bool csv_parser::next_value( zstring *value, bool *eol, bool *quoted ) const {
+  if ( buf_ )
+    return next_buf_value( value, eol, quoted );
+
   ztd::string_appender<zstring,128> appender( value );
   char c;
   bool in_quote = false;
@@ -97,6 +105,141 @@ return_true:
   return true;
 }
 
+/**
+ * Same as next_value() but for an in-memory buffer: runs of ordinary
+ * characters are appended to \a value at once rather than one at a time.
+ */
+bool csv_parser::next_buf_value( zstring *value, bool *eol,
+                                 bool *quoted ) const {
+  char const *p = buf_;
+  bool in_quote = false;
+  bool is_quoted = false;
+
+  value->clear();
+
+  while ( p < buf_end_ ) {
+    char const *const run = p;
+    if ( in_quote ) {
+      while ( p < buf_end_ && *p != quote_ && *p != quote_esc_ )
+        ++p;
+      value->append( run, p - run );
+      if ( p == buf_end_ )
+        break;
+      char const c = *p++;
+      if ( quote_esc_ == quote_ ) {     // ""
+        if ( p == buf_end_ )
+          break;
+        if ( *p != quote_ ) {
+          in_quote = false;
+          continue;
+        }
+        ++p;
+        *value += quote_;
+      } else {                          // \"
+        if ( c == quote_ ) {
+          in_quote = false;
+          continue;
+        }
+        if ( p == buf_end_ )
+          break;
+        *value += *p++;
+      }
+    } else {
+      while ( p < buf_end_ && *p != quote_ && *p != sep_ &&
+              *p != '\n' && *p != '\r' )
+        ++p;
+      value->append( run, p - run );
+      if ( p == buf_end_ )
+        break;
+      char const c = *p++;
+      if ( c == quote_ ) {
+        in_quote = is_quoted = true;
+        continue;
+      }
+      if ( c == sep_ )
+        *eol = false;
+      else {
+        if ( c == '\r' && p < buf_end_ && *p == '\n' )
+          ++p;
+        *eol = true;
+      }
+      buf_ = p;
+      if ( quoted )
+        *quoted = is_quoted;
+      return true;
+    }
+  } // while
+
+  buf_ = p;
+  if ( value->empty() )
+    return false;
+
+  *eol = true;
+  if ( quoted )
+    *quoted = is_quoted;
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static uint64_t const ones = ~static_cast<uint64_t>( 0 ) / 0xFF;
+
+/**
+ * Gets a word having every byte equal to \a c.
+ */
+inline uint64_t splat( char c ) {
+  return ones * static_cast<unsigned char>( c );
+}
+
+/**
+ * Checks whether any byte of \a w is equal to the byte splat in \a pattern.
+ */
+inline bool has_byte( uint64_t w, uint64_t pattern ) {
+  uint64_t const x = w ^ pattern;
+  return !!( (x - ones) & ~x & (ones << 7) );
+}
+
+void csv_scan( char const *begin, char const *end, char const *buf_end,
+               char quote, csv_scan_info *info ) {
+  uint64_t const quote_word = splat( quote );
+  uint64_t const nl_word = splat( '\n' );
+  uint64_t const cr_word = splat( '\r' );
+  unsigned in_quote = 0;
+
+  info->quotes = 0;
+  info->records[0] = info->records[1] = 0;
+  info->last_eol[0] = info->last_eol[1] = nullptr;
+
+  for ( char const *p = begin; p < end; ) {
+    if ( end - p >= static_cast<ptrdiff_t>( sizeof( uint64_t ) ) ) {
+      uint64_t w;
+      ::memcpy( &w, p, sizeof( w ) );
+      if ( !has_byte( w, quote_word ) && !has_byte( w, nl_word ) &&
+           !has_byte( w, cr_word ) ) {
+        p += sizeof( w );
+        continue;
+      }
+    }
+    char const *const word_end =
+      p + std::min( end - p, static_cast<ptrdiff_t>( sizeof( uint64_t ) ) );
+    for ( ; p < word_end; ++p ) {
+      if ( *p == quote ) {
+        ++info->quotes;
+        in_quote ^= 1;
+      } else if ( *p == '\n' ||
+                  ( *p == '\r' && ( p + 1 == buf_end || p[1] != '\n' ) ) ) {
+        //
+        // If the range starts outside of a quoted value, the terminator counts
+        // only when in_quote is 0; if it starts inside of one, only when
+        // in_quote is 1.
+        //
+        ++info->records[ in_quote ];
+        info->last_eol[ in_quote ] = p + 1;
+      }
+    } // for
+  } // for
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 } // namespace zorba
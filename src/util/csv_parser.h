@@ -17,6 +17,8 @@
 #ifndef ZORBA_CSV_H
 #define ZORBA_CSV_H
 
+#include <cstddef>
+
 #include <zorba/internal/cxx_util.h>
 
 #include "zorbatypes/zstring.h"
@@ -41,6 +43,7 @@ public:
    */
   csv_parser( char sep = ',', char quote = '"' ) {
     is_ = nullptr;
+    buf_ = buf_end_ = nullptr;
     sep_ = sep;
     quote_ = quote_esc_ = quote;
   }
@@ -55,6 +58,7 @@ public:
    */
   csv_parser( char sep, char quote, char quote_esc ) {
     is_ = nullptr;
+    buf_ = buf_end_ = nullptr;
     sep_ = sep;
     quote_ = quote;
     quote_esc_ = quote_esc;
@@ -70,6 +74,7 @@ public:
    */
   csv_parser( std::istream &is, char sep = ',', char quote = '"' ) {
     is_ = &is;
+    buf_ = buf_end_ = nullptr;
     sep_ = sep;
     quote_ = quote_esc_ = quote;
   }
@@ -85,6 +90,7 @@ public:
    */
   csv_parser( std::istream &is, char sep, char quote, char quote_esc ) {
     is_ = &is;
+    buf_ = buf_end_ = nullptr;
     sep_ = sep;
     quote_ = quote;
     quote_esc_ = quote_esc;
@@ -102,6 +108,55 @@ public:
    */
   bool next_value( zstring *value, bool *eol, bool *quoted = nullptr ) const;
 
+  /**
+   * Gets the quote character.
+   *
+   * @return Returns said character.
+   */
+  char get_quote() const {
+    return quote_;
+  }
+
+  /**
+   * Gets the quote-escape character.
+   *
+   * @return Returns said character.
+   */
+  char get_quote_esc() const {
+    return quote_esc_;
+  }
+
+  /**
+   * Gets the value-separator character.
+   *
+   * @return Returns said character.
+   */
+  char get_separator() const {
+    return sep_;
+  }
+
+  /**
+   * Gets the current position within the buffer being read from.
+   *
+   * @return Returns said position or \c null if not reading from a buffer.
+   */
+  char const* get_buffer_pos() const {
+    return buf_;
+  }
+
+  /**
+   * Sets the in-memory buffer to read from.  Values are then parsed directly
+   * from the buffer rather than one character at a time from an istream.
+   *
+   * @param begin A pointer to the first character of the buffer.
+   * @param end A pointer to one past the last character of the buffer.
+   */
+  void set_buffer( char const *begin, char const *end ) {
+    is_ = nullptr;
+    buf_ = begin;
+    buf_end_ = end;
+  }
+
   /**
    * Sets the quote character to use.
    *
@@ -137,15 +192,72 @@ public:
    */
   void set_stream( std::istream &is ) {
     is_ = &is;
+    buf_ = buf_end_ = nullptr;
   }
 
 private:
   std::istream *is_;
+  mutable char const *buf_;
+  char const *buf_end_;
   char quote_;
   char quote_esc_;
   char sep_;
+
+  bool next_buf_value( zstring*, bool*, bool* ) const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Information about a range of a CSV buffer as gathered by csv_scan().
+ *
+ * Whether a newline terminates a record depends on whether it is inside a
+ * quoted value, i.e., on the number of quote characters that precede it in the
+ * buffer.  Since that number is not known when ranges are scanned
+ * independently, the information is gathered for both cases: index 0 is for
+ * when the range starts outside of a quoted value and index 1 for when it
+ * starts inside of one.
+ */
+struct csv_scan_info {
+  /**
+   * The number of quote characters in the range.
+   */
+  size_t quotes;
+
+  /**
+   * The number of record terminators in the range.
+   */
+  size_t records[2];
+
+  /**
+   * A pointer to one past the last record terminator in the range or \c null
+   * if there is none.
+   */
+  char const *last_eol[2];
 };
 
+/**
+ * Scans a range of a CSV buffer for quote characters and record terminators.
+ * A record terminator is either a newline or a carriage-return that is not
+ * followed by a newline.  The scan skips over runs of characters that are
+ * neither by examining a machine word at a time.
+ *
+ * This is valid only when the quote-escape character is the same as the quote
+ * character (i.e., a quote is escaped by doubling it) since only then does the
+ * parity of the number of preceding quote characters determine whether a
+ * character is inside a quoted value.
+ *
+ * @param begin A pointer to the first character of the range.
+ * @param end A pointer to one past the last character of the range.
+ * @param buf_end A pointer to one past the last character of the whole buffer
+ * (used to look past the end of the range for a newline following a
+ * carriage-return).
+ * @param quote The quote character.
+ * @param info A pointer to the info to receive the result.
+ */
+void csv_scan( char const *begin, char const *end, char const *buf_end,
+               char quote, csv_scan_info *info );
+
 ///////////////////////////////////////////////////////////////////////////////
 
 } // namespace std
@@ -0,0 +1,515 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stdafx.h"
+
+// standard
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+// Zorba
+#include <zorba/internal/cxx_util.h>
+
+// local
+#include "ascii_util.h"
+#include "float_util.h"
+
+using namespace std;
+
+namespace zorba {
+namespace fp {
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A "do-it-yourself floating-point" number: f * 2^e.
+ */
+struct diy_fp {
+  uint64_t f;
+  int e;
+
+  diy_fp() { }
+  diy_fp( uint64_t f, int e ) : f( f ), e( e ) { }
+};
+
+/**
+ * Gets the upper 64 bits (rounded) of the 128-bit product of two numbers.
+ */
+static diy_fp operator*( diy_fp const &x, diy_fp const &y ) {
+  uint64_t const M32 = 0xFFFFFFFFu;
+  uint64_t const a = x.f >> 32, b = x.f & M32;
+  uint64_t const c = y.f >> 32, d = y.f & M32;
+  uint64_t const ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+  uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+  tmp += 1u << 31;                      // round
+  return diy_fp( ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64 );
+}
+
+/**
+ * Shifts the given number's significand left so that its highest bit is set.
+ */
+static diy_fp normalize( diy_fp x ) {
+  while ( !(x.f & (static_cast<uint64_t>( 1 ) << 63)) ) {
+    x.f <<= 1;
+    --x.e;
+  }
+  return x;
+}
+
+/**
+ * Cached powers of 10 from 1e-348 to 1e340 in steps of 1e8, each normalized
+ * to a 64-bit significand and rounded to nearest.
+ */
+static struct {
+  uint64_t f;
+  short e;
+} const cached_powers[] = {
+  { 0xfa8fd5a0081c0288ULL, -1220 }, // 1e-348
+  { 0xbaaee17fa23ebf76ULL, -1193 }, // 1e-340
+  { 0x8b16fb203055ac76ULL, -1166 }, // 1e-332
+  { 0xcf42894a5dce35eaULL, -1140 }, // 1e-324
+  { 0x9a6bb0aa55653b2dULL, -1113 }, // 1e-316
+  { 0xe61acf033d1a45dfULL, -1087 }, // 1e-308
+  { 0xab70fe17c79ac6caULL, -1060 }, // 1e-300
+  { 0xff77b1fcbebcdc4fULL, -1034 }, // 1e-292
+  { 0xbe5691ef416bd60cULL, -1007 }, // 1e-284
+  { 0x8dd01fad907ffc3cULL,  -980 }, // 1e-276
+  { 0xd3515c2831559a83ULL,  -954 }, // 1e-268
+  { 0x9d71ac8fada6c9b5ULL,  -927 }, // 1e-260
+  { 0xea9c227723ee8bcbULL,  -901 }, // 1e-252
+  { 0xaecc49914078536dULL,  -874 }, // 1e-244
+  { 0x823c12795db6ce57ULL,  -847 }, // 1e-236
+  { 0xc21094364dfb5637ULL,  -821 }, // 1e-228
+  { 0x9096ea6f3848984fULL,  -794 }, // 1e-220
+  { 0xd77485cb25823ac7ULL,  -768 }, // 1e-212
+  { 0xa086cfcd97bf97f4ULL,  -741 }, // 1e-204
+  { 0xef340a98172aace5ULL,  -715 }, // 1e-196
+  { 0xb23867fb2a35b28eULL,  -688 }, // 1e-188
+  { 0x84c8d4dfd2c63f3bULL,  -661 }, // 1e-180
+  { 0xc5dd44271ad3cdbaULL,  -635 }, // 1e-172
+  { 0x936b9fcebb25c996ULL,  -608 }, // 1e-164
+  { 0xdbac6c247d62a584ULL,  -582 }, // 1e-156
+  { 0xa3ab66580d5fdaf6ULL,  -555 }, // 1e-148
+  { 0xf3e2f893dec3f126ULL,  -529 }, // 1e-140
+  { 0xb5b5ada8aaff80b8ULL,  -502 }, // 1e-132
+  { 0x87625f056c7c4a8bULL,  -475 }, // 1e-124
+  { 0xc9bcff6034c13053ULL,  -449 }, // 1e-116
+  { 0x964e858c91ba2655ULL,  -422 }, // 1e-108
+  { 0xdff9772470297ebdULL,  -396 }, // 1e-100
+  { 0xa6dfbd9fb8e5b88fULL,  -369 }, // 1e-92
+  { 0xf8a95fcf88747d94ULL,  -343 }, // 1e-84
+  { 0xb94470938fa89bcfULL,  -316 }, // 1e-76
+  { 0x8a08f0f8bf0f156bULL,  -289 }, // 1e-68
+  { 0xcdb02555653131b6ULL,  -263 }, // 1e-60
+  { 0x993fe2c6d07b7facULL,  -236 }, // 1e-52
+  { 0xe45c10c42a2b3b06ULL,  -210 }, // 1e-44
+  { 0xaa242499697392d3ULL,  -183 }, // 1e-36
+  { 0xfd87b5f28300ca0eULL,  -157 }, // 1e-28
+  { 0xbce5086492111aebULL,  -130 }, // 1e-20
+  { 0x8cbccc096f5088ccULL,  -103 }, // 1e-12
+  { 0xd1b71758e219652cULL,   -77 }, // 1e-4
+  { 0x9c40000000000000ULL,   -50 }, // 1e4
+  { 0xe8d4a51000000000ULL,   -24 }, // 1e12
+  { 0xad78ebc5ac620000ULL,     3 }, // 1e20
+  { 0x813f3978f8940984ULL,    30 }, // 1e28
+  { 0xc097ce7bc90715b3ULL,    56 }, // 1e36
+  { 0x8f7e32ce7bea5c70ULL,    83 }, // 1e44
+  { 0xd5d238a4abe98068ULL,   109 }, // 1e52
+  { 0x9f4f2726179a2245ULL,   136 }, // 1e60
+  { 0xed63a231d4c4fb27ULL,   162 }, // 1e68
+  { 0xb0de65388cc8ada8ULL,   189 }, // 1e76
+  { 0x83c7088e1aab65dbULL,   216 }, // 1e84
+  { 0xc45d1df942711d9aULL,   242 }, // 1e92
+  { 0x924d692ca61be758ULL,   269 }, // 1e100
+  { 0xda01ee641a708deaULL,   295 }, // 1e108
+  { 0xa26da3999aef774aULL,   322 }, // 1e116
+  { 0xf209787bb47d6b85ULL,   348 }, // 1e124
+  { 0xb454e4a179dd1877ULL,   375 }, // 1e132
+  { 0x865b86925b9bc5c2ULL,   402 }, // 1e140
+  { 0xc83553c5c8965d3dULL,   428 }, // 1e148
+  { 0x952ab45cfa97a0b3ULL,   455 }, // 1e156
+  { 0xde469fbd99a05fe3ULL,   481 }, // 1e164
+  { 0xa59bc234db398c25ULL,   508 }, // 1e172
+  { 0xf6c69a72a3989f5cULL,   534 }, // 1e180
+  { 0xb7dcbf5354e9beceULL,   561 }, // 1e188
+  { 0x88fcf317f22241e2ULL,   588 }, // 1e196
+  { 0xcc20ce9bd35c78a5ULL,   614 }, // 1e204
+  { 0x98165af37b2153dfULL,   641 }, // 1e212
+  { 0xe2a0b5dc971f303aULL,   667 }, // 1e220
+  { 0xa8d9d1535ce3b396ULL,   694 }, // 1e228
+  { 0xfb9b7cd9a4a7443cULL,   720 }, // 1e236
+  { 0xbb764c4ca7a44410ULL,   747 }, // 1e244
+  { 0x8bab8eefb6409c1aULL,   774 }, // 1e252
+  { 0xd01fef10a657842cULL,   800 }, // 1e260
+  { 0x9b10a4e5e9913129ULL,   827 }, // 1e268
+  { 0xe7109bfba19c0c9dULL,   853 }, // 1e276
+  { 0xac2820d9623bf429ULL,   880 }, // 1e284
+  { 0x80444b5e7aa7cf85ULL,   907 }, // 1e292
+  { 0xbf21e44003acdd2dULL,   933 }, // 1e300
+  { 0x8e679c2f5e44ff8fULL,   960 }, // 1e308
+  { 0xd433179d9c8cb841ULL,   986 }, // 1e316
+  { 0x9e19db92b4e31ba9ULL,  1013 }, // 1e324
+  { 0xeb96bf6ebadf77d9ULL,  1039 }, // 1e332
+  { 0xaf87023b9bf0ee6bULL,  1066 }  // 1e340
+};
+
+/**
+ * Gets the cached power of 10 c = 10^-k such that the binary exponent of the
+ * product of a normalized number whose binary exponent is \a e and c is in
+ * [-60,-32], so that its integral part fits into 32 bits.
+ *
+ * @param e The binary exponent.
+ * @param k A pointer to receive the (negated) decimal exponent.
+ * @return Returns said cached power.
+ */
+static diy_fp get_cached_power( int e, int *k ) {
+  double const dk = (-61 - e) * 0.30102999566398114 + 347;
+  int ik = static_cast<int>( dk );
+  if ( dk - ik > 0.0 )
+    ++ik;
+  unsigned const index = static_cast<unsigned>( (ik >> 3) + 1 );
+  *k = -(-348 + static_cast<int>( index << 3 ));
+  return diy_fp( cached_powers[ index ].f, cached_powers[ index ].e );
+}
+
+static uint64_t const pow10_u64[] = {
+  1ULL,
+  10ULL,
+  100ULL,
+  1000ULL,
+  10000ULL,
+  100000ULL,
+  1000000ULL,
+  10000000ULL,
+  100000000ULL,
+  1000000000ULL,
+  10000000000ULL,
+  100000000000ULL,
+  1000000000000ULL,
+  10000000000000ULL,
+  100000000000000ULL,
+  1000000000000000ULL,
+  10000000000000000ULL,
+  100000000000000000ULL,
+  1000000000000000000ULL,
+  10000000000000000000ULL
+};
+
+static int count_decimal_digits( uint32_t n ) {
+  int digits = 1;
+  while ( digits < 10 && n >= pow10_u64[ digits ] )
+    ++digits;
+  return digits;
+}
+
+/**
+ * Moves the last generated digit down while that brings the number closer to
+ * the value and keeps it within the rounding interval.
+ */
+static void grisu_round( char *buf, int len, uint64_t delta, uint64_t rest,
+                         uint64_t ten_kappa, uint64_t wp_w ) {
+  while ( rest < wp_w && delta - rest >= ten_kappa &&
+          (rest + ten_kappa < wp_w ||
+           wp_w - rest > rest + ten_kappa - wp_w) ) {
+    --buf[ len - 1 ];
+    rest += ten_kappa;
+  }
+}
+
+/**
+ * Generates the shortest digits of W that are within [Mp - delta, Mp].
+ */
+static int digit_gen( diy_fp const &W, diy_fp const &Mp, uint64_t delta,
+                      char *buf, int *k ) {
+  diy_fp const one( static_cast<uint64_t>( 1 ) << -Mp.e, Mp.e );
+  uint64_t const wp_w = Mp.f - W.f;
+  uint32_t p1 = static_cast<uint32_t>( Mp.f >> -one.e );
+  uint64_t p2 = Mp.f & (one.f - 1);
+  int kappa = count_decimal_digits( p1 );
+  int len = 0;
+
+  while ( kappa > 0 ) {
+    uint32_t const pow10 = static_cast<uint32_t>( pow10_u64[ kappa - 1 ] );
+    uint32_t const d = p1 / pow10;
+    p1 %= pow10;
+    if ( d || len )
+      buf[ len++ ] = static_cast<char>( '0' + d );
+    --kappa;
+    uint64_t const rest = (static_cast<uint64_t>( p1 ) << -one.e) + p2;
+    if ( rest <= delta ) {
+      *k += kappa;
+      grisu_round(
+        buf, len, delta, rest, pow10_u64[ kappa ] << -one.e, wp_w
+      );
+      return len;
+    }
+  }
+
+  for ( ;; ) {
+    p2 *= 10;
+    delta *= 10;
+    char const d = static_cast<char>( p2 >> -one.e );
+    if ( d || len )
+      buf[ len++ ] = static_cast<char>( '0' + d );
+    p2 &= one.f - 1;
+    --kappa;
+    if ( p2 < delta ) {
+      *k += kappa;
+      int const index = -kappa;
+      grisu_round(
+        buf, len, delta, p2, one.f, index < 20 ? wp_w * pow10_u64[ index ] : 0
+      );
+      return len;
+    }
+  }
+}
+
+/**
+ * Runs Grisu2 given the (non-normalized) value v and whether its lower
+ * neighbor is closer to it than its upper neighbor.
+ */
+static int grisu2( diy_fp const &v, bool lower_closer, char *buf,
+                   int *exponent ) {
+  //
+  // The boundaries m- and p (m+) are half-way between v and its neighbors.
+  //
+  diy_fp const p( normalize( diy_fp( (v.f << 1) + 1, v.e - 1 ) ) );
+  diy_fp m( lower_closer ?
+    diy_fp( (v.f << 2) - 1, v.e - 2 ) :
+    diy_fp( (v.f << 1) - 1, v.e - 1 )
+  );
+  m.f <<= m.e - p.e;
+  m.e = p.e;
+
+  int mk;
+  diy_fp const c_mk( get_cached_power( p.e, &mk ) );
+  diy_fp const W( normalize( v ) * c_mk );
+  diy_fp Wp( p * c_mk );
+  diy_fp Wm( m * c_mk );
+  //
+  // Narrow the interval by 1 ulp on each side to account for the imprecision
+  // of the multiplications so that the digits always round-trip.
+  //
+  ++Wm.f;
+  --Wp.f;
+
+  *exponent = mk;
+  int len = digit_gen( W, Wp, Wp.f - Wm.f, buf, exponent );
+  while ( len > 1 && buf[ len - 1 ] == '0' ) {
+    --len;
+    ++*exponent;
+  }
+  return len;
+}
+
+static double str_to_value( char const *s, double* ) {
+  return ::strtod( s, nullptr );
+}
+
+static float str_to_value( char const *s, float* ) {
+  return ::strtof( s, nullptr );
+}
+
+/**
+ * Checks whether significand * 10^exponent converts back to value.
+ */
+template<typename F>
+static bool round_trips( uint64_t significand, int exponent, F value ) {
+  F result;
+  if ( !fast_ston( significand, exponent, &result ) ) {
+    char buf[ sizeof( ascii::itoa_buf_type ) * 2 ];
+    char *const e = ascii::itoa( significand, buf ) + ::strlen( buf );
+    *e = 'e';
+    ascii::itoa( exponent, e + 1 );
+    result = str_to_value( buf, static_cast<F*>( nullptr ) );
+  }
+  return result == value;
+}
+
+/**
+ * Grisu2 sometimes generates one digit too many (or, when rounding up carries
+ * through all the digits, even more).  This removes the last digit by rounding
+ * down or up for as long as the result still converts back to value.  If a
+ * shorter string of digits converts back to value, then so does one of the two
+ * roundings of the current digits, so the result is the shortest possible.
+ */
+template<typename F>
+static int shorten( F value, char *buf, int len, int *exponent ) {
+  uint64_t significand = 0;
+  for ( int i = 0; i < len; ++i )
+    significand = significand * 10 + (buf[i] - '0');
+
+  int e = *exponent;
+  while ( significand >= 10 ) {
+    //
+    // Try the nearer of the two candidates first.
+    //
+    uint64_t const down = significand / 10;
+    uint64_t const nearer = down + (significand % 10 >= 5);
+    uint64_t const farther = down + (significand % 10 < 5);
+    if ( round_trips( nearer, e + 1, value ) )
+      significand = nearer;
+    else if ( round_trips( farther, e + 1, value ) )
+      significand = farther;
+    else
+      break;
+    ++e;
+    while ( significand % 10 == 0 ) {
+      significand /= 10;
+      ++e;
+    }
+  }
+
+  if ( e != *exponent ) {
+    *exponent = e;
+    len = 0;
+    for ( uint64_t n = significand; n; n /= 10 )
+      ++len;
+    for ( int i = len - 1; i >= 0; --i, significand /= 10 )
+      buf[i] = static_cast<char>( '0' + significand % 10 );
+  }
+  return len;
+}
+
+int shortest_digits( double value, char *buf, int *exponent ) {
+  int const significand_bits = numeric_limits<double>::digits - 1;
+  uint64_t const hidden_bit = static_cast<uint64_t>( 1 ) << significand_bits;
+  int const exponent_bias = 0x3FF + significand_bits;
+
+  uint64_t bits;
+  ::memcpy( &bits, &value, sizeof( bits ) );
+  uint64_t const significand = bits & (hidden_bit - 1);
+  int const biased_e = static_cast<int>( (bits >> significand_bits) & 0x7FF );
+
+  diy_fp const v( biased_e ?
+    diy_fp( significand + hidden_bit, biased_e - exponent_bias ) :
+    diy_fp( significand, 1 - exponent_bias )
+  );
+  int const len = grisu2( v, biased_e > 1 && !significand, buf, exponent );
+  return shorten( value, buf, len, exponent );
+}
+
+int shortest_digits( float value, char *buf, int *exponent ) {
+  int const significand_bits = numeric_limits<float>::digits - 1;
+  uint32_t const hidden_bit = static_cast<uint32_t>( 1 ) << significand_bits;
+  int const exponent_bias = 0x7F + significand_bits;
+
+  uint32_t bits;
+  ::memcpy( &bits, &value, sizeof( bits ) );
+  uint32_t const significand = bits & (hidden_bit - 1);
+  int const biased_e = static_cast<int>( (bits >> significand_bits) & 0xFF );
+
+  diy_fp const v( biased_e ?
+    diy_fp( significand + hidden_bit, biased_e - exponent_bias ) :
+    diy_fp( significand, 1 - exponent_bias )
+  );
+  int const len = grisu2( v, biased_e > 1 && !significand, buf, exponent );
+  return shorten( value, buf, len, exponent );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static double const pow10_double[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static float const pow10_float[] = {
+  1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+bool fast_ston( uint64_t significand, int exponent, double *result ) {
+#if FLT_EVAL_METHOD == 0 || FLT_EVAL_METHOD == 1
+  //
+  // 10^22 is the largest power of 10 that's exactly representable as a
+  // double.
+  //
+  int const max_exponent = 22;
+  uint64_t const max_significand =
+    static_cast<uint64_t>( 1 ) << numeric_limits<double>::digits;
+
+  if ( significand > max_significand )
+    return false;
+  if ( !significand ) {
+    *result = 0;
+    return true;
+  }
+  if ( exponent > max_exponent ) {
+    //
+    // Handle, e.g., 1e30 as 1e8 * 1e22 if the significand stays exact.
+    //
+    int const shift = exponent - max_exponent;
+    if ( shift >= 16 ||
+         significand > max_significand / pow10_u64[ shift ] )
+      return false;
+    significand *= pow10_u64[ shift ];
+    exponent = max_exponent;
+  }
+  if ( exponent < -max_exponent )
+    return false;
+
+  double const d = static_cast<double>( significand );
+  *result = exponent < 0 ?
+    d / pow10_double[ -exponent ] : d * pow10_double[ exponent ];
+  return true;
+#else
+  //
+  // With extended-precision intermediates (e.g., the x87 FPU), the result
+  // would be rounded twice.
+  //
+  return false;
+#endif
+}
+
+bool fast_ston( uint64_t significand, int exponent, float *result ) {
+  int const max_exponent = 10;
+  uint64_t const max_significand =
+    static_cast<uint64_t>( 1 ) << numeric_limits<float>::digits;
+
+  if ( significand > max_significand )
+    return false;
+  if ( !significand ) {
+    *result = 0;
+    return true;
+  }
+  if ( exponent > max_exponent ) {
+    int const shift = exponent - max_exponent;
+    if ( shift >= 8 ||
+         significand > max_significand / pow10_u64[ shift ] )
+      return false;
+    significand *= pow10_u64[ shift ];
+    exponent = max_exponent;
+  }
+  if ( exponent < -max_exponent )
+    return false;
+
+  //
+  // Even if computed in double precision, the result is rounded correctly
+  // since 53 >= 2 * 24 + 2 (Figueroa, "When is Double Rounding Innocuous?").
+  //
+  float const f = static_cast<float>( significand );
+  *result = exponent < 0 ?
+    f / pow10_float[ -exponent ] : f * pow10_float[ exponent ];
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace fp
+} // namespace zorba
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef ZORBA_FLOAT_UTIL_H
+#define ZORBA_FLOAT_UTIL_H
+
+// Zorba
+#include "zorbamisc/config/stdint.h"
+
+namespace zorba {
+namespace fp {
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The size of a buffer that is big enough to hold the digits generated by
+ * shortest_digits().
+ */
+int const digits_buf_size = 24;
+
+/**
+ * Gets the shortest sequence of decimal digits that, when converted back to
+ * a \c double (with round-to-nearest), yields exactly \a value.  This is done
+ * by the Grisu2 algorithm (Florian Loitsch, "Printing Floating-Point Numbers
+ * Quickly and Accurately with Integers," PLDI 2010) that uses only 64-bit
+ * integer arithmetic.  Since Grisu2 sometimes generates more digits than
+ * needed, its output is then shortened for as long as it still round-trips,
+ * so the digits are always the shortest possible.
+ *
+ * @param value The value.  It must be finite and greater than 0.
+ * @param digits A pointer to a buffer of at least \c digits_buf_size bytes to
+ * receive the digits.  They are \e not null-terminated.  The first and last
+ * digits are never \c '0'.
+ * @param exponent A pointer to receive the power of 10 such that \a value is
+ * (approximately) the integer made up by \a digits times 10 to the power of
+ * \a *exponent.
+ * @return Returns the number of digits.
+ */
+int shortest_digits( double value, char *digits, int *exponent );
+
+/**
+ * Same as shortest_digits(double,char*,int*) except that the digits are the
+ * shortest that yield exactly \a value when converted back to a \c float.
+ *
+ * @param value The value.  It must be finite and greater than 0.
+ * @param digits A pointer to a buffer of at least \c digits_buf_size bytes to
+ * receive the digits.
+ * @param exponent A pointer to receive the power of 10.
+ * @return Returns the number of digits.
+ */
+int shortest_digits( float value, char *digits, int *exponent );
+
+/**
+ * Converts a decimal number to the \c double nearest to it without strtod(3)
+ * when that can be done exactly with a single floating-point operation
+ * (William D. Clinger, "How to Read Floating Point Numbers Accurately," PLDI
+ * 1990), i.e., when both \a significand and the power of 10 are exactly
+ * representable.
+ *
+ * @param significand The decimal significand.
+ * @param exponent The power of 10 to multiply \a significand by.
+ * @param result A pointer to receive the result.
+ * @return Returns \c true only if the conversion was done; if \c false, the
+ * number has to be converted by other means.
+ */
+bool fast_ston( uint64_t significand, int exponent, double *result );
+
+/**
+ * Same as fast_ston(uint64_t,int,double*) but for \c float.
+ *
+ * @param significand The decimal significand.
+ * @param exponent The power of 10 to multiply \a significand by.
+ * @param result A pointer to receive the result.
+ * @return Returns \c true only if the conversion was done.
+ */
+bool fast_ston( uint64_t significand, int exponent, float *result );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace fp
+} // namespace zorba
+
+#endif /* ZORBA_FLOAT_UTIL_H */
+/*
+ * Local variables:
+ * mode: c++
+ * End:
+ */
+/* vim:set et sw=2 ts=2: */
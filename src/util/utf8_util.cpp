@@ -26,6 +26,7 @@
 
 // Zorba
 #include <zorba/internal/cxx_util.h>
+#include "zorbamisc/config/stdint.h"
 
 // local
 #include "ascii_util.h"
@@ -208,9 +209,52 @@ size_type length( storage_type const *s ) {
   return total_len;
 }
 
+/**
+ * A word having the high bit of every byte set.
+ */
+static uint64_t const high_bits = ~static_cast<uint64_t>( 0 ) / 0xFF * 0x80;
+
+/**
+ * Gets the (possibly unaligned) word starting at the given byte.
+ *
+ * @param p A pointer to the first byte of the word.
+ * @return Returns said word.
+ */
+inline uint64_t load_word( storage_type const *p ) {
+  uint64_t w;
+  ::memcpy( &w, p, sizeof( w ) );
+  return w;
+}
+
+/**
+ * Checks whether every byte of the given word is a non-NULL ASCII character.
+ *
+ * @param w The word to check.
+ * @return Returns \c true only if every byte of \a w is in [0x01,0x7F].
+ */
+inline bool is_ascii_word( uint64_t w ) {
+  //
+  // Subtracting 1 from each byte sets its high bit only if the byte is 0 (or
+  // if it's set already).
+  //
+  return !((w | (w - high_bits / 0x80)) & high_bits);
+}
+
 size_type length( storage_type const *begin, storage_type const *end ) {
   size_type total_len = 0;
-  while ( begin < end && *begin ) {
+  while ( begin < end ) {
+    //
+    // Count ASCII characters a word at a time: only for non-ASCII bytes (or
+    // NULL) does the character length need to be looked up.
+    //
+    if ( end - begin >= static_cast<ptrdiff_t>( sizeof( uint64_t ) ) &&
+         is_ascii_word( load_word( begin ) ) ) {
+      begin += sizeof( uint64_t );
+      total_len += sizeof( uint64_t );
+      continue;
+    }
+    if ( !*begin )
+      break;
     begin += char_length( *begin );
     ++total_len;
   }
@@ -318,6 +362,15 @@ storage_type const* validate( storage_type const *s ) {
 storage_type const* validate( storage_type const *s, size_type s_len ) {
   try {
     for ( ; s_len; ++s, --s_len ) {
+      while ( s_len >= sizeof( uint64_t ) && !(load_word( s ) & high_bits) ) {
+        //
+        // A word of ASCII characters is always valid.
+        //
+        s += sizeof( uint64_t );
+        s_len -= sizeof( uint64_t );
+      }
+      if ( !s_len )
+        break;
       for ( size_type c_len = char_length( *s ); --c_len; )
         if ( !--s_len || !is_continuation_byte( *++s ) )
           return s;
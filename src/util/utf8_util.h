@@ -974,6 +974,51 @@ hash(const StringType& s, const XQPCollator* collation = NULL)
 #endif /* ZORBA_NO_ICU */
 }
 
+/**
+ * Gets the collation (sort) key of a string: comparing the keys of two strings
+ * byte-by-byte gives the same result as comparing the strings themselves with
+ * compare(), so a string that is going to be compared many times (e.g., while
+ * sorting) need be converted only once.
+ *
+ * @param s The string.
+ * @param collation The collation.  It must be neither \c null nor do memcmp.
+ * @param key The string to receive the key.  It is never empty.
+ * @return Returns the same value as hash(s,collation).
+ */
+template<class StringType,class KeyStringType> inline
+typename std::enable_if<ZORBA_IS_STRING(StringType)
+                     && ZORBA_IS_STRING(KeyStringType),
+                        uint32_t>::type
+sort_key(const StringType& s, const XQPCollator* collation, KeyStringType* key)
+{
+#ifndef ZORBA_NO_ICU
+  assert(collation && !collation->doMemCmp());
+
+  CollationKey collKey;
+  UErrorCode status = U_ZERO_ERROR;
+
+  unicode::string uni_s;
+  unicode::to_string(s, &uni_s);
+
+  static_cast<Collator*>(collation->getCollator())->
+  getCollationKey(uni_s, collKey, status);
+
+  if(U_FAILURE(status))
+  {
+    assert(false);
+  }
+
+  // ICU keys are terminated by a 0 byte that is included in the count.
+  int32_t count;
+  const uint8_t* bytes = collKey.getByteArray(count);
+  key->assign(reinterpret_cast<const char*>(bytes), count);
+
+  return collKey.hashCode();
+#else
+  ZORBA_ASSERT(false);
+#endif /* ZORBA_NO_ICU */
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 } // namespace utf8
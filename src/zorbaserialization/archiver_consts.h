@@ -107,6 +107,8 @@ enum TypeCode
   TYPE_OrderByClause,
   TYPE_MaterializeClause,
   TYPE_GroupByClause,
+  TYPE_ParallelForIterator,
+  TYPE_BatchCallIterator,
 
   TYPE_ChildAxisIterator,
   TYPE_DescendantSelfAxisIterator,
@@ -292,10 +294,14 @@ enum TypeCode
   TYPE_DeleteIndexIterator,
   TYPE_CreateIndexIterator,
   TYPE_CreateInternalIndexIterator,
+  TYPE_HashJoinBuildIterator,
+  TYPE_HashJoinProbeIterator,
+  TYPE_FullTextIndexKeysIterator,
 
   TYPE_PrecedingAxisIterator,
   TYPE_PrecedingReverseAxisIterator,
   TYPE_FollowingAxisIterator,
+  TYPE_TwigPathIterator,
 
   TYPE_MaterializeIterator,
 
@@ -804,7 +804,6 @@ template<typename FloatType>
 void operator&(Archiver& ar, FloatImpl<FloatType>& obj)
 {
   ar & obj.value_;
-  ar & obj.precision_;
 }
 
 
@@ -34,6 +34,7 @@
 #include "store/api/item_handle.h"
 #include "store/api/iterator.h"
 #include "store/api/item_factory.h"
+#include "store/api/doc_projection.h"
 
 #include "zorbamisc/ns_consts.h"
 
@@ -47,6 +48,7 @@
 #include "functions/function.h"
 
 #include "runtime/hof/function_item.h"
+#include "runtime/json/json_scan.h"
 
 #include "context/static_context.h"
 
@@ -1509,6 +1511,99 @@ void operator&(Archiver& ar, QueryLoc& obj)
 }
 
 
+/*******************************************************************************
+  DocProjection is a store class, so it is serialized by value rather than as
+  a serializable class.
+********************************************************************************/
+void operator&(Archiver& ar, store::DocProjection_t& obj)
+{
+  bool isNull = (obj.getp() == NULL);
+  ar & isNull;
+
+  if (isNull)
+    return;
+
+  if (!ar.is_serializing_out())
+    obj = new store::DocProjection;
+
+  std::vector<store::DocProjection::Path>& paths = obj->getPaths();
+
+  csize numPaths = paths.size();
+  ar & numPaths;
+  paths.resize(numPaths);
+
+  for (csize i = 0; i < numPaths; ++i)
+  {
+    store::DocProjection::Path& path = paths[i];
+
+    csize numSteps = path.size();
+    ar & numSteps;
+    path.resize(numSteps);
+
+    for (csize j = 0; j < numSteps; ++j)
+    {
+      SERIALIZE_ENUM(store::DocProjection::Axis, path[j].theAxis);
+      ar & path[j].theName;
+    }
+  }
+}
+
+
+/*******************************************************************************
+  Like DocProjection, a JSONScan is serialized by value.
+********************************************************************************/
+void operator&(Archiver& ar, rchandle<JSONScan>& obj)
+{
+  bool isNull = (obj.getp() == NULL);
+  ar & isNull;
+
+  if (isNull)
+    return;
+
+  if (!ar.is_serializing_out())
+    obj = new JSONScan;
+
+  std::vector<JSONScan::Node>& nodes = obj->getNodes();
+
+  csize numNodes = nodes.size();
+  ar & numNodes;
+  nodes.resize(numNodes);
+
+  for (csize i = 0; i < numNodes; ++i)
+  {
+    JSONScan::Node& node = nodes[i];
+
+    csize numChildren = node.theChildren.size();
+    ar & numChildren;
+    node.theChildren.resize(numChildren);
+
+    for (csize j = 0; j < numChildren; ++j)
+    {
+      ar & node.theChildren[j].first;
+      ar & node.theChildren[j].second;
+    }
+
+    ar & node.theKeep;
+
+    csize numPredicates = node.thePredicates.size();
+    ar & numPredicates;
+    node.thePredicates.resize(numPredicates);
+
+    for (csize j = 0; j < numPredicates; ++j)
+      ar & node.thePredicates[j];
+  }
+
+  std::vector<store::Item_t>& predicates = obj->getPredicates();
+
+  csize numPredicates = predicates.size();
+  ar & numPredicates;
+  predicates.resize(numPredicates);
+
+  for (csize i = 0; i < numPredicates; ++i)
+    ar & predicates[i];
+}
+
+
 /*******************************************************************************
 
 ********************************************************************************/
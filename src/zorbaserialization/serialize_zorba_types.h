@@ -44,6 +44,7 @@ namespace zorba
   class function;
   class HashMapItemPointerCmp;
   class HashMapZStringCmp;
+  class JSONScan;
   class QueryLoc;
   class Timezone;
   class XQType;
@@ -79,6 +80,10 @@ void operator&(Archiver& ar, QueryLoc& obj);
 
 void operator&(Archiver& ar, const Diagnostic*& obj);
 
+void operator&(Archiver& ar, store::DocProjection_t& obj);
+
+void operator&(Archiver& ar, rchandle<JSONScan>& obj);
+
 
 #define SERIALIZE_TYPEMANAGER(type_mgr_type, type_mgr)                  \
   bool is_root_type_mgr =                                               \
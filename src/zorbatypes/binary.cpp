@@ -62,6 +62,13 @@ void Base64::decode( istream &is, zstring *to ) {
   CATCH_BASE64_EXCEPTION()
 }
 
+void Base64::decode( istream &is, ostream &os ) {
+  try {
+    base64::decode( is, os, base64::dopt_any_len | base64::dopt_ignore_ws );
+  }
+  CATCH_BASE64_EXCEPTION()
+}
+
 void Base64::decode( char const *from, size_type from_len, zstring *to ) {
   try {
     base64::decode(
@@ -71,6 +78,15 @@ void Base64::decode( char const *from, size_type from_len, zstring *to ) {
   CATCH_BASE64_EXCEPTION()
 }
 
+void Base64::decode( char const *from, size_type from_len, value_type *to ) {
+  try {
+    base64::decode(
+      from, from_len, to, base64::dopt_any_len | base64::dopt_ignore_ws
+    );
+  }
+  CATCH_BASE64_EXCEPTION()
+}
+
 Base64::Base64( Base16 const &b16 ) {
   value_type tmp;
   hexbinary::decode( &b16.data()[0], b16.size(), &tmp );
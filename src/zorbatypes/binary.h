@@ -50,8 +50,12 @@ public:
 
   static void decode( std::istream&, zstring* );
 
+  static void decode( std::istream&, std::ostream& );
+
   static void decode( char const*, size_type, zstring* );
 
+  static void decode( char const*, size_type, value_type* );
+
 public:
   Base64();
   Base64( Base64 const &b64 );
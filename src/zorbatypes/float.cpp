@@ -22,6 +22,7 @@
 
 #include "common/common.h"
 #include "util/ascii_util.h"
+#include "util/float_util.h"
 
 #include "decimal.h"
 #include "float.h"
@@ -51,14 +52,17 @@ zstring const& neg_inf_str() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-static void count_significant_digits( char digit, int *significant_digits,
-                                      int *trailing_zeros ) {
-  if ( digit == '0' )
-    ++*trailing_zeros;
+static void accumulate_digit( char digit, uint64_t *significand,
+                              int *significand_digits, bool *fast ) {
+  //
+  // 19 digits always fit into 64 bits.
+  //
+  if ( *significand_digits == 19 )
+    *fast = false;
   else {
-    if ( (*significant_digits)++ )
-      *significant_digits += *trailing_zeros;
-    *trailing_zeros = 0;
+    *significand = *significand * 10 + (digit - '0');
+    if ( *significand )
+      ++*significand_digits;
   }
 }
 
@@ -67,13 +71,10 @@ void FloatImpl<F>::parse( char const *s ) {
   if ( !*s )
     throw std::invalid_argument( "empty string" );
 
-  int significant_digits = 0;
-
   s = ascii::trim_start_space( s );
 
   if ( !parse_etc( s ) ) {
     char const *const first_non_ws = s;
-    int trailing_zeros = 0;
     //
     // We need got_digit to know that we're potentially parsing a floating
     // point value comprised of at least one digit -- which means the value
@@ -84,39 +85,61 @@ void FloatImpl<F>::parse( char const *s ) {
     // whereas XQuery insists on a specific case.
     //
     bool got_digit = false;
+    //
+    // The digits are also accumulated into a decimal significand and exponent
+    // so that, in the common case, the value can be converted exactly without
+    // strtod() (see fp::fast_ston()).  If there are too many digits or the
+    // literal is malformed, fast is set to false and aton() is used.
+    //
+    bool fast = true;
+    bool const negative = *s == '-';
+    uint64_t significand = 0;
+    int significand_digits = 0;
+    int exponent = 0;
 
     if ( *s == '+' || *s == '-' )
       ++s;
     if ( ascii::is_digit( *s ) ) {
       got_digit = true;
       do {
-        count_significant_digits( *s, &significant_digits, &trailing_zeros );
+        accumulate_digit( *s, &significand, &significand_digits, &fast );
       } while ( ascii::is_digit( *++s ) );
     }
     if ( *s == '.' && ascii::is_digit( *++s ) ) {
       got_digit = true;
       do {
-        count_significant_digits( *s, &significant_digits, &trailing_zeros );
+        accumulate_digit( *s, &significand, &significand_digits, &fast );
+        --exponent;
       } while ( ascii::is_digit( *++s ) );
     }
+    fast = fast && got_digit;
     if ( *s == 'e' || *s == 'E' ) {
       ++s;
+      bool const exponent_negative = *s == '-';
       if ( *s == '+' || *s == '-' )
         ++s;
       if ( ascii::is_digit( *s ) ) {
         got_digit = true;
-        while ( ascii::is_digit( *++s ) ) ;
-      }
+        int e = 0;
+        do {
+          if ( e < 100000 )
+            e = e * 10 + (*s - '0');
+        } while ( ascii::is_digit( *++s ) );
+        exponent += exponent_negative ? -e : e;
+      } else
+        fast = false;
     }
     if ( !got_digit )
       throw std::invalid_argument(
         BUILD_STRING( '"', first_non_ws, "\": invalid floating-point literal" )
       );
-    value_ = ztd::aton<value_type>( first_non_ws );
+    value_type value;
+    if ( fast && !*ascii::trim_start_space( s ) &&
+         fp::fast_ston( significand, exponent, &value ) )
+      value_ = negative ? -value : value;
+    else
+      value_ = ztd::aton<value_type>( first_non_ws );
   }
-
-  precision_ = significant_digits < max_precision() ?
-    significant_digits : max_precision();
 }
 
 template<typename F>
@@ -243,13 +266,38 @@ void FloatImpl<float>::modf( FloatImpl<float> &out_fraction,
   out_integer = int_part;
 }
 
+/**
+ * Gets the magnitude at and above which all values of type F are integral.
+ */
+template<typename F>
+inline F min_integral() {
+  return static_cast<F>( 1ull << (std::numeric_limits<F>::digits - 1) );
+}
+
 template<typename F>
 FloatImpl<F> FloatImpl<F>::round() const {
-  return round( numeric_consts<xs_integer>::zero() );
+  FloatImpl result;
+  if ( isFinite() && !isZero() && std::fabs( value_ ) < min_integral<F>() ) {
+    //
+    // For values having a fractional part, subtracting the floor is exact.
+    //
+    F r = std::floor( value_ );
+    if ( value_ - r >= static_cast<F>( 0.5 ) )
+      r += 1;
+    if ( r == 0 && value_ < 0 )
+      result = neg_zero();
+    else
+      result.value_ = r;
+  } else
+    result.value_ = value_;
+  return result;
 }
 
 template<typename F>
 FloatImpl<F> FloatImpl<F>::round( Integer const &precision ) const {
+  if ( precision.sign() == 0 )
+    return round();
+
   FloatImpl result;
   if ( isFinite() && !isZero() ) {
     MAPM m(
@@ -274,7 +322,22 @@ FloatImpl<F> FloatImpl<F>::round( Integer const &precision ) const {
 template<typename F>
 FloatImpl<F> FloatImpl<F>::roundHalfToEven( Integer const &precision ) const {
   FloatImpl result;
-  if ( isFinite() && !isZero() ) {
+  if ( !isFinite() || isZero() )
+    result.value_ = value_;
+  else if ( precision.sign() == 0 ) {
+    if ( std::fabs( value_ ) < min_integral<F>() ) {
+      F r = std::floor( value_ );
+      F const diff = value_ - r;
+      if ( diff > static_cast<F>( 0.5 ) ||
+           (diff == static_cast<F>( 0.5 ) && std::fmod( r, F(2) ) != 0) )
+        r += 1;
+      if ( r == 0 && value_ < 0 )
+        result = neg_zero();
+      else
+        result.value_ = r;
+    } else
+      result.value_ = value_;
+  } else {
     MAPM m(
       Decimal::roundHalfToEven2(
         Decimal::value_type( value_ ),
@@ -288,8 +351,7 @@ FloatImpl<F> FloatImpl<F>::roundHalfToEven( Integer const &precision ) const {
       m.toString( buf, ZORBA_FLOAT_POINT_PRECISION );
       result.parse( buf );
     }
-  } else
-    result.value_ = value_;
+  }
   return result;
 }
 
@@ -347,80 +409,58 @@ zstring FloatImpl<F>::toString( bool no_scientific_format ) const {
   if ( isNegZero() )
     return "-0";
 
-  value_type const abs_val = fabs( value_ );
-  value_type const lower = 0.000001f, upper = 1000000.0f;
-
-  if ( no_scientific_format || (abs_val >= lower && abs_val < upper) ||
-       abs_val == 0 ) {
-#if 1
-    // This is the "spec" implementation, i.e., it is an exact application of
-    // the spec in  http://www.w3.org/TR/xpath-functions/#casting
-    MAPM temp( value_ );
-    temp = temp.round( precision_ );
-    return Decimal::toString( temp, isNegZero(), max_precision() );
-#else
-    std::stringstream stream;
-    stream.precision(7);
-    stream.setf(std::ios::fixed);
-    stream << value_;
-
-    zstring result(stream.str());
-
-    // remove non-significant trailing 0's
-    long i = result.size() - 1;
-    while (str[i] == '0')
-      --i;
-
-    if (i >= 0) {
-      long j = i;
-      while (str[j] != '.')
-        --j;
-
-      if (j >= 0)
-        if (j == i)
-          result.resize(i);
-        else
-          result.resize(i+1);
-    }
-
-    return result;
-#endif
-  } else {
-    char buf[174];
-    sprintf( buf, "%#1.*E", (int)precision_, (double)value_ );
-    char *e = ::strchr( buf, 'E' );
-
+  //
+  // The digits are the shortest ones that convert back to value_, so the
+  // result is the canonical representation of the value and no rounding to
+  // some precision nor clean-up of the digits is needed.
+  //
+  char digits[ fp::digits_buf_size ];
+  int exponent;
+  int const n = fp::shortest_digits( std::fabs( value_ ), digits, &exponent );
+  //
+  // The value is 0.d1d2...dn * 10^point.
+  //
+  int const point = n + exponent;
+
+  zstring result;
+  result.reserve( n + 8 );
+  if ( value_ < 0 )
+    result += '-';
+
+  if ( no_scientific_format || (point >= -5 && point <= 6) ) {
     //
-    // Clean-up, part 1: remove trailing zeros from mantissa
-    // e.g.: xx.xx12300Exx => xx.xx123Exx
+    // The absolute value is in [0.000001,1000000): use decimal notation
+    // without trailing zeros after, nor a lone, decimal point.
     //
-    char *zero = e - 1;
-    while ( *zero == '0' && zero[-1] != '.' )
-      --zero;
-    if ( zero < e - 1 )
-      ::memmove( zero + 1, e, strlen( e ) + 1 );
-
+    if ( point <= 0 ) {
+      result += "0.";
+      result.append( -point, '0' );
+      result.append( digits, n );
+    } else if ( point >= n ) {
+      result.append( digits, n );
+      result.append( point - n, '0' );
+    } else {
+      result.append( digits, point );
+      result += '.';
+      result.append( digits + point, n - point );
+    }
+  } else {
     //
-    // Clean-up, part 2: remove '+' and leading '0' from exponent
-    // e.g: 1E+xx => 1Exx, 1E-0x => 1E-x
+    // Use scientific notation with exactly one non-zero digit before the
+    // decimal point, at least one digit after it, and no '+' nor leading
+    // zeros in the exponent.
     //
-    e = ::strchr( buf, 'E' );
-    char *dest = ++e;
-    switch ( *e ) {
-      case '-':
-        ++dest;
-        // no break;
-      case '+':
-        ++e;
-    }
-    if ( *e == '0' )
-      ++e;
-    if ( dest < e )
-      ::memmove( dest, e, strlen( e ) + 1 );
-
-    Decimal::reduce( buf );
-    return buf;
+    result += digits[0];
+    result += '.';
+    if ( n > 1 )
+      result.append( digits + 1, n - 1 );
+    else
+      result += '0';
+    result += 'E';
+    ascii::itoa_buf_type buf;
+    result += ascii::itoa( point - 1, buf );
   }
+  return result;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
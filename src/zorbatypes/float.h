@@ -301,12 +301,7 @@ public:
                                         FloatImpl<FloatType2>& );
 
 private:
-  typedef unsigned short precision_type;
-
-  value_type     value_;
-  precision_type precision_;
-
-  static precision_type max_precision();
+  value_type value_;
 
   void parse( char const* );
   bool parse_etc( char const* );
@@ -322,93 +317,83 @@ typedef FloatImpl<double> Double;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-template<>
-inline FloatImpl<float>::precision_type FloatImpl<float>::max_precision() {
-  return 7;
-}
-
-template<>
-inline FloatImpl<double>::precision_type FloatImpl<double>::max_precision() {
-  return 16;
-}
-
 ////////// constructors ///////////////////////////////////////////////////////
 
 template<typename F>
 inline FloatImpl<F>::FloatImpl( char c ) :
-  value_( static_cast<F>( c ) ), precision_( max_precision() )
+  value_( static_cast<F>( c ) )
 {
 }
 
 template<typename F>
 inline FloatImpl<F>::FloatImpl( signed char c ) :
-  value_( static_cast<F>( c ) ), precision_( max_precision() )
+  value_( static_cast<F>( c ) )
 {
 }
 
 template<typename F>
 inline FloatImpl<F>::FloatImpl( short n ) :
-  value_( static_cast<F>( n ) ), precision_( max_precision() )
+  value_( static_cast<F>( n ) )
 {
 }
 
 template<typename F>
 inline FloatImpl<F>::FloatImpl( int n ) :
-  value_( static_cast<F>( n ) ), precision_( max_precision() )
+  value_( static_cast<F>( n ) )
 {
 }
 
 template<typename F>
 inline FloatImpl<F>::FloatImpl( long n ) :
-  value_( static_cast<F>( n ) ), precision_( max_precision() )
+  value_( static_cast<F>( n ) )
 {
 }
 
 template<typename F>
 inline FloatImpl<F>::FloatImpl( long long n ) :
-  value_( static_cast<F>( n ) ), precision_( max_precision() )
+  value_( static_cast<F>( n ) )
 {
 }
 
 template<typename F>
 inline FloatImpl<F>::FloatImpl( unsigned char c ) :
-  value_( static_cast<F>( c ) ), precision_( max_precision() )
+  value_( static_cast<F>( c ) )
 {
 }
 
 template<typename F>
 inline FloatImpl<F>::FloatImpl( unsigned short n ) :
-  value_( static_cast<F>( n ) ), precision_( max_precision() )
+  value_( static_cast<F>( n ) )
 {
 }
 
 template<typename F>
 inline FloatImpl<F>::FloatImpl( unsigned int n ) :
-  value_( static_cast<F>( n ) ), precision_( max_precision() )
+  value_( static_cast<F>( n ) )
 {
 }
 
 template<typename F>
 inline FloatImpl<F>::FloatImpl( unsigned long n ) :
-  value_( static_cast<F>( n ) ), precision_( max_precision() )
+  value_( static_cast<F>( n ) )
 {
 }
 
 template<typename F>
 inline FloatImpl<F>::FloatImpl( unsigned long long n ) :
-  value_( static_cast<F>( n ) ), precision_( max_precision() )
+  value_( static_cast<F>( n ) )
 {
 }
 
 template<typename F>
 inline FloatImpl<F>::FloatImpl( float n ) :
-  value_( static_cast<F>( n ) ), precision_( max_precision() )
+  value_( static_cast<F>( n ) )
 {
 }
 
 template<typename F>
 inline FloatImpl<F>::FloatImpl( double n ) :
-  value_( static_cast<F>( n ) ), precision_( max_precision() )
+  value_( static_cast<F>( n ) )
 {
 }
 
@@ -428,7 +413,7 @@ inline FloatImpl<F>::FloatImpl( StringType const &s,
 template<typename F>
 template<typename G>
 inline FloatImpl<F>::FloatImpl( FloatImpl<G> const &f ) :
-  value_( static_cast<F>( f.value_ ) ), precision_( max_precision() )
+  value_( static_cast<F>( f.value_ ) )
 {
 }
 
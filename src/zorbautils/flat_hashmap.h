@@ -0,0 +1,920 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ZORBA_UTILS_FLAT_HASHMAP_H
+#define ZORBA_UTILS_FLAT_HASHMAP_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include <zorba/config.h>
+
+#include "common/common.h"
+#include "zorbamisc/config/stdint.h"
+
+#include "zorbautils/fatal.h"
+#include "zorbautils/mutex.h"
+
+#include "store/api/shared_types.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define ZORBA_FLAT_HASH_SSE2 1
+# include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+# include <intrin.h>
+#endif
+
+namespace zorba
+{
+
+
+/*******************************************************************************
+
+  A group of consecutive control bytes of a FlatHashMap that are examined
+  together: with SSE2, the 16 bytes are compared in a single instruction;
+  otherwise, they're compared one at a time.
+
+  A control byte is either EMPTY (0x80) or, for an occupied slot, 7 bits of
+  the hash value of the slot's key. A mask has bit i set if the i-th byte of
+  the group matches.
+
+********************************************************************************/
+class FlatHashGroup
+{
+public:
+  typedef uint8_t ctrl_type;
+  typedef uint32_t mask_type;
+
+  static ctrl_type const EMPTY = 0x80;
+  static csize const SIZE = 16;
+
+  static mask_type match(ctrl_type const *ctrl, ctrl_type tag)
+  {
+#ifdef ZORBA_FLAT_HASH_SSE2
+    __m128i const g = _mm_loadu_si128(reinterpret_cast<__m128i const*>(ctrl));
+    return static_cast<mask_type>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(static_cast<char>(tag))))
+    );
+#else
+    mask_type m = 0;
+    for (csize i = 0; i < SIZE; ++i)
+      if (ctrl[i] == tag)
+        m |= mask_type(1) << i;
+    return m;
+#endif
+  }
+
+  static mask_type match_empty(ctrl_type const *ctrl)
+  {
+#ifdef ZORBA_FLAT_HASH_SSE2
+    // EMPTY is the only control byte with its high bit set.
+    return static_cast<mask_type>(
+      _mm_movemask_epi8(
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(ctrl))
+      )
+    );
+#else
+    return match(ctrl, EMPTY);
+#endif
+  }
+
+  /**
+   * Gets the index of the lowest set bit of a non-zero mask.
+   */
+  static csize lowest(mask_type m)
+  {
+    assert(m != 0);
+#if defined(__GNUC__)
+    return static_cast<csize>(__builtin_ctz(m));
+#elif defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward(&i, m);
+    return i;
+#else
+    csize i = 0;
+    for (; !(m & 1); m >>= 1)
+      ++i;
+    return i;
+#endif
+  }
+};
+
+
+/*******************************************************************************
+
+  This template class implements a hash-based map from items of type K to items
+  of type V using open addressing, as an alternative to HashMap whose chained
+  entries cost a pointer chase per probe.
+
+  C is the template parameter that implements the hashing and equality
+  functions; it has the same contract as for HashMap:
+    uint32_t hash(const K&);
+    bool equal(const K&, const K&);
+
+  The table has a power-of-2 number of slots, each one being either empty or
+  occupied by a single key/value pair. A key is placed in the first empty slot
+  at or after its "home" slot (linear probing). Lookups examine the control
+  bytes of a whole FlatHashGroup at a time and call C::equal() only for slots
+  whose control byte and stored hash value match those of the key; a lookup
+  stops at the first empty slot.
+
+  Erasing a key never leaves a tombstone: the keys that follow it in the same
+  run of occupied slots are shifted back into the hole whenever that keeps them
+  reachable from their home slots ("backward-shift deletion"), so lookups never
+  get longer because of past deletions.
+
+  Other than the iteration order, the public interface is the same as that of
+  HashMap (minus erase(iterator&)), so a HashMap can be replaced by a
+  FlatHashMap by just changing its type.
+
+  theCtrl       : The control bytes, one per slot plus SIZE - 1 trailing bytes
+                  that are copies of the first SIZE - 1 ones so that a group
+                  starting near the end of the table wraps around.
+  theHashes     : The C::hash() values of the keys, so that the table can be
+                  grown and keys can be shifted without rehashing them.
+  theKeys       : The keys (uninitialized in empty slots).
+  theValues     : The values (uninitialized in empty slots).
+  theCapacity   : The number of slots.
+  theShift      : 64 - log2(theCapacity).
+  theNumEntries : The number of occupied slots.
+  theMaxLoad    : The number of entries above which the table is doubled.
+
+********************************************************************************/
+template <class K, class V, class C>
+class FlatHashMap
+{
+  FlatHashMap( FlatHashMap const& );
+  FlatHashMap& operator=( FlatHashMap const& );
+
+  typedef FlatHashGroup::ctrl_type ctrl_type;
+  typedef FlatHashGroup::mask_type mask_type;
+
+  static csize const NPOS = static_cast<csize>(-1);
+
+public:
+  typedef K key_type;
+  typedef V value_type;
+  typedef C key_equal;
+
+  class iterator
+  {
+    friend class FlatHashMap;
+
+  protected:
+    FlatHashMap const * theMap;
+    csize               thePos;
+
+  protected:
+    iterator(FlatHashMap const* map, csize pos)
+      :
+      theMap(map),
+      thePos(pos)
+    {
+      while (thePos < theMap->theCapacity && theMap->isFree(thePos))
+        thePos++;
+    }
+
+  public:
+    iterator() : theMap(NULL), thePos(0) {}
+
+    bool operator==(const iterator& other) const
+    {
+      return theMap == other.theMap && thePos == other.thePos;
+    }
+
+    bool operator!=(const iterator& other) const
+    {
+      return theMap != other.theMap || thePos != other.thePos;
+    }
+
+    iterator& operator++()
+    {
+      if (thePos < theMap->theCapacity)
+      {
+        thePos++;
+        while (thePos < theMap->theCapacity && theMap->isFree(thePos))
+          thePos++;
+      }
+      return *this;
+    }
+
+    std::pair<K, V> operator*() const
+    {
+      ZORBA_FATAL(thePos < theMap->theCapacity, "");
+      return std::pair<K, V>(theMap->theKeys[thePos], theMap->theValues[thePos]);
+    }
+
+    const K& getKey() const
+    {
+      ZORBA_FATAL(thePos < theMap->theCapacity, "");
+      return theMap->theKeys[thePos];
+    }
+
+    V& getValue() const
+    {
+      ZORBA_FATAL(thePos < theMap->theCapacity, "");
+      return theMap->theValues[thePos];
+    }
+
+    void setValue(const V& val)
+    {
+      ZORBA_FATAL(thePos < theMap->theCapacity, "");
+      theMap->theValues[thePos] = val;
+    }
+  };
+
+public:
+  static const double DEFAULT_LOAD_FACTOR;
+
+protected:
+  ctrl_type                    * theCtrl;
+  uint32_t                     * theHashes;
+  K                            * theKeys;
+  V                            * theValues;
+
+  csize                          theCapacity;
+  unsigned                       theShift;
+
+  csize                          theNumEntries;
+
+  double                         theLoadFactor;
+
+  csize                          theMaxLoad;
+
+  C                              theCompareFunction;
+
+  SYNC_CODE(mutable Mutex        theMutex;)
+  SYNC_CODE(Mutex              * theMutexp;)
+
+public:
+
+/***************************************************************************//**
+  Constructor: Allocates a table big enough to hold the given number of
+  entries without growing.
+
+  This constructor takes as input a comparison-function obj. This is needed
+  when the C::hash() and C::equal() methods are not static.
+********************************************************************************/
+FlatHashMap(const C& compFunction, csize size, bool sync)
+  :
+  theNumEntries(0),
+  theLoadFactor(DEFAULT_LOAD_FACTOR),
+  theCompareFunction(compFunction)
+{
+  allocate(computeCapacity(size));
+  SYNC_CODE(theMutexp = (sync ? &theMutex : NULL);)
+}
+
+
+/***************************************************************************//**
+  Constructor: Allocates a table big enough to hold the given number of
+  entries without growing. It should be used when the C::hash() and
+  C::equal() methods are static.
+********************************************************************************/
+FlatHashMap(csize size, bool sync)
+  :
+  theNumEntries(0),
+  theLoadFactor(DEFAULT_LOAD_FACTOR)
+{
+  allocate(computeCapacity(size));
+  SYNC_CODE(theMutexp = (sync ? &theMutex : NULL);)
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+virtual ~FlatHashMap()
+{
+  destroyEntries();
+  deallocate();
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+SYNC_CODE(                 \
+Mutex* get_mutex() const   \
+{                          \
+  return theMutexp;        \
+}                          \
+)
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void set_load_factor(double v)
+{
+  theLoadFactor = v;
+  computeMaxLoad();
+}
+
+
+bool empty() const
+{
+  return (theNumEntries == 0);
+}
+
+
+csize size() const
+{
+  return theNumEntries;
+}
+
+
+csize capacity() const
+{
+  return theCapacity;
+}
+
+
+csize bucket_count() const
+{
+  return theCapacity;
+}
+
+
+C get_compare_function()
+{
+  return theCompareFunction;
+}
+
+
+bool get_sync() const
+{
+  bool sync = false;
+  SYNC_CODE(sync = (theMutexp == &theMutex));
+  return sync;
+}
+
+
+/*******************************************************************************
+  Removes all the entries but keeps the table at its current size.
+********************************************************************************/
+void clear()
+{
+  SYNC_CODE(AutoMutex lock(theMutexp);)
+
+  clearNoSync();
+}
+
+
+void clearNoSync()
+{
+  destroyEntries();
+  ::memset(theCtrl, FlatHashGroup::EMPTY, theCapacity + FlatHashGroup::SIZE - 1);
+  theNumEntries = 0;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+iterator begin() const
+{
+  return iterator(this, 0);
+}
+
+
+iterator end() const
+{
+  return iterator(this, theCapacity);
+}
+
+
+/*******************************************************************************
+  Return true if the map already contains an item that is "equal" to the given
+  item; otherwise return false.
+********************************************************************************/
+bool exists(const K& item) const
+{
+  uint32_t hval = hash(item);
+
+  SYNC_CODE(AutoMutex lock(theMutexp);)
+
+  return probe(hval, KeyEquals(*this, item)) != NPOS;
+}
+
+
+/*******************************************************************************
+  If the given item is already in the map, return an iterator positioned at the
+  associated entry; otherwise return the end iterator.
+********************************************************************************/
+iterator find(const K& item)
+{
+  uint32_t hval = hash(item);
+
+  SYNC_CODE(AutoMutex lock(theMutexp);)
+
+  csize pos = probe(hval, KeyEquals(*this, item));
+
+  return pos == NPOS ? end() : iterator(this, pos);
+}
+
+
+/*******************************************************************************
+  Look for a key that has the given hash value and for which the given
+  predicate returns true. This allows looking up a key by something that is
+  not a K (e.g., a string key by a char const*) without constructing a K.
+  Return a pointer to the key or NULL if there is no such key.
+********************************************************************************/
+template <class P>
+K const* findNoSync(uint32_t hval, P const& pred) const
+{
+  csize pos = probe(hval, pred);
+
+  return pos == NPOS ? NULL : theKeys + pos;
+}
+
+
+/*******************************************************************************
+  If the given item is already in the map, return true and a copy of the value
+  associated with the item; otherwise return false.
+********************************************************************************/
+bool get(const K& item, V& value) const
+{
+  uint32_t hval = hash(item);
+
+  SYNC_CODE(AutoMutex lock(theMutexp);)
+
+  csize pos = probe(hval, KeyEquals(*this, item));
+
+  if (pos == NPOS)
+    return false;
+
+  value = theValues[pos];
+  return true;
+}
+
+
+/******************************************************************************
+  If the map does not already contain an item I that is "equal" to the given
+  item, make a copy of the given item and its associated value and place the
+  new (item, value) pair in the map; then return true. Otherwise, return false.
+********************************************************************************/
+bool insert(const std::pair<const K, V>& pair)
+{
+  bool found;
+  uint32_t hval = hash(pair.first);
+
+  SYNC_CODE(AutoMutex lock(theMutexp);)
+
+  csize pos = hashInsert(pair.first, hval, found);
+
+  if (!found)
+    theValues[pos] = pair.second;
+
+  return !found;
+}
+
+
+/******************************************************************************
+  If the map does not already contain an item I that is "equal" to the given
+  item, make a copy of the given item and its associated value and place the
+  new (item, value) pair in the map; then return true. Otherwise, return false,
+  as well as a copy of the value associated with the found item I.
+********************************************************************************/
+bool insert(const K& item, V& value)
+{
+  bool found;
+  uint32_t hval = hash(item);
+
+  SYNC_CODE(AutoMutex lock(theMutexp);)
+
+  csize pos = hashInsert(item, hval, found);
+
+  if (!found)
+    theValues[pos] = value;
+  else
+    value = theValues[pos];
+
+  return !found;
+}
+
+
+/******************************************************************************
+  If the map does not already contain an item I that is "equal" to the given
+  item, return false. Otherwise, set the value associated with I to the given
+  value and return true,
+********************************************************************************/
+bool update(const K& item, const V& value)
+{
+  uint32_t hval = hash(item);
+
+  SYNC_CODE(AutoMutex lock(theMutexp);)
+
+  csize pos = probe(hval, KeyEquals(*this, item));
+
+  if (pos == NPOS)
+    return false;
+
+  theValues[pos] = value;
+  return true;
+}
+
+
+/*******************************************************************************
+  If the map contains an item that is "equal" to the given item, remove that
+  item from the map and return true. Otherwise, return false.
+********************************************************************************/
+bool erase(const K& item)
+{
+  uint32_t hval = hash(item);
+
+  SYNC_CODE(AutoMutex lock(theMutexp);)
+
+  return eraseNoSync(item, hval);
+}
+
+
+bool eraseNoSync(const K& item)
+{
+  return eraseNoSync(item, hash(item));
+}
+
+
+bool eraseNoSync(const K& item, uint32_t hval)
+{
+  csize pos = probe(hval, KeyEquals(*this, item));
+
+  if (pos == NPOS)
+    return false;
+
+  eraseEntry(pos);
+  return true;
+}
+
+
+/*******************************************************************************
+  Remove every entry whose key satisfies the given predicate. A key that gets
+  shifted back while the table is being scanned may be passed to the predicate
+  more than once.
+********************************************************************************/
+template <class P>
+csize eraseIfNoSync(P const& pred)
+{
+  csize numErased = 0;
+
+  for (csize pos = 0; pos < theCapacity; )
+  {
+    if (!isFree(pos) && pred(theKeys[pos]))
+    {
+      // The hole may be refilled by a key from further on: look at it again.
+      eraseEntry(pos);
+      ++numErased;
+    }
+    else
+    {
+      ++pos;
+    }
+  }
+
+  return numErased;
+}
+
+
+protected:
+
+/*******************************************************************************
+  A predicate that compares keys using the comparison function of the map.
+********************************************************************************/
+class KeyEquals
+{
+public:
+  KeyEquals(FlatHashMap const& map, K const& key) : theMap(map), theKey(key) {}
+
+  bool operator()(K const& key) const
+  {
+    return theMap.equal(key, theKey);
+  }
+
+private:
+  FlatHashMap const & theMap;
+  K const           & theKey;
+};
+
+
+/*******************************************************************************
+
+********************************************************************************/
+csize computeCapacity(csize size) const
+{
+  csize const minCap = static_cast<csize>(size / theLoadFactor) + 1;
+
+  csize cap = FlatHashGroup::SIZE;
+  while (cap < minCap)
+    cap *= 2;
+
+  return cap;
+}
+
+
+uint32_t hash(const K& item) const
+{
+  return theCompareFunction.hash(item);
+}
+
+
+bool equal(const K& item1, const K& item2) const
+{
+  return theCompareFunction.equal(item1, item2);
+}
+
+
+/*******************************************************************************
+  The hash values given by C::hash() are often poorly distributed (e.g., item
+  addresses), so they're scrambled by Fibonacci hashing: the home slot is given
+  by the top log2(theCapacity) bits of the product and the control byte by the
+  7 bits right below them.
+********************************************************************************/
+uint64_t scramble(uint32_t hval) const
+{
+  return hval * static_cast<uint64_t>(0x9E3779B97F4A7C15ULL);
+}
+
+
+csize home(uint32_t hval) const
+{
+  return static_cast<csize>(scramble(hval) >> theShift);
+}
+
+
+ctrl_type tag(uint32_t hval) const
+{
+  return static_cast<ctrl_type>((scramble(hval) >> (theShift - 7)) & 0x7F);
+}
+
+
+bool isFree(csize pos) const
+{
+  return theCtrl[pos] == FlatHashGroup::EMPTY;
+}
+
+
+void setCtrl(csize pos, ctrl_type c)
+{
+  theCtrl[pos] = c;
+  if (pos < FlatHashGroup::SIZE - 1)
+    theCtrl[theCapacity + pos] = c;
+}
+
+
+/*******************************************************************************
+  Return the position of the key with the given hash value for which the given
+  predicate returns true or NPOS if there is none.
+********************************************************************************/
+template <class P>
+csize probe(uint32_t hval, P const& pred) const
+{
+  ctrl_type const t = tag(hval);
+  csize const mask = theCapacity - 1;
+  csize pos = home(hval);
+
+  for (;;)
+  {
+    mask_type m = FlatHashGroup::match(theCtrl + pos, t);
+    mask_type const e = FlatHashGroup::match_empty(theCtrl + pos);
+
+    // Only the slots before the first empty one are part of the run.
+    if (e)
+      m &= (e & (0u - e)) - 1;
+
+    for (; m; m &= m - 1)
+    {
+      csize i = (pos + FlatHashGroup::lowest(m)) & mask;
+      if (theHashes[i] == hval && pred(theKeys[i]))
+        return i;
+    }
+
+    if (e)
+      return NPOS;
+
+    pos = (pos + FlatHashGroup::SIZE) & mask;
+  }
+}
+
+
+/*******************************************************************************
+  Return the position of the first empty slot at or after the home slot of the
+  given hash value. There always is one since theMaxLoad < theCapacity.
+********************************************************************************/
+csize findEmpty(uint32_t hval) const
+{
+  csize const mask = theCapacity - 1;
+  csize pos = home(hval);
+
+  for (;;)
+  {
+    mask_type e = FlatHashGroup::match_empty(theCtrl + pos);
+    if (e)
+      return (pos + FlatHashGroup::lowest(e)) & mask;
+
+    pos = (pos + FlatHashGroup::SIZE) & mask;
+  }
+}
+
+
+/*******************************************************************************
+  Return the position of the entry for the given item, inserting one with a
+  default-constructed value if there is none.
+********************************************************************************/
+csize hashInsert(const K& item, uint32_t hval, bool& found)
+{
+  csize pos = probe(hval, KeyEquals(*this, item));
+
+  if (pos != NPOS)
+  {
+    found = true;
+    return pos;
+  }
+
+  found = false;
+
+  if (theNumEntries >= theMaxLoad)
+  {
+    garbageCollect();
+
+    if (theNumEntries >= theMaxLoad)
+      resizeHashTab(theCapacity * 2);
+  }
+
+  pos = findEmpty(hval);
+
+  new (theKeys + pos) K(item);
+  new (theValues + pos) V;
+  theHashes[pos] = hval;
+  setCtrl(pos, tag(hval));
+
+  ++theNumEntries;
+
+  return pos;
+}
+
+
+/*******************************************************************************
+  Free the slot at the given position, then shift back into the hole the first
+  of the following keys of the run that can still be reached from its home
+  slot from there, and repeat for the hole that this leaves.
+********************************************************************************/
+void eraseEntry(csize hole)
+{
+  csize const mask = theCapacity - 1;
+
+  theKeys[hole].~K();
+  theValues[hole].~V();
+
+  for (csize pos = (hole + 1) & mask; !isFree(pos); pos = (pos + 1) & mask)
+  {
+    // The key stays put if its home is cyclically in (hole, pos].
+    csize h = home(theHashes[pos]);
+    if (((pos - h) & mask) < ((pos - hole) & mask))
+      continue;
+
+    new (theKeys + hole) K(theKeys[pos]);
+    new (theValues + hole) V(theValues[pos]);
+    theKeys[pos].~K();
+    theValues[pos].~V();
+    theHashes[hole] = theHashes[pos];
+    setCtrl(hole, theCtrl[pos]);
+
+    hole = pos;
+  }
+
+  setCtrl(hole, FlatHashGroup::EMPTY);
+
+  --theNumEntries;
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void allocate(csize cap)
+{
+  theCapacity = cap;
+
+  theShift = 64;
+  for (csize c = cap; c > 1; c >>= 1)
+    --theShift;
+
+  computeMaxLoad();
+
+  theCtrl = new ctrl_type[cap + FlatHashGroup::SIZE - 1];
+  ::memset(theCtrl, FlatHashGroup::EMPTY, cap + FlatHashGroup::SIZE - 1);
+  theHashes = new uint32_t[cap];
+  theKeys = static_cast<K*>(::operator new(cap * sizeof(K)));
+  theValues = static_cast<V*>(::operator new(cap * sizeof(V)));
+}
+
+
+void computeMaxLoad()
+{
+  theMaxLoad = static_cast<csize>(theCapacity * theLoadFactor);
+  if (theMaxLoad >= theCapacity)
+    theMaxLoad = theCapacity - 1;
+}
+
+
+void deallocate()
+{
+  delete[] theCtrl;
+  delete[] theHashes;
+  ::operator delete(theKeys);
+  ::operator delete(theValues);
+}
+
+
+void destroyEntries()
+{
+  for (csize pos = 0; pos < theCapacity; ++pos)
+  {
+    if (!isFree(pos))
+    {
+      theKeys[pos].~K();
+      theValues[pos].~V();
+    }
+  }
+}
+
+
+/*******************************************************************************
+  Move every entry to a new table of the given capacity, using the stored hash
+  values rather than rehashing the keys.
+********************************************************************************/
+void resizeHashTab(csize newCap)
+{
+  ctrl_type* oldCtrl = theCtrl;
+  uint32_t* oldHashes = theHashes;
+  K* oldKeys = theKeys;
+  V* oldValues = theValues;
+  csize oldCap = theCapacity;
+
+  allocate(newCap);
+
+  for (csize i = 0; i < oldCap; ++i)
+  {
+    if (oldCtrl[i] == FlatHashGroup::EMPTY)
+      continue;
+
+    uint32_t hval = oldHashes[i];
+    csize pos = findEmpty(hval);
+
+    new (theKeys + pos) K(oldKeys[i]);
+    new (theValues + pos) V(oldValues[i]);
+    theHashes[pos] = hval;
+    setCtrl(pos, tag(hval));
+
+    oldKeys[i].~K();
+    oldValues[i].~V();
+  }
+
+  delete[] oldCtrl;
+  delete[] oldHashes;
+  ::operator delete(oldKeys);
+  ::operator delete(oldValues);
+}
+
+
+/*******************************************************************************
+  Called right before the table would be doubled in size: a subclass can free
+  up entries (see eraseIfNoSync()) to avoid it.
+********************************************************************************/
+virtual void garbageCollect()
+{
+}
+
+};
+
+template <class K, class V, class C>
+const double FlatHashMap<K, V, C>::DEFAULT_LOAD_FACTOR = 0.8;
+
+} // namespace zorba
+
+#endif /* ZORBA_UTILS_FLAT_HASHMAP_H */
+
+/*
+ * Local variables:
+ * mode: c++
+ * End:
+ */
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ZORBA_UTILS_FLAT_HASHSET_H
+#define ZORBA_UTILS_FLAT_HASHSET_H
+
+#include <zorba/config.h>
+#include "zorbautils/flat_hashmap.h"
+#include "zorbautils/hashset.h"
+
+
+namespace zorba
+{
+
+
+/*******************************************************************************
+  The FlatHashMap counterpart of HashSet.
+********************************************************************************/
+template <class T, class C>
+class FlatHashSet : public FlatHashMap<T, DummyHashValue, C>
+{
+public:
+
+typedef typename FlatHashMap<T, DummyHashValue, C>::iterator iterator;
+
+
+FlatHashSet(const C& compFunction, csize size, bool sync)
+  :
+  FlatHashMap<T, DummyHashValue, C>(compFunction, size, sync)
+{
+}
+
+
+FlatHashSet(csize size, bool sync)
+  :
+  FlatHashMap<T, DummyHashValue, C>(size, sync)
+{
+}
+
+
+virtual ~FlatHashSet()
+{
+}
+
+
+/******************************************************************************
+  If the set does not already contain an item that is "equal" to the given item,
+  insert the given item to the set and return true. Otherwise, return false.
+********************************************************************************/
+bool insert(const T& item)
+{
+  bool found;
+  uint32_t hval = this->hash(item);
+
+  SYNC_CODE(AutoMutex lock(this->theMutexp);)
+
+  this->hashInsert(item, hval, found);
+
+  return !found;
+}
+
+
+/******************************************************************************
+  If the set does not already contain an item I that is "equal" to the given
+  item, insert the given item to the set and return true. Otherwise, return
+  false. In both cases, also return a copy of the item that is in the set.
+********************************************************************************/
+bool insert(const T& item, T& outItem)
+{
+  bool found;
+  uint32_t hval = this->hash(item);
+
+  SYNC_CODE(AutoMutex lock(this->theMutexp);)
+
+  csize pos = this->hashInsert(item, hval, found);
+
+  outItem = this->theKeys[pos];
+
+  return !found;
+}
+
+};
+
+
+} // namespace zorba
+
+#endif /* ZORBA_UTILS_FLAT_HASHSET_H */
+
+/*
+ * Local variables:
+ * mode: c++
+ * End:
+ */
+/* vim:set et sw=2 ts=2: */
@@ -17,6 +17,7 @@
 #ifndef ZORBA_HASHFUN_H
 #define ZORBA_HASHFUN_H
 
+#include <cstring>
 #include <string>
 
 #include <zorba/config.h>
@@ -32,6 +33,8 @@ class  hashfun
 #define FNV_32_INIT     ((uint32_t)0x811c9dc5)
 #define FNV_64_PRIME    ((uint64_t)0x100000001b3ULL)
 #define FNV_64_INIT     ((uint64_t)0x84222325cbf29ce4LL)
+#define WH_64_MUL       ((uint64_t)0x9e3779b97f4a7c15ULL)
+#define WH_64_FIN       ((uint64_t)0xd6e8feb86659fd93ULL)
 
   /**
    * 32 bit Fowler/Noll/Vo FNV-1a hash on binary (untyped) buffer
@@ -166,6 +169,48 @@ class  hashfun
   {
     return h32(str.c_str(), FNV_32_INIT);
   }
+
+  /*
+   * 32 bit hash on binary (untyped) buffer that consumes 8 octets at a time
+   * rather than one as FNV does, hence is several times faster on strings
+   * that aren't very short. Since the octets are read as native 64-bit
+   * integers, the hash value of a given buffer depends on the endianness of
+   * the machine: it must not be persisted.
+   *
+   * input:
+   *  buf   - start of buffer to hash
+   *  len   - length of buffer in octets
+   *  hval  - previous hash value or FNV_32_INIT if first call
+   *
+   * @return 32 bit hash
+   *
+   */
+  static inline uint32_t h32w( void const *buf, size_t len,
+                               uint32_t hval = FNV_32_INIT )
+  {
+    unsigned char const *bp = static_cast<unsigned char const*>(buf);
+    uint64_t h = hval ^ (len * WH_64_MUL);
+    uint64_t w;
+
+    for ( ; len >= 8; bp += 8, len -= 8 )
+    {
+      ::memcpy(&w, bp, 8);
+      h = (h ^ w) * WH_64_MUL;
+      h ^= h >> 29;
+    }
+    if (len)
+    {
+      w = 0;
+      ::memcpy(&w, bp, len);
+      h = (h ^ w) * WH_64_MUL;
+      h ^= h >> 29;
+    }
+
+    /* final avalanche so that every input bit affects the low 32 bits */
+    h *= WH_64_FIN;
+    h ^= h >> 32;
+    return (uint32_t)h;
+  }
   
   /*
    * 64 bit Fowler/Noll/Vo hash on binary (untyped) buffer
@@ -45,8 +45,8 @@ AtomicItemHandleHashSet::~AtomicItemHandleHashSet()
 
 void AtomicItemHandleHashSet::clear()
 {
-  HashSet<store::Item*, AtomicItemHandleHashSet::CompareFunction>::iterator ite;
-  HashSet<store::Item*, AtomicItemHandleHashSet::CompareFunction>::iterator end;
+  FlatHashSet<store::Item*, AtomicItemHandleHashSet::CompareFunction>::iterator ite;
+  FlatHashSet<store::Item*, AtomicItemHandleHashSet::CompareFunction>::iterator end;
 
   ite = theSet.begin();
   end = theSet.end();
@@ -18,7 +18,7 @@
 
 #include <cassert>
 
-#include "zorbautils/hashset.h"
+#include "zorbautils/flat_hashset.h"
 
 #include "runtime/booleans/BooleanImpl.h"
 
@@ -107,7 +107,7 @@ public:
 private:
   ValueCompareParam                      * theCompareParam;
   CompareFunction                          theCompareFunction;
-  HashSet<store::Item*, CompareFunction>   theSet;
+  FlatHashSet<store::Item*, CompareFunction>   theSet;
 
 public:
   AtomicItemHandleHashSet(ValueCompareParam* compParam, csize size = 1024);
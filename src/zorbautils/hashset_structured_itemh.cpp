@@ -22,8 +22,8 @@ namespace zorba
 
 void StructuredItemHandleHashSet::clear()
 {
-  HashSet<store::Item*, StructuredItemHandleHashSet::CompareFunction>::iterator ite;
-  HashSet<store::Item*, StructuredItemHandleHashSet::CompareFunction>::iterator end;
+  FlatHashSet<store::Item*, StructuredItemHandleHashSet::CompareFunction>::iterator ite;
+  FlatHashSet<store::Item*, StructuredItemHandleHashSet::CompareFunction>::iterator end;
 
   ite = theSet.begin();
   end = theSet.end();
@@ -20,7 +20,7 @@
 #include <cassert>
 
 #include "zorbautils/hashfun.h"
-#include "zorbautils/hashset.h"
+#include "zorbautils/flat_hashset.h"
 
 #include "zorbatypes/collation_manager.h"
 
@@ -60,7 +60,7 @@ public:
   };
 
 private:
-  HashSet<store::Item*, CompareFunction>  theSet;
+  FlatHashSet<store::Item*, CompareFunction>  theSet;
 
 public:
   StructuredItemHandleHashSet(csize size, bool sync) : theSet(size, sync) { }
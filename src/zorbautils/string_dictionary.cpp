@@ -0,0 +1,118 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "stdafx.h"
+
+#include "store/api/item_factory.h"
+
+#include "zorbautils/string_dictionary.h"
+
+
+namespace zorba
+{
+
+/*******************************************************************************
+
+********************************************************************************/
+StringDictionary::StringDictionary(store::ItemFactory* factory, bool untyped)
+  :
+  theFactory(factory),
+  theIsUntyped(untyped),
+  theItems(1024, false),
+  theNumLookups(0),
+  theNumHits(0),
+  theSavedBytes(0)
+{
+}
+
+
+/*******************************************************************************
+  Return in result an item whose string value is the given value. If the value
+  is short enough, the item is shared with all other values in the dictionary
+  that are equal to it. As with the item factory, the given value may be
+  swapped with an empty string.
+********************************************************************************/
+void StringDictionary::createItem(store::Item_t& result, zstring& value)
+{
+  if (value.size() > MAX_STRING_SIZE)
+  {
+    createNewItem(result, value);
+    return;
+  }
+
+  ++theNumLookups;
+
+  if (theItems.get(value, result))
+  {
+    ++theNumHits;
+    theSavedBytes += result->dynamic_size() + result->alloc_size();
+    return;
+  }
+
+  if (theItems.size() >= MAX_STRINGS)
+  {
+    createNewItem(result, value);
+    return;
+  }
+
+  zstring key(value);
+
+  createNewItem(result, value);
+
+  theItems.insert(key, result);
+}
+
+
+void StringDictionary::createNewItem(store::Item_t& result, zstring& value)
+{
+  if (theIsUntyped)
+    theFactory->createUntypedAtomic(result, value);
+  else
+    theFactory->createString(result, value);
+}
+
+
+/*******************************************************************************
+
+********************************************************************************/
+void StringDictionary::clear()
+{
+  theItems.clear();
+  theNumLookups = 0;
+  theNumHits = 0;
+  theSavedBytes = 0;
+}
+
+
+/*******************************************************************************
+  Print a one-line summary of the memory saved while loading the given source.
+********************************************************************************/
+void StringDictionary::report(std::ostream& os, const zstring& source) const
+{
+  os << "String dictionary       : " << source << ' '
+     << numStrings() << " distinct values, "
+     << theNumHits << " of " << theNumLookups << " values shared, "
+     << theSavedBytes << " bytes saved" << std::endl;
+}
+
+
+} // namespace zorba
+
+/*
+ * Local variables:
+ * mode: c++
+ * End:
+ */
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef ZORBA_ZORBAUTILS_STRING_DICTIONARY
+#define ZORBA_ZORBAUTILS_STRING_DICTIONARY
+
+#include <iostream>
+
+#include "common/common.h"
+
+#include "store/api/item.h"
+
+#include "zorbautils/hashmap_zstring.h"
+
+
+namespace zorba
+{
+
+namespace store
+{
+class ItemFactory;
+}
+
+
+/*******************************************************************************
+  A dictionary of short string values, used by the XML loader while loading a
+  single tree and by the JSON loader while reading a single input stream. All
+  the occurrences of the same short value within that input (text nodes,
+  attribute values, JSON keys and strings) share a single atomic item, and
+  hence a single string representation, instead of each one owning its own
+  copy of the bytes. Equality checks on two such values reduce to a pointer
+  comparison (see StringItem::equals() and UntypedAtomicItem::equals()).
+
+  The dictionary creates either xs:untypedAtomic items (for XML) or xs:string
+  items (for JSON). Values longer than MAX_STRING_SIZE bytes are not pooled,
+  since they are unlikely to repeat. Once the dictionary holds MAX_STRINGS
+  distinct values, new values are no longer added to it (but lookups of the
+  existing ones still succeed), so that a long stream of distinct values
+  does not keep growing it.
+
+  theNumLookups : Number of values of at most MAX_STRING_SIZE bytes that were
+                  looked up.
+  theNumHits    : Number of such values that were already in the dictionary.
+  theSavedBytes : Total size of the items (and their strings) that did not
+                  have to be allocated thanks to the hits.
+********************************************************************************/
+class StringDictionary
+{
+public:
+  static const csize MAX_STRING_SIZE = 64;
+
+  static const csize MAX_STRINGS = 65536;
+
+protected:
+  ZSTRING_HASH_MAP(store::Item_t, ItemMap);
+
+protected:
+  store::ItemFactory  * theFactory;
+  bool                  theIsUntyped;
+  ItemMap               theItems;
+
+  csize                 theNumLookups;
+  csize                 theNumHits;
+  csize                 theSavedBytes;
+
+public:
+  StringDictionary(store::ItemFactory* factory, bool untyped);
+
+  void createItem(store::Item_t& result, zstring& value);
+
+  void clear();
+
+  csize numStrings() const { return theItems.size(); }
+
+  csize numLookups() const { return theNumLookups; }
+
+  csize numHits() const { return theNumHits; }
+
+  csize savedBytes() const { return theSavedBytes; }
+
+  void report(std::ostream& os, const zstring& source) const;
+
+protected:
+  void createNewItem(store::Item_t& result, zstring& value);
+};
+
+
+} // namespace zorba
+
+#endif
+
+/*
+ * Local variables:
+ * mode: c++
+ * End:
+ */
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,17 @@
+{
+  "first" : "one", 
+  "second" : "two", 
+  "third" : "three"
+}{
+  "first" : "quoted", 
+  "second" : "embedded \" quote", 
+  "third" : "embedded\nnewline"
+}{
+  "first" : "\" leading quote", 
+  "second" : "", 
+  "third" : "trailing quote \""
+}{
+  "first" : "last", 
+  "second" : "three", 
+  "third" : "fields"
+}
@@ -0,0 +1 @@
+40000 true
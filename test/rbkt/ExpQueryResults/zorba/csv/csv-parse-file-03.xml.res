@@ -0,0 +1 @@
+19999 true EXTRA_VALUE
@@ -0,0 +1,2 @@
+<?xml version="1.0" encoding="UTF-8"?>
+<w v="C"/><w v="b"/><w v="a"/><w v="Á"/><w/>
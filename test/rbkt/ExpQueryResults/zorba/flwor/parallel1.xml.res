@@ -0,0 +1 @@
+284 11809583786 7 140 14 1015 21 3311
\ No newline at end of file
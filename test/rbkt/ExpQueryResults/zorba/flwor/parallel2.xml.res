@@ -0,0 +1 @@
+<r><d n="3">9</d><d n="1">1</d><d n="2">4</d></r>
\ No newline at end of file
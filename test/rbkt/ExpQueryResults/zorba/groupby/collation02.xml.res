@@ -0,0 +1,2 @@
+<?xml version="1.0" encoding="UTF-8"?>
+<group key="apple" count="1"/><group key="resume" count="3"/><group key="zebra" count="2"/>
@@ -0,0 +1 @@
+a c e b a c e
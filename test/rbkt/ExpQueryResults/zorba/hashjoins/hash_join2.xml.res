@@ -0,0 +1 @@
+true 13 a c e b f a c e b f a c e
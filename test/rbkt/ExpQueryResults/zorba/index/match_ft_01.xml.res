@@ -0,0 +1 @@
+<result><phrase>1</phrase><distance>1 3</distance><diacritics>4</diacritics><case>3</case><or>2 4</or><deleted>3</deleted></result>
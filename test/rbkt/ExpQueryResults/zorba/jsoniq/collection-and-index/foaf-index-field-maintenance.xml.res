@@ -0,0 +1 @@
+{ "kirk" : "unknown", "kirk-age" : 1, "picard" : "captain", "picard-old-age" : 0, "picard-new-age" : "Jean-Luc Picard" }
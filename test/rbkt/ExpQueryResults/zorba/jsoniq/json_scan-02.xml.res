@@ -0,0 +1 @@
+1 4 6
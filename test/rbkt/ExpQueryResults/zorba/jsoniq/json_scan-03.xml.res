@@ -0,0 +1 @@
+{ "k" : "a", "v" : [ 1, { "w" : null } ] } { "k" : "a", "v" : true }
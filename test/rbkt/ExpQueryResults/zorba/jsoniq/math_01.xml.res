@@ -1 +1 @@
-{ "pi" : 3.1415926535897931 }
+{ "pi" : 3.141592653589793 }
@@ -1,2 +1,2 @@
 <?xml version="1.0" encoding="UTF-8"?>
-16.674657798418629
\ No newline at end of file
+16.67465779841863
\ No newline at end of file
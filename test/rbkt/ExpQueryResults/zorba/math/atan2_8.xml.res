@@ -1,2 +1,2 @@
 <?xml version="1.0" encoding="UTF-8"?>
--3.1415926535897931
\ No newline at end of file
+-3.141592653589793
\ No newline at end of file
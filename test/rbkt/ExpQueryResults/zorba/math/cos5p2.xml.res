@@ -1,2 +1,2 @@
 <?xml version="1.0" encoding="UTF-8"?>
-6.1230317691118863E-17
\ No newline at end of file
+6.123031769111886E-17
\ No newline at end of file
@@ -1,2 +1,2 @@
 <?xml version="1.0" encoding="UTF-8"?>
-2.7182818284590451
\ No newline at end of file
+2.718281828459045
\ No newline at end of file
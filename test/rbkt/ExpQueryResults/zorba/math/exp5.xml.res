@@ -1,2 +1,2 @@
 <?xml version="1.0" encoding="UTF-8"?>
-7.3890560989306504
\ No newline at end of file
+7.38905609893065
\ No newline at end of file
@@ -1,2 +1,2 @@
 <?xml version="1.0" encoding="UTF-8"?>
-27.463915719843492
+27.46391571984349
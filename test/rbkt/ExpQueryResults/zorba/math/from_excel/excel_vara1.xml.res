@@ -1,2 +1,2 @@
 <?xml version="1.0" encoding="UTF-8"?>
-754.26666666666654
+754.2666666666665
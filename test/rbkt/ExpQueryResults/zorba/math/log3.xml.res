@@ -1,2 +1,2 @@
 <?xml version="1.0" encoding="UTF-8"?>
-9.1049798563183568
\ No newline at end of file
+9.104979856318357
\ No newline at end of file
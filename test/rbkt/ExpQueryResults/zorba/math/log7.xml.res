@@ -1,2 +1,2 @@
 <?xml version="1.0" encoding="UTF-8"?>
--6.9077552789821368
\ No newline at end of file
+-6.907755278982137
\ No newline at end of file
@@ -1 +1 @@
-1.4142135623730951 7.3890560989306504 0.6931471805599453 0.9092974268256817 -0.4161468365471424 -2.1850398632615189 0 0 0
+1.4142135623730951 7.38905609893065 0.6931471805599453 0.9092974268256817 -0.4161468365471424 -2.185039863261519 0 0 0
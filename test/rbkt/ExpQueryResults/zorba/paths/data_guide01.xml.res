@@ -0,0 +1 @@
+<result><dvds>0</dvds><titles>5</titles><names><name>Eve</name></names><none>0</none><twig>1</twig><twig-none>0</twig-none></result>
\ No newline at end of file
@@ -0,0 +1 @@
+<result><before>0 2 1</before><dvds><dvd id="d1"><title>Film</title></dvd></dvds><magazines>0</magazines><persons>0</persons><members><name>Eve</name></members><twig>1</twig></result>
\ No newline at end of file
@@ -0,0 +1 @@
+<result><titles><title>XQuery</title><title>XML</title></titles><authors>Ann Bob Cy Dee</authors><ids>s1 s2</ids><last><book id="b3" year="2012"><title>JSON</title><author>Dee</author></book></last><count>2</count></result>
\ No newline at end of file
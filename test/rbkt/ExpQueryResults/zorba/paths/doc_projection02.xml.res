@@ -0,0 +1 @@
+2,3 text,more 1
\ No newline at end of file
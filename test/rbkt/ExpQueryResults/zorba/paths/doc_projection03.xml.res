@@ -0,0 +1 @@
+b1 b2 m1 b3 m2
\ No newline at end of file
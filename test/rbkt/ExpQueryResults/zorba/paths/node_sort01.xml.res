@@ -0,0 +1 @@
+a1 a2 a3 a4 a5 a6 a7 a8 a9 a10 a11 a12 a1 b1 a2 b2 a3 b3 a4 b4 a5 b5 a6 b6 a7 b7 a8 b8 a9 b9 a10 b10 a11 b11 a12 b12 a1 a2 a3 a4 a5 a6 a7 a8 a9 a10 a11 a12 23 t1 t2 @3 t3 t4 @5 t5 t6 t7 @8 t8 t9 b10 @10 t10 b11 t11 b12 t12 r ax @x y r a10 b10 a11 b11 a12 b12
\ No newline at end of file
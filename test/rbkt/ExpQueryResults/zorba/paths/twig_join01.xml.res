@@ -0,0 +1 @@
+<r1>1 2 3</r1><r2>1 3</r2><r3>3</r3><r4>1 2 3 5</r4><r5>1,2,3 3</r5><r6>1 2 3</r6><r7>1 3</r7><r8>1,2,3 3</r8><r9>0</r9>
\ No newline at end of file
@@ -0,0 +1 @@
+1 2 | 1 3
\ No newline at end of file
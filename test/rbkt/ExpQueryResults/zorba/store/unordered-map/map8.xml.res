@@ -0,0 +1 @@
+9 500 0 9
\ No newline at end of file
@@ -0,0 +1 @@
+4000 4001 26
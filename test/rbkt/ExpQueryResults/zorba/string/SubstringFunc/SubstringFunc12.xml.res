@@ -0,0 +1 @@
+é1😀é2😀 0😀  cdef é1 😀
@@ -0,0 +1 @@
+1 6 0 5 1 true 2 true 17 true false α;β|γ x;;y end; true true
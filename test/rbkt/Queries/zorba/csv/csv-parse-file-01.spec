@@ -0,0 +1,4 @@
+Serialization: indent=yes
+Args:
+-x
+rbktPath:=$RBKT_SRC_DIR
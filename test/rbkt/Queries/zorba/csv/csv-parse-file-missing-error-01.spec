@@ -0,0 +1,5 @@
+Error: http://zorba.io/modules/json-csv:MISSING_VALUE
+Serialization: indent=yes
+Args:
+-x
+rbktPath:=$RBKT_SRC_DIR
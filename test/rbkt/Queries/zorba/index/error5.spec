@@ -0,0 +1 @@
+Error: http://zorba.io/errors:ZDST0027
@@ -0,0 +1 @@
+Serialization: method=json
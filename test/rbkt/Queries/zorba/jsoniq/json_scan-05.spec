@@ -0,0 +1 @@
+Error: http://www.w3.org/2005/xqt-errors:XPTY0004
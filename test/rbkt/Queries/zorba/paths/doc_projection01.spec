@@ -0,0 +1,3 @@
+Args: 
+-x
+input-context:=$RBKT_SRC_DIR/Queries/zorba/paths/doc_projection.xml
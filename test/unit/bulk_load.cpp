@@ -0,0 +1,196 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <fstream>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <zorba/collection.h>
+#include <zorba/collection_manager.h>
+#include <zorba/item_factory.h>
+#include <zorba/item_sequence.h>
+#include <zorba/iterator.h>
+#include <zorba/store_manager.h>
+#include <zorba/xmldatamanager.h>
+#include <zorba/zorba.h>
+#include <zorba/zorba_exception.h>
+
+using namespace zorba;
+
+static const int NUM_FILES = 40;
+
+/**
+ * Writes NUM_FILES small documents (every fifth one as JSON) and returns
+ * their names.
+ */
+static void
+write_files(std::vector<String>& aFiles)
+{
+  for (int i = 0; i < NUM_FILES; ++i)
+  {
+    std::ostringstream lName;
+    lName << "bulk_load_" << i << (i % 5 == 4 ? ".json" : ".xml");
+
+    std::ofstream lOut(lName.str().c_str());
+    if (i % 5 == 4)
+      lOut << "{ \"doc\" : " << i << " }";
+    else
+      lOut << "<doc><n>" << i << "</n></doc>";
+
+    aFiles.push_back(lName.str());
+  }
+}
+
+/**
+ * Deletes the files written by write_files().
+ */
+static void
+remove_files(const std::vector<String>& aFiles)
+{
+  for (size_t i = 0; i < aFiles.size(); ++i)
+    std::remove(aFiles[i].c_str());
+}
+
+/**
+ * The documents must be inserted in the order of the files, whatever the
+ * number of parsing threads.
+ */
+bool
+bulk_load1(Zorba* z,
+           const std::vector<String>& lFiles,
+           unsigned int aNumThreads)
+{
+  try
+  {
+    CollectionManager* lColMgr = z->getXmlDataManager()->getCollectionManager();
+    Item lName = z->getItemFactory()->createQName("http://www.zorba.io/", "bulk");
+
+    lColMgr->createCollection(lName);
+    Collection_t lColl = lColMgr->getCollection(lName);
+
+    BulkLoadStats lStats;
+    lColl->loadDocumentsLast(lFiles, aNumThreads, &lStats);
+
+    std::cout << lStats.theNumDocuments << " documents, "
+              << lStats.theNumBytes << " bytes, "
+              << lStats.getDocumentsPerSecond() << " docs/s, "
+              << lStats.getBytesPerSecond() << " bytes/s" << std::endl;
+
+    if (lStats.theNumDocuments != NUM_FILES)
+      return false;
+
+    ItemSequence_t lContents = lColl->contents();
+    Iterator_t lIter = lContents->getIterator();
+    lIter->open();
+
+    Item lDoc;
+    int i = 0;
+    while (lIter->next(lDoc))
+    {
+      std::ostringstream lExpected;
+      lExpected << i;
+      String lValue = (lDoc.isJSONItem() ?
+                       lDoc.getObjectValue("doc").getStringValue() :
+                       lDoc.getStringValue());
+
+      if (lValue != lExpected.str())
+      {
+        std::cerr << "unexpected item at position " << i << ": "
+                  << lValue << std::endl;
+        return false;
+      }
+      ++i;
+    }
+    lIter->close();
+
+    lColMgr->deleteCollection(lName);
+
+    return i == NUM_FILES;
+  }
+  catch (ZorbaException const& e)
+  {
+    std::cerr << e << std::endl;
+  }
+  return false;
+}
+
+/**
+ * A missing file makes the whole load fail and nothing is inserted.
+ */
+bool
+bulk_load2(Zorba* z, std::vector<String> lFiles)
+{
+  lFiles.insert(lFiles.begin() + 10, "bulk_load_missing.xml");
+
+  CollectionManager* lColMgr = z->getXmlDataManager()->getCollectionManager();
+  Item lName = z->getItemFactory()->createQName("http://www.zorba.io/", "bulk2");
+
+  lColMgr->createCollection(lName);
+  Collection_t lColl = lColMgr->getCollection(lName);
+
+  bool lFailed = false;
+  try
+  {
+    lColl->loadDocumentsLast(lFiles, 4);
+  }
+  catch (ZorbaException const& e)
+  {
+    std::cout << "expected error: " << e << std::endl;
+    lFailed = true;
+  }
+
+  ItemSequence_t lContents = lColl->contents();
+  Iterator_t lIter = lContents->getIterator();
+  lIter->open();
+  Item lDoc;
+  bool lEmpty = !lIter->next(lDoc);
+  lIter->close();
+
+  lColMgr->deleteCollection(lName);
+
+  return lFailed && lEmpty;
+}
+
+int
+bulk_load(int argc, char* argv[])
+{
+  void* store = StoreManager::getStore();
+  Zorba* z = Zorba::getInstance(store);
+
+  std::vector<String> lFiles;
+  write_files(lFiles);
+
+  int lResult = 0;
+
+  std::cout << "executing example 1 (1 thread)" << std::endl;
+  if (!bulk_load1(z, lFiles, 1))
+    lResult = 1;
+
+  std::cout << "executing example 1 (4 threads)" << std::endl;
+  if (!lResult && !bulk_load1(z, lFiles, 4))
+    lResult = 2;
+
+  std::cout << "executing example 2" << std::endl;
+  if (!lResult && !bulk_load2(z, lFiles))
+    lResult = 3;
+
+  remove_files(lFiles);
+
+  return lResult;
+}
+
+/* vim:set et sw=2 ts=2: */
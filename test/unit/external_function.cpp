@@ -151,6 +151,31 @@ public:
   }
 };
 
+std::vector<size_t> lBatchSizes;
+
+class MyBatchExternalFunction : public BatchExternalFunction
+{
+public:
+  String getURI() const { return "http://www.zorba-xquery.com/m"; }
+
+  String getLocalName() const { return "bar6"; }
+
+  size_t getBatchSize() const { return 4; }
+
+  void evaluateBatch(
+        const ArgumentTuples_t& tuples,
+        std::vector<Item>& results) const
+  {
+    lBatchSizes.push_back(tuples.size());
+
+    for (size_t i = 0; i < tuples.size(); ++i)
+    {
+      results.push_back(Zorba::getInstance(0)->getItemFactory()->
+                        createInteger(2 * tuples[i][0].getLongValue()));
+    }
+  }
+};
+
 class MyExternalModule : public ExternalModule
 {
 protected:
@@ -159,6 +184,7 @@ protected:
   MySimpleExternalFunction3          bar3;
   MySimpleExternalFunction4          bar4;
   MySimpleExternalFunction5          bar5;
+  MyBatchExternalFunction            bar6;
 
 public:
   String getURI() const { return "http://www.zorba-xquery.com/m"; }
@@ -173,6 +199,8 @@ public:
         return const_cast<MySimpleExternalFunction4*>(&bar4);
     else if (aLocalname == "bar5")
         return const_cast<MySimpleExternalFunction5*>(&bar5);
+    else if (aLocalname == "bar6")
+        return const_cast<MyBatchExternalFunction*>(&bar6);
     else
         return const_cast<MySimpleExternalFunction2*>(&bar2);
   }
@@ -431,6 +459,53 @@ external_function_test_5(Zorba* aZorba)
   return false;
 }
 
+// calls to a batch external function in the return clause of a FLWOR are
+// evaluated in batches of getBatchSize() calls
+bool
+external_function_test_6(Zorba* aZorba)
+{
+  try 
+  {
+    std::ifstream lIn("ext_main5.xq");
+    assert(lIn.good());
+    MyExternalModule lMod;
+
+    StaticContext_t lSctx = aZorba->createStaticContext();
+    lSctx->registerModule(&lMod);
+
+    {
+      XQuery_t lQuery = aZorba->compileQuery(lIn, lSctx);
+
+      std::vector<long long> lResults;
+      Iterator_t lIter = lQuery->iterator();
+      Item lItem;
+      lIter->open();
+      while (lIter->next(lItem))
+        lResults.push_back(lItem.getLongValue());
+      lIter->close();
+
+      if (lResults.size() != 5 || lResults[0] != 4 || lResults[4] != 20)
+        return false;
+    }
+
+    // 5 calls, in a batch of 4 and a batch of 1
+    return (lBatchSizes.size() == 2 &&
+            lBatchSizes[0] == 4 &&
+            lBatchSizes[1] == 1);
+  } 
+  catch (XQueryException& qe) 
+  {
+    std::cerr << qe << std::endl;
+    return false;
+  }
+  catch (ZorbaException& e)
+  {
+    std::cerr << e << std::endl;
+    return false;
+  }
+  return true;
+}
+
 int
 external_function(int argc, char* argv[]) 
 {
@@ -467,6 +542,12 @@ external_function(int argc, char* argv[])
     return 4;
   }
 
+  std::cout << "executing external_function_test_6" << std::endl;
+  if (!external_function_test_6(lZorba))
+  {
+    return 6;
+  }
+
 
   lZorba->shutdown();
   zorba::StoreManager::shutdownStore(lStore);
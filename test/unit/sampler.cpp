@@ -0,0 +1,189 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <zorba/item_factory.h>
+#include <zorba/properties.h>
+#include <zorba/store_manager.h>
+#include <zorba/zorba.h>
+#include <zorba/zorba_exception.h>
+
+using namespace zorba;
+
+/**
+ * Runs a query that takes long enough to be sampled a number of times and
+ * returns what the sampler printed to the debug stream.  The bound of the
+ * loop is external, so that the query is not folded at compile time.
+ */
+static std::string
+run_sampled(Zorba* z, Zorba_sample_format_t aFormat)
+{
+  XQuery_t lQuery = z->compileQuery(
+    "declare variable $n as xs:integer external;\n"
+    "sum(for $i in 1 to $n return string-length(string($i * $i)))");
+
+  lQuery->getDynamicContext()->setVariable(
+    "n", z->getItemFactory()->createInteger(2000000));
+  lQuery->setSampling(aFormat, 1);
+
+  std::ostringstream lSamples;
+  Properties::instance().setDebugStream(lSamples);
+
+  try
+  {
+    std::ostringstream lResult;
+    lQuery->execute(lResult);
+  }
+  catch (...)
+  {
+    Properties::instance().setDebugStream(std::cout);
+    throw;
+  }
+  Properties::instance().setDebugStream(std::cout);
+
+  return lSamples.str();
+}
+
+/**
+ * Every line of the collapsed stacks is a ';'-separated list of frames,
+ * followed by a space and a positive number of samples.
+ */
+bool
+sampler1(Zorba* z)
+{
+  std::string const lSamples = run_sampled(z, SAMPLE_FORMAT_COLLAPSED);
+  std::cout << lSamples;
+
+  std::istringstream lIn(lSamples);
+  std::string lLine;
+  int lNumLines = 0;
+
+  while (std::getline(lIn, lLine))
+  {
+    std::string::size_type const lSpace = lLine.rfind(' ');
+    if (lSpace == std::string::npos || lSpace == 0)
+      return false;
+
+    std::istringstream lCount(lLine.substr(lSpace + 1));
+    unsigned long lNum = 0;
+    if (!(lCount >> lNum) || !lCount.eof() || lNum == 0)
+      return false;
+
+    ++lNumLines;
+  }
+
+  return lNumLines > 0;
+}
+
+/**
+ * The table starts with the number of samples and a header, and has one row
+ * of four times and an iterator per sampled iterator.
+ */
+bool
+sampler2(Zorba* z)
+{
+  std::string const lSamples = run_sampled(z, SAMPLE_FORMAT_TABLE);
+  std::cout << lSamples;
+
+  std::istringstream lIn(lSamples);
+  std::string lLine;
+
+  unsigned long lNumSamples = 0;
+  std::string lTaken;
+  if (!std::getline(lIn, lLine) ||
+      !(std::istringstream(lLine) >> lNumSamples >> lTaken) ||
+      lNumSamples == 0 || lTaken != "samples")
+    return false;
+
+  if (!std::getline(lIn, lLine) || lLine.find("self ms") == std::string::npos)
+    return false;
+
+  int lNumRows = 0;
+  while (std::getline(lIn, lLine))
+  {
+    std::istringstream lRow(lLine);
+    double lSelf, lSelfPct, lTotal, lTotalPct;
+    std::string lName;
+    if (!(lRow >> lSelf >> lSelfPct >> lTotal >> lTotalPct >> lName) ||
+        lSelf > lTotal || lTotalPct > 100.0)
+      return false;
+
+    ++lNumRows;
+  }
+
+  return lNumRows > 0;
+}
+
+/**
+ * The Chrome trace must parse as JSON and consist of "complete" events.
+ */
+bool
+sampler3(Zorba* z)
+{
+  std::string const lSamples = run_sampled(z, SAMPLE_FORMAT_TRACE);
+
+  try
+  {
+    XQuery_t lCheck = z->compileQuery(
+      "declare variable $trace as xs:string external;\n"
+      "let $events := jn:members(jn:parse-json($trace)(\"traceEvents\"))\n"
+      "return exists($events) and\n"
+      "  (every $e in $events satisfies\n"
+      "     $e(\"ph\") eq \"X\" and\n"
+      "     $e(\"name\") instance of xs:string and\n"
+      "     $e(\"ts\") instance of xs:integer and\n"
+      "     $e(\"dur\") instance of xs:integer)");
+
+    lCheck->getDynamicContext()->setVariable(
+      "trace", z->getItemFactory()->createString(lSamples));
+
+    std::ostringstream lResult;
+    lCheck->execute(lResult);
+    std::cout << lResult.str() << std::endl;
+
+    return lResult.str().find("true") != std::string::npos;
+  }
+  catch (ZorbaException const& e)
+  {
+    std::cerr << e << std::endl << lSamples << std::endl;
+  }
+  return false;
+}
+
+int
+sampler(int argc, char* argv[])
+{
+  void* store = StoreManager::getStore();
+  Zorba* z = Zorba::getInstance(store);
+
+  std::cout << "executing example 1 (collapsed)" << std::endl;
+  if (!sampler1(z))
+    return 1;
+
+  std::cout << "executing example 2 (table)" << std::endl;
+  if (!sampler2(z))
+    return 2;
+
+  std::cout << "executing example 3 (trace)" << std::endl;
+  if (!sampler3(z))
+    return 3;
+
+  return 0;
+}
+
+/* vim:set et sw=2 ts=2: */
@@ -16,12 +16,15 @@
 
 #include <vector>
 #include <iostream>
+#include <sstream>
 #include <cassert>
 
 #include <zorba/zorba.h>
 #include <zorba/store_manager.h>
 #include <zorba/audit.h>
 #include <zorba/audit_scoped.h>
+#include <zorba/diagnostic_list.h>
+#include <zorba/xquery_exception.h>
 
 bool
 test_audit_1(zorba::Zorba* aZorba)
@@ -98,6 +101,77 @@ test_audit_2(zorba::Zorba* aZorba)
   return true;
 }
 
+bool
+test_audit_3(zorba::Zorba* aZorba)
+{
+  zorba::audit::Provider* lAuditProvider = aZorba->getAuditProvider();
+  zorba::audit::Configuration* config = lAuditProvider->createConfiguration();
+  std::vector<zorba::String> property_names;
+  zorba::audit::Configuration::getPropertyNames(property_names);
+
+  bool lIsStatic;
+  lIsStatic = zorba::audit::Configuration::enableProperty(config, property_names,
+                                                          "xquery/execution/memory-peak");
+  assert(lIsStatic);
+  lIsStatic = zorba::audit::Configuration::enableProperty(config, property_names,
+                                                          "xquery/execution/memory-allocated");
+  assert(lIsStatic);
+
+  zorba::audit::Event* event = lAuditProvider->createEvent(config);
+
+  zorba::XQuery_t query = aZorba->createQuery();
+  zorba::StaticContext_t lStaticContext = aZorba->createStaticContext();
+
+  lStaticContext->setAuditEvent(event);
+
+  Zorba_CompilerHints lHints;
+  query->compile("for $i in 1 to 1000 order by -$i return <a>{$i}</a>",
+                 lStaticContext, lHints);
+  std::ostringstream lResult;
+  query->execute(lResult);
+
+  bool lSuccess = true;
+
+  if (event->size() != 1) {
+    lSuccess = false;
+  } else {
+    // one record with the memory counters of the execution
+    const zorba::audit::Record* lRecord = event->at(0);
+    assert(lRecord->size() == 2);
+    std::cerr << *event << std::endl;
+  }
+
+  if (query->getMemoryPeak() == 0 ||
+      query->getMemoryAllocated() < query->getMemoryPeak())
+    lSuccess = false;
+
+  aZorba->getAuditProvider()->submitEvent(event);
+  aZorba->getAuditProvider()->destroyConfiguration(config);
+
+  return lSuccess;
+}
+
+bool
+test_audit_4(zorba::Zorba* aZorba)
+{
+  // the sort of the flwor must exceed the memory limit of the query
+  zorba::XQuery_t query = aZorba->compileQuery(
+    "for $i in 1 to 100000 order by -$i return $i");
+  query->setMemoryAccounting(true, 10000);
+
+  try {
+    std::ostringstream lResult;
+    query->execute(lResult);
+  }
+  catch (zorba::XQueryException& qe) {
+    std::cerr << qe << std::endl;
+    return qe.diagnostic() == zorba::zerr::ZXQP0067_MEMORY_LIMIT_EXCEEDED &&
+           query->getMemoryPeak() > 10000;
+  }
+
+  return false;
+}
+
 int
 test_audit(int argc, char* argv[])
 {
@@ -114,6 +188,16 @@ test_audit(int argc, char* argv[])
     return 2;
   }
 
+  if (!test_audit_3(lZorbaInstance))
+  {
+    return 3;
+  }
+
+  if (!test_audit_4(lZorbaInstance))
+  {
+    return 4;
+  }
+
   return 0;
 }
 /* vim:set et sw=2 ts=2: */
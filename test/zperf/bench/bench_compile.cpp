@@ -0,0 +1,141 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks of the query parser and compiler.
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <zorba/xquery.h>
+
+#include "benchmark.h"
+
+using namespace std;
+using namespace zorba;
+using namespace zorba::bench;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @return Returns the text of the XMark queries q1.xq through q20.xq.
+ */
+static vector<string> const& xmark_queries() {
+  static vector<string> queries;
+  if ( queries.empty() ) {
+    for ( int i = 1; i <= 20; ++i ) {
+      ostringstream path;
+      path << ZORBA_BENCH_XMARK_DIR << "/q" << i << ".xq";
+      ifstream is( path.str().c_str() );
+      if ( !is )
+        throw runtime_error( '"' + path.str() + "\": can not open query" );
+      ostringstream text;
+      text << is.rdbuf();
+      queries.push_back( text.str() );
+    }
+  }
+  return queries;
+}
+
+/**
+ * @return Returns a large generated query: a library of functions and a FLWOR
+ * expression that calls each of them.
+ */
+static string const& generated_query() {
+  static string query;
+  if ( query.empty() ) {
+    int const n = 200;
+    ostringstream oss;
+    oss << "declare namespace b = \"http://zorba.io/bench\";\n";
+    for ( int i = 0; i < n; ++i )
+      oss << "declare function b:f" << i << "( $x as xs:integer ) as xs:integer"
+          << " { if ( $x mod " << i + 2 << " eq 0 ) then $x * " << i
+          << " else $x + " << i << " };\n";
+    oss << "for $i in 1 to 100\n"
+           "let $v := (";
+    for ( int i = 0; i < n; ++i )
+      oss << (i ? ", " : "") << "b:f" << i << "( $i )";
+    oss << ")\n"
+           "where sum( $v ) gt 0\n"
+           "order by $i descending\n"
+           "return <r i=\"{ $i }\">{ count( $v ) }</r>\n";
+    query = oss.str();
+  }
+  return query;
+}
+
+static size_t total_size( vector<string> const &queries ) {
+  size_t size = 0;
+  for ( vector<string>::const_iterator q = queries.begin(); q != queries.end();
+        ++q )
+    size += q->size();
+  return size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ZORBA_BENCHMARK( "parse.xmark" ) {
+  Zorba *const zorba = state.zorba();
+  vector<string> const &queries = xmark_queries();
+  while ( state.keepRunning() ) {
+    for ( vector<string>::const_iterator q = queries.begin();
+          q != queries.end(); ++q ) {
+      XQuery_t const query( zorba->createQuery() );
+      istringstream is( *q );
+      query->parse( is );
+    }
+  }
+  state.setItems( queries.size() );
+  state.setBytes( total_size( queries ) );
+}
+
+ZORBA_BENCHMARK( "parse.generated" ) {
+  Zorba *const zorba = state.zorba();
+  string const &text = generated_query();
+  while ( state.keepRunning() ) {
+    XQuery_t const query( zorba->createQuery() );
+    istringstream is( text );
+    query->parse( is );
+  }
+  state.setBytes( text.size() );
+}
+
+ZORBA_BENCHMARK( "compile.xmark" ) {
+  Zorba *const zorba = state.zorba();
+  vector<string> const &queries = xmark_queries();
+  while ( state.keepRunning() ) {
+    for ( vector<string>::const_iterator q = queries.begin();
+          q != queries.end(); ++q ) {
+      XQuery_t const query( zorba->createQuery() );
+      query->compile( String( *q ) );
+    }
+  }
+  state.setItems( queries.size() );
+}
+
+ZORBA_BENCHMARK( "compile.generated" ) {
+  Zorba *const zorba = state.zorba();
+  String const text( generated_query() );
+  while ( state.keepRunning() ) {
+    XQuery_t const query( zorba->createQuery() );
+    query->compile( text );
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Throughput benchmarks of one query run by several threads at once, in the
+// style of test/unit/multithread_stress_test.cpp: every thread queries the
+// same loaded document with its own parameter.  The benchmarks differ only in
+// how a thread gets its own instance of the query.  Each iteration starts
+// THREADS threads that run the query RUNS_PER_THREAD times each.
+
+#include <zorba/config.h>
+
+#ifndef ZORBA_FOR_ONE_THREAD_ONLY
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <zorba/dynamic_context.h>
+#include <zorba/item_factory.h>
+#include <zorba/xquery.h>
+#include <zorba/zorba_exception.h>
+
+#include "benchmark.h"
+#include "data.h"
+
+using namespace std;
+using namespace zorba;
+using namespace zorba::bench;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static unsigned const THREADS = 4;
+static unsigned const RUNS_PER_THREAD = 8;
+
+static char const QUERY[] =
+  "declare variable $doc as document-node() external;\n"
+  "declare variable $g as xs:integer external;\n"
+  "count( $doc/records/record[ @group eq concat( \"g\", $g ) ] )";
+
+/**
+ * Runs the query once.
+ *
+ * @param zorba The Zorba instance.
+ * @param query The compiled query shared by all threads.
+ * @param doc The document to query.
+ * @param run The number of the run, from which the parameter is derived.
+ */
+typedef void (*task_type)( Zorba *zorba, XQuery const *query, Item const &doc,
+                           unsigned run );
+
+static void bind( DynamicContext *dctx, Zorba *zorba, Item const &doc,
+                  unsigned run ) {
+  dctx->setVariable( "doc", doc );
+  dctx->setVariable( "g", zorba->getItemFactory()->createInteger( run % 50 ) );
+}
+
+static void compile_task( Zorba *zorba, XQuery const*, Item const &doc,
+                          unsigned run ) {
+  XQuery_t const query( zorba->compileQuery( QUERY ) );
+  bind( query->getDynamicContext(), zorba, doc, run );
+  ostringstream oss;
+  query->execute( oss );
+}
+
+static void clone_task( Zorba *zorba, XQuery const *query, Item const &doc,
+                        unsigned run ) {
+  XQuery_t const clone( query->clone() );
+  bind( clone->getDynamicContext(), zorba, doc, run );
+  ostringstream oss;
+  clone->execute( oss );
+}
+
+static void execution_task( Zorba *zorba, XQuery const *query,
+                            Item const &doc, unsigned run ) {
+  XQueryExecution_t const execution( query->createExecution() );
+  bind( execution->getDynamicContext(), zorba, doc, run );
+  ostringstream oss;
+  execution->execute( oss );
+}
+
+static void worker( task_type task, Zorba *zorba, XQuery const *query,
+                    Item const *doc, unsigned t, string *error ) {
+  try {
+    for ( unsigned r = 0; r < RUNS_PER_THREAD; ++r )
+      task( zorba, query, *doc, t * RUNS_PER_THREAD + r );
+  }
+  catch ( std::exception const &e ) {
+    *error = e.what();
+  }
+}
+
+static void run_concurrent( State &state, task_type task ) {
+  Zorba *const zorba = state.zorba();
+  Item const doc( parse_xml_data( zorba ) );
+  XQuery_t const query( zorba->compileQuery( QUERY ) );
+
+  while ( state.keepRunning() ) {
+    vector<thread> threads;
+    vector<string> errors( THREADS );
+    for ( unsigned t = 0; t < THREADS; ++t )
+      threads.push_back(
+        thread( worker, task, zorba, query.get(), &doc, t, &errors[t] )
+      );
+    for ( unsigned t = 0; t < THREADS; ++t )
+      threads[t].join();
+    for ( unsigned t = 0; t < THREADS; ++t )
+      if ( !errors[t].empty() )
+        throw runtime_error( errors[t] );
+  }
+  state.setItems( THREADS * RUNS_PER_THREAD );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Every run compiles its own query.
+ZORBA_BENCHMARK( "concurrent.compile" ) {
+  run_concurrent( state, compile_task );
+}
+
+// Every run clones the shared query (see XQuery::clone()).
+ZORBA_BENCHMARK( "concurrent.clone" ) {
+  run_concurrent( state, clone_task );
+}
+
+// Every run creates an execution of the shared query (see
+// XQuery::createExecution()).
+ZORBA_BENCHMARK( "concurrent.execution" ) {
+  run_concurrent( state, execution_task );
+}
+
+#endif /* ZORBA_FOR_ONE_THREAD_ONLY */
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
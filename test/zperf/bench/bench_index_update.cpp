@@ -0,0 +1,92 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks of small updates on a JSON collection with five automatically
+// maintained indexes (see index_update.xqlib).  Each iteration applies one
+// update to one object of the collection.
+
+#include <sstream>
+#include <string>
+
+#include <zorba/dynamic_context.h>
+#include <zorba/item_factory.h>
+#include <zorba/xquery.h>
+
+#include "benchmark.h"
+
+using namespace std;
+using namespace zorba;
+using namespace zorba::bench;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static unsigned const NUM_DOCS = 10000;
+
+static string prolog() {
+  return string( "import module namespace b = "
+                 "\"http://zorba.io/bench/index-update\" at \"file://" )
+         + ZORBA_BENCH_DIR + "/index_update.xqlib\";\n";
+}
+
+static void run_sequential( Zorba *zorba, string const &body ) {
+  XQuery_t const query( zorba->createQuery() );
+  query->compile( String( prolog() + body ) );
+  ostringstream oss;
+  query->execute( oss );
+}
+
+static void run_update( State &state, char const *function ) {
+  Zorba *const zorba = state.zorba();
+  ostringstream setup;
+  setup << "b:setup( " << NUM_DOCS << " )";
+  run_sequential( zorba, setup.str() );
+
+  XQuery_t const query( zorba->createQuery() );
+  query->compile( String(
+    prolog() +
+    "declare variable $i as xs:integer external;\n" +
+    function + "( $i )"
+  ) );
+  DynamicContext *const dctx = query->getDynamicContext();
+  ItemFactory *const factory = zorba->getItemFactory();
+
+  try {
+    unsigned long i = 0;
+    while ( state.keepRunning() ) {
+      dctx->setVariable( "i", factory->createInteger( i++ % NUM_DOCS + 1 ) );
+      query->execute();
+    }
+    state.setItems( 1 );
+  }
+  catch ( ... ) {
+    run_sequential( zorba, "b:teardown()" );
+    throw;
+  }
+  run_sequential( zorba, "b:teardown()" );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ZORBA_BENCHMARK( "index.update.unindexed-field" ) {
+  run_update( state, "b:visit" );
+}
+
+ZORBA_BENCHMARK( "index.update.indexed-field" ) {
+  run_update( state, "b:reprice" );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks of a FLWOR that filters the records of json_data() as they are
+// parsed by jn:parse-json().  The "full" variants compile the query with the
+// JSON scan turned off (see Properties::setJSONScan()), so every record is
+// built in full before the where clause looks at it.
+
+#include <zorba/dynamic_context.h>
+#include <zorba/item_factory.h>
+#include <zorba/iterator.h>
+#include <zorba/properties.h>
+#include <zorba/xquery.h>
+
+#include "benchmark.h"
+#include "data.h"
+
+using namespace zorba;
+using namespace zorba::bench;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static char const QUERY[] =
+  "declare variable $text as xs:string external;\n"
+  "for $o in jn:parse-json( $text, {\n"
+  "  \"jsoniq-multiple-top-level-items\" : true(),\n"
+  "  \"jsoniq-strip-top-level-array\" : true()\n"
+  "} )\n"
+  "where $o.group eq \"g7\"\n"
+  "return $o.price";
+
+static void run_scan( State &state, bool scan ) {
+  Zorba *const zorba = state.zorba();
+  Properties &props = Properties::instance();
+  bool const old_scan = props.getJSONScan();
+
+  props.setJSONScan( scan );
+  XQuery_t const query( zorba->createQuery() );
+  try {
+    query->compile( QUERY );
+  }
+  catch ( ... ) {
+    props.setJSONScan( old_scan );
+    throw;
+  }
+  props.setJSONScan( old_scan );
+
+  query->getDynamicContext()->setVariable(
+    "text", zorba->getItemFactory()->createString( json_data() )
+  );
+
+  unsigned long long n = 0;
+  while ( state.keepRunning() ) {
+    n = 0;
+    Iterator_t const it( query->iterator() );
+    Item item;
+    it->open();
+    while ( it->next( item ) )
+      ++n;
+    it->close();
+  }
+  state.setItems( n );
+  state.setBytes( json_data().size() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ZORBA_BENCHMARK( "json.scan.filter" ) {
+  run_scan( state, true );
+}
+
+ZORBA_BENCHMARK( "json.scan.filter.full" ) {
+  run_scan( state, false );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
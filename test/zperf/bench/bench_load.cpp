@@ -0,0 +1,44 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks of loading documents into the store.
+
+#include "benchmark.h"
+#include "data.h"
+
+using namespace zorba;
+using namespace zorba::bench;
+
+///////////////////////////////////////////////////////////////////////////////
+
+ZORBA_BENCHMARK( "load.xml" ) {
+  Zorba *const zorba = state.zorba();
+  xml_data();
+  while ( state.keepRunning() )
+    parse_xml_data( zorba );
+  state.setBytes( xml_data().size() );
+}
+
+ZORBA_BENCHMARK( "load.json" ) {
+  Zorba *const zorba = state.zorba();
+  json_data();
+  while ( state.keepRunning() )
+    parse_json_data( zorba );
+  state.setBytes( json_data().size() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
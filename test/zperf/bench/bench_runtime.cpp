@@ -0,0 +1,135 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks of the iterators of compiled queries.  Each query is compiled
+// once; only the evaluation of its result is timed.
+
+#include <zorba/dynamic_context.h>
+#include <zorba/iterator.h>
+#include <zorba/xquery.h>
+
+#include "benchmark.h"
+#include "data.h"
+
+using namespace zorba;
+using namespace zorba::bench;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Compiles the given query and binds the external variables \c $doc and
+ * \c $json to the parsed xml_data() and json_data().
+ */
+static XQuery_t prepare( Zorba *zorba, char const *text ) {
+  XQuery_t query( zorba->createQuery() );
+  query->compile( text );
+  DynamicContext *const dctx = query->getDynamicContext();
+  dctx->setVariable( "doc", parse_xml_data( zorba ) );
+  dctx->setVariable( "json", parse_json_data( zorba ) );
+  return query;
+}
+
+/**
+ * Evaluates the query and discards its result.
+ *
+ * @return Returns the number of items in the result.
+ */
+static unsigned long long drain( XQuery_t const &query ) {
+  unsigned long long n = 0;
+  Iterator_t const it( query->iterator() );
+  Item item;
+  it->open();
+  while ( it->next( item ) )
+    ++n;
+  it->close();
+  return n;
+}
+
+static void run_query( State &state, char const *text ) {
+  XQuery_t const query( prepare( state.zorba(), text ) );
+  unsigned long long n = 0;
+  while ( state.keepRunning() )
+    n = drain( query );
+  state.setItems( n );
+}
+
+#define PROLOG                                                    \
+  "declare variable $doc as document-node() external;\n"         \
+  "declare variable $json as array() external;\n"
+
+///////////////////////////////////////////////////////////////////////////////
+
+ZORBA_BENCHMARK( "execute.flwor" ) {
+  run_query( state, PROLOG
+    "for $i in 1 to 100000\n"
+    "let $j := $i * 2\n"
+    "where $j mod 3 eq 0\n"
+    "return $j"
+  );
+}
+
+ZORBA_BENCHMARK( "execute.flwor.json" ) {
+  run_query( state, PROLOG
+    "for $r in jn:members( $json )\n"
+    "where $r(\"price\") gt 500\n"
+    "return $r(\"id\")"
+  );
+}
+
+ZORBA_BENCHMARK( "execute.groupby" ) {
+  run_query( state, PROLOG
+    "for $r in $doc/records/record\n"
+    "group by $g := string( $r/@group )\n"
+    "return <group name=\"{ $g }\">{ sum( $r/price ) }</group>"
+  );
+}
+
+ZORBA_BENCHMARK( "execute.orderby" ) {
+  run_query( state, PROLOG
+    "for $r in $doc/records/record\n"
+    "order by xs:decimal( $r/price ) descending, string( $r/name )\n"
+    "return string( $r/@id )"
+  );
+}
+
+ZORBA_BENCHMARK( "execute.path" ) {
+  run_query( state, PROLOG
+    "$doc/records/record[ @group eq \"g7\" ]/name, $doc//price"
+  );
+}
+
+ZORBA_BENCHMARK( "execute.path.descendant" ) {
+  run_query( state, PROLOG
+    "$doc//record[ name eq \"alpha bravo\" ]/@id"
+  );
+}
+
+// The optimizer evaluates the inner FLWOR with a temporary hash index on
+// the group of the records, which is built once and probed once per group.
+ZORBA_BENCHMARK( "index.hashjoin" ) {
+  run_query( state, PROLOG
+    "for $g in 0 to 49\n"
+    "let $k := concat( \"g\", $g )\n"
+    "return count(\n"
+    "  for $r in $doc/records/record\n"
+    "  where string( $r/@group ) eq $k\n"
+    "  return $r\n"
+    ")"
+  );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
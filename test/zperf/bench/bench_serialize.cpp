@@ -0,0 +1,76 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks of the serializer.  The queries only return an already loaded
+// document, so the time is spent in the serializer.
+
+#include <sstream>
+
+#include <zorba/dynamic_context.h>
+#include <zorba/options.h>
+#include <zorba/xquery.h>
+
+#include "benchmark.h"
+#include "data.h"
+
+using namespace std;
+using namespace zorba;
+using namespace zorba::bench;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void run_serialize( State &state, char const *text, Item const &value,
+                           Zorba_serialization_method_t method ) {
+  XQuery_t const query( state.zorba()->createQuery() );
+  query->compile( text );
+  query->getDynamicContext()->setVariable( "value", value );
+
+  Zorba_SerializerOptions_t options;
+  options.ser_method = method;
+
+  size_t size = 0;
+  while ( state.keepRunning() ) {
+    ostringstream oss;
+    query->execute( oss, &options );
+    state.pause();
+    size = oss.str().size();
+    state.resume();
+  }
+  state.setBytes( size );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ZORBA_BENCHMARK( "serialize.xml" ) {
+  run_serialize(
+    state,
+    "declare variable $value external; $value",
+    parse_xml_data( state.zorba() ),
+    ZORBA_SERIALIZATION_METHOD_XML
+  );
+}
+
+ZORBA_BENCHMARK( "serialize.json" ) {
+  run_serialize(
+    state,
+    "declare variable $value external; $value",
+    parse_json_data( state.zorba() ),
+    ZORBA_SERIALIZATION_METHOD_JSON
+  );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,409 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include <zorba/item.h>
+#include <zorba/item_sequence.h>
+#include <zorba/iterator.h>
+#include <zorba/jsondatamanager.h>
+#include <zorba/zorba_exception.h>
+
+#include "benchmark.h"
+
+using namespace std;
+
+namespace zorba {
+namespace bench {
+
+// The calibration never runs a benchmark more often than this per repetition.
+static unsigned long const MAX_ITERATIONS = 1000000000UL;
+
+///////////////////////////////////////////////////////////////////////////////
+
+State::State( Zorba *zorba, unsigned long iterations ) :
+  zorba_( zorba ),
+  iterations_( iterations ),
+  done_( 0 ),
+  running_( false ),
+  elapsed_( 0 ),
+  items_( 0 ),
+  bytes_( 0 )
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static registry_type& get_registry() {
+  static registry_type registry;
+  return registry;
+}
+
+static bool name_less( Benchmark const &a, Benchmark const &b ) {
+  return a.name < b.name;
+}
+
+registry_type const& registry() {
+  registry_type &r = get_registry();
+  std::stable_sort( r.begin(), r.end(), name_less );
+  return r;
+}
+
+Registrar::Registrar( char const *name, function_type function ) {
+  Benchmark const b = { name, function };
+  get_registry().push_back( b );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Runs the benchmark once with the given number of iterations.
+ */
+static State run_once( Zorba *zorba, Benchmark const &b,
+                       unsigned long iterations ) {
+  State state( zorba, iterations );
+  b.function( state );
+  return state;
+}
+
+/**
+ * Finds the number of iterations for which a repetition takes at least
+ * min_time ms.  The runs done to find it also warm up the caches.
+ */
+static unsigned long calibrate( Zorba *zorba, Benchmark const &b,
+                                double min_time ) {
+  unsigned long n = 1;
+  for ( ;; ) {
+    State const state( run_once( zorba, b, n ) );
+    if ( state.elapsed() >= min_time || n >= MAX_ITERATIONS )
+      return n;
+    double next;
+    if ( state.elapsed() <= 0 )
+      next = n * 100.0;
+    else
+      next = min_time * 1.2 * n / state.elapsed();
+    next = std::min( std::max( next, n * 2.0 ), n * 100.0 );
+    n = next > MAX_ITERATIONS ? MAX_ITERATIONS : (unsigned long)next;
+  }
+}
+
+static void compute_stats( Result &r ) {
+  vector<double> sorted( r.samples );
+  std::sort( sorted.begin(), sorted.end() );
+
+  size_t const n = sorted.size();
+  r.min = sorted.front();
+  r.max = sorted.back();
+  r.median = n % 2 ? sorted[ n / 2 ] : (sorted[ n / 2 - 1 ] + sorted[ n / 2 ]) / 2;
+
+  double sum = 0;
+  for ( size_t i = 0; i < n; ++i )
+    sum += sorted[i];
+  r.mean = sum / n;
+
+  double sq = 0;
+  for ( size_t i = 0; i < n; ++i )
+    sq += (sorted[i] - r.mean) * (sorted[i] - r.mean);
+  r.stddev = n > 1 ? std::sqrt( sq / (n - 1) ) : 0;
+}
+
+results_type run( Zorba *zorba, Options const &options ) {
+  results_type results;
+  registry_type const &benchmarks = registry();
+
+  for ( registry_type::const_iterator b = benchmarks.begin();
+        b != benchmarks.end(); ++b ) {
+    if ( !options.filter.empty() &&
+         b->name.find( options.filter ) == string::npos )
+      continue;
+
+    Result r;
+    r.name = b->name;
+    r.iterations = 0;
+    r.mean = r.median = r.stddev = r.min = r.max = 0;
+    r.items_per_sec = r.bytes_per_sec = r.baseline_median = 0;
+
+    try {
+      r.iterations = calibrate( zorba, *b, options.min_time );
+
+      unsigned long long items = 0, bytes = 0;
+      for ( unsigned i = 0; i < options.repetitions; ++i ) {
+        State const state( run_once( zorba, *b, r.iterations ) );
+        r.samples.push_back( state.elapsed() * 1000000.0 / r.iterations );
+        items = state.items();
+        bytes = state.bytes();
+      }
+
+      compute_stats( r );
+      if ( r.median > 0 ) {
+        r.items_per_sec = items * 1000000000.0 / r.median;
+        r.bytes_per_sec = bytes * 1000000000.0 / r.median;
+      }
+    }
+    catch ( ZorbaException const &e ) {
+      ostringstream oss;
+      oss << e;
+      r.error = oss.str();
+    }
+    catch ( std::exception const &e ) {
+      r.error = e.what();
+    }
+    results.push_back( r );
+  }
+  return results;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void load_baseline( Zorba *zorba, string const &path, results_type &results ) {
+  ifstream is( path.c_str() );
+  if ( !is )
+    throw std::runtime_error( "\"" + path + "\": can not open baseline" );
+
+  ItemSequence_t const seq( zorba->getJsonDataManager()->parseJSON( is ) );
+  Iterator_t const it( seq->getIterator() );
+  Item root;
+  it->open();
+  bool const got_root = it->next( root );
+  it->close();
+  if ( !got_root || !root.isJSONItem() )
+    throw std::runtime_error( "\"" + path + "\": not a benchmark result" );
+
+  map<string,double> medians;
+  Item const benchmarks( root.getObjectValue( "benchmarks" ) );
+  if ( benchmarks.isNull() )
+    throw std::runtime_error( "\"" + path + "\": not a benchmark result" );
+
+  uint64_t const size = benchmarks.getArraySize();
+  for ( uint64_t i = 1; i <= size; ++i ) {
+    Item const b( benchmarks.getArrayValue( static_cast<uint32_t>( i ) ) );
+    Item const name( b.getObjectValue( "name" ) );
+    Item const median( b.getObjectValue( "median_ns" ) );
+    if ( !name.isNull() && !median.isNull() )
+      medians[ name.getStringValue().str() ] =
+        std::strtod( median.getStringValue().c_str(), 0 );
+  }
+
+  for ( results_type::iterator r = results.begin(); r != results.end(); ++r ) {
+    map<string,double>::const_iterator const m = medians.find( r->name );
+    if ( m != medians.end() )
+      r->baseline_median = m->second;
+  }
+}
+
+static double change_percent( Result const &r ) {
+  return (r.median - r.baseline_median) * 100.0 / r.baseline_median;
+}
+
+static bool is_regression( Result const &r, Options const &options ) {
+  return r.error.empty() && r.baseline_median > 0 &&
+         change_percent( r ) > options.threshold;
+}
+
+unsigned count_regressions( results_type const &results,
+                            Options const &options ) {
+  unsigned n = 0;
+  for ( results_type::const_iterator r = results.begin(); r != results.end();
+        ++r )
+    if ( is_regression( *r, options ) )
+      ++n;
+  return n;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static string format_time( double ns ) {
+  ostringstream oss;
+  oss << fixed << setprecision( 2 );
+  if ( ns < 1000 )
+    oss << ns << " ns";
+  else if ( ns < 1000000 )
+    oss << ns / 1000 << " us";
+  else if ( ns < 1000000000 )
+    oss << ns / 1000000 << " ms";
+  else
+    oss << ns / 1000000000 << " s";
+  return oss.str();
+}
+
+static string format_rate( double per_sec, char const *unit ) {
+  ostringstream oss;
+  oss << fixed << setprecision( 2 );
+  if ( per_sec < 1000 )
+    oss << per_sec << ' ' << unit << "/s";
+  else if ( per_sec < 1000000 )
+    oss << per_sec / 1000 << " K" << unit << "/s";
+  else if ( per_sec < 1000000000 )
+    oss << per_sec / 1000000 << " M" << unit << "/s";
+  else
+    oss << per_sec / 1000000000 << " G" << unit << "/s";
+  return oss.str();
+}
+
+void print_table( ostream &os, results_type const &results,
+                  Options const &options ) {
+  size_t width = 9;
+  for ( results_type::const_iterator r = results.begin(); r != results.end();
+        ++r )
+    width = std::max( width, r->name.size() );
+
+  os << left << setw( width ) << "benchmark" << right
+     << setw( 12 ) << "iterations"
+     << setw( 14 ) << "median"
+     << setw( 14 ) << "min"
+     << setw( 9 ) << "cv"
+     << setw( 16 ) << "throughput";
+  if ( !options.baseline.empty() )
+    os << setw( 12 ) << "vs. base";
+  os << endl;
+
+  for ( results_type::const_iterator r = results.begin(); r != results.end();
+        ++r ) {
+    os << left << setw( width ) << r->name << right;
+    if ( !r->error.empty() ) {
+      os << "  ERROR: " << r->error << endl;
+      continue;
+    }
+
+    ostringstream cv;
+    cv << fixed << setprecision( 1 )
+       << (r->mean > 0 ? r->stddev * 100 / r->mean : 0) << '%';
+
+    string throughput;
+    if ( r->bytes_per_sec > 0 )
+      throughput = format_rate( r->bytes_per_sec, "B" );
+    else if ( r->items_per_sec > 0 )
+      throughput = format_rate( r->items_per_sec, "" );
+
+    os << setw( 12 ) << r->iterations
+       << setw( 14 ) << format_time( r->median )
+       << setw( 14 ) << format_time( r->min )
+       << setw( 9 ) << cv.str()
+       << setw( 16 ) << throughput;
+
+    if ( !options.baseline.empty() ) {
+      if ( r->baseline_median > 0 ) {
+        ostringstream change;
+        change << fixed << setprecision( 1 ) << showpos << change_percent( *r )
+               << '%';
+        os << setw( 12 ) << change.str();
+        if ( is_regression( *r, options ) )
+          os << "  REGRESSION";
+      } else {
+        os << setw( 12 ) << "new";
+      }
+    }
+    os << endl;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static string json_string( string const &s ) {
+  ostringstream oss;
+  oss << '"';
+  for ( string::const_iterator c = s.begin(); c != s.end(); ++c ) {
+    switch ( *c ) {
+      case '"' : oss << "\\\""; break;
+      case '\\': oss << "\\\\"; break;
+      case '\n': oss << "\\n"; break;
+      case '\r': oss << "\\r"; break;
+      case '\t': oss << "\\t"; break;
+      default:
+        if ( static_cast<unsigned char>( *c ) < 0x20 )
+          oss << "\\u" << hex << setw( 4 ) << setfill( '0' )
+              << static_cast<int>( *c ) << dec << setfill( ' ' );
+        else
+          oss << *c;
+    }
+  }
+  oss << '"';
+  return oss.str();
+}
+
+void print_json( ostream &os, results_type const &results,
+                 Options const &options ) {
+  ios::fmtflags const flags = os.flags();
+  streamsize const precision = os.precision();
+  os << fixed << setprecision( 3 );
+
+  os << "{" << endl
+     << "  \"context\" : {" << endl
+     << "    \"zorba_version\" : "
+     << json_string( Zorba::version().getVersion() ) << ',' << endl
+     << "    \"repetitions\" : " << options.repetitions << ',' << endl
+     << "    \"min_time_ms\" : " << options.min_time << endl
+     << "  }," << endl
+     << "  \"benchmarks\" : [";
+
+  for ( results_type::const_iterator r = results.begin(); r != results.end();
+        ++r ) {
+    if ( r != results.begin() )
+      os << ',';
+    os << endl << "    {" << endl
+       << "      \"name\" : " << json_string( r->name );
+
+    if ( !r->error.empty() ) {
+      os << ',' << endl
+         << "      \"error\" : " << json_string( r->error ) << endl
+         << "    }";
+      continue;
+    }
+
+    os << ',' << endl
+       << "      \"iterations\" : " << r->iterations << ',' << endl
+       << "      \"repetitions\" : " << r->samples.size() << ',' << endl
+       << "      \"mean_ns\" : " << r->mean << ',' << endl
+       << "      \"median_ns\" : " << r->median << ',' << endl
+       << "      \"stddev_ns\" : " << r->stddev << ',' << endl
+       << "      \"min_ns\" : " << r->min << ',' << endl
+       << "      \"max_ns\" : " << r->max << ',' << endl;
+    if ( r->items_per_sec > 0 )
+      os << "      \"items_per_second\" : " << r->items_per_sec << ',' << endl;
+    if ( r->bytes_per_sec > 0 )
+      os << "      \"bytes_per_second\" : " << r->bytes_per_sec << ',' << endl;
+    if ( r->baseline_median > 0 )
+      os << "      \"baseline_median_ns\" : " << r->baseline_median << ','
+         << endl
+         << "      \"change_percent\" : " << change_percent( *r ) << ','
+         << endl
+         << "      \"regression\" : "
+         << (is_regression( *r, options ) ? "true" : "false") << ',' << endl;
+    os << "      \"samples_ns\" : [ ";
+    for ( size_t i = 0; i < r->samples.size(); ++i )
+      os << (i ? ", " : "") << r->samples[i];
+    os << " ]" << endl
+       << "    }";
+  }
+
+  os << endl << "  ]" << endl << "}" << endl;
+
+  os.flags( flags );
+  os.precision( precision );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace bench
+} // namespace zorba
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ZORBA_BENCH_BENCHMARK_H
+#define ZORBA_BENCH_BENCHMARK_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <zorba/zorba.h>
+#include <zorba/util/timer.h>
+
+namespace zorba {
+namespace bench {
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The state that a benchmark function uses to run its timed loop:
+ *
+ *   ZORBA_BENCHMARK( "group.name" ) {
+ *     // untimed setup
+ *     while ( state.keepRunning() ) {
+ *       // timed code
+ *     }
+ *     state.setItems( n );
+ *   }
+ *
+ * The timer starts with the first call of keepRunning() and stops when it
+ * returns false, so the setup is not timed. Work that must be done in each
+ * iteration but must not be timed can be put between pause() and resume().
+ */
+class State {
+public:
+  State( Zorba *zorba, unsigned long iterations );
+
+  Zorba* zorba() const { return zorba_; }
+
+  bool keepRunning() {
+    if ( done_ == 0 && !running_ ) {
+      running_ = true;
+      timer_.start();
+    }
+    if ( done_ < iterations_ ) {
+      ++done_;
+      return true;
+    }
+    stop();
+    return false;
+  }
+
+  void pause() {
+    if ( running_ ) {
+      elapsed_ += timer_.elapsed();
+      running_ = false;
+    }
+  }
+
+  void resume() {
+    if ( !running_ ) {
+      running_ = true;
+      timer_.start();
+    }
+  }
+
+  /**
+   * Sets the number of items (e.g., tuples, nodes, queries) that one iteration
+   * processes, so that the throughput can be reported.
+   */
+  void setItems( unsigned long long items ) { items_ = items; }
+
+  /**
+   * Sets the number of bytes that one iteration processes, so that the
+   * throughput can be reported.
+   */
+  void setBytes( unsigned long long bytes ) { bytes_ = bytes; }
+
+  unsigned long iterations() const { return iterations_; }
+  double elapsed() const { return elapsed_; }
+  unsigned long long items() const { return items_; }
+  unsigned long long bytes() const { return bytes_; }
+
+private:
+  void stop() {
+    if ( running_ ) {
+      elapsed_ += timer_.elapsed();
+      running_ = false;
+    }
+  }
+
+  Zorba *const zorba_;
+  unsigned long const iterations_;
+  unsigned long done_;
+  bool running_;
+  time::wall::timer timer_;
+  double elapsed_;                      // in milliseconds
+  unsigned long long items_;
+  unsigned long long bytes_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+typedef void (*function_type)( State& );
+
+/**
+ * A registered benchmark.
+ */
+struct Benchmark {
+  std::string name;
+  function_type function;
+};
+
+typedef std::vector<Benchmark> registry_type;
+
+/**
+ * @return Returns the benchmarks registered by ZORBA_BENCHMARK, sorted by name.
+ */
+registry_type const& registry();
+
+/**
+ * Registers a benchmark during static initialization.
+ */
+struct Registrar {
+  Registrar( char const *name, function_type function );
+};
+
+#define ZORBA_BENCHMARK_CAT2(A,B) A##B
+#define ZORBA_BENCHMARK_CAT(A,B) ZORBA_BENCHMARK_CAT2(A,B)
+
+/**
+ * Defines and registers a benchmark.  The body has access to a
+ * zorba::bench::State named \c state.
+ */
+#define ZORBA_BENCHMARK(NAME)                                               \
+  static void ZORBA_BENCHMARK_CAT(bench_,__LINE__)( zorba::bench::State& ); \
+  static zorba::bench::Registrar ZORBA_BENCHMARK_CAT(registrar_,__LINE__)(  \
+    NAME, &ZORBA_BENCHMARK_CAT(bench_,__LINE__)                             \
+  );                                                                        \
+  static void ZORBA_BENCHMARK_CAT(bench_,__LINE__)(                         \
+    zorba::bench::State &state )
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The options of a run of the benchmarks.
+ */
+struct Options {
+  std::string filter;                   // substring of the names to run
+  unsigned repetitions;                 // timed repetitions per benchmark
+  double min_time;                      // per repetition, in milliseconds
+  std::string baseline;                 // JSON output of an earlier run
+  double threshold;                     // in percent of the baseline median
+  bool json;
+
+  Options() :
+    repetitions( 5 ), min_time( 200 ), threshold( 5 ), json( false )
+  {
+  }
+};
+
+/**
+ * The statistics of the repetitions of one benchmark.  All times are per
+ * iteration, in nanoseconds.
+ */
+struct Result {
+  std::string name;
+  unsigned long iterations;             // per repetition
+  std::vector<double> samples;
+  double mean;
+  double median;
+  double stddev;
+  double min;
+  double max;
+  double items_per_sec;                 // 0 if not set by the benchmark
+  double bytes_per_sec;                 // 0 if not set by the benchmark
+  double baseline_median;               // 0 if not in the baseline
+  std::string error;
+};
+
+typedef std::vector<Result> results_type;
+
+/**
+ * Runs the registered benchmarks whose names contain options.filter.
+ *
+ * @return Returns the results, in the order of the registry.
+ */
+results_type run( Zorba *zorba, Options const &options );
+
+/**
+ * Reads the median of each benchmark from the JSON output of an earlier run
+ * and stores it in the baseline_median of the result with the same name.
+ */
+void load_baseline( Zorba *zorba, std::string const &path,
+                    results_type &results );
+
+/**
+ * @return Returns the number of benchmarks whose median is slower than their
+ * baseline median by more than options.threshold percent.
+ */
+unsigned count_regressions( results_type const &results,
+                            Options const &options );
+
+/**
+ * Prints the results as a human-readable table.
+ */
+void print_table( std::ostream &os, results_type const &results,
+                  Options const &options );
+
+/**
+ * Prints the results as JSON.  The output can be used as a baseline.
+ */
+void print_json( std::ostream &os, results_type const &results,
+                 Options const &options );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace bench
+} // namespace zorba
+#endif /* ZORBA_BENCH_BENCHMARK_H */
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sstream>
+
+#include <zorba/item_sequence.h>
+#include <zorba/iterator.h>
+#include <zorba/jsondatamanager.h>
+#include <zorba/xmldatamanager.h>
+
+#include "data.h"
+
+using namespace std;
+
+namespace zorba {
+namespace bench {
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A tiny linear congruential generator so that the data does not depend on
+ * the rand() of the platform.
+ */
+class lcg {
+public:
+  lcg() : x_( 12345 ) { }
+
+  unsigned next( unsigned n ) {
+    x_ = x_ * 1103515245u + 12345u;
+    return (x_ >> 16) % n;
+  }
+
+private:
+  unsigned x_;
+};
+
+static char const *const words[] = {
+  "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel",
+  "india", "juliett", "kilo", "lima", "mike", "november", "oscar", "papa"
+};
+
+static unsigned const num_words = sizeof( words ) / sizeof( words[0] );
+
+static void make_record( lcg &g, unsigned *group, string *name,
+                         unsigned *price ) {
+  *group = g.next( 50 );
+  *name = string( words[ g.next( num_words ) ] ) + ' ' +
+          words[ g.next( num_words ) ];
+  *price = g.next( 100000 );
+}
+
+string const& xml_data() {
+  static string data;
+  if ( data.empty() ) {
+    lcg g;
+    ostringstream oss;
+    oss << "<records>";
+    for ( unsigned i = 1; i <= DATA_RECORDS; ++i ) {
+      unsigned group, price;
+      string name;
+      make_record( g, &group, &name, &price );
+      oss << "<record id=\"" << i << "\" group=\"g" << group << "\">"
+          << "<name>" << name << "</name>"
+          << "<price>" << price / 100 << '.' << price % 100 / 10
+          << price % 10 << "</price>"
+          << "</record>";
+    }
+    oss << "</records>";
+    data = oss.str();
+  }
+  return data;
+}
+
+string const& json_data() {
+  static string data;
+  if ( data.empty() ) {
+    lcg g;
+    ostringstream oss;
+    oss << '[';
+    for ( unsigned i = 1; i <= DATA_RECORDS; ++i ) {
+      unsigned group, price;
+      string name;
+      make_record( g, &group, &name, &price );
+      if ( i > 1 )
+        oss << ',';
+      oss << "{\"id\":" << i << ",\"group\":\"g" << group << '"'
+          << ",\"name\":\"" << name << '"'
+          << ",\"price\":" << price / 100 << '.' << price % 100 / 10
+          << price % 10 << '}';
+    }
+    oss << ']';
+    data = oss.str();
+  }
+  return data;
+}
+
+Item parse_xml_data( Zorba *zorba ) {
+  istringstream is( xml_data() );
+  return zorba->getXmlDataManager()->parseXML( is );
+}
+
+Item parse_json_data( Zorba *zorba ) {
+  istringstream is( json_data() );
+  ItemSequence_t const seq( zorba->getJsonDataManager()->parseJSON( is ) );
+  Iterator_t const it( seq->getIterator() );
+  Item result;
+  it->open();
+  it->next( result );
+  it->close();
+  return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace bench
+} // namespace zorba
+/* vim:set et sw=2 ts=2: */
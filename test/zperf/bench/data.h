@@ -0,0 +1,65 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ZORBA_BENCH_DATA_H
+#define ZORBA_BENCH_DATA_H
+
+#include <string>
+
+#include <zorba/item.h>
+#include <zorba/zorba.h>
+
+namespace zorba {
+namespace bench {
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The number of records in the generated documents.
+ */
+unsigned const DATA_RECORDS = 10000;
+
+/**
+ * @return Returns an XML document of DATA_RECORDS elements of the form
+ *
+ *    <record id="1" group="g7"><name>...</name><price>...</price></record>
+ *
+ * inside a \c records element.  The document is generated once and is the
+ * same in every run.
+ */
+std::string const& xml_data();
+
+/**
+ * @return Returns a JSON array of DATA_RECORDS objects with the same content
+ * as the records of xml_data().
+ */
+std::string const& json_data();
+
+/**
+ * Parses xml_data().
+ */
+Item parse_xml_data( Zorba *zorba );
+
+/**
+ * Parses json_data().
+ */
+Item parse_json_data( Zorba *zorba );
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace bench
+} // namespace zorba
+#endif /* ZORBA_BENCH_DATA_H */
+/* vim:set et sw=2 ts=2: */
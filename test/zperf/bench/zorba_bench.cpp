@@ -0,0 +1,173 @@
+/*
+ * Copyright 2006-2016 zorba.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <zorba/store_manager.h>
+#include <zorba/zorba.h>
+#include <zorba/zorba_exception.h>
+
+#include "benchmark.h"
+
+using namespace std;
+using namespace zorba;
+using namespace zorba::bench;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static char const *me;
+
+static void usage() {
+  cerr << "usage: " << me << " [options]\n"
+          "options:\n"
+          "  --filter <substring>  run only the benchmarks whose names contain it\n"
+          "  --repetitions <n>     timed repetitions per benchmark (default: 5)\n"
+          "  --min-time <ms>       minimum time of one repetition (default: 200)\n"
+          "  --json                print the results as JSON\n"
+          "  --output <file>       also write the results as JSON to <file>\n"
+          "  --baseline <file>     compare with the JSON results of an earlier run\n"
+          "  --threshold <pct>     slowdown reported as regression (default: 5)\n"
+          "  --list                list the benchmarks and exit\n"
+          "  --help                print this help and exit\n"
+          "\n"
+          "The exit status is 1 if a benchmark failed or regressed.\n";
+}
+
+static char const* arg_value( int argc, char const *argv[], int *i ) {
+  if ( *i + 1 >= argc ) {
+    cerr << me << ": " << argv[ *i ] << " requires a value\n";
+    usage();
+    exit( 2 );
+  }
+  return argv[ ++*i ];
+}
+
+static double num_value( int argc, char const *argv[], int *i ) {
+  char const *const opt = argv[ *i ];
+  char const *const value = arg_value( argc, argv, i );
+  char *end;
+  double const d = strtod( value, &end );
+  if ( *end || d < 0 ) {
+    cerr << me << ": \"" << value << "\": invalid value for " << opt << '\n';
+    exit( 2 );
+  }
+  return d;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main( int argc, char const *argv[] ) {
+  me = argv[0];
+
+  Options options;
+  string output;
+  bool list = false;
+
+  for ( int i = 1; i < argc; ++i ) {
+    if ( !strcmp( argv[i], "--filter" ) )
+      options.filter = arg_value( argc, argv, &i );
+    else if ( !strcmp( argv[i], "--repetitions" ) ) {
+      options.repetitions = static_cast<unsigned>( num_value( argc, argv, &i ) );
+      if ( !options.repetitions )
+        options.repetitions = 1;
+    }
+    else if ( !strcmp( argv[i], "--min-time" ) )
+      options.min_time = num_value( argc, argv, &i );
+    else if ( !strcmp( argv[i], "--json" ) )
+      options.json = true;
+    else if ( !strcmp( argv[i], "--output" ) )
+      output = arg_value( argc, argv, &i );
+    else if ( !strcmp( argv[i], "--baseline" ) )
+      options.baseline = arg_value( argc, argv, &i );
+    else if ( !strcmp( argv[i], "--threshold" ) )
+      options.threshold = num_value( argc, argv, &i );
+    else if ( !strcmp( argv[i], "--list" ) )
+      list = true;
+    else if ( !strcmp( argv[i], "--help" ) ) {
+      usage();
+      return 0;
+    }
+    else {
+      cerr << me << ": \"" << argv[i] << "\": unknown option\n";
+      usage();
+      return 2;
+    }
+  }
+
+  if ( list ) {
+    registry_type const &benchmarks = registry();
+    for ( registry_type::const_iterator b = benchmarks.begin();
+          b != benchmarks.end(); ++b )
+      if ( b->name.find( options.filter ) != string::npos )
+        cout << b->name << '\n';
+    return 0;
+  }
+
+  void *const store = StoreManager::getStore();
+  Zorba *const zorba = Zorba::getInstance( store );
+  int status = 0;
+
+  try {
+    results_type results( run( zorba, options ) );
+
+    if ( !options.baseline.empty() )
+      load_baseline( zorba, options.baseline, results );
+
+    if ( options.json )
+      print_json( cout, results, options );
+    else
+      print_table( cout, results, options );
+
+    if ( !output.empty() ) {
+      ofstream os( output.c_str() );
+      print_json( os, results, options );
+      if ( !os ) {
+        cerr << me << ": \"" << output << "\": can not write results\n";
+        status = 2;
+      }
+    }
+
+    for ( results_type::const_iterator r = results.begin();
+          r != results.end(); ++r )
+      if ( !r->error.empty() )
+        status = 1;
+
+    if ( unsigned const n = count_regressions( results, options ) ) {
+      cerr << me << ": " << n << " benchmark(s) regressed by more than "
+           << options.threshold << "%\n";
+      status = 1;
+    }
+  }
+  catch ( ZorbaException const &e ) {
+    cerr << me << ": " << e << endl;
+    status = 2;
+  }
+  catch ( std::exception const &e ) {
+    cerr << me << ": " << e.what() << endl;
+    status = 2;
+  }
+
+  zorba->shutdown();
+  StoreManager::shutdownStore( store );
+  return status;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,32 @@
+#!/bin/sh
+#
+# Copyright 2006-2016 zorba.io
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# Runs parallel_flwor.xq with 1 to 16 threads and prints the average execution
+# time reported by zorba --timing for each run.
+#
+# usage: run.sh [path/to/zorba] [n]
+
+ZORBA=${1:-zorba}
+N=${2:-20000}
+DIR=`dirname "$0"`
+
+for THREADS in 1 2 4 8 16
+do
+  TIME=`"$ZORBA" --timing --parallel-flwor-threads $THREADS \
+         -e n:=$N -f -q "$DIR/parallel_flwor.xq" |
+        sed -n 's/^Average Execution Time *: *//p'`
+  echo "threads $THREADS: $TIME"
+done